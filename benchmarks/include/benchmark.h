@@ -0,0 +1,182 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/* Minimal micro-benchmark harness used by the AnvilBenchmarks target.
+ *
+ * Each benchmark is a function which executes the measured operation a requested number of times.
+ * The runner times a number of repetitions of every benchmark and emits one JSON object per benchmark
+ * (JSON Lines), so that results can be diffed and tracked across revisions.
+ *
+ * Behavioral checks live next to the benchmarks of the code they exercise. These are run instead of the benchmarks
+ * when --checks is passed, and report one JSON object per check. Failed expectations are also reported on stderr.
+ *
+ * Benchmarks which need a Vulkan device should request one from the context. If no device can be
+ * created (eg. because no ICD is installed), the benchmark is reported as skipped. To get results which
+ * do not depend on the GPU installed in the machine, point the loader at a software ICD (eg. lavapipe,
+ * by setting VK_ICD_FILENAMES) and/or pick the device by name with --device=<substring>.
+ */
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "misc/types.h"
+#include <functional>
+#include <string>
+
+namespace AnvilBenchmarks
+{
+    class Context
+    {
+    public:
+        /* Public functions */
+
+        /** Constructor.
+         *
+         *  @param in_device_filter Substring the name of the physical device to use needs to contain. Empty
+         *                          string matches all physical devices.
+         **/
+        explicit Context(const std::string& in_device_filter);
+
+        ~Context();
+
+        /** Returns a single-GPU device created for the first physical device reported by the loader, whose name
+         *  matches the filter specified at creation time. The device is created at first call time.
+         *
+         *  @return Requested device, or nullptr if no Vulkan device could be created.
+         **/
+        Anvil::SGPUDevice* get_device();
+
+    private:
+        /* Private functions */
+        Context           (const Context&);
+        Context& operator=(const Context&);
+
+        /* Private variables */
+        bool                       m_device_creation_attempted;
+        std::string                m_device_filter;
+        Anvil::BaseDeviceUniquePtr m_device_ptr;
+        Anvil::InstanceUniquePtr   m_instance_ptr;
+    };
+
+    /* Executes the measured operation @param in_n_iterations times.
+     *
+     * Must return false if the benchmark cannot be run in the current environment, true otherwise.
+     */
+    typedef std::function<bool(Context* in_context_ptr,
+                               uint32_t in_n_iterations)> BenchmarkFunction;
+
+    /* Registers a benchmark at static initialization time. */
+    class Registrar
+    {
+    public:
+        /** Constructor.
+         *
+         *  @param in_name                  Unique benchmark name, in <group>/<benchmark> form.
+         *  @param in_n_iterations          Number of iterations to execute per repetition.
+         *  @param in_n_items_per_iteration Number of items (eg. submissions) processed per iteration. Used to
+         *                                  report per-item timings.
+         *  @param in_function              Benchmark function.
+         **/
+        Registrar(const char*       in_name,
+                  uint32_t          in_n_iterations,
+                  uint32_t          in_n_items_per_iteration,
+                  BenchmarkFunction in_function);
+    };
+
+    /* Executes a behavioral check. Failed expectations are reported with ANVIL_EXPECT().
+     *
+     * Must return false if the check cannot be run in the current environment, true otherwise.
+     */
+    typedef std::function<bool(Context* in_context_ptr)> CheckFunction;
+
+    /* Registers a behavioral check at static initialization time. */
+    class CheckRegistrar
+    {
+    public:
+        /** Constructor.
+         *
+         *  @param in_name     Unique check name, in <group>/<check> form.
+         *  @param in_function Check function.
+         **/
+        CheckRegistrar(const char*   in_name,
+                       CheckFunction in_function);
+    };
+
+    /** Prevents the compiler from optimizing away computations whose results are otherwise unused. */
+    template<typename Type>
+    inline void do_not_optimize(const Type& in_value)
+    {
+        #if defined(_MSC_VER)
+        {
+            static volatile const void* sink_ptr;
+
+            sink_ptr = &in_value;
+        }
+        #else
+        {
+            asm volatile("" : : "g"(&in_value) : "memory");
+        }
+        #endif
+    }
+
+    /** Runs all registered benchmarks whose name contains @param in_filter and prints results to stdout.
+     *
+     *  @param in_filter        Substring benchmark names need to contain in order to run. Empty string matches
+     *                          all benchmarks.
+     *  @param in_device_filter Substring the name of the physical device benchmarks should use needs to contain.
+     *                          Empty string matches all physical devices.
+     *  @param in_n_repetitions Number of timed repetitions per benchmark.
+     *
+     *  @return Number of benchmarks which were run.
+     **/
+    uint32_t run_benchmarks(const std::string& in_filter,
+                            const std::string& in_device_filter,
+                            uint32_t           in_n_repetitions);
+
+    /** Runs all registered checks whose name contains @param in_filter and prints results to stdout.
+     *
+     *  @param in_filter               Substring check names need to contain in order to run. Empty string matches
+     *                                 all checks.
+     *  @param in_device_filter        Substring the name of the physical device checks should use needs to contain.
+     *                                 Empty string matches all physical devices.
+     *  @param out_n_failed_checks_ptr Deref will be set to the number of checks which failed. Must not be null.
+     *
+     *  @return Number of checks which were run.
+     **/
+    uint32_t run_checks(const std::string& in_filter,
+                        const std::string& in_device_filter,
+                        uint32_t*          out_n_failed_checks_ptr);
+
+    /** Reports a failed expectation of the check which is being run. Use ANVIL_EXPECT() instead of calling this
+     *  function directly.
+     **/
+    void report_failed_expectation(const char* in_expression,
+                                   const char* in_file,
+                                   int         in_line);
+}; /* namespace AnvilBenchmarks */
+
+/* Fails the check which is being run if @param expression evaluates to false. Evaluates to the result of the expression,
+ * so that checks can bail out early if later expectations depend on it.
+ */
+#define ANVIL_EXPECT(expression) ((expression) ? true \
+                                               : (AnvilBenchmarks::report_failed_expectation(#expression, __FILE__, __LINE__), false) )
+
+#endif /* BENCHMARK_H */
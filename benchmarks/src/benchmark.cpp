@@ -0,0 +1,309 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/device_create_info.h"
+#include "misc/instance_create_info.h"
+#include "wrappers/device.h"
+#include "wrappers/instance.h"
+#include "wrappers/physical_device.h"
+#include "benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    typedef struct Benchmark
+    {
+        AnvilBenchmarks::BenchmarkFunction function;
+        std::string                        name;
+        uint32_t                           n_items_per_iteration;
+        uint32_t                           n_iterations;
+    } Benchmark;
+
+    typedef struct Check
+    {
+        AnvilBenchmarks::CheckFunction function;
+        std::string                    name;
+    } Check;
+
+    /* Number of failed expectations reported since the check which is being run has started */
+    uint32_t g_n_failed_expectations = 0;
+
+    std::vector<Benchmark>& get_benchmarks()
+    {
+        static std::vector<Benchmark> benchmarks;
+
+        return benchmarks;
+    }
+
+    std::vector<Check>& get_checks()
+    {
+        static std::vector<Check> checks;
+
+        return checks;
+    }
+}
+
+
+/* Please see header for specification */
+AnvilBenchmarks::Context::Context(const std::string& in_device_filter)
+    :m_device_creation_attempted(false),
+     m_device_filter            (in_device_filter)
+{
+    /* Stub */
+}
+
+AnvilBenchmarks::Context::~Context()
+{
+    /* The device must be released before the instance it has been created for. */
+    m_device_ptr.reset  ();
+    m_instance_ptr.reset();
+}
+
+/* Please see header for specification */
+Anvil::SGPUDevice* AnvilBenchmarks::Context::get_device()
+{
+    if (!m_device_creation_attempted)
+    {
+        m_device_creation_attempted = true;
+
+        m_instance_ptr = Anvil::Instance::create(Anvil::InstanceCreateInfo::create("AnvilBenchmarks", /* in_app_name    */
+                                                                                   "AnvilBenchmarks", /* in_engine_name */
+                                                                                   Anvil::DebugCallbackFunction(),
+                                                                                   false) );          /* in_mt_safe     */
+
+        if (m_instance_ptr != nullptr)
+        {
+            for (uint32_t n_physical_device = 0;
+                          n_physical_device < m_instance_ptr->get_n_physical_devices();
+                        ++n_physical_device)
+            {
+                const Anvil::PhysicalDevice* physical_device_ptr = m_instance_ptr->get_physical_device(n_physical_device);
+                const char*                  device_name         = physical_device_ptr->get_device_properties().core_vk1_0_properties_ptr->device_name;
+
+                if (strstr(device_name,
+                           m_device_filter.c_str() ) == nullptr)
+                {
+                    continue;
+                }
+
+                m_device_ptr = Anvil::SGPUDevice::create(Anvil::DeviceCreateInfo::create_sgpu(physical_device_ptr,
+                                                                                              false,                      /* in_enable_shader_module_cache */
+                                                                                              Anvil::DeviceExtensionConfiguration(),
+                                                                                              std::vector<std::string>(), /* in_layers */
+                                                                                              Anvil::CommandPoolCreateFlagBits::CREATE_RESET_COMMAND_BUFFER_BIT,
+                                                                                              false) );                   /* in_mt_safe */
+
+                if (m_device_ptr != nullptr)
+                {
+                    /* Tag the results with the device they have been gathered on */
+                    printf("{\"device\": \"%s\", \"driver_version\": %u}\n",
+                           device_name,
+                           physical_device_ptr->get_device_properties().core_vk1_0_properties_ptr->driver_version);
+
+                    fflush(stdout);
+                }
+
+                break;
+            }
+        }
+    }
+
+    return reinterpret_cast<Anvil::SGPUDevice*>(m_device_ptr.get() );
+}
+
+AnvilBenchmarks::Registrar::Registrar(const char*       in_name,
+                                      uint32_t          in_n_iterations,
+                                      uint32_t          in_n_items_per_iteration,
+                                      BenchmarkFunction in_function)
+{
+    Benchmark new_benchmark;
+
+    new_benchmark.function              = in_function;
+    new_benchmark.n_items_per_iteration = in_n_items_per_iteration;
+    new_benchmark.n_iterations          = in_n_iterations;
+    new_benchmark.name                  = in_name;
+
+    get_benchmarks().push_back(new_benchmark);
+}
+
+AnvilBenchmarks::CheckRegistrar::CheckRegistrar(const char*   in_name,
+                                                CheckFunction in_function)
+{
+    Check new_check;
+
+    new_check.function = in_function;
+    new_check.name     = in_name;
+
+    get_checks().push_back(new_check);
+}
+
+/* Please see header for specification */
+void AnvilBenchmarks::report_failed_expectation(const char* in_expression,
+                                                const char* in_file,
+                                                int         in_line)
+{
+    fprintf(stderr,
+            "%s:%d: Expectation failed: %s\n",
+            in_file,
+            in_line,
+            in_expression);
+
+    ++g_n_failed_expectations;
+}
+
+/* Please see header for specification */
+uint32_t AnvilBenchmarks::run_benchmarks(const std::string& in_filter,
+                                         const std::string& in_device_filter,
+                                         uint32_t           in_n_repetitions)
+{
+    Context  context         (in_device_filter);
+    uint32_t n_benchmarks_run = 0;
+    auto     benchmarks       = get_benchmarks();
+
+    std::sort(benchmarks.begin(),
+              benchmarks.end  (),
+              [](const Benchmark& in_benchmark1,
+                 const Benchmark& in_benchmark2)
+              {
+                  return in_benchmark1.name < in_benchmark2.name;
+              });
+
+    for (const auto& current_benchmark : benchmarks)
+    {
+        std::vector<double> ns_per_iteration_vec;
+
+        if (in_filter.size()                            > 0 &&
+            current_benchmark.name.find(in_filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        /* Warm caches & lazily created objects up */
+        if (!current_benchmark.function(&context,
+                                        std::max(current_benchmark.n_iterations / 10,
+                                                 1u) ))
+        {
+            printf("{\"benchmark\": \"%s\", \"skipped\": true}\n",
+                   current_benchmark.name.c_str() );
+
+            fflush(stdout);
+            continue;
+        }
+
+        for (uint32_t n_repetition = 0;
+                      n_repetition < in_n_repetitions;
+                    ++n_repetition)
+        {
+            const auto start_time = std::chrono::steady_clock::now();
+
+            current_benchmark.function(&context,
+                                       current_benchmark.n_iterations);
+
+            const auto end_time = std::chrono::steady_clock::now();
+
+            ns_per_iteration_vec.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count() ) / current_benchmark.n_iterations);
+        }
+
+        std::sort(ns_per_iteration_vec.begin(),
+                  ns_per_iteration_vec.end  () );
+
+        {
+            const double median_ns = ns_per_iteration_vec.at(ns_per_iteration_vec.size() / 2);
+
+            printf("{\"benchmark\": \"%s\", \"iterations\": %u, \"repetitions\": %u, \"items_per_iteration\": %u, "
+                   "\"ns_per_iteration_min\": %.2f, \"ns_per_iteration_median\": %.2f, \"ns_per_iteration_max\": %.2f, \"ns_per_item_median\": %.2f}\n",
+                   current_benchmark.name.c_str(),
+                   current_benchmark.n_iterations,
+                   in_n_repetitions,
+                   current_benchmark.n_items_per_iteration,
+                   ns_per_iteration_vec.front(),
+                   median_ns,
+                   ns_per_iteration_vec.back(),
+                   median_ns / current_benchmark.n_items_per_iteration);
+
+            fflush(stdout);
+        }
+
+        ++n_benchmarks_run;
+    }
+
+    return n_benchmarks_run;
+}
+
+/* Please see header for specification */
+uint32_t AnvilBenchmarks::run_checks(const std::string& in_filter,
+                                     const std::string& in_device_filter,
+                                     uint32_t*          out_n_failed_checks_ptr)
+{
+    auto     checks       = get_checks();
+    Context  context      (in_device_filter);
+    uint32_t n_checks_run = 0;
+
+    *out_n_failed_checks_ptr = 0;
+
+    std::sort(checks.begin(),
+              checks.end  (),
+              [](const Check& in_check1,
+                 const Check& in_check2)
+              {
+                  return in_check1.name < in_check2.name;
+              });
+
+    for (const auto& current_check : checks)
+    {
+        if (in_filter.size()                        > 0 &&
+            current_check.name.find(in_filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        g_n_failed_expectations = 0;
+
+        if (!current_check.function(&context) )
+        {
+            printf("{\"check\": \"%s\", \"skipped\": true}\n",
+                   current_check.name.c_str() );
+
+            fflush(stdout);
+            continue;
+        }
+
+        printf("{\"check\": \"%s\", \"passed\": %s}\n",
+               current_check.name.c_str(),
+               (g_n_failed_expectations == 0) ? "true" : "false");
+
+        fflush(stdout);
+
+        if (g_n_failed_expectations != 0)
+        {
+            ++(*out_n_failed_checks_ptr);
+        }
+
+        ++n_checks_run;
+    }
+
+    return n_checks_run;
+}
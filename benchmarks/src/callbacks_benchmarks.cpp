@@ -0,0 +1,444 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/callbacks.h"
+#include "benchmark.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const uint32_t g_n_many_subscribers = 256;
+
+    enum
+    {
+        DUMMY_CALLBACK_ID_NO_SUBSCRIBERS,
+        DUMMY_CALLBACK_ID_FOUR_SUBSCRIBERS,
+        DUMMY_CALLBACK_ID_MANY_SUBSCRIBERS,
+        DUMMY_CALLBACK_ID_CHECK,
+
+        DUMMY_CALLBACK_ID_COUNT
+    };
+
+    /* Exposes CallbacksSupportProvider::callback() and callback_safe(), which are protected. */
+    class DummyCallbacksSupportProvider : public Anvil::CallbacksSupportProvider
+    {
+    public:
+        DummyCallbacksSupportProvider()
+            :CallbacksSupportProvider(DUMMY_CALLBACK_ID_COUNT)
+        {
+            /* Stub */
+        }
+
+        void fire(Anvil::CallbackID        in_callback_id,
+                  Anvil::CallbackArgument* in_callback_arg_ptr) const
+        {
+            callback(in_callback_id,
+                     in_callback_arg_ptr);
+        }
+
+        void fire_safe(Anvil::CallbackID        in_callback_id,
+                       Anvil::CallbackArgument* in_callback_arg_ptr)
+        {
+            callback_safe(in_callback_id,
+                          in_callback_arg_ptr);
+        }
+    };
+
+    typedef std::function<void(DummyCallbacksSupportProvider* in_provider_ptr,
+                               Anvil::CallbackArgument*       in_callback_arg_ptr)> FireFunction;
+
+    /** Signs g_n_many_subscribers subscribers up to DUMMY_CALLBACK_ID_MANY_SUBSCRIBERS, fires the slot
+     *  @param in_n_iterations times using @param in_fire_function, then signs the subscribers out.
+     **/
+    void run_many_subscribers_benchmark(uint32_t     in_n_iterations,
+                                        FireFunction in_fire_function)
+    {
+        uint32_t                      n_calls           = 0;
+        std::vector<uint32_t>         owners            (g_n_many_subscribers);
+        DummyCallbacksSupportProvider provider;
+        Anvil::CallbackArgument       callback_arg;
+        Anvil::CallbackFunction       callback_function = [&n_calls](Anvil::CallbackArgument*)
+        {
+            ++n_calls;
+        };
+
+        for (auto& current_owner : owners)
+        {
+            provider.register_for_callbacks(DUMMY_CALLBACK_ID_MANY_SUBSCRIBERS,
+                                            callback_function,
+                                           &current_owner);
+        }
+
+        for (uint32_t n_iteration = 0;
+                      n_iteration < in_n_iterations;
+                    ++n_iteration)
+        {
+            in_fire_function(&provider,
+                             &callback_arg);
+        }
+
+        AnvilBenchmarks::do_not_optimize(n_calls);
+
+        for (auto& current_owner : owners)
+        {
+            provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_MANY_SUBSCRIBERS,
+                                               callback_function,
+                                              &current_owner);
+        }
+    }
+
+    /* Fires a callback slot nobody has subscribed to. Most callbacks fired by Anvil wrappers fall into this category. */
+    AnvilBenchmarks::Registrar g_callback_no_subscribers_benchmark(
+        "callbacks/callback_no_subscribers",
+        1000000, /* in_n_iterations          */
+        1,       /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            DummyCallbacksSupportProvider provider;
+            Anvil::CallbackArgument       callback_arg;
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                provider.fire(DUMMY_CALLBACK_ID_NO_SUBSCRIBERS,
+                             &callback_arg);
+            }
+
+            return true;
+        });
+
+    /* Fires a callback slot with four subscribers. */
+    AnvilBenchmarks::Registrar g_callback_four_subscribers_benchmark(
+        "callbacks/callback_four_subscribers",
+        1000000, /* in_n_iterations          */
+        4,       /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            uint32_t                      n_calls           = 0;
+            uint32_t                      owners[4];
+            DummyCallbacksSupportProvider provider;
+            Anvil::CallbackArgument       callback_arg;
+            Anvil::CallbackFunction       callback_function = [&n_calls](Anvil::CallbackArgument*)
+            {
+                ++n_calls;
+            };
+
+            for (uint32_t n_owner = 0;
+                          n_owner < sizeof(owners) / sizeof(owners[0]);
+                        ++n_owner)
+            {
+                provider.register_for_callbacks(DUMMY_CALLBACK_ID_FOUR_SUBSCRIBERS,
+                                                callback_function,
+                                                owners + n_owner);
+            }
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                provider.fire(DUMMY_CALLBACK_ID_FOUR_SUBSCRIBERS,
+                             &callback_arg);
+            }
+
+            AnvilBenchmarks::do_not_optimize(n_calls);
+
+            for (uint32_t n_owner = 0;
+                          n_owner < sizeof(owners) / sizeof(owners[0]);
+                        ++n_owner)
+            {
+                provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_FOUR_SUBSCRIBERS,
+                                                   callback_function,
+                                                   owners + n_owner);
+            }
+
+            return true;
+        });
+
+    /* Fires a callback slot with hundreds of subscribers. */
+    AnvilBenchmarks::Registrar g_callback_many_subscribers_benchmark(
+        "callbacks/callback_many_subscribers",
+        20000,                /* in_n_iterations          */
+        g_n_many_subscribers, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            run_many_subscribers_benchmark(in_n_iterations,
+                                           [](DummyCallbacksSupportProvider* in_provider_ptr,
+                                              Anvil::CallbackArgument*       in_callback_arg_ptr)
+                                           {
+                                               in_provider_ptr->fire(DUMMY_CALLBACK_ID_MANY_SUBSCRIBERS,
+                                                                     in_callback_arg_ptr);
+                                           });
+
+            return true;
+        });
+
+    /* Fires a callback slot with hundreds of subscribers, using the variant which also calls back subscribers
+     * added while the callback is in progress. */
+    AnvilBenchmarks::Registrar g_callback_safe_many_subscribers_benchmark(
+        "callbacks/callback_safe_many_subscribers",
+        20000,                /* in_n_iterations          */
+        g_n_many_subscribers, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            run_many_subscribers_benchmark(in_n_iterations,
+                                           [](DummyCallbacksSupportProvider* in_provider_ptr,
+                                              Anvil::CallbackArgument*       in_callback_arg_ptr)
+                                           {
+                                               in_provider_ptr->fire_safe(DUMMY_CALLBACK_ID_MANY_SUBSCRIBERS,
+                                                                          in_callback_arg_ptr);
+                                           });
+
+            return true;
+        });
+
+    /* Registers a subscriber from a callback handler. callback() must not call the new subscriber back until the
+     * next invocation, whereas callback_safe() must call it back right away, exactly once. */
+    AnvilBenchmarks::CheckRegistrar g_register_during_dispatch_check(
+        "callbacks/register_during_dispatch",
+        [](AnvilBenchmarks::Context*)
+        {
+            uint32_t                      n_added_calls         = 0;
+            uint32_t                      n_registering_calls   = 0;
+            uint32_t                      owners[2];
+            DummyCallbacksSupportProvider provider;
+            Anvil::CallbackArgument       callback_arg;
+            Anvil::CallbackFunction       added_function        = [&n_added_calls](Anvil::CallbackArgument*)
+            {
+                ++n_added_calls;
+            };
+            Anvil::CallbackFunction       registering_function  = [&](Anvil::CallbackArgument*)
+            {
+                if (n_registering_calls++ == 0)
+                {
+                    provider.register_for_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                                    added_function,
+                                                    owners + 1);
+                }
+            };
+
+            provider.register_for_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                            registering_function,
+                                            owners + 0);
+
+            provider.fire(DUMMY_CALLBACK_ID_CHECK,
+                         &callback_arg);
+
+            ANVIL_EXPECT(n_added_calls == 0);
+
+            provider.fire(DUMMY_CALLBACK_ID_CHECK,
+                         &callback_arg);
+
+            ANVIL_EXPECT(n_added_calls       == 1);
+            ANVIL_EXPECT(n_registering_calls == 2);
+
+            provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                               added_function,
+                                               owners + 1);
+
+            n_added_calls       = 0;
+            n_registering_calls = 0;
+
+            provider.fire_safe(DUMMY_CALLBACK_ID_CHECK,
+                              &callback_arg);
+
+            ANVIL_EXPECT(n_added_calls       == 1);
+            ANVIL_EXPECT(n_registering_calls == 1);
+
+            provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                               added_function,
+                                               owners + 1);
+            provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                               registering_function,
+                                               owners + 0);
+
+            return true;
+        });
+
+    /* Has a callback handler unregister and register again a subscriber which has already been called back.
+     * callback_safe() must not call the subscriber back twice. */
+    AnvilBenchmarks::CheckRegistrar g_reregister_during_dispatch_check(
+        "callbacks/reregister_during_dispatch",
+        [](AnvilBenchmarks::Context*)
+        {
+            uint32_t                      n_reregistered_calls   = 0;
+            uint32_t                      owners[2];
+            DummyCallbacksSupportProvider provider;
+            Anvil::CallbackArgument       callback_arg;
+            Anvil::CallbackFunction       reregistered_function  = [&n_reregistered_calls](Anvil::CallbackArgument*)
+            {
+                ++n_reregistered_calls;
+            };
+            Anvil::CallbackFunction       reregistering_function = [&](Anvil::CallbackArgument*)
+            {
+                provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                                   reregistered_function,
+                                                   owners + 0);
+                provider.register_for_callbacks   (DUMMY_CALLBACK_ID_CHECK,
+                                                   reregistered_function,
+                                                   owners + 0);
+            };
+
+            provider.register_for_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                            reregistered_function,
+                                            owners + 0);
+            provider.register_for_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                            reregistering_function,
+                                            owners + 1);
+
+            provider.fire_safe(DUMMY_CALLBACK_ID_CHECK,
+                              &callback_arg);
+
+            ANVIL_EXPECT(n_reregistered_calls == 1);
+
+            provider.fire_safe(DUMMY_CALLBACK_ID_CHECK,
+                              &callback_arg);
+
+            ANVIL_EXPECT(n_reregistered_calls                                     == 2);
+            ANVIL_EXPECT(provider.is_callback_registered(DUMMY_CALLBACK_ID_CHECK,
+                                                         reregistered_function,
+                                                         owners + 0) );
+
+            provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                               reregistered_function,
+                                               owners + 0);
+            provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                               reregistering_function,
+                                               owners + 1);
+
+            return true;
+        });
+
+    /* Has a callback handler unregister another subscriber. The subscriber must not be called back by any
+     * invocation which starts after the handler returns. */
+    AnvilBenchmarks::CheckRegistrar g_unregister_during_dispatch_check(
+        "callbacks/unregister_during_dispatch",
+        [](AnvilBenchmarks::Context*)
+        {
+            uint32_t                      n_unregistered_calls   = 0;
+            uint32_t                      n_unregistering_calls  = 0;
+            uint32_t                      owners[2];
+            DummyCallbacksSupportProvider provider;
+            Anvil::CallbackArgument       callback_arg;
+            Anvil::CallbackFunction       unregistered_function  = [&n_unregistered_calls](Anvil::CallbackArgument*)
+            {
+                ++n_unregistered_calls;
+            };
+            Anvil::CallbackFunction       unregistering_function = [&](Anvil::CallbackArgument*)
+            {
+                if (n_unregistering_calls++ == 0)
+                {
+                    provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                                       unregistered_function,
+                                                       owners + 1);
+                }
+            };
+
+            provider.register_for_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                            unregistering_function,
+                                            owners + 0);
+            provider.register_for_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                            unregistered_function,
+                                            owners + 1);
+
+            /* The in-flight invocation may still call the unregistered subscriber back */
+            provider.fire(DUMMY_CALLBACK_ID_CHECK,
+                         &callback_arg);
+
+            ANVIL_EXPECT(n_unregistered_calls <= 1);
+
+            n_unregistered_calls = 0;
+
+            provider.fire     (DUMMY_CALLBACK_ID_CHECK,
+                              &callback_arg);
+            provider.fire_safe(DUMMY_CALLBACK_ID_CHECK,
+                              &callback_arg);
+
+            ANVIL_EXPECT(n_unregistered_calls  == 0);
+            ANVIL_EXPECT(n_unregistering_calls == 3);
+            ANVIL_EXPECT(!provider.is_callback_registered(DUMMY_CALLBACK_ID_CHECK,
+                                                          unregistered_function,
+                                                          owners + 1) );
+
+            provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                               unregistering_function,
+                                               owners + 0);
+
+            return true;
+        });
+
+    /* Unregisters a subscriber while another thread is calling it back. unregister_from_callbacks() must not return
+     * before the call-back has finished. */
+    AnvilBenchmarks::CheckRegistrar g_unregister_waits_for_dispatch_check(
+        "callbacks/unregister_waits_for_dispatch",
+        [](AnvilBenchmarks::Context*)
+        {
+            std::atomic<bool>             has_call_finished(false);
+            std::atomic<bool>             has_call_started (false);
+            uint32_t                      owner;
+            DummyCallbacksSupportProvider provider;
+            Anvil::CallbackFunction       slow_function = [&](Anvil::CallbackArgument*)
+            {
+                has_call_started = true;
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(50) );
+
+                has_call_finished = true;
+            };
+
+            provider.register_for_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                            slow_function,
+                                           &owner);
+
+            std::thread dispatch_thread(
+                [&provider]()
+                {
+                    Anvil::CallbackArgument callback_arg;
+
+                    provider.fire(DUMMY_CALLBACK_ID_CHECK,
+                                 &callback_arg);
+                });
+
+            while (!has_call_started)
+            {
+                std::this_thread::yield();
+            }
+
+            provider.unregister_from_callbacks(DUMMY_CALLBACK_ID_CHECK,
+                                               slow_function,
+                                              &owner);
+
+            ANVIL_EXPECT(has_call_finished);
+
+            dispatch_thread.join();
+
+            return true;
+        });
+}
@@ -0,0 +1,252 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/buffer_create_info.h"
+#include "misc/command_stream.h"
+#include "wrappers/buffer.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
+#include "wrappers/device.h"
+#include "wrappers/queue.h"
+#include "benchmark.h"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    Anvil::PrimaryCommandBufferUniquePtr create_command_buffer(Anvil::SGPUDevice* in_device_ptr)
+    {
+        auto queue_ptr = in_device_ptr->get_universal_queue(0);
+
+        return in_device_ptr->get_command_pool_for_queue_family_index(queue_ptr->get_queue_family_index() )->alloc_primary_level_command_buffer();
+    }
+
+    /* Records a fixed sequence of commands into @param in_cmd_buffer_ptr. Returns the number of commands recorded. */
+    uint32_t record_commands(Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr,
+                             Anvil::Buffer*               in_buffer_ptr)
+    {
+        const Anvil::BufferBarrier buffer_barrier(Anvil::AccessFlagBits::TRANSFER_WRITE_BIT,
+                                                  Anvil::AccessFlagBits::SHADER_READ_BIT,
+                                                  VK_QUEUE_FAMILY_IGNORED,
+                                                  VK_QUEUE_FAMILY_IGNORED,
+                                                  in_buffer_ptr,
+                                                  64,   /* in_offset */
+                                                  128); /* in_size   */
+        const uint8_t              update_data[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+        const VkViewport           viewports[2]    = {{0.0f,  0.0f,  64.0f, 32.0f, 0.0f, 1.0f},
+                                                      {64.0f, 32.0f, 16.0f, 8.0f,  0.5f, 1.0f}};
+
+        ANVIL_EXPECT(in_cmd_buffer_ptr->record_fill_buffer     (in_buffer_ptr,
+                                                                0,    /* in_dst_offset */
+                                                                256,  /* in_size       */
+                                                                0xDEADBEEF) );
+        ANVIL_EXPECT(in_cmd_buffer_ptr->record_update_buffer   (in_buffer_ptr,
+                                                                128, /* in_dst_offset */
+                                                                sizeof(update_data),
+                                                                update_data) );
+        ANVIL_EXPECT(in_cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT,
+                                                                Anvil::PipelineStageFlagBits::COMPUTE_SHADER_BIT,
+                                                                Anvil::DependencyFlagBits::NONE,
+                                                                0,       /* in_memory_barrier_count        */
+                                                                nullptr, /* in_memory_barriers_ptr         */
+                                                                1,       /* in_buffer_memory_barrier_count */
+                                                               &buffer_barrier,
+                                                                0,       /* in_image_memory_barrier_count  */
+                                                                nullptr) ); /* in_image_memory_barriers_ptr */
+        ANVIL_EXPECT(in_cmd_buffer_ptr->record_set_line_width  (2.5f) );
+        ANVIL_EXPECT(in_cmd_buffer_ptr->record_set_viewport    (0, /* in_first_viewport */
+                                                                2, /* in_viewport_count */
+                                                                viewports) );
+
+        return 5;
+    }
+
+    /* Verifies that both streams hold the same commands with the same arguments. Payloads of pipeline barriers are
+     * decoded, since the structures they are serialized as are padded. */
+    void verify_streams_match(const Anvil::CommandStream* in_stream_a_ptr,
+                              const Anvil::CommandStream* in_stream_b_ptr)
+    {
+        auto command_a_iterator = in_stream_a_ptr->begin();
+        auto command_b_iterator = in_stream_b_ptr->begin();
+
+        ANVIL_EXPECT(in_stream_a_ptr->get_n_commands  () == in_stream_b_ptr->get_n_commands  () );
+        ANVIL_EXPECT(in_stream_a_ptr->get_n_bytes_used() == in_stream_b_ptr->get_n_bytes_used() );
+
+        for (;
+             command_a_iterator != in_stream_a_ptr->end() &&
+             command_b_iterator != in_stream_b_ptr->end();
+           ++command_a_iterator,
+           ++command_b_iterator)
+        {
+            if (!ANVIL_EXPECT(command_a_iterator.get_command_type() == command_b_iterator.get_command_type() ) ||
+                !ANVIL_EXPECT(command_a_iterator.get_payload_size() == command_b_iterator.get_payload_size() ))
+            {
+                return;
+            }
+
+            if (command_a_iterator.get_command_type() == Anvil::COMMAND_TYPE_PIPELINE_BARRIER)
+            {
+                Anvil::CommandStream::Reader      reader_a(command_a_iterator);
+                Anvil::CommandStream::Reader      reader_b(command_b_iterator);
+                std::vector<Anvil::BufferBarrier> buffer_barriers_a;
+                std::vector<Anvil::BufferBarrier> buffer_barriers_b;
+                std::vector<Anvil::ImageBarrier>  image_barriers_a;
+                std::vector<Anvil::ImageBarrier>  image_barriers_b;
+                std::vector<Anvil::MemoryBarrier> memory_barriers_a;
+                std::vector<Anvil::MemoryBarrier> memory_barriers_b;
+
+                ANVIL_EXPECT(reader_a.read<Anvil::PipelineStageFlags>() == reader_b.read<Anvil::PipelineStageFlags>() );
+                ANVIL_EXPECT(reader_a.read<Anvil::PipelineStageFlags>() == reader_b.read<Anvil::PipelineStageFlags>() );
+                ANVIL_EXPECT(reader_a.read<Anvil::DependencyFlags>   () == reader_b.read<Anvil::DependencyFlags>   () );
+
+                reader_a.read_memory_barriers(&memory_barriers_a);
+                reader_b.read_memory_barriers(&memory_barriers_b);
+                reader_a.read_buffer_barriers(&buffer_barriers_a);
+                reader_b.read_buffer_barriers(&buffer_barriers_b);
+                reader_a.read_image_barriers (&image_barriers_a);
+                reader_b.read_image_barriers (&image_barriers_b);
+
+                ANVIL_EXPECT(memory_barriers_a.size() == memory_barriers_b.size() );
+                ANVIL_EXPECT(image_barriers_a.size () == image_barriers_b.size () );
+
+                if (ANVIL_EXPECT(buffer_barriers_a.size() == 1) &&
+                    ANVIL_EXPECT(buffer_barriers_b.size() == 1) )
+                {
+                    const auto& barrier_a = buffer_barriers_a.at(0);
+                    const auto& barrier_b = buffer_barriers_b.at(0);
+
+                    ANVIL_EXPECT(barrier_a.buffer_ptr      == barrier_b.buffer_ptr);
+                    ANVIL_EXPECT(barrier_a.dst_access_mask == barrier_b.dst_access_mask);
+                    ANVIL_EXPECT(barrier_a.offset          == 64                    &&
+                                 barrier_b.offset          == 64);
+                    ANVIL_EXPECT(barrier_a.size            == 128                   &&
+                                 barrier_b.size            == 128);
+                    ANVIL_EXPECT(barrier_a.src_access_mask == barrier_b.src_access_mask);
+                }
+            }
+            else
+            {
+                ANVIL_EXPECT(memcmp(command_a_iterator.get_payload(),
+                                    command_b_iterator.get_payload(),
+                                    command_a_iterator.get_payload_size() ) == 0);
+            }
+        }
+
+        ANVIL_EXPECT(command_a_iterator == in_stream_a_ptr->end() );
+        ANVIL_EXPECT(command_b_iterator == in_stream_b_ptr->end() );
+    }
+
+    /* Captures a few commands into a stream, replays the stream into another command buffer which has a second
+     * stream attached, and verifies that both streams hold the same commands. Also verifies that a cleared stream
+     * captures the same commands again without growing. */
+    AnvilBenchmarks::CheckRegistrar g_record_and_replay_check(
+        "command_stream/record_and_replay",
+        [](AnvilBenchmarks::Context* in_context_ptr)
+        {
+            Anvil::BufferUniquePtr               buffer_ptr;
+            Anvil::PrimaryCommandBufferUniquePtr capture_cmd_buffer_ptr;
+            Anvil::CommandStreamUniquePtr        capture_stream_ptr;
+            Anvil::SGPUDevice*                   device_ptr              = in_context_ptr->get_device();
+            uint32_t                             n_commands              = 0;
+            size_t                               n_bytes_used            = 0;
+            Anvil::PrimaryCommandBufferUniquePtr replay_cmd_buffer_ptr;
+            Anvil::CommandStreamUniquePtr        replay_stream_ptr;
+
+            if (device_ptr == nullptr)
+            {
+                return false;
+            }
+
+            buffer_ptr             = Anvil::Buffer::create(Anvil::BufferCreateInfo::create_alloc(device_ptr,
+                                                                                                 256,
+                                                                                                 Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
+                                                                                                 Anvil::SharingMode::EXCLUSIVE,
+                                                                                                 Anvil::BufferCreateFlagBits::NONE,
+                                                                                                 Anvil::BufferUsageFlagBits::STORAGE_BUFFER_BIT |
+                                                                                                 Anvil::BufferUsageFlagBits::TRANSFER_DST_BIT,
+                                                                                                 Anvil::MemoryFeatureFlagBits::NONE) );
+            capture_cmd_buffer_ptr = create_command_buffer        (device_ptr);
+            capture_stream_ptr     = Anvil::CommandStream::create();
+            replay_cmd_buffer_ptr  = create_command_buffer        (device_ptr);
+            replay_stream_ptr      = Anvil::CommandStream::create();
+
+            if (!ANVIL_EXPECT(buffer_ptr             != nullptr) ||
+                !ANVIL_EXPECT(capture_cmd_buffer_ptr != nullptr) ||
+                !ANVIL_EXPECT(replay_cmd_buffer_ptr  != nullptr) )
+            {
+                return true;
+            }
+
+            capture_cmd_buffer_ptr->set_command_stream(capture_stream_ptr.get() );
+            replay_cmd_buffer_ptr->set_command_stream (replay_stream_ptr.get() );
+
+            /* Capture */
+            capture_cmd_buffer_ptr->start_recording(true,   /* in_one_time_submit          */
+                                                    false); /* in_simultaneous_use_allowed */
+            {
+                n_commands = record_commands(capture_cmd_buffer_ptr.get(),
+                                             buffer_ptr.get() );
+            }
+            capture_cmd_buffer_ptr->stop_recording();
+
+            ANVIL_EXPECT(capture_stream_ptr->get_n_commands  () == n_commands);
+            ANVIL_EXPECT(capture_stream_ptr->get_n_bytes_used() >  0);
+
+            /* Replay */
+            replay_cmd_buffer_ptr->start_recording(true,   /* in_one_time_submit          */
+                                                   false); /* in_simultaneous_use_allowed */
+            {
+                ANVIL_EXPECT(capture_stream_ptr->replay(replay_cmd_buffer_ptr.get() ));
+            }
+            replay_cmd_buffer_ptr->stop_recording();
+
+            verify_streams_match(capture_stream_ptr.get(),
+                                 replay_stream_ptr.get() );
+
+            /* Re-capture into a cleared stream */
+            n_bytes_used = capture_stream_ptr->get_n_bytes_used();
+
+            capture_stream_ptr->clear();
+
+            ANVIL_EXPECT(capture_stream_ptr->get_n_commands  () == 0);
+            ANVIL_EXPECT(capture_stream_ptr->get_n_bytes_used() == 0);
+            ANVIL_EXPECT(capture_stream_ptr->begin()            == capture_stream_ptr->end() );
+
+            capture_cmd_buffer_ptr->start_recording(true,   /* in_one_time_submit          */
+                                                    false); /* in_simultaneous_use_allowed */
+            {
+                record_commands(capture_cmd_buffer_ptr.get(),
+                                buffer_ptr.get() );
+            }
+            capture_cmd_buffer_ptr->stop_recording();
+
+            ANVIL_EXPECT(capture_stream_ptr->get_n_bytes_used() == n_bytes_used);
+
+            verify_streams_match(capture_stream_ptr.get(),
+                                 replay_stream_ptr.get() );
+
+            capture_cmd_buffer_ptr->set_command_stream(nullptr);
+            replay_cmd_buffer_ptr->set_command_stream (nullptr);
+
+            return true;
+        });
+}
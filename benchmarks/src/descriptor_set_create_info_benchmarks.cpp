@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/descriptor_set_create_info.h"
+#include "benchmark.h"
+
+namespace
+{
+    const uint32_t g_n_bindings = 8;
+
+    /* Creates a DS create info describing a typical material descriptor set. */
+    Anvil::DescriptorSetCreateInfoUniquePtr create_ds_create_info()
+    {
+        static const Anvil::DescriptorType descriptor_types[] =
+        {
+            Anvil::DescriptorType::UNIFORM_BUFFER,
+            Anvil::DescriptorType::UNIFORM_BUFFER_DYNAMIC,
+            Anvil::DescriptorType::STORAGE_BUFFER,
+            Anvil::DescriptorType::COMBINED_IMAGE_SAMPLER,
+        };
+
+        auto result_ptr = Anvil::DescriptorSetCreateInfo::create();
+
+        for (uint32_t n_binding = 0;
+                      n_binding < g_n_bindings;
+                    ++n_binding)
+        {
+            result_ptr->add_binding(n_binding,
+                                    descriptor_types[n_binding % (sizeof(descriptor_types) / sizeof(descriptor_types[0]) )],
+                                    1 + n_binding % 3, /* in_descriptor_array_size */
+                                    Anvil::ShaderStageFlagBits::FRAGMENT_BIT | Anvil::ShaderStageFlagBits::VERTEX_BIT);
+        }
+
+        return result_ptr;
+    }
+
+    /* Builds a new DS create info, as done by apps & Anvil wrappers for every new descriptor set group. */
+    AnvilBenchmarks::Registrar g_create_benchmark(
+        "descriptor_set_create_info/create",
+        100000,       /* in_n_iterations          */
+        g_n_bindings, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                auto ds_create_info_ptr = create_ds_create_info();
+
+                AnvilBenchmarks::do_not_optimize(ds_create_info_ptr->get_n_bindings() );
+            }
+
+            return true;
+        });
+
+    /* Compares two identical DS create infos. This is what DescriptorSetLayoutManager does for every layout lookup. */
+    AnvilBenchmarks::Registrar g_compare_benchmark(
+        "descriptor_set_create_info/compare",
+        1000000,      /* in_n_iterations          */
+        g_n_bindings, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            static const auto ds_create_info1_ptr = create_ds_create_info();
+            static const auto ds_create_info2_ptr = create_ds_create_info();
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                AnvilBenchmarks::do_not_optimize(*ds_create_info1_ptr == *ds_create_info2_ptr);
+            }
+
+            return true;
+        });
+}
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/formats.h"
+#include "benchmark.h"
+
+namespace
+{
+    const uint32_t g_n_core_formats = VK_FORMAT_ASTC_12x12_SRGB_BLOCK            - VK_FORMAT_R4G4_UNORM_PACK8        + 1;
+    const uint32_t g_n_yuv_formats  = VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM_KHR - VK_FORMAT_G8B8G8R8_422_UNORM_KHR + 1;
+
+    /* Queries properties Image and ImageView wrappers look up at creation time, for all core formats. */
+    AnvilBenchmarks::Registrar g_core_format_properties_benchmark(
+        "formats/core_format_properties",
+        10000,            /* in_n_iterations          */
+        g_n_core_formats, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            std::vector<Anvil::ImageAspectFlags> aspects;
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                for (uint32_t current_format_vk  = VK_FORMAT_R4G4_UNORM_PACK8;
+                              current_format_vk <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
+                            ++current_format_vk)
+                {
+                    const auto current_format = static_cast<Anvil::Format>(current_format_vk);
+
+                    Anvil::Formats::get_format_aspects(current_format,
+                                                      &aspects);
+
+                    AnvilBenchmarks::do_not_optimize(aspects.size                                   () );
+                    AnvilBenchmarks::do_not_optimize(Anvil::Formats::get_format_n_components_nonyuv(current_format) );
+                    AnvilBenchmarks::do_not_optimize(Anvil::Formats::get_format_name               (current_format) );
+                    AnvilBenchmarks::do_not_optimize(Anvil::Formats::is_format_compressed          (current_format) );
+                }
+            }
+
+            return true;
+        });
+
+    /* As above, but for Y'CbCr formats, whose properties are stored separately. */
+    AnvilBenchmarks::Registrar g_yuv_format_properties_benchmark(
+        "formats/yuv_format_properties",
+        10000,           /* in_n_iterations          */
+        g_n_yuv_formats, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            std::vector<Anvil::ImageAspectFlags> aspects;
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                for (uint32_t current_format_vk  = VK_FORMAT_G8B8G8R8_422_UNORM_KHR;
+                              current_format_vk <= VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM_KHR;
+                            ++current_format_vk)
+                {
+                    const auto current_format = static_cast<Anvil::Format>(current_format_vk);
+
+                    Anvil::Formats::get_format_aspects(current_format,
+                                                      &aspects);
+
+                    AnvilBenchmarks::do_not_optimize(aspects.size                          () );
+                    AnvilBenchmarks::do_not_optimize(Anvil::Formats::get_format_n_planes (current_format) );
+                    AnvilBenchmarks::do_not_optimize(Anvil::Formats::get_format_name     (current_format) );
+                    AnvilBenchmarks::do_not_optimize(Anvil::Formats::is_format_compressed(current_format) );
+                }
+            }
+
+            return true;
+        });
+}
@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/fp16.h"
+#include "benchmark.h"
+#include <vector>
+
+namespace
+{
+    const uint32_t g_n_values = 4096;
+
+    /* Returns a set of FP32 values covering normals, denormals and values which overflow FP16. */
+    const std::vector<Anvil::float32_t>& get_fp32_values()
+    {
+        static std::vector<Anvil::float32_t> values;
+
+        if (values.size() == 0)
+        {
+            for (uint32_t n_value = 0;
+                          n_value < g_n_values;
+                        ++n_value)
+            {
+                values.push_back(Anvil::float32_t( (static_cast<float>(n_value) - g_n_values / 2) * 37.25f / static_cast<float>(1 + n_value % 97) ) );
+            }
+        }
+
+        return values;
+    }
+
+    /* Returns FP16 values whose bit patterns are spread evenly across the whole 16-bit range. */
+    const std::vector<Anvil::float16_t>& get_fp16_values()
+    {
+        static std::vector<Anvil::float16_t> values;
+
+        if (values.size() == 0)
+        {
+            for (uint32_t n_value = 0;
+                          n_value < g_n_values;
+                        ++n_value)
+            {
+                Anvil::float16_t new_value;
+
+                new_value.u = static_cast<unsigned short>(n_value * (65536 / g_n_values) );
+
+                values.push_back(new_value);
+            }
+        }
+
+        return values;
+    }
+
+    template<Anvil::float16_t (*ConversionFunction)(Anvil::float32_t)>
+    bool convert_fp32_to_fp16(AnvilBenchmarks::Context*,
+                              uint32_t in_n_iterations)
+    {
+        const auto& values = get_fp32_values();
+
+        for (uint32_t n_iteration = 0;
+                      n_iteration < in_n_iterations;
+                    ++n_iteration)
+        {
+            for (const auto& current_value : values)
+            {
+                AnvilBenchmarks::do_not_optimize(ConversionFunction(current_value).u);
+            }
+        }
+
+        return true;
+    }
+
+    template<Anvil::float32_t (*ConversionFunction)(Anvil::float16_t)>
+    bool convert_fp16_to_fp32(AnvilBenchmarks::Context*,
+                              uint32_t in_n_iterations)
+    {
+        const auto& values = get_fp16_values();
+
+        for (uint32_t n_iteration = 0;
+                      n_iteration < in_n_iterations;
+                    ++n_iteration)
+        {
+            for (const auto& current_value : values)
+            {
+                AnvilBenchmarks::do_not_optimize(ConversionFunction(current_value).u);
+            }
+        }
+
+        return true;
+    }
+
+    AnvilBenchmarks::Registrar g_fp16_to_fp32_fast3_benchmark    ("fp16/fp16_to_fp32_fast3",     1000, g_n_values, convert_fp16_to_fp32<Anvil::Utils::fp16_to_fp32_fast3>);
+    AnvilBenchmarks::Registrar g_fp16_to_fp32_full_benchmark     ("fp16/fp16_to_fp32_full",      1000, g_n_values, convert_fp16_to_fp32<Anvil::Utils::fp16_to_fp32_full>);
+    AnvilBenchmarks::Registrar g_fp32_to_fp16_fast3_benchmark    ("fp16/fp32_to_fp16_fast3",     1000, g_n_values, convert_fp32_to_fp16<Anvil::Utils::fp32_to_fp16_fast3>);
+    AnvilBenchmarks::Registrar g_fp32_to_fp16_full_benchmark     ("fp16/fp32_to_fp16_full",      1000, g_n_values, convert_fp32_to_fp16<Anvil::Utils::fp32_to_fp16_full>);
+    AnvilBenchmarks::Registrar g_fp32_to_fp16_full_rtne_benchmark("fp16/fp32_to_fp16_full_rtne", 1000, g_n_values, convert_fp32_to_fp16<Anvil::Utils::fp32_to_fp16_full_rtne>);
+}
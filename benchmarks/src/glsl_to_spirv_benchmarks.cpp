@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/glsl_to_spirv.h"
+#include "benchmark.h"
+
+namespace
+{
+    const uint32_t g_n_definitions = 16;
+
+    const char* g_fragment_shader_glsl = "#version 450\n"
+                                         "\n"
+                                         "layout(location = 0) in  vec2 uv;\n"
+                                         "layout(location = 0) out vec4 result;\n"
+                                         "\n"
+                                         "layout(set = 0, binding = 0) uniform sampler2D textures[N_TEXTURES];\n"
+                                         "\n"
+                                         "void main()\n"
+                                         "{\n"
+                                         "    result = vec4(0.0);\n"
+                                         "\n"
+                                         "    for (int n_texture = 0; n_texture < N_TEXTURES; ++n_texture)\n"
+                                         "    {\n"
+                                         "        result += texture(textures[n_texture], uv * SCALE);\n"
+                                         "    }\n"
+                                         "}\n";
+
+    /* Forms final GLSL source code out of the base source and a number of definitions. Does not invoke glslang,
+     * so no device is required. */
+    AnvilBenchmarks::Registrar g_source_assembly_benchmark(
+        "glsl_to_spirv/source_assembly",
+        20000,           /* in_n_iterations          */
+        g_n_definitions, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                auto generator_ptr = Anvil::GLSLShaderToSPIRVGenerator::create(nullptr, /* in_opt_device_ptr */
+                                                                               Anvil::GLSLShaderToSPIRVGenerator::MODE_USE_SPECIFIED_SOURCE,
+                                                                               g_fragment_shader_glsl,
+                                                                               Anvil::ShaderStage::FRAGMENT);
+
+                generator_ptr->add_definition_value_pair("N_TEXTURES",
+                                                         4);
+                generator_ptr->add_definition_value_pair("SCALE",
+                                                         "vec2(0.5)");
+
+                for (uint32_t n_definition = 2;
+                              n_definition < g_n_definitions;
+                            ++n_definition)
+                {
+                    generator_ptr->add_definition_value_pair("UNUSED_DEFINITION_" + std::to_string(n_definition),
+                                                             n_definition);
+                }
+
+                AnvilBenchmarks::do_not_optimize(generator_ptr->get_glsl_source_code().size() );
+            }
+
+            return true;
+        });
+}
@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/* AnvilBenchmarks entry point.
+ *
+ * Usage: AnvilBenchmarks [--checks] [--filter=<substring>] [--device=<substring>] [--repetitions=<n>]
+ *
+ * Results are written to stdout, one JSON object per line. --device picks the first physical device whose name
+ * contains the specified substring (eg. --device=llvmpipe to run against lavapipe). --checks runs behavioral checks
+ * instead of benchmarks, and makes the process exit with a failure code if any of them fails.
+ */
+#include "benchmark.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char* argv[])
+{
+    std::string device_filter;
+    std::string filter;
+    uint32_t    n_repetitions     = 5;
+    bool        should_run_checks = false;
+
+    for (int n_arg = 1;
+             n_arg < argc;
+           ++n_arg)
+    {
+        static const char* checks_arg         = "--checks";
+        static const char* device_prefix      = "--device=";
+        static const char* filter_prefix      = "--filter=";
+        static const char* repetitions_prefix = "--repetitions=";
+
+        if (strcmp(argv[n_arg],
+                   checks_arg) == 0)
+        {
+            should_run_checks = true;
+        }
+        else
+        if (strncmp(argv[n_arg],
+                    device_prefix,
+                    strlen(device_prefix) ) == 0)
+        {
+            device_filter = argv[n_arg] + strlen(device_prefix);
+        }
+        else
+        if (strncmp(argv[n_arg],
+                    filter_prefix,
+                    strlen(filter_prefix) ) == 0)
+        {
+            filter = argv[n_arg] + strlen(filter_prefix);
+        }
+        else
+        if (strncmp(argv[n_arg],
+                    repetitions_prefix,
+                    strlen(repetitions_prefix) ) == 0)
+        {
+            n_repetitions = static_cast<uint32_t>(atoi(argv[n_arg] + strlen(repetitions_prefix) ) );
+        }
+        else
+        {
+            fprintf(stderr,
+                    "Usage: %s [--checks] [--filter=<substring>] [--device=<substring>] [--repetitions=<n>]\n",
+                    argv[0]);
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (should_run_checks)
+    {
+        uint32_t n_failed_checks = 0;
+
+        AnvilBenchmarks::run_checks(filter,
+                                    device_filter,
+                                   &n_failed_checks);
+
+        return (n_failed_checks == 0) ? EXIT_SUCCESS
+                                      : EXIT_FAILURE;
+    }
+
+    if (n_repetitions == 0)
+    {
+        n_repetitions = 1;
+    }
+
+    return (AnvilBenchmarks::run_benchmarks(filter,
+                                            device_filter,
+                                            n_repetitions) > 0) ? EXIT_SUCCESS
+                                                                : EXIT_FAILURE;
+}
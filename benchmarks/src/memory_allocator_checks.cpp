@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/buffer_create_info.h"
+#include "misc/memory_allocator.h"
+#include "misc/memory_block_create_info.h"
+#include "wrappers/buffer.h"
+#include "wrappers/device.h"
+#include "wrappers/memory_block.h"
+#include "benchmark.h"
+#include <vector>
+
+namespace
+{
+    /* Describes a buffer added to a transient memory allocator by a check. */
+    typedef struct TransientBuffer
+    {
+        Anvil::BufferUniquePtr buffer_ptr;
+        uint32_t               first_use;
+        bool                   has_lifetime;
+        uint32_t               last_use;
+
+        TransientBuffer()
+            :first_use   (0),
+             has_lifetime(false),
+             last_use    (UINT32_MAX)
+        {
+            /* Stub */
+        }
+    } TransientBuffer;
+
+    /* Creates a buffer, adds it to @param in_memory_allocator_ptr and optionally declares its lifetime. */
+    bool add_transient_buffer(Anvil::SGPUDevice*            in_device_ptr,
+                              Anvil::MemoryAllocator*       in_memory_allocator_ptr,
+                              VkDeviceSize                  in_size,
+                              bool                          in_has_lifetime,
+                              uint32_t                      in_first_use,
+                              uint32_t                      in_last_use,
+                              std::vector<TransientBuffer>* inout_buffers_ptr)
+    {
+        TransientBuffer new_buffer;
+
+        new_buffer.buffer_ptr = Anvil::Buffer::create(Anvil::BufferCreateInfo::create_no_alloc(in_device_ptr,
+                                                                                               in_size,
+                                                                                               Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
+                                                                                               Anvil::SharingMode::EXCLUSIVE,
+                                                                                               Anvil::BufferCreateFlagBits::NONE,
+                                                                                               Anvil::BufferUsageFlagBits::STORAGE_BUFFER_BIT) );
+
+        if (!ANVIL_EXPECT(new_buffer.buffer_ptr != nullptr)                                    ||
+            !ANVIL_EXPECT(in_memory_allocator_ptr->add_buffer(new_buffer.buffer_ptr.get(),
+                                                              Anvil::MemoryFeatureFlagBits::NONE) ))
+        {
+            return false;
+        }
+
+        if (in_has_lifetime)
+        {
+            if (!ANVIL_EXPECT(in_memory_allocator_ptr->set_lifetime(new_buffer.buffer_ptr.get(),
+                                                                    in_first_use,
+                                                                    in_last_use) ))
+            {
+                return false;
+            }
+
+            new_buffer.first_use    = in_first_use;
+            new_buffer.has_lifetime = true;
+            new_buffer.last_use     = in_last_use;
+        }
+
+        inout_buffers_ptr->push_back(std::move(new_buffer) );
+
+        return true;
+    }
+
+    /* Verifies that buffers which are alive at the same time do not share memory, and that all buffers are bound at
+     * offsets meeting their alignment requirements.
+     *
+     * @return Number of buffer pairs which share memory. */
+    uint32_t verify_transient_buffers(std::vector<TransientBuffer>& in_buffers)
+    {
+        uint32_t n_aliased_pairs = 0;
+
+        for (uint32_t n_buffer = 0;
+                      n_buffer < static_cast<uint32_t>(in_buffers.size() );
+                    ++n_buffer)
+        {
+            auto&                      buffer              = in_buffers.at(n_buffer);
+            const Anvil::MemoryBlock*  memory_block_ptr    = buffer.buffer_ptr->get_memory_block(0);
+            const VkMemoryRequirements memory_requirements = buffer.buffer_ptr->get_memory_requirements();
+
+            if (!ANVIL_EXPECT(memory_block_ptr != nullptr) )
+            {
+                continue;
+            }
+
+            ANVIL_EXPECT((memory_block_ptr->get_start_offset() % memory_requirements.alignment) == 0);
+            ANVIL_EXPECT(memory_block_ptr->get_create_info_ptr()->get_size()                                         >= memory_requirements.size);
+
+            for (uint32_t n_other_buffer = n_buffer + 1;
+                          n_other_buffer < static_cast<uint32_t>(in_buffers.size() );
+                        ++n_other_buffer)
+            {
+                auto&                     other_buffer           = in_buffers.at(n_other_buffer);
+                const Anvil::MemoryBlock* other_memory_block_ptr = other_buffer.buffer_ptr->get_memory_block(0);
+                bool                      are_lifetimes_disjoint = false;
+
+                if (other_memory_block_ptr                 == nullptr                      ||
+                    other_memory_block_ptr->get_memory()   != memory_block_ptr->get_memory() )
+                {
+                    continue;
+                }
+
+                if (memory_block_ptr->get_start_offset()       >= other_memory_block_ptr->get_start_offset() + other_memory_block_ptr->get_create_info_ptr()->get_size() ||
+                    other_memory_block_ptr->get_start_offset() >= memory_block_ptr->get_start_offset()       + memory_block_ptr->get_create_info_ptr()->get_size() )
+                {
+                    continue;
+                }
+
+                /* Buffers without a declared lifetime must never be aliased */
+                are_lifetimes_disjoint = (buffer.has_lifetime                                     &&
+                                          other_buffer.has_lifetime                               &&
+                                          (buffer.last_use       < other_buffer.first_use ||
+                                           other_buffer.last_use < buffer.first_use) );
+
+                ANVIL_EXPECT(are_lifetimes_disjoint);
+
+                ++n_aliased_pairs;
+            }
+        }
+
+        return n_aliased_pairs;
+    }
+
+    /* Places three equally sized buffers: two which are used in disjoint passes, and a third one whose lifetime overlaps
+     * with both. Verifies that the first two share memory and the third does not overlap with either. */
+    AnvilBenchmarks::CheckRegistrar g_transient_aliasing_check(
+        "memory_allocator/transient_aliasing",
+        [](AnvilBenchmarks::Context* in_context_ptr)
+        {
+            std::vector<TransientBuffer>    buffers;
+            Anvil::SGPUDevice*              device_ptr           = in_context_ptr->get_device();
+            Anvil::MemoryAllocatorUniquePtr memory_allocator_ptr;
+
+            if (device_ptr == nullptr)
+            {
+                return false;
+            }
+
+            memory_allocator_ptr = Anvil::MemoryAllocator::create_transient(device_ptr);
+
+            if (!add_transient_buffer(device_ptr, memory_allocator_ptr.get(), 4096, true, 0, 1, &buffers) ||
+                !add_transient_buffer(device_ptr, memory_allocator_ptr.get(), 4096, true, 2, 3, &buffers) ||
+                !add_transient_buffer(device_ptr, memory_allocator_ptr.get(), 4096, true, 1, 2, &buffers) ||
+                !ANVIL_EXPECT        (memory_allocator_ptr->bake() ))
+            {
+                return true;
+            }
+
+            ANVIL_EXPECT(verify_transient_buffers(buffers)                                  == 1);
+            ANVIL_EXPECT(buffers.at(0).buffer_ptr->get_memory_block(0)->get_start_offset() == buffers.at(1).buffer_ptr->get_memory_block(0)->get_start_offset() );
+
+            return true;
+        });
+
+    /* Places buffers of various sizes with pseudo-random lifetimes, as well as buffers without a declared lifetime,
+     * and verifies that no buffers which are alive at the same time share memory. */
+    AnvilBenchmarks::CheckRegistrar g_transient_aliasing_random_lifetimes_check(
+        "memory_allocator/transient_aliasing_random_lifetimes",
+        [](AnvilBenchmarks::Context* in_context_ptr)
+        {
+            std::vector<TransientBuffer>    buffers;
+            Anvil::SGPUDevice*              device_ptr           = in_context_ptr->get_device();
+            Anvil::MemoryAllocatorUniquePtr memory_allocator_ptr;
+            uint32_t                        seed                 = 1;
+
+            if (device_ptr == nullptr)
+            {
+                return false;
+            }
+
+            memory_allocator_ptr = Anvil::MemoryAllocator::create_transient(device_ptr);
+
+            for (uint32_t n_buffer = 0;
+                          n_buffer < 32;
+                        ++n_buffer)
+            {
+                seed = seed * 1664525 + 1013904223;
+
+                const bool     has_lifetime = ((n_buffer % 8) != 7);
+                const uint32_t first_use    = (seed >> 8)  % 8;
+                const uint32_t last_use     = first_use + (seed >> 16) % 3;
+                const uint32_t size         = 256 * (1 + (seed >> 20) % 64);
+
+                if (!add_transient_buffer(device_ptr,
+                                          memory_allocator_ptr.get(),
+                                          size,
+                                          has_lifetime,
+                                          first_use,
+                                          last_use,
+                                         &buffers) )
+                {
+                    return true;
+                }
+            }
+
+            if (ANVIL_EXPECT(memory_allocator_ptr->bake() ))
+            {
+                ANVIL_EXPECT(verify_transient_buffers(buffers) > 0);
+            }
+
+            return true;
+        });
+}
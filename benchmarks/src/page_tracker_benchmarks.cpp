@@ -0,0 +1,351 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/page_tracker.h"
+#include "benchmark.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    const VkDeviceSize g_page_size     = 64 * 1024;
+    const uint32_t     g_n_pages       = 1024;
+    const uint32_t     g_n_pages_large = 256 * 1024;
+
+    /* PageTracker never dereferences memory block pointers, so a dummy non-null value is sufficient to mark
+     * pages as memory-backed. */
+    Anvil::MemoryBlock* const g_dummy_memory_block_ptr  = reinterpret_cast<Anvil::MemoryBlock*>(static_cast<uintptr_t>(g_page_size) );
+    Anvil::MemoryBlock* const g_dummy_memory_block2_ptr = reinterpret_cast<Anvil::MemoryBlock*>(static_cast<uintptr_t>(g_page_size * 2) );
+
+    /* Binds memory to all pages of a sparse resource one page at a time, and then unbinds the pages in the same order.
+     * This mirrors the sparse binding pattern of a streaming system, which updates residency at page granularity. */
+    AnvilBenchmarks::Registrar g_set_binding_per_page_benchmark(
+        "page_tracker/set_binding_per_page",
+        10,              /* in_n_iterations          */
+        g_n_pages * 2,   /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                Anvil::PageTracker page_tracker(g_page_size * g_n_pages,
+                                                g_page_size);
+
+                for (uint32_t n_page = 0;
+                              n_page < g_n_pages;
+                            ++n_page)
+                {
+                    page_tracker.set_binding(g_dummy_memory_block_ptr,
+                                             g_page_size * n_page, /* in_memory_block_start_offset */
+                                             g_page_size * n_page, /* in_start_offset              */
+                                             g_page_size);
+                }
+
+                for (uint32_t n_page = 0;
+                              n_page < g_n_pages;
+                            ++n_page)
+                {
+                    page_tracker.set_binding(nullptr,
+                                             0,                    /* in_memory_block_start_offset */
+                                             g_page_size * n_page, /* in_start_offset              */
+                                             g_page_size);
+                }
+
+                AnvilBenchmarks::do_not_optimize(page_tracker.get_n_pages_with_memory_backing() );
+            }
+
+            return true;
+        });
+
+    /* Looks up memory blocks bound to pseudo-randomly picked pages of a fully resident sparse resource. */
+    AnvilBenchmarks::Registrar g_get_memory_block_benchmark(
+        "page_tracker/get_memory_block",
+        100,       /* in_n_iterations          */
+        g_n_pages, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            Anvil::PageTracker page_tracker(g_page_size * g_n_pages,
+                                            g_page_size);
+
+            for (uint32_t n_page = 0;
+                          n_page < g_n_pages;
+                        ++n_page)
+            {
+                page_tracker.set_binding(g_dummy_memory_block_ptr,
+                                         g_page_size * n_page, /* in_memory_block_start_offset */
+                                         g_page_size * n_page, /* in_start_offset              */
+                                         g_page_size);
+            }
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                for (uint32_t n_lookup = 0;
+                              n_lookup < g_n_pages;
+                            ++n_lookup)
+                {
+                    const uint32_t n_page                    = (n_lookup * 401) % g_n_pages;
+                    VkDeviceSize   memory_region_start_offset = 0;
+
+                    AnvilBenchmarks::do_not_optimize(page_tracker.get_memory_block(g_page_size * n_page,
+                                                                                   g_page_size,
+                                                                                  &memory_region_start_offset) );
+                }
+            }
+
+            return true;
+        });
+
+    /* Binds memory to every page of a 16 GiB sparse resource, alternating between two memory blocks so that bindings
+     * cannot be coalesced, then looks up all pages in a pseudo-random order. */
+    AnvilBenchmarks::Registrar g_large_resource_benchmark(
+        "page_tracker/large_resource_bind_and_lookup",
+        1,                   /* in_n_iterations          */
+        g_n_pages_large * 2, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                Anvil::PageTracker page_tracker(g_page_size * g_n_pages_large,
+                                                g_page_size);
+
+                for (uint32_t n_page = 0;
+                              n_page < g_n_pages_large;
+                            ++n_page)
+                {
+                    page_tracker.set_binding(((n_page % 2) == 0) ? g_dummy_memory_block_ptr : g_dummy_memory_block2_ptr,
+                                             g_page_size * (n_page / 2), /* in_memory_block_start_offset */
+                                             g_page_size * n_page,       /* in_start_offset              */
+                                             g_page_size);
+                }
+
+                for (uint32_t n_lookup = 0;
+                              n_lookup < g_n_pages_large;
+                            ++n_lookup)
+                {
+                    const uint32_t n_page                     = (n_lookup * 40009) % g_n_pages_large;
+                    VkDeviceSize   memory_region_start_offset = 0;
+
+                    AnvilBenchmarks::do_not_optimize(page_tracker.get_memory_block(g_page_size * n_page,
+                                                                                   g_page_size,
+                                                                                  &memory_region_start_offset) );
+                }
+
+                AnvilBenchmarks::do_not_optimize(page_tracker.get_n_pages_with_memory_backing() );
+            }
+
+            return true;
+        });
+
+    /* Binds, overwrites and unbinds page runs of a small resource, and verifies that runs which continue the same region
+     * of the same memory block are coalesced, and split again when pages in the middle are rebound. */
+    AnvilBenchmarks::CheckRegistrar g_coalescing_check(
+        "page_tracker/coalescing",
+        [](AnvilBenchmarks::Context*)
+        {
+            Anvil::PageTracker page_tracker(g_page_size * 8,
+                                            g_page_size);
+            VkDeviceSize       memory_region_start_offset = 0;
+
+            /* Bind pages 0-3 one at a time to consecutive regions of the same memory block */
+            for (uint32_t n_page = 0;
+                          n_page < 4;
+                        ++n_page)
+            {
+                ANVIL_EXPECT(page_tracker.set_binding(g_dummy_memory_block_ptr,
+                                                      g_page_size * n_page, /* in_memory_block_start_offset */
+                                                      g_page_size * n_page, /* in_start_offset              */
+                                                      g_page_size) );
+            }
+
+            ANVIL_EXPECT(page_tracker.get_n_memory_blocks            () == 1);
+            ANVIL_EXPECT(page_tracker.get_n_pages_with_memory_backing() == 4);
+
+            ANVIL_EXPECT(page_tracker.get_memory_block(g_page_size * 2,
+                                                       g_page_size,
+                                                      &memory_region_start_offset) == g_dummy_memory_block_ptr);
+            ANVIL_EXPECT(memory_region_start_offset                                == g_page_size * 2);
+
+            /* Unbinding a page in the middle splits the run */
+            ANVIL_EXPECT(page_tracker.set_binding(nullptr,
+                                                  0,               /* in_memory_block_start_offset */
+                                                  g_page_size * 1, /* in_start_offset              */
+                                                  g_page_size) );
+
+            ANVIL_EXPECT(page_tracker.get_n_memory_blocks            () == 2);
+            ANVIL_EXPECT(page_tracker.get_n_pages_with_memory_backing() == 3);
+            ANVIL_EXPECT(page_tracker.get_memory_block               (g_page_size * 1,
+                                                                      g_page_size,
+                                                                     &memory_region_start_offset) == nullptr);
+
+            /* Binding a different region of the same memory block must not be coalesced with neighbors */
+            ANVIL_EXPECT(page_tracker.set_binding(g_dummy_memory_block_ptr,
+                                                  g_page_size * 7, /* in_memory_block_start_offset */
+                                                  g_page_size * 1, /* in_start_offset              */
+                                                  g_page_size) );
+
+            ANVIL_EXPECT(page_tracker.get_n_memory_blocks            () == 3);
+            ANVIL_EXPECT(page_tracker.get_n_pages_with_memory_backing() == 4);
+
+            /* Restoring the original binding merges all runs back */
+            ANVIL_EXPECT(page_tracker.set_binding(g_dummy_memory_block_ptr,
+                                                  g_page_size * 1, /* in_memory_block_start_offset */
+                                                  g_page_size * 1, /* in_start_offset              */
+                                                  g_page_size) );
+
+            ANVIL_EXPECT(page_tracker.get_n_memory_blocks            () == 1);
+            ANVIL_EXPECT(page_tracker.get_n_pages_with_memory_backing() == 4);
+
+            /* Overwriting part of the run with another memory block splits it into three */
+            ANVIL_EXPECT(page_tracker.set_binding(g_dummy_memory_block2_ptr,
+                                                  0,               /* in_memory_block_start_offset */
+                                                  g_page_size * 1, /* in_start_offset              */
+                                                  g_page_size * 2) );
+
+            ANVIL_EXPECT(page_tracker.get_n_memory_blocks            () == 3);
+            ANVIL_EXPECT(page_tracker.get_n_pages_with_memory_backing() == 4);
+
+            ANVIL_EXPECT(page_tracker.get_memory_block(g_page_size * 3,
+                                                       g_page_size,
+                                                      &memory_region_start_offset) == g_dummy_memory_block_ptr);
+            ANVIL_EXPECT(memory_region_start_offset                                == g_page_size * 3);
+
+            /* Unbinding the whole region removes all runs */
+            ANVIL_EXPECT(page_tracker.set_binding(nullptr,
+                                                  0, /* in_memory_block_start_offset */
+                                                  0, /* in_start_offset              */
+                                                  g_page_size * 8) );
+
+            ANVIL_EXPECT(page_tracker.get_n_memory_blocks            () == 0);
+            ANVIL_EXPECT(page_tracker.get_n_pages_with_memory_backing() == 0);
+
+            return true;
+        });
+
+    /* Applies pseudo-random binding updates to a resource whose size is not a multiple of the page size, and compares
+     * the tracker's state against a per-page reference after each update. */
+    AnvilBenchmarks::CheckRegistrar g_per_page_reference_check(
+        "page_tracker/per_page_reference",
+        [](AnvilBenchmarks::Context*)
+        {
+            const uint32_t                   n_pages             = 64;
+            const VkDeviceSize               region_size         = g_page_size * (n_pages - 1) + g_page_size / 2;
+            Anvil::MemoryBlock* const        memory_block_ptrs[] = {nullptr, g_dummy_memory_block_ptr, g_dummy_memory_block2_ptr};
+            Anvil::PageTracker               page_tracker         (region_size,
+                                                                   g_page_size);
+            std::vector<Anvil::MemoryBlock*> reference_memory_block_ptrs(n_pages,
+                                                                         nullptr);
+            std::vector<VkDeviceSize>        reference_offsets          (n_pages,
+                                                                         0);
+            uint32_t                         seed                = 1;
+
+            ANVIL_EXPECT(page_tracker.get_n_pages() == n_pages);
+
+            for (uint32_t n_update = 0;
+                          n_update < 2000;
+                        ++n_update)
+            {
+                seed = seed * 1664525 + 1013904223;
+
+                const uint32_t            n_start_page     = (seed >> 8)  % n_pages;
+                const uint32_t            n_update_pages   = 1 + (seed >> 16) % (n_pages - n_start_page);
+                Anvil::MemoryBlock* const memory_block_ptr = memory_block_ptrs[(seed >> 24) % 3];
+                const VkDeviceSize        memory_offset    = g_page_size * ((seed >> 26) % 4) * n_pages;
+                const VkDeviceSize        start_offset     = g_page_size * n_start_page;
+                const VkDeviceSize        size             = std::min(g_page_size * n_update_pages,
+                                                                      region_size - start_offset);
+                uint32_t                  n_backed_pages   = 0;
+
+                if (!ANVIL_EXPECT(page_tracker.set_binding(memory_block_ptr,
+                                                           memory_offset + start_offset,
+                                                           start_offset,
+                                                           size) ))
+                {
+                    break;
+                }
+
+                for (uint32_t n_page = n_start_page;
+                              n_page < n_start_page + n_update_pages;
+                            ++n_page)
+                {
+                    reference_memory_block_ptrs[n_page] = memory_block_ptr;
+                    reference_offsets          [n_page] = memory_offset + g_page_size * n_page;
+                }
+
+                for (uint32_t n_page = 0;
+                              n_page < n_pages;
+                            ++n_page)
+                {
+                    VkDeviceSize        memory_region_start_offset = 0;
+                    Anvil::MemoryBlock* result_ptr                 = page_tracker.get_memory_block(g_page_size * n_page,
+                                                                                                    (n_page == n_pages - 1) ? g_page_size / 2
+                                                                                                                            : g_page_size,
+                                                                                                   &memory_region_start_offset);
+
+                    ANVIL_EXPECT(result_ptr == reference_memory_block_ptrs[n_page]);
+
+                    if (result_ptr != nullptr)
+                    {
+                        ANVIL_EXPECT(memory_region_start_offset == reference_offsets[n_page]);
+
+                        ++n_backed_pages;
+                    }
+                }
+
+                ANVIL_EXPECT(page_tracker.get_n_pages_with_memory_backing() == n_backed_pages);
+
+                /* Runs must be disjoint, and runs which continue each other must have been coalesced */
+                {
+                    const Anvil::PageTracker::MemoryBlockBinding* prev_binding_ptr = nullptr;
+
+                    for (const auto& current_binding : page_tracker.get_bindings() )
+                    {
+                        const auto& binding = current_binding.second;
+
+                        ANVIL_EXPECT(binding.start_offset     == current_binding.first);
+                        ANVIL_EXPECT(binding.memory_block_ptr != nullptr);
+                        ANVIL_EXPECT(binding.size             >  0);
+
+                        if (prev_binding_ptr != nullptr)
+                        {
+                            ANVIL_EXPECT(prev_binding_ptr->start_offset + prev_binding_ptr->size <= binding.start_offset);
+
+                            ANVIL_EXPECT(!(prev_binding_ptr->memory_block_ptr                                    == binding.memory_block_ptr     &&
+                                           prev_binding_ptr->start_offset              + prev_binding_ptr->size == binding.start_offset         &&
+                                           prev_binding_ptr->memory_block_start_offset + prev_binding_ptr->size == binding.memory_block_start_offset) );
+                        }
+
+                        prev_binding_ptr = &binding;
+                    }
+                }
+            }
+
+            return true;
+        });
+}
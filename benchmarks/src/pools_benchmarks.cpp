@@ -0,0 +1,353 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/pools.h"
+#include "benchmark.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const uint32_t g_n_items_per_batch = 64;
+    const uint32_t g_n_threads         = 4;
+
+    typedef std::unique_ptr<uint64_t, std::function<void(uint64_t*)> > DummyItemUniquePtr;
+
+    /* Pool worker whose items are plain integers. Keeps pool item creation cost out of the measurements. */
+    class DummyPoolWorker : public Anvil::IPoolWorker<DummyItemUniquePtr>
+    {
+    public:
+        DummyItemUniquePtr create_item() override
+        {
+            return DummyItemUniquePtr(new uint64_t(0),
+                                      std::default_delete<uint64_t>() );
+        }
+
+        void release_item(DummyItemUniquePtr in_item_ptr) override
+        {
+            in_item_ptr.reset();
+        }
+
+        void reset_item(DummyItemUniquePtr& in_item_ptr) override
+        {
+            *in_item_ptr = 0;
+        }
+    };
+
+    typedef Anvil::GenericPool<uint64_t, DummyItemUniquePtr> DummyPool;
+
+    typedef std::unique_ptr<std::atomic<uint32_t>, std::function<void(std::atomic<uint32_t>*)> > OwnerItemUniquePtr;
+
+    /* Pool worker whose items hold an owner tag, which lets checks detect items handed out to more than one owner.
+     * Counts calls made by the pool. */
+    class CountingPoolWorker : public Anvil::IPoolWorker<OwnerItemUniquePtr>
+    {
+    public:
+        explicit CountingPoolWorker(std::atomic<uint32_t>* out_n_created_items_ptr,
+                                    std::atomic<uint32_t>* out_n_released_items_ptr,
+                                    std::atomic<uint32_t>* out_n_reset_items_ptr)
+            :m_n_created_items_ptr (out_n_created_items_ptr),
+             m_n_released_items_ptr(out_n_released_items_ptr),
+             m_n_reset_items_ptr   (out_n_reset_items_ptr)
+        {
+            /* Stub */
+        }
+
+        OwnerItemUniquePtr create_item() override
+        {
+            ++(*m_n_created_items_ptr);
+
+            return OwnerItemUniquePtr(new std::atomic<uint32_t>(0),
+                                      std::default_delete<std::atomic<uint32_t> >() );
+        }
+
+        void release_item(OwnerItemUniquePtr in_item_ptr) override
+        {
+            ++(*m_n_released_items_ptr);
+
+            in_item_ptr.reset();
+        }
+
+        void reset_item(OwnerItemUniquePtr& in_item_ptr) override
+        {
+            ANVIL_REDUNDANT_ARGUMENT_CONST(in_item_ptr);
+
+            ++(*m_n_reset_items_ptr);
+        }
+
+    private:
+        std::atomic<uint32_t>* m_n_created_items_ptr;
+        std::atomic<uint32_t>* m_n_released_items_ptr;
+        std::atomic<uint32_t>* m_n_reset_items_ptr;
+    };
+
+    typedef Anvil::GenericPool<std::atomic<uint32_t>, OwnerItemUniquePtr> OwnerPool;
+
+    /* Retrieves a single item from the pool and immediately returns it. */
+    AnvilBenchmarks::Registrar g_get_return_single_item_benchmark(
+        "pools/get_return_single_item",
+        1000000, /* in_n_iterations          */
+        1,       /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            DummyPool pool(g_n_items_per_batch,
+                           new DummyPoolWorker() );
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                auto item_ptr = pool.get_item();
+
+                AnvilBenchmarks::do_not_optimize(*item_ptr);
+            }
+
+            return true;
+        });
+
+    /* Retrieves a batch of items from the pool and returns them in reverse order, as is the case when a frame's
+     * worth of pooled objects is released. */
+    AnvilBenchmarks::Registrar g_get_return_batch_benchmark(
+        "pools/get_return_batch",
+        20000,               /* in_n_iterations          */
+        g_n_items_per_batch, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            DummyPool                       pool(g_n_items_per_batch,
+                                                 new DummyPoolWorker() );
+            std::vector<DummyItemUniquePtr> item_ptrs;
+
+            item_ptrs.reserve(g_n_items_per_batch);
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                for (uint32_t n_item = 0;
+                              n_item < g_n_items_per_batch;
+                            ++n_item)
+                {
+                    item_ptrs.push_back(pool.get_item() );
+                }
+
+                while (!item_ptrs.empty() )
+                {
+                    item_ptrs.pop_back();
+                }
+            }
+
+            return true;
+        });
+
+    /* Retrieves a single item from the pool and immediately returns it, from many threads sharing the pool at the
+     * same time. Measures the cost of contention on the pool's free list. */
+    AnvilBenchmarks::Registrar g_get_return_contended_benchmark(
+        "pools/get_return_contended",
+        250000,      /* in_n_iterations          */
+        g_n_threads, /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            DummyPool                pool(g_n_items_per_batch,
+                                          new DummyPoolWorker() );
+            std::vector<std::thread> threads;
+
+            for (uint32_t n_thread = 0;
+                          n_thread < g_n_threads;
+                        ++n_thread)
+            {
+                threads.push_back(
+                    std::thread([&pool, in_n_iterations]()
+                    {
+                        for (uint32_t n_iteration = 0;
+                                      n_iteration < in_n_iterations;
+                                    ++n_iteration)
+                        {
+                            auto item_ptr = pool.get_item();
+
+                            AnvilBenchmarks::do_not_optimize(*item_ptr);
+                        }
+                    })
+                );
+            }
+
+            for (auto& current_thread : threads)
+            {
+                current_thread.join();
+            }
+
+            return true;
+        });
+
+    /* Verifies that preallocated items are handed out before new ones are created, that returned items are reused
+     * and reset, that the pool grows past its chunk boundaries, and that all items are released at tear-down time. */
+    AnvilBenchmarks::CheckRegistrar g_item_lifetime_check(
+        "pools/item_lifetime",
+        [](AnvilBenchmarks::Context*)
+        {
+            const uint32_t        n_items_to_preallocate = 4;
+            const uint32_t        n_items                = 100;
+            std::atomic<uint32_t> n_created_items        (0);
+            std::atomic<uint32_t> n_released_items       (0);
+            std::atomic<uint32_t> n_reset_items          (0);
+
+            {
+                OwnerPool                           pool         (n_items_to_preallocate,
+                                                                  new CountingPoolWorker(&n_created_items,
+                                                                                         &n_released_items,
+                                                                                         &n_reset_items) );
+                std::vector<OwnerItemUniquePtr>     item_ptrs;
+                std::vector<std::atomic<uint32_t>*> raw_item_ptrs;
+
+                ANVIL_EXPECT(n_created_items == n_items_to_preallocate);
+
+                /* A returned item is the first one to be handed out again */
+                {
+                    std::atomic<uint32_t>* raw_item_ptr = nullptr;
+
+                    {
+                        auto item_ptr = pool.get_item();
+
+                        raw_item_ptr = item_ptr.get();
+                    }
+
+                    ANVIL_EXPECT(pool.get_item().get() == raw_item_ptr);
+                    ANVIL_EXPECT(n_reset_items         == 2);
+                }
+
+                for (uint32_t n_item = 0;
+                              n_item < n_items;
+                            ++n_item)
+                {
+                    item_ptrs.push_back    (pool.get_item() );
+                    raw_item_ptrs.push_back(item_ptrs.back().get() );
+
+                    /* Preallocated items must be used up before new items are created */
+                    ANVIL_EXPECT(n_created_items == std::max(n_items_to_preallocate,
+                                                             n_item + 1) );
+                }
+
+                /* Items which are in use at the same time must be distinct */
+                std::sort(raw_item_ptrs.begin(),
+                          raw_item_ptrs.end  () );
+
+                ANVIL_EXPECT(std::adjacent_find(raw_item_ptrs.begin(),
+                                                raw_item_ptrs.end  () ) == raw_item_ptrs.end() );
+
+                /* Returning all items and getting them back must not create new ones */
+                item_ptrs.clear();
+
+                for (uint32_t n_item = 0;
+                              n_item < n_items;
+                            ++n_item)
+                {
+                    item_ptrs.push_back(pool.get_item() );
+                }
+
+                ANVIL_EXPECT(n_created_items == n_items);
+                ANVIL_EXPECT(n_reset_items   == n_items * 2 + 2);
+
+                item_ptrs.clear();
+
+                ANVIL_EXPECT(n_released_items == 0);
+            }
+
+            ANVIL_EXPECT(n_released_items == n_created_items);
+
+            return true;
+        });
+
+    /* Has many threads get and return items at the same time, tagging each item with its owner for as long as it is
+     * held. An item handed out to two threads at the same time shows up as a tag mismatch. */
+    AnvilBenchmarks::CheckRegistrar g_contended_ownership_check(
+        "pools/contended_ownership",
+        [](AnvilBenchmarks::Context*)
+        {
+            const uint32_t           n_iterations          = 20000;
+            std::atomic<uint32_t>    n_created_items       (0);
+            std::atomic<uint32_t>    n_ownership_conflicts (0);
+            std::atomic<uint32_t>    n_released_items      (0);
+            std::atomic<uint32_t>    n_reset_items         (0);
+            std::vector<std::thread> threads;
+
+            {
+                OwnerPool pool(2, /* in_n_items_to_preallocate */
+                               new CountingPoolWorker(&n_created_items,
+                                                      &n_released_items,
+                                                      &n_reset_items) );
+
+                for (uint32_t n_thread = 0;
+                              n_thread < g_n_threads;
+                            ++n_thread)
+                {
+                    threads.push_back(
+                        std::thread([&pool, &n_ownership_conflicts, n_iterations, n_thread]()
+                        {
+                            const uint32_t owner_tag = n_thread + 1;
+
+                            for (uint32_t n_iteration = 0;
+                                          n_iteration < n_iterations;
+                                        ++n_iteration)
+                            {
+                                OwnerItemUniquePtr item_ptrs[2] = {pool.get_item(), pool.get_item()};
+
+                                for (auto& current_item_ptr : item_ptrs)
+                                {
+                                    if (current_item_ptr->exchange(owner_tag) != 0)
+                                    {
+                                        ++n_ownership_conflicts;
+                                    }
+                                }
+
+                                std::this_thread::yield();
+
+                                for (auto& current_item_ptr : item_ptrs)
+                                {
+                                    if (current_item_ptr->exchange(0) != owner_tag)
+                                    {
+                                        ++n_ownership_conflicts;
+                                    }
+                                }
+                            }
+                        })
+                    );
+                }
+
+                for (auto& current_thread : threads)
+                {
+                    current_thread.join();
+                }
+
+                ANVIL_EXPECT(n_ownership_conflicts == 0);
+                ANVIL_EXPECT(n_created_items       <= g_n_threads * 2);
+                ANVIL_EXPECT(n_reset_items         == g_n_threads * n_iterations * 2);
+            }
+
+            ANVIL_EXPECT(n_released_items == n_created_items);
+
+            return true;
+        });
+}
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/submission_batch.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
+#include "wrappers/device.h"
+#include "wrappers/queue.h"
+#include "benchmark.h"
+
+/* NOTE: Each benchmark function call allocates & records a single empty command buffer, which is then submitted
+ *       the requested number of times. The one-off setup cost is negligible compared to the submissions.
+ *
+ *       To keep the number of in-flight submissions bounded, the queue is drained every N_SUBMISSIONS_PER_DRAIN
+ *       submissions.
+ */
+#define N_SUBMISSIONS_PER_BATCH (16)
+#define N_SUBMISSIONS_PER_DRAIN (256)
+
+namespace
+{
+    Anvil::PrimaryCommandBufferUniquePtr create_empty_command_buffer(Anvil::SGPUDevice* in_device_ptr)
+    {
+        auto queue_ptr      = in_device_ptr->get_universal_queue(0);
+        auto cmd_buffer_ptr = in_device_ptr->get_command_pool_for_queue_family_index(queue_ptr->get_queue_family_index() )->alloc_primary_level_command_buffer();
+
+        cmd_buffer_ptr->start_recording(false, /* in_one_time_submit          */
+                                        true); /* in_simultaneous_use_allowed */
+        cmd_buffer_ptr->stop_recording ();
+
+        return cmd_buffer_ptr;
+    }
+
+    /* Submits a single command buffer per vkQueueSubmit() call. */
+    AnvilBenchmarks::Registrar g_submit_benchmark(
+        "queue/submit",
+        10000, /* in_n_iterations          */
+        1,     /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context* in_context_ptr,
+           uint32_t                  in_n_iterations)
+        {
+            auto device_ptr = in_context_ptr->get_device();
+
+            if (device_ptr == nullptr)
+            {
+                return false;
+            }
+
+            auto queue_ptr      = device_ptr->get_universal_queue(0);
+            auto cmd_buffer_ptr = create_empty_command_buffer  (device_ptr);
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                queue_ptr->submit(
+                    Anvil::SubmitInfo::create(cmd_buffer_ptr.get(),
+                                              0,       /* in_n_semaphores_to_signal              */
+                                              nullptr, /* in_opt_semaphore_to_signal_ptrs_ptr    */
+                                              0,       /* in_n_semaphores_to_wait_on             */
+                                              nullptr, /* in_opt_semaphore_to_wait_on_ptrs_ptr   */
+                                              nullptr, /* in_opt_dst_stage_masks_to_wait_on_ptrs */
+                                              false)   /* in_should_block                        */
+                );
+
+                if ((n_iteration % N_SUBMISSIONS_PER_DRAIN) == (N_SUBMISSIONS_PER_DRAIN - 1) )
+                {
+                    queue_ptr->wait_idle();
+                }
+            }
+
+            queue_ptr->wait_idle();
+
+            return true;
+        });
+
+    /* Submits N_SUBMISSIONS_PER_BATCH command buffers, each described by a separate SubmitInfo, with a single
+     * vkQueueSubmit() call. */
+    AnvilBenchmarks::Registrar g_submit_batch_benchmark(
+        "queue/submit_batch",
+        10000 / N_SUBMISSIONS_PER_BATCH, /* in_n_iterations          */
+        N_SUBMISSIONS_PER_BATCH,         /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context* in_context_ptr,
+           uint32_t                  in_n_iterations)
+        {
+            Anvil::SubmissionBatch batch;
+            auto                   device_ptr = in_context_ptr->get_device();
+
+            if (device_ptr == nullptr)
+            {
+                return false;
+            }
+
+            auto queue_ptr      = device_ptr->get_universal_queue(0);
+            auto cmd_buffer_ptr = create_empty_command_buffer  (device_ptr);
+
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                for (uint32_t n_submission = 0;
+                              n_submission < N_SUBMISSIONS_PER_BATCH;
+                            ++n_submission)
+                {
+                    batch.add(
+                        Anvil::SubmitInfo::create(cmd_buffer_ptr.get(),
+                                                  0,       /* in_n_semaphores_to_signal              */
+                                                  nullptr, /* in_opt_semaphore_to_signal_ptrs_ptr    */
+                                                  0,       /* in_n_semaphores_to_wait_on             */
+                                                  nullptr, /* in_opt_semaphore_to_wait_on_ptrs_ptr   */
+                                                  nullptr, /* in_opt_dst_stage_masks_to_wait_on_ptrs */
+                                                  false)   /* in_should_block                        */
+                    );
+                }
+
+                queue_ptr->submit(&batch);
+
+                if ((n_iteration % (N_SUBMISSIONS_PER_DRAIN / N_SUBMISSIONS_PER_BATCH) ) == (N_SUBMISSIONS_PER_DRAIN / N_SUBMISSIONS_PER_BATCH - 1) )
+                {
+                    queue_ptr->wait_idle();
+                }
+            }
+
+            queue_ptr->wait_idle();
+
+            return true;
+        });
+}
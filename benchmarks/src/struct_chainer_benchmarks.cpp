@@ -0,0 +1,253 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/struct_chainer.h"
+#include "benchmark.h"
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    /* Fills the chainer with the structures Queue::submit() chains together for a protected MGPU submission. */
+    void fill_submit_info_chainer(Anvil::StructChainer<VkSubmitInfo>* in_chainer_ptr)
+    {
+        static const VkCommandBuffer cmd_buffers_vk         [4] = {VK_NULL_HANDLE};
+        static const uint32_t        cmd_buffer_device_masks[4] = {1, 1, 1, 1};
+
+        VkDeviceGroupSubmitInfoKHR device_group_submit_info;
+        VkProtectedSubmitInfo      protected_submit_info;
+        VkSubmitInfo               submit_info;
+
+        submit_info.commandBufferCount   = 4;
+        submit_info.pCommandBuffers      = cmd_buffers_vk;
+        submit_info.pNext                = nullptr;
+        submit_info.pSignalSemaphores    = nullptr;
+        submit_info.pWaitDstStageMask    = nullptr;
+        submit_info.pWaitSemaphores      = nullptr;
+        submit_info.signalSemaphoreCount = 0;
+        submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.waitSemaphoreCount   = 0;
+
+        device_group_submit_info.commandBufferCount            = 4;
+        device_group_submit_info.pCommandBufferDeviceMasks     = cmd_buffer_device_masks;
+        device_group_submit_info.pNext                         = nullptr;
+        device_group_submit_info.pSignalSemaphoreDeviceIndices = nullptr;
+        device_group_submit_info.pWaitSemaphoreDeviceIndices   = nullptr;
+        device_group_submit_info.signalSemaphoreCount          = 0;
+        device_group_submit_info.sType                         = VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR;
+        device_group_submit_info.waitSemaphoreCount            = 0;
+
+        protected_submit_info.pNext           = nullptr;
+        protected_submit_info.protectedSubmit = VK_TRUE;
+        protected_submit_info.sType           = VK_STRUCTURE_TYPE_PROTECTED_SUBMIT_INFO;
+
+        in_chainer_ptr->append_struct(submit_info);
+        in_chainer_ptr->append_struct(device_group_submit_info);
+        in_chainer_ptr->append_struct(protected_submit_info);
+    }
+
+    /* Appends a VkDeviceGroupSubmitInfo struct whose device mask array is stored as a helper structure, followed by
+     * @param in_n_protected_submit_infos VkProtectedSubmitInfo structs, to a chainer which only holds the root struct. */
+    void fill_chainer_with_helper_data(Anvil::StructChainer<VkSubmitInfo>* in_chainer_ptr,
+                                       const std::vector<uint32_t>&        in_device_masks,
+                                       uint32_t                            in_n_protected_submit_infos)
+    {
+        VkDeviceGroupSubmitInfoKHR device_group_submit_info = {};
+        Anvil::StructID            device_group_submit_info_id;
+
+        device_group_submit_info.commandBufferCount = static_cast<uint32_t>(in_device_masks.size() );
+        device_group_submit_info.sType              = VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR;
+
+        device_group_submit_info_id = in_chainer_ptr->append_struct(device_group_submit_info);
+
+        in_chainer_ptr->store_helper_structure_vector(in_device_masks,
+                                                      device_group_submit_info_id,
+                                                      offsetof(VkDeviceGroupSubmitInfoKHR, pCommandBufferDeviceMasks) );
+
+        for (uint32_t n_protected_submit_info = 0;
+                      n_protected_submit_info < in_n_protected_submit_infos;
+                    ++n_protected_submit_info)
+        {
+            VkProtectedSubmitInfo protected_submit_info = {};
+
+            protected_submit_info.protectedSubmit = n_protected_submit_info % 2;
+            protected_submit_info.sType           = VK_STRUCTURE_TYPE_PROTECTED_SUBMIT_INFO;
+
+            in_chainer_ptr->append_struct(protected_submit_info);
+        }
+    }
+
+    /* Verifies a chain formed from structs appended by fill_chainer_with_helper_data(). */
+    void verify_chain_with_helper_data(const VkSubmitInfo*          in_root_struct_ptr,
+                                       const std::vector<uint32_t>& in_device_masks,
+                                       uint32_t                     in_n_protected_submit_infos)
+    {
+        const VkDeviceGroupSubmitInfoKHR* device_group_submit_info_ptr = reinterpret_cast<const VkDeviceGroupSubmitInfoKHR*>(in_root_struct_ptr->pNext);
+        const VkProtectedSubmitInfo*      protected_submit_info_ptr    = nullptr;
+
+        ANVIL_EXPECT(in_root_struct_ptr->sType              == VK_STRUCTURE_TYPE_SUBMIT_INFO);
+        ANVIL_EXPECT(in_root_struct_ptr->commandBufferCount == static_cast<uint32_t>(in_device_masks.size() ) );
+
+        if (!ANVIL_EXPECT(device_group_submit_info_ptr        != nullptr                                       &&
+                          device_group_submit_info_ptr->sType == VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR) )
+        {
+            return;
+        }
+
+        /* The helper array must have been copied, not referenced */
+        ANVIL_EXPECT(device_group_submit_info_ptr->commandBufferCount        == static_cast<uint32_t>(in_device_masks.size() ) );
+        ANVIL_EXPECT(device_group_submit_info_ptr->pCommandBufferDeviceMasks != in_device_masks.data() );
+
+        for (uint32_t n_device_mask = 0;
+                      n_device_mask < static_cast<uint32_t>(in_device_masks.size() );
+                    ++n_device_mask)
+        {
+            ANVIL_EXPECT(device_group_submit_info_ptr->pCommandBufferDeviceMasks[n_device_mask] == in_device_masks.at(n_device_mask) );
+        }
+
+        protected_submit_info_ptr = reinterpret_cast<const VkProtectedSubmitInfo*>(device_group_submit_info_ptr->pNext);
+
+        for (uint32_t n_protected_submit_info = 0;
+                      n_protected_submit_info < in_n_protected_submit_infos;
+                    ++n_protected_submit_info)
+        {
+            if (!ANVIL_EXPECT(protected_submit_info_ptr        != nullptr                                &&
+                              protected_submit_info_ptr->sType == VK_STRUCTURE_TYPE_PROTECTED_SUBMIT_INFO) )
+            {
+                return;
+            }
+
+            ANVIL_EXPECT(protected_submit_info_ptr->protectedSubmit == n_protected_submit_info % 2);
+
+            protected_submit_info_ptr = reinterpret_cast<const VkProtectedSubmitInfo*>(protected_submit_info_ptr->pNext);
+        }
+
+        ANVIL_EXPECT(protected_submit_info_ptr == nullptr);
+    }
+
+    /* Copies the chain to a new StructChain instance. This is what all call sites used to do. */
+    AnvilBenchmarks::Registrar g_create_chain_benchmark(
+        "struct_chainer/create_chain",
+        1000000, /* in_n_iterations          */
+        1,       /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                Anvil::StructChainer<VkSubmitInfo> struct_chainer;
+
+                fill_submit_info_chainer(&struct_chainer);
+
+                auto chain_ptr = struct_chainer.create_chain();
+
+                AnvilBenchmarks::do_not_optimize(chain_ptr->get_root_struct()->pNext);
+            }
+
+            return true;
+        });
+
+    /* Forms the chain in-place. Allocation-free for chains which fit in the chainer's inline storage. */
+    AnvilBenchmarks::Registrar g_bake_chain_benchmark(
+        "struct_chainer/bake_chain",
+        1000000, /* in_n_iterations          */
+        1,       /* in_n_items_per_iteration */
+        [](AnvilBenchmarks::Context*,
+           uint32_t in_n_iterations)
+        {
+            for (uint32_t n_iteration = 0;
+                          n_iteration < in_n_iterations;
+                        ++n_iteration)
+            {
+                Anvil::StructChainer<VkSubmitInfo> struct_chainer;
+
+                fill_submit_info_chainer(&struct_chainer);
+
+                AnvilBenchmarks::do_not_optimize(struct_chainer.bake_chain()->pNext);
+            }
+
+            return true;
+        });
+
+    /* Forms chains which fit in the chainer's inline storage, and chains which have outgrown it, both in-place and
+     * in a StructChain instance. Verifies that structs are linked in the order they were appended, and that helper
+     * structure pointers are patched to copies of the helper data. */
+    AnvilBenchmarks::CheckRegistrar g_chain_layout_check(
+        "struct_chainer/chain_layout",
+        [](AnvilBenchmarks::Context*)
+        {
+            /* The larger configuration exceeds inline capacity of all storage vectors */
+            const uint32_t n_device_masks_per_config[]           = {4, 300};
+            const uint32_t n_protected_submit_infos_per_config[] = {1, 40};
+
+            for (uint32_t n_config = 0;
+                          n_config < sizeof(n_device_masks_per_config) / sizeof(n_device_masks_per_config[0]);
+                        ++n_config)
+            {
+                Anvil::StructChainUniquePtr<VkSubmitInfo>            chain_ptr;
+                std::vector<uint32_t>                                device_masks             (n_device_masks_per_config[n_config]);
+                const uint32_t                                       n_protected_submit_infos = n_protected_submit_infos_per_config[n_config];
+                std::unique_ptr<Anvil::StructChainer<VkSubmitInfo> > struct_chainer_ptr       (new Anvil::StructChainer<VkSubmitInfo>() );
+                VkSubmitInfo                                         submit_info              = {};
+
+                for (uint32_t n_device_mask = 0;
+                              n_device_mask < static_cast<uint32_t>(device_masks.size() );
+                            ++n_device_mask)
+                {
+                    device_masks.at(n_device_mask) = 1u << (n_device_mask % 32);
+                }
+
+                submit_info.commandBufferCount = static_cast<uint32_t>(device_masks.size() );
+                submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+                struct_chainer_ptr->append_struct(submit_info);
+
+                fill_chainer_with_helper_data(struct_chainer_ptr.get(),
+                                              device_masks,
+                                              n_protected_submit_infos);
+
+                ANVIL_EXPECT(struct_chainer_ptr->get_n_structs() == 2 + n_protected_submit_infos);
+
+                verify_chain_with_helper_data(struct_chainer_ptr->bake_chain(),
+                                              device_masks,
+                                              n_protected_submit_infos);
+
+                /* Chains created with create_chain() must outlive the chainer */
+                chain_ptr = struct_chainer_ptr->create_chain();
+
+                struct_chainer_ptr.reset();
+
+                if (ANVIL_EXPECT(chain_ptr != nullptr) )
+                {
+                    ANVIL_EXPECT(chain_ptr->root_struct_ptr == chain_ptr->get_root_struct() );
+
+                    verify_chain_with_helper_data(chain_ptr->get_root_struct(),
+                                                  device_masks,
+                                                  n_protected_submit_infos);
+                }
+            }
+
+            return true;
+        });
+}
@@ -40,6 +40,7 @@
 #endif
 
 #include <algorithm>
+#include <thread>
 
 namespace Anvil
 {
@@ -167,6 +168,37 @@ namespace Anvil
         const Anvil::Image* image_ptr;
     } OnMemoryBlockNeededForImageCallbackArgument;
 
+    typedef struct OnMemoryPressureThresholdCrossedCallbackArgument : public Anvil::CallbackArgument
+    {
+        /** Constructor.
+         *
+         *  @param in_tracker_ptr Memory budget tracker which fired the notification.
+         *  @param in_n_heap      Index of the memory heap whose estimated usage has exceeded the threshold.
+         *  @param in_threshold   Threshold which has been exceeded, expressed as a fraction of the heap budget.
+         *  @param in_usage       Estimated heap usage at the time the notification was fired.
+         *  @param in_budget      Heap budget at the time the notification was fired.
+         **/
+        explicit OnMemoryPressureThresholdCrossedCallbackArgument(const Anvil::MemoryBudgetTracker* in_tracker_ptr,
+                                                                  uint32_t                          in_n_heap,
+                                                                  float                             in_threshold,
+                                                                  VkDeviceSize                      in_usage,
+                                                                  VkDeviceSize                      in_budget)
+            :budget     (in_budget),
+             n_heap     (in_n_heap),
+             threshold  (in_threshold),
+             tracker_ptr(in_tracker_ptr),
+             usage      (in_usage)
+        {
+            /* Stub */
+        }
+
+        VkDeviceSize                      budget;
+        uint32_t                          n_heap;
+        float                             threshold;
+        const Anvil::MemoryBudgetTracker* tracker_ptr;
+        VkDeviceSize                      usage;
+    } OnMemoryPressureThresholdCrossedCallbackArgument;
+
     typedef struct OnNewBindingAddedToDescriptorSetLayoutCallbackArgument : public Anvil::CallbackArgument
     {
         const DescriptorSetLayout* descriptor_set_layout_ptr;
@@ -273,6 +305,11 @@ namespace Anvil
 
     /** Provides call-back support for inheriting classes. Please see wrappers/callbacks.h header for
      *  more details.
+     *
+     *  Subscribers of each callback slot are stored in an immutable snapshot. Callbacks are fired without
+     *  taking a lock: the dispatching thread walks the snapshot which was current at the time the dispatch
+     *  started. Registration and unregistration are serialized, and publish a modified copy of the snapshot.
+     *  Snapshots which have been replaced are released as soon as the last in-flight dispatch finishes.
      **/
     class CallbacksSupportProvider : public ICallbacksSupportClient
     {
@@ -289,9 +326,17 @@ namespace Anvil
         {
             anvil_assert(in_callback_id_count > 0);
 
-            m_callback_id_count = in_callback_id_count;
-            m_callbacks         = new Callbacks[static_cast<uintptr_t>(in_callback_id_count)];
-            m_callbacks_locked  = false;
+            m_callback_id_count       = in_callback_id_count;
+            m_callback_snapshots      = new std::atomic<const Callbacks*>[static_cast<uintptr_t>(in_callback_id_count)];
+            m_has_retired_snapshots   = false;
+            m_n_active_readers        = 0;
+
+            for (CallbackID n_callback_id = 0;
+                            n_callback_id < in_callback_id_count;
+                          ++n_callback_id)
+            {
+                m_callback_snapshots[n_callback_id].store(nullptr);
+            }
         }
 
         /** Destructor.
@@ -301,9 +346,23 @@ namespace Anvil
          **/
         virtual ~CallbacksSupportProvider()
         {
-            delete [] m_callbacks;
+            anvil_assert(m_n_active_readers == 0);
 
-            m_callbacks = nullptr;
+            for (CallbackID n_callback_id = 0;
+                            n_callback_id < m_callback_id_count;
+                          ++n_callback_id)
+            {
+                delete m_callback_snapshots[n_callback_id].load();
+            }
+
+            for (auto snapshot_ptr : m_retired_snapshots)
+            {
+                delete snapshot_ptr;
+            }
+
+            delete [] m_callback_snapshots;
+
+            m_callback_snapshots = nullptr;
         }
 
         /* ICallbacksSupportClient interface implementation */
@@ -326,10 +385,14 @@ namespace Anvil
 
             anvil_assert(in_callback_id < m_callback_id_count);
 
-            return std::find(m_callbacks[in_callback_id].begin(),
-                             m_callbacks[in_callback_id].end(),
-                             Callback(in_callback_function,
-                                      in_callback_function_owner_ptr) ) != m_callbacks[in_callback_id].end();
+            /* Snapshots are only released by writers, which hold the mutex */
+            const Callbacks* snapshot_ptr = m_callback_snapshots[in_callback_id].load();
+
+            return (snapshot_ptr != nullptr                                       &&
+                    std::find(snapshot_ptr->begin(),
+                              snapshot_ptr->end(),
+                              Callback(in_callback_function,
+                                       in_callback_function_owner_ptr) ) != snapshot_ptr->end() );
         }
 
         /** Registers a new call-back client.
@@ -337,6 +400,9 @@ namespace Anvil
          *  Note that the function does NOT check if the specified callback func ptr + user argument
          *  has not already been registered.
          *
+         *  Can be called from a callback handler. The new subscriber will not be called back by
+         *  callback() invocations which are already in progress.
+         *
          *  @param in_callback_id        ID of the call-back slot the caller intends to sign up to. The
          *                               value must not exceed the maximum callback ID allowed by the
          *                               inheriting class.
@@ -355,7 +421,6 @@ namespace Anvil
             anvil_assert(in_callback_id        <  m_callback_id_count);
             anvil_assert(in_callback_function  != nullptr);
             anvil_assert(in_callback_owner_ptr != nullptr);
-            anvil_assert(!m_callbacks_locked);
 
             #ifdef _DEBUG
             {
@@ -365,10 +430,17 @@ namespace Anvil
             }
             #endif
 
-            m_callbacks[in_callback_id].push_back(
+            const Callbacks* snapshot_ptr     = m_callback_snapshots[in_callback_id].load();
+            Callbacks*       new_snapshot_ptr = (snapshot_ptr != nullptr) ? new Callbacks(*snapshot_ptr)
+                                                                          : new Callbacks();
+
+            new_snapshot_ptr->push_back(
                 Callback(in_callback_function,
                          in_callback_owner_ptr)
             );
+
+            publish_snapshot(in_callback_id,
+                             new_snapshot_ptr);
         }
 
         /** Unregisters the client from the specified call-back slot.
@@ -377,6 +449,15 @@ namespace Anvil
          *  a preceding register_for_callbacks() call, or which has already been unregistered.
          *  Doing so will result in an assertion failure.
          *
+         *  When called from a thread which is not dispatching callbacks of this object, the function
+         *  waits until all callback() and callback_safe() invocations which are in progress on other
+         *  threads have finished. The subscriber is guaranteed not to be called back once this
+         *  function returns, so its owner can be released right after. The caller must not hold any
+         *  lock which the called back functions may need to take.
+         *
+         *  Can be called from a callback handler, in which case the function does not wait. callback()
+         *  invocations which are already in progress may then still call the subscriber back.
+         *
          *  @param in_callback_id                 ID of the call-back slot the caller wants to sign out from.
          *                                        The value must not exceed the maximum callback ID allowed by
          *                                        the inheriting class.
@@ -388,21 +469,58 @@ namespace Anvil
                                        CallbackFunction in_callback_function,
                                        void*            in_callback_function_owner_ptr)
         {
-            std::unique_lock<std::recursive_mutex> mutex_lock(m_mutex);
-
             anvil_assert(in_callback_id       <  m_callback_id_count);
             anvil_assert(in_callback_function != nullptr);
-            anvil_assert(!m_callbacks_locked);
 
-            auto callback_iterator = std::find(m_callbacks[in_callback_id].begin(),
-                                               m_callbacks[in_callback_id].end(),
-                                               Callback(in_callback_function,
-                                                        in_callback_function_owner_ptr) );
+            {
+                std::unique_lock<std::recursive_mutex> mutex_lock  (m_mutex);
+                const Callbacks*                       snapshot_ptr(m_callback_snapshots[in_callback_id].load() );
+
+                anvil_assert(snapshot_ptr != nullptr);
+                if (snapshot_ptr == nullptr)
+                {
+                    return;
+                }
+
+                auto callback_iterator = std::find(snapshot_ptr->begin(),
+                                                   snapshot_ptr->end(),
+                                                   Callback(in_callback_function,
+                                                            in_callback_function_owner_ptr) );
 
-            anvil_assert(callback_iterator != m_callbacks[in_callback_id].end() );
-            if (callback_iterator != m_callbacks[in_callback_id].end() )
+                anvil_assert(callback_iterator != snapshot_ptr->end() );
+                if (callback_iterator == snapshot_ptr->end() )
+                {
+                    return;
+                }
+
+                Callbacks* new_snapshot_ptr = nullptr;
+
+                if (snapshot_ptr->size() > 1)
+                {
+                    new_snapshot_ptr = new Callbacks();
+
+                    new_snapshot_ptr->reserve(snapshot_ptr->size() - 1);
+                    new_snapshot_ptr->insert (new_snapshot_ptr->end(),
+                                              snapshot_ptr->begin(),
+                                              callback_iterator);
+                    new_snapshot_ptr->insert (new_snapshot_ptr->end(),
+                                              callback_iterator + 1,
+                                              snapshot_ptr->end() );
+                }
+
+                publish_snapshot(in_callback_id,
+                                 new_snapshot_ptr);
+            }
+
+            /* Dispatches which started before the new snapshot was published may still call the subscriber back.
+             * Wait for them to finish, unless this thread is one of the dispatchers, in which case waiting would
+             * never finish. The mutex is not held at this point, so that called back functions may (un)register. */
+            if (!is_dispatching_on_this_thread() )
             {
-                m_callbacks[in_callback_id].erase(callback_iterator);
+                while (m_n_active_readers.load() > 0)
+                {
+                    std::this_thread::yield();
+                }
             }
         }
 
@@ -412,10 +530,10 @@ namespace Anvil
         /** Calls back all subscribers which have signed up for the specified callback slot.
          *
          *  The clients are called one after another from the thread, in which the call has
-         *  been invoked.
+         *  been invoked. Only subscribers which were registered at the time the call was made
+         *  are called back.
          *
-         *  This implementation assumes that the invoked functions will NOT alter the
-         *  callback array. If that is the case, use (slower) callback_safe() instead.
+         *  This function does not take any locks, and can be called from many threads at the same time.
          *
          *  @param in_callback_id      ID of the call-back slot to use.
          *  @param in_callback_arg_ptr Call-back argument to use.
@@ -423,23 +541,27 @@ namespace Anvil
         void callback(CallbackID        in_callback_id,
                       CallbackArgument* in_callback_arg_ptr) const
         {
-            std::unique_lock<std::recursive_mutex> mutex_lock(m_mutex);
-
             anvil_assert(in_callback_id < m_callback_id_count);
-            anvil_assert(!m_callbacks_locked);
 
-            m_callbacks_locked = true;
+            /* Most slots have no subscribers. Skip the reader registration for these. */
+            if (m_callback_snapshots[in_callback_id].load(std::memory_order_relaxed) == nullptr)
             {
-                for (auto callback_iterator  = m_callbacks[in_callback_id].begin();
-                          callback_iterator != m_callbacks[in_callback_id].end();
-                        ++callback_iterator)
-                {
-                    const auto& current_callback = *callback_iterator;
+                return;
+            }
+
+            begin_dispatch();
+            {
+                const Callbacks* snapshot_ptr = m_callback_snapshots[in_callback_id].load();
 
-                    current_callback.function(in_callback_arg_ptr);
+                if (snapshot_ptr != nullptr)
+                {
+                    for (const auto& current_callback : *snapshot_ptr)
+                    {
+                        current_callback.function(in_callback_arg_ptr);
+                    }
                 }
             }
-            m_callbacks_locked = false;
+            end_dispatch();
         }
 
         /** Calls back all subscribers which have signed up for the specified callback slot.
@@ -447,15 +569,12 @@ namespace Anvil
          *  The clients are called one after another from the thread, in which the call has
          *  been invoked.
          *
-         *  This implementation assumes that the invoked functions MAY alter the
-         *  callback array. It will go the extra mile to ensure the cached callbacks are not
-         *  called more than once, and will take note of any new callback subscriptions that
-         *  may have been added by the called back functions.
-         *
-         *  This implementation is NOT MT-safe.
-         *
-         *  This function can potentially take a long time to execute.
+         *  Unlike callback(), this implementation also calls back subscribers which have been
+         *  registered while the call was in progress (eg. by the called back functions). Each
+         *  subscriber is called at most once, even if it unregisters and registers again while the
+         *  call is in progress.
          *
+         *  This function does not take any locks, and can be called from many threads at the same time.
          *
          *  @param in_callback_id  ID of the call-back slot to use.
          *  @param in_callback_arg Call-back argument to use.
@@ -463,47 +582,34 @@ namespace Anvil
         void callback_safe(CallbackID        in_callback_id,
                            CallbackArgument* in_callback_arg_ptr)
         {
-            std::unique_lock<std::recursive_mutex> mutex_lock(m_mutex);
-
             anvil_assert(in_callback_id < m_callback_id_count);
-            anvil_assert(!m_callbacks_locked);
 
-            bool                  another_iteration_needed = true;
-            bool                  first_iteration          = true;
-            std::vector<Callback> invoked_callbacks;
-
-            while (another_iteration_needed                &&
-                   m_callbacks[in_callback_id].size() > 0)
+            if (m_callback_snapshots[in_callback_id].load(std::memory_order_relaxed) == nullptr)
             {
-                const std::vector<Callback> cached_callbacks = m_callbacks[in_callback_id];
+                return;
+            }
 
-                another_iteration_needed = false;
+            begin_dispatch();
+            {
+                const Callbacks* snapshot_ptr = m_callback_snapshots[in_callback_id].load();
 
-                for (uint32_t n_current_callback = 0;
-                              n_current_callback < static_cast<uint32_t>(cached_callbacks.size() );
-                            ++n_current_callback)
+                if (snapshot_ptr != nullptr)
                 {
-                    const auto& current_callback = cached_callbacks[n_current_callback];
-
-                    if (first_iteration                                        ||
-                        std::find(invoked_callbacks.begin(),
-                                  invoked_callbacks.end(),
-                                  current_callback) == invoked_callbacks.end() )
+                    for (const auto& current_callback : *snapshot_ptr)
                     {
                         current_callback.function(in_callback_arg_ptr);
-
-                        invoked_callbacks.push_back(current_callback);
                     }
-                }
 
-                /* Has m_callbacks[in_callback_id] changed as a result of the callback above? */
-                if (!(m_callbacks[in_callback_id] == invoked_callbacks) )
-                {
-                    another_iteration_needed = true;
+                    /* Have the called back functions changed the subscriber list? */
+                    if (m_callback_snapshots[in_callback_id].load() != snapshot_ptr)
+                    {
+                        callback_new_subscribers(in_callback_id,
+                                                 in_callback_arg_ptr,
+                                                 snapshot_ptr);
+                    }
                 }
-
-                first_iteration = false;
             }
+            end_dispatch();
         }
 
         /** Tells how many subscribers have registered for the specified callback */
@@ -514,8 +620,10 @@ namespace Anvil
             if (in_callback_id < m_callback_id_count)
             {
                 std::unique_lock<std::recursive_mutex> mutex_lock(m_mutex);
+                const Callbacks*                       snapshot_ptr = m_callback_snapshots[in_callback_id].load();
 
-                result = static_cast<uint32_t>(m_callbacks[in_callback_id].size() );
+                result = (snapshot_ptr != nullptr) ? static_cast<uint32_t>(snapshot_ptr->size() )
+                                                   : 0;
             }
 
             return result;
@@ -551,11 +659,160 @@ namespace Anvil
 
         typedef std::vector<Callback> Callbacks;
 
+        /* Private functions */
+
+        /** Registers a dispatch of this object's callbacks as in flight. Must be paired with an end_dispatch() call. */
+        void begin_dispatch() const
+        {
+            ++m_n_active_readers;
+
+            get_thread_dispatch_providers().push_back(this);
+        }
+
+        /** Calls back subscribers of the specified callback slot which have been registered since @param in_walked_snapshot_ptr
+         *  was walked by callback_safe(), until the subscriber list stops changing.
+         *
+         *  Every subscriber of a walked snapshot has been called back by the time the walk finishes, so subscribers which
+         *  have already been called back are exactly those found in earlier snapshots. Walked snapshots stay alive until
+         *  the dispatch ends, even if they have been replaced since.
+         *
+         *  @param in_callback_id         ID of the call-back slot to use.
+         *  @param in_callback_arg_ptr    Call-back argument to use.
+         *  @param in_walked_snapshot_ptr Snapshot whose subscribers have all been called back. Must not be null.
+         **/
+        void callback_new_subscribers(CallbackID        in_callback_id,
+                                      CallbackArgument* in_callback_arg_ptr,
+                                      const Callbacks*  in_walked_snapshot_ptr)
+        {
+            const Callbacks*              snapshot_ptr        (m_callback_snapshots[in_callback_id].load() );
+            std::vector<const Callbacks*> walked_snapshot_ptrs(1,
+                                                               in_walked_snapshot_ptr);
+
+            while (snapshot_ptr != nullptr)
+            {
+                const Callbacks* new_snapshot_ptr = nullptr;
+
+                for (const auto& current_callback : *snapshot_ptr)
+                {
+                    bool has_been_called_back = false;
+
+                    for (const auto walked_snapshot_ptr : walked_snapshot_ptrs)
+                    {
+                        if (std::find(walked_snapshot_ptr->begin(),
+                                      walked_snapshot_ptr->end(),
+                                      current_callback) != walked_snapshot_ptr->end() )
+                        {
+                            has_been_called_back = true;
+
+                            break;
+                        }
+                    }
+
+                    if (!has_been_called_back)
+                    {
+                        current_callback.function(in_callback_arg_ptr);
+                    }
+                }
+
+                new_snapshot_ptr = m_callback_snapshots[in_callback_id].load();
+
+                if (new_snapshot_ptr == snapshot_ptr)
+                {
+                    break;
+                }
+
+                walked_snapshot_ptrs.push_back(snapshot_ptr);
+
+                snapshot_ptr = new_snapshot_ptr;
+            }
+        }
+
+        /** Marks the most recent dispatch started by this thread as finished. If it was the last dispatch in flight,
+         *  releases snapshots which have been retired in the meantime.
+         **/
+        void end_dispatch() const
+        {
+            get_thread_dispatch_providers().pop_back();
+
+            if (--m_n_active_readers == 0      &&
+                m_has_retired_snapshots.load() )
+            {
+                std::unique_lock<std::recursive_mutex> mutex_lock(m_mutex);
+
+                /* A new dispatch may have started in the meantime. It cannot be walking any of the retired
+                 * snapshots though, as these are no longer reachable. */
+                release_retired_snapshots();
+            }
+        }
+
+        /** Returns providers whose callbacks are being dispatched by the calling thread, innermost last. */
+        static std::vector<const CallbacksSupportProvider*>& get_thread_dispatch_providers()
+        {
+            static thread_local std::vector<const CallbacksSupportProvider*> result;
+
+            return result;
+        }
+
+        /** Tells whether the calling thread is in the middle of dispatching this object's callbacks. */
+        bool is_dispatching_on_this_thread() const
+        {
+            const auto& providers = get_thread_dispatch_providers();
+
+            return std::find(providers.begin(),
+                             providers.end(),
+                             this) != providers.end();
+        }
+
+        /** Replaces the subscriber snapshot of the specified callback slot. Must be called with m_mutex held.
+         *
+         *  The replaced snapshot may still be walked by in-flight dispatches, so it is retired rather than
+         *  released. Retired snapshots are released right away if no dispatch is found in flight, or by the
+         *  last in-flight dispatch when it finishes. Since a dispatch registers itself before loading a
+         *  snapshot, any dispatch which starts after the exchange is guaranteed to see the new snapshot.
+         *
+         *  @param in_callback_id       ID of the call-back slot to update.
+         *  @param in_new_snapshot_ptr  New snapshot, or nullptr if the slot has no subscribers. Ownership is taken over.
+         **/
+        void publish_snapshot(CallbackID in_callback_id,
+                              Callbacks* in_new_snapshot_ptr)
+        {
+            const Callbacks* old_snapshot_ptr = m_callback_snapshots[in_callback_id].exchange(in_new_snapshot_ptr);
+
+            if (old_snapshot_ptr != nullptr)
+            {
+                m_retired_snapshots.push_back(old_snapshot_ptr);
+
+                m_has_retired_snapshots = true;
+            }
+
+            release_retired_snapshots();
+        }
+
+        /** Releases all retired snapshots if no dispatch is in flight. Must be called with m_mutex held. */
+        void release_retired_snapshots() const
+        {
+            if (m_n_active_readers.load() != 0)
+            {
+                return;
+            }
+
+            for (auto snapshot_ptr : m_retired_snapshots)
+            {
+                delete snapshot_ptr;
+            }
+
+            m_retired_snapshots.clear();
+
+            m_has_retired_snapshots = false;
+        }
+
         /* Private variables */
-        CallbackID                   m_callback_id_count;
-        Callbacks*                   m_callbacks;
-        mutable volatile bool        m_callbacks_locked;
-        mutable std::recursive_mutex m_mutex;
+        CallbackID                            m_callback_id_count;
+        std::atomic<const Callbacks*>*        m_callback_snapshots;
+        mutable std::atomic<bool>             m_has_retired_snapshots;
+        mutable std::recursive_mutex          m_mutex;
+        mutable std::atomic<uint32_t>         m_n_active_readers;
+        mutable std::vector<const Callbacks*> m_retired_snapshots;
     };
 } /* namespace Anvil */
 
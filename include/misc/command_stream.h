@@ -0,0 +1,414 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Compact, arena-allocated stream of commands recorded into a command buffer. Implemented in order to:
+ *
+ *  - capture the commands a command buffer is recorded with at a low CPU cost. Each command is stored as a small,
+ *    type-tagged header followed by a flat payload holding the arguments, including the contents of all arrays the
+ *    arguments point to. Payloads are appended to large chunks of memory, so steady-state capture (ie. capturing
+ *    into a stream which has been cleared) does not allocate.
+ *  - iterate over captured commands, eg. for CPU-side frame capture tools.
+ *  - replay the stream into another command buffer, eg. to benchmark the cost of recording a real frame.
+ *
+ *  A stream starts capturing commands once it is attached to a command buffer with CommandBufferBase::set_command_stream().
+ *  The stream does NOT retain objects the captured commands refer to. Object pointers and Vulkan handles are stored
+ *  verbatim, which means a stream can only be replayed as long as all objects it refers to are alive. For the same reason,
+ *  replay is in-process only: streams cannot be saved to a file or otherwise moved to another process. Iteration is always
+ *  safe.
+ *
+ *  The stream is NOT thread-safe.
+ **/
+#ifndef MISC_COMMAND_STREAM_H
+#define MISC_COMMAND_STREAM_H
+
+#include "misc/types.h"
+#include "wrappers/command_buffer.h"
+#include <cstring>
+#include <type_traits>
+
+namespace Anvil
+{
+    class CommandStream
+    {
+    public:
+        /* Public type definitions */
+
+        /** Wraps an array of items, so that it can be passed to append_command(). The array contents are copied
+         *  into the stream at append time.
+         **/
+        template<typename Type>
+        struct Array
+        {
+            const Type* items_ptr;
+            uint32_t    n_items;
+
+            Array(const Type* in_items_ptr,
+                  uint32_t    in_n_items)
+                :items_ptr(in_items_ptr),
+                 n_items  ((in_items_ptr != nullptr) ? in_n_items : 0)
+            {
+                /* Stub */
+            }
+        };
+
+        /** Fixed-size header preceding the payload of each command stored in the stream. */
+        typedef struct CommandHeader
+        {
+            CommandType type;
+            uint32_t    n_payload_bytes;
+        } CommandHeader;
+
+        /** Iterates over commands stored in a stream, in the order they were appended in. */
+        class Iterator
+        {
+        public:
+            /* Public functions */
+
+            /** Returns type of the command the iterator points at. */
+            CommandType get_command_type() const
+            {
+                return get_header_ptr()->type;
+            }
+
+            /** Returns a pointer to the payload of the command the iterator points at. Use CommandStream::Reader to
+             *  decode it.
+             **/
+            const uint8_t* get_payload() const
+            {
+                return reinterpret_cast<const uint8_t*>(get_header_ptr() ) + sizeof(CommandHeader);
+            }
+
+            /** Returns size of the payload of the command the iterator points at. */
+            uint32_t get_payload_size() const
+            {
+                return get_header_ptr()->n_payload_bytes;
+            }
+
+            const Iterator& operator*() const
+            {
+                return *this;
+            }
+
+            Iterator& operator++();
+
+            bool operator==(const Iterator& in_iterator) const
+            {
+                return (m_n_chunk      == in_iterator.m_n_chunk      &&
+                        m_chunk_offset == in_iterator.m_chunk_offset &&
+                        m_stream_ptr   == in_iterator.m_stream_ptr);
+            }
+
+            bool operator!=(const Iterator& in_iterator) const
+            {
+                return !(*this == in_iterator);
+            }
+
+        private:
+            /* Private functions */
+            Iterator(const CommandStream* in_stream_ptr,
+                     uint32_t             in_n_chunk,
+                     uint32_t             in_chunk_offset);
+
+            const CommandHeader* get_header_ptr() const;
+
+            /* Private variables */
+            uint32_t             m_chunk_offset;
+            uint32_t             m_n_chunk;
+            const CommandStream* m_stream_ptr;
+
+            friend class CommandStream;
+        };
+
+        /** Decodes the payload of a single command. Values must be read in the same order and using the same types
+         *  they were passed to append_command() with.
+         *
+         *  Pointers returned by the reader point into the stream and stay valid until the stream is cleared or released.
+         **/
+        class Reader
+        {
+        public:
+            /* Public functions */
+
+            /** Constructor.
+             *
+             *  @param in_command Command to decode.
+             **/
+            explicit Reader(const Iterator& in_command)
+                :m_n_payload_bytes(in_command.get_payload_size() ),
+                 m_offset         (0),
+                 m_payload_ptr    (in_command.get_payload() )
+            {
+                /* Stub */
+            }
+
+            /** Reads a single plain data value. */
+            template<typename Type>
+            const Type& read()
+            {
+                return *reinterpret_cast<const Type*>(get(sizeof(Type),
+                                                          alignof(Type) ));
+            }
+
+            /** Reads an array stored as CommandStream::Array<Type>.
+             *
+             *  @param out_n_items_ptr Deref will be set to the number of items in the array. Must not be nullptr.
+             *
+             *  @return Pointer to the first item, or nullptr if the array is empty.
+             **/
+            template<typename Type>
+            const Type* read_array(uint32_t* out_n_items_ptr)
+            {
+                const Type* result_ptr = nullptr;
+
+                *out_n_items_ptr = read<uint32_t>();
+                result_ptr       = reinterpret_cast<const Type*>(get(*out_n_items_ptr * static_cast<uint32_t>(sizeof(Type) ),
+                                                                     alignof(Type) ));
+
+                return (*out_n_items_ptr > 0) ? result_ptr : nullptr;
+            }
+
+            void        read_attachment_sample_locations(std::vector<Anvil::AttachmentSampleLocations>* out_result_ptr);
+            void        read_buffer_barriers            (std::vector<Anvil::BufferBarrier>*             out_result_ptr);
+            void        read_image_barriers             (std::vector<Anvil::ImageBarrier>*              out_result_ptr);
+            void        read_memory_barriers            (std::vector<Anvil::MemoryBarrier>*             out_result_ptr);
+            void        read_sample_locations_info      (Anvil::SampleLocationsInfo*                    out_result_ptr);
+            const char* read_string                     ();
+            void        read_subpass_sample_locations   (std::vector<Anvil::SubpassSampleLocations>*    out_result_ptr);
+
+        private:
+            /* Private functions */
+            const uint8_t* get(uint32_t in_n_bytes,
+                               uint32_t in_alignment);
+
+            /* Private variables */
+            uint32_t       m_n_payload_bytes;
+            uint32_t       m_offset;
+            const uint8_t* m_payload_ptr;
+        };
+
+        /* Public functions */
+
+        /** Creates a new, empty command stream.
+         *
+         *  @param in_chunk_size Size of a single chunk of memory the stream sub-allocates commands from. Commands whose
+         *                       payload does not fit in a chunk of this size are stored in a dedicated, larger chunk.
+         **/
+        static Anvil::CommandStreamUniquePtr create(uint32_t in_chunk_size = 64 * 1024);
+
+        /** Destructor */
+        ~CommandStream();
+
+        /** Appends a new command to the stream.
+         *
+         *  Each argument must either be a plain data value (no owned resources), an Array<> instance, a string or a SampleLocationsInfo
+         *  instance. Arrays of barriers and sample locations are also supported.
+         *
+         *  @param in_type Type of the command.
+         *  @param in_args Command arguments.
+         **/
+        template<typename... Types>
+        void append_command(CommandType     in_type,
+                            const Types&... in_args)
+        {
+            PayloadWriter size_writer(nullptr);
+
+            serialize_all(&size_writer,
+                          in_args...);
+
+            {
+                PayloadWriter payload_writer(allocate_command(in_type,
+                                                              size_writer.offset) );
+
+                serialize_all(&payload_writer,
+                              in_args...);
+            }
+        }
+
+        Iterator begin() const;
+
+        /** Removes all commands from the stream. Memory allocated for the commands is retained for later reuse. */
+        void clear();
+
+        Iterator end() const;
+
+        /** Returns the number of bytes used by commands stored in the stream. */
+        size_t get_n_bytes_used() const
+        {
+            return m_n_bytes_used;
+        }
+
+        /** Returns the number of commands stored in the stream. */
+        uint32_t get_n_commands() const
+        {
+            return m_n_commands;
+        }
+
+        /** Helper function which wraps @param in_n_items items under @param in_opt_items_ptr in an Array<>.
+         *  If @param in_opt_items_ptr is nullptr, an empty array is returned.
+         **/
+        template<typename Type>
+        static Array<Type> make_array(const Type* in_opt_items_ptr,
+                                      uint32_t    in_n_items)
+        {
+            return Array<Type>(in_opt_items_ptr,
+                               in_n_items);
+        }
+
+        /** Records all commands held by the stream into the specified command buffer. Command buffer must be in
+         *  the recording state. Commands which can only be recorded into primary command buffers make the call fail
+         *  if @param in_command_buffer_ptr is a secondary command buffer.
+         *
+         *  @param in_command_buffer_ptr Command buffer to record the commands into. Must not be nullptr. Must not
+         *                               be a command buffer the stream is attached to.
+         *
+         *  @return true if all commands were recorded successfully, false otherwise.
+         **/
+        bool replay(Anvil::CommandBufferBase* in_command_buffer_ptr) const;
+
+    private:
+        /* Private type definitions */
+
+        typedef struct Chunk
+        {
+            uint32_t                    n_bytes_used;
+            uint32_t                    size;
+            std::unique_ptr<uint64_t[]> storage_ptr;
+
+            explicit Chunk(uint32_t in_size)
+                :n_bytes_used(0),
+                 size        (in_size),
+                 storage_ptr (new uint64_t[in_size / sizeof(uint64_t)])
+            {
+                /* Stub */
+            }
+        } Chunk;
+
+        /* Computes the size of a payload (if data_ptr is nullptr) or writes it out. */
+        typedef struct PayloadWriter
+        {
+            uint8_t* data_ptr;
+            uint32_t offset;
+
+            explicit PayloadWriter(uint8_t* in_data_ptr)
+                :data_ptr(in_data_ptr),
+                 offset  (0)
+            {
+                /* Stub */
+            }
+
+            void put(const void* in_data_ptr,
+                     uint32_t    in_n_bytes,
+                     uint32_t    in_alignment)
+            {
+                offset = Anvil::Utils::round_up(offset,
+                                                (in_alignment < sizeof(uint64_t) ) ? in_alignment
+                                                                                   : static_cast<uint32_t>(sizeof(uint64_t) ));
+
+                if (data_ptr   != nullptr &&
+                    in_n_bytes >  0)
+                {
+                    memcpy(data_ptr + offset,
+                           in_data_ptr,
+                           in_n_bytes);
+                }
+
+                offset += in_n_bytes;
+            }
+        } PayloadWriter;
+
+        /* Private functions */
+        CommandStream(uint32_t in_chunk_size);
+
+        CommandStream           (const CommandStream&);
+        CommandStream& operator=(const CommandStream&);
+
+        uint8_t* allocate_command(CommandType in_type,
+                                  uint32_t    in_n_payload_bytes);
+
+        template<typename Type>
+        static void serialize(PayloadWriter* in_writer_ptr,
+                              const Type&    in_value)
+        {
+            static_assert(std::is_trivially_destructible<Type>::value,
+                          "Only plain data values can be stored in a command stream");
+
+            in_writer_ptr->put(&in_value,
+                               sizeof(Type),
+                               alignof(Type) );
+        }
+
+        template<typename Type>
+        static void serialize(PayloadWriter*     in_writer_ptr,
+                              const Array<Type>& in_array)
+        {
+            static_assert(std::is_trivially_destructible<Type>::value,
+                          "Only arrays of plain data values can be stored in a command stream");
+
+            serialize(in_writer_ptr,
+                      in_array.n_items);
+
+            in_writer_ptr->put(in_array.items_ptr,
+                               in_array.n_items * static_cast<uint32_t>(sizeof(Type) ),
+                               alignof(Type) );
+        }
+
+        static void serialize(PayloadWriter*                                  in_writer_ptr,
+                              const Array<Anvil::AttachmentSampleLocations>& in_array);
+        static void serialize(PayloadWriter*                                  in_writer_ptr,
+                              const Array<Anvil::BufferBarrier>&             in_array);
+        static void serialize(PayloadWriter*                                  in_writer_ptr,
+                              const Array<Anvil::ImageBarrier>&              in_array);
+        static void serialize(PayloadWriter*                                  in_writer_ptr,
+                              const Array<Anvil::MemoryBarrier>&             in_array);
+        static void serialize(PayloadWriter*                                  in_writer_ptr,
+                              const Array<Anvil::SubpassSampleLocations>&    in_array);
+        static void serialize(PayloadWriter*                                  in_writer_ptr,
+                              const Anvil::SampleLocationsInfo&              in_info);
+        static void serialize(PayloadWriter*                                  in_writer_ptr,
+                              const std::string&                             in_string);
+
+        static void serialize_all(PayloadWriter* in_writer_ptr)
+        {
+            ANVIL_REDUNDANT_ARGUMENT(in_writer_ptr);
+        }
+
+        template<typename Type, typename... Types>
+        static void serialize_all(PayloadWriter*  in_writer_ptr,
+                                  const Type&     in_value,
+                                  const Types&... in_values)
+        {
+            serialize    (in_writer_ptr,
+                          in_value);
+            serialize_all(in_writer_ptr,
+                          in_values...);
+        }
+
+        /* Private variables */
+        uint32_t                             m_chunk_size;
+        std::vector<std::unique_ptr<Chunk> > m_chunks;
+        size_t                               m_n_bytes_used;
+        uint32_t                             m_n_chunks_used;
+        uint32_t                             m_n_commands;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_COMMAND_STREAM_H */
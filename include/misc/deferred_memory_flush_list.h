@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Device-wide list of memory blocks which hold host writes to non-coherent memory that have not been flushed yet.
+ *  Implemented in order to:
+ *
+ *  - let MemoryBlock::write() skip the vkFlushMappedMemoryRanges() call it would otherwise have to issue for each write
+ *    to a non-coherent memory block. Only memory blocks whose mapping mode has been set to
+ *    MemoryBlockMappingMode::PERSISTENT_WITH_DEFERRED_FLUSHES defer their flushes.
+ *  - coalesce all pending dirty ranges (adjacent and overlapping ones are merged) and flush them with a single
+ *    vkFlushMappedMemoryRanges() call.
+ *
+ *  The list is flushed automatically by Queue::submit(), so that all host writes are visible to the device by the time
+ *  the submitted work starts executing. Apps may also flush it explicitly, eg. once per frame.
+ *
+ *  This object should ONLY be instantiated by Anvil::BaseDevice.
+ *
+ *  Opt-in MT-safety available.
+ **/
+#ifndef MISC_DEFERRED_MEMORY_FLUSH_LIST_H
+#define MISC_DEFERRED_MEMORY_FLUSH_LIST_H
+
+#include "misc/mt_safety.h"
+#include "misc/types.h"
+#include <atomic>
+#include <unordered_set>
+
+namespace Anvil
+{
+    class DeferredMemoryFlushList : public MTSafetySupportProvider
+    {
+    public:
+        /* Public functions */
+
+        /** Destructor */
+        ~DeferredMemoryFlushList();
+
+        /** Flushes all dirty ranges of all memory blocks which have deferred their flushes since the last flush() call,
+         *  using a single vkFlushMappedMemoryRanges() call.
+         *
+         *  @return true if successful or if there was nothing to flush, false otherwise.
+         **/
+        bool flush();
+
+        /** Returns the number of memory blocks whose writes are yet to be flushed. */
+        uint32_t get_n_pending_memory_blocks() const
+        {
+            return m_n_pending_memory_blocks.load();
+        }
+
+        /** Returns the total number of vkFlushMappedMemoryRanges() calls issued by the list. */
+        uint64_t get_n_flush_calls() const
+        {
+            return m_n_flush_calls.load();
+        }
+
+        /** Returns the total number of memory ranges passed to vkFlushMappedMemoryRanges() calls issued by the list,
+         *  after coalescing.
+         **/
+        uint64_t get_n_flushed_ranges() const
+        {
+            return m_n_flushed_ranges.load();
+        }
+
+    private:
+        /* Private functions */
+        DeferredMemoryFlushList(const Anvil::BaseDevice* in_device_ptr,
+                                bool                     in_mt_safe);
+
+        DeferredMemoryFlushList           (const DeferredMemoryFlushList&);
+        DeferredMemoryFlushList& operator=(const DeferredMemoryFlushList&);
+
+        void on_memory_block_dirtied (Anvil::MemoryBlock* in_memory_block_ptr);
+        void on_memory_block_released(Anvil::MemoryBlock* in_memory_block_ptr);
+
+        static Anvil::DeferredMemoryFlushListUniquePtr create(const Anvil::BaseDevice* in_device_ptr,
+                                                              bool                     in_mt_safe);
+
+        /* Private members */
+        const Anvil::BaseDevice*                m_device_ptr;
+        std::unordered_set<Anvil::MemoryBlock*> m_pending_memory_blocks;
+        std::vector<VkMappedMemoryRange>        m_ranges_vk;
+
+        std::atomic<uint32_t> m_n_pending_memory_blocks;
+        std::atomic<uint64_t> m_n_flush_calls;
+        std::atomic<uint64_t> m_n_flushed_ranges;
+
+        friend class BaseDevice;
+        friend class MemoryBlock;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_DEFERRED_MEMORY_FLUSH_LIST_H */
@@ -0,0 +1,200 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Per-device table of device-level Vulkan entrypoints.
+ *
+ *  Function pointers exposed by Anvil::Vulkan are retrieved with vkGetInstanceProcAddr(), so calls made through them
+ *  are routed through loader trampolines which look up the actual implementation for the dispatchable handle on
+ *  every call. The table holds pointers retrieved with vkGetDeviceProcAddr() for a specific device instead, which
+ *  point directly at the implementation of the driver the device was created with. This:
+ *
+ *  - removes one level of indirection from every command recorded or submitted.
+ *  - lets devices created with different drivers coexist in the same process.
+ *
+ *  All VK 1.0 entrypoints must be exposed by the device, or init() fails. VK 1.1 entrypoints are only available
+ *  if the device reports VK 1.1 support, and are set to nullptr otherwise.
+ *
+ *  One table is owned by each Anvil::BaseDevice instance. Use BaseDevice::get_dispatch_table() to access it.
+ **/
+#ifndef MISC_DEVICE_DISPATCH_TABLE_H
+#define MISC_DEVICE_DISPATCH_TABLE_H
+
+#include "misc/vulkan.h"
+
+namespace Anvil
+{
+    typedef struct DeviceDispatchTable
+    {
+        /* VK 1.0 core */
+        PFN_vkDestroyDevice                     vkDestroyDevice;
+        PFN_vkGetDeviceQueue                    vkGetDeviceQueue;
+        PFN_vkQueueSubmit                       vkQueueSubmit;
+        PFN_vkQueueWaitIdle                     vkQueueWaitIdle;
+        PFN_vkDeviceWaitIdle                    vkDeviceWaitIdle;
+        PFN_vkAllocateMemory                    vkAllocateMemory;
+        PFN_vkFreeMemory                        vkFreeMemory;
+        PFN_vkMapMemory                         vkMapMemory;
+        PFN_vkUnmapMemory                       vkUnmapMemory;
+        PFN_vkFlushMappedMemoryRanges           vkFlushMappedMemoryRanges;
+        PFN_vkInvalidateMappedMemoryRanges      vkInvalidateMappedMemoryRanges;
+        PFN_vkGetDeviceMemoryCommitment         vkGetDeviceMemoryCommitment;
+        PFN_vkBindBufferMemory                  vkBindBufferMemory;
+        PFN_vkBindImageMemory                   vkBindImageMemory;
+        PFN_vkGetBufferMemoryRequirements       vkGetBufferMemoryRequirements;
+        PFN_vkGetImageMemoryRequirements        vkGetImageMemoryRequirements;
+        PFN_vkGetImageSparseMemoryRequirements  vkGetImageSparseMemoryRequirements;
+        PFN_vkQueueBindSparse                   vkQueueBindSparse;
+        PFN_vkCreateFence                       vkCreateFence;
+        PFN_vkDestroyFence                      vkDestroyFence;
+        PFN_vkResetFences                       vkResetFences;
+        PFN_vkGetFenceStatus                    vkGetFenceStatus;
+        PFN_vkWaitForFences                     vkWaitForFences;
+        PFN_vkCreateSemaphore                   vkCreateSemaphore;
+        PFN_vkDestroySemaphore                  vkDestroySemaphore;
+        PFN_vkCreateEvent                       vkCreateEvent;
+        PFN_vkDestroyEvent                      vkDestroyEvent;
+        PFN_vkGetEventStatus                    vkGetEventStatus;
+        PFN_vkSetEvent                          vkSetEvent;
+        PFN_vkResetEvent                        vkResetEvent;
+        PFN_vkCreateQueryPool                   vkCreateQueryPool;
+        PFN_vkDestroyQueryPool                  vkDestroyQueryPool;
+        PFN_vkGetQueryPoolResults               vkGetQueryPoolResults;
+        PFN_vkCreateBuffer                      vkCreateBuffer;
+        PFN_vkDestroyBuffer                     vkDestroyBuffer;
+        PFN_vkCreateBufferView                  vkCreateBufferView;
+        PFN_vkDestroyBufferView                 vkDestroyBufferView;
+        PFN_vkCreateImage                       vkCreateImage;
+        PFN_vkDestroyImage                      vkDestroyImage;
+        PFN_vkGetImageSubresourceLayout         vkGetImageSubresourceLayout;
+        PFN_vkCreateImageView                   vkCreateImageView;
+        PFN_vkDestroyImageView                  vkDestroyImageView;
+        PFN_vkCreateShaderModule                vkCreateShaderModule;
+        PFN_vkDestroyShaderModule               vkDestroyShaderModule;
+        PFN_vkCreatePipelineCache               vkCreatePipelineCache;
+        PFN_vkDestroyPipelineCache              vkDestroyPipelineCache;
+        PFN_vkGetPipelineCacheData              vkGetPipelineCacheData;
+        PFN_vkMergePipelineCaches               vkMergePipelineCaches;
+        PFN_vkCreateGraphicsPipelines           vkCreateGraphicsPipelines;
+        PFN_vkCreateComputePipelines            vkCreateComputePipelines;
+        PFN_vkDestroyPipeline                   vkDestroyPipeline;
+        PFN_vkCreatePipelineLayout              vkCreatePipelineLayout;
+        PFN_vkDestroyPipelineLayout             vkDestroyPipelineLayout;
+        PFN_vkCreateSampler                     vkCreateSampler;
+        PFN_vkDestroySampler                    vkDestroySampler;
+        PFN_vkCreateDescriptorSetLayout         vkCreateDescriptorSetLayout;
+        PFN_vkDestroyDescriptorSetLayout        vkDestroyDescriptorSetLayout;
+        PFN_vkCreateDescriptorPool              vkCreateDescriptorPool;
+        PFN_vkDestroyDescriptorPool             vkDestroyDescriptorPool;
+        PFN_vkResetDescriptorPool               vkResetDescriptorPool;
+        PFN_vkAllocateDescriptorSets            vkAllocateDescriptorSets;
+        PFN_vkFreeDescriptorSets                vkFreeDescriptorSets;
+        PFN_vkUpdateDescriptorSets              vkUpdateDescriptorSets;
+        PFN_vkCreateFramebuffer                 vkCreateFramebuffer;
+        PFN_vkDestroyFramebuffer                vkDestroyFramebuffer;
+        PFN_vkCreateRenderPass                  vkCreateRenderPass;
+        PFN_vkDestroyRenderPass                 vkDestroyRenderPass;
+        PFN_vkGetRenderAreaGranularity          vkGetRenderAreaGranularity;
+        PFN_vkCreateCommandPool                 vkCreateCommandPool;
+        PFN_vkDestroyCommandPool                vkDestroyCommandPool;
+        PFN_vkResetCommandPool                  vkResetCommandPool;
+        PFN_vkAllocateCommandBuffers            vkAllocateCommandBuffers;
+        PFN_vkFreeCommandBuffers                vkFreeCommandBuffers;
+        PFN_vkBeginCommandBuffer                vkBeginCommandBuffer;
+        PFN_vkEndCommandBuffer                  vkEndCommandBuffer;
+        PFN_vkResetCommandBuffer                vkResetCommandBuffer;
+        PFN_vkCmdBindPipeline                   vkCmdBindPipeline;
+        PFN_vkCmdSetViewport                    vkCmdSetViewport;
+        PFN_vkCmdSetScissor                     vkCmdSetScissor;
+        PFN_vkCmdSetLineWidth                   vkCmdSetLineWidth;
+        PFN_vkCmdSetDepthBias                   vkCmdSetDepthBias;
+        PFN_vkCmdSetBlendConstants              vkCmdSetBlendConstants;
+        PFN_vkCmdSetDepthBounds                 vkCmdSetDepthBounds;
+        PFN_vkCmdSetStencilCompareMask          vkCmdSetStencilCompareMask;
+        PFN_vkCmdSetStencilWriteMask            vkCmdSetStencilWriteMask;
+        PFN_vkCmdSetStencilReference            vkCmdSetStencilReference;
+        PFN_vkCmdBindDescriptorSets             vkCmdBindDescriptorSets;
+        PFN_vkCmdBindIndexBuffer                vkCmdBindIndexBuffer;
+        PFN_vkCmdBindVertexBuffers              vkCmdBindVertexBuffers;
+        PFN_vkCmdDraw                           vkCmdDraw;
+        PFN_vkCmdDrawIndexed                    vkCmdDrawIndexed;
+        PFN_vkCmdDrawIndirect                   vkCmdDrawIndirect;
+        PFN_vkCmdDrawIndexedIndirect            vkCmdDrawIndexedIndirect;
+        PFN_vkCmdDispatch                       vkCmdDispatch;
+        PFN_vkCmdDispatchIndirect               vkCmdDispatchIndirect;
+        PFN_vkCmdCopyBuffer                     vkCmdCopyBuffer;
+        PFN_vkCmdCopyImage                      vkCmdCopyImage;
+        PFN_vkCmdBlitImage                      vkCmdBlitImage;
+        PFN_vkCmdCopyBufferToImage              vkCmdCopyBufferToImage;
+        PFN_vkCmdCopyImageToBuffer              vkCmdCopyImageToBuffer;
+        PFN_vkCmdUpdateBuffer                   vkCmdUpdateBuffer;
+        PFN_vkCmdFillBuffer                     vkCmdFillBuffer;
+        PFN_vkCmdClearColorImage                vkCmdClearColorImage;
+        PFN_vkCmdClearDepthStencilImage         vkCmdClearDepthStencilImage;
+        PFN_vkCmdClearAttachments               vkCmdClearAttachments;
+        PFN_vkCmdResolveImage                   vkCmdResolveImage;
+        PFN_vkCmdSetEvent                       vkCmdSetEvent;
+        PFN_vkCmdResetEvent                     vkCmdResetEvent;
+        PFN_vkCmdWaitEvents                     vkCmdWaitEvents;
+        PFN_vkCmdPipelineBarrier                vkCmdPipelineBarrier;
+        PFN_vkCmdBeginQuery                     vkCmdBeginQuery;
+        PFN_vkCmdEndQuery                       vkCmdEndQuery;
+        PFN_vkCmdResetQueryPool                 vkCmdResetQueryPool;
+        PFN_vkCmdWriteTimestamp                 vkCmdWriteTimestamp;
+        PFN_vkCmdCopyQueryPoolResults           vkCmdCopyQueryPoolResults;
+        PFN_vkCmdPushConstants                  vkCmdPushConstants;
+        PFN_vkCmdBeginRenderPass                vkCmdBeginRenderPass;
+        PFN_vkCmdNextSubpass                    vkCmdNextSubpass;
+        PFN_vkCmdEndRenderPass                  vkCmdEndRenderPass;
+        PFN_vkCmdExecuteCommands                vkCmdExecuteCommands;
+
+        /* VK 1.1 core */
+        PFN_vkBindBufferMemory2                 vkBindBufferMemory2;
+        PFN_vkBindImageMemory2                  vkBindImageMemory2;
+        PFN_vkCmdDispatchBase                   vkCmdDispatchBase;
+        PFN_vkCmdSetDeviceMask                  vkCmdSetDeviceMask;
+        PFN_vkCreateDescriptorUpdateTemplate    vkCreateDescriptorUpdateTemplate;
+        PFN_vkCreateSamplerYcbcrConversion      vkCreateSamplerYcbcrConversion;
+        PFN_vkDestroyDescriptorUpdateTemplate   vkDestroyDescriptorUpdateTemplate;
+        PFN_vkDestroySamplerYcbcrConversion     vkDestroySamplerYcbcrConversion;
+        PFN_vkGetBufferMemoryRequirements2      vkGetBufferMemoryRequirements2;
+        PFN_vkGetDescriptorSetLayoutSupport     vkGetDescriptorSetLayoutSupport;
+        PFN_vkGetDeviceGroupPeerMemoryFeatures  vkGetDeviceGroupPeerMemoryFeatures;
+        PFN_vkGetDeviceQueue2                   vkGetDeviceQueue2;
+        PFN_vkGetImageMemoryRequirements2       vkGetImageMemoryRequirements2;
+        PFN_vkGetImageSparseMemoryRequirements2 vkGetImageSparseMemoryRequirements2;
+        PFN_vkTrimCommandPool                   vkTrimCommandPool;
+        PFN_vkUpdateDescriptorSetWithTemplate   vkUpdateDescriptorSetWithTemplate;
+
+        /** Constructor. Sets all func pointers to nullptr. */
+        DeviceDispatchTable();
+
+        /** Retrieves all func pointers for the specified device.
+         *
+         *  @param in_device_vk Vulkan device handle to use. Must not be VK_NULL_HANDLE.
+         *
+         *  @return true if all VK 1.0 entrypoints were successfully retrieved, false otherwise.
+         **/
+        bool init(VkDevice in_device_vk);
+    } DeviceDispatchTable;
+}; /* namespace Anvil */
+
+#endif /* MISC_DEVICE_DISPATCH_TABLE_H */
@@ -28,12 +28,48 @@
 #define DUMMY_WINDOW_H
 
 #include "misc/window.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace Anvil
 {
     class DummyWindow : public Window
     {
     public:
+        /* Public type definitions */
+
+        /* Configures headless benchmark mode. Please see enable_benchmark_mode() for more details. */
+        typedef struct BenchmarkModeSettings
+        {
+            /* Device to measure GPU frame times with. If nullptr, only CPU frame times are measured.
+             *
+             * GPU timing is only supported for single-GPU devices. It brackets each frame with timestamps
+             * written to the first universal queue, so the measured time covers all work the present
+             * callback submits to that queue.
+             */
+            const Anvil::BaseDevice* device_ptr;
+
+            /* Number of frames to render before the window closes itself. 0 = run until close() is called. */
+            uint32_t n_frames;
+
+            /* Name of the file the summary should be written to at exit. Empty string = stdout. */
+            std::string summary_file_name;
+
+            /* Minimum time every frame should take. 0 = render frames as fast as possible. */
+            uint32_t target_frame_time_usec;
+
+            BenchmarkModeSettings()
+                :device_ptr            (nullptr),
+                 n_frames              (0),
+                 target_frame_time_usec(0)
+            {
+                /* Stub */
+            }
+        } BenchmarkModeSettings;
+
         /* Public functions */
         static Anvil::WindowUniquePtr create(const std::string&             in_title,
                                              unsigned int                   in_width,
@@ -48,6 +84,21 @@ namespace Anvil
 
         virtual void close();
 
+        /** Switches the window to headless benchmark mode. In this mode, run():
+         *
+         *  - invokes the present callback either as fast as possible, or paced to the requested frame time.
+         *  - measures CPU time spent in each present callback invocation and, optionally, GPU time of the
+         *    work submitted for each frame.
+         *  - writes average, p50, p95, p99 and maximum frame times to a file or stdout when the loop exits.
+         *
+         *  Must be called before run().
+         *
+         *  @param in_settings Benchmark mode configuration.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool enable_benchmark_mode(const BenchmarkModeSettings& in_settings);
+
         /* Returns window's platform */
         WindowPlatform get_platform() const
         {
@@ -76,8 +127,55 @@ namespace Anvil
                     InputCallbacks          in_input_callback_collection);
 
         bool init();
+
+        void on_frame_finished      ();
+        void on_frame_started       ();
+        void write_benchmark_summary();
+
+    private:
+        /* Private type definitions */
+
+        /* Holds pre-recorded command buffers bracketing a single in-flight frame with GPU timestamps. */
+        typedef struct GPUTimingSlot
+        {
+            Anvil::PrimaryCommandBufferUniquePtr end_cmd_buffer_ptr;
+            Anvil::FenceUniquePtr                fence_ptr;
+            bool                                 is_pending;
+            Anvil::PrimaryCommandBufferUniquePtr start_cmd_buffer_ptr;
+
+            GPUTimingSlot()
+                :is_pending(false)
+            {
+                /* Stub */
+            }
+        } GPUTimingSlot;
+
+        /* Private functions */
+        bool init_gpu_timing            ();
+        void retrieve_gpu_timing_results(GPUTimingSlot* in_slot_ptr,
+                                         uint32_t       in_n_slot);
+
+        /* Private variables */
+        bool                                         m_benchmark_mode_enabled;
+        BenchmarkModeSettings                        m_benchmark_mode_settings;
+        std::vector<double>                          m_cpu_frame_times_msec;
+        std::chrono::steady_clock::time_point        m_frame_start_time;
+        std::vector<double>                          m_gpu_frame_times_msec;
+        uint32_t                                     m_gpu_timestamp_bits;
+        double                                       m_gpu_timestamp_period_nsec;
+        Anvil::QueryPoolUniquePtr                    m_gpu_timing_query_pool_ptr;
+        std::vector<std::unique_ptr<GPUTimingSlot> > m_gpu_timing_slots;
+        uint32_t                                     m_n_benchmark_frames;
+        uint32_t                                     m_n_gpu_timing_frames;
     };
 
+    /** Dummy window which stores contents of every presented swapchain image in a PNG file.
+     *
+     *  Frames are captured asynchronously. Each frame's swapchain image is copied to one of a ring of readback
+     *  buffers by pre-recorded command buffers, and the copy is only read back when the slot is about to be
+     *  reused a few frames later, so the render loop does not wait for the GPU. PNG encoding and file I/O
+     *  happen on a pool of worker threads.
+     */
     class DummyWindowWithPNGSnapshots : public DummyWindow
     {
     public:
@@ -88,11 +186,8 @@ namespace Anvil
                                              PresentCallbackFunction in_present_callback_func,
                                              InputCallbacks          in_input_callback_collection);
 
-        /** Destructor */
-        virtual ~DummyWindowWithPNGSnapshots()
-        {
-            /* Stub */
-        }
+        /** Destructor. Waits until all pending frames are stored. */
+        virtual ~DummyWindowWithPNGSnapshots();
 
         /* Returns window's platform */
         WindowPlatform get_platform() const
@@ -111,6 +206,35 @@ namespace Anvil
         void set_swapchain(Anvil::Swapchain* in_swapchain_ptr);
 
     private:
+        /* Private type definitions */
+
+        /* Owns resources needed to read back a single in-flight frame. */
+        typedef struct CaptureSlot
+        {
+            /* Command buffers copying swapchain image contents to the readback buffer. One per swapchain image. */
+            std::vector<Anvil::PrimaryCommandBufferUniquePtr> cmd_buffer_ptrs;
+
+            Anvil::FenceUniquePtr  fence_ptr;
+            Anvil::ImageUniquePtr  intermediate_image_ptr;
+            bool                   is_pending;
+            uint32_t               n_frame;
+            Anvil::BufferUniquePtr readback_buffer_ptr;
+
+            CaptureSlot()
+                :is_pending(false),
+                 n_frame   (0)
+            {
+                /* Stub */
+            }
+        } CaptureSlot;
+
+        /* Describes a single frame waiting to be encoded and stored by one of the worker threads. */
+        typedef struct EncodeJob
+        {
+            std::string                file_name;
+            std::unique_ptr<uint8_t[]> raw_data_ptr;
+        } EncodeJob;
+
         /* Private functions */
         DummyWindowWithPNGSnapshots(const std::string&      in_title,
                                     unsigned int            in_width,
@@ -118,26 +242,33 @@ namespace Anvil
                                     PresentCallbackFunction in_present_callback_func, 
                                     InputCallbacks          in_input_callback_collection);
 
-        /** Grabs contents of the specified swapchain image and returns them in a raw R8G8B8A8_UNORM
-         *  format.
-         *
-         *  NOTE: This solution is temporary. At some point, this function is going to be exposed 
-         *        in Image interface.
-         *
-         *  @param in_swapchain_image_ptr Swapchain image, whose contents should be extracted.
-         *
-         *  @return As per summary.
-         */
-        std::unique_ptr<uint8_t[]> get_swapchain_image_raw_r8g8b8a8_unorm_data(Anvil::Image* in_swapchain_image_ptr);
+        void encode_worker_thread_entrypoint();
+        void finish_pending_captures        ();
+        bool init_capture_pipeline          ();
+        void record_capture_commands        (Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr,
+                                             Anvil::Image*                in_swapchain_image_ptr,
+                                             CaptureSlot*                 in_slot_ptr);
+        void retire_capture_slot            (CaptureSlot*                 in_slot_ptr);
 
-        /** Grabs fake swapchain image contents and stores it in a PNG file. */
+        /** Submits a copy of the last acquired swapchain image to the next capture slot. If the slot is still
+         *  holding an older frame, that frame is read back and handed over to the encoder threads first.
+         */
         void store_swapchain_frame();
 
         /* Private members */
-        uint32_t    m_height;
-        uint32_t    m_n_frames_presented;
-        std::string m_title;
-        uint32_t    m_width;
+        std::vector<std::unique_ptr<CaptureSlot> > m_capture_slots;
+        uint32_t                                   m_capture_image_height;
+        uint32_t                                   m_capture_image_width;
+        bool                                       m_capture_pipeline_initialized;
+        std::condition_variable                    m_encode_jobs_cv;
+        std::deque<EncodeJob>                      m_encode_jobs;
+        std::mutex                                 m_encode_jobs_mutex;
+        std::vector<std::thread>                   m_encode_worker_threads;
+        bool                                       m_encode_workers_should_quit;
+        uint32_t                                   m_height;
+        uint32_t                                   m_n_frames_presented;
+        std::string                                m_title;
+        uint32_t                                   m_width;
 
         Anvil::Swapchain* m_swapchain_ptr;
     };
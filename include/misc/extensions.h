@@ -118,6 +118,7 @@ namespace Anvil
             ValueType khr_storage_buffer_storage_class;
             ValueType khr_swapchain;
             ValueType khr_swapchain_mutable_format;
+            ValueType khr_timeline_semaphore;
             ValueType khr_variable_pointers;
             ValueType khr_vulkan_memory_model;
 
@@ -228,6 +229,7 @@ namespace Anvil
                     {ExtensionData(VK_KHR_STORAGE_BUFFER_STORAGE_CLASS_EXTENSION_NAME,     &khr_storage_buffer_storage_class)},
                     {ExtensionData(VK_KHR_SWAPCHAIN_EXTENSION_NAME,                        &khr_swapchain)},
                     {ExtensionData(VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME,         &khr_swapchain_mutable_format)},
+                    {ExtensionData(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,               &khr_timeline_semaphore)},
                     {ExtensionData(VK_KHR_VARIABLE_POINTERS_EXTENSION_NAME,                &khr_variable_pointers)},
                     {ExtensionData(VK_KHR_VULKAN_MEMORY_MODEL_EXTENSION_NAME,              &khr_vulkan_memory_model)},
 
@@ -430,6 +432,7 @@ namespace Anvil
         virtual ValueType khr_storage_buffer_storage_class    () const = 0;
         virtual ValueType khr_swapchain                       () const = 0;
         virtual ValueType khr_swapchain_mutable_format        () const = 0;
+        virtual ValueType khr_timeline_semaphore              () const = 0;
         virtual ValueType khr_variable_pointers               () const = 0;
         virtual ValueType khr_vulkan_memory_model             () const = 0;
 
@@ -1110,6 +1113,13 @@ namespace Anvil
             return m_device_extensions_ptr->khr_swapchain_mutable_format;
         }
 
+        ValueType khr_timeline_semaphore() const final
+        {
+            anvil_assert(m_expose_device_extensions);
+
+            return m_device_extensions_ptr->khr_timeline_semaphore;
+        }
+
         ValueType khr_variable_pointers() const final
         {
             anvil_assert(m_expose_device_extensions);
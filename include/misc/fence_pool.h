@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Device-wide fence pool. Implemented in order to:
+ *
+ *  - avoid creating and destroying Vulkan fences every time a submission needs to be waited on.
+ *  - reset recycled fences in batches, using a single vkResetFences() call per batch.
+ *
+ *  Fences returned by get_fence() are always unsignalled. A fence is returned to the pool when the unique
+ *  pointer referring to it goes out of scope. Returned fences are kept aside and only reset when the pool
+ *  runs out of unsignalled fences, so that many fences can be reset at once.
+ *
+ *  A fence may be returned while a submission it was passed to is still pending (eg. after a wait on it timed
+ *  out). Such fences are not reset, and hence not reused, until they become signalled. Fences which have never
+ *  been submitted (eg. because the submission failed) are reused right away, without a reset.
+ *
+ *  Whether a fence has been submitted is tracked by Anvil::Queue, so fences handed out by the pool must only be
+ *  submitted through Anvil::Queue.
+ *
+ *  This object should ONLY be instantiated by Anvil::BaseDevice.
+ *
+ *  Opt-in MT-safety available.
+ **/
+#ifndef MISC_FENCE_POOL_H
+#define MISC_FENCE_POOL_H
+
+#include "misc/mt_safety.h"
+#include "misc/types.h"
+
+namespace Anvil
+{
+    class FencePool : public MTSafetySupportProvider
+    {
+    public:
+        /* Public functions */
+
+        /** Destructor */
+        ~FencePool();
+
+        /** Returns an unsignalled fence. If no such fence is available in the pool, signalled fences returned to
+         *  the pool earlier are reset. If there are none, a new fence is created.
+         *
+         *  @return Requested fence, or nullptr if the pool failed to create a new fence. Releasing the pointer
+         *          returns the fence to the pool. Do NOT destroy the fence in any other way.
+         **/
+        Anvil::FenceUniquePtr get_fence();
+
+        /** Returns the number of fences owned by the pool which are not in use at the time of the call. */
+        uint32_t get_n_available_fences() const;
+
+        /** Returns the total number of fences created by the pool so far. */
+        uint32_t get_n_fences() const;
+
+    private:
+        /* Private functions */
+        FencePool(const Anvil::BaseDevice* in_device_ptr,
+                  bool                     in_mt_safe);
+
+        FencePool           (const FencePool&);
+        FencePool& operator=(const FencePool&);
+
+        void on_fence_returned(Anvil::Fence* in_fence_ptr);
+
+        static Anvil::FencePoolUniquePtr create(const Anvil::BaseDevice* in_device_ptr,
+                                                bool                     in_mt_safe);
+
+        /* Private members */
+        const Anvil::BaseDevice* m_device_ptr;
+
+        std::vector<Anvil::Fence*>         m_available_fence_ptrs;
+        std::vector<Anvil::FenceUniquePtr> m_fence_ptrs;
+        std::vector<Anvil::Fence*>         m_returned_fence_ptrs;
+
+        friend class BaseDevice;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_FENCE_POOL_H */
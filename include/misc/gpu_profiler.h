@@ -0,0 +1,311 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** GPU timestamp profiler. Implemented in order to:
+ *
+ *  - measure GPU execution time of named, nestable zones recorded into command buffers.
+ *  - retrieve the timings without stalling the CPU. Each frame in flight writes to its own timestamp query
+ *    pool, which is only polled (without VK_QUERY_RESULT_WAIT_BIT) when it is about to be reused by a later
+ *    frame. Frames whose results are not available by then are dropped.
+ *  - aggregate the timings per zone path (eg. "Frame/GBuffer/Opaque") and export them in Chrome trace event
+ *    format, so that they can be inspected with chrome://tracing or Perfetto.
+ *
+ *  Zones are also emitted as VK_EXT_debug_utils labels, so that the same names show up in frame debuggers.
+ *
+ *  Usage:
+ *
+ *  1. Call begin_frame() once per frame for the command buffer which is submitted first in that frame. The call
+ *     records a reset of the frame's query pool, so it must be made outside of a render pass.
+ *  2. Bracket GPU work with begin_zone() and end_zone() calls, or use GPUProfilerZone. A zone may begin and end in
+ *     different command buffers, as long as all command buffers of the frame are submitted to the same queue,
+ *     in the order they were recorded in.
+ *  3. Call end_frame() after the last zone of the frame ends.
+ *
+ *  Opt-in MT-safety available.
+ **/
+#ifndef MISC_GPU_PROFILER_H
+#define MISC_GPU_PROFILER_H
+
+#include "misc/mt_safety.h"
+#include "misc/types.h"
+#include <deque>
+#include <map>
+
+namespace Anvil
+{
+    class GPUProfiler : public MTSafetySupportProvider
+    {
+    public:
+        /* Public type definitions */
+
+        /* Describes GPU execution of a single zone instance. */
+        typedef struct ZoneResult
+        {
+            /* Nesting level of the zone. 0 for zones which were started with no other zone active. */
+            uint32_t depth;
+
+            /* Time between the zone's begin and end timestamps */
+            double duration_usec;
+
+            /* Index of the frame the zone was recorded for, as counted by begin_frame() */
+            uint64_t n_frame;
+
+            std::string name;
+
+            /* Index of the parent zone in the result vector, or UINT32_MAX for top-level zones */
+            uint32_t parent_zone_index;
+
+            /* Time of the zone's begin timestamp, relative to the first timestamp retrieved by the profiler */
+            double start_usec;
+        } ZoneResult;
+
+        /* Aggregated timings of all instances of a zone at a given position in the zone hierarchy. */
+        typedef struct ZoneStatistics
+        {
+            uint32_t    depth;
+            double      max_duration_usec;
+            double      min_duration_usec;
+            uint64_t    n_samples;
+            std::string path;
+            double      total_duration_usec;
+
+            ZoneStatistics()
+                :depth              (0),
+                 max_duration_usec  (0.0),
+                 min_duration_usec  (0.0),
+                 n_samples          (0),
+                 total_duration_usec(0.0)
+            {
+                /* Stub */
+            }
+
+            double get_avg_duration_usec() const
+            {
+                return (n_samples > 0) ? total_duration_usec / static_cast<double>(n_samples)
+                                       : 0.0;
+            }
+        } ZoneStatistics;
+
+        /* Public functions */
+
+        /** Creates a new profiler instance.
+         *
+         *  @param in_device_ptr            Device to use. Must not be nullptr.
+         *  @param in_n_frames_in_flight    Number of frames whose timestamps may be pending at the same time. Results of
+         *                                  a frame are retrieved this many frames after it was started. Must be at least 1.
+         *  @param in_n_max_zones_per_frame Maximum number of zones which can be timed in a single frame. Zones exceeding
+         *                                  the limit are only emitted as debug labels.
+         *  @param in_n_max_trace_frames    Number of most recently retrieved frames to keep for get_chrome_trace_json().
+         *                                  0 disables trace capture. Statistics are gathered regardless.
+         *  @param in_mt_safety             MT safety setting to use.
+         *
+         *  @return New profiler instance, or nullptr if the query pools could not be created.
+         **/
+        static Anvil::GPUProfilerUniquePtr create(const Anvil::BaseDevice* in_device_ptr,
+                                                  uint32_t                 in_n_frames_in_flight,
+                                                  uint32_t                 in_n_max_zones_per_frame,
+                                                  uint32_t                 in_n_max_trace_frames,
+                                                  MTSafety                 in_mt_safety = Anvil::MTSafety::INHERIT_FROM_PARENT_DEVICE);
+
+        /** Destructor */
+        ~GPUProfiler();
+
+        /** Starts a new frame. Retrieves results of the frame which used the same query pool before, if they are
+         *  available, and records a reset of the query pool into @param in_cmd_buffer_ptr.
+         *
+         *  @param in_cmd_buffer_ptr Command buffer to record the query pool reset into. Must be in recording state
+         *                           and must not have a render pass active. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool begin_frame(Anvil::CommandBufferBase* in_cmd_buffer_ptr);
+
+        /** Begins a new zone, nested in the zone which is currently active (if any). Records a timestamp write and
+         *  opens a debug label region of the same name.
+         *
+         *  @param in_cmd_buffer_ptr     Command buffer to record the commands into. Must not be nullptr.
+         *  @param in_name               Zone name. Must not contain '/'.
+         *  @param in_opt_color_vec4_ptr Debug label color. May be nullptr, in which case white is used.
+         *  @param in_pipeline_stage     Pipeline stage to write the timestamp at.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool begin_zone(Anvil::CommandBufferBase*    in_cmd_buffer_ptr,
+                        const std::string&           in_name,
+                        const float*                 in_opt_color_vec4_ptr = nullptr,
+                        Anvil::PipelineStageFlagBits in_pipeline_stage     = Anvil::PipelineStageFlagBits::TOP_OF_PIPE_BIT);
+
+        /** Ends the frame started with the preceding begin_frame() call. All zones must have been ended by the time
+         *  this function is called.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool end_frame();
+
+        /** Ends the most recently started zone. Records a timestamp write and closes the debug label region.
+         *
+         *  @param in_cmd_buffer_ptr Command buffer to record the commands into. Must not be nullptr.
+         *  @param in_pipeline_stage Pipeline stage to write the timestamp at.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool end_zone(Anvil::CommandBufferBase*    in_cmd_buffer_ptr,
+                      Anvil::PipelineStageFlagBits in_pipeline_stage = Anvil::PipelineStageFlagBits::BOTTOM_OF_PIPE_BIT);
+
+        /** Stores the result of get_chrome_trace_json() in a file.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool export_chrome_trace(const std::string& in_filename) const;
+
+        /** Returns zone results of the most recently retrieved frames as a Chrome trace event format JSON document.
+         *  Each zone is reported as a complete ("X") event.
+         **/
+        std::string get_chrome_trace_json() const;
+
+        /** Returns zone results of the most recently retrieved frame, in the order zones were started in.
+         *
+         *  @param out_results_ptr Deref will be set to the results. Must not be nullptr.
+         **/
+        void get_last_frame_results(std::vector<ZoneResult>* out_results_ptr) const;
+
+        /** Returns the number of frames whose results were not available by the time their query pool had to be
+         *  reused. If this value keeps growing, the number of frames in flight should be increased.
+         **/
+        uint64_t get_n_dropped_frames() const;
+
+        /** Returns timings aggregated per zone path since the profiler was created or reset_statistics() was last
+         *  called. Zones are sorted by path, so parents always precede their children.
+         *
+         *  @param out_statistics_ptr Deref will be set to the statistics. Must not be nullptr.
+         **/
+        void get_statistics(std::vector<ZoneStatistics>* out_statistics_ptr) const;
+
+        /** Discards aggregated statistics and captured trace frames. */
+        void reset_statistics();
+
+    private:
+        /* Private type definitions */
+
+        typedef struct Zone
+        {
+            uint32_t    depth;
+            bool        is_timed;
+            std::string name;
+            uint32_t    parent_zone_index;
+            uint32_t    start_query_index;
+        } Zone;
+
+        typedef struct Frame
+        {
+            bool                      is_pending;
+            uint64_t                  n_frame;
+            uint32_t                  n_queries_used;
+            Anvil::QueryPoolUniquePtr query_pool_ptr;
+            std::vector<Zone>         zones;
+
+            Frame()
+                :is_pending    (false),
+                 n_frame       (0),
+                 n_queries_used(0)
+            {
+                /* Stub */
+            }
+        } Frame;
+
+        /* Private functions */
+        GPUProfiler(const Anvil::BaseDevice* in_device_ptr,
+                    uint32_t                 in_n_max_zones_per_frame,
+                    uint32_t                 in_n_max_trace_frames,
+                    bool                     in_mt_safe);
+
+        GPUProfiler           (const GPUProfiler&);
+        GPUProfiler& operator=(const GPUProfiler&);
+
+        bool init                  (uint32_t in_n_frames_in_flight);
+        void retrieve_frame_results(Frame*   in_frame_ptr);
+
+        /* Private variables */
+        Frame*                                m_current_frame_ptr;
+        const Anvil::BaseDevice*              m_device_ptr;
+        std::vector<std::unique_ptr<Frame> >  m_frames;
+        bool                                  m_has_time_origin;
+        std::vector<ZoneResult>               m_last_frame_results;
+        std::vector<uint64_t>                 m_query_results;
+        uint64_t                              m_n_dropped_frames;
+        uint64_t                              m_n_frames_started;
+        uint32_t                              m_n_max_trace_frames;
+        uint32_t                              m_n_max_zones_per_frame;
+        uint32_t                              m_n_timestamp_bits;
+        std::map<std::string, ZoneStatistics> m_statistics;
+        uint64_t                              m_time_origin_ticks;
+        double                                m_timestamp_period_nsec;
+        std::deque<std::vector<ZoneResult> >  m_trace_frames;
+        std::vector<uint32_t>                 m_zone_stack;
+    };
+
+    /** Helper class which begins a GPU profiler zone at construction time and ends it at destruction time. */
+    class GPUProfilerZone
+    {
+    public:
+        /* Public functions */
+
+        /** Constructor. Please see GPUProfiler::begin_zone() for argument specification.
+         *
+         *  @param in_profiler_ptr Profiler to use. May be nullptr, in which case the object does nothing.
+         **/
+        GPUProfilerZone(Anvil::GPUProfiler*       in_profiler_ptr,
+                        Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                        const std::string&        in_name,
+                        const float*              in_opt_color_vec4_ptr = nullptr)
+            :m_cmd_buffer_ptr(in_cmd_buffer_ptr),
+             m_profiler_ptr  (in_profiler_ptr)
+        {
+            if (m_profiler_ptr != nullptr)
+            {
+                m_profiler_ptr->begin_zone(in_cmd_buffer_ptr,
+                                           in_name,
+                                           in_opt_color_vec4_ptr);
+            }
+        }
+
+        /** Destructor */
+        ~GPUProfilerZone()
+        {
+            if (m_profiler_ptr != nullptr)
+            {
+                m_profiler_ptr->end_zone(m_cmd_buffer_ptr);
+            }
+        }
+
+    private:
+        /* Private functions */
+        GPUProfilerZone           (const GPUProfilerZone&);
+        GPUProfilerZone& operator=(const GPUProfilerZone&);
+
+        /* Private variables */
+        Anvil::CommandBufferBase* m_cmd_buffer_ptr;
+        Anvil::GPUProfiler*       m_profiler_ptr;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_GPU_PROFILER_H */
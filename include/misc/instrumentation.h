@@ -0,0 +1,222 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** CPU instrumentation layer. Implemented in order to:
+ *
+ *  - measure how much time Anvil spends in its hot paths (queue submissions, pipeline baking, descriptor set
+ *    updates, memory allocator baking, GLSL->SPIR-V conversion).
+ *  - keep the cost of recording an event low. Each thread appends events to its own fixed-size ring buffer
+ *    without taking any locks. Events which do not fit in the buffer are dropped and counted.
+ *  - let apps decide what to do with the data. Buffered events are handed over to a user-specified sink
+ *    whenever Instrumentation::flush() is called. ChromeTraceInstrumentationSink is provided out of the box.
+ *
+ *  The ANVIL_INSTRUMENTATION_COUNTER() and ANVIL_INSTRUMENTATION_SCOPE() macros used by Anvil entry-points
+ *  expand to nothing, unless Anvil is built with ANVIL_ENABLE_INSTRUMENTATION CMake option enabled.
+ **/
+#ifndef MISC_INSTRUMENTATION_H
+#define MISC_INSTRUMENTATION_H
+
+#include "misc/types.h"
+#include "misc/time.h"
+#include <mutex>
+
+namespace Anvil
+{
+    enum class InstrumentationEventType
+    {
+        /* Event value holds a delta to apply to the counter */
+        COUNTER,
+
+        /* Event value holds zone duration in nanoseconds */
+        ZONE
+    };
+
+    typedef struct InstrumentationEvent
+    {
+        /* Must point to a string with static storage duration */
+        const char* name;
+
+        /* As returned by Anvil::Time::get_absolute_time_in_nsec() */
+        uint64_t start_time_nsec;
+
+        InstrumentationEventType type;
+        uint64_t                 value;
+    } InstrumentationEvent;
+
+    /** Interface which needs to be implemented by objects which are to receive flushed instrumentation events. */
+    class IInstrumentationSink
+    {
+    public:
+        virtual ~IInstrumentationSink()
+        {
+            /* Stub */
+        }
+
+        /** Called by Instrumentation::flush() for every thread which recorded events since the last flush.
+         *
+         *  Calls are serialized, but may be made from any thread which calls flush().
+         *
+         *  @param in_thread_id  Anvil-assigned ID of the thread which recorded the events.
+         *  @param in_events_ptr Events, in the order they were recorded in. Only valid for the duration of the call.
+         *  @param in_n_events   Number of events under @param in_events_ptr.
+         **/
+        virtual void on_events_flushed(uint32_t                    in_thread_id,
+                                       const InstrumentationEvent* in_events_ptr,
+                                       uint32_t                    in_n_events) = 0;
+    };
+
+    class Instrumentation
+    {
+    public:
+        /* Public functions */
+
+        /** Hands all events recorded since the last flush over to the sink. If no sink is set, the events
+         *  are discarded.
+         *
+         *  Thread-safe.
+         **/
+        static void flush();
+
+        /** Returns the number of events which have been dropped because a thread's event buffer was full. */
+        static uint64_t get_n_dropped_events();
+
+        /** Records a counter update for the calling thread.
+         *
+         *  @param in_name  Counter name. Must point to a string with static storage duration.
+         *  @param in_delta Value to add to the counter.
+         **/
+        static void record_counter(const char* in_name,
+                                   uint64_t    in_delta);
+
+        /** Records a timed zone for the calling thread.
+         *
+         *  @param in_name            Zone name. Must point to a string with static storage duration.
+         *  @param in_start_time_nsec Zone start time, as returned by Anvil::Time::get_absolute_time_in_nsec().
+         *  @param in_end_time_nsec   Zone end time, as returned by Anvil::Time::get_absolute_time_in_nsec().
+         **/
+        static void record_zone(const char* in_name,
+                                uint64_t    in_start_time_nsec,
+                                uint64_t    in_end_time_nsec);
+
+        /** Sets the object which flush() should hand events over to.
+         *
+         *  @param in_opt_sink_ptr New sink. May be nullptr. The sink must stay alive until it is replaced,
+         *                         or until the last flush() call returns.
+         **/
+        static void set_sink(IInstrumentationSink* in_opt_sink_ptr);
+
+    private:
+        Instrumentation();
+    };
+
+    /** Records a zone covering the lifetime of the object. */
+    class InstrumentationScope
+    {
+    public:
+        /* Public functions */
+        explicit InstrumentationScope(const char* in_name)
+            :m_name           (in_name),
+             m_start_time_nsec(Anvil::Time::get_absolute_time_in_nsec() )
+        {
+            /* Stub */
+        }
+
+        ~InstrumentationScope()
+        {
+            Anvil::Instrumentation::record_zone(m_name,
+                                                m_start_time_nsec,
+                                                Anvil::Time::get_absolute_time_in_nsec() );
+        }
+
+    private:
+        /* Private functions */
+        InstrumentationScope           (const InstrumentationScope&);
+        InstrumentationScope& operator=(const InstrumentationScope&);
+
+        /* Private variables */
+        const char* m_name;
+        uint64_t    m_start_time_nsec;
+    };
+
+    /** Instrumentation sink which accumulates flushed events and exports them in Chrome trace event format.
+     *  Zones are exported as complete ("X") events, counters as counter ("C") events holding running totals.
+     *
+     *  Thread-safe.
+     **/
+    class ChromeTraceInstrumentationSink : public IInstrumentationSink
+    {
+    public:
+        /* Public functions */
+         ChromeTraceInstrumentationSink();
+        ~ChromeTraceInstrumentationSink();
+
+        /** Stores the result of get_chrome_trace_json() in a file.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool export_chrome_trace(const std::string& in_filename) const;
+
+        /** Returns all events accumulated so far as a Chrome trace event format JSON document. */
+        std::string get_chrome_trace_json() const;
+
+        /* IInstrumentationSink implementation */
+        void on_events_flushed(uint32_t                    in_thread_id,
+                               const InstrumentationEvent* in_events_ptr,
+                               uint32_t                    in_n_events) override;
+
+        /** Discards all accumulated events. */
+        void reset();
+
+    private:
+        /* Private type definitions */
+        typedef struct ThreadEvent
+        {
+            InstrumentationEvent event;
+            uint32_t             thread_id;
+        } ThreadEvent;
+
+        /* Private functions */
+        ChromeTraceInstrumentationSink           (const ChromeTraceInstrumentationSink&);
+        ChromeTraceInstrumentationSink& operator=(const ChromeTraceInstrumentationSink&);
+
+        /* Private variables */
+        std::vector<ThreadEvent> m_events;
+        mutable std::mutex       m_mutex;
+    };
+}; /* namespace Anvil */
+
+#if defined(ANVIL_ENABLE_INSTRUMENTATION)
+    #define ANVIL_INSTRUMENTATION_CONCAT_INTERNAL(a, b) a##b
+    #define ANVIL_INSTRUMENTATION_CONCAT(a, b)          ANVIL_INSTRUMENTATION_CONCAT_INTERNAL(a, b)
+
+    #define ANVIL_INSTRUMENTATION_COUNTER(name, delta) \
+        Anvil::Instrumentation::record_counter(name,   \
+                                               static_cast<uint64_t>(delta) )
+
+    #define ANVIL_INSTRUMENTATION_SCOPE(name) \
+        Anvil::InstrumentationScope ANVIL_INSTRUMENTATION_CONCAT(instrumentation_scope_, __LINE__)(name)
+#else
+    #define ANVIL_INSTRUMENTATION_COUNTER(name, delta)
+    #define ANVIL_INSTRUMENTATION_SCOPE(name)
+#endif
+
+#endif /* MISC_INSTRUMENTATION_H */
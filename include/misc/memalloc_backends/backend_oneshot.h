@@ -25,6 +25,9 @@
  *
  * The allocator can only handle one bake request throughout its life-time.
  *
+ * Optionally, the backend can let items whose lifetimes do not overlap share memory ranges. This is used to implement
+ * transient memory allocators.
+ *
  * This class should only be used internally by MemoryAllocator.
  **/
 #ifndef MISC_MEMORY_ALLOCATOR_BACKEND_ONESHOT_H
@@ -51,9 +54,13 @@ namespace Anvil
              *
              *  Should only be used internally by MemoryAllocator.
              *
-             *  @param in_device_ptr Vulkan device the memory allocations are going to be made for.
+             *  @param in_device_ptr                          Vulkan device the memory allocations are going to be made for.
+             *  @param in_alias_items_with_disjoint_lifetimes true if items whose lifetimes do not overlap should be allowed to
+             *                                                share memory. Also makes the backend prefer lazily allocated
+             *                                                memory for transient attachments.
              **/
-            OneShot(const Anvil::BaseDevice* in_device_ptr);
+            OneShot(const Anvil::BaseDevice* in_device_ptr,
+                    bool                     in_alias_items_with_disjoint_lifetimes);
 
             /** Destructor. */
             virtual ~OneShot();
@@ -62,6 +69,7 @@ namespace Anvil
             /* IMemoryAllocatorBackend functions */
 
             bool     bake                            (Anvil::MemoryAllocator::Items&              in_items) final;
+            void     get_memory_type_statistics      (std::vector<Anvil::MemoryAllocator::MemoryTypeStatistics>* out_statistics_ptr) const final;
             VkResult map                             (void*                                       in_memory_object,
                                                       VkDeviceSize                                in_start_offset,
                                                       VkDeviceSize                                in_memory_block_start_offset,
@@ -75,7 +83,15 @@ namespace Anvil
 
             /* Private functions */
 
+            VkDeviceSize calculate_aliased_item_offsets(const std::vector<Anvil::MemoryAllocator::Item*>&      in_items,
+                                                        std::map<Anvil::MemoryAllocator::Item*, VkDeviceSize>* out_offsets_ptr) const;
+            VkDeviceSize calculate_item_offsets        (const std::vector<Anvil::MemoryAllocator::Item*>&      in_items,
+                                                        std::map<Anvil::MemoryAllocator::Item*, VkDeviceSize>* out_offsets_ptr) const;
+
+            static bool is_linear_item(const Anvil::MemoryAllocator::Item* in_item_ptr);
+
             /* Private variables */
+            bool                              m_alias_items_with_disjoint_lifetimes;
             const Anvil::BaseDevice*          m_device_ptr;
             bool                              m_is_baked;
             std::vector<MemoryBlockUniquePtr> m_memory_blocks;
@@ -125,6 +125,7 @@ namespace Anvil
             /* IMemoryAllocatorBackend functions */
 
             bool     bake                            (Anvil::MemoryAllocator::Items&              in_items) final;
+            void     get_memory_type_statistics      (std::vector<Anvil::MemoryAllocator::MemoryTypeStatistics>* out_statistics_ptr) const final;
             VkResult map                             (void*                                       in_memory_object,
                                                       VkDeviceSize                                in_start_offset,
                                                       VkDeviceSize                                in_memory_block_start_offset,
@@ -33,6 +33,9 @@
 #include "misc/mt_safety.h"
 #include "misc/types.h"
 #include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
 #include <vector>
 #include <cfloat>
 
@@ -97,12 +100,15 @@ namespace Anvil
             float                                memory_priority;
 
             VkExtent3D              extent;
+            uint32_t                first_use;
             bool                    is_baked;
+            uint32_t                last_use;
             VkDeviceSize            miptail_offset;
             uint32_t                n_layer;
             uint32_t                n_plane;
             VkOffset3D              offset;
             Anvil::ImageSubresource subresource;
+            std::string             tag;
 
             Item(Anvil::MemoryAllocator*                     in_memory_allocator_ptr,
                  Anvil::Buffer*                              in_buffer_ptr,
@@ -213,6 +219,49 @@ namespace Anvil
 
         typedef std::vector<std::unique_ptr<Item> > Items;
 
+        /* Describes usage of memory of a single memory type, as allocated by the memory allocator. */
+        typedef struct MemoryTypeStatistics
+        {
+            /* Size of the largest range of allocated memory which is not assigned to any object. */
+            VkDeviceSize largest_free_range_size;
+
+            /* Number of alive memory regions assigned to buffers & images. */
+            uint32_t n_allocations;
+
+            /* Number of Vulkan memory allocations. */
+            uint32_t n_blocks;
+
+            /* Number of disjoint ranges of allocated memory which are not assigned to any object. */
+            uint32_t n_free_ranges;
+
+            /* Total size of Vulkan memory allocations. */
+            VkDeviceSize reserved_size;
+
+            /* Number of bytes assigned to buffers & images. */
+            VkDeviceSize used_size;
+
+            MemoryTypeStatistics()
+                :largest_free_range_size(0),
+                 n_allocations          (0),
+                 n_blocks               (0),
+                 n_free_ranges          (0),
+                 reserved_size          (0),
+                 used_size              (0)
+            {
+                /* Stub */
+            }
+
+            /* Returns a value from range [0, 1], telling how scattered the free space is. 0 is returned if there is
+             * no free space, or if all free space is contiguous. */
+            float get_fragmentation() const
+            {
+                const VkDeviceSize free_size = reserved_size - used_size;
+
+                return (free_size > 0) ? 1.0f - static_cast<float>(largest_free_range_size) / static_cast<float>(free_size)
+                                       : 0.0f;
+            }
+        } MemoryTypeStatistics;
+
         class IMemoryAllocatorBackend : public IMemoryAllocatorBackendBase
         {
         public:
@@ -222,9 +271,23 @@ namespace Anvil
             }
 
             virtual bool bake                            (Items&                                      in_items)                              = 0;
+            virtual void get_memory_type_statistics      (std::vector<MemoryTypeStatistics>*          out_statistics_ptr)              const = 0;
             virtual bool supports_device_masks           ()                                                                            const = 0;
             virtual bool supports_external_memory_handles(const Anvil::ExternalMemoryHandleTypeFlags& in_external_memory_handle_types) const = 0;
             virtual bool supports_protected_memory       ()                                                                            const = 0;
+
+            /** Returns all alive memory blocks which have been assigned to items baked by the backend. */
+            std::vector<const Anvil::MemoryBlock*> get_baked_memory_blocks() const;
+
+            /** Should be called for each memory block assigned to an item at bake time. */
+            void on_memory_block_baked(const Anvil::MemoryBlock* in_memory_block_ptr);
+
+            /* IMemoryAllocatorBackendBase */
+            void on_memory_block_released(const Anvil::MemoryBlock* in_memory_block_ptr) final;
+
+        private:
+            std::unordered_set<const Anvil::MemoryBlock*> m_baked_memory_blocks;
+            mutable std::mutex                            m_baked_memory_blocks_mutex;
         };
 
         /* Public functions */
@@ -240,6 +303,11 @@ namespace Anvil
          *  @param in_data_vector_ptr                         The buffer will be filled with data extracted from the specified
          *                                                    vector. Total number of bytes defined in the vector must match
          *                                                    buffer size.
+         *
+         *                                                    Post-fill data of all buffers using non-mappable memory is
+         *                                                    uploaded at bake time with a single staging buffer and a single
+         *                                                    submission per queue.
+         *
          *  @param in_required_memory_features                Memory features the assigned memory must support.
          *                                                    See MemoryFeatureFlagBits for more details.
          *  @param in_opt_external_nt_handle_info_ptr         TODO. Pointer must remain valid till baking time.
@@ -510,6 +578,27 @@ namespace Anvil
         static Anvil::MemoryAllocatorUniquePtr create_oneshot(const Anvil::BaseDevice* in_device_ptr,
                                                               MTSafety                 in_mt_safety = Anvil::MTSafety::INHERIT_FROM_PARENT_DEVICE);
 
+        /** Creates a new transient memory allocator instance.
+         *
+         *  Works like the one-shot allocator, except that items whose lifetimes (as declared with set_lifetime() ) do not
+         *  overlap are allowed to share memory ranges. This is meant for render targets & scratch buffers which are only
+         *  needed for a part of a frame, such as the intermediate attachments of a post-processing chain.
+         *
+         *  Images which are created with TRANSIENT_ATTACHMENT usage are assigned lazily allocated memory, if the device
+         *  exposes a memory type which is compatible with both the image and the requested memory features.
+         *
+         *  Since aliased resources share memory, contents of a resource are undefined at the beginning of its lifetime.
+         *  Images should be transitioned from UNDEFINED layout at their first use. Apps are also responsible for making
+         *  sure the last use of a resource finishes executing before the first use of a resource it aliases with starts
+         *  (eg. by recording both uses in the same command buffer, separated with a pipeline barrier).
+         *
+         *  Items without a declared lifetime are never aliased.
+         *
+         *  @param in_device_ptr Device to use.
+         **/
+        static Anvil::MemoryAllocatorUniquePtr create_transient(const Anvil::BaseDevice* in_device_ptr,
+                                                                MTSafety                 in_mt_safety = Anvil::MTSafety::INHERIT_FROM_PARENT_DEVICE);
+
         /** Creates a new VMA memory allocator instance.
          *
          *  This type of allocator supports an arbitrary number of implicit or explicit bake invocations.
@@ -526,6 +615,24 @@ namespace Anvil
                                                           const Anvil::MemoryFeatureFlags& in_memory_features,
                                                           uint32_t*                        out_opt_filtered_memory_types_ptr);
 
+        /** Returns usage statistics of memory allocated by the allocator.
+         *
+         *  @param out_statistics_ptr Deref will be resized to the number of memory types supported by the device and
+         *                            filled with per-memory type statistics. Must not be nullptr.
+         **/
+        void get_statistics(std::vector<MemoryTypeStatistics>* out_statistics_ptr) const;
+
+        /** Returns a JSON document which describes memory allocated by the allocator. The document holds:
+         *
+         *  - "memory_types": statistics (see get_statistics() ) of each memory type the allocator has allocated memory from.
+         *  - "allocations":  one entry for each alive memory block assigned to a buffer or an image, including its tag,
+         *                    memory type, offset and size. Calling this function right before the allocator's objects are
+         *                    expected to be gone is an easy way of finding out which allocation sites leak memory.
+         *
+         *  Memory blocks must not be released from other threads while the document is being built.
+         **/
+        std::string get_statistics_json() const;
+
         /** By default, once memory regions are baked, memory allocator will bind them to objects specified
          *  at add_*() call time. Use cases exist where apps may prefer to handle this action on their own.
          *
@@ -565,6 +672,34 @@ namespace Anvil
          */
         void set_post_bake_callback(MemoryAllocatorBakeCallbackFunction in_post_bake_callback_function);
 
+        /** Assigns a tag to all items added with subsequent add_*() calls. At bake time, the tag is assigned to memory blocks
+         *  the items are given (see MemoryBlock::get_tag() ), and is then used to identify the allocation site in statistics
+         *  reports returned by get_statistics_json().
+         *
+         *  @param in_tag Tag to use. Pass an empty string to stop tagging items.
+         **/
+        void set_allocation_tag(const std::string& in_tag);
+
+        /** Declares the range of passes (or any other app-defined points within a frame) a resource is used in.
+         *  Only taken into account by transient allocators (see create_transient() ).
+         *
+         *  Must be called after the resource has been added to the allocator, and before the allocator is baked.
+         *
+         *  @param in_buffer_ptr / in_image_ptr Resource to declare the lifetime for. Must have been added to the allocator
+         *                                      with one of the add_*() functions.
+         *  @param in_first_use                 Index of the first pass the resource is used in.
+         *  @param in_last_use                  Index of the last pass the resource is used in. Must not be smaller than
+         *                                      @param in_first_use.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool set_lifetime(Anvil::Buffer* in_buffer_ptr,
+                          uint32_t       in_first_use,
+                          uint32_t       in_last_use);
+        bool set_lifetime(Anvil::Image*  in_image_ptr,
+                          uint32_t       in_first_use,
+                          uint32_t       in_last_use);
+
          /** Destructor.
           *
           *  Releases the underlying MemoryBlock instance
@@ -586,6 +721,13 @@ namespace Anvil
 
         bool do_bind_sparse_device_indices_sanity_check  (const MGPUBindSparseDeviceIndices*          in_opt_mgpu_bind_sparse_device_indices_ptr) const;
         bool do_external_memory_handle_type_sanity_checks(const Anvil::ExternalMemoryHandleTypeFlags& in_external_memory_handle_types) const;
+        bool fill_buffers_with_post_fill_data            ();
+
+        static const void* get_post_fill_data_ptr(const Item* in_item_ptr);
+
+        bool set_lifetime_internal(const void* in_buffer_or_image_ptr,
+                                   uint32_t    in_first_use,
+                                   uint32_t    in_last_use);
 
         void on_is_alloc_pending_for_buffer_query(CallbackArgument* in_callback_arg_ptr);
         void on_is_alloc_pending_for_image_query (CallbackArgument* in_callback_arg_ptr);
@@ -602,6 +744,7 @@ namespace Anvil
         MemoryAllocator& operator=(const MemoryAllocator&);
 
         /* Private members */
+        std::string                              m_allocation_tag;
         std::shared_ptr<IMemoryAllocatorBackend> m_backend_ptr;
         const Anvil::BaseDevice*                 m_device_ptr;
         Items                                    m_items;
@@ -0,0 +1,195 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/** Device-wide memory budget tracker. Implemented in order to:
+ *
+ *  - keep track of the number of bytes allocated by Anvil per memory heap and memory type. Only memory blocks which
+ *    own a memory allocation are taken into account; blocks derived from other blocks are not, so that the same
+ *    allocation is never counted twice. Memory blocks handed out by the VMA backend are counted at sub-allocation
+ *    granularity.
+ *  - estimate process-wide memory usage per heap. If VK_EXT_memory_budget has been enabled on the device, the estimate
+ *    is based on the usage reported by the driver at the time the budget was last refreshed, plus the bytes Anvil has allocated (or
+ *    released) since then. Otherwise, the bytes allocated by Anvil are used.
+ *  - notify subscribers whenever the estimated usage of a heap rises above one of the configured fractions of the heap
+ *    budget (see MEMORY_BUDGET_TRACKER_CALLBACK_ID_PRESSURE_THRESHOLD_CROSSED), so that apps can evict resources
+ *    before the driver starts paging memory out.
+ *
+ *  Before a pressure notification is fired, the budget is re-queried from the driver (if VK_EXT_memory_budget is
+ *  enabled) to confirm the estimate. Since the budget may also change due to activity of other processes, apps
+ *  are encouraged to call refresh_budget() periodically, eg. once per frame.
+ *
+ *  This object should ONLY be instantiated by Anvil::BaseDevice.
+ *
+ *  Opt-in MT-safety available.
+ **/
+#ifndef MISC_MEMORY_BUDGET_TRACKER_H
+#define MISC_MEMORY_BUDGET_TRACKER_H
+
+#include "misc/callbacks.h"
+#include "misc/mt_safety.h"
+#include "misc/types.h"
+
+namespace Anvil
+{
+    typedef enum
+    {
+        /* Notification fired when the estimated usage of a memory heap rises above one of the pressure thresholds.
+         *
+         * Only fired once per threshold. The notification will be fired again only after the estimated usage drops
+         * below the threshold and then rises above it again.
+         *
+         * The callback may release memory blocks.
+         *
+         * callback_arg: Pointer to OnMemoryPressureThresholdCrossedCallbackArgument instance.
+         */
+        MEMORY_BUDGET_TRACKER_CALLBACK_ID_PRESSURE_THRESHOLD_CROSSED,
+
+        /* Always last */
+        MEMORY_BUDGET_TRACKER_CALLBACK_ID_COUNT
+    } MemoryBudgetTrackerCallbackID;
+
+    class MemoryBudgetTracker : public CallbacksSupportProvider,
+                                public MTSafetySupportProvider
+    {
+    public:
+        /* Public type definitions */
+
+        typedef struct HeapBudget
+        {
+            /* Number of bytes allocated by Anvil from the heap */
+            VkDeviceSize allocated_size;
+
+            /* Heap budget, as reported by the driver. If VK_EXT_memory_budget is unsupported, this is the heap size. */
+            VkDeviceSize budget;
+
+            /* Estimated process-wide heap usage. Please see class documentation for more details. */
+            VkDeviceSize usage;
+
+            HeapBudget()
+                :allocated_size(0),
+                 budget        (0),
+                 usage         (0)
+            {
+                /* Stub */
+            }
+        } HeapBudget;
+
+        /* Public functions */
+
+        /** Destructor */
+        ~MemoryBudgetTracker();
+
+        /** Returns the number of bytes allocated by Anvil from heap at index @param in_n_heap. */
+        VkDeviceSize get_allocated_size_for_heap(uint32_t in_n_heap) const;
+
+        /** Returns the number of bytes allocated by Anvil from memory type at index @param in_n_memory_type. */
+        VkDeviceSize get_allocated_size_for_memory_type(uint32_t in_n_memory_type) const;
+
+        /** Returns budget information for heap at index @param in_n_heap.
+         *
+         *  The budget is NOT re-queried at call time. Use refresh_budget() to do so.
+         **/
+        HeapBudget get_heap_budget(uint32_t in_n_heap) const;
+
+        /** Returns the number of memory heaps tracked. */
+        uint32_t get_n_heaps() const
+        {
+            return static_cast<uint32_t>(m_heaps.size() );
+        }
+
+        /** Returns pressure thresholds, expressed as fractions of heap budgets. See set_pressure_thresholds(). */
+        std::vector<float> get_pressure_thresholds() const;
+
+        /** Tells whether heap budget & usage can be queried from the driver (VK_EXT_memory_budget enabled on the device). */
+        bool is_budget_query_supported() const
+        {
+            return m_is_budget_query_supported;
+        }
+
+        /** Re-queries heap budget & usage from the driver, if VK_EXT_memory_budget is supported, and fires pressure
+         *  notifications for heaps whose usage has risen above any of the thresholds since last time.
+         **/
+        void refresh_budget();
+
+        /** Configures fractions of heap budgets, at which pressure notifications should be fired.
+         *
+         *  By default, notifications are fired when the estimated heap usage exceeds 75%, 90% and 95% of the budget.
+         *
+         *  @param in_thresholds Values from range (0.0, 1.0]. The values are sorted at call time.
+         **/
+        void set_pressure_thresholds(const std::vector<float>& in_thresholds);
+
+    private:
+        /* Private type declarations */
+        typedef struct HeapData
+        {
+            VkDeviceSize allocated_size;
+            VkDeviceSize allocated_size_at_last_refresh;
+            VkDeviceSize budget;
+            uint32_t     n_thresholds_exceeded;
+            VkDeviceSize usage_at_last_refresh;
+
+            HeapData()
+                :allocated_size                (0),
+                 allocated_size_at_last_refresh(0),
+                 budget                        (0),
+                 n_thresholds_exceeded         (0),
+                 usage_at_last_refresh         (0)
+            {
+                /* Stub */
+            }
+        } HeapData;
+
+        /* Private functions */
+        MemoryBudgetTracker(const Anvil::BaseDevice* in_device_ptr,
+                            bool                     in_mt_safe);
+
+        MemoryBudgetTracker           (const MemoryBudgetTracker&);
+        MemoryBudgetTracker& operator=(const MemoryBudgetTracker&);
+
+        VkDeviceSize get_estimated_heap_usage (const HeapData&    in_heap_data)        const;
+        uint32_t     get_n_thresholds_exceeded(VkDeviceSize       in_usage,
+                                               VkDeviceSize       in_budget)           const;
+        void         on_memory_block_allocated(const MemoryBlock* in_memory_block_ptr);
+        void         on_memory_block_released (const MemoryBlock* in_memory_block_ptr);
+        void         query_budget             ();
+        void         update_pressure_levels   (bool               in_allow_budget_query);
+
+        static Anvil::MemoryBudgetTrackerUniquePtr create(const Anvil::BaseDevice* in_device_ptr,
+                                                          bool                     in_mt_safe);
+
+        /* Private members */
+        const Anvil::BaseDevice* m_device_ptr;
+
+        std::vector<HeapData>     m_heaps;
+        bool                      m_is_budget_query_supported;
+        std::vector<VkDeviceSize> m_memory_type_allocated_sizes;
+        std::vector<uint32_t>     m_memory_type_heap_indices;
+        std::vector<float>        m_pressure_thresholds;
+
+        friend class BaseDevice;
+        friend class MemoryBlock;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_MEMORY_BUDGET_TRACKER_H */
@@ -24,14 +24,47 @@
 #define MISC_PAGE_TRACKER_H
 
 #include "misc/types.h"
+#include <map>
 
 
 namespace Anvil
 {
-    /** Tracks memory page bindings for sparse images & sparse buffers */
+    /** Tracks memory page bindings for sparse images & sparse buffers.
+     *
+     *  Bindings are stored as an ordered map of disjoint, memory-backed page runs, keyed by their start offsets.
+     *  Adjacent runs which refer to contiguous regions of the same memory block are merged. Binding and lookup
+     *  cost is logarithmic in the number of runs (plus linear in the number of runs a binding overwrites), so
+     *  resources with hundreds of thousands of pages can be tracked. The number of memory-backed pages is
+     *  updated incrementally.
+     */
     class PageTracker
     {
     public:
+        /* Public type definitions */
+
+        /** Describes a run of pages bound to a contiguous region of a single memory block. */
+        typedef struct MemoryBlockBinding
+        {
+            MemoryBlock* memory_block_ptr;
+            VkDeviceSize memory_block_start_offset;
+            VkDeviceSize size;
+            VkDeviceSize start_offset;
+
+            MemoryBlockBinding(MemoryBlock* in_memory_block_ptr,
+                               VkDeviceSize in_memory_block_start_offset,
+                               VkDeviceSize in_size,
+                               VkDeviceSize in_start_offset)
+            {
+                memory_block_ptr          = in_memory_block_ptr;
+                memory_block_start_offset = in_memory_block_start_offset;
+                size                      = in_size;
+                start_offset              = in_start_offset;
+            }
+        } MemoryBlockBinding;
+
+        /* Maps start offsets of memory-backed page runs to their bindings */
+        typedef std::map<VkDeviceSize, MemoryBlockBinding> Bindings;
+
         /* Public functions */
 
         /** Constructor.
@@ -58,28 +91,21 @@ namespace Anvil
                                              VkDeviceSize  in_size,
                                              VkDeviceSize* out_memory_region_start_offset_ptr) const;
 
-        /** The same memory block is often bound to more than just one page. PageTracker
-         *  coalesces such occurences into a single descriptor.
-         *
-         *  This function can be used to retrieve a memory block, bound to a descriptor
-         *  at a given index (@param in_n_memory_block).
-         *
-         *  @param in_n_memory_block See above. Must not be equal or larger than value returned
-         *                           by get_n_memory_blocks().
+        /** The same memory block is often bound to more than just one page. PageTracker coalesces such occurences
+         *  into a single descriptor.
          *
-         *  @return The requested memory block.
-         */
-        Anvil::MemoryBlock* get_memory_block(uint32_t in_n_memory_block) const
+         *  This function returns all descriptors, ordered by their start offsets. Use it to iterate over the memory
+         *  blocks bound to the tracked region.
+         **/
+        const Bindings& get_bindings() const
         {
-            anvil_assert(in_n_memory_block < m_memory_blocks.size() );
-
-            return m_memory_blocks.at(in_n_memory_block).memory_block_ptr;
+            return m_bindings;
         }
 
         /** Returns the number of disjoint memory blocks */
         uint32_t get_n_memory_blocks() const
         {
-            return static_cast<uint32_t>(m_memory_blocks.size() );
+            return static_cast<uint32_t>(m_bindings.size() );
         }
 
         /** Returns total number of pages */
@@ -120,36 +146,17 @@ namespace Anvil
                          VkDeviceSize in_size);
 
     private:
-        /* Private type definitions */
-        typedef struct MemoryBlockBinding
-        {
-            MemoryBlock* memory_block_ptr;
-            VkDeviceSize memory_block_start_offset;
-            VkDeviceSize size;
-            VkDeviceSize start_offset;
-
-            MemoryBlockBinding(MemoryBlock* in_memory_block_ptr,
-                               VkDeviceSize in_memory_block_start_offset,
-                               VkDeviceSize in_size,
-                               VkDeviceSize in_start_offset)
-            {
-                memory_block_ptr          = in_memory_block_ptr;
-                memory_block_start_offset = in_memory_block_start_offset;
-                size                      = in_size;
-                start_offset              = in_start_offset;
-            }
-        } MemoryBlockBinding;
-
         /* Private functions */
+        uint32_t get_n_pages_in_range(VkDeviceSize in_start_offset,
+                                      VkDeviceSize in_end_offset) const;
+        void     merge_with_neighbors(Bindings::iterator in_binding_iterator);
 
         /* Private variables */
-        std::vector<MemoryBlockBinding>  m_memory_blocks;
-        uint32_t                         m_n_memory_blocks_with_memory_backing;
-        uint32_t                         m_n_pages_with_memory_backing;
-        uint32_t                         m_n_total_pages;
-        VkDeviceSize                     m_page_size;
-        VkDeviceSize                     m_region_size;
-        std::vector<PageOccupancyStatus> m_sparse_page_occupancy;
+        Bindings     m_bindings;
+        uint32_t     m_n_pages_with_memory_backing;
+        uint32_t     m_n_total_pages;
+        VkDeviceSize m_page_size;
+        VkDeviceSize m_region_size;
     };
 }; /* namespace Anvil */
 
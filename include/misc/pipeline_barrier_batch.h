@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Accumulates pipeline barriers recorded back-to-back into a command buffer, so that they can be issued with
+ *  a single vkCmdPipelineBarrier() call. Implemented in order to:
+ *
+ *  - reduce the number of pipeline barrier commands (and, consequently, pipeline drains) when many resources
+ *    are transitioned in a row, eg. when preparing a set of images for a render pass.
+ *  - drop barriers which neither transition the layout of an image, nor transfer ownership of a resource,
+ *    nor define a memory dependency.
+ *
+ *  Barriers are merged by OR-ing their source and destination stage masks. Since this only ever widens the
+ *  synchronization scopes, the merged command is at least as strong as the commands it replaces, as long as
+ *  none of the barriers depends on another barrier from the same batch. For this reason, barriers which:
+ *
+ *  - refer to a buffer range or an image subresource range overlapping with a range a pending barrier refers to, or
+ *  - specify different dependency flags than the pending barriers,
+ *
+ *  are never added to a batch which is not empty. Barriers which are identical to a pending barrier are dropped.
+ *
+ *  Create with CommandBufferBase::set_pipeline_barrier_batching_enabled().
+ *
+ *  The batch is NOT thread-safe.
+ **/
+#ifndef MISC_PIPELINE_BARRIER_BATCH_H
+#define MISC_PIPELINE_BARRIER_BATCH_H
+
+#include "misc/types.h"
+#include <unordered_set>
+
+namespace Anvil
+{
+    class PipelineBarrierBatch
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new, empty batch. */
+        static Anvil::PipelineBarrierBatchUniquePtr create();
+
+        /** Destructor */
+        ~PipelineBarrierBatch();
+
+        /** Appends a pipeline barrier command to the batch. Barriers which would not affect execution of the
+         *  command buffer are dropped.
+         *
+         *  Arguments have the same meaning as for vkCmdPipelineBarrier().
+         *
+         *  @return true if the command has been merged into the batch, false if it depends on one of the pending
+         *          barriers. In the latter case, the batch is left intact. The caller should flush it and call
+         *          this function again.
+         **/
+        bool add(Anvil::PipelineStageFlags    in_src_stage_mask,
+                 Anvil::PipelineStageFlags    in_dst_stage_mask,
+                 Anvil::DependencyFlags       in_dependency_flags,
+                 uint32_t                     in_memory_barrier_count,
+                 const VkMemoryBarrier*       in_memory_barriers_ptr,
+                 uint32_t                     in_buffer_memory_barrier_count,
+                 const VkBufferMemoryBarrier* in_buffer_memory_barriers_ptr,
+                 uint32_t                     in_image_memory_barrier_count,
+                 const VkImageMemoryBarrier*  in_image_memory_barriers_ptr);
+
+        /** Removes all pending barriers from the batch. Scratch storage is retained. */
+        void clear();
+
+        /** Returns buffer memory barriers to be issued when the batch is flushed. */
+        const std::vector<VkBufferMemoryBarrier>& get_buffer_memory_barriers() const
+        {
+            return m_buffer_memory_barriers;
+        }
+
+        /** Returns dependency flags to be used when the batch is flushed. */
+        const Anvil::DependencyFlags& get_dependency_flags() const
+        {
+            return m_dependency_flags;
+        }
+
+        /** Returns the destination stage mask to be used when the batch is flushed. */
+        const Anvil::PipelineStageFlags& get_dst_stage_mask() const
+        {
+            return m_dst_stage_mask;
+        }
+
+        /** Returns image memory barriers to be issued when the batch is flushed. */
+        const std::vector<VkImageMemoryBarrier>& get_image_memory_barriers() const
+        {
+            return m_image_memory_barriers;
+        }
+
+        /** Returns memory barriers to be issued when the batch is flushed. */
+        const std::vector<VkMemoryBarrier>& get_memory_barriers() const
+        {
+            return m_memory_barriers;
+        }
+
+        /** Returns the number of barriers dropped since creation or last reset() call. */
+        uint32_t get_n_dropped_barriers() const
+        {
+            return m_n_dropped_barriers;
+        }
+
+        /** Returns the number of pipeline barrier commands which were merged into a batch which already held another
+         *  command, since creation or last reset() call.
+         **/
+        uint32_t get_n_merged_commands() const
+        {
+            return m_n_merged_commands;
+        }
+
+        /** Returns the source stage mask to be used when the batch is flushed. */
+        const Anvil::PipelineStageFlags& get_src_stage_mask() const
+        {
+            return m_src_stage_mask;
+        }
+
+        /** Tells whether the batch holds no commands which need to be flushed.
+         *
+         *  Note that a batch whose barriers have all been dropped still needs to be flushed, in order to preserve
+         *  the execution dependency defined by the stage masks.
+         **/
+        bool is_empty() const
+        {
+            return (m_n_pending_commands == 0);
+        }
+
+        /** Removes all pending barriers from the batch and resets the counters. */
+        void reset();
+
+    private:
+        /* Private functions */
+        PipelineBarrierBatch();
+
+        PipelineBarrierBatch           (const PipelineBarrierBatch&);
+        PipelineBarrierBatch& operator=(const PipelineBarrierBatch&);
+
+        bool depends_on_pending_barriers(uint32_t                     in_buffer_memory_barrier_count,
+                                         const VkBufferMemoryBarrier* in_buffer_memory_barriers_ptr,
+                                         uint32_t                     in_image_memory_barrier_count,
+                                         const VkImageMemoryBarrier*  in_image_memory_barriers_ptr) const;
+        bool is_pending                 (const VkBufferMemoryBarrier& in_barrier) const;
+        bool is_pending                 (const VkImageMemoryBarrier&  in_barrier) const;
+
+        /* Private variables */
+        std::vector<VkBufferMemoryBarrier> m_buffer_memory_barriers;
+        std::vector<VkImageMemoryBarrier>  m_image_memory_barriers;
+        std::vector<VkMemoryBarrier>       m_memory_barriers;
+
+        /* Used to quickly reject resources which none of the pending barriers refers to. */
+        std::unordered_set<VkBuffer> m_pending_buffers;
+        std::unordered_set<VkImage>  m_pending_images;
+
+        Anvil::DependencyFlags    m_dependency_flags;
+        Anvil::PipelineStageFlags m_dst_stage_mask;
+        Anvil::PipelineStageFlags m_src_stage_mask;
+
+        uint32_t m_n_dropped_barriers;
+        uint32_t m_n_merged_commands;
+        uint32_t m_n_pending_commands;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_PIPELINE_BARRIER_BATCH_H */
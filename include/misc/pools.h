@@ -33,13 +33,17 @@
  *  3. Finally, at the top we have specialized classes which inherit from Pool. At instantiation time,
  *     they initialize a worker's instance and pass it down to the middle layer.
  *
- *  Pools are NOT thread-safe at the moment. This will be added in the near future.
+ *  Items can be retrieved from and returned to a pool from many threads at the same time. Workers' create_item()
+ *  calls are serialized by the pool, but reset_item() may be called concurrently for different items. Command
+ *  buffer pools which are used from many threads therefore need a parent command pool with MT safety enabled.
  */
 #ifndef WRAPPERS_POOLS_H
 #define WRAPPERS_POOLS_H
 
 #include "misc/types.h"
+#include <atomic>
 #include <forward_list>
+#include <mutex>
 
 
 namespace Anvil
@@ -73,21 +77,16 @@ namespace Anvil
     {
         PoolItemPtrType item;
 
+        /* Index of the next container in the pool's free list, or UINT32_MAX if this is the last one.
+         * Only meaningful while the item is available. */
+        std::atomic<uint32_t> n_next_available_item;
+
         PoolItemContainer()
+            :n_next_available_item(UINT32_MAX)
         {
             /* Stub */
         }
 
-        PoolItemContainer(PoolItemPtrType in_item)
-        {
-            item = std::move(in_item);
-        }
-
-        bool operator==(const PoolItemType* in_item_ptr) const
-        {
-            return item.get() == in_item_ptr;
-        }
-
         PoolItemContainer(const PoolItemContainer&) = delete;
         PoolItemContainer& operator=(const PoolItemContainer&) = delete;
     };
@@ -108,18 +107,24 @@ namespace Anvil
          *  @param in_pool_ptr Pointer to the command buffer pool, to which the command buffer
          *                     should be returned when the auto pointer goes out of scope. Must
          *                     not be nullptr.
+         *  @param in_n_item   Index of the item in the pool.
          **/
-        ReturnToPoolFunctor(GenericPool<PoolItemType, PoolItemPtrType>* in_pool_ptr)
+        ReturnToPoolFunctor(GenericPool<PoolItemType, PoolItemPtrType>* in_pool_ptr,
+                            uint32_t                                    in_n_item)
         {
+            n_item   = in_n_item;
             pool_ptr = in_pool_ptr;
         }
 
         void operator()(PoolItemType* in_item)
         {
-            pool_ptr->return_item(in_item);
+            ANVIL_REDUNDANT_ARGUMENT(in_item);
+
+            pool_ptr->return_item(n_item);
         }
 
     private:
+        uint32_t                                    n_item;
         GenericPool<PoolItemType, PoolItemPtrType>* pool_ptr;
     };
 
@@ -141,20 +146,23 @@ namespace Anvil
          **/
         GenericPool(uint32_t                      in_n_items_to_preallocate,
                     IPoolWorker<PoolItemPtrType>* in_worker_ptr)
-            :m_capacity  (in_n_items_to_preallocate),
-             m_worker_ptr(in_worker_ptr)
+            :m_available_items_head(UINT32_MAX),
+             m_capacity            (in_n_items_to_preallocate),
+             m_n_items             (0),
+             m_worker_ptr          (in_worker_ptr)
         {
+            for (uint32_t n_chunk = 0;
+                          n_chunk < N_MAX_CHUNKS;
+                        ++n_chunk)
+            {
+                m_chunks[n_chunk].store(nullptr);
+            }
+
             for (uint32_t n_item = 0;
                           n_item < in_n_items_to_preallocate;
                         ++n_item)
             {
-                std::unique_ptr<PoolItemContainer<PoolItemType, PoolItemPtrType> > new_item_container_ptr(
-                    new PoolItemContainer<PoolItemType, PoolItemPtrType>(m_worker_ptr->create_item() )
-                );
-
-                m_available_pool_item_containers.push_back(
-                    std::move(new_item_container_ptr)
-                );
+                push_available_item(create_item_container() );
             }
         }
 
@@ -165,26 +173,20 @@ namespace Anvil
          **/
         virtual ~GenericPool()
         {
-            while (!m_active_pool_item_containers.empty())
+            for (uint32_t n_item = m_n_items;
+                          n_item > 0;
+                        --n_item)
             {
-                std::unique_ptr<Anvil::PoolItemContainer<PoolItemType, PoolItemPtrType> >& current_item_container = m_active_pool_item_containers.back();
-
                 m_worker_ptr->release_item(
-                    std::move(current_item_container->item)
+                    std::move(get_item_container(n_item - 1)->item)
                 );
-
-                m_active_pool_item_containers.pop_back();
             }
 
-            while (!m_available_pool_item_containers.empty())
+            for (uint32_t n_chunk = 0;
+                          n_chunk < N_MAX_CHUNKS;
+                        ++n_chunk)
             {
-                std::unique_ptr<Anvil::PoolItemContainer<PoolItemType, PoolItemPtrType> >& current_item_container = m_available_pool_item_containers.back();
-
-                m_worker_ptr->release_item(
-                    std::move(current_item_container->item)
-                );
-
-                m_available_pool_item_containers.pop_back();
+                delete [] m_chunks[n_chunk].load();
             }
 
             delete m_worker_ptr;
@@ -204,95 +206,183 @@ namespace Anvil
          *
          *  Callers must NOT release the retrieved instances.
          *
+         *  This function can be called from multiple threads at the same time. Available items are
+         *  popped from a lock-free list. A lock is only taken if a new item needs to be created.
+         *
          *  @return As per description. */
         PoolItemPtrType get_item()
         {
-            ReturnToPoolFunctor<PoolItemType, PoolItemPtrType> release_functor(this);
-            PoolItemPtrType                                    result;
+            uint32_t        n_item;
+            PoolItemPtrType result;
 
-            if (!m_available_pool_item_containers.empty())
+            if (!pop_available_item(&n_item) )
             {
-                result = PoolItemPtrType(m_available_pool_item_containers.back()->item.get(),
-                                         release_functor);
-
-                m_active_pool_item_containers.push_back(
-                    std::move(m_available_pool_item_containers.back() )
-                );
-
-                m_available_pool_item_containers.pop_back();
+                n_item = create_item_container();
             }
-            else
-            {
-                std::unique_ptr<PoolItemContainer<PoolItemType, PoolItemPtrType> > new_item_container(
-                    new PoolItemContainer<PoolItemType, PoolItemPtrType>(m_worker_ptr->create_item() )
-                );
-
-                m_active_pool_item_containers.push_back(
-                    std::move(new_item_container)
-                );
 
-                result = PoolItemPtrType(m_active_pool_item_containers.back()->item.get(),
-                                         release_functor);
-            }
+            result = PoolItemPtrType(get_item_container(n_item)->item.get(),
+                                     ReturnToPoolFunctor<PoolItemType, PoolItemPtrType>(this,
+                                                                                        n_item) );
 
             m_worker_ptr->reset_item(result);
 
             return result;
         }
 
-        /** Stores the provided instance back in the pool. */
-        void return_item(PoolItemType* in_item_ptr)
+        /** Stores the item at index @param in_n_item back in the pool.
+         *
+         *  This function can be called from multiple threads at the same time.
+         **/
+        void return_item(uint32_t in_n_item)
         {
-            std::unique_ptr<PoolItemContainer<PoolItemType, PoolItemPtrType> > container;
-            bool                                                               has_found = false;
+            anvil_assert(in_n_item < m_n_items);
 
-            ANVIL_REDUNDANT_VARIABLE(has_found);
+            push_available_item(in_n_item);
+        }
 
-            for (auto iterator  = m_active_pool_item_containers.begin();
-                      iterator != m_active_pool_item_containers.end();
-                    ++iterator)
-            {
-                if ((*iterator)->item.get() == in_item_ptr)
-                {
-                    container = std::move(*iterator);
-                    has_found = true;
+    protected:
+        /* Protected functions */
 
-                    m_active_pool_item_containers.erase(iterator);
+        /** Retrieves the underlying pool worker instance */
+        const IPoolWorker<PoolItemPtrType>* get_worker_ptr() const
+        {
+            return m_worker_ptr;
+        }
 
-                    break;
-                }
+    private:
+        /* Private type definitions */
+        typedef PoolItemContainer<PoolItemType, PoolItemPtrType> ItemContainer;
+
+        /* Chunk n_chunk holds (1 << n_chunk) item containers. Chunks are never reallocated, so containers keep
+         * their addresses, and can be looked up by index without taking a lock. */
+        static const uint32_t N_MAX_CHUNKS = 32;
+
+        /* Private functions */
+
+        /** Creates a new pool item and stores it in a new item container.
+         *
+         *  @return Index of the new item container.
+         **/
+        uint32_t create_item_container()
+        {
+            std::unique_lock<std::mutex> lock       (m_item_creation_mutex);
+            const uint32_t               n_new_item = m_n_items;
+            uint32_t                     n_chunk;
+            uint32_t                     n_item_in_chunk;
+
+            get_chunk_location(n_new_item,
+                              &n_chunk,
+                              &n_item_in_chunk);
+
+            if (n_item_in_chunk == 0)
+            {
+                m_chunks[n_chunk].store(new ItemContainer[static_cast<size_t>(1) << n_chunk],
+                                        std::memory_order_release);
             }
 
-            anvil_assert(has_found);
+            get_item_container(n_new_item)->item = m_worker_ptr->create_item();
 
-            m_available_pool_item_containers.push_back(
-                std::move(container)
-            );
+            m_n_items = n_new_item + 1;
+
+            return n_new_item;
         }
 
-    protected:
-        /* Protected type declarations */
-        typedef std::vector<std::unique_ptr<PoolItemContainer<PoolItemType, PoolItemPtrType> > > PoolItemContainers;
+        /** Determines which chunk holds the item container at index @param in_n_item. */
+        static void get_chunk_location(uint32_t  in_n_item,
+                                       uint32_t* out_n_chunk_ptr,
+                                       uint32_t* out_n_item_in_chunk_ptr)
+        {
+            const uint32_t n_item_plus_one = in_n_item + 1;
+            uint32_t       n_chunk         = 0;
 
-        /* Protected functions */
+            while (n_chunk + 1                          < N_MAX_CHUNKS &&
+                   (n_item_plus_one >> (n_chunk + 1)) != 0)
+            {
+                ++n_chunk;
+            }
 
-        /** Retrieves the underlying pool worker instance */
-        const IPoolWorker<PoolItemPtrType>* get_worker_ptr() const
+            *out_n_chunk_ptr         = n_chunk;
+            *out_n_item_in_chunk_ptr = n_item_plus_one - (1u << n_chunk);
+        }
+
+        /** Returns the item container at index @param in_n_item. */
+        ItemContainer* get_item_container(uint32_t in_n_item) const
         {
-            return m_worker_ptr;
+            uint32_t n_chunk;
+            uint32_t n_item_in_chunk;
+
+            get_chunk_location(in_n_item,
+                              &n_chunk,
+                              &n_item_in_chunk);
+
+            return m_chunks[n_chunk].load(std::memory_order_acquire) + n_item_in_chunk;
         }
 
-        /* Protected variables */
-        PoolItemContainers m_active_pool_item_containers;
-        PoolItemContainers m_available_pool_item_containers;
+        /** Pops an item off the list of available items.
+         *
+         *  The list head packs the index of the first available item (low 32 bits) with a counter which is bumped
+         *  on every update (high 32 bits), so that a stale head cannot be swapped in if the same item was popped
+         *  and pushed back in the meantime.
+         *
+         *  @return true if an item was popped, false if no items are available.
+         **/
+        bool pop_available_item(uint32_t* out_n_item_ptr)
+        {
+            uint64_t head = m_available_items_head.load(std::memory_order_acquire);
+
+            while (true)
+            {
+                const uint32_t n_item = static_cast<uint32_t>(head & UINT32_MAX);
+                uint64_t       new_head;
+
+                if (n_item == UINT32_MAX)
+                {
+                    return false;
+                }
+
+                new_head = (((head >> 32) + 1) << 32) | get_item_container(n_item)->n_next_available_item.load(std::memory_order_relaxed);
+
+                if (m_available_items_head.compare_exchange_weak(head,
+                                                                 new_head,
+                                                                 std::memory_order_acquire,
+                                                                 std::memory_order_acquire) )
+                {
+                    *out_n_item_ptr = n_item;
+
+                    return true;
+                }
+            }
+        }
+
+        /** Pushes the item at index @param in_n_item onto the list of available items. */
+        void push_available_item(uint32_t in_n_item)
+        {
+            ItemContainer* container_ptr = get_item_container(in_n_item);
+            uint64_t       head          = m_available_items_head.load(std::memory_order_relaxed);
+            uint64_t       new_head;
+
+            do
+            {
+                container_ptr->n_next_available_item.store(static_cast<uint32_t>(head & UINT32_MAX),
+                                                           std::memory_order_relaxed);
+
+                new_head = (((head >> 32) + 1) << 32) | in_n_item;
+            }
+            while (!m_available_items_head.compare_exchange_weak(head,
+                                                                 new_head,
+                                                                 std::memory_order_release,
+                                                                 std::memory_order_relaxed) );
+        }
 
-    private:
         /* Private variables */
+        std::atomic<uint64_t>         m_available_items_head;
         uint32_t                      m_capacity;
+        std::atomic<ItemContainer*>   m_chunks[N_MAX_CHUNKS];
+        std::mutex                    m_item_creation_mutex;
+        std::atomic<uint32_t>         m_n_items;
         IPoolWorker<PoolItemPtrType>* m_worker_ptr;
     };
 
-
     /** Implements IPoolWorker interface for primary command buffers. */
     template<class CommandBufferPtr>
     class CommandBufferPoolWorker : public IPoolWorker<CommandBufferPtr>
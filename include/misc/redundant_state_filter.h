@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Shadows the state of a command buffer which is set by bind and dynamic state commands, in order to detect
+ *  commands which would not change it. Implemented in order to:
+ *
+ *  - let CommandBufferBase drop redundant vkCmdBindPipeline(), vkCmdBindDescriptorSets(), vkCmdBindVertexBuffers(),
+ *    vkCmdSetViewport(), vkCmdSetScissor() and vkCmdPushConstants() calls, which are common in renderers that
+ *    re-bind the same state for every draw call.
+ *  - keep track of the number of dropped commands.
+ *
+ *  The filter compares raw Vulkan handles, so that objects which re-create their handles (eg. descriptor sets baked
+ *  after an update) are never mistaken for the state which is already bound. The tracking is conservative:
+ *
+ *  - changing the layout descriptor sets are bound with forgets all sets bound for the bind point.
+ *  - changing the layout push constants are updated with forgets all push constant values.
+ *  - binding a different graphics pipeline forgets all viewports and scissors, since these may be part of the
+ *    pipeline's static state.
+ *
+ *  Create with CommandBufferBase::set_redundant_state_filtering_enabled().
+ *
+ *  The filter is NOT thread-safe.
+ **/
+#ifndef MISC_REDUNDANT_STATE_FILTER_H
+#define MISC_REDUNDANT_STATE_FILTER_H
+
+#include "misc/types.h"
+
+namespace Anvil
+{
+    class RedundantStateFilter
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new filter instance, which assumes no state is known. */
+        static Anvil::RedundantStateFilterUniquePtr create();
+
+        /** Destructor */
+        ~RedundantStateFilter();
+
+        /** Each filter_*() function checks whether recording the described command would leave the state of the command
+         *  buffer intact. If it would not, the shadow state is updated to reflect the command.
+         *
+         *  Arguments have the same meaning as for the corresponding vkCmd*() functions.
+         *
+         *  @return true if the command is redundant and should be dropped, false if it needs to be recorded.
+         **/
+        bool filter_bind_descriptor_sets(Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                         VkPipelineLayout         in_layout,
+                                         uint32_t                 in_first_set,
+                                         uint32_t                 in_set_count,
+                                         const VkDescriptorSet*   in_descriptor_sets_ptr,
+                                         uint32_t                 in_dynamic_offset_count,
+                                         const uint32_t*          in_dynamic_offsets_ptr);
+        bool filter_bind_pipeline       (Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                         VkPipeline               in_pipeline);
+        bool filter_bind_vertex_buffers (uint32_t                 in_first_binding,
+                                         uint32_t                 in_binding_count,
+                                         const VkBuffer*          in_buffers_ptr,
+                                         const VkDeviceSize*      in_offsets_ptr);
+        bool filter_push_constants      (VkPipelineLayout         in_layout,
+                                         Anvil::ShaderStageFlags  in_stage_flags,
+                                         uint32_t                 in_offset,
+                                         uint32_t                 in_size,
+                                         const void*              in_values_ptr);
+        bool filter_set_scissor         (uint32_t                 in_first_scissor,
+                                         uint32_t                 in_scissor_count,
+                                         const VkRect2D*          in_scissors_ptr);
+        bool filter_set_viewport        (uint32_t                 in_first_viewport,
+                                         uint32_t                 in_viewport_count,
+                                         const VkViewport*        in_viewports_ptr);
+
+        /** Returns the number of commands the filter reported as redundant since creation or last reset() call. */
+        uint32_t get_n_elided_commands() const
+        {
+            return m_n_elided_commands;
+        }
+
+        /** Forgets all shadowed state. Should be called whenever the state of the command buffer becomes undefined,
+         *  eg. after vkCmdExecuteCommands().
+         **/
+        void invalidate();
+
+        /** Forgets all shadowed state and resets the elided command counter. Should be called whenever the command
+         *  buffer starts recording.
+         **/
+        void reset();
+
+    private:
+        /* Private type definitions */
+
+        /* Shader stages whose push constant values are shadowed: vertex, tessellation control, tessellation evaluation,
+         * geometry, fragment and compute.
+         */
+        enum
+        {
+            N_SHADOWED_SHADER_STAGES = 6,
+            N_SHADOWED_BIND_POINTS   = 2
+        };
+
+        typedef struct DescriptorSetBindings
+        {
+            std::vector<uint32_t>        dynamic_offsets;
+            uint32_t                     dynamic_offsets_first_set;
+            uint32_t                     dynamic_offsets_n_sets;
+            VkPipelineLayout             layout;
+            std::vector<VkDescriptorSet> sets;
+
+            DescriptorSetBindings()
+            {
+                reset();
+            }
+
+            void reset()
+            {
+                dynamic_offsets.clear();
+                sets.clear           ();
+
+                dynamic_offsets_first_set = 0;
+                dynamic_offsets_n_sets    = 0;
+                layout                    = VK_NULL_HANDLE;
+            }
+        } DescriptorSetBindings;
+
+        typedef struct VertexBufferBinding
+        {
+            VkBuffer     buffer;
+            VkDeviceSize offset;
+        } VertexBufferBinding;
+
+        /* Private functions */
+        RedundantStateFilter();
+
+        RedundantStateFilter           (const RedundantStateFilter&);
+        RedundantStateFilter& operator=(const RedundantStateFilter&);
+
+        /* Private variables */
+        DescriptorSetBindings m_descriptor_set_bindings[N_SHADOWED_BIND_POINTS];
+        VkPipeline            m_pipelines              [N_SHADOWED_BIND_POINTS];
+
+        VkPipelineLayout     m_push_constant_layout;
+        std::vector<uint8_t> m_push_constant_values     [N_SHADOWED_SHADER_STAGES];
+        std::vector<bool>    m_push_constant_values_set [N_SHADOWED_SHADER_STAGES];
+
+        std::vector<VkRect2D>            m_scissors;
+        std::vector<bool>                m_scissors_set;
+        std::vector<VertexBufferBinding> m_vertex_buffer_bindings;
+        std::vector<VkViewport>          m_viewports;
+        std::vector<bool>                m_viewports_set;
+
+        uint32_t m_n_elided_commands;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_REDUNDANT_STATE_FILTER_H */
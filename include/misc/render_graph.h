@@ -0,0 +1,529 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Describes a frame as a set of passes, each of which declares which buffers and images it reads from and
+ *  writes to, and takes care of everything apps otherwise need to hand-roll in order to execute the passes
+ *  efficiently:
+ *
+ *  - passes whose results are never consumed are culled.
+ *  - passes are ordered so that consecutive passes rendering to attachments of the same size can be merged into
+ *    subpasses of a single render pass. Load and store operations are derived from how attachments are used by
+ *    the other passes, so that contents which are never consumed are neither loaded nor stored.
+ *  - barriers between passes are generated by the ResourceStateTracker. Dependencies between merged passes are
+ *    expressed as by-region subpass dependencies.
+ *  - transient resources (owned by the graph) whose lifetimes do not overlap share memory.
+ *  - passes can be recorded in parallel into secondary command buffers.
+ *
+ *  Resources are either imported (created and owned by the app) or transient. Contents of imported resources
+ *  are always preserved between frames. Contents of transient resources are undefined at the beginning of
+ *  each frame, and are only preserved until the last pass which uses them, unless they are marked as outputs
+ *  with mark_resource_as_output().
+ *
+ *  Usage:
+ *
+ *  1. Declare resources with import_*() and add_transient_*().
+ *  2. Declare passes with add_pass(), and how they access resources with add_pass_*() functions. Passes
+ *     must be added in an order, in which they could be executed. Each resource can be used at most once
+ *     by a single pass.
+ *  3. Call bake(). The graph cannot be modified afterward. Graphics pipelines used by passes must be created
+ *     for render passes returned by get_pass_render_pass().
+ *  4. For each frame, call record() to record all passes into a primary command buffer. Images imported
+ *     from a swapchain can be replaced between frames with set_imported_image().
+ *
+ *  Passes are kept alive only if they write to an imported resource, to a resource marked as an output, or to
+ *  a resource read by another pass which is kept alive.
+ *
+ *  Passes must not record barriers, begin or end render passes, and must not declare resource usages with
+ *  CommandBufferBase::declare_*_usage().
+ *
+ *  Image views and framebuffers created for imported images are cached until the graph is released, so
+ *  imported resources must outlive the graph.
+ *
+ *  The graph is NOT thread-safe.
+ **/
+#ifndef MISC_RENDER_GRAPH_H
+#define MISC_RENDER_GRAPH_H
+
+#include "misc/types.h"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace Anvil
+{
+    class RenderGraph
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new, empty render graph.
+         *
+         *  @param in_device_ptr          Device to use. Must not be nullptr.
+         *  @param in_queue_family_index  Index of the queue family command buffers recorded by the graph are going
+         *                                to be submitted to.
+         *  @param in_n_frames_in_flight  Number of frames which may be executing GPU-side at the same time.
+         *                                Secondary command buffers recorded by a record() call are reused by
+         *                                the (in_n_frames_in_flight)-th next record() call, so the primary
+         *                                command buffer recorded by the former must have finished executing by
+         *                                then. Must be at least 1.
+         *  @param in_n_recording_threads Number of threads, including the calling thread, passes should be
+         *                                recorded on. If 1, passes are recorded directly into the primary command
+         *                                buffer. Otherwise, each pass is recorded into a separate secondary
+         *                                command buffer and record functions must be thread-safe. Values larger
+         *                                than 1 require @param in_device_ptr to have been created with MT safety
+         *                                enabled.
+         *
+         *  @return New graph instance if successful, nullptr otherwise.
+         **/
+        static Anvil::RenderGraphUniquePtr create(Anvil::BaseDevice* in_device_ptr,
+                                                  uint32_t           in_queue_family_index,
+                                                  uint32_t           in_n_frames_in_flight,
+                                                  uint32_t           in_n_recording_threads);
+
+        /** Destructor */
+        ~RenderGraph();
+
+        /** Adds a new pass to the graph.
+         *
+         *  @param in_name            Name of the pass. Used for debugging purposes only.
+         *  @param in_record_function Function which records commands of the pass. Must not be empty.
+         *  @param out_pass_id_ptr    Deref will be set to ID of the new pass. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool add_pass(const std::string&               in_name,
+                      Anvil::RenderGraphRecordFunction in_record_function,
+                      Anvil::RenderGraphPassID*        out_pass_id_ptr);
+
+        /** Declares that a pass accesses a buffer outside of any attachment.
+         *
+         *  @param in_pass_id     ID of the pass.
+         *  @param in_resource_id ID of a buffer resource.
+         *  @param in_stage_mask  Pipeline stages which access the buffer. Must not be 0.
+         *  @param in_access_mask Types of accesses which are performed. Write access types make the pass a producer
+         *                        of the buffer's contents.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool add_pass_buffer_access(Anvil::RenderGraphPassID     in_pass_id,
+                                    Anvil::RenderGraphResourceID in_resource_id,
+                                    Anvil::PipelineStageFlags    in_stage_mask,
+                                    Anvil::AccessFlags           in_access_mask);
+
+        /** Declares that a pass renders to a color attachment. Locations are assigned to color attachments in the
+         *  order they are added to the pass, starting from 0.
+         *
+         *  @param in_pass_id             ID of the pass.
+         *  @param in_resource_id         ID of an image resource with a color format.
+         *  @param in_opt_clear_value_ptr If not nullptr, the attachment is cleared to the specified value before
+         *                                the pass is executed. Otherwise, its contents are preserved.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool add_pass_color_attachment(Anvil::RenderGraphPassID     in_pass_id,
+                                       Anvil::RenderGraphResourceID in_resource_id,
+                                       const VkClearColorValue*     in_opt_clear_value_ptr = nullptr);
+
+        /** Declares that a pass uses a depth/stencil attachment. At most one depth/stencil attachment can be
+         *  added to a pass.
+         *
+         *  @param in_pass_id             ID of the pass.
+         *  @param in_resource_id         ID of an image resource with a depth and/or stencil format.
+         *  @param in_opt_clear_value_ptr If not nullptr, the attachment is cleared to the specified value before
+         *                                the pass is executed. Otherwise, its contents are preserved.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool add_pass_depth_stencil_attachment(Anvil::RenderGraphPassID        in_pass_id,
+                                               Anvil::RenderGraphResourceID    in_resource_id,
+                                               const VkClearDepthStencilValue* in_opt_clear_value_ptr = nullptr);
+
+        /** Declares that a pass accesses an image outside of any attachment. All subresources of the image are
+         *  considered to be accessed.
+         *
+         *  @param in_pass_id     ID of the pass.
+         *  @param in_resource_id ID of an image resource.
+         *  @param in_layout      Layout the image needs to be in.
+         *  @param in_stage_mask  Pipeline stages which access the image. Must not be 0.
+         *  @param in_access_mask Types of accesses which are performed. Write access types make the pass a producer
+         *                        of the image's contents.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool add_pass_image_access(Anvil::RenderGraphPassID     in_pass_id,
+                                   Anvil::RenderGraphResourceID in_resource_id,
+                                   Anvil::ImageLayout           in_layout,
+                                   Anvil::PipelineStageFlags    in_stage_mask,
+                                   Anvil::AccessFlags           in_access_mask);
+
+        /** Declares that a pass reads from an input attachment. Input attachment indices are assigned in the order
+         *  input attachments are added to the pass, starting from 0.
+         *
+         *  A pass which reads an input attachment rendered to by an earlier pass can be merged with that pass into
+         *  a single render pass.
+         *
+         *  @param in_pass_id     ID of the pass.
+         *  @param in_resource_id ID of an image resource.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool add_pass_input_attachment(Anvil::RenderGraphPassID     in_pass_id,
+                                       Anvil::RenderGraphResourceID in_resource_id);
+
+        /** Declares a new buffer owned by the graph.
+         *
+         *  @param in_size             Size of the buffer. Must not be 0.
+         *  @param in_usage            Usage flags the buffer needs to be created with.
+         *  @param out_resource_id_ptr Deref will be set to ID of the new resource. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool add_transient_buffer(VkDeviceSize                  in_size,
+                                  Anvil::BufferUsageFlags       in_usage,
+                                  Anvil::RenderGraphResourceID* out_resource_id_ptr);
+
+        /** Declares a new single-layer, single-mip 2D image owned by the graph.
+         *
+         *  @param in_format           Format of the image.
+         *  @param in_width            Width of the image.
+         *  @param in_height           Height of the image.
+         *  @param in_sample_count     Number of samples of the image.
+         *  @param in_usage            Usage flags the image needs to be created with, in addition to attachment
+         *                             usage flags, which are derived from how passes use the image.
+         *  @param out_resource_id_ptr Deref will be set to ID of the new resource. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool add_transient_image(Anvil::Format                 in_format,
+                                 uint32_t                      in_width,
+                                 uint32_t                      in_height,
+                                 Anvil::SampleCountFlagBits    in_sample_count,
+                                 Anvil::ImageUsageFlags        in_usage,
+                                 Anvil::RenderGraphResourceID* out_resource_id_ptr);
+
+        /** Culls passes, orders and merges the remaining ones into render passes, and allocates transient
+         *  resources. Must be called exactly once, before the first record() call.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool bake();
+
+        /** Returns a buffer resource, or nullptr if @param in_resource_id does not refer to a buffer. Transient
+         *  buffers are only available after bake() is called, and only if they are used by any of the passes
+         *  which have not been culled.
+         **/
+        Anvil::Buffer* get_buffer(Anvil::RenderGraphResourceID in_resource_id) const;
+
+        /** Returns an image resource, or nullptr if @param in_resource_id does not refer to an image. Transient
+         *  images are only available after bake() is called, and only if they are used by any of the passes
+         *  which have not been culled.
+         **/
+        Anvil::Image* get_image(Anvil::RenderGraphResourceID in_resource_id) const;
+
+        /** Returns a view of the base mip of the first layer of an image resource, eg. to bind an input attachment
+         *  to a descriptor set. Views are created at first call time.
+         *
+         *  @return Requested view, or nullptr if @param in_resource_id does not refer to an image which is available.
+         **/
+        Anvil::ImageView* get_image_view(Anvil::RenderGraphResourceID in_resource_id);
+
+        /** Returns the number of passes which have been culled at bake time. */
+        uint32_t get_n_culled_passes() const
+        {
+            return m_n_culled_passes;
+        }
+
+        /** Returns the number of render passes baked for the graph. Tells how many passes have been merged, when
+         *  compared with the number of passes which use attachments.
+         **/
+        uint32_t get_n_render_passes() const
+        {
+            return m_n_render_passes;
+        }
+
+        /** Returns the number of memory blocks backing transient resources. */
+        uint32_t get_n_transient_memory_blocks() const
+        {
+            return static_cast<uint32_t>(m_heaps.size() );
+        }
+
+        /** Tells which render pass and subpass a pass is going to be executed in. Graphics pipelines used by the
+         *  pass need to be created for these. Must only be called after bake().
+         *
+         *  @param in_pass_id              ID of the pass.
+         *  @param out_render_pass_ptr_ptr Deref will be set to the render pass. Must not be nullptr.
+         *  @param out_subpass_id_ptr      Deref will be set to the subpass ID. Must not be nullptr.
+         *
+         *  @return true if successful, false if the pass does not use any attachments, has been culled, or the
+         *          graph has not been baked yet.
+         **/
+        bool get_pass_render_pass(Anvil::RenderGraphPassID in_pass_id,
+                                  Anvil::RenderPass**      out_render_pass_ptr_ptr,
+                                  Anvil::SubPassID*        out_subpass_id_ptr) const;
+
+        /** Tells whether a pass has been culled at bake time. */
+        bool is_pass_culled(Anvil::RenderGraphPassID in_pass_id) const;
+
+        /** Declares a buffer owned by the app.
+         *
+         *  @param in_buffer_ptr       Buffer to import. Must not be nullptr.
+         *  @param out_resource_id_ptr Deref will be set to ID of the new resource. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool import_buffer(Anvil::Buffer*                in_buffer_ptr,
+                           Anvil::RenderGraphResourceID* out_resource_id_ptr);
+
+        /** Declares an image owned by the app. Attachments refer to the base mip of the first layer of the image.
+         *
+         *  @param in_image_ptr        Image to import. Must not be nullptr.
+         *  @param out_resource_id_ptr Deref will be set to ID of the new resource. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool import_image(Anvil::Image*                 in_image_ptr,
+                          Anvil::RenderGraphResourceID* out_resource_id_ptr);
+
+        /** Marks a transient resource as an output of the graph. Passes which produce its contents are not culled,
+         *  and its contents are preserved after the last pass which uses it.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool mark_resource_as_output(Anvil::RenderGraphResourceID in_resource_id);
+
+        /** Records all passes which have not been culled into a primary command buffer.
+         *
+         *  @param in_cmd_buffer_ptr Command buffer to record the passes into. Must be in the recording state,
+         *                           and must not have a render pass active.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool record(Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr);
+
+        /** Replaces an imported image, eg. to render to the next swapchain image. The new image must have the same
+         *  format, size and sample count as the image imported originally.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool set_imported_image(Anvil::RenderGraphResourceID in_resource_id,
+                                Anvil::Image*                in_image_ptr);
+
+    private:
+        /* Private type definitions */
+
+        enum class AccessType
+        {
+            BUFFER,
+            COLOR_ATTACHMENT,
+            DEPTH_STENCIL_ATTACHMENT,
+            IMAGE,
+            INPUT_ATTACHMENT,
+        };
+
+        /* Describes how a pass accesses a single resource. */
+        typedef struct Access
+        {
+            Anvil::AccessFlags           access_mask;
+            VkClearValue                 clear_value;
+            Anvil::ImageLayout           layout;
+            Anvil::RenderGraphResourceID resource_id;
+            bool                         should_clear;
+            Anvil::PipelineStageFlags    stage_mask;
+            AccessType                   type;
+
+            Access();
+
+            bool is_attachment() const
+            {
+                return (type != AccessType::BUFFER &&
+                        type != AccessType::IMAGE);
+            }
+        } Access;
+
+        /* Memory block shared by transient resources of a single kind (buffers or images). */
+        typedef struct Heap
+        {
+            bool                        is_image;
+            Anvil::MemoryBlockUniquePtr memory_block_ptr;
+            uint32_t                    memory_types;
+            VkDeviceSize                size;
+        } Heap;
+
+        typedef struct Pass
+        {
+            std::vector<Access>              accesses;
+            std::string                      name;
+            Anvil::RenderGraphRecordFunction record_function;
+
+            /* Bake-time properties */
+            VkExtent2D                 extent;
+            bool                       is_alive;
+            uint32_t                   n_step;
+            Anvil::SampleCountFlagBits sample_count;
+            Anvil::SubPassID           subpass_id;
+
+            Pass();
+
+            bool has_attachments() const
+            {
+                return (extent.width != 0);
+            }
+        } Pass;
+
+        typedef struct Resource
+        {
+            Anvil::Buffer*         buffer_ptr;
+            Anvil::Image*          image_ptr;
+            bool                   is_image;
+            bool                   is_imported;
+            bool                   is_output;
+            Anvil::BufferUniquePtr owned_buffer_ptr;
+            Anvil::ImageUniquePtr  owned_image_ptr;
+
+            /* Transient resource properties */
+            Anvil::BufferUsageFlags    buffer_usage;
+            Anvil::Format              format;
+            uint32_t                   height;
+            Anvil::ImageUsageFlags     image_usage;
+            Anvil::SampleCountFlagBits sample_count;
+            VkDeviceSize               size;
+            uint32_t                   width;
+
+            /* Bake-time properties. Lifetimes are expressed in steps. */
+            Anvil::AccessFlags        alias_src_access_mask;
+            Anvil::PipelineStageFlags alias_src_stage_mask;
+            Anvil::AccessFlags        all_access_mask;
+            Anvil::PipelineStageFlags all_stage_mask;
+            uint32_t                  first_step;
+            VkDeviceSize              heap_offset;
+            uint32_t                  last_step;
+            uint32_t                  n_heap;
+
+            /* Record-time properties */
+            bool is_used;
+
+            Resource();
+        } Resource;
+
+        /* A render pass, one subpass of which executes each pass in the step, or a single pass which does not
+         * use any attachments. */
+        typedef struct Step
+        {
+            std::vector<Anvil::RenderGraphResourceID> attachment_resource_ids;
+            std::vector<Anvil::AccessFlags>           attachment_access_masks;
+            std::vector<Anvil::ImageLayout>           attachment_layouts;
+            std::vector<Anvil::PipelineStageFlags>    attachment_stage_masks;
+            std::vector<VkClearValue>                 clear_values;
+            uint32_t                                  first_pass;
+            uint32_t                                  n_passes;
+            Anvil::RenderPassUniquePtr                render_pass_ptr;
+
+            std::map<std::vector<Anvil::ImageView*>, Anvil::FramebufferUniquePtr> framebuffers;
+        } Step;
+
+        /* Private functions */
+        RenderGraph(Anvil::BaseDevice* in_device_ptr,
+                    uint32_t           in_queue_family_index,
+                    uint32_t           in_n_frames_in_flight,
+                    uint32_t           in_n_recording_threads);
+
+        RenderGraph           (const RenderGraph&);
+        RenderGraph& operator=(const RenderGraph&);
+
+        bool add_pass_access          (Anvil::RenderGraphPassID in_pass_id,
+                                       const Access&            in_access);
+        bool allocate_transient_resources();
+        bool bake_render_pass         (uint32_t                 in_n_step);
+        bool can_merge                (const Step&              in_step,
+                                       uint32_t                 in_n_pass) const;
+        void cull_passes              ();
+        bool declare_usage            (Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr,
+                                       Anvil::RenderGraphResourceID in_resource_id,
+                                       bool                         in_is_attachment,
+                                       Anvil::ImageLayout           in_layout,
+                                       Anvil::PipelineStageFlags    in_stage_mask,
+                                       Anvil::AccessFlags           in_access_mask);
+        bool declare_step_usages      (Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr,
+                                       uint32_t                     in_n_step);
+        Anvil::Framebuffer* get_framebuffer(uint32_t            in_n_step);
+        bool order_passes             ();
+        void record_passes            (uint32_t                 in_n_thread);
+        void worker_thread_entrypoint (uint32_t                 in_n_thread);
+
+        static bool is_read (const Access& in_access);
+        static bool is_write(const Access& in_access);
+
+        /* Private variables */
+        Anvil::BaseDevice* m_device_ptr;
+        bool               m_is_baked;
+        uint32_t           m_n_culled_passes;
+        uint32_t           m_n_current_frame;
+        const uint32_t     m_n_frames_in_flight;
+        const uint32_t     m_n_recording_threads;
+        uint32_t           m_n_render_passes;
+        const uint32_t     m_queue_family_index;
+
+        std::vector<Heap>     m_heaps;
+        std::vector<Pass>     m_passes;
+        std::vector<Resource> m_resources;
+        std::vector<Step>     m_steps;
+
+        /* Indices of passes which have not been culled, in execution order. Steps refer to ranges of this array. */
+        std::vector<uint32_t> m_ordered_pass_indices;
+
+        std::unordered_map<Anvil::Image*, Anvil::ImageViewUniquePtr> m_image_views;
+        std::vector<Anvil::ImageView*>                              m_scratch_image_view_ptrs;
+
+        /* Tracks states of transient resources within a frame. Global states of transient resources are never
+         * used, since contents of transient resources do not outlive the frame. */
+        Anvil::ResourceStateTrackerUniquePtr m_transient_state_tracker_ptr;
+
+        /* Scratch storage used to record barriers for transient resources. Retained between calls. */
+        std::vector<Anvil::BufferBarrier> m_transient_buffer_barriers;
+        Anvil::PipelineStageFlags         m_transient_dst_stage_mask;
+        std::vector<Anvil::ImageBarrier>  m_transient_image_barriers;
+        Anvil::AccessFlags                m_transient_memory_dst_access_mask;
+        Anvil::AccessFlags                m_transient_memory_src_access_mask;
+        Anvil::PipelineStageFlags         m_transient_src_stage_mask;
+
+        /* Parallel recording. Command pools and secondary command buffers are indexed by
+         * (n_frame_in_flight * n_recording_threads + n_thread). */
+        std::vector<Anvil::CommandPoolUniquePtr>                         m_command_pools;
+        std::vector<std::vector<Anvil::SecondaryCommandBufferUniquePtr> > m_secondary_cmd_buffers;
+
+        std::vector<Anvil::SecondaryCommandBuffer*> m_pass_cmd_buffer_ptrs;
+        std::vector<Anvil::Framebuffer*>            m_step_framebuffer_ptrs;
+
+        std::condition_variable  m_jobs_cv;
+        std::mutex               m_jobs_mutex;
+        uint64_t                 m_jobs_generation;
+        std::atomic<uint32_t>    m_n_next_job;
+        uint32_t                 m_n_busy_workers;
+        std::vector<std::thread> m_worker_threads;
+        bool                     m_workers_should_quit;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_RENDER_GRAPH_H */
@@ -0,0 +1,297 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Tracks how buffers and image subresources are accessed by commands recorded into a command buffer, and
+ *  generates the minimal set of barriers needed to make these accesses safe. Implemented in order to:
+ *
+ *  - free apps from having to know which layout an image is in, and which accesses it has been subject to,
+ *    at the time a command buffer is recorded.
+ *  - avoid over-synchronisation (eg. ALL_COMMANDS -> ALL_COMMANDS barriers), as well as blocking layout
+ *    transition submissions.
+ *
+ *  Apps declare how a command is going to access a resource by calling one of the
+ *  CommandBufferBase::declare_*_usage() functions, before the command is recorded. The first time a resource
+ *  (or an image subresource) is used by a command buffer, the usage is recorded as a requirement, which the
+ *  resource must satisfy when the command buffer starts executing. Any subsequent usage is compared against the
+ *  state the resource is left in by the preceding commands, and a barrier is only recorded if:
+ *
+ *  - an image subresource needs to be transitioned to a different layout, or
+ *  - there is a write-after-write or write-after-read hazard, or
+ *  - the requested read access has not been made visible since the resource was last written to.
+ *
+ *  Consecutive reads using the same layout are folded into a single requirement.
+ *
+ *  At submission time, Queue resolves requirements against the global state of each resource, stored in the
+ *  Buffer and Image wrappers, and records any barriers needed into a prologue command buffer which is submitted
+ *  right before the command buffer. States the command buffers leave the resources in are collected in
+ *  a PendingStates container, and only become the new global states once the submission has been made.
+ *  Since command buffers are resolved in submission order, the same command buffer can be submitted many times,
+ *  even if the resources are in different states each time.
+ *
+ *  Known limitations:
+ *
+ *  - Accesses which have not been declared, as well as barriers recorded by apps, are not tracked.
+ *  - Queue family ownership transfers are not supported. All generated barriers use VK_QUEUE_FAMILY_IGNORED.
+ *  - Each image subresource (mip of an array layer) is tracked as a whole. Generated barriers always refer to
+ *    all aspects of an image.
+ *  - Requirements are only resolved for single-GPU, unprotected submissions.
+ *
+ *  Trackers are NOT thread-safe. Global resource states are only accessed with the device's resource state mutex
+ *  locked, if the device is MT-safe, so submissions made to different queues can resolve their requirements
+ *  concurrently. Please see BaseDevice::get_resource_state_mutex() for more details.
+ **/
+#ifndef MISC_RESOURCE_STATE_TRACKER_H
+#define MISC_RESOURCE_STATE_TRACKER_H
+
+#include "misc/types.h"
+#include <unordered_map>
+
+namespace Anvil
+{
+    class ResourceStateTracker
+    {
+    public:
+        /* Public type definitions */
+
+        /** Holds resource states produced by resolve() calls made for a single submission. Lets Queue update global
+         *  resource states only after the submission is known to have been made, and leave them intact if it fails.
+         *
+         *  Any access to the container must be synchronized with accesses to global resource states.
+         **/
+        class PendingStates
+        {
+        public:
+            /* Public functions */
+
+            /** Forgets all pending states. Global resource states are not affected. */
+            void clear();
+
+            /** Tells whether no resource states are pending. */
+            bool is_empty() const
+            {
+                return (m_buffer_states.size() == 0 &&
+                        m_image_states.size () == 0);
+            }
+
+            /** Stores all pending states as global states of the resources they refer to, and clears the container. */
+            void publish();
+
+            /** Overrides pending state of image subresources, as if they have been accessed by commands which are
+             *  not tracked.
+             *
+             *  @param in_image_ptr         Image to use. Must not be nullptr.
+             *  @param in_subresource_range Subresources to override the state of. Aspect mask is ignored.
+             *  @param in_state             New state of the subresources.
+             **/
+            void set_image_state(Anvil::Image*                       in_image_ptr,
+                                 const Anvil::ImageSubresourceRange& in_subresource_range,
+                                 const Anvil::ResourceAccessState&   in_state);
+
+        private:
+            /* Private functions */
+            Anvil::ResourceAccessState&              get_buffer_state(Anvil::Buffer* in_buffer_ptr);
+            std::vector<Anvil::ResourceAccessState>& get_image_states(Anvil::Image*  in_image_ptr);
+
+            /* Private variables */
+            std::unordered_map<Anvil::Buffer*, Anvil::ResourceAccessState>               m_buffer_states;
+            std::unordered_map<Anvil::Image*,  std::vector<Anvil::ResourceAccessState> > m_image_states;
+
+            friend class ResourceStateTracker;
+        };
+
+        /* Public functions */
+
+        /** Creates a new tracker, which does not track any resources. */
+        static Anvil::ResourceStateTrackerUniquePtr create();
+
+        /** Destructor */
+        ~ResourceStateTracker();
+
+        /** Appends resource usages recorded by another tracker, as if they happened after the usages recorded by
+         *  this tracker so far. Used to account for secondary command buffers executed by a primary command buffer.
+         *
+         *  Arguments have the same meaning as for use_buffer() and use_image().
+         **/
+        void append(const Anvil::ResourceStateTracker& in_tracker,
+                    Anvil::PipelineStageFlags*         inout_src_stage_mask_ptr,
+                    Anvil::PipelineStageFlags*         inout_dst_stage_mask_ptr,
+                    std::vector<Anvil::BufferBarrier>* out_buffer_barriers_ptr,
+                    std::vector<Anvil::ImageBarrier>*  out_image_barriers_ptr);
+
+        /** Tells whether no resource usage has been recorded since creation or last reset() call. */
+        bool is_empty() const
+        {
+            return (m_buffer_tracks.size() == 0 &&
+                    m_image_tracks.size () == 0);
+        }
+
+        /** Forgets all recorded resource usages. Global resource states are not affected. */
+        void reset();
+
+        /** Determines barriers needed to bring all tracked resources from their current state to the state
+         *  expected by the first commands which use them, and stores the state the resources are left in after all
+         *  recorded commands execute in @param inout_pending_states_ptr.
+         *
+         *  The current state of a resource is taken from @param inout_pending_states_ptr if it holds one, or from
+         *  the global state of the resource otherwise. Global resource states are never modified.
+         *
+         *  Must be called exactly once per submission of the command buffer the tracker belongs to, in submission
+         *  order. The pending states must be published once the submission is made.
+         *
+         *  @param inout_pending_states_ptr Pending resource states of the submission. Must not be nullptr.
+         *
+         *  Remaining arguments have the same meaning as for use_buffer() and use_image().
+         **/
+        void resolve(PendingStates*                     inout_pending_states_ptr,
+                     Anvil::PipelineStageFlags*         inout_src_stage_mask_ptr,
+                     Anvil::PipelineStageFlags*         inout_dst_stage_mask_ptr,
+                     std::vector<Anvil::BufferBarrier>* out_buffer_barriers_ptr,
+                     std::vector<Anvil::ImageBarrier>*  out_image_barriers_ptr);
+
+        /** Updates global state of image subresources whose layout has been changed outside of any tracked command
+         *  buffer. Must only be called after the layout change finishes executing.
+         *
+         *  Locks the device's resource state mutex for the duration of the call.
+         *
+         *  @param in_image_ptr         Image whose layout has been changed. Must not be nullptr.
+         *  @param in_subresource_range Subresources whose layout has been changed.
+         *  @param in_layout            New layout of the subresources.
+         **/
+        static void set_image_layout(Anvil::Image*                       in_image_ptr,
+                                     const Anvil::ImageSubresourceRange& in_subresource_range,
+                                     Anvil::ImageLayout                  in_layout);
+
+        /** Records a buffer usage.
+         *
+         *  @param in_buffer_ptr            Buffer to be accessed. Must not be nullptr.
+         *  @param in_stage_mask            Pipeline stages which are going to access the buffer.
+         *  @param in_access_mask           Types of accesses which are going to be performed.
+         *  @param inout_src_stage_mask_ptr Deref will be OR-ed with source stages of the generated barriers, if any.
+         *                                  Must not be nullptr.
+         *  @param inout_dst_stage_mask_ptr Deref will be OR-ed with destination stages of the generated barriers, if
+         *                                  any. Must not be nullptr.
+         *  @param out_buffer_barriers_ptr  Generated buffer barriers will be appended to this vector. Must not be
+         *                                  nullptr.
+         **/
+        void use_buffer(Anvil::Buffer*                     in_buffer_ptr,
+                        Anvil::PipelineStageFlags          in_stage_mask,
+                        Anvil::AccessFlags                 in_access_mask,
+                        Anvil::PipelineStageFlags*         inout_src_stage_mask_ptr,
+                        Anvil::PipelineStageFlags*         inout_dst_stage_mask_ptr,
+                        std::vector<Anvil::BufferBarrier>* out_buffer_barriers_ptr);
+
+        /** Records an image usage.
+         *
+         *  @param in_image_ptr             Image to be accessed. Must not be nullptr.
+         *  @param in_subresource_range     Subresources to be accessed. Aspect mask is ignored.
+         *  @param in_layout                Layout the subresources need to be in.
+         *  @param in_stage_mask            Pipeline stages which are going to access the subresources.
+         *  @param in_access_mask           Types of accesses which are going to be performed.
+         *  @param inout_src_stage_mask_ptr Deref will be OR-ed with source stages of the generated barriers, if any.
+         *                                  Must not be nullptr.
+         *  @param inout_dst_stage_mask_ptr Deref will be OR-ed with destination stages of the generated barriers, if
+         *                                  any. Must not be nullptr.
+         *  @param out_image_barriers_ptr   Generated image barriers will be appended to this vector. Must not be
+         *                                  nullptr.
+         **/
+        void use_image(Anvil::Image*                       in_image_ptr,
+                       const Anvil::ImageSubresourceRange& in_subresource_range,
+                       Anvil::ImageLayout                  in_layout,
+                       Anvil::PipelineStageFlags           in_stage_mask,
+                       Anvil::AccessFlags                  in_access_mask,
+                       Anvil::PipelineStageFlags*          inout_src_stage_mask_ptr,
+                       Anvil::PipelineStageFlags*          inout_dst_stage_mask_ptr,
+                       std::vector<Anvil::ImageBarrier>*   out_image_barriers_ptr);
+
+    private:
+        /* Private type definitions */
+
+        /* Describes how a buffer or a single image subresource is accessed by the recorded commands. */
+        typedef struct Track
+        {
+            /* Access the resource needs to be ready for when the command buffer starts executing. */
+            Anvil::AccessFlags        first_access_mask;
+            Anvil::ImageLayout        first_layout;
+            Anvil::PipelineStageFlags first_stage_mask;
+
+            /* Tells whether subsequent reads using the same layout can still be folded into the requirement. */
+            bool is_first_access_open;
+            bool is_used;
+
+            /* State the resource is left in by the recorded commands. */
+            Anvil::ResourceAccessState current_state;
+
+            Track()
+                :first_layout        (Anvil::ImageLayout::UNDEFINED),
+                 is_first_access_open(false),
+                 is_used             (false)
+            {
+                /* Stub */
+            }
+        } Track;
+
+        /* Describes a barrier for a block of image subresources. Initially covers a single subresource, until it
+         * is coalesced with its neighbours. */
+        typedef struct SubresourceBarrier
+        {
+            Anvil::AccessFlags dst_access_mask;
+            Anvil::ImageLayout new_layout;
+            Anvil::ImageLayout old_layout;
+            Anvil::AccessFlags src_access_mask;
+
+            uint32_t n_layer;
+            uint32_t n_layers;
+            uint32_t n_mip;
+            uint32_t n_mips;
+        } SubresourceBarrier;
+
+        /* Private functions */
+        ResourceStateTracker();
+
+        ResourceStateTracker           (const ResourceStateTracker&);
+        ResourceStateTracker& operator=(const ResourceStateTracker&);
+
+        void bake_image_barriers(Anvil::Image*                     in_image_ptr,
+                                 std::vector<Anvil::ImageBarrier>* out_image_barriers_ptr);
+        bool use                (Anvil::ImageLayout                in_layout,
+                                 Anvil::PipelineStageFlags         in_stage_mask,
+                                 Anvil::AccessFlags                in_access_mask,
+                                 Track*                            inout_track_ptr,
+                                 Anvil::PipelineStageFlags*        out_src_stage_mask_ptr,
+                                 Anvil::AccessFlags*               out_src_access_mask_ptr);
+
+        static std::vector<Anvil::ResourceAccessState>& get_image_states     (Anvil::Image*                       in_image_ptr);
+        static void                                     set_subresource_states(Anvil::Image*                       in_image_ptr,
+                                                                               const Anvil::ImageSubresourceRange& in_subresource_range,
+                                                                               const Anvil::ResourceAccessState&   in_state,
+                                                                               std::vector<ResourceAccessState>*   inout_states_ptr);
+
+        /* Private variables */
+        std::unordered_map<Anvil::Buffer*, Track>              m_buffer_tracks;
+        std::unordered_map<Anvil::Image*,  std::vector<Track> > m_image_tracks;
+
+        /* Scratch storage used to coalesce image barriers. Retained between calls. */
+        std::vector<SubresourceBarrier> m_subresource_barriers;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_RESOURCE_STATE_TRACKER_H */
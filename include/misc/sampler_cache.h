@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Device-wide sampler cache. Implemented in order to:
+ *
+ *  - re-use Sampler instances whenever a sampler with identical state is requested more than once.
+ *    Implementations are allowed to cap the number of live VkSampler handles (maxSamplerAllocationCount)
+ *    at a value as low as 4000, so it is a good idea to never create more samplers than necessary.
+ *  - gather hit/miss statistics.
+ *
+ *  Samplers returned by the cache are ref-counted. The underlying Vulkan sampler is released when
+ *  the last unique pointer referring to it goes out of scope.
+ *
+ *  The cache keeps a copy of the state of Y'CbCr conversions used by cached samplers, so conversion objects
+ *  may be released while samplers created with them are still alive.
+ *
+ *  This object should ONLY be instantiated by Anvil::BaseDevice.
+ *
+ *  Opt-in MT-safety available.
+ **/
+#ifndef MISC_SAMPLER_CACHE_H
+#define MISC_SAMPLER_CACHE_H
+
+#include "misc/mt_safety.h"
+#include "misc/sampler_ycbcr_conversion_create_info.h"
+#include "misc/types.h"
+#include <atomic>
+#include <unordered_map>
+
+namespace Anvil
+{
+    class SamplerCache : public MTSafetySupportProvider
+    {
+    public:
+        /* Public type definitions */
+
+        typedef struct Statistics
+        {
+            /* Number of get_sampler() calls which were served with an already existing sampler */
+            uint64_t n_hits;
+
+            /* Number of get_sampler() calls which required a new sampler to be created */
+            uint64_t n_misses;
+
+            /* Number of distinct samplers currently owned by the cache */
+            uint32_t n_live_samplers;
+
+            Statistics()
+                :n_hits         (0),
+                 n_misses       (0),
+                 n_live_samplers(0)
+            {
+                /* Stub */
+            }
+        } Statistics;
+
+        /* Public functions */
+
+        /** Destructor */
+        ~SamplerCache();
+
+        /** Returns a sampler whose state matches the specified create info struct. If no such sampler
+         *  has been created before (or all previously returned instances have since been released),
+         *  a new one will be spawned at call time.
+         *
+         *  All fields of @param in_create_info_ptr are taken into account, including the reduction mode and
+         *  the Y'CbCr conversion. MT safety setting of the create info is ignored - cached samplers always
+         *  inherit it from the cache.
+         *
+         *  @param in_create_info_ptr   Create info structure describing the sampler. Must not be nullptr.
+         *                              The cache does not take ownership of the structure.
+         *  @param out_sampler_ptr_ptr  Deref will be set to a shared sampler instance. Releasing the pointer
+         *                              drops the reference. Do NOT destroy the sampler in any other way.
+         *                              Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool get_sampler(const Anvil::SamplerCreateInfo* in_create_info_ptr,
+                         Anvil::SamplerUniquePtr*        out_sampler_ptr_ptr);
+
+        /** Returns hit/miss statistics gathered since the cache was created or reset_statistics() was last called. */
+        Statistics get_statistics() const;
+
+        /** Zeroes hit/miss counters. Does not affect the number of live samplers. */
+        void reset_statistics();
+
+    private:
+        /* Private type declarations */
+        typedef struct SamplerContainer
+        {
+            uint32_t         n_references;
+            SamplerUniquePtr sampler_ptr;
+
+            /* Copy of the state of the Y'CbCr conversion the sampler was created with, or nullptr if none was used.
+             *
+             * The conversion object itself may be released while the sampler is still alive, so cache lookups must
+             * never dereference the conversion pointer stored in the sampler's create info.
+             */
+            SamplerYCbCrConversionCreateInfoUniquePtr ycbcr_conversion_create_info_ptr;
+
+            SamplerContainer()
+                :n_references(1)
+            {
+                /* Stub */
+            }
+        } SamplerContainer;
+
+        typedef std::vector<std::unique_ptr<SamplerContainer> >  SamplerContainers;
+        typedef std::unordered_map<size_t, SamplerContainers>    SamplerContainersMap;
+
+        /* Private functions */
+        SamplerCache(const Anvil::BaseDevice* in_device_ptr,
+                     bool                     in_mt_safe);
+
+        SamplerCache           (const SamplerCache&);
+        SamplerCache& operator=(const SamplerCache&);
+
+        Anvil::SamplerCreateInfoUniquePtr                 clone_create_info                 (const Anvil::SamplerCreateInfo* in_create_info_ptr) const;
+        Anvil::SamplerYCbCrConversionCreateInfoUniquePtr clone_ycbcr_conversion_create_info(const Anvil::SamplerCreateInfo* in_create_info_ptr) const;
+        bool                                              is_match                          (const SamplerContainer*         in_container_ptr,
+                                                                                             const Anvil::SamplerCreateInfo* in_create_info_ptr) const;
+        void                                              on_sampler_dereferenced           (size_t                          in_hash,
+                                                                                             Anvil::Sampler*                 in_sampler_ptr);
+
+        static Anvil::SamplerCacheUniquePtr create  (const Anvil::BaseDevice*        in_device_ptr,
+                                                     bool                            in_mt_safe);
+        static size_t                       get_hash(const Anvil::SamplerCreateInfo* in_create_info_ptr);
+
+        /* Private members */
+        const Anvil::BaseDevice* m_device_ptr;
+        SamplerContainersMap     m_samplers;
+        uint32_t                 m_n_live_samplers;
+
+        std::atomic<uint64_t> m_n_hits;
+        std::atomic<uint64_t> m_n_misses;
+
+        friend class BaseDevice;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_SAMPLER_CACHE_H */
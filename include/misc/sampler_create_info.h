@@ -245,9 +245,19 @@ namespace Anvil
             return m_use_unnormalized_coordinates;
         }
 
+        /** Tells whether both structures describe the same sampler state.
+         *
+         *  Y'CbCr conversion objects are compared by their create info state, so that samplers using distinct
+         *  but identically defined conversions compare equal. MT safety setting is ignored, as it does not
+         *  affect the sampler state.
+         **/
+        bool operator==(const Anvil::SamplerCreateInfo& in_create_info) const;
+
     private:
         /* Private functions */
 
+        bool is_equal_ignoring_ycbcr_conversion(const Anvil::SamplerCreateInfo& in_create_info) const;
+
         SamplerCreateInfo(const Anvil::BaseDevice*    in_device_ptr,
                           Anvil::Filter               in_mag_filter,
                           Anvil::Filter               in_min_filter,
@@ -289,6 +299,8 @@ namespace Anvil
 
         ANVIL_DISABLE_ASSIGNMENT_OPERATOR(SamplerCreateInfo);
         ANVIL_DISABLE_COPY_CONSTRUCTOR(SamplerCreateInfo);
+
+        friend class SamplerCache;
     };
 }; /* namespace Anvil */
 
@@ -93,6 +93,12 @@ namespace Anvil
             return m_y_chroma_offset;
         }
 
+        /** Tells whether both structures describe the same conversion state.
+         *
+         *  MT safety setting is ignored, as it does not affect the conversion state.
+         **/
+        bool operator==(const Anvil::SamplerYCbCrConversionCreateInfo& in_create_info) const;
+
         void set_chroma_filter(const Anvil::Filter& in_chroma_filter)
         {
             m_chroma_filter = in_chroma_filter;
@@ -36,7 +36,9 @@ namespace Anvil
          * NOTE: Unless specified later with a corresponding set_..() invocation, the following parameters are assumed by default:
          *
          * - Exportable external semaphore handle type: none
+         * - Initial value:                             0
          * - MT safety:                                 Anvil::MTSafety::INHERIT_FROM_PARENT_DEVICE
+         * - Semaphore type:                            Anvil::SemaphoreType::BINARY_KHR
          */
         static Anvil::SemaphoreCreateInfoUniquePtr create(const Anvil::BaseDevice* in_device_ptr);
 
@@ -70,11 +72,21 @@ namespace Anvil
             }
         #endif
 
+        const uint64_t& get_initial_value() const
+        {
+            return m_initial_value;
+        }
+
         const MTSafety& get_mt_safety() const
         {
             return m_mt_safety;
         }
 
+        const Anvil::SemaphoreType& get_semaphore_type() const
+        {
+            return m_semaphore_type;
+        }
+
         void set_device(const Anvil::BaseDevice* in_device_ptr)
         {
             m_device_ptr = in_device_ptr;
@@ -123,11 +135,29 @@ namespace Anvil
             }
         #endif
 
+        /* Specifies the payload a timeline semaphore should be initialized with.
+         *
+         * Ignored for binary semaphores.
+         */
+        void set_initial_value(const uint64_t& in_initial_value)
+        {
+            m_initial_value = in_initial_value;
+        }
+
         void set_mt_safety(const MTSafety& in_mt_safety)
         {
             m_mt_safety = in_mt_safety;
         }
 
+        /* Specifies the type of the semaphore to create.
+         *
+         * Anvil::SemaphoreType::TIMELINE_KHR requires VK_KHR_timeline_semaphore with the timelineSemaphore feature enabled.
+         */
+        void set_semaphore_type(const Anvil::SemaphoreType& in_semaphore_type)
+        {
+            m_semaphore_type = in_semaphore_type;
+        }
+
     private:
         /* Private functions */
         SemaphoreCreateInfo(const Anvil::BaseDevice* in_device_ptr,
@@ -136,7 +166,9 @@ namespace Anvil
         /* Private variables */
         const Anvil::BaseDevice*                m_device_ptr;
         Anvil::ExternalSemaphoreHandleTypeFlags m_exportable_external_semaphore_handle_types;
+        uint64_t                                m_initial_value;
         Anvil::MTSafety                         m_mt_safety;
+        Anvil::SemaphoreType                    m_semaphore_type;
 
         #ifdef _WIN32
             ExternalNTHandleInfo m_exportable_nt_handle_info;
@@ -0,0 +1,407 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Streams memory in and out of sparse buffers and sparse images at page granularity, so that only the parts
+ *  of large resources which are actually needed (eg. by virtual texturing) consume device memory.
+ *
+ *  - Apps request pages either directly with request_page(), or by handing over a page bitmask produced by
+ *    GPU feedback passes with request_pages_from_feedback().
+ *  - Physical pages are sub-allocated from memory blocks of fixed size, which are allocated lazily until the
+ *    page budget specified at creation time is reached.
+ *  - When the budget has been exhausted, the least recently requested pages are evicted. Pages requested within
+ *    the last n frames in flight are never evicted. Requests which cannot be satisfied are dropped, and should
+ *    be re-issued in later frames.
+ *  - All bind and unbind operations scheduled within a frame are coalesced into a single bind info, submitted
+ *    with a single vkQueueBindSparse() call by flush().
+ *
+ *  Mip tails of sparse images cannot be paged. They are backed by a dedicated memory block at registration time
+ *  and stay resident until the image is unregistered. Only color aspect of single-plane sparse images is
+ *  supported.
+ *
+ *  Newly resident pages have undefined contents. Apps should upload their data after flush() returns, using
+ *  the regions reported by get_buffer_page_region() and get_image_page_region() for pages returned by
+ *  get_last_flush_bound_pages().
+ *
+ *  Usage, for each frame:
+ *
+ *  1. Request pages the frame needs.
+ *  2. Call flush() before submitting work which accesses the requested pages.
+ *  3. Upload contents of newly bound pages.
+ *
+ *  Memory blocks backing physical pages are released together with the manager, so the manager must outlive
+ *  all resources registered with it.
+ *
+ *  The manager is NOT thread-safe.
+ **/
+#ifndef MISC_SPARSE_RESIDENCY_MANAGER_H
+#define MISC_SPARSE_RESIDENCY_MANAGER_H
+
+#include "misc/types.h"
+#include <memory>
+#include <vector>
+
+namespace Anvil
+{
+    class SparseResidencyManager
+    {
+    public:
+        /* Public type definitions */
+
+        /* Refers to a single page of a registered resource. */
+        typedef struct Page
+        {
+            Anvil::SparseResourceID resource_id;
+            uint32_t                n_page;
+
+            Page(Anvil::SparseResourceID in_resource_id,
+                 uint32_t                in_n_page)
+                :resource_id(in_resource_id),
+                 n_page     (in_n_page)
+            {
+                /* Stub */
+            }
+        } Page;
+
+        /* Public functions */
+
+        /** Creates a new sparse residency manager instance.
+         *
+         *  @param in_device_ptr               Device to use. Must not be nullptr.
+         *  @param in_page_size                Size of a single page. Must be equal to the sparse block size of
+         *                                     all images, and a multiple of the sparse block size of all buffers,
+         *                                     which are going to be registered.
+         *  @param in_n_pages_per_memory_block Number of pages each memory block backing physical pages should
+         *                                     hold. Must be at least 1.
+         *  @param in_max_n_resident_pages     Maximum number of pages which can be resident at the same time.
+         *                                     Must be at least 1. Does not include mip tails.
+         *  @param in_n_frames_in_flight       Number of frames the GPU may be working on at any time. Pages
+         *                                     requested within this many most recent frames are never evicted.
+         *                                     Must be at least 1.
+         *  @param in_memory_features          Memory features memory blocks must support.
+         *
+         *  @return New manager instance if successful, nullptr otherwise.
+         **/
+        static Anvil::SparseResidencyManagerUniquePtr create(Anvil::BaseDevice*        in_device_ptr,
+                                                             VkDeviceSize              in_page_size,
+                                                             uint32_t                  in_n_pages_per_memory_block,
+                                                             uint32_t                  in_max_n_resident_pages,
+                                                             uint32_t                  in_n_frames_in_flight,
+                                                             Anvil::MemoryFeatureFlags in_memory_features = Anvil::MemoryFeatureFlagBits::DEVICE_LOCAL_BIT);
+
+        /** Destructor */
+        ~SparseResidencyManager();
+
+        /** Updates bindings of all registered resources, so that pages requested since the last flush() call are
+         *  resident, and advances the frame counter.
+         *
+         *  Emits a single vkQueueBindSparse() call with a single bind info. The call is skipped if no bindings
+         *  need to be updated and no semaphores or fence have been specified.
+         *
+         *  @param in_queue_ptr                 Queue to use. Must support sparse binding operations.
+         *  @param in_n_wait_semaphores         Number of semaphores to wait on before bindings are updated.
+         *  @param in_opt_wait_semaphore_ptrs   Semaphores to wait on. Should include a semaphore signaled after
+         *                                      GPU work of the oldest frame in flight completes. May be nullptr
+         *                                      if @param in_n_wait_semaphores is 0.
+         *  @param in_n_signal_semaphores       Number of semaphores to signal after bindings are updated.
+         *  @param in_opt_signal_semaphore_ptrs Semaphores to signal. May be nullptr if
+         *                                      @param in_n_signal_semaphores is 0.
+         *  @param in_opt_fence_ptr             Fence to signal after bindings are updated. May be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool flush(Anvil::Queue*            in_queue_ptr,
+                   uint32_t                 in_n_wait_semaphores         = 0,
+                   Anvil::Semaphore* const* in_opt_wait_semaphore_ptrs   = nullptr,
+                   uint32_t                 in_n_signal_semaphores       = 0,
+                   Anvil::Semaphore* const* in_opt_signal_semaphore_ptrs = nullptr,
+                   Anvil::Fence*            in_opt_fence_ptr             = nullptr);
+
+        /** Retrieves the region of a registered buffer, which a page corresponds to.
+         *
+         *  @param in_resource_id ID of a registered buffer.
+         *  @param in_n_page      Index of the page. Must be smaller than value reported by get_n_pages().
+         *  @param out_offset_ptr Deref will be set to the start offset of the region. Must not be nullptr.
+         *  @param out_size_ptr   Deref will be set to the size of the region. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool get_buffer_page_region(Anvil::SparseResourceID in_resource_id,
+                                    uint32_t                in_n_page,
+                                    VkDeviceSize*           out_offset_ptr,
+                                    VkDeviceSize*           out_size_ptr) const;
+
+        /** Retrieves index of the page holding a texel of a registered image.
+         *
+         *  @param in_resource_id ID of a registered image.
+         *  @param in_n_mip       Mip level. Must be smaller than mip_tail_first_lod of the image. Texels of mips
+         *                        forming the mip tail are always resident.
+         *  @param in_n_layer     Array layer.
+         *  @param in_x           X coordinate of the texel.
+         *  @param in_y           Y coordinate of the texel.
+         *  @param in_z           Z coordinate of the texel.
+         *  @param out_n_page_ptr Deref will be set to the index of the page. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool get_image_page_index(Anvil::SparseResourceID in_resource_id,
+                                  uint32_t                in_n_mip,
+                                  uint32_t                in_n_layer,
+                                  uint32_t                in_x,
+                                  uint32_t                in_y,
+                                  uint32_t                in_z,
+                                  uint32_t*               out_n_page_ptr) const;
+
+        /** Retrieves the region of a registered image, which a page corresponds to.
+         *
+         *  @param in_resource_id      ID of a registered image.
+         *  @param in_n_page           Index of the page. Must be smaller than value reported by get_n_pages().
+         *  @param out_subresource_ptr Deref will be set to the subresource the page belongs to. Must not be
+         *                             nullptr.
+         *  @param out_offset_ptr      Deref will be set to the offset of the region, in texels. Must not be
+         *                             nullptr.
+         *  @param out_extent_ptr      Deref will be set to the extent of the region, in texels. Regions of
+         *                             pages at subresource edges are clamped to the subresource. Must not be
+         *                             nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool get_image_page_region(Anvil::SparseResourceID  in_resource_id,
+                                   uint32_t                 in_n_page,
+                                   Anvil::ImageSubresource* out_subresource_ptr,
+                                   VkOffset3D*              out_offset_ptr,
+                                   VkExtent3D*              out_extent_ptr) const;
+
+        /** Returns pages which have been made resident by the last flush() call. Their contents are undefined. */
+        const std::vector<Page>& get_last_flush_bound_pages() const
+        {
+            return m_last_flush_bound_pages;
+        }
+
+        /** Returns the number of requests which the last flush() call could not satisfy, because all resident
+         *  pages were in use by frames in flight.
+         **/
+        uint32_t get_last_flush_n_dropped_requests() const
+        {
+            return m_last_flush_n_dropped_requests;
+        }
+
+        /** Returns the number of pages evicted by the last flush() call. */
+        uint32_t get_last_flush_n_evicted_pages() const
+        {
+            return m_last_flush_n_evicted_pages;
+        }
+
+        /** Returns the number of memory blocks allocated to back physical pages. */
+        uint32_t get_n_memory_blocks() const
+        {
+            return static_cast<uint32_t>(m_memory_blocks.size() );
+        }
+
+        /** Returns the number of pages of a registered resource, or 0 if the ID does not refer to a registered
+         *  resource.
+         **/
+        uint32_t get_n_pages(Anvil::SparseResourceID in_resource_id) const;
+
+        /** Returns the number of pages which are currently resident, excluding mip tails. */
+        uint32_t get_n_resident_pages() const
+        {
+            return m_n_resident_pages;
+        }
+
+        /** Tells whether a page of a registered resource is resident. */
+        bool is_page_resident(Anvil::SparseResourceID in_resource_id,
+                              uint32_t                in_n_page) const;
+
+        /** Registers a buffer, whose pages should be managed by the manager.
+         *
+         *  The buffer must have been created with SPARSE_BINDING_BIT and SPARSE_RESIDENCY_BIT flags, and must
+         *  not have any memory bound. It must stay alive until it is unregistered.
+         *
+         *  @param in_buffer_ptr       Buffer to register. Must not be nullptr.
+         *  @param out_resource_id_ptr Deref will be set to ID of the buffer. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool register_buffer(Anvil::Buffer*           in_buffer_ptr,
+                             Anvil::SparseResourceID* out_resource_id_ptr);
+
+        /** Registers an image, whose pages should be managed by the manager.
+         *
+         *  The image must have been created with SPARSE_BINDING_BIT and SPARSE_RESIDENCY_BIT flags, must use a
+         *  single-plane color format, and must not have any memory bound. It must stay alive until it is
+         *  unregistered. Mip tails are bound by the next flush() call.
+         *
+         *  Pages are indexed in layer, mip, z, y, x order, starting from the most significant one.
+         *
+         *  @param in_image_ptr        Image to register. Must not be nullptr.
+         *  @param out_resource_id_ptr Deref will be set to ID of the image. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool register_image(Anvil::Image*            in_image_ptr,
+                            Anvil::SparseResourceID* out_resource_id_ptr);
+
+        /** Marks a page of a registered resource as used in the current frame. If the page is not resident, it is
+         *  going to be made resident by the next flush() call, budget permitting.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool request_page(Anvil::SparseResourceID in_resource_id,
+                          uint32_t                in_n_page);
+
+        /** Requests all pages of a registered resource whose bits are set in a bitmask, eg. read back from
+         *  a buffer written by a feedback pass. Bit n of word w corresponds to page (32 * w + n).
+         *
+         *  @param in_resource_id ID of a registered resource.
+         *  @param in_bitmask_ptr Bitmask to use. Must not be nullptr.
+         *  @param in_n_words     Number of 32-bit words in the bitmask. Bits beyond the last page are ignored.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool request_pages_from_feedback(Anvil::SparseResourceID in_resource_id,
+                                         const uint32_t*         in_bitmask_ptr,
+                                         uint32_t                in_n_words);
+
+        /** Unregisters a resource and releases all physical pages assigned to it.
+         *
+         *  Bindings of the resource are NOT updated, so the resource must not be accessed by the GPU
+         *  afterward. Should be called right before the resource is released.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool unregister_resource(Anvil::SparseResourceID in_resource_id);
+
+    private:
+        /* Private type definitions */
+
+        /* Describes a physical page. Pages assigned to resources are linked into a list, sorted from the least
+         * to the most recently used one.
+         */
+        typedef struct PhysicalPage
+        {
+            uint64_t                last_used_frame;
+            Anvil::MemoryBlock*     memory_block_ptr;
+            VkDeviceSize            memory_block_start_offset;
+            uint32_t                n_lru_next;
+            uint32_t                n_lru_prev;
+            uint32_t                n_virtual_page;
+            Anvil::SparseResourceID resource_id;
+
+            PhysicalPage(Anvil::MemoryBlock* in_memory_block_ptr,
+                         VkDeviceSize        in_memory_block_start_offset);
+        } PhysicalPage;
+
+        /* Describes tiles of a single mip level of a sparse image. */
+        typedef struct MipInfo
+        {
+            VkExtent3D extent;
+            VkExtent3D n_tiles;
+            uint32_t   n_first_page;
+        } MipInfo;
+
+        typedef struct Resource
+        {
+            Anvil::Buffer* buffer_ptr;
+            Anvil::Image*  image_ptr;
+
+            /* Index of the physical page assigned to each virtual page. UINT32_MAX for pages which are not
+             * resident, UINT32_MAX - 1 for pages which have been requested, but are not bound yet. */
+            std::vector<uint32_t> physical_pages;
+
+            /* Buffers only */
+            VkDeviceSize size;
+
+            /* Images only */
+            VkExtent3D           granularity;
+            std::vector<MipInfo> mips;
+            uint32_t             n_pages_per_layer;
+
+            VkDeviceSize                mip_tail_offset;
+            VkDeviceSize                mip_tail_size;
+            VkDeviceSize                mip_tail_stride;
+            Anvil::MemoryBlockUniquePtr mip_tail_memory_block_ptr; /* Released when mip tails are bound */
+            uint32_t                    n_mip_tails;
+
+            Resource();
+        } Resource;
+
+        /* Private functions */
+        SparseResidencyManager(Anvil::BaseDevice*        in_device_ptr,
+                               VkDeviceSize              in_page_size,
+                               uint32_t                  in_n_pages_per_memory_block,
+                               uint32_t                  in_max_n_resident_pages,
+                               uint32_t                  in_n_frames_in_flight,
+                               Anvil::MemoryFeatureFlags in_memory_features);
+
+        SparseResidencyManager           (const SparseResidencyManager&);
+        SparseResidencyManager& operator=(const SparseResidencyManager&);
+
+        bool      acquire_physical_page      (Anvil::SparseMemoryBindingUpdateInfo* in_update_ptr,
+                                              Anvil::SparseMemoryBindInfoID         in_bind_info_id,
+                                              uint32_t*                             out_n_physical_page_ptr);
+        void      append_page_update         (Anvil::SparseMemoryBindingUpdateInfo* in_update_ptr,
+                                              Anvil::SparseMemoryBindInfoID         in_bind_info_id,
+                                              const Resource&                       in_resource,
+                                              uint32_t                              in_n_virtual_page,
+                                              Anvil::MemoryBlock*                   in_opt_memory_block_ptr,
+                                              VkDeviceSize                          in_memory_block_start_offset) const;
+        bool      are_memory_types_compatible(uint32_t                              in_memory_types) const;
+        Resource* get_resource               (Anvil::SparseResourceID               in_resource_id) const;
+        void      lru_append                 (uint32_t                              in_n_physical_page);
+        void      lru_remove                 (uint32_t                              in_n_physical_page);
+        bool      register_resource          (std::unique_ptr<Resource>             in_resource_ptr,
+                                              uint32_t                              in_memory_types,
+                                              Anvil::SparseResourceID*              out_resource_id_ptr);
+
+        static void get_image_page_region(const Resource&          in_resource,
+                                          uint32_t                 in_n_page,
+                                          Anvil::ImageSubresource* out_subresource_ptr,
+                                          VkOffset3D*              out_offset_ptr,
+                                          VkExtent3D*              out_extent_ptr);
+
+        /* Private variables */
+        Anvil::BaseDevice*        m_device_ptr;
+        uint32_t                  m_max_n_resident_pages;
+        Anvil::MemoryFeatureFlags m_memory_features;
+        uint32_t                  m_memory_types;
+        uint32_t                  m_n_frames_in_flight;
+        uint32_t                  m_n_pages_per_memory_block;
+        VkDeviceSize              m_page_size;
+
+        uint64_t m_n_current_frame;
+        uint32_t m_n_lru_head;
+        uint32_t m_n_lru_tail;
+        uint32_t m_n_resident_pages;
+
+        std::vector<uint32_t>                    m_free_physical_pages;
+        std::vector<Anvil::MemoryBlockUniquePtr> m_memory_blocks;
+        std::vector<Page>                        m_pending_pages;
+        std::vector<PhysicalPage>                m_physical_pages;
+        std::vector<std::unique_ptr<Resource> >  m_resources;
+
+        std::vector<Page> m_last_flush_bound_pages;
+        uint32_t          m_last_flush_n_dropped_requests;
+        uint32_t          m_last_flush_n_evicted_pages;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_SPARSE_RESIDENCY_MANAGER_H */
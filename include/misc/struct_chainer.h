@@ -24,6 +24,7 @@
 #define MISC_STRUCT_CHAINER_H
 
 #include "types.h"
+#include <algorithm>
 
 namespace Anvil
 {
@@ -94,14 +95,110 @@ namespace Anvil
         std::vector<StructChainUniquePtr<StructType> > struct_chain_ptrs;
     };
 
+    /* Vector of POD items, which keeps up to InlineCapacity items in-place and only falls back to the heap
+     * when that capacity is exceeded. Once spilled, the items stay on the heap until the vector is destroyed.
+     *
+     * Used by StructChainer to avoid heap allocations for the common case, where only a handful of
+     * small structures are chained together.
+     */
+    template<typename ItemType, uint32_t InlineCapacity>
+    class InlinePODVector
+    {
+    public:
+        InlinePODVector()
+            :m_n_items(0)
+        {
+            /* Stub */
+        }
+
+        void clear()
+        {
+            m_n_items = 0;
+        }
+
+        ItemType* data()
+        {
+            return (m_heap_items.size() == 0) ? m_inline_items : &m_heap_items.at(0);
+        }
+
+        const ItemType* data() const
+        {
+            return (m_heap_items.size() == 0) ? m_inline_items : &m_heap_items.at(0);
+        }
+
+        uint32_t size() const
+        {
+            return m_n_items;
+        }
+
+        ItemType& operator[](const uint32_t& in_n_item)
+        {
+            anvil_assert(in_n_item < m_n_items);
+
+            return data()[in_n_item];
+        }
+
+        const ItemType& operator[](const uint32_t& in_n_item) const
+        {
+            anvil_assert(in_n_item < m_n_items);
+
+            return data()[in_n_item];
+        }
+
+        void push_back(const ItemType& in_item)
+        {
+            resize(m_n_items + 1);
+
+            data()[m_n_items - 1] = in_item;
+        }
+
+        /* NOTE: Newly added items are NOT initialized. */
+        void resize(const uint32_t& in_n_items)
+        {
+            if (m_heap_items.size() != 0)
+            {
+                if (m_heap_items.size() < in_n_items)
+                {
+                    m_heap_items.resize(std::max(in_n_items,
+                                                 static_cast<uint32_t>(m_heap_items.size() ) * 2) );
+                }
+            }
+            else
+            if (in_n_items > InlineCapacity)
+            {
+                m_heap_items.resize(std::max(in_n_items,
+                                             InlineCapacity * 2) );
+
+                memcpy(&m_heap_items.at(0),
+                       m_inline_items,
+                       sizeof(ItemType) * m_n_items);
+            }
+
+            m_n_items = in_n_items;
+        }
+
+    private:
+        std::vector<ItemType> m_heap_items;
+        ItemType              m_inline_items[InlineCapacity];
+        uint32_t              m_n_items;
+    };
+
+    /* Builds a chain of Vulkan structures.
+     *
+     * Struct and helper structure data is stored in inline buffers, so that no heap allocations are
+     * required for chains which fit within the inline capacity. Chains can be consumed in two ways:
+     *
+     * - bake_chain() patches pNext and helper structure pointers in the storage owned by the chainer and
+     *   returns the root struct. This is the allocation-free path, meant for the common case where the chain
+     *   is only needed for the duration of a single Vulkan call.
+     * - create_chain() copies the chain to a new StructChain instance, which can outlive the chainer.
+     */
     template<typename StructType>
     class StructChainer
     {
     public:
         /* Public functions */
          StructChainer()
-             :m_helper_structs_size(0),
-              m_structs_size       (0)
          {
              /* Stub */
          }
@@ -114,27 +211,24 @@ namespace Anvil
         template<typename ChainedStructType>
         StructID append_struct(const ChainedStructType& in_struct)
         {
-            const uint32_t       pre_call_structs_size(m_structs_size);
-            std::vector<uint8_t> struct_raw_data      (sizeof(in_struct) );
+            const uint32_t pre_call_structs_size(get_structs_size() );
 
             anvil_assert(in_struct.pNext == nullptr);
 
             /* Zeroth item appended to the chain must be of StructType type! */
-            if (m_structs_size    == 0                  &&
-                sizeof(in_struct) != sizeof(StructType) )
+            if (pre_call_structs_size == 0                  &&
+                sizeof(in_struct)     != sizeof(StructType) )
             {
                 anvil_assert_fail();
             }
 
-            memcpy(struct_raw_data.data(),
-                   &in_struct,
-                   sizeof(in_struct) );
+            m_struct_offsets.push_back(pre_call_structs_size);
 
-            m_structs.push_back(
-                std::move(struct_raw_data)
-            );
+            m_structs.resize(m_structs.size() + get_n_storage_items(sizeof(in_struct) ) );
 
-            m_structs_size += sizeof(in_struct);
+            memcpy(reinterpret_cast<uint8_t*>(m_structs.data() ) + pre_call_structs_size,
+                   &in_struct,
+                   sizeof(in_struct) );
 
             return pre_call_structs_size;
         }
@@ -144,17 +238,10 @@ namespace Anvil
                                     const StructID&         in_referring_struct,
                                     const uint32_t&         in_referring_struct_pnext_ptr_offset)
         {
-            anvil_assert(m_structs.size() >  in_referring_struct);
-            anvil_assert(m_structs.size() >= in_referring_struct + in_referring_struct_pnext_ptr_offset + sizeof(void*) );
-
-            m_helper_structs.push_back(
-                HelperStruct(&in_helper_struct,
-                             sizeof(in_helper_struct),
-                             in_referring_struct,
-                            in_referring_struct_pnext_ptr_offset)
-            );
-
-            m_helper_structs_size += static_cast<uint32_t>(sizeof(in_helper_struct) );
+            store_helper_data(&in_helper_struct,
+                              sizeof(in_helper_struct),
+                              in_referring_struct,
+                              in_referring_struct_pnext_ptr_offset);
         }
 
         template<typename HelperStructType>
@@ -165,34 +252,57 @@ namespace Anvil
             /* Convert the input vector to a single entry */
             anvil_assert(in_helper_struct_vec.size() > 0);
 
-            m_helper_structs.push_back(
-                HelperStruct(&in_helper_struct_vec.at(0),
-                              static_cast<uint32_t>(in_helper_struct_vec.size() ) * sizeof(HelperStructType),
+            store_helper_data(&in_helper_struct_vec.at(0),
+                              static_cast<uint32_t>(in_helper_struct_vec.size() * sizeof(HelperStructType) ),
                               in_referring_struct,
-                              in_referring_struct_pnext_ptr_offset)
-            );
+                              in_referring_struct_pnext_ptr_offset);
+        }
 
-            m_helper_structs_size += static_cast<uint32_t>(in_helper_struct_vec.size() ) * sizeof(HelperStructType);
+        /** Links all structs appended to the chainer together, updates pointers to helper structures and
+         *  returns the root struct of the chain.
+         *
+         *  The chain is formed in storage owned by the chainer, so no allocations are made. The returned
+         *  pointer (and pointers to any structs in the chain) are only valid until the chainer is modified
+         *  or released.
+         **/
+        StructType* bake_chain()
+        {
+            uint8_t* helper_data_ptr = reinterpret_cast<uint8_t*>(m_helper_data.data() );
+            uint8_t* struct_data_ptr = reinterpret_cast<uint8_t*>(m_structs.data    () );
+
+            anvil_assert(m_struct_offsets.size() > 0);
+
+            link_chain(struct_data_ptr);
+
+            for (uint32_t n_helper_struct = 0;
+                          n_helper_struct < m_helper_structs.size();
+                        ++n_helper_struct)
+            {
+                const auto& current_helper_struct = m_helper_structs[n_helper_struct];
+
+                *reinterpret_cast<void**>(struct_data_ptr + current_helper_struct.referring_struct_id + current_helper_struct.referring_struct_ptr_offset) = helper_data_ptr + current_helper_struct.data_offset;
+            }
+
+            return reinterpret_cast<StructType*>(struct_data_ptr);
         }
 
         std::unique_ptr<StructChain<StructType> > create_chain() const
         {
-            size_t                                    n_bytes_used     = 0;
-            const uint32_t                            n_helper_structs = static_cast<uint32_t>(m_helper_structs.size() );
-            const uint32_t                            n_structs        = static_cast<uint32_t>(m_structs.size       () );
+            const uint32_t                            helper_data_size = m_helper_data.size() * sizeof(StorageItem);
+            const uint32_t                            structs_size     = get_structs_size();
             std::unique_ptr<StructChain<StructType> > result_ptr;
 
             /* Sanity checks */
-            if (m_structs.size() == 0)
+            if (m_struct_offsets.size() == 0)
             {
-                anvil_assert(m_structs.size() > 0);
+                anvil_assert(m_struct_offsets.size() > 0);
 
                 goto end;
             }
 
             /* Allocate the result instance */
             result_ptr.reset(
-                new StructChain<StructType>(m_structs_size + m_helper_structs_size)
+                new StructChain<StructType>(structs_size + helper_data_size)
             );
 
             if (result_ptr == nullptr)
@@ -202,47 +312,29 @@ namespace Anvil
                 goto end;
             }
 
-            /* Form the struct chain.. */
-            for (uint32_t n_struct = 0;
-                          n_struct < n_structs;
-                        ++n_struct)
-            {
-                /* Copy struct contents to the final vector */
-                const auto& current_struct_data      = m_structs.at(n_struct);
-                const auto  current_struct_data_size = current_struct_data.size();
+            /* Copy struct contents to the final vector and form the struct chain.. */
+            memcpy(&result_ptr->raw_data.at(0),
+                   m_structs.data(),
+                   structs_size);
 
-                memcpy(&result_ptr->raw_data.at(n_bytes_used),
-                       &current_struct_data.at(0),
-                        current_struct_data_size);
+            link_chain(&result_ptr->raw_data.at(0) );
 
-                /* Adjust pNext pointer to point at the next struct, if defined. */
-                if (n_struct != (n_structs - 1) )
-                {
-                    VkStructHeader* header_ptr = reinterpret_cast<VkStructHeader*>(&result_ptr->raw_data.at(n_bytes_used) );
-
-                    header_ptr->next_ptr = &result_ptr->raw_data.at(0) + n_bytes_used + current_struct_data_size;
-                }
-
-                n_bytes_used += current_struct_data_size;
-            }
-
-            for (uint32_t n_helper_struct = 0;
-                          n_helper_struct < n_helper_structs;
-                        ++n_helper_struct)
+            if (helper_data_size > 0)
             {
-                const auto& current_helper_struct_props     = m_helper_structs.at(n_helper_struct);
-                const auto& current_helper_struct_data      = current_helper_struct_props.data;
-                const auto  current_helper_struct_data_size = current_helper_struct_data.size();
-
                 /* Cache helper structure data */
-                memcpy(&result_ptr->raw_data.at(n_bytes_used),
-                       &current_helper_struct_data.at(0),
-                        current_helper_struct_data_size);
+                memcpy(&result_ptr->raw_data.at(structs_size),
+                       m_helper_data.data(),
+                       helper_data_size);
 
-                /* Patch the field of the referring struct so that it points to the helper structure we cache locally */
-                *reinterpret_cast<void**>(&result_ptr->raw_data.at(current_helper_struct_props.referring_struct_id + current_helper_struct_props.referring_struct_ptr_offset) ) = &result_ptr->raw_data.at(n_bytes_used);
+                for (uint32_t n_helper_struct = 0;
+                              n_helper_struct < m_helper_structs.size();
+                            ++n_helper_struct)
+                {
+                    const auto& current_helper_struct = m_helper_structs[n_helper_struct];
 
-                n_bytes_used += current_helper_struct_data_size;
+                    /* Patch the field of the referring struct so that it points to the helper structure we cache locally */
+                    *reinterpret_cast<void**>(&result_ptr->raw_data.at(current_helper_struct.referring_struct_id + current_helper_struct.referring_struct_ptr_offset) ) = &result_ptr->raw_data.at(structs_size + current_helper_struct.data_offset);
+                }
             }
 
             result_ptr->root_struct_ptr = reinterpret_cast<StructType*>(&result_ptr->raw_data.at(0) );
@@ -252,81 +344,136 @@ namespace Anvil
             return result_ptr;
         }
 
+        /** Returns the most recently appended struct.
+         *
+         *  NOTE: The returned pointer refers to storage owned by the chainer, which moves to the heap once a chain
+         *        outgrows the inline capacity. It is therefore only valid until the next append_struct() call, or
+         *        until the chainer is released.
+         **/
         StructType* get_last_struct()
         {
-            anvil_assert(m_structs.size() > 0);
+            anvil_assert(m_struct_offsets.size() > 0);
 
-            return reinterpret_cast<StructType*>(&m_structs.at(m_structs.size() - 1).at(0) );
+            return reinterpret_cast<StructType*>(reinterpret_cast<uint8_t*>(m_structs.data() ) + m_struct_offsets[m_struct_offsets.size() - 1]);
         }
 
         const StructType* get_last_struct() const
         {
-            anvil_assert(m_structs.size() > 0);
+            anvil_assert(m_struct_offsets.size() > 0);
 
-            return reinterpret_cast<const StructType*>(&m_structs.at(m_structs.size() - 1).at(0) );
+            return reinterpret_cast<const StructType*>(reinterpret_cast<const uint8_t*>(m_structs.data() ) + m_struct_offsets[m_struct_offsets.size() - 1]);
         }
 
         uint32_t get_n_structs() const
         {
-            return static_cast<uint32_t>(m_structs.size() );
+            return m_struct_offsets.size();
         }
 
+        /** Returns the first appended struct.
+         *
+         *  NOTE: The returned pointer is only valid until the next append_struct() call. See get_last_struct().
+         **/
         StructType* get_root_struct()
         {
-            anvil_assert(m_structs.size() > 0);
+            anvil_assert(m_struct_offsets.size() > 0);
 
-            return reinterpret_cast<StructType*>(&m_structs.at(0).at(0) );
+            return reinterpret_cast<StructType*>(m_structs.data() );
         }
 
         const StructType* get_root_struct() const
         {
-            anvil_assert(m_structs.size() > 0);
+            anvil_assert(m_struct_offsets.size() > 0);
 
-            return reinterpret_cast<const StructType*>(&m_structs.at(0).at(0) );
+            return reinterpret_cast<const StructType*>(m_structs.data() );
         }
 
+        /** Returns the struct appended as @param in_index-th, or nullptr if the index is invalid.
+         *
+         *  NOTE: The returned pointer is only valid until the next append_struct() call. See get_last_struct().
+         **/
         VkStructHeader* get_struct_at_index(const uint32_t& in_index)
         {
             VkStructHeader* result_ptr = nullptr;
 
-            if (m_structs.size() > in_index)
+            if (m_struct_offsets.size() > in_index)
             {
-                result_ptr = reinterpret_cast<VkStructHeader*>(&m_structs.at(in_index).at(0) );
+                result_ptr = reinterpret_cast<VkStructHeader*>(reinterpret_cast<uint8_t*>(m_structs.data() ) + m_struct_offsets[in_index]);
             }
 
             return result_ptr;
         }
     private:
         /* Private type definitions */
+
+        /* Struct data is stored in 8-byte units, so that all structs (and helper structures) are suitably
+         * aligned for any member Vulkan structures may define. */
+        typedef uint64_t StorageItem;
+
         typedef struct HelperStruct
         {
-            std::vector<uint8_t> data;
-            StructID             referring_struct_id;
-            uint32_t             referring_struct_ptr_offset;
+            uint32_t data_offset;
+            StructID referring_struct_id;
+            uint32_t referring_struct_ptr_offset;
+        } HelperStruct;
 
-            HelperStruct(const void*     in_data_ptr,
-                         const uint32_t& in_data_size,
-                         const StructID& in_referring_struct_id,
-                         const uint32_t& in_referring_struct_ptr_offset)
-                :referring_struct_id        (in_referring_struct_id),
-                 referring_struct_ptr_offset(in_referring_struct_ptr_offset)
-            {
-                anvil_assert(in_data_ptr  != nullptr);
-                anvil_assert(in_data_size != 0);
+        /* Private functions */
+        static uint32_t get_n_storage_items(const uint32_t& in_n_bytes)
+        {
+            return static_cast<uint32_t>((in_n_bytes + sizeof(StorageItem) - 1) / sizeof(StorageItem) );
+        }
+
+        uint32_t get_structs_size() const
+        {
+            return m_structs.size() * static_cast<uint32_t>(sizeof(StorageItem) );
+        }
 
-                data.resize(in_data_size);
+        void link_chain(uint8_t* in_struct_data_ptr) const
+        {
+            const uint32_t n_structs = m_struct_offsets.size();
 
-                memcpy(&data.at(0),
-                       in_data_ptr,
-                       in_data_size);
+            for (uint32_t n_struct = 0;
+                          n_struct < n_structs;
+                        ++n_struct)
+            {
+                /* Adjust pNext pointer to point at the next struct, if defined. */
+                VkStructHeader* header_ptr = reinterpret_cast<VkStructHeader*>(in_struct_data_ptr + m_struct_offsets[n_struct]);
+
+                header_ptr->next_ptr = (n_struct != (n_structs - 1) ) ? in_struct_data_ptr + m_struct_offsets[n_struct + 1]
+                                                                      : nullptr;
             }
-        } HelperStruct;
+        }
 
-        /* Private functions */
-        std::vector<HelperStruct>          m_helper_structs;
-        uint32_t                           m_helper_structs_size;
-        std::vector<std::vector<uint8_t> > m_structs;
-        uint32_t                           m_structs_size;
+        void store_helper_data(const void*     in_data_ptr,
+                               const uint32_t& in_data_size,
+                               const StructID& in_referring_struct,
+                               const uint32_t& in_referring_struct_pnext_ptr_offset)
+        {
+            HelperStruct   helper_struct;
+            const uint32_t pre_call_helper_data_size = m_helper_data.size() * static_cast<uint32_t>(sizeof(StorageItem) );
+
+            anvil_assert(in_data_ptr  != nullptr);
+            anvil_assert(in_data_size != 0);
+            anvil_assert(get_structs_size() >  in_referring_struct);
+            anvil_assert(get_structs_size() >= in_referring_struct + in_referring_struct_pnext_ptr_offset + sizeof(void*) );
+
+            m_helper_data.resize(m_helper_data.size() + get_n_storage_items(in_data_size) );
+
+            memcpy(reinterpret_cast<uint8_t*>(m_helper_data.data() ) + pre_call_helper_data_size,
+                   in_data_ptr,
+                   in_data_size);
+
+            helper_struct.data_offset                 = pre_call_helper_data_size;
+            helper_struct.referring_struct_id         = in_referring_struct;
+            helper_struct.referring_struct_ptr_offset = in_referring_struct_pnext_ptr_offset;
+
+            m_helper_structs.push_back(helper_struct);
+        }
+
+        /* Private variables */
+        InlinePODVector<StorageItem,  32> m_helper_data;
+        InlinePODVector<HelperStruct, 4>  m_helper_structs;
+        InlinePODVector<uint32_t,     16> m_struct_offsets;
+        InlinePODVector<StorageItem,  64> m_structs;
     };
 };
 
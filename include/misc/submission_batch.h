@@ -0,0 +1,193 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Accumulates any number of SubmitInfo descriptors, so that they can be handed over to the implementation
+ *  with a single vkQueueSubmit() call. Implemented in order to:
+ *
+ *  - reduce the number of vkQueueSubmit() calls apps need to issue per frame.
+ *  - avoid temporary allocations at submission time. All scratch storage needed to build Vulkan submit info
+ *    structures is owned by the batch and is retained between flushes, so a batch which is reused across frames
+ *    stops allocating once it has grown to the working set size.
+ *
+ *  Contents of SubmitInfo structures are copied at add() time, so it is safe to release them (and arrays
+ *  they point to) right after the call. The referred command buffers, semaphores and fences must remain alive
+ *  until the batch is submitted.
+ *
+ *  Since vkQueueSubmit() accepts at most one fence, all SubmitInfo structures added to the same batch must
+ *  either refer to the same fence, or to no fence at all. If any of the submissions is blocking, the whole
+ *  batch is waited on after being submitted.
+ *
+ *  Use Queue::submit(SubmissionBatch*) to flush the batch.
+ *
+ *  The batch is NOT thread-safe.
+ **/
+#ifndef MISC_SUBMISSION_BATCH_H
+#define MISC_SUBMISSION_BATCH_H
+
+#include "misc/types.h"
+
+namespace Anvil
+{
+    class SubmissionBatch
+    {
+    public:
+        /* Public functions */
+
+        /** Constructor. Creates an empty batch. */
+        SubmissionBatch();
+
+        /** Destructor */
+        ~SubmissionBatch();
+
+        /** Appends a new submission to the batch. Submissions are executed in the order they were added in.
+         *
+         *  @param in_submit_info Submission to append. SGPU and MGPU submissions can be freely mixed, as long as
+         *                        the batch is submitted to a queue of a device of the matching type.
+         *
+         *  @return true if successful, false if the submission refers to a different fence than one of the
+         *          submissions which had been added to the batch before.
+         **/
+        bool add(const Anvil::SubmitInfo& in_submit_info);
+
+        /** Removes all submissions from the batch. Scratch storage is retained. */
+        void clear();
+
+        /** Returns the fence which is going to be signalled when all submissions in the batch finish
+         *  executing GPU-side, or nullptr if none of the added submissions specified a fence.
+         **/
+        Anvil::Fence* get_fence() const
+        {
+            return m_fence_ptr;
+        }
+
+        /** Returns the number of submissions added to the batch since it was created or last cleared. */
+        uint32_t get_n_submissions() const
+        {
+            return static_cast<uint32_t>(m_submissions.size() );
+        }
+
+        /** Tells whether Queue::submit() is going to block until the batch finishes executing. */
+        bool get_should_block() const
+        {
+            return m_should_block;
+        }
+
+        /** Returns the timeout which will be used when waiting on the batch to finish executing. */
+        const uint64_t& get_timeout() const
+        {
+            return m_timeout;
+        }
+
+    private:
+        /* Private type definitions */
+
+        /* Describes a single submission. All first_* fields index into flat arrays owned by the batch. */
+        typedef struct Submission
+        {
+            uint32_t first_cmd_buffer;
+            uint32_t first_signal_semaphore;
+            uint32_t first_wait_semaphore;
+            uint32_t n_cmd_buffers;
+            uint32_t n_signal_semaphores;
+            uint32_t n_wait_semaphores;
+
+            bool has_timeline_semaphore_values;
+            bool is_mgpu;
+            bool is_protected;
+
+            #if defined(_WIN32)
+                bool has_d3d12_fence_semaphore_values;
+
+                uint32_t first_keyed_mutex_acquire_key;
+                uint32_t first_keyed_mutex_release_key;
+                uint32_t n_keyed_mutex_acquire_keys;
+                uint32_t n_keyed_mutex_release_keys;
+            #endif
+
+            Submission()
+            {
+                memset(this,
+                       0,
+                       sizeof(*this) );
+            }
+        } Submission;
+
+        /* Private functions */
+
+        const VkSubmitInfo* bake_submit_infos(VkSemaphore in_opt_tracking_semaphore,
+                                              uint64_t    in_tracking_semaphore_value);
+        void                lock_unlock      (bool        in_should_lock) const;
+
+        SubmissionBatch           (const SubmissionBatch&);
+        SubmissionBatch& operator=(const SubmissionBatch&);
+
+        /* Private variables */
+        std::vector<Submission> m_submissions;
+
+        std::vector<Anvil::CommandBufferBase*> m_cmd_buffer_ptrs;
+        std::vector<uint32_t>                  m_cmd_buffer_device_masks;
+        std::vector<VkCommandBuffer>           m_cmd_buffers_vk;
+
+        std::vector<Anvil::Semaphore*> m_signal_semaphore_ptrs;
+        std::vector<uint32_t>          m_signal_semaphore_device_indices;
+        std::vector<VkSemaphore>       m_signal_semaphores_vk;
+
+        std::vector<Anvil::Semaphore*>    m_wait_semaphore_ptrs;
+        std::vector<uint32_t>             m_wait_semaphore_device_indices;
+        std::vector<VkPipelineStageFlags> m_wait_semaphore_dst_stage_masks;
+        std::vector<VkSemaphore>          m_wait_semaphores_vk;
+
+        /* NOTE: Timeline semaphore value arrays are kept in sync with semaphore arrays. */
+        std::vector<uint64_t> m_timeline_signal_semaphore_values;
+        std::vector<uint64_t> m_timeline_wait_semaphore_values;
+
+        #if defined(_WIN32)
+            std::vector<uint64_t> m_d3d12_fence_signal_semaphore_values;
+            std::vector<uint64_t> m_d3d12_fence_wait_semaphore_values;
+
+            std::vector<VkDeviceMemory> m_keyed_mutex_acquire_syncs;
+            std::vector<uint64_t>       m_keyed_mutex_acquire_keys;
+            std::vector<uint32_t>       m_keyed_mutex_acquire_timeouts;
+            std::vector<VkDeviceMemory> m_keyed_mutex_release_syncs;
+            std::vector<uint64_t>       m_keyed_mutex_release_keys;
+        #endif
+
+        /* Vulkan structures. Filled at bake time. */
+        std::vector<VkDeviceGroupSubmitInfoKHR>       m_device_group_submit_infos_vk;
+        std::vector<VkProtectedSubmitInfo>            m_protected_submit_infos_vk;
+        std::vector<VkSubmitInfo>                     m_submit_infos_vk;
+        std::vector<VkTimelineSemaphoreSubmitInfoKHR> m_timeline_semaphore_submit_infos_vk;
+
+        #if defined(_WIN32)
+            std::vector<VkD3D12FenceSubmitInfoKHR>              m_d3d12_fence_submit_infos_vk;
+            std::vector<VkWin32KeyedMutexAcquireReleaseInfoKHR> m_keyed_mutex_acquire_release_infos_vk;
+        #endif
+
+        Anvil::Fence* m_fence_ptr;
+        bool          m_should_block;
+        uint64_t      m_timeout;
+
+        friend class Anvil::Queue;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_SUBMISSION_BATCH_H */
@@ -42,16 +42,20 @@ namespace Anvil
          Time();
         ~Time();
 
+        /** Returns the value of a monotonic clock in nanoseconds. The reference point is unspecified, but it is
+         *  the same for all threads, so values returned for different threads can be compared.
+         **/
+        static uint64_t get_absolute_time_in_nsec();
+
+        /** Returns the number of milliseconds which have passed since the object was created. */
         uint64_t get_time_in_msec();
 
+        /** Returns the number of nanoseconds which have passed since the object was created. */
+        uint64_t get_time_in_nsec();
+
     private:
         /* Private fields */
-        #ifdef _WIN32
-            LARGE_INTEGER m_frequency;
-            LARGE_INTEGER m_start_time;
-        #else
-            uint64_t m_start_time;
-        #endif
+        uint64_t m_start_time_nsec;
     };
 }; /* namespace Anvil */
 
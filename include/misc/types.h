@@ -115,10 +115,12 @@ namespace Anvil
     struct CallbackArgument;
     class  CommandBufferBase;
     class  CommandPool;
+    class  CommandStream;
     class  ComputePipelineCreateInfo;
     class  ComputePipelineManager;
     class  DebugMessenger;
     class  DebugMessengerCreateInfo;
+    class  DeferredMemoryFlushList;
     class  DescriptorPool;
     class  DescriptorPoolCreateInfo;
     class  DescriptorSet;
@@ -132,10 +134,12 @@ namespace Anvil
     class  Event;
     class  EventCreateInfo;
     class  Fence;
+    class  FencePool;
     class  FenceCreateInfo;
     class  Framebuffer;
     class  FramebufferCreateInfo;
     class  GLSLShaderToSPIRVGenerator;
+    class  GPUProfiler;
     class  GraphicsPipelineCreateInfo;
     class  GraphicsPipelineManager;
     class  Image;
@@ -147,22 +151,28 @@ namespace Anvil
     class  MemoryAllocator;
     class  MemoryBlock;
     class  MemoryBlockCreateInfo;
+    class  MemoryBudgetTracker;
     struct MemoryHeap;
     struct MemoryProperties;
     struct MemoryType;
     class  MGPUDevice;
     class  PhysicalDevice;
+    class  PipelineBarrierBatch;
     class  PipelineCache;
     class  PipelineLayout;
     class  PipelineLayoutManager;
     class  PrimaryCommandBuffer;
     class  QueryPool;
     class  Queue;
+    class  RedundantStateFilter;
+    class  RenderGraph;
     class  RenderingSurface;
     class  RenderingSurfaceCreateInfo;
     class  RenderPass;
     class  RenderPassCreateInfo;
+    class  ResourceStateTracker;
     class  Sampler;
+    class  SamplerCache;
     class  SamplerCreateInfo;
     class  SamplerYCbCrConversion;
     class  SamplerYCbCrConversionCreateInfo;
@@ -172,6 +182,8 @@ namespace Anvil
     class  SGPUDevice;
     class  ShaderModule;
     class  ShaderModuleCache;
+    class  SparseResidencyManager;
+    class  SubmissionBatch;
     class  Swapchain;
     class  SwapchainCreateInfo;
     class  Window;
@@ -184,9 +196,11 @@ namespace Anvil
     typedef std::unique_ptr<BufferView,                            std::function<void(BufferView*)> >                  BufferViewUniquePtr;
     typedef std::unique_ptr<CommandBufferBase,                     std::function<void(CommandBufferBase*)> >           CommandBufferBaseUniquePtr;
     typedef std::unique_ptr<CommandPool,                           std::function<void(CommandPool*)> >                 CommandPoolUniquePtr;
+    typedef std::unique_ptr<CommandStream,                         std::function<void(CommandStream*)> >               CommandStreamUniquePtr;
     typedef std::unique_ptr<ComputePipelineCreateInfo>                                                                 ComputePipelineCreateInfoUniquePtr;
     typedef std::unique_ptr<DebugMessengerCreateInfo>                                                                  DebugMessengerCreateInfoUniquePtr;
     typedef std::unique_ptr<DebugMessenger,                        std::function<void(DebugMessenger*)> >              DebugMessengerUniquePtr;
+    typedef std::unique_ptr<DeferredMemoryFlushList,               std::function<void(DeferredMemoryFlushList*)> >     DeferredMemoryFlushListUniquePtr;
     typedef std::unique_ptr<DescriptorPoolCreateInfo>                                                                  DescriptorPoolCreateInfoUniquePtr;
     typedef std::unique_ptr<DescriptorPool,                        std::function<void(DescriptorPool*)> >              DescriptorPoolUniquePtr;
     typedef std::unique_ptr<DescriptorSetCreateInfo>                                                                   DescriptorSetCreateInfoUniquePtr;
@@ -201,9 +215,11 @@ namespace Anvil
     typedef std::unique_ptr<Event,                                 std::function<void(Event*)> >                       EventUniquePtr;
     typedef std::unique_ptr<FenceCreateInfo>                                                                           FenceCreateInfoUniquePtr;
     typedef std::unique_ptr<Fence,                                 std::function<void(Fence*)> >                       FenceUniquePtr;
+    typedef std::unique_ptr<FencePool,                             std::function<void(FencePool*)> >                   FencePoolUniquePtr;
     typedef std::unique_ptr<FramebufferCreateInfo>                                                                     FramebufferCreateInfoUniquePtr;
     typedef std::unique_ptr<Framebuffer,                           std::function<void(Framebuffer*)> >                 FramebufferUniquePtr;
     typedef std::unique_ptr<GLSLShaderToSPIRVGenerator,            std::function<void(GLSLShaderToSPIRVGenerator*)> >  GLSLShaderToSPIRVGeneratorUniquePtr;
+    typedef std::unique_ptr<GPUProfiler,                           std::function<void(GPUProfiler*)> >                 GPUProfilerUniquePtr;
     typedef std::unique_ptr<GraphicsPipelineCreateInfo>                                                                GraphicsPipelineCreateInfoUniquePtr;
     typedef std::unique_ptr<GraphicsPipelineManager>                                                                   GraphicsPipelineManagerUniquePtr;
     typedef std::unique_ptr<ImageCreateInfo>                                                                           ImageCreateInfoUniquePtr;
@@ -215,16 +231,22 @@ namespace Anvil
     typedef std::unique_ptr<MemoryAllocator,                       std::function<void(MemoryAllocator*)> >             MemoryAllocatorUniquePtr;
     typedef std::unique_ptr<MemoryBlockCreateInfo>                                                                     MemoryBlockCreateInfoUniquePtr;
     typedef std::unique_ptr<MemoryBlock,                           std::function<void(MemoryBlock*)> >                 MemoryBlockUniquePtr;
+    typedef std::unique_ptr<MemoryBudgetTracker,                   std::function<void(MemoryBudgetTracker*)> >         MemoryBudgetTrackerUniquePtr;
     typedef std::unique_ptr<MGPUDevice,                            std::function<void(MGPUDevice*)> >                  MGPUDeviceUniquePtr;
+    typedef std::unique_ptr<PipelineBarrierBatch,                  std::function<void(PipelineBarrierBatch*)> >        PipelineBarrierBatchUniquePtr;
     typedef std::unique_ptr<PipelineCache,                         std::function<void(PipelineCache*)> >               PipelineCacheUniquePtr;
     typedef std::unique_ptr<PipelineLayoutManager,                 std::function<void(PipelineLayoutManager*)> >       PipelineLayoutManagerUniquePtr;
     typedef std::unique_ptr<PipelineLayout,                        std::function<void(PipelineLayout*)> >              PipelineLayoutUniquePtr;
     typedef std::unique_ptr<PrimaryCommandBuffer,                  std::function<void(PrimaryCommandBuffer*)> >        PrimaryCommandBufferUniquePtr;
     typedef std::unique_ptr<QueryPool,                             std::function<void(QueryPool*)> >                   QueryPoolUniquePtr;
+    typedef std::unique_ptr<RedundantStateFilter,                  std::function<void(RedundantStateFilter*)> >        RedundantStateFilterUniquePtr;
+    typedef std::unique_ptr<RenderGraph,                           std::function<void(RenderGraph*)> >                 RenderGraphUniquePtr;
     typedef std::unique_ptr<RenderingSurface,                      std::function<void(RenderingSurface*)> >            RenderingSurfaceUniquePtr;
     typedef std::unique_ptr<RenderingSurfaceCreateInfo>                                                                RenderingSurfaceCreateInfoUniquePtr;
     typedef std::unique_ptr<RenderPassCreateInfo>                                                                      RenderPassCreateInfoUniquePtr;
     typedef std::unique_ptr<RenderPass,                            std::function<void(RenderPass*)> >                  RenderPassUniquePtr;
+    typedef std::unique_ptr<ResourceStateTracker,                  std::function<void(ResourceStateTracker*)> >        ResourceStateTrackerUniquePtr;
+    typedef std::unique_ptr<SamplerCache,                          std::function<void(SamplerCache*)> >                SamplerCacheUniquePtr;
     typedef std::unique_ptr<SamplerCreateInfo>                                                                         SamplerCreateInfoUniquePtr;
     typedef std::unique_ptr<Sampler,                               std::function<void(Sampler*)> >                     SamplerUniquePtr;
     typedef std::unique_ptr<SamplerYCbCrConversionCreateInfo>                                                          SamplerYCbCrConversionCreateInfoUniquePtr;
@@ -235,6 +257,7 @@ namespace Anvil
     typedef std::unique_ptr<SGPUDevice,                            std::function<void(SGPUDevice*)> >                  SGPUDeviceUniquePtr;
     typedef std::unique_ptr<ShaderModuleCache,                     std::function<void(ShaderModuleCache*)> >           ShaderModuleCacheUniquePtr;
     typedef std::unique_ptr<ShaderModule,                          std::function<void(ShaderModule*)> >                ShaderModuleUniquePtr;
+    typedef std::unique_ptr<SparseResidencyManager,                std::function<void(SparseResidencyManager*)> >      SparseResidencyManagerUniquePtr;
     typedef std::unique_ptr<SwapchainCreateInfo>                                                                       SwapchainCreateInfoUniquePtr;
     typedef std::unique_ptr<Swapchain,                             std::function<void(Swapchain*)> >                   SwapchainUniquePtr;
     typedef std::unique_ptr<Window,                                std::function<void(Window*)> >                      WindowUniquePtr;
@@ -268,12 +291,29 @@ namespace Anvil
     /* Index of a query within parent query pool instance */
     typedef uint32_t QueryIndex;
 
+    /* Unique ID of a pass within scope of a RenderGraph instance. */
+    typedef uint32_t RenderGraphPassID;
+
+    /* Unique ID of a buffer or an image within scope of a RenderGraph instance. */
+    typedef uint32_t RenderGraphResourceID;
+
+    /** Render graph pass recording call-back function prototype.
+     *
+     *  @param in_cmd_buffer_ptr Command buffer the pass commands should be recorded into.
+     *  @param in_pass_id        ID of the pass to record.
+     **/
+    typedef std::function<void (Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                                Anvil::RenderGraphPassID  in_pass_id)> RenderGraphRecordFunction;
+
     /* Unique ID of a render-pass attachment within scope of a RenderPass instance. */
     typedef uint32_t RenderPassAttachmentID;
 
     /* Unique ID of a sparse memory bind update */
     typedef uint32_t SparseMemoryBindInfoID;
 
+    /* Unique ID of a buffer or an image within scope of a SparseResidencyManager instance. */
+    typedef uint32_t SparseResourceID;
+
     /* Unique ID of a render-pass' sub-pass attachment within scope of a RenderPass instance. */
     typedef uint32_t SubPassAttachmentID;
 
@@ -41,6 +41,10 @@ namespace Anvil
                                          void**       out_result_ptr)   = 0;
         virtual bool     supports_baking() const                        = 0;
         virtual void     unmap          (void*        in_memory_object) = 0;
+
+        /* Called by memory blocks which were assigned the backend with set_parent_memory_allocator_backend_ptr(),
+         * right before they are released. */
+        virtual void on_memory_block_released(const Anvil::MemoryBlock* in_memory_block_ptr) = 0;
     };
 
     /** Container for sparse memory binding updates */
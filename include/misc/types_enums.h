@@ -1506,6 +1506,22 @@ namespace Anvil
         REGULAR_WITH_MEMORY_TYPE
     };
 
+    /* Tells how storage of a root memory block is mapped into process space. */
+    enum class MemoryBlockMappingMode
+    {
+        /* Storage is mapped for the duration of each read() and write() call, unless the app keeps it mapped with map(). */
+        ON_DEMAND,
+
+        /* Storage stays mapped until the mapping mode is changed, or until the memory block is released. */
+        PERSISTENT,
+
+        /* As PERSISTENT. Additionally, write() calls made against non-coherent memory do not flush the modified range.
+         * Instead, the range is recorded in the device-wide deferred memory flush list and flushed, together with all
+         * other pending ranges, at the next Queue::submit() or DeferredMemoryFlushList::flush() call.
+         */
+        PERSISTENT_WITH_DEFERRED_FLUSHES,
+    };
+
     enum class MemoryFeatureFlagBits
     {
         /* NOTE: If more memory feature flags are added here, make sure to also update Anvil::Utils::get_vk_property_flags_from_memory_feature_flags()
@@ -1617,12 +1633,17 @@ namespace Anvil
 
         /* Anvil-specific items */
         ANVIL_COMPUTE_PIPELINE_MANAGER = VK_OBJECT_TYPE_END_RANGE + 1,
+        ANVIL_DEFERRED_MEMORY_FLUSH_LIST,
         ANVIL_DESCRIPTOR_SET_GROUP,
         ANVIL_DESCRIPTOR_SET_LAYOUT_MANAGER,
+        ANVIL_FENCE_POOL,
         ANVIL_GLSL_SHADER_TO_SPIRV_GENERATOR,
+        ANVIL_GPU_PROFILER,
         ANVIL_GRAPHICS_PIPELINE_MANAGER,
         ANVIL_MEMORY_BLOCK,
+        ANVIL_MEMORY_BUDGET_TRACKER,
         ANVIL_PIPELINE_LAYOUT_MANAGER,
+        ANVIL_SAMPLER_CACHE,
 
         /* Always last */
         UNKNOWN
@@ -1980,6 +2001,18 @@ namespace Anvil
         UNKNOWN = VK_SAMPLER_YCBCR_MODEL_CONVERSION_MAX_ENUM
     };
 
+    /* NOTE: These map 1:1 to VK equivalents */
+    enum class SemaphoreType
+    {
+        /* Core VK 1.0 functionality */
+        BINARY_KHR = VK_SEMAPHORE_TYPE_BINARY_KHR,
+
+        /* VK_KHR_timeline_semaphore */
+        TIMELINE_KHR = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+
+        UNKNOWN = VK_SEMAPHORE_TYPE_MAX_ENUM_KHR
+    };
+
     /* Specifies one of the compute / rendering pipeline stages. */
     enum class ShaderStage
     {
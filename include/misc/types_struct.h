@@ -1173,6 +1173,15 @@ namespace Anvil
         ExtensionKHRSwapchainEntrypoints();
     } ExtensionKHRSwapchainEntrypoints;
 
+    typedef struct ExtensionKHRTimelineSemaphoreEntrypoints
+    {
+        PFN_vkGetSemaphoreCounterValueKHR vkGetSemaphoreCounterValueKHR;
+        PFN_vkSignalSemaphoreKHR          vkSignalSemaphoreKHR;
+        PFN_vkWaitSemaphoresKHR           vkWaitSemaphoresKHR;
+
+        ExtensionKHRTimelineSemaphoreEntrypoints();
+    } ExtensionKHRTimelineSemaphoreEntrypoints;
+
     #ifdef _WIN32
         #if defined(ANVIL_INCLUDE_WIN3264_WINDOW_SYSTEM_SUPPORT)
             typedef struct ExtensionKHRWin32SurfaceEntrypoints
@@ -1782,6 +1791,18 @@ namespace Anvil
         bool operator==(const KHRShaderFloatControlsProperties& in_properties) const;
     } KHRShaderFloatControlsProperties;
 
+    typedef struct KHRTimelineSemaphoreFeatures
+    {
+        bool timeline_semaphore;
+
+        KHRTimelineSemaphoreFeatures();
+        KHRTimelineSemaphoreFeatures(const VkPhysicalDeviceTimelineSemaphoreFeaturesKHR& in_features);
+
+        VkPhysicalDeviceTimelineSemaphoreFeaturesKHR get_vk_physical_device_timeline_semaphore_features() const;
+
+        bool operator==(const KHRTimelineSemaphoreFeatures& in_features) const;
+    } KHRTimelineSemaphoreFeatures;
+
         typedef struct KHRVariablePointerFeatures
     {
         bool variable_pointers;
@@ -2416,6 +2437,7 @@ namespace Anvil
         const KHRMultiviewFeatures*              khr_multiview_features_ptr;
         const KHRSamplerYCbCrConversionFeatures* khr_sampler_ycbcr_conversion_features_ptr;
         const KHRShaderAtomicInt64Features*      khr_shader_atomic_int64_features_ptr;
+        const KHRTimelineSemaphoreFeatures*      khr_timeline_semaphore_features_ptr;
         const KHRVariablePointerFeatures*        khr_variable_pointer_features_ptr;
         const KHRVulkanMemoryModelFeatures*      khr_vulkan_memory_model_features_ptr;
 
@@ -2434,6 +2456,7 @@ namespace Anvil
                                const KHRMultiviewFeatures*              in_khr_multiview_features_ptr,
                                const KHRSamplerYCbCrConversionFeatures* in_khr_sampler_ycbcr_conversion_features_ptr,
                                const KHRShaderAtomicInt64Features*      in_khr_shader_atomic_int64_features_ptr,
+                               const KHRTimelineSemaphoreFeatures*      in_khr_timeline_semaphore_features_ptr,
                                const KHRVariablePointerFeatures*        in_khr_variable_pointer_features_ptr,
                                const KHRVulkanMemoryModelFeatures*      in_khr_vulkan_memory_model_features_ptr);
 
@@ -2722,6 +2745,39 @@ namespace Anvil
         explicit PhysicalDeviceGroup();
     } PhysicalDeviceGroup;
 
+    /** Describes how a buffer or a single image subresource has been accessed by the commands recorded so far.
+     *
+     *  Used to determine the minimal set of barriers needed before the resource can be accessed in a different
+     *  way. Please see ResourceStateTracker for more details.
+     **/
+    typedef struct ResourceAccessState
+    {
+        /* Layout the image subresource is in. Always UNDEFINED for buffers. */
+        Anvil::ImageLayout layout;
+
+        /* Stages which have read the resource since it was last written to. */
+        Anvil::PipelineStageFlags read_stages;
+
+        /* Access types and stages the last write (or layout transition) has been made visible to. */
+        Anvil::AccessFlags        visible_access;
+        Anvil::PipelineStageFlags visible_stages;
+
+        /* Last write access to the resource, which has not been made available yet, and stages any barrier
+         * which depends on the last write (or layout transition) needs to wait on. */
+        Anvil::AccessFlags        write_access;
+        Anvil::PipelineStageFlags write_stages;
+
+        /** Constructor. Describes a resource which has not been accessed yet.
+         *
+         *  @param in_layout Layout the image subresource is in.
+         **/
+        explicit ResourceAccessState(Anvil::ImageLayout in_layout = Anvil::ImageLayout::UNDEFINED)
+            :layout(in_layout)
+        {
+            /* Stub */
+        }
+    } ResourceAccessState;
+
     /** TODO */
     typedef struct SemaphoreMGPUSubmission
     {
@@ -2927,6 +2983,7 @@ namespace Anvil
          *  - D3D12 fence submit info:          none
          *  - Keyed mutex acquire/release info: none
          *  - Protected submission:             no
+         *  - Timeline semaphore values:        none
          *
          *  To adjust these settings, please use corresponding set_..() functions, prior to passing the structure over to Queue::submit().
          *
@@ -3186,6 +3243,22 @@ namespace Anvil
             return should_block;
         }
 
+        /* Returns true if set_timeline_semaphore_values() has been called prior to this call. Otherwise returns false.
+         *
+         * If the func returns true, derefs are set to the arrays specified at set_timeline_semaphore_values() call time.
+         */
+        bool get_timeline_semaphore_values(const uint64_t** out_signal_semaphore_values_ptr_ptr,
+                                           const uint64_t** out_wait_semaphore_values_ptr_ptr) const
+        {
+            bool result = (timeline_signal_semaphore_values_ptr != nullptr && n_signal_semaphores != 0) ||
+                          (timeline_wait_semaphore_values_ptr   != nullptr && n_wait_semaphores   != 0);
+
+            *out_signal_semaphore_values_ptr_ptr = timeline_signal_semaphore_values_ptr;
+            *out_wait_semaphore_values_ptr_ptr   = timeline_wait_semaphore_values_ptr;
+
+            return result;
+        }
+
         const uint64_t& get_timeout() const
         {
             return timeout;
@@ -3314,6 +3387,40 @@ namespace Anvil
             is_protected = in_should_enable;
         }
 
+        /* Calling this function will make Anvil fill & chain a VkTimelineSemaphoreSubmitInfoKHR struct at queue submission time.
+         *
+         * Values corresponding to binary semaphores are ignored by the implementation.
+         *
+         * Requires VK_KHR_timeline_semaphore support.
+         *
+         * NOTE: The structure caches the provided pointers, not the contents available under derefs! Make sure the pointers remain valid
+         *       for the time of the Queue::submit() call.
+         *
+         * @param in_signal_semaphore_values_ptr An array of exactly n_signal_semaphores values to signal the semaphores with.
+         *                                       Must not be nullptr unless n_signal_semaphores is 0.
+         * @param in_wait_semaphore_values_ptr   An array of exactly n_wait_semaphores values to wait for.
+         *                                       Must not be nullptr unless n_wait_semaphores is 0.
+         **/
+        void set_timeline_semaphore_values(const uint64_t* in_signal_semaphore_values_ptr,
+                                           const uint32_t& in_n_signal_semaphore_values,
+                                           const uint64_t* in_wait_semaphore_values_ptr,
+                                           const uint32_t& in_n_wait_semaphore_values)
+        {
+            ANVIL_REDUNDANT_ARGUMENT_CONST(in_n_signal_semaphore_values);
+            ANVIL_REDUNDANT_ARGUMENT_CONST(in_n_wait_semaphore_values);
+
+            anvil_assert((n_signal_semaphores != 0  && in_signal_semaphore_values_ptr != nullptr) ||
+                         (n_signal_semaphores == 0) );
+            anvil_assert((n_wait_semaphores   != 0  && in_wait_semaphore_values_ptr   != nullptr) ||
+                         (n_wait_semaphores   == 0) );
+
+            anvil_assert(in_n_signal_semaphore_values == n_signal_semaphores);
+            anvil_assert(in_n_wait_semaphore_values   == n_wait_semaphores);
+
+            timeline_signal_semaphore_values_ptr = in_signal_semaphore_values_ptr;
+            timeline_wait_semaphore_values_ptr   = in_wait_semaphore_values_ptr;
+        }
+
         /* Sets a timeout which is used when waiting on a fence that the submission is associated with.
          *
          * If your submission times out, you're likely about to experience a TDR and lose the device.
@@ -3377,6 +3484,9 @@ namespace Anvil
             const uint64_t*            keyed_mutex_release_mutex_key_value_ptrs;
         #endif
 
+        const uint64_t* timeline_signal_semaphore_values_ptr;
+        const uint64_t* timeline_wait_semaphore_values_ptr;
+
         bool                 is_protected;
         bool                 should_block;
         uint64_t             timeout;
@@ -24,6 +24,7 @@
 
 #include <config.h>
 #include "vulkan/vulkan.h"
+#include "misc/vulkan_compat.h"
 
 namespace Anvil
 {
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Definitions of Vulkan extensions Anvil makes use of, which are missing from the bundled Khronos
+ *  headers. Every block is guarded by the extension's macro, so the definitions are dropped as soon
+ *  as the headers Anvil is built against provide them.
+ *
+ *  Enumerators cannot be appended to VkStructureType from outside vulkan_core.h, so new structure
+ *  types are exposed as VkStructureType constants of the same name instead.
+ **/
+#ifndef MISC_VULKAN_COMPAT_H
+#define MISC_VULKAN_COMPAT_H
+
+#include "vulkan/vulkan.h"
+
+#ifndef VK_KHR_timeline_semaphore
+    #define VK_KHR_timeline_semaphore 1
+    #define VK_KHR_TIMELINE_SEMAPHORE_SPEC_VERSION   2
+    #define VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME "VK_KHR_timeline_semaphore"
+
+    #define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR   static_cast<VkStructureType>(1000207000)
+    #define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_PROPERTIES_KHR static_cast<VkStructureType>(1000207001)
+    #define VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR                    static_cast<VkStructureType>(1000207002)
+    #define VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR                static_cast<VkStructureType>(1000207003)
+    #define VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR                           static_cast<VkStructureType>(1000207004)
+    #define VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR                         static_cast<VkStructureType>(1000207005)
+
+    typedef enum VkSemaphoreTypeKHR
+    {
+        VK_SEMAPHORE_TYPE_BINARY_KHR     = 0,
+        VK_SEMAPHORE_TYPE_TIMELINE_KHR   = 1,
+        VK_SEMAPHORE_TYPE_MAX_ENUM_KHR   = 0x7FFFFFFF
+    } VkSemaphoreTypeKHR;
+
+    typedef enum VkSemaphoreWaitFlagBitsKHR
+    {
+        VK_SEMAPHORE_WAIT_ANY_BIT_KHR            = 0x00000001,
+        VK_SEMAPHORE_WAIT_FLAG_BITS_MAX_ENUM_KHR = 0x7FFFFFFF
+    } VkSemaphoreWaitFlagBitsKHR;
+    typedef VkFlags VkSemaphoreWaitFlagsKHR;
+
+    typedef struct VkPhysicalDeviceTimelineSemaphoreFeaturesKHR
+    {
+        VkStructureType sType;
+        void*           pNext;
+        VkBool32        timelineSemaphore;
+    } VkPhysicalDeviceTimelineSemaphoreFeaturesKHR;
+
+    typedef struct VkPhysicalDeviceTimelineSemaphorePropertiesKHR
+    {
+        VkStructureType sType;
+        void*           pNext;
+        uint64_t        maxTimelineSemaphoreValueDifference;
+    } VkPhysicalDeviceTimelineSemaphorePropertiesKHR;
+
+    typedef struct VkSemaphoreTypeCreateInfoKHR
+    {
+        VkStructureType    sType;
+        const void*        pNext;
+        VkSemaphoreTypeKHR semaphoreType;
+        uint64_t           initialValue;
+    } VkSemaphoreTypeCreateInfoKHR;
+
+    typedef struct VkTimelineSemaphoreSubmitInfoKHR
+    {
+        VkStructureType sType;
+        const void*     pNext;
+        uint32_t        waitSemaphoreValueCount;
+        const uint64_t* pWaitSemaphoreValues;
+        uint32_t        signalSemaphoreValueCount;
+        const uint64_t* pSignalSemaphoreValues;
+    } VkTimelineSemaphoreSubmitInfoKHR;
+
+    typedef struct VkSemaphoreWaitInfoKHR
+    {
+        VkStructureType         sType;
+        const void*             pNext;
+        VkSemaphoreWaitFlagsKHR flags;
+        uint32_t                semaphoreCount;
+        const VkSemaphore*      pSemaphores;
+        const uint64_t*         pValues;
+    } VkSemaphoreWaitInfoKHR;
+
+    typedef struct VkSemaphoreSignalInfoKHR
+    {
+        VkStructureType sType;
+        const void*     pNext;
+        VkSemaphore     semaphore;
+        uint64_t        value;
+    } VkSemaphoreSignalInfoKHR;
+
+    typedef VkResult (VKAPI_PTR *PFN_vkGetSemaphoreCounterValueKHR)(VkDevice device, VkSemaphore semaphore, uint64_t* pValue);
+    typedef VkResult (VKAPI_PTR *PFN_vkSignalSemaphoreKHR)         (VkDevice device, const VkSemaphoreSignalInfoKHR* pSignalInfo);
+    typedef VkResult (VKAPI_PTR *PFN_vkWaitSemaphoresKHR)          (VkDevice device, const VkSemaphoreWaitInfoKHR* pWaitInfo, uint64_t timeout);
+#endif /* !VK_KHR_timeline_semaphore */
+
+#endif /* MISC_VULKAN_COMPAT_H */
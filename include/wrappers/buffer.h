@@ -118,7 +118,8 @@ namespace Anvil
          *
          *  Sparse buffers do not support implicit bake operations yet.
          *
-         *  Note that resident sparse buffers may have multiple memory blocks assigned.
+         *  Note that resident sparse buffers may have multiple memory blocks assigned. For these, the call takes time
+         *  linear in @param in_n_memory_block. Use get_page_tracker()->get_bindings() to iterate over all of them.
          **/
         Anvil::MemoryBlock* get_memory_block(uint32_t in_n_memory_block);
 
@@ -265,6 +266,20 @@ namespace Anvil
         bool init               ();
         bool init_staging_buffer(const VkDeviceSize& in_size,
                                  Anvil::Queue*       in_opt_queue_ptr);
+
+        /** Determines which queue should be used to copy data from a staging buffer to this buffer.
+         *
+         *  @param in_opt_queue_ptr       Queue to use if the buffer is EXCLUSIVE and compatible with more than one
+         *                                queue family type. Ignored otherwise.
+         *  @param out_queue_fam_bits_ptr Deref will be set to the queue family bit corresponding to the result queue.
+         *                                Must not be nullptr.
+         *
+         *  @return Queue to use, or nullptr if the buffer is EXCLUSIVE, compatible with more than one queue family
+         *          type and @param in_opt_queue_ptr is nullptr.
+         **/
+        Anvil::Queue* get_staging_queue(Anvil::Queue*               in_opt_queue_ptr,
+                                        Anvil::QueueFamilyFlagBits* out_queue_fam_bits_ptr) const;
+
         bool set_memory_sparse  (MemoryBlock*        in_memory_block_ptr,
                                  bool                in_memory_block_owned_by_buffer,
                                  VkDeviceSize        in_memory_start_offset,
@@ -291,7 +306,12 @@ namespace Anvil
         bool                              m_prefers_dedicated_allocation;
         bool                              m_requires_dedicated_allocation;
 
-        friend class Anvil::Queue; /* set_memory_sparse() */
+        /* Global access state of the buffer, as seen by ResourceStateTracker. */
+        Anvil::ResourceAccessState m_tracked_state;
+
+        friend class Anvil::MemoryAllocator;      /* get_staging_queue() */
+        friend class Anvil::Queue;                /* set_memory_sparse() */
+        friend class Anvil::ResourceStateTracker; /* m_tracked_state     */
 
         ANVIL_DISABLE_ASSIGNMENT_OPERATOR(Buffer);
         ANVIL_DISABLE_COPY_CONSTRUCTOR(Buffer);
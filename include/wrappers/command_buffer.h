@@ -169,38 +169,6 @@ namespace Anvil
         COMMAND_BUFFER_CALLBACK_ID_COUNT
     };
 
-    /** Holds all arguments passed to a vkCmdBeginQueryIndexedEXT() command. */
-    typedef struct BeginQueryIndexedEXTCommand : public Command
-    {
-        Anvil::QueryControlFlags flags;
-        uint32_t                 index;
-        Anvil::QueryPool*        query_pool_ptr;
-        uint32_t                 query;
-
-        /** Constructor.
-         *
-         *  Arguments as per VK_EXT_transform_feedback.
-         **/
-        explicit BeginQueryIndexedEXTCommand(Anvil::QueryPool*               in_query_pool_ptr,
-                                             const uint32_t&                 in_query,
-                                             const Anvil::QueryControlFlags& in_flags,
-                                             const uint32_t&                 in_index);
-
-        /** Destructor.
-         *
-         *  Releases the encapsulated Framebuffer and RenderPass instances.
-         **/
-        virtual ~BeginQueryIndexedEXTCommand()
-         {
-             /* Stub */
-         }
-
-
-    private:
-        BeginQueryIndexedEXTCommand           (const BeginQueryIndexedEXTCommand&);
-        BeginQueryIndexedEXTCommand& operator=(const BeginQueryIndexedEXTCommand&);
-    } BeginQueryIndexedEXTCommand;
-
     /** Holds all arguments passed to a vkCmdBeginRenderPass() command. */
     typedef struct BeginRenderPassCommand : public Command
     {
@@ -298,40 +266,6 @@ namespace Anvil
         }
     } BeginRenderPassCommandRecordedCallbackData;
 
-    typedef struct BeginTransformFeedbackEXTCommand : public Command
-    {
-        std::vector<VkDeviceSize>         counter_buffer_offsets;
-        std::vector<const Anvil::Buffer*> counter_buffer_ptrs;
-        uint32_t                          first_counter_buffer;
-
-        explicit BeginTransformFeedbackEXTCommand(const uint32_t&                          in_first_counter_buffer,
-                                                  const std::vector<const Anvil::Buffer*>& in_counter_buffer_ptrs,
-                                                  const std::vector<VkDeviceSize>&         in_counter_buffer_offsets);
-
-    private:
-        BeginTransformFeedbackEXTCommand           (const BeginTransformFeedbackEXTCommand&);
-        BeginTransformFeedbackEXTCommand& operator=(const BeginTransformFeedbackEXTCommand);
-    } BeginTransformFeedbackEXTCommand;
-
-    typedef struct BindTransformFeedbackBuffersEXTCommand : public Command
-    {
-        std::vector<Anvil::Buffer*> buffer_ptrs;
-        uint32_t                    first_binding;
-        uint32_t                    n_bindings;
-        std::vector<VkDeviceSize>   offsets;
-        std::vector<VkDeviceSize>   sizes;
-
-        explicit BindTransformFeedbackBuffersEXTCommand(const uint32_t&                    in_first_binding,
-                                                        const uint32_t&                    in_n_bindings,
-                                                        const std::vector<Anvil::Buffer*>& in_buffer_ptrs,
-                                                        const std::vector<VkDeviceSize>&   in_offsets,
-                                                        const std::vector<VkDeviceSize>&   in_sizes);
-
-    private:
-        BindTransformFeedbackBuffersEXTCommand           (const BindTransformFeedbackBuffersEXTCommand&);
-        BindTransformFeedbackBuffersEXTCommand& operator=(const BindTransformFeedbackBuffersEXTCommand);
-    } BindTransformFeedbackBuffersEXTCommand;
-
     /** Holds all arguments passed to a vkCmdEndRenderPass() command. */
     typedef struct EndRenderPassCommand : public Command
     {
@@ -435,8 +369,52 @@ namespace Anvil
         void begin_debug_utils_label(const char*  in_label_name_ptr,
                                      const float* in_color_vec4_ptr);
 
+        /** Declares how commands recorded next are going to access a buffer, and records a pipeline barrier if
+         *  one is needed to make the access safe, given how the buffer has been accessed by commands recorded
+         *  earlier.
+         *
+         *  The first usage declared for a resource since recording started never results in a barrier. Instead,
+         *  the usage becomes a requirement, which Queue resolves against the state the resource is in at the time
+         *  the command buffer is submitted. Please see ResourceStateTracker documentation for more details.
+         *
+         *  Barriers are recorded with record_pipeline_barrier(), so they are subject to pipeline barrier batching.
+         *  It is an error to declare a usage which requires a barrier while a render pass is active.
+         *
+         *  @param in_buffer_ptr  Buffer to be accessed. Must not be nullptr.
+         *  @param in_stage_mask  Pipeline stages which are going to access the buffer. Must not be 0.
+         *  @param in_access_mask Types of accesses which are going to be performed.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool declare_buffer_usage(Anvil::Buffer*            in_buffer_ptr,
+                                  Anvil::PipelineStageFlags in_stage_mask,
+                                  Anvil::AccessFlags        in_access_mask);
+
+        /** Declares how commands recorded next are going to access a range of image subresources, and records
+         *  a pipeline barrier if one is needed to transition the subresources to the requested layout, or to make
+         *  the access safe.
+         *
+         *  Please see declare_buffer_usage() documentation for more details.
+         *
+         *  @param in_image_ptr         Image to be accessed. Must not be nullptr.
+         *  @param in_subresource_range Subresources to be accessed. Aspect mask is ignored, since barriers generated
+         *                              for the image always refer to all its aspects.
+         *  @param in_layout            Layout the subresources need to be in.
+         *  @param in_stage_mask        Pipeline stages which are going to access the subresources. Must not be 0.
+         *  @param in_access_mask       Types of accesses which are going to be performed.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool declare_image_usage(Anvil::Image*                       in_image_ptr,
+                                 const Anvil::ImageSubresourceRange& in_subresource_range,
+                                 Anvil::ImageLayout                  in_layout,
+                                 Anvil::PipelineStageFlags           in_stage_mask,
+                                 Anvil::AccessFlags                  in_access_mask);
+
         /* Disables internal command stashing which is enbled for builds created with
-         * STORE_COMMAND_BUFFER_COMMANDS enabled.
+         * STORE_COMMAND_BUFFER_COMMANDS enabled. Only affects command buffers created after the call.
+         *
+         * Command streams attached with set_command_stream() are not affected.
          *
          * Nop for builds that were not built with the definition enabled.
          */
@@ -472,12 +450,49 @@ namespace Anvil
             return m_type;
         }
 
+        /** Returns the command stream commands recorded into the command buffer are appended to, or nullptr
+         *  if none is attached.
+         **/
+        Anvil::CommandStream* get_command_stream() const
+        {
+            return m_command_stream_ptr;
+        }
+
+        /** Returns the number of bind and dynamic state commands which were dropped, because they would not have
+         *  changed the state of the command buffer, since recording last started.
+         *
+         *  Always returns 0 if redundant state filtering is disabled.
+         **/
+        uint32_t get_n_elided_commands() const;
+
+        /** Returns the number of pipeline barriers which were dropped, because they would not have affected
+         *  execution of the command buffer, since recording last started.
+         *
+         *  Always returns 0 if pipeline barrier batching is disabled.
+         **/
+        uint32_t get_n_dropped_pipeline_barriers() const;
+
+        /** Returns the number of record_pipeline_barrier() calls which were merged into a vkCmdPipelineBarrier()
+         *  call issued for an earlier record_pipeline_barrier() call, since recording last started.
+         *
+         *  Always returns 0 if pipeline barrier batching is disabled.
+         **/
+        uint32_t get_n_merged_pipeline_barrier_commands() const;
+
         /** Returns the parent command pool */
         Anvil::CommandPool* get_parent_command_pool() const
         {
             return m_parent_command_pool_ptr;
         }
 
+        /** Returns the tracker holding resource usages declared since recording last started, or nullptr if
+         *  no usage has been declared since the command buffer was created.
+         **/
+        Anvil::ResourceStateTracker* get_resource_state_tracker() const
+        {
+            return m_resource_state_tracker_ptr.get();
+        }
+
         /** Inserts a single queue debug label.
          *
          *  Requires VK_EXT_debug_utils support. Otherwise, the call is moot.
@@ -488,9 +503,20 @@ namespace Anvil
         void insert_debug_utils_label(const char*  in_label_name_ptr,
                                       const float* in_color_vec4_ptr);
 
-        /** Issues a vkCmdBeginQuery() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Tells whether pipeline barrier batching has been enabled for the command buffer. */
+        bool is_pipeline_barrier_batching_enabled() const
+        {
+            return (m_pipeline_barrier_batch_ptr != nullptr);
+        }
+
+        /** Tells whether redundant state filtering has been enabled for the command buffer. */
+        bool is_redundant_state_filtering_enabled() const
+        {
+            return (m_redundant_state_filter_ptr != nullptr);
+        }
+
+        /** Issues a vkCmdBeginQuery() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -503,9 +529,8 @@ namespace Anvil
                                 Anvil::QueryIndex        in_entry,
                                 Anvil::QueryControlFlags in_flags);
 
-        /** Issues a vkCmdBeginQueryIndexedEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBeginQueryIndexedEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -521,9 +546,8 @@ namespace Anvil
                                         const Anvil::QueryControlFlags& in_flags,
                                         const uint32_t&                 in_index);
 
-        /** Issues a vkCmdBeginTransformFeedbackEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBeginTransformFeedbackEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -541,9 +565,8 @@ namespace Anvil
                                                  Anvil::Buffer**     in_opt_counter_buffer_ptrs,
                                                  const VkDeviceSize* in_opt_counter_buffer_offsets);
 
-        /** Issues a vkCmdBindDescriptorSets() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBindDescriptorSets() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -560,9 +583,8 @@ namespace Anvil
                                          uint32_t                           in_dynamic_offset_count,
                                          const uint32_t*                    in_dynamic_offset_ptrs);
 
-        /** Issues a vkCmdBindIndexBuffer() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBindIndexBuffer() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -575,9 +597,8 @@ namespace Anvil
                                       VkDeviceSize     in_offset,
                                       Anvil::IndexType in_index_type);
 
-        /** Issues a vkCmdBindPipeline() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBindPipeline() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -589,9 +610,8 @@ namespace Anvil
         bool record_bind_pipeline(Anvil::PipelineBindPoint in_pipeline_bind_point,
                                   Anvil::PipelineID        in_pipeline_id);
 
-        /** Issues a vkCmdBindTransformFeedbackBuffersEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBindTransformFeedbackBuffersEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -609,9 +629,8 @@ namespace Anvil
                                                         const VkDeviceSize* in_offsets_ptr,
                                                         const VkDeviceSize* in_sizes_ptr);
 
-        /** Issues a vkCmdBindVertexBuffers() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBindVertexBuffers() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -625,9 +644,8 @@ namespace Anvil
                                         Anvil::Buffer**     in_buffer_ptrs,
                                         const VkDeviceSize* in_offset_ptrs);
 
-        /** Issues a vkCmdBlitImage() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBlitImage() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -647,9 +665,8 @@ namespace Anvil
                                const Anvil::ImageBlit* in_region_ptrs,
                                Anvil::Filter           in_filter);
 
-        /** Issues a vkCmdClearAttachments() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdClearAttachments() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -666,9 +683,8 @@ namespace Anvil
                                       uint32_t                      in_n_rects,
                                       const VkClearRect*            in_rect_ptrs);
 
-        /** Issues a vkCmdClearColorImage() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdClearColorImage() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -686,9 +702,8 @@ namespace Anvil
                                       uint32_t                            in_range_count,
                                       const Anvil::ImageSubresourceRange* in_range_ptrs);
 
-        /** Issues a vkCmdClearDepthStencilImage() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdClearDepthStencilImage() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -706,9 +721,8 @@ namespace Anvil
                                               uint32_t                            in_range_count,
                                               const Anvil::ImageSubresourceRange* in_range_ptrs);
 
-        /** Issues a vkCmdCopyBuffer() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdCopyBuffer() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -725,9 +739,8 @@ namespace Anvil
                                 uint32_t                 in_region_count,
                                 const Anvil::BufferCopy* in_region_ptrs);
 
-        /** Issues a vkCmdCopyBufferToImage() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdCopyBufferToImage() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -745,9 +758,8 @@ namespace Anvil
                                          uint32_t                      in_region_count,
                                          const Anvil::BufferImageCopy* in_region_ptrs);
 
-        /** Issues a vkCmdCopyImage() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdCopyImage() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -766,9 +778,8 @@ namespace Anvil
                                uint32_t                in_region_count,
                                const Anvil::ImageCopy* in_region_ptrs);
 
-        /** Issues a vkCmdCopyImageToBuffer() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdCopyImageToBuffer() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -786,9 +797,8 @@ namespace Anvil
                                          uint32_t                      in_region_count,
                                          const Anvil::BufferImageCopy* in_region_ptrs);
 
-        /** Issues a vkCmdCopyQueryPoolResults() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdCopyQueryPoolResults() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -808,9 +818,8 @@ namespace Anvil
                                             VkDeviceSize       in_dst_stride,
                                             VkQueryResultFlags in_flags);
 
-        /** Issues a vkCmdDebugMarkerBeginEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDebugMarkerBeginEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -822,9 +831,8 @@ namespace Anvil
         bool record_debug_marker_begin_EXT(const std::string& in_marker_name,
                                            const float*       in_opt_color);
 
-        /** Issues a vkCmdDebugMarkerEndEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDebugMarkerEndEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -835,9 +843,8 @@ namespace Anvil
          **/
         bool record_debug_marker_end_EXT();
 
-        /** Issues a vkCmdDebugMarkerInsertEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDebugMarkerInsertEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -849,9 +856,8 @@ namespace Anvil
         bool record_debug_marker_insert_EXT(const std::string& in_marker_name,
                                             const float*       in_opt_color);
 
-        /** Issues a vkCmdDispatch() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDispatch() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -867,9 +873,8 @@ namespace Anvil
                              uint32_t in_y,
                              uint32_t in_z);
 
-        /** Issues a vkCmdDispatchBaseKHR() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDispatchBaseKHR() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -890,9 +895,8 @@ namespace Anvil
                                       uint32_t in_group_count_y,
                                       uint32_t in_group_count_z);
 
-        /** Issues a vkCmdDispatchIndirect() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDispatchIndirect() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -907,9 +911,8 @@ namespace Anvil
         bool record_dispatch_indirect(Anvil::Buffer* in_buffer_ptr,
                                       VkDeviceSize   in_offset);
 
-        /** Issues a vkCmdDraw() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDraw() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -926,9 +929,8 @@ namespace Anvil
                          uint32_t in_first_vertex,
                          uint32_t in_first_instance);
 
-        /** Issues a vkCmdDrawIndexed() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDrawIndexed() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -946,9 +948,8 @@ namespace Anvil
                                  int32_t  in_vertex_offset,
                                  uint32_t in_first_instance);
 
-        /** Issues a vkCmdDrawIndexedIndirect() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDrawIndexedIndirect() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -965,9 +966,8 @@ namespace Anvil
                                           uint32_t       in_draw_count,
                                           uint32_t       in_stride);
 
-        /** Issues a vkCmdDrawIndexedIndirectCountAMD() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDrawIndexedIndirectCountAMD() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -989,9 +989,8 @@ namespace Anvil
                                                     uint32_t       in_max_draw_count,
                                                     uint32_t       in_stride);
 
-        /** Issues a vkCmdDrawIndexedIndirectCountKHR() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDrawIndexedIndirectCountKHR() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1013,9 +1012,8 @@ namespace Anvil
                                                     uint32_t       in_max_draw_count,
                                                     uint32_t       in_stride);
 
-        /** Issues a vkCmdDrawIndirect() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDrawIndirect() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1032,9 +1030,8 @@ namespace Anvil
                                   uint32_t       in_count,
                                   uint32_t       in_stride);
 
-        /** Issues a vkCmdDrawIndirectByteCountEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDrawIndirectByteCountEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1056,9 +1053,8 @@ namespace Anvil
                                                  const uint32_t&     in_counter_offset,
                                                  const uint32_t&     in_vertex_stride);
 
-        /** Issues a vkCmdDrawIndirectCount() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDrawIndirectCount() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1080,9 +1076,8 @@ namespace Anvil
                                             uint32_t       in_max_draw_count,
                                             uint32_t       in_stride);
 
-        /** Issues a vkCmdDrawIndirectCount() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdDrawIndirectCount() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1104,9 +1099,8 @@ namespace Anvil
                                             uint32_t       in_max_draw_count,
                                             uint32_t       in_stride);
 
-        /** Issues a vkCmdEndQuery() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdEndQuery() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1118,9 +1112,8 @@ namespace Anvil
         bool record_end_query(Anvil::QueryPool* in_query_pool_ptr,
                               Anvil::QueryIndex in_entry);
 
-        /** Issues a vkCmdEndQueryIndexedEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdEndQueryIndexedEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1135,9 +1128,8 @@ namespace Anvil
                                           const Anvil::QueryIndex& in_query,
                                           const uint32_t&          in_index);
 
-        /** Issues a vkCmdEndTransformFeedbackEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdEndTransformFeedbackEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1155,9 +1147,8 @@ namespace Anvil
                                                Anvil::Buffer**     in_opt_counter_buffer_ptrs,
                                                const VkDeviceSize* in_opt_counter_buffer_offsets);
 
-        /** Issues a vkCmdFillBuffer() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdFillBuffer() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1174,9 +1165,12 @@ namespace Anvil
                                 VkDeviceSize   in_size,
                                 uint32_t       in_data);
 
-        /** Issues a vkCmdPipelineBarrier() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdPipelineBarrier() call and appends it to the command stream attached
+         *  to the command buffer, if any.
+         *
+         *  If pipeline barrier batching is enabled and no render pass is active, the barriers are
+         *  deferred until another command is recorded, and may be merged with barriers specified
+         *  by subsequent calls. The call is appended to the command stream right away.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1195,9 +1189,8 @@ namespace Anvil
                                      uint32_t                   in_image_memory_barrier_count,
                                      const ImageBarrier*  const in_image_memory_barriers_ptr);
 
-        /** Issues a vkCmdPushConstants() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdPushConstants() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1212,9 +1205,8 @@ namespace Anvil
                                    uint32_t                in_size,
                                    const void*             in_values);
 
-        /** Issues a vkCmdResetEvent() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdResetEvent() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1229,9 +1221,8 @@ namespace Anvil
         bool record_reset_event(Anvil::Event*             in_event_ptr,
                                 Anvil::PipelineStageFlags in_stage_mask);
 
-        /** Issues a vkCmdResetQueryPool() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdResetQueryPool() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1247,9 +1238,8 @@ namespace Anvil
                                      Anvil::QueryIndex in_start_query,
                                      uint32_t          in_query_count);
 
-        /** Issues a vkCmdResolveImage() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdResolveImage() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1268,9 +1258,8 @@ namespace Anvil
                                   uint32_t                   in_region_count,
                                   const Anvil::ImageResolve* in_region_ptrs);
 
-        /** Issues a vkCmdSetBlendConstants() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetBlendConstants() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1281,9 +1270,8 @@ namespace Anvil
          **/
         bool record_set_blend_constants(const float in_blend_constants[4]);
 
-        /** Issues a vkCmdSetDepthBias() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetDepthBias() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1296,9 +1284,8 @@ namespace Anvil
                                    float in_depth_bias_clamp,
                                    float in_slope_scaled_depth_bias);
 
-        /** Issues a vkCmdSetDepthBounds() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetDepthBounds() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1310,9 +1297,8 @@ namespace Anvil
         bool record_set_depth_bounds(float in_min_depth_bounds,
                                      float in_max_depth_bounds);
 
-        /** Issues a vkCmdSetDeviceMaskKHR() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetDeviceMaskKHR() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1325,9 +1311,8 @@ namespace Anvil
          **/
         bool record_set_device_mask_KHR(uint32_t in_device_mask);
 
-        /** Issues a vkCmdSetEvent() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetEvent() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1342,9 +1327,8 @@ namespace Anvil
         bool record_set_event(Anvil::Event*             in_event_ptr,
                               Anvil::PipelineStageFlags in_stage_mask);
 
-        /** Issues a vkCmdSetLineWidth() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetLineWidth() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1355,9 +1339,8 @@ namespace Anvil
          **/
         bool record_set_line_width(float in_line_width);
 
-        /** Issues a vkCmdSetSampleLocationsEXT() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetSampleLocationsEXT() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1370,9 +1353,8 @@ namespace Anvil
          **/
         bool record_set_sample_locations_EXT(const Anvil::SampleLocationsInfo& in_sample_locations_info);
 
-        /** Issues a vkCmdSetScissor() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetScissor() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1385,9 +1367,8 @@ namespace Anvil
                                 uint32_t        in_scissor_count,
                                 const VkRect2D* in_scissor_ptrs);
 
-        /** Issues a vkCmdSetStencilCompareMask() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetStencilCompareMask() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1399,9 +1380,8 @@ namespace Anvil
         bool record_set_stencil_compare_mask(Anvil::StencilFaceFlags in_face_mask,
                                              uint32_t                in_stencil_compare_mask);
 
-        /** Issues a vkCmdSetStencilReference() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetStencilReference() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1413,9 +1393,8 @@ namespace Anvil
         bool record_set_stencil_reference(Anvil::StencilFaceFlags in_face_mask,
                                           uint32_t                in_stencil_reference);
 
-        /** Issues a vkCmdSetStencilWriteMask() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetStencilWriteMask() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1427,9 +1406,8 @@ namespace Anvil
         bool record_set_stencil_write_mask(Anvil::StencilFaceFlags in_face_mask,
                                            uint32_t                in_stencil_write_mask);
 
-        /** Issues a vkCmdSetViewport() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdSetViewport() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1442,9 +1420,8 @@ namespace Anvil
                                  uint32_t          in_viewport_count,
                                  const VkViewport* in_viewport_ptrs);
 
-        /** Issues a vkCmdUpdateBuffer() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdUpdateBuffer() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1462,9 +1439,8 @@ namespace Anvil
                                   const void*    in_data_ptr);
 
 
-        /** Issues a vkCmdWaitEvents() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdWaitEvents() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1484,9 +1460,8 @@ namespace Anvil
                                 uint32_t                   in_image_memory_barrier_count,
                                 const ImageBarrier* const  in_image_memory_barriers_ptr);
 
-        /** Issues a vkCmdWriteBufferMarkerAMD() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdWriteBufferMarkerAMD() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1502,9 +1477,8 @@ namespace Anvil
                                             const VkDeviceSize&                 in_dst_offset,
                                             const uint32_t&                     in_marker);
 
-        /** Issues a vkCmdWriteTimestamp() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdWriteTimestamp() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -1517,8 +1491,8 @@ namespace Anvil
                                     Anvil::QueryPool*            in_query_pool_ptr,
                                     Anvil::QueryIndex            in_entry);
 
-        /** Resets the underlying Vulkan command buffer and clears the internally managed vector of
-         *  recorded commands, if STORE_COMMAND_BUFFER_COMMANDS has been defined for the build.
+        /** Resets the underlying Vulkan command buffer and clears the internally owned command stream,
+         *  if STORE_COMMAND_BUFFER_COMMANDS has been defined for the build.
          *
          *  @param in_should_release_resources true if the vkResetCommandBuffer() should be made with the
          *                                     VK_CMD_BUFFER_RESET_RELEASE_RESOURCES_BIT flag set.
@@ -1527,6 +1501,56 @@ namespace Anvil
          **/
         bool reset(bool in_should_release_resources);
 
+        /** Attaches a command stream to the command buffer. All commands subsequently recorded into the command
+         *  buffer are going to be appended to the stream, in addition to being recorded into the Vulkan command buffer.
+         *
+         *  The command buffer neither takes ownership of the stream, nor clears it when the command buffer is reset
+         *  or starts recording again. The stream must stay alive until it is detached or the command buffer is released.
+         *
+         *  In builds with STORE_COMMAND_BUFFER_COMMANDS defined, command buffers come with an internally owned
+         *  stream attached, unless command stashing has been disabled. Attaching another stream replaces it.
+         *
+         *  @param in_opt_command_stream_ptr Stream to append commands to, or nullptr to stop capturing commands.
+         **/
+        void set_command_stream(Anvil::CommandStream* in_opt_command_stream_ptr)
+        {
+            m_command_stream_ptr = in_opt_command_stream_ptr;
+        }
+
+        /** Enables or disables pipeline barrier batching for the command buffer. Disabled by default.
+         *
+         *  When enabled, barriers specified by consecutive record_pipeline_barrier() calls are accumulated and
+         *  issued with a single vkCmdPipelineBarrier() call, whose stage masks are the union of the masks specified
+         *  for the merged calls. Pending barriers are flushed right before any other command is recorded, and when
+         *  recording stops. Barriers recorded while a render pass is active are never deferred, since they need to
+         *  match the subpass self-dependency.
+         *
+         *  Barriers which neither transition image layout, nor transfer queue family ownership, nor specify any
+         *  access masks are dropped. Please see PipelineBarrierBatch documentation for details on when barriers
+         *  can be merged.
+         *
+         *  Disabling the batching while recording is in progress flushes all pending barriers.
+         *
+         *  @param in_enabled true to enable the batching, false to disable it.
+         **/
+        void set_pipeline_barrier_batching_enabled(bool in_enabled);
+
+        /** Enables or disables redundant state filtering for the command buffer. Disabled by default.
+         *
+         *  When enabled, the command buffer shadows the state set by record_bind_pipeline(), record_bind_descriptor_sets(),
+         *  record_bind_vertex_buffers(), record_set_viewport(), record_set_scissor() and record_push_constants(). Calls
+         *  which would not change that state are dropped: they are neither recorded into the Vulkan command buffer, nor
+         *  appended to the attached command stream. Such calls still return true.
+         *
+         *  The shadowed state is forgotten whenever the command buffer starts recording, is reset, or executes
+         *  secondary command buffers. It is also safe to enable the filtering while recording is in progress.
+         *
+         *  Please see RedundantStateFilter documentation for details on how the state is tracked.
+         *
+         *  @param in_enabled true to enable the filtering, false to disable it.
+         **/
+        void set_redundant_state_filtering_enabled(bool in_enabled);
+
         /** Stops an ongoing command recording process.
          *
          *  It is an error to invoke this function if the command buffer has not been put
@@ -1537,1381 +1561,6 @@ namespace Anvil
         bool stop_recording();
 
     protected:
-        /* Forward declarations */
-        struct BeginQueryCommand;
-        struct BindDescriptorSetsCommand;
-        struct BindIndexBufferCommand;
-        struct BindPipelineCommand;
-        struct BindVertexBuffersCommand;
-        struct BlitImageCommand;
-        struct ClearAttachmentsCommand;
-        struct ClearColorImageCommand;
-        struct ClearDepthStencilImageCommand;
-        struct CopyBufferCommand;
-        struct CopyBufferToImageCommand;
-        struct CopyImageCommand;
-        struct CopyImageToBufferCommand;
-        struct CopyQueryPoolResultsCommand;
-        struct DebugMarkerBeginEXTCommand;
-        struct DebugMarkerEndEXTCommand;
-        struct DispatchCommand;
-        struct DispatchIndirectCommand;
-        struct DrawCommand;
-        struct DrawIndexedCommand;
-        struct DrawIndirectCommand;
-        struct DrawIndexedIndirectCommand;
-        struct EndQueryCommand;
-        struct EndQueryIndexedEXTCommand;
-        struct ExecuteCommandsCommand;
-        struct FillBufferCommand;
-        struct NextSubpassCommand;
-        struct PushConstantsCommand;
-        struct ResetEventCommand;
-        struct ResetQueryPoolCommand;
-        struct ResolveImageCommand;
-        struct SetBlendConstantsCommand;
-        struct SetDepthBiasCommand;
-        struct SetDepthBoundsCommand;
-        struct SetEventCommand;
-        struct SetLineWidthCommand;
-        struct SetSampleLocationsEXTCommand;
-        struct SetScissorCommand;
-        struct SetStencilCompareMaskCommand;
-        struct SetStencilReferenceCommand;
-        struct SetStencilWriteMaskCommand;
-        struct SetViewportCommand;
-        struct UpdateBufferCommand;
-        struct WaitEventsCommand;
-        struct WriteTimestampCommand;
-
-        /* Protected type definitions */
-
-        /** Holds all arguments passed to a vkCmdBeginQuery() command */
-        typedef struct BeginQueryCommand : public Command
-        {
-            Anvil::QueryControlFlags flags;
-
-            Anvil::QueryIndex entry;
-            Anvil::QueryPool* query_pool_ptr;
-
-            /** Constructor. */
-            explicit BeginQueryCommand(Anvil::QueryPool*        in_query_pool_ptr,
-                                       Anvil::QueryIndex        in_entry,
-                                       Anvil::QueryControlFlags in_flags);
-
-            /** Destructor. */
-            virtual ~BeginQueryCommand()
-            {
-                /* Stub */
-            }
-        } BeginQueryCommand;
-
-        /** Holds all arguments passed to a vkCmdBindDescriptorSets() command. */
-        typedef struct BindDescriptorSetsCommand : public Command
-        {
-            std::vector<const Anvil::DescriptorSet*> descriptor_sets;
-            std::vector<uint32_t>                    dynamic_offsets;
-            uint32_t                                 first_set;
-            Anvil::PipelineLayout*                   layout_ptr;
-            Anvil::PipelineBindPoint                 pipeline_bind_point;
-
-            /** Constructor. **/
-            explicit BindDescriptorSetsCommand(Anvil::PipelineBindPoint           in_pipeline_bind_point,
-                                               Anvil::PipelineLayout*             in_layout_ptr,
-                                               uint32_t                           in_first_set,
-                                               uint32_t                           in_set_count,
-                                               const Anvil::DescriptorSet* const* in_descriptor_set_ptrs,
-                                               uint32_t                           in_dynamic_offset_count,
-                                               const uint32_t*                    in_dynamic_offset_ptrs);
-
-            /** Destructor. */
-            virtual ~BindDescriptorSetsCommand()
-            {
-                /* Stub */
-            }
-
-        } BindDescriptorSetsCommand;
-
-
-        /** Holds all arguments passed to a vkCmdBindIndexBuffer() command. */
-        typedef struct BindIndexBufferCommand : public Command
-        {
-            VkBuffer         buffer;
-            Anvil::Buffer*   buffer_ptr;
-            Anvil::IndexType index_type;
-            VkDeviceSize     offset;
-
-            /** Constructor. **/
-            explicit BindIndexBufferCommand(Anvil::Buffer*   in_buffer_ptr,
-                                            VkDeviceSize     in_offset,
-                                            Anvil::IndexType in_index_type);
-
-            /** Destructor. */
-            virtual ~BindIndexBufferCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            BindIndexBufferCommand& operator=(const BindIndexBufferCommand&);
-        } BindIndexBufferCommand;
-
-
-        /** Holds all arguments passed to a vkCmdBindPipeline() command. */
-        typedef struct BindPipelineCommand : public Command
-        {
-            Anvil::PipelineBindPoint pipeline_bind_point;
-            Anvil::PipelineID        pipeline_id;
-
-            /** Constructor.
-             *
-             *  @param in_pipeline_bind_point As per Vulkan API.
-             *  @param in_pipeline_id         ID of the pipeline. Can either be a compute pipeline ID, coming from
-             *                                the device-specific compute pipeline manager initialized by the library,
-             *                                or a graphics pipeline ID, coming from the device-specific graphics pipeline
-             *                                manager. The type of the pipeline is deduced from @param in_pipeline_bind_point.
-             **/
-            explicit BindPipelineCommand(Anvil::PipelineBindPoint in_pipeline_bind_point,
-                                         Anvil::PipelineID        in_pipeline_id);
-
-            /* Destructor. */
-            virtual ~BindPipelineCommand()
-            {
-                 /* Stub */
-            }
-        } BindPipelineCommand;
-
-
-        /** Holds a single vertex buffer binding, as specified by "in_buffer_ptrs" and "in_offset_ptrs"
-         *  argment arrays, passed to a vkCmdBindVertexBuffers() call.
-         **/
-        typedef struct BindVertexBuffersCommandBinding
-        {
-            VkBuffer       buffer;
-            Anvil::Buffer* buffer_ptr;
-            VkDeviceSize   offset;
-
-            /** Constructor. **/
-            explicit BindVertexBuffersCommandBinding(Anvil::Buffer* in_buffer_ptr,
-                                                     VkDeviceSize   in_offset);
-
-            /** Destructor. */
-            virtual ~BindVertexBuffersCommandBinding()
-            {
-                /* Stub */
-            }
-
-            BindVertexBuffersCommandBinding(const BindVertexBuffersCommandBinding& in);
-
-        private:
-            BindVertexBuffersCommandBinding& operator=(const BindVertexBuffersCommandBinding&);
-        } BindVertexBuffersCommandBinding;
-
-        /** Holds all arguments passed to a vkCmdBindVertexBuffers() command. */
-        typedef struct BindVertexBuffersCommand : public Command
-        {
-            std::vector<BindVertexBuffersCommandBinding> bindings;
-            uint32_t                                     start_binding;
-
-            /** Constructor. **/
-            explicit BindVertexBuffersCommand(uint32_t            in_start_binding,
-                                              uint32_t            in_binding_count,
-                                              Anvil::Buffer**     in_buffer_ptrs,
-                                              const VkDeviceSize* in_offset_ptrs);
-
-            /** Destructor. */
-            virtual ~BindVertexBuffersCommand()
-            {
-                /* Stub */
-            }
-        } BindVertexBuffersCommand;
-
-        /** Holds all arguments passed to a vkCmdBlitImage() command. */
-        typedef struct BlitImageCommand : public Command
-        {
-            VkImage            dst_image;
-            Anvil::ImageLayout dst_image_layout;
-            Anvil::Image*      dst_image_ptr;
-            VkImage            src_image;
-            Anvil::ImageLayout src_image_layout;
-            Anvil::Image*      src_image_ptr;
-
-            Anvil::Filter                 filter;
-            std::vector<Anvil::ImageBlit> regions;
-
-            /** Constructor. */
-            explicit BlitImageCommand(Anvil::Image*           in_src_image_ptr,
-                                      Anvil::ImageLayout      in_src_image_layout,
-                                      Anvil::Image*           in_dst_image_ptr,
-                                      Anvil::ImageLayout      in_dst_image_layout,
-                                      uint32_t                in_region_count,
-                                      const Anvil::ImageBlit* in_region_ptrs,
-                                      Anvil::Filter           in_filter);
-
-            /** Destructor. */
-            virtual ~BlitImageCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            BlitImageCommand& operator=(const BlitImageCommand&);
-        } BlitImageCommand;
-
-
-        /* Holds a single attachment definition, as used by ClearAttachmentsCommand descriptor */
-        typedef struct ClearAttachmentsCommandAttachment
-        {
-            Anvil::ImageAspectFlags aspect_mask;
-
-            VkClearValue clear_value;
-            uint32_t     color_attachment;
-
-            /** Constructor. **/
-            ClearAttachmentsCommandAttachment(Anvil::ImageAspectFlags in_aspect_mask,
-                                              VkClearValue            in_clear_value,
-                                              uint32_t                in_color_attachment)
-            {
-                aspect_mask      = in_aspect_mask;
-                clear_value      = in_clear_value;
-                color_attachment = in_color_attachment;
-            }
-
-            /** Destructor. */
-            virtual ~ClearAttachmentsCommandAttachment()
-            {
-                /* Stub */
-            }
-        } ClearAttachmentsCommandAttachment;
-
-        /** Holds all arguments passed to a vkCmdClearAttachments() command. */
-        typedef struct ClearAttachmentsCommand : public Command
-        {
-            std::vector<ClearAttachmentsCommandAttachment> attachments;
-            std::vector<VkClearRect>                       rects;
-
-            /* Constructor. **/
-            explicit ClearAttachmentsCommand(uint32_t                      in_n_attachments,
-                                             const Anvil::ClearAttachment* in_attachments,
-                                             uint32_t                      in_n_rects,
-                                             const VkClearRect*            in_rect_ptrs);
-
-            /** Destructor. */
-            virtual ~ClearAttachmentsCommand()
-            {
-                /* Stub */
-            }
-        } ClearAttachmentsCommand;
-
-
-        /** Holds all arguments passed to a vkCmdClearColorImage() command. */
-        typedef struct ClearColorImageCommand : public Command
-        {
-            VkClearColorValue                         color;
-            VkImage                                   image;
-            Anvil::ImageLayout                        image_layout;
-            Anvil::Image*                             image_ptr;
-            std::vector<Anvil::ImageSubresourceRange> ranges;
-
-            /** Constructor. **/
-            explicit ClearColorImageCommand(Anvil::Image*                       in_image_ptr,
-                                            Anvil::ImageLayout                  in_image_layout,
-                                            const VkClearColorValue*            in_color_ptr,
-                                            uint32_t                            in_range_count,
-                                            const Anvil::ImageSubresourceRange* in_range_ptrs);
-
-            /** Destructor. */
-            virtual ~ClearColorImageCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            ClearColorImageCommand& operator=(const ClearColorImageCommand& in);
-        } ClearColorImageCommand;
-
-
-        /** Holds all arguments passed to a vkCmdClearDepthStencilImage() command. */
-        typedef struct ClearDepthStencilImageCommand : public Command
-        {
-            VkClearDepthStencilValue                  depth_stencil;
-            VkImage                                   image;
-            Anvil::ImageLayout                        image_layout;
-            Anvil::Image*                             image_ptr;
-            std::vector<Anvil::ImageSubresourceRange> ranges;
-
-            /** Constructor. **/
-            explicit ClearDepthStencilImageCommand(Anvil::Image*                       in_image_ptr,
-                                                   Anvil::ImageLayout                  in_image_layout,
-                                                   const VkClearDepthStencilValue*     in_depth_stencil_ptr,
-                                                   uint32_t                            in_range_count,
-                                                   const Anvil::ImageSubresourceRange* in_range_ptrs);
-
-            /** Destructor. */
-            virtual ~ClearDepthStencilImageCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            ClearDepthStencilImageCommand& operator=(const ClearDepthStencilImageCommand& in);
-        } ClearDepthStencilImageCommand;
-
-
-        /** Holds all arguments passed to a vkCmdCopyBuffer() command. */
-        typedef struct CopyBufferCommand : public Command
-        {
-            VkBuffer                       dst_buffer;
-            Anvil::Buffer*                 dst_buffer_ptr;
-            std::vector<Anvil::BufferCopy> regions;
-            VkBuffer                       src_buffer;
-            Anvil::Buffer*                 src_buffer_ptr;
-
-            /** Constructor. **/
-            explicit CopyBufferCommand(Anvil::Buffer*           in_src_buffer_ptr,
-                                       Anvil::Buffer*           in_dst_buffer_ptr,
-                                       uint32_t                 in_region_count,
-                                       const Anvil::BufferCopy* in_region_ptrs);
-
-            /** Destructor. */
-            virtual ~CopyBufferCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            CopyBufferCommand& operator=(const CopyBufferCommand&);
-        } CopyBufferCommand;
-
-
-        /** Holds all arguments passed to a vkCmdCopyBufferToImage() command. */
-        typedef struct CopyBufferToImageCommand : public Command
-        {
-            VkImage                             dst_image;
-            Anvil::ImageLayout                  dst_image_layout;
-            Anvil::Image*                       dst_image_ptr;
-            std::vector<Anvil::BufferImageCopy> regions;
-            VkBuffer                            src_buffer;
-            Anvil::Buffer*                      src_buffer_ptr;
-
-            /** Constructor. **/
-            explicit CopyBufferToImageCommand(Anvil::Buffer*                in_src_buffer_ptr,
-                                              Anvil::Image*                 in_dst_image_ptr,
-                                              Anvil::ImageLayout            in_dst_image_layout,
-                                              uint32_t                      in_region_count,
-                                              const Anvil::BufferImageCopy* in_region_ptrs);
-
-            /** Destructor. */
-            virtual ~CopyBufferToImageCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            CopyBufferToImageCommand& operator=(const CopyBufferToImageCommand&);
-
-        } CopyBufferToImageCommand;
-
-
-        /** Holds all arguments passed to a vkCmdCopyImage() command. */
-        typedef struct CopyImageCommand : public Command
-        {
-            VkImage                       dst_image;
-            Anvil::Image*                 dst_image_ptr;
-            Anvil::ImageLayout            dst_image_layout;
-            std::vector<Anvil::ImageCopy> regions;
-            VkImage                       src_image;
-            Anvil::Image*                 src_image_ptr;
-            Anvil::ImageLayout            src_image_layout;
-
-            /** Constructor. **/
-            explicit CopyImageCommand(Anvil::Image*           in_src_image_ptr,
-                                      Anvil::ImageLayout      in_src_image_layout,
-                                      Anvil::Image*           in_dst_image_ptr,
-                                      Anvil::ImageLayout      in_dst_image_layout,
-                                      uint32_t                in_region_count,
-                                      const Anvil::ImageCopy* in_region_ptrs);
-
-            /** Destructor. */
-            virtual ~CopyImageCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            CopyImageCommand& operator=(const CopyImageCommand&);
-        } CopyImageCommand;
-
-
-        /** Holds all arguments passed to a vkCmdCopyImageToBuffer() command. */
-        typedef struct CopyImageToBufferCommand : public Command
-        {
-            VkBuffer                            dst_buffer;
-            Anvil::Buffer*                      dst_buffer_ptr;
-            std::vector<Anvil::BufferImageCopy> regions;
-            VkImage                             src_image;
-            Anvil::ImageLayout                  src_image_layout;
-            Anvil::Image*                       src_image_ptr;
-
-            /** Constructor. **/
-            explicit CopyImageToBufferCommand(Anvil::Image*                 in_src_image_ptr,
-                                              Anvil::ImageLayout            in_src_image_layout,
-                                              Anvil::Buffer*                in_dst_buffer_ptr,
-                                              uint32_t                      in_region_count,
-                                              const Anvil::BufferImageCopy* in_region_ptrs);
-
-            /** Destructor. */
-            virtual ~CopyImageToBufferCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            CopyImageToBufferCommand& operator=(const CopyImageToBufferCommand&);
-        } CopyImageToBufferCommand;
-
-
-        /** Holds all arguments passed to a vkCmdCopyQueryPoolResults() command. */
-        typedef struct CopyQueryPoolResultsCommand : public Command
-        {
-            VkQueryResultFlags flags;
-
-            VkBuffer          dst_buffer;
-            Anvil::Buffer*    dst_buffer_ptr;
-            VkDeviceSize      dst_offset;
-            VkDeviceSize      dst_stride;
-            uint32_t          query_count;
-            Anvil::QueryPool* query_pool_ptr;
-            Anvil::QueryIndex start_query;
-
-            /** Constructor. **/
-            explicit CopyQueryPoolResultsCommand(Anvil::QueryPool*  in_query_pool_ptr,
-                                                 Anvil::QueryIndex  in_start_query,
-                                                 uint32_t           in_query_count,
-                                                 Anvil::Buffer*     in_dst_buffer_ptr,
-                                                 VkDeviceSize       in_dst_offset,
-                                                 VkDeviceSize       in_dst_stride,
-                                                 VkQueryResultFlags in_flags);
-
-            /** Destructor. */
-            virtual ~CopyQueryPoolResultsCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            CopyQueryPoolResultsCommand& operator=(const CopyQueryPoolResultsCommand&);
-        } CopyQueryPoolResultsCommand;
-
-        /** Holds all arguments passed to a vkCmdDebugMarkerBeginEXT() command. */
-        typedef struct DebugMarkerBeginEXTCommand : public Command
-        {
-            float       color[4];
-            std::string marker_name;
-
-            /** Constructor. */
-            explicit DebugMarkerBeginEXTCommand(const std::string& in_marker_name,
-                                                const float*       in_color);
-
-            /* Destructor */
-            virtual ~DebugMarkerBeginEXTCommand()
-            {
-                /* Stub */
-            }
-        } DebugMarkerBeginEXTCommand;
-
-        /** Holds all arguments passed to a vkCmdDebugMarkerEndEXT() command. */
-        typedef struct DebugMarkerEndEXTCommand : public Command
-        {
-            /* Constructor. */
-            explicit DebugMarkerEndEXTCommand();
-
-            /* Destructor. */
-            virtual ~DebugMarkerEndEXTCommand()
-            {
-                /* Stub */
-            }
-        } DebugMarkerEndEXTCommand;
-
-        /** Holds all arguments passed to a vkCmdDebugMarkerInsertEXT() command. */
-        typedef struct DebugMarkerInsertEXTCommand : public Command
-        {
-            float       color[4];
-            std::string marker_name;
-
-            /** Constructor. */
-            explicit DebugMarkerInsertEXTCommand(const std::string& in_marker_name,
-                                                 const float*       in_color);
-
-            /* Destructor. */
-            virtual ~DebugMarkerInsertEXTCommand()
-            {
-            }
-        } DebugMarkerInsertEXTCommand;
-
-        /** Holds all arguments passed to a vkCmdDispatch() command. */
-        typedef struct DispatchCommand : public Command
-        {
-            uint32_t x;
-            uint32_t y;
-            uint32_t z;
-
-            /** Constructor. **/
-            explicit DispatchCommand(uint32_t in_x,
-                                     uint32_t in_y,
-                                     uint32_t in_z);
-
-            /** Destructor. */
-            virtual ~DispatchCommand()
-            {
-                /* Stub */
-            }
-        } DispatchCommand;
-
-
-        /** Holds all arguments passed to a vkCmdDispatchBaseKHR() command. */
-        typedef struct DispatchBaseKHRCommand : public Command
-        {
-            uint32_t base_group_x;
-            uint32_t base_group_y;
-            uint32_t base_group_z;
-            uint32_t group_count_x;
-            uint32_t group_count_y;
-            uint32_t group_count_z;
-
-            /** Constructor. **/
-            explicit DispatchBaseKHRCommand(uint32_t in_base_group_x,
-                                            uint32_t in_base_group_y,
-                                            uint32_t in_base_group_z,
-                                            uint32_t in_group_count_x,
-                                            uint32_t in_group_count_y,
-                                            uint32_t in_group_count_z);
-
-            /** Destructor. */
-            virtual ~DispatchBaseKHRCommand()
-            {
-                /* Stub */
-            }
-        } DispatchBaseKHRCommand;
-
-
-        /** Holds all arguments passed to a vkCmdDispatchIndirect() command. */
-        typedef struct DispatchIndirectCommand : public Command
-        {
-            VkBuffer       buffer;
-            Anvil::Buffer* buffer_ptr;
-            VkDeviceSize   offset;
-
-            /** Constructor. **/
-            explicit DispatchIndirectCommand(Anvil::Buffer* in_buffer_ptr,
-                                             VkDeviceSize   in_offset);
-
-            /** Destructor. */
-            virtual ~DispatchIndirectCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            DispatchIndirectCommand& operator=(const DispatchIndirectCommand&);
-        } DispatchIndirectCommand;
-
-
-        /** Holds all arguments passed to a vkCmdDraw() command. */
-        typedef struct DrawCommand : public Command
-        {
-            uint32_t first_instance;
-            uint32_t first_vertex;
-            uint32_t instance_count;
-            uint32_t vertex_count;
-
-            /** Constructor.
-             *
-             *  Arguments as per Vulkan API.
-             **/
-            explicit DrawCommand(uint32_t in_vertex_count,
-                                 uint32_t in_instance_count,
-                                 uint32_t in_first_vertex,
-                                 uint32_t in_first_instance);
-
-            /** Destructor. */
-            virtual ~DrawCommand()
-            {
-                /* Stub */
-            }
-        } DrawCommand;
-
-
-        /** Holds all arguments passed to a vkCmdDrawIndexed() command. */
-        typedef struct DrawIndexedCommand : public Command
-        {
-            uint32_t first_index;
-            uint32_t first_instance;
-            uint32_t index_count;
-            uint32_t instance_count;
-            int32_t  vertex_offset;
-
-            /** Constructor. **/
-            explicit DrawIndexedCommand(uint32_t in_index_count,
-                                        uint32_t in_instance_count,
-                                        uint32_t in_first_index,
-                                        int32_t  in_vertex_offset,
-                                        uint32_t in_first_instance);
-
-            /** Destructor. */
-            virtual ~DrawIndexedCommand()
-            {
-                /* Stub */
-            }
-        } DrawIndexedCommand;
-
-
-        /** Holds all arguments passed to a vkCmdDrawIndirect() command. */
-        typedef struct DrawIndirectCommand : public Command
-        {
-            VkBuffer       buffer;
-            Anvil::Buffer* buffer_ptr;
-            uint32_t       count;
-            VkDeviceSize   offset;
-            uint32_t       stride;
-
-            /** Constructor. **/
-            explicit DrawIndirectCommand(Anvil::Buffer* in_buffer_ptr,
-                                         VkDeviceSize   in_offset,
-                                         uint32_t       in_count,
-                                         uint32_t       in_stride);
-
-            /** Destructor. */
-            virtual ~DrawIndirectCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            DrawIndirectCommand& operator=(const DrawIndirectCommand&);
-        } DrawIndirectCommand;
-
-        /** Holds all arguments passed to a vkCmdDrawIndirectCountAMD() command. */
-        typedef struct DrawIndirectCountAMDCommand : public Command
-        {
-            VkBuffer       buffer;
-            Anvil::Buffer* buffer_ptr;
-            VkBuffer       count_buffer;
-            Anvil::Buffer* count_buffer_ptr;
-            VkDeviceSize   count_offset;
-            uint32_t       max_draw_count;
-            VkDeviceSize   offset;
-            uint32_t       stride;
-
-            /** Constructor. **/
-            explicit DrawIndirectCountAMDCommand(Anvil::Buffer* in_buffer_ptr,
-                                                 VkDeviceSize   in_offset,
-                                                 Anvil::Buffer* in_count_buffer_ptr,
-                                                 VkDeviceSize   in_count_offset,
-                                                 uint32_t       in_max_draw_count,
-                                                 uint32_t       in_stride);
-
-            /** Destructor */
-            virtual ~DrawIndirectCountAMDCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            DrawIndirectCountAMDCommand& operator=(const DrawIndirectCountAMDCommand&);
-        } DrawIndirectCountAMDCommand;
-
-        /** Holds all arguments passed to a vkCmdDrawIndirectCountKHR() command. */
-        typedef struct DrawIndirectCountKHRCommand : public Command
-        {
-            VkBuffer       buffer;
-            Anvil::Buffer* buffer_ptr;
-            VkBuffer       count_buffer;
-            Anvil::Buffer* count_buffer_ptr;
-            VkDeviceSize   count_offset;
-            uint32_t       max_draw_count;
-            VkDeviceSize   offset;
-            uint32_t       stride;
-
-            /** Constructor. **/
-            explicit DrawIndirectCountKHRCommand(Anvil::Buffer* in_buffer_ptr,
-                                                 VkDeviceSize   in_offset,
-                                                 Anvil::Buffer* in_count_buffer_ptr,
-                                                 VkDeviceSize   in_count_offset,
-                                                 uint32_t       in_max_draw_count,
-                                                 uint32_t       in_stride);
-
-            /** Destructor */
-            virtual ~DrawIndirectCountKHRCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            DrawIndirectCountKHRCommand& operator=(const DrawIndirectCountKHRCommand&);
-        } DrawIndirectCountKHRCommand;
-
-        /** Holds all arguments passed to a vkCmdDrawIndexedIndirect() command. */
-        typedef struct DrawIndexedIndirectCommand : public Command
-        {
-            VkBuffer       buffer;
-            Anvil::Buffer* buffer_ptr;
-            uint32_t       draw_count;
-            VkDeviceSize   offset;
-            uint32_t       stride;
-
-            /** Constructor. **/
-            explicit DrawIndexedIndirectCommand(Anvil::Buffer* in_buffer_ptr,
-                                                VkDeviceSize   in_offset,
-                                                uint32_t       in_draw_count,
-                                                uint32_t       in_stride);
-
-            /** Destructor. */
-            virtual ~DrawIndexedIndirectCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            DrawIndexedIndirectCommand& operator=(const DrawIndexedIndirectCommand&);
-        } DrawIndexedIndirectCommand;
-
-        /** Holds all arguments passed to a vkCmdDrawIndirectByteCountEXT() command. */
-        typedef struct DrawIndirectByteCountEXTCommand : public Command
-        {
-            VkDeviceSize   counter_buffer_offset;
-            Anvil::Buffer* counter_buffer_ptr;
-            uint32_t       counter_offset;
-            uint32_t       first_instance;
-            uint32_t       instance_count;
-            uint32_t       vertex_stride;
-
-            /** Constructor. **/
-            explicit DrawIndirectByteCountEXTCommand(const uint32_t&     in_instance_count,
-                                                     const uint32_t&     in_first_instance,
-                                                     Anvil::Buffer*      in_counter_buffer_ptr,
-                                                     const VkDeviceSize& in_counter_buffer_offset,
-                                                     const uint32_t&     in_counter_offset,
-                                                     const uint32_t&     in_vertex_stride);
-
-            /** Destructor */
-            virtual ~DrawIndirectByteCountEXTCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            DrawIndirectByteCountEXTCommand& operator=(const DrawIndirectByteCountEXTCommand&);
-        } DrawIndirectByteCountEXTCommand;
-
-        /** Holds all arguments passed to a vkCmdDrawIndexedIndirectCountAMD() command. */
-        typedef struct DrawIndexedIndirectCountAMDCommand : public Command
-        {
-            VkBuffer       buffer;
-            Anvil::Buffer* buffer_ptr;
-            VkBuffer       count_buffer;
-            Anvil::Buffer* count_buffer_ptr;
-            VkDeviceSize   count_offset;
-            uint32_t       max_draw_count;
-            VkDeviceSize   offset;
-            uint32_t       stride;
-
-            /** Constructor. **/
-            explicit DrawIndexedIndirectCountAMDCommand(Anvil::Buffer* in_buffer_ptr,
-                                                        VkDeviceSize   in_offset,
-                                                        Anvil::Buffer* in_count_buffer_ptr,
-                                                        VkDeviceSize   in_count_offset,
-                                                        uint32_t       in_max_draw_count,
-                                                        uint32_t       in_stride);
-
-            /** Destructor */
-            virtual ~DrawIndexedIndirectCountAMDCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            DrawIndexedIndirectCountAMDCommand& operator=(const DrawIndexedIndirectCountAMDCommand&);
-        } DrawIndexedIndirectCountAMDCommand;
-
-        /** Holds all arguments passed to a vkCmdDrawIndexedIndirectCountKHR() command. */
-        typedef struct DrawIndexedIndirectCountKHRCommand : public Command
-        {
-            VkBuffer       buffer;
-            Anvil::Buffer* buffer_ptr;
-            VkBuffer       count_buffer;
-            Anvil::Buffer* count_buffer_ptr;
-            VkDeviceSize   count_offset;
-            uint32_t       max_draw_count;
-            VkDeviceSize   offset;
-            uint32_t       stride;
-
-            /** Constructor. **/
-            explicit DrawIndexedIndirectCountKHRCommand(Anvil::Buffer* in_buffer_ptr,
-                                                        VkDeviceSize   in_offset,
-                                                        Anvil::Buffer* in_count_buffer_ptr,
-                                                        VkDeviceSize   in_count_offset,
-                                                        uint32_t       in_max_draw_count,
-                                                        uint32_t       in_stride);
-
-            /** Destructor */
-            virtual ~DrawIndexedIndirectCountKHRCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            DrawIndexedIndirectCountKHRCommand& operator=(const DrawIndexedIndirectCountKHRCommand&);
-        } DrawIndexedIndirectCountKHRCommand;
-
-        /** Holds all arguments passed to a vkCmdEndQuery() command. */
-        typedef struct EndQueryCommand : public Command
-        {
-            Anvil::QueryIndex entry;
-            Anvil::QueryPool* query_pool_ptr;
-
-            /** Constructor. **/
-            explicit EndQueryCommand(Anvil::QueryPool* in_query_pool_ptr,
-                                     Anvil::QueryIndex in_entry);
-
-            /** Destructor. */
-            virtual ~EndQueryCommand()
-            {
-                /* Stub */
-            }
-
-        } EndQueryCommand;
-
-        /** Holds all arguments passed to a vkCmdEndQueryIndexedEXT() command. */
-        typedef struct EndQueryIndexedEXTCommand : public Command
-        {
-            uint32_t          index;
-            Anvil::QueryIndex query;
-            Anvil::QueryPool* query_pool_ptr;
-
-            /** Constructor. **/
-            explicit EndQueryIndexedEXTCommand(Anvil::QueryPool*        in_query_pool_ptr,
-                                               const Anvil::QueryIndex& in_entry,
-                                               const uint32_t&          in_index);
-
-            /** Destructor. */
-            virtual ~EndQueryIndexedEXTCommand()
-            {
-                /* Stub */
-            }
-
-        } EndQueryIndexedEXTCommand;
-
-        typedef struct EndTransformFeedbackEXTCommand : public Command
-        {
-            std::vector<VkDeviceSize>         counter_buffer_offsets;
-            std::vector<const Anvil::Buffer*> counter_buffer_ptrs;
-            uint32_t                          first_counter_buffer;
-
-            explicit EndTransformFeedbackEXTCommand(const uint32_t&                          in_first_counter_buffer,
-                                                    const std::vector<const Anvil::Buffer*>& in_counter_buffer_ptrs,
-                                                    const std::vector<VkDeviceSize>&         in_counter_buffer_offsets);
-
-        private:
-            EndTransformFeedbackEXTCommand           (const EndTransformFeedbackEXTCommand&);
-            EndTransformFeedbackEXTCommand& operator=(const EndTransformFeedbackEXTCommand);
-        } EndTransformFeedbackEXTCommand;
-
-        /** Holds all arguments passed to a vkCmdExecuteCommands() command. */
-        typedef struct ExecuteCommandsCommand : public Command
-        {
-            std::vector<Anvil::SecondaryCommandBuffer*> command_buffer_ptrs;
-            std::vector<VkCommandBuffer>                command_buffers;
-
-            /** Constructor. **/
-            explicit ExecuteCommandsCommand(uint32_t                        in_cmd_buffers_count,
-                                            Anvil::SecondaryCommandBuffer** in_cmd_buffer_ptrs);
-
-            /** Destructor. */
-            virtual ~ExecuteCommandsCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            ExecuteCommandsCommand& operator=(const ExecuteCommandsCommand&);
-        } ExecuteCommandsCommand;
-
-
-        /** Holds all arguments passed to a vkCmdFillBuffer() command. */
-        typedef struct FillBufferCommand : public Command
-        {
-            uint32_t       data;
-            VkBuffer       dst_buffer;
-            Anvil::Buffer* dst_buffer_ptr;
-            VkDeviceSize   dst_offset;
-            VkDeviceSize   size;
-
-            /** Constructor. **/
-            explicit FillBufferCommand(Anvil::Buffer* in_dst_buffer_ptr,
-                                       VkDeviceSize   in_dst_offset,
-                                       VkDeviceSize   in_size,
-                                       uint32_t       in_data);
-
-            /** Destructor. */
-            virtual ~FillBufferCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            FillBufferCommand& operator=(const FillBufferCommand&);
-        } FillBufferCommand;
-
-
-        /** Holds all arguments passed to a vkCmdNextSubpass() command. */
-        typedef struct NextSubpassCommand : public Command
-        {
-            Anvil::SubpassContents contents;
-
-            /** Constructor. **/
-            explicit NextSubpassCommand(Anvil::SubpassContents in_contents);
-
-            /** Destructor. */
-            virtual ~NextSubpassCommand()
-            {
-                /* Stub */
-            }
-        } NextSubpassCommand;
-
-        typedef struct NextSubpass2KHRCommand : public NextSubpassCommand
-        {
-            /** Constructor. **/
-            NextSubpass2KHRCommand(Anvil::SubpassContents in_contents)
-                :NextSubpassCommand(in_contents)
-            {
-                type = COMMAND_TYPE_NEXT_SUBPASS_2_KHR;
-            }
-        } NextSubpass2KHRCommand;
-
-        /** Holds all arguments passed to a vkCmdPushConstants() command. */
-        typedef struct PushConstantsCommand : public Command
-        {
-            Anvil::ShaderStageFlags stage_flags;
-
-            Anvil::PipelineLayout* layout_ptr;
-            uint32_t               offset;
-            uint32_t               size;
-            const void*            values;
-
-            /** Constructor. **/
-            explicit PushConstantsCommand(Anvil::PipelineLayout*  in_layout_ptr,
-                                          Anvil::ShaderStageFlags in_stage_flags,
-                                          uint32_t                in_offset,
-                                          uint32_t                in_size,
-                                          const void*             in_values);
-
-            /** Destructor. */
-            virtual ~PushConstantsCommand()
-            {
-                /* Stub */
-            }
-        } PushConstantsCommand;
-
-        /** Holds all arguments passed to a vkCmdResetEvent() command. **/
-        typedef struct ResetEventCommand : public Command
-        {
-            Anvil::PipelineStageFlags stage_mask;
-
-            VkEvent       event;
-            Anvil::Event* event_ptr;
-
-            /** Constructor. **/
-            explicit ResetEventCommand(Anvil::Event*             in_event_ptr,
-                                       Anvil::PipelineStageFlags in_stage_mask);
-
-            /** Destructor. */
-            virtual ~ResetEventCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            ResetEventCommand& operator=(const ResetEventCommand&);
-        } ResetEventCommand;
-
-
-        /** Holds all arguments passed to a vkCmdResetQueryPoolCommand() command. **/
-        typedef struct ResetQueryPoolCommand : public Command
-        {
-            uint32_t          query_count;
-            Anvil::QueryPool* query_pool_ptr;
-            Anvil::QueryIndex start_query;
-
-            /** Constructor. **/
-            explicit ResetQueryPoolCommand(Anvil::QueryPool* in_query_pool_ptr,
-                                           Anvil::QueryIndex in_start_query,
-                                           uint32_t          in_query_count);
-
-            /** Destructor. */
-            virtual ~ResetQueryPoolCommand()
-            {
-                /* Stub */
-            }
-        } ResetQueryPoolCommand;
-
-
-        /** Holds all arguments passed to a vkCmdResolveImage() command. **/
-        typedef struct ResolveImageCommand : public Command
-        {
-            VkImage                          dst_image;
-            Anvil::Image*                    dst_image_ptr;
-            Anvil::ImageLayout               dst_image_layout;
-            std::vector<Anvil::ImageResolve> regions;
-            VkImage                          src_image;
-            Anvil::Image*                    src_image_ptr;
-            Anvil::ImageLayout               src_image_layout;
-
-            /** Constructor. **/
-            explicit ResolveImageCommand(Anvil::Image*              in_src_image_ptr,
-                                         Anvil::ImageLayout         in_src_image_layout,
-                                         Anvil::Image*              in_dst_image_ptr,
-                                         Anvil::ImageLayout         in_dst_image_layout,
-                                         uint32_t                   in_region_count,
-                                         const Anvil::ImageResolve* in_region_ptrs);
-
-            /** Destructor. */
-            virtual ~ResolveImageCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            ResolveImageCommand& operator=(const ResolveImageCommand&);
-        } ResolveImageCommand;
-
-        /** Holds all arguments passed to a vkCmdSetBlendConstants() command. **/
-        typedef struct SetBlendConstantsCommand : public Command
-        {
-            float blend_constants[4];
-
-            /** Constructor. **/
-            explicit SetBlendConstantsCommand(const float in_blend_constants[4]);
-
-            /** Destructor. */
-            virtual ~SetBlendConstantsCommand()
-            {
-                /* Stub */
-            }
-        } SetBlendConstantsCommand;
-
-
-        /** Holds all arguments passed to a vkCmdSetDepthBias() command. **/
-        typedef struct SetDepthBiasCommand : public Command
-        {
-            float depth_bias_clamp;
-            float depth_bias_constant_factor;
-            float slope_scaled_depth_bias;
-
-            /** Constructor. **/
-            explicit SetDepthBiasCommand(float in_depth_bias_constant_factor,
-                                         float in_depth_bias_clamp,
-                                         float in_slope_scaled_depth_bias);
-
-            /** Destructor. */
-            virtual ~SetDepthBiasCommand()
-            {
-                /* Stub */
-            }
-        } SetDepthBiasCommand;
-
-
-        /** Holds all arguments passed to a vkCmdSetDepthBounds() command. **/
-        typedef struct SetDepthBoundsCommand : public Command
-        {
-            float max_depth_bounds;
-            float min_depth_bounds;
-
-            /** Constructor. **/
-            explicit SetDepthBoundsCommand(float in_min_depth_bounds,
-                                           float in_max_depth_bounds);
-
-            /** Destructor. */
-            virtual ~SetDepthBoundsCommand()
-            {
-                /* Stub */
-            }
-        } SetDepthBoundsCommand;
-
-        /** Holds all arguments passed to a vkCmdSetDeviceMaskKHR() command. **/
-        typedef struct SetDeviceMaskKHRCommand : public Command
-        {
-            uint32_t device_mask;
-
-            /** Constructor. **/
-            SetDeviceMaskKHRCommand(uint32_t in_device_mask);
-
-            /** Destructor. */
-            virtual ~SetDeviceMaskKHRCommand()
-            {
-                /* Stub */
-            }
-        } SetDeviceMaskKHRCommand;
-
-        /** Holds all arguments passed to a vkCmdSetEvent() command. **/
-        typedef struct SetEventCommand : public Command
-        {
-            VkEvent       event;
-            Anvil::Event* event_ptr;
-
-            Anvil::PipelineStageFlags stage_mask;
-
-            /** Constructor. **/
-            explicit SetEventCommand(Anvil::Event*             in_event_ptr,
-                                     Anvil::PipelineStageFlags in_stage_mask);
-
-            /** Destructor. */
-            virtual ~SetEventCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            SetEventCommand& operator=(const SetEventCommand&);
-        } SetEventCommand;
-
-
-        /** Holds all arguments passed to a vkCmdSetLineWidth() command. **/
-        typedef struct SetLineWidthCommand : public Command
-        {
-            float line_width;
-
-            /** Constructor. **/
-            explicit SetLineWidthCommand(float in_line_width);
-
-            /** Destructor. */
-            virtual ~SetLineWidthCommand()
-            {
-                /* Stub */
-            }
-        } SetLineWidthCommand;
-
-
-        /** Holds all arguments passed to vkCmdSetSampleLocationsEXT() command. **/
-        typedef struct SetSampleLocationsEXTCommand : public Command
-        {
-            Anvil::SampleLocationsInfo sample_locations_info;
-
-            /** Constructor. **/
-            explicit SetSampleLocationsEXTCommand(const Anvil::SampleLocationsInfo& in_sample_locations_info);
-
-            /** Destructor. */
-            virtual ~SetSampleLocationsEXTCommand()
-            {
-                /* Stub */
-            }
-        } SetSampleLocationsEXTCommand;
-
-
-        /** Holds all arguments passed to a vkCmdSetScissor() command. **/
-        typedef struct SetScissorCommand : public Command
-        {
-            uint32_t              first_scissor;
-            std::vector<VkRect2D> scissors;
-
-            /** Constructor. **/
-            explicit SetScissorCommand(uint32_t        in_first_scissor,
-                                       uint32_t        in_scissor_count,
-                                       const VkRect2D* in_scissor_ptrs);
-
-            /** Destructor. */
-            virtual ~SetScissorCommand()
-            {
-                /* Stub */
-            }
-        } SetScissorCommand;
-
-
-        /** Holds all arguments passed to a vkCmdSetStencilCompareMask() command. **/
-        typedef struct SetStencilCompareMaskCommand : public Command
-        {
-            Anvil::StencilFaceFlags face_mask;
-
-            uint32_t stencil_compare_mask;
-
-            /** Constructor. **/
-            explicit SetStencilCompareMaskCommand(Anvil::StencilFaceFlags in_face_mask,
-                                                  uint32_t                in_stencil_compare_mask);
-
-            /** Destructor. */
-            virtual ~SetStencilCompareMaskCommand()
-            {
-                /* Stub */
-            }
-        } SetStencilCompareMaskCommand;
-
-
-        /** Holds all arguments passed to a vkCmdSetStencilReference() command. **/
-        typedef struct SetStencilReferenceCommand : public Command
-        {
-            Anvil::StencilFaceFlags face_mask;
-
-            uint32_t stencil_reference;
-
-            /** Constructor. **/
-            explicit SetStencilReferenceCommand(Anvil::StencilFaceFlags in_face_mask,
-                                                uint32_t                in_stencil_reference);
-
-            /** Destructor. */
-            virtual ~SetStencilReferenceCommand()
-            {
-                /* Stub */
-            }
-        } SetStencilReferenceCommand;
-
-
-        /** Holds all arguments passed to a vkCmdSetStencilWriteMask() command. **/
-        typedef struct SetStencilWriteMaskCommand : public Command
-        {
-            Anvil::StencilFaceFlags face_mask;
-
-            uint32_t stencil_write_mask;
-
-            /** Constructor. **/
-            explicit SetStencilWriteMaskCommand(Anvil::StencilFaceFlags in_face_mask,
-                                                uint32_t                in_stencil_write_mask);
-
-            /** Destructor. */
-            virtual ~SetStencilWriteMaskCommand()
-            {
-                /* Stub */
-            }
-        } SetStencilWriteMaskCommand;
-
-        /** Holds all arguments passed to a vkCmdSetViewport() command. **/
-        typedef struct SetViewportCommand : public Command
-        {
-            uint32_t                first_viewport;
-            std::vector<VkViewport> viewports;
-
-            /** Constructor. **/
-            explicit SetViewportCommand(uint32_t          in_first_viewport,
-                                        uint32_t          in_viewport_count,
-                                        const VkViewport* in_viewport_ptrs);
-
-            /** Destructor. */
-            virtual ~SetViewportCommand()
-            {
-                /* Stub */
-            }
-        } SetViewportCommand;
-
-
-        /** Holds all arguments passed to a vkCmdUpdateBuffer() command. **/
-        typedef struct UpdateBufferCommand : public Command
-        {
-            const void*     data_ptr;
-            VkDeviceSize    data_size;
-            VkBuffer        dst_buffer;
-            Anvil::Buffer*  dst_buffer_ptr;
-            VkDeviceSize    dst_offset;
-
-            /** Constructor **/
-            explicit UpdateBufferCommand(Anvil::Buffer* in_dst_buffer_ptr,
-                                         VkDeviceSize   in_dst_offset,
-                                         VkDeviceSize   in_data_size,
-                                         const void*    in_data_ptr);
-
-            /** Destructor. */
-            virtual ~UpdateBufferCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            UpdateBufferCommand& operator=(const UpdateBufferCommand&);
-        } UpdateBufferCommand;
-
-        /** Holds all arguments passed to a vkCmdWaitEvents() command. **/
-        typedef struct WaitEventsCommand : public Command
-        {
-            Anvil::PipelineStageFlags dst_stage_mask;
-            Anvil::PipelineStageFlags src_stage_mask;
-
-            std::vector<BufferBarrier>  buffer_barriers;
-            std::vector<ImageBarrier>   image_barriers;
-            std::vector<MemoryBarrier>  memory_barriers;
-
-            std::vector<VkEvent>       events;
-            std::vector<Anvil::Event*> event_ptrs;
-
-            /** Constructor **/
-            explicit WaitEventsCommand(uint32_t                   in_event_count,
-                                       Anvil::Event* const*       in_event_ptrs,
-                                       Anvil::PipelineStageFlags  in_src_stage_mask,
-                                       Anvil::PipelineStageFlags  in_dst_stage_mask,
-                                       uint32_t                   in_memory_barrier_count,
-                                       const MemoryBarrier* const in_memory_barrier_ptr_ptr,
-                                       uint32_t                   in_buffer_memory_barrier_count,
-                                       const BufferBarrier* const in_buffer_memory_barrier_ptr_ptr,
-                                       uint32_t                   in_image_memory_barrier_count,
-                                       const ImageBarrier* const  in_image_memory_barrier_ptr_ptr);
-
-            /** Destructor. */
-            virtual ~WaitEventsCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            WaitEventsCommand& operator=(const WaitEventsCommand&);
-        } WaitEventsCommand;
-
-        /** Holds all arguments passed to vkCmdWriteBufferMarkerAMD() command. **/
-        typedef struct WriteBufferMarkerAMDCommand : public Command
-        {
-            Anvil::PipelineStageFlagBits pipeline_stage;
-            Anvil::Buffer*               dst_buffer_ptr;
-            VkDeviceSize                 dst_offset;
-            uint32_t                     marker;
-
-            /** Constructor **/
-            explicit WriteBufferMarkerAMDCommand(const Anvil::PipelineStageFlagBits& in_pipeline_stage,
-                                                 Anvil::Buffer*                      in_dst_buffer_ptr,
-                                                 VkDeviceSize                        in_dst_offset,
-                                                 const uint32_t&                     in_marker);
-
-            /** Destructor. */
-            virtual ~WriteBufferMarkerAMDCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            WriteBufferMarkerAMDCommand& operator=(const WriteBufferMarkerAMDCommand&);
-        } WriteBufferMarkerAMDCommand;
-
-        /** Holds all arguments passed to a vkCmdWriteTimestamp() command. **/
-        typedef struct WriteTimestampCommand : public Command
-        {
-            Anvil::PipelineStageFlagBits pipeline_stage;
-
-            Anvil::QueryIndex entry;
-            Anvil::QueryPool* query_pool_ptr;
-
-            /** Constructor. **/
-            explicit WriteTimestampCommand(Anvil::PipelineStageFlagBits in_pipeline_stage,
-                                           Anvil::QueryPool*            in_query_pool_ptr,
-                                           Anvil::QueryIndex            in_entry);
-
-            /** Destructor. */
-            virtual ~WriteTimestampCommand()
-            {
-                /* Stub */
-            }
-
-        private:
-            WriteTimestampCommand& operator=(const WriteTimestampCommand&);
-        } WriteTimestampCommand;
-
-
-        typedef std::vector<Command> Commands;
-
         /* Protected functions */
         explicit CommandBufferBase(const Anvil::BaseDevice* in_device_ptr,
                                    Anvil::CommandPool*      in_parent_command_pool_ptr,
@@ -2922,20 +1571,30 @@ namespace Anvil
             void clear_commands();
         #endif
 
+        void flush_pending_pipeline_barriers();
+
         /* Protected variables */
         #ifdef STORE_COMMAND_BUFFER_COMMANDS
-            Commands m_commands;
+            Anvil::CommandStreamUniquePtr m_owned_command_stream_ptr;
         #endif
 
-        VkCommandBuffer          m_command_buffer;
-        uint32_t                 m_device_mask;
-        const Anvil::BaseDevice* m_device_ptr;
-        bool                     m_is_renderpass_active;
-        uint32_t                 m_n_debug_label_regions_started;
-        Anvil::CommandPool*      m_parent_command_pool_ptr;
-        bool                     m_recording_in_progress;
-        uint32_t                 m_renderpass_device_mask;
-        CommandBufferType        m_type;
+        VkCommandBuffer                      m_command_buffer;
+        Anvil::CommandStream*                m_command_stream_ptr;
+        uint32_t                             m_device_mask;
+        const Anvil::BaseDevice*             m_device_ptr;
+        bool                                 m_is_renderpass_active;
+        uint32_t                             m_n_debug_label_regions_started;
+        Anvil::CommandPool*                  m_parent_command_pool_ptr;
+        Anvil::PipelineBarrierBatchUniquePtr m_pipeline_barrier_batch_ptr;
+        bool                                 m_recording_in_progress;
+        Anvil::RedundantStateFilterUniquePtr m_redundant_state_filter_ptr;
+        uint32_t                             m_renderpass_device_mask;
+        Anvil::ResourceStateTrackerUniquePtr m_resource_state_tracker_ptr;
+        CommandBufferType                    m_type;
+
+        /* Scratch storage for barriers generated by m_resource_state_tracker_ptr. Retained between calls. */
+        std::vector<Anvil::BufferBarrier> m_tracked_buffer_barriers;
+        std::vector<Anvil::ImageBarrier>  m_tracked_image_barriers;
 
         static bool m_command_stashing_disabled;
 
@@ -2963,9 +1622,8 @@ namespace Anvil
             /* Stub */
         }
 
-        /** Issues a vkCmdBeginRenderPass() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBeginRenderPass() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -3012,9 +1670,8 @@ namespace Anvil
                                       const uint32_t&                         in_opt_n_post_subpass_sample_locations         = 0,
                                       const Anvil::SubpassSampleLocations*    in_opt_post_subpass_sample_locations_ptr       = nullptr);
 
-        /** Issues a vkCmdBeginRenderPass2KHR() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdBeginRenderPass2KHR() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -3061,9 +1718,8 @@ namespace Anvil
                                            const uint32_t&                         in_opt_n_post_subpass_sample_locations         = 0,
                                            const Anvil::SubpassSampleLocations*    in_opt_post_subpass_sample_locations_ptr       = nullptr);
 
-        /** Issues a vkCmdEndRenderPass() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdEndRenderPass() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -3074,9 +1730,8 @@ namespace Anvil
          **/
         bool record_end_render_pass();
 
-        /** Issues a vkCmdEndRenderPass2KHR() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdEndRenderPass2KHR() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -3087,9 +1742,8 @@ namespace Anvil
          **/
         bool record_end_render_pass2_KHR();
 
-        /** Issues a vkCmdExecuteCommands() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdExecuteCommands() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -3101,9 +1755,8 @@ namespace Anvil
         bool record_execute_commands(uint32_t                        in_cmd_buffers_count,
                                      Anvil::SecondaryCommandBuffer** in_cmd_buffers);
 
-        /** Issues a vkCmdNextSubpass() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdNextSubpass() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -3114,9 +1767,8 @@ namespace Anvil
          **/
         bool record_next_subpass(Anvil::SubpassContents in_contents);
 
-        /** Issues a vkCmdNextSubpass2KHR() call and appends it to the internal vector of commands
-         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
-         *  #define enabled).
+        /** Issues a vkCmdNextSubpass2KHR() call and appends it to the command stream attached
+         *  to the command buffer, if any.
          *
          *  Calling this function for a command buffer which has not been put into a recording mode
          *  (by issuing a start_recording() call earlier) will result in an assertion failure.
@@ -3127,8 +1779,8 @@ namespace Anvil
          **/
         bool record_next_subpass2_KHR(Anvil::SubpassContents in_contents);
 
-        /** Issues a vkBeginCommandBufer() call and clears the internally managed vector of recorded
-         *  commands, if STORE_COMMAND_BUFFER_COMMANDS has been defined for the build.
+        /** Issues a vkBeginCommandBufer() call and clears the internally owned command stream,
+         *  if STORE_COMMAND_BUFFER_COMMANDS has been defined for the build.
          *
          *  It is an error to invoke this function if recording is already in progress.
          *
@@ -3194,8 +1846,8 @@ namespace Anvil
     public:
         /* Public functions */
 
-        /** Issues a vkBeginCommandBufer() call and clears the internally managed vector of recorded
-         *  commands, if STORE_COMMAND_BUFFER_COMMANDS has been defined for the build.
+        /** Issues a vkBeginCommandBufer() call and clears the internally owned command stream,
+         *  if STORE_COMMAND_BUFFER_COMMANDS has been defined for the build.
          *
          *  The difference between this function and ::start_recording() is that this entrypoint should be
          *  used to start recording a secondary-level command buffer which will live within the specified
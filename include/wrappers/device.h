@@ -33,6 +33,7 @@
 
 #include "misc/debug.h"
 #include "misc/device_create_info.h"
+#include "misc/device_dispatch_table.h"
 #include "misc/extensions.h"
 #include "misc/mt_safety.h"
 #include "misc/struct_chainer.h"
@@ -94,11 +95,34 @@ namespace Anvil
             return m_create_info_ptr.get();
         }
 
+        /** Returns a device-wide list of memory blocks whose writes to non-coherent memory have not been flushed yet.
+         *  Please see Anvil::MemoryBlockMappingMode::PERSISTENT_WITH_DEFERRED_FLUSHES for more details.
+         *
+         *  @return As per description
+         **/
+        Anvil::DeferredMemoryFlushList* get_deferred_memory_flush_list() const
+        {
+            return m_deferred_memory_flush_list_ptr.get();
+        }
+
         Anvil::DescriptorSetLayoutManager* get_descriptor_set_layout_manager() const
         {
             return m_descriptor_set_layout_manager_ptr.get();
         }
 
+        /** Returns a table of device-level Vulkan entrypoints retrieved for this device with vkGetDeviceProcAddr().
+         *
+         *  All device-level Vulkan calls made by Anvil on behalf of this device go through the table. Applications
+         *  are encouraged to use it, too, instead of Anvil::Vulkan func pointers, which are routed through loader
+         *  trampolines.
+         *
+         *  @return As per description
+         **/
+        const Anvil::DeviceDispatchTable& get_dispatch_table() const
+        {
+            return m_dispatch_table;
+        }
+
         /** Retrieves a raw Vulkan handle for this device.
          *
          *  @return As per description
@@ -330,6 +354,36 @@ namespace Anvil
             return m_khr_swapchain_extension_entrypoints;
         }
 
+        /** Returns a container with entry-points to functions introduced by VK_KHR_timeline_semaphore extension.
+         *
+         *  Will fire an assertion failure if the extension was not requested at device creation time.
+         **/
+        const ExtensionKHRTimelineSemaphoreEntrypoints& get_extension_khr_timeline_semaphore_entrypoints() const
+        {
+            anvil_assert(m_extension_enabled_info_ptr->get_device_extension_info()->khr_timeline_semaphore() );
+
+            return m_khr_timeline_semaphore_extension_entrypoints;
+        }
+
+        /** Returns a device-wide fence pool. Fences retrieved from the pool are recycled when released.
+         *
+         *  @return As per description
+         **/
+        Anvil::FencePool* get_fence_pool() const
+        {
+            return m_fence_pool_ptr.get();
+        }
+
+        /** Returns a device-wide memory budget tracker, which keeps track of the amount of memory allocated per heap and
+         *  memory type, and fires notifications when heap usage rises above configurable fractions of heap budgets.
+         *
+         *  @return As per description
+         **/
+        Anvil::MemoryBudgetTracker* get_memory_budget_tracker() const
+        {
+            return m_memory_budget_tracker_ptr.get();
+        }
+
         /** Retrieves a graphics pipeline manager, created for this device instance.
          *
          *  @return As per description
@@ -556,6 +610,16 @@ namespace Anvil
         bool get_sample_locations(Anvil::SampleCountFlagBits          in_sample_count,
                                   std::vector<Anvil::SampleLocation>* out_result_ptr) const;
 
+        /** Returns a device-wide sampler cache. Samplers retrieved from the cache are shared between all
+         *  users requesting identical sampler state.
+         *
+         *  @return As per description
+         **/
+        Anvil::SamplerCache* get_sampler_cache() const
+        {
+            return m_sampler_cache_ptr.get();
+        }
+
         /** Returns shader module cache instance */
         Anvil::ShaderModuleCache* get_shader_module_cache() const
         {
@@ -743,7 +807,8 @@ namespace Anvil
         std::map<uint32_t /* Vulkan queue family index */, std::vector<Anvil::Queue*> > m_queue_ptrs_per_vk_queue_fam;
 
         /* Protected variables */
-        VkDevice m_device;
+        VkDevice                   m_device;
+        Anvil::DeviceDispatchTable m_dispatch_table;
 
         ExtensionAMDBufferMarkerEntrypoints               m_amd_buffer_marker_extension_entrypoints;
         ExtensionAMDDrawIndirectCountEntrypoints          m_amd_draw_indirect_count_extension_entrypoints;
@@ -764,6 +829,7 @@ namespace Anvil
         ExtensionKHRSamplerYCbCrConversionEntrypoints     m_khr_sampler_ycbcr_conversion_extension_entrypoints;
         ExtensionKHRSurfaceEntrypoints                    m_khr_surface_extension_entrypoints;
         ExtensionKHRSwapchainEntrypoints                  m_khr_swapchain_extension_entrypoints;
+        ExtensionKHRTimelineSemaphoreEntrypoints          m_khr_timeline_semaphore_extension_entrypoints;
 
         #if defined(_WIN32)
             ExtensionKHRExternalFenceWin32Entrypoints     m_khr_external_fence_win32_extension_entrypoints;
@@ -780,21 +846,41 @@ namespace Anvil
         bool init_dummy_dsg          () const;
         bool init_extension_func_ptrs();
 
+        /** Returns the mutex which protects global resource states tracked by ResourceStateTracker, or nullptr
+         *  if the device is not MT-safe.
+         *
+         *  Queues hold the mutex from the moment they start resolving resource states for a submission until
+         *  the resulting states are published, so that submissions made to different queues observe each other's
+         *  states in submission order. If a queue lock is also needed, it must be taken first.
+         **/
+        std::recursive_mutex* get_resource_state_mutex() const
+        {
+            return (is_mt_safe() ) ? &m_resource_state_mutex
+                                   : nullptr;
+        }
+
         /* Private variables */
 
 
         std::unique_ptr<Anvil::ComputePipelineManager>   m_compute_pipeline_manager_ptr;
+        Anvil::DeferredMemoryFlushListUniquePtr          m_deferred_memory_flush_list_ptr;
         DescriptorSetLayoutManagerUniquePtr              m_descriptor_set_layout_manager_ptr;
         mutable Anvil::DescriptorSetGroupUniquePtr       m_dummy_dsg_ptr;
         mutable std::mutex                               m_dummy_dsg_mutex;
         std::unique_ptr<Anvil::ExtensionInfo<bool> >     m_extension_enabled_info_ptr;
+        Anvil::FencePoolUniquePtr                        m_fence_pool_ptr;
+        Anvil::MemoryBudgetTrackerUniquePtr              m_memory_budget_tracker_ptr;
         GraphicsPipelineManagerUniquePtr                 m_graphics_pipeline_manager_ptr;
         PipelineCacheUniquePtr                           m_pipeline_cache_ptr;
         PipelineLayoutManagerUniquePtr                   m_pipeline_layout_manager_ptr;
+        mutable std::recursive_mutex                     m_resource_state_mutex;
+        Anvil::SamplerCacheUniquePtr                     m_sampler_cache_ptr;
         Anvil::ShaderModuleCacheUniquePtr                m_shader_module_cache_ptr;
 
         std::vector<CommandPoolUniquePtr> m_command_pool_ptr_per_vk_queue_fam;
 
+        friend class  Anvil::Queue;                /* get_resource_state_mutex() */
+        friend class  Anvil::ResourceStateTracker; /* get_resource_state_mutex() */
         friend struct DeviceDeleter;
     };
 
@@ -34,6 +34,7 @@
 #include "misc/debug_marker.h"
 #include "misc/mt_safety.h"
 #include "misc/types.h"
+#include <atomic>
 
 namespace Anvil
 {
@@ -112,6 +113,17 @@ namespace Anvil
                                              const ExternalHandleType&                     in_handle);
         #endif
 
+        /** Tells whether the fence has been passed to a successful Queue submission or sparse binding operation since
+         *  it was created or last reset. A fence which has not been submitted can only be signalled if it was created
+         *  in the signalled state.
+         *
+         *  Fences submitted without going through Anvil::Queue are not taken into account.
+         **/
+        bool has_been_submitted() const
+        {
+            return m_has_been_submitted;
+        }
+
         /** Tells whether the fence is signalled at the time of the call.
          *
          *  @return true if the fence is set, false otherwise.
@@ -138,6 +150,58 @@ namespace Anvil
         static bool reset_fences(const uint32_t in_n_fences,
                                  Fence*         in_fences);
 
+        /** Resets the specified number of Vulkan fences with a single vkResetFences() call.
+         *
+         *  All fences must have been created for the same device.
+         *
+         *  @param in_n_fences    Number of Fence instances accessible under @param in_fence_ptrs.
+         *  @param in_fence_ptrs  An array of @param in_n_fences pointers to Fence instances to reset. Must not be nullptr,
+         *                        unless @param in_n_fences is 0.
+         *
+         *  @return true if the function executed successfully, false otherwise.
+         **/
+        static bool reset_fences(const uint32_t in_n_fences,
+                                 Fence* const*  in_fence_ptrs);
+
+        /** Blocks until the fence is signalled or until @param in_timeout nanoseconds pass.
+         *
+         *  @return true if the fence was signalled, false if the wait timed out or failed.
+         **/
+        bool wait(uint64_t in_timeout = UINT64_MAX) const;
+
+        /** Blocks until all specified fences are signalled or until @param in_timeout nanoseconds pass.
+         *
+         *  All fences are waited on with a single vkWaitForFences() call, and must have been created for the same device.
+         *
+         *  @param in_n_fences   Number of Fence instances accessible under @param in_fence_ptrs.
+         *  @param in_fence_ptrs An array of @param in_n_fences pointers to Fence instances to wait on. Must not be nullptr,
+         *                       unless @param in_n_fences is 0.
+         *  @param in_timeout    Timeout, in nanoseconds.
+         *
+         *  @return true if all fences were signalled, false if the wait timed out or failed.
+         **/
+        static bool wait_all(const uint32_t in_n_fences,
+                             Fence* const*  in_fence_ptrs,
+                             uint64_t       in_timeout = UINT64_MAX);
+
+        /** Blocks until at least one of the specified fences is signalled or until @param in_timeout nanoseconds pass.
+         *
+         *  All fences are waited on with a single vkWaitForFences() call, and must have been created for the same device.
+         *
+         *  @param in_n_fences                     Number of Fence instances accessible under @param in_fence_ptrs. Must not be 0.
+         *  @param in_fence_ptrs                   An array of @param in_n_fences pointers to Fence instances to wait on.
+         *                                         Must not be nullptr.
+         *  @param in_timeout                      Timeout, in nanoseconds.
+         *  @param out_opt_signalled_fence_idx_ptr If not nullptr and the function returns true, deref will be set to the index
+         *                                         of the first fence under @param in_fence_ptrs which was found signalled.
+         *
+         *  @return true if any of the fences was signalled, false if the wait timed out or failed.
+         **/
+        static bool wait_any(const uint32_t in_n_fences,
+                             Fence* const*  in_fence_ptrs,
+                             uint64_t       in_timeout                      = UINT64_MAX,
+                             uint32_t*      out_opt_signalled_fence_idx_ptr = nullptr);
+
     private:
         /* Private functions */
 
@@ -153,10 +217,18 @@ namespace Anvil
         bool init         ();
         void release_fence();
 
+        static bool wait_for_fences(const uint32_t in_n_fences,
+                                    Fence* const*  in_fence_ptrs,
+                                    bool           in_wait_all,
+                                    uint64_t       in_timeout);
+
         /* Private variables */
         Anvil::FenceCreateInfoUniquePtr                        m_create_info_ptr;
         std::map<Anvil::ExternalFenceHandleTypeFlagBits, bool> m_external_fence_created_for_handle_type;
         VkFence                                                m_fence;
+        std::atomic<bool>                                      m_has_been_submitted;
+
+        friend class Queue;
     };
 }; /* namespace Anvil */
 
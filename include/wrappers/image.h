@@ -80,7 +80,13 @@ namespace Anvil
 
         /* Transitions the image from one layout to another.
          *
-         * This is a blocking call.
+         * For single-GPU devices, the transition is submitted to @param in_queue_ptr without waiting for it to finish
+         * executing. It is resolved the same way resource usages declared for submitted command buffers are, so
+         * tracked resource states are updated and later submissions to the same queue are ordered after the
+         * transition. Work submitted to other queues must synchronize with it, eg. using @param in_opt_set_semaphore_ptrs.
+         * Please see ResourceStateTracker documentation for more details.
+         *
+         * For multi-GPU devices, this is a blocking call.
          *
          * @param in_queue_ptr                    Queue to use for the transition. The specified queue must support pipeline barrier
          *                                        command. Must not be null.
@@ -607,7 +613,11 @@ namespace Anvil
         std::vector<std::unique_ptr<AspectPageOccupancyData> >                   m_sparse_aspect_page_occupancy_data_items_owned;
         std::map<Anvil::ImageAspectFlagBits, Anvil::SparseImageAspectProperties> m_sparse_aspect_props;
 
+        /* Global access state of each subresource, as seen by ResourceStateTracker. Lazily initialized. */
+        std::vector<Anvil::ResourceAccessState> m_tracked_subresource_states;
+
         friend class Anvil::Queue;
+        friend class Anvil::ResourceStateTracker; /* m_tracked_subresource_states */
 
         ANVIL_DISABLE_ASSIGNMENT_OPERATOR(Image);
         ANVIL_DISABLE_COPY_CONSTRUCTOR(Image);
@@ -30,8 +30,13 @@
  *  - if more than one read() or write() calls is necessary, the class exposes a function which
  *    lets its users map the block's storage into process space. Then, the user should issue
  *    a number of read & write ops, after which the object can be unmapped.
+ *  - alternatively, the block's storage can be kept persistently mapped. Flushes of writes made
+ *    to persistently mapped non-coherent memory can be deferred and coalesced, so that the dirty
+ *    ranges of all memory blocks are flushed with a single API call.
  *  - provides a way to create derivative memory blocks, whose storage is "carved out" of the
  *    parent memory block's.
+ *  - keeps track of derived memory blocks which are alive, so that usage & fragmentation of the
+ *    underlying memory allocation can be reported.
  **/
 #ifndef WRAPPERS_MEMORY_BLOCK_H
 #define WRAPPERS_MEMORY_BLOCK_H
@@ -39,6 +44,7 @@
 #include "misc/mt_safety.h"
 #include "misc/types.h"
 #include "misc/memory_block_create_info.h"
+#include <unordered_set>
 
 namespace Anvil
 {
@@ -59,6 +65,48 @@ namespace Anvil
                         public MTSafetySupportProvider
     {
     public:
+        /* Public type definitions */
+
+        /* Describes how the memory allocation backing a memory block is used by derived memory blocks. */
+        typedef struct Statistics
+        {
+            /* Size of the largest range of the allocation which is not covered by any derived memory block. */
+            VkDeviceSize largest_free_range_size;
+
+            /* Number of alive memory blocks which have been derived from the allocation. */
+            uint32_t n_derived_blocks;
+
+            /* Number of disjoint ranges of the allocation which are not covered by any derived memory block. */
+            uint32_t n_free_ranges;
+
+            /* Size of the allocation. */
+            VkDeviceSize reserved_size;
+
+            /* Number of bytes covered by at least one derived memory block. If no derived memory blocks are
+             * alive, the whole allocation is considered to be in use. */
+            VkDeviceSize used_size;
+
+            Statistics()
+                :largest_free_range_size(0),
+                 n_derived_blocks       (0),
+                 n_free_ranges          (0),
+                 reserved_size          (0),
+                 used_size              (0)
+            {
+                /* Stub */
+            }
+
+            /* Returns a value from range [0, 1], telling how scattered the free space is. 0 is returned if there is
+             * no free space, or if all free space is contiguous. */
+            float get_fragmentation() const
+            {
+                const VkDeviceSize free_size = reserved_size - used_size;
+
+                return (free_size > 0) ? 1.0f - static_cast<float>(largest_free_range_size) / static_cast<float>(free_size)
+                                       : 0.0f;
+            }
+        } Statistics;
+
         /* Public functions */
 
         /* TODO
@@ -92,11 +140,26 @@ namespace Anvil
         /** Releases the Vulkan counterpart and unregisters the wrapper instance from the object tracker */
         virtual ~MemoryBlock();
 
+        /** Flushes all ranges modified by write() calls, whose flushes have been deferred, with a single
+         *  vkFlushMappedMemoryRanges() call. Only ranges of the memory allocation this memory block belongs to are flushed.
+         *
+         *  Also see DeferredMemoryFlushList::flush(), which flushes pending writes of all memory blocks of a device.
+         *
+         *  @return true if successful or if there was nothing to flush, false otherwise.
+         **/
+        bool flush_pending_writes();
+
         const Anvil::MemoryBlockCreateInfo* get_create_info_ptr() const
         {
             return m_create_info_ptr.get();
         }
 
+        /** Returns the mapping mode of the memory allocation this memory block belongs to. */
+        Anvil::MemoryBlockMappingMode get_mapping_mode() const
+        {
+            return get_root_memory_block()->m_mapping_mode;
+        }
+
         /* Returns the underlying raw Vulkan VkDeviceMemory handle. */
         const VkDeviceMemory& get_memory() const
         {
@@ -117,6 +180,19 @@ namespace Anvil
             return m_start_offset;
         }
 
+        /** Returns usage statistics of the memory allocation backing this memory block. For derived memory blocks,
+         *  statistics of the root memory block (ie. the one which owns the allocation) are returned.
+         *
+         *  If the root memory block has already been released, zeroed statistics are returned.
+         **/
+        Statistics get_statistics() const;
+
+        /** Returns the tag assigned to the memory block with set_tag(), or by the memory allocator which created it. */
+        const std::string& get_tag() const
+        {
+            return m_tag;
+        }
+
         /** Checks if the memory range covered by this memory block intersects with memory range covered
          *  by the user-specified memory block
          *
@@ -171,6 +247,34 @@ namespace Anvil
                   VkDeviceSize in_size,
                   void*        out_result_ptr);
 
+        /** Changes the way storage of the memory allocation this memory block belongs to is mapped into process space.
+         *  Please see Anvil::MemoryBlockMappingMode documentation for more details.
+         *
+         *  Persistent mapping modes avoid a map & unmap call pair per read() & write() call. Additionally, deferring
+         *  flushes avoids one vkFlushMappedMemoryRanges() call per write() made against non-coherent memory, which
+         *  dominates the cost of frequent small writes (eg. uniform buffer updates).
+         *
+         *  Pending writes are flushed when switching out of MemoryBlockMappingMode::PERSISTENT_WITH_DEFERRED_FLUSHES mode.
+         *
+         *  This function must not be called concurrently with any other function of the memory block or blocks derived
+         *  from the same allocation.
+         *
+         *  @param in_mapping_mode New mapping mode to use. Persistent modes require the memory to be mappable.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool set_mapping_mode(Anvil::MemoryBlockMappingMode in_mapping_mode);
+
+        /** Assigns a user-defined tag to the memory block. Tags are included in MemoryAllocator statistics reports
+         *  and are meant to identify the allocation site.
+         *
+         *  This function is NOT thread-safe.
+         **/
+        void set_tag(const std::string& in_tag)
+        {
+            m_tag = in_tag;
+        }
+
         /** Unmaps the mapped storage from the process space.
          *
          *  The call should only be made after a map() call.
@@ -180,7 +284,10 @@ namespace Anvil
         /** Writes user data to the specified region of the underlying memory object after mapping
          *  it into process space.
          *  If the buffer object uses non-coherent memory backing, the modified regions will be
-         *  flushed to ensure GPU can access the latest data after this call finishes.
+         *  flushed to ensure GPU can access the latest data after this call finishes, unless the
+         *  memory block is in MemoryBlockMappingMode::PERSISTENT_WITH_DEFERRED_FLUSHES mapping mode.
+         *  In the latter case, the modified region is recorded and flushed at next Queue::submit(),
+         *  flush_pending_writes() or DeferredMemoryFlushList::flush() call, whichever comes first.
          *
          *  This function does not require the caller to issue a map() call, prior to being called.
          *  However, making that call in advance will skip map()+unmap() invocations, wnich would
@@ -220,10 +327,18 @@ namespace Anvil
         MemoryBlock           (const MemoryBlock&);
         MemoryBlock& operator=(const MemoryBlock&);
 
-        void     close_gpu_memory_access     ();
-        uint32_t get_device_memory_type_index(uint32_t                  in_memory_type_bits,
-                                              Anvil::MemoryFeatureFlags in_memory_features);
-        bool     open_gpu_memory_access      ();
+        void               add_pending_flush_range     (VkDeviceSize              in_start_offset,
+                                                        VkDeviceSize              in_size);
+        void               close_gpu_memory_access     ();
+        uint32_t           get_device_memory_type_index(uint32_t                  in_memory_type_bits,
+                                                        Anvil::MemoryFeatureFlags in_memory_features);
+        const MemoryBlock* get_root_memory_block       () const;
+        MemoryBlock*       get_root_memory_block       ();
+        bool               open_gpu_memory_access      ();
+        void               pop_pending_flush_ranges    (std::vector<VkMappedMemoryRange>* out_ranges_ptr);
+
+        void register_derived_memory_block  (MemoryBlock* in_memory_block_ptr);
+        void unregister_derived_memory_block(MemoryBlock* in_memory_block_ptr);
 
         /* IMemoryBlockBackendSupport */
         void set_parent_memory_allocator_backend_ptr(std::shared_ptr<Anvil::IMemoryAllocatorBackendBase> in_backend_ptr,
@@ -252,20 +367,31 @@ namespace Anvil
         }
 
         /* Private members */
-        std::atomic<uint32_t> m_gpu_data_map_count; /* Only set for root memory blocks */
-        void*                 m_gpu_data_ptr;       /* Only set for root memory blocks */
+        std::atomic<uint32_t>         m_gpu_data_map_count; /* Only set for root memory blocks */
+        void*                         m_gpu_data_ptr;       /* Only set for root memory blocks */
+        Anvil::MemoryBlockMappingMode m_mapping_mode;       /* Only set for root memory blocks */
+
+        /* Atom-aligned <start, end> ranges modified by write() calls whose flushes have been deferred. Only used by root memory blocks. */
+        std::vector<std::pair<VkDeviceSize, VkDeviceSize> > m_pending_flush_ranges;
 
         void*                                 m_backend_object;
         Anvil::MemoryBlockCreateInfoUniquePtr m_create_info_ptr;
+        bool                                  m_is_budget_tracked;
         VkDeviceMemory                        m_memory;
         const Anvil::MemoryType*              m_memory_type_props_ptr; /* keep for simplified debugging */
         VkDeviceSize                          m_start_offset;
 
+        std::unordered_set<MemoryBlock*> m_derived_memory_blocks; /* Only used by root memory blocks */
+        MemoryBlock*                     m_root_memory_block_ptr; /* Only set for derived memory blocks */
+        std::string                      m_tag;
+
         std::vector<const Anvil::PhysicalDevice*>           m_mgpu_physical_devices;
         std::shared_ptr<Anvil::IMemoryAllocatorBackendBase> m_owned_parent_memory_allocator_backend_ptr;
         Anvil::IMemoryAllocatorBackendBase*                 m_parent_memory_allocator_backend_ptr;
 
         std::map<Anvil::ExternalMemoryHandleTypeFlagBits, Anvil::ExternalHandleUniquePtr> m_external_handle_type_to_external_handle;
+
+        friend class DeferredMemoryFlushList;
     };
 }; /* Vulkan namespace */
 
@@ -34,7 +34,9 @@
 #include "misc/debug.h"
 #include "misc/debug_marker.h"
 #include "misc/mt_safety.h"
+#include "misc/resource_state_tracker.h"
 #include "misc/types.h"
+#include <deque>
 
 namespace Anvil
 {
@@ -141,6 +143,30 @@ namespace Anvil
          */
         void end_debug_utils_label();
 
+        /** Retrieves the ID of the most recent submission which has finished executing GPU-side.
+         *
+         *  Requires submission tracking support. Please see supports_submission_tracking() for more details.
+         *
+         *  @param out_submission_id_ptr Deref will be set to the queried ID. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool get_completed_submission_id(uint64_t* out_submission_id_ptr) const;
+
+        /** Retrieves the ID assigned to the most recent tracked submission made to the queue, or 0 if no submission
+         *  has been tracked yet.
+         *
+         *  Submission IDs are assigned in a monotonically increasing manner, so all submissions with IDs smaller
+         *  than or equal to a value returned by get_completed_submission_id() are guaranteed to have finished executing.
+         *  Only submissions which need an ID are tracked. Please see submit() for more details.
+         *
+         *  Requires submission tracking support. Please see supports_submission_tracking() for more details.
+         **/
+        uint64_t get_last_submission_id() const
+        {
+            return m_last_submission_id;
+        }
+
         /** Retrieves parent device instance */
         const Anvil::BaseDevice* get_parent_device() const
         {
@@ -174,6 +200,19 @@ namespace Anvil
             return m_queue_index;
         }
 
+        /** Retrieves the timeline semaphore which is signalled with the submission ID whenever a tracked submission
+         *  finishes executing. Can be used to make submissions to other queues wait on submissions made to this queue,
+         *  as long as the IDs to wait for have been retrieved from submit().
+         *
+         *  The semaphore must NOT be signalled by the app.
+         *
+         *  @return Requested semaphore, or nullptr if submission tracking is not supported.
+         **/
+        Anvil::Semaphore* get_submission_semaphore() const
+        {
+            return m_submission_semaphore_ptr.get();
+        }
+
         /** Inserts a single queue debug label.
          *
          *  Requires VK_EXT_debug_utils support. Otherwise, the call is moot.
@@ -278,7 +317,54 @@ namespace Anvil
                                               Anvil::Semaphore* const*            in_wait_semaphore_ptrs_ptr,
                                               Anvil::SwapchainOperationErrorCode* out_present_results_ptr);
 
-        bool submit(const SubmitInfo& in_submit_info);
+        /** Submits work described by @param in_submit_info to the queue.
+         *
+         *  If the queue supports submission tracking and @param out_opt_submission_id_ptr is not nullptr, the submission
+         *  is assigned a new submission ID, which is stored under *out_opt_submission_id_ptr. Blocking submissions which
+         *  do not specify a fence, as well as submissions which need prologue command buffers (see below), are also
+         *  assigned an ID, so that they can be waited on using the submission semaphore instead of a fence. All other
+         *  submissions do not signal the submission semaphore, and leave get_last_submission_id() unchanged.
+         *  Since submissions complete in order, a completed ID still implies that all submissions made earlier,
+         *  tracked or not, have finished executing.
+         *
+         *  For single-GPU, unprotected submissions, resource usages declared for the submitted command buffers
+         *  are resolved against the current state of the resources. If any barriers are needed, they are recorded
+         *  into a prologue command buffer, which is submitted right before the command buffer which needs it.
+         *  Please see ResourceStateTracker documentation for more details.
+         *
+         *  Each call is a flush point for the device's deferred memory flush list: host writes to memory blocks using
+         *  MemoryBlockMappingMode::PERSISTENT_WITH_DEFERRED_FLUSHES are flushed before the work is submitted, so they
+         *  are visible to it. If no writes are pending, this costs a single atomic load.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool submit(const SubmitInfo& in_submit_info,
+                    uint64_t*         out_opt_submission_id_ptr = nullptr);
+
+        /** Submits all submissions accumulated in @param in_batch_ptr with a single vkQueueSubmit() call.
+         *
+         *  Command buffers, semaphores and the fence referred to by the batch are locked for the duration of the call.
+         *  If any of the batched submissions was marked as blocking, the function waits until the whole batch
+         *  finishes executing GPU-side, using the shortest of the specified timeouts.
+         *
+         *  The batch is cleared upon return, but retains its scratch storage, so it can be reused without
+         *  incurring further allocations.
+         *
+         *  If the queue supports submission tracking, the whole batch is assigned a single submission ID, subject to
+         *  the same rules as submit(const SubmitInfo&).
+         *
+         *  Resource usages declared for command buffers in single-GPU, unprotected submissions are resolved the
+         *  same way submit(const SubmitInfo&) does it. Like submit(const SubmitInfo&), the call is a flush point for
+         *  deferred memory flushes, even if the batch is empty.
+         *
+         *  @param in_batch_ptr              Batch to submit. Must not be nullptr. Submitting an empty batch is a no-op.
+         *  @param out_opt_submission_id_ptr If not nullptr and the queue supports submission tracking, deref will be set
+         *                                   to the ID assigned to the batch.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool submit(Anvil::SubmissionBatch* in_batch_ptr,
+                    uint64_t*               out_opt_submission_id_ptr = nullptr);
 
         /** Tells whether the queue supports protected memory operations */
         bool supports_protected_memory_operations() const
@@ -292,9 +378,60 @@ namespace Anvil
             return m_supports_sparse_bindings;
         }
 
+        /** Tells whether submissions made to the queue can be assigned submission IDs, which can be used to determine
+         *  GPU-side progress without having to associate a fence with each submission.
+         *
+         *  Requires VK_KHR_timeline_semaphore support, with timelineSemaphore feature supported.
+         **/
+        bool supports_submission_tracking() const
+        {
+            return (m_submission_semaphore_ptr != nullptr);
+        }
+
+        /** Blocks until a submission with the specified ID (and, consequently, all submissions made earlier) finishes
+         *  executing GPU-side, or until @param in_timeout nanoseconds pass.
+         *
+         *  Requires submission tracking support. Please see supports_submission_tracking() for more details.
+         *
+         *  @return true if the submission has finished executing, false if the wait timed out or failed.
+         **/
+        bool wait_for_submission(uint64_t in_submission_id,
+                                 uint64_t in_timeout = UINT64_MAX) const;
+
         void wait_idle();
 
     private:
+        /* Private type definitions */
+
+        /* Describes an image layout change requested with Image::change_image_layout() */
+        typedef struct ImageLayoutChange
+        {
+            Anvil::AccessFlags           dst_access_mask;
+            Anvil::ImageLayout           dst_layout;
+            Anvil::Image*                image_ptr;
+            Anvil::AccessFlags           src_access_mask;
+            Anvil::ImageLayout           src_layout;
+            Anvil::ImageSubresourceRange subresource_range;
+        } ImageLayoutChange;
+
+        /* Prologue command buffers submitted with a single vkQueueSubmit() call. */
+        typedef struct InFlightPrologueCommandBuffers
+        {
+            std::vector<Anvil::PrimaryCommandBufferUniquePtr> cmd_buffer_ptrs;
+
+            /* Fence owned by the queue which the submission has been made with, or submission ID assigned to it.
+             * If neither is set, the submission has been made with a fence owned by the app, and is known to have
+             * finished executing once any later item has. */
+            Anvil::FenceUniquePtr fence_ptr;
+            uint64_t              submission_id;
+
+            InFlightPrologueCommandBuffers()
+                :submission_id(0)
+            {
+                /* Stub */
+            }
+        } InFlightPrologueCommandBuffers;
+
         /* Private functions */
         bool present_internal   (Anvil::DeviceGroupPresentModeFlagBits in_presentation_mode,
                                  uint32_t                              in_n_swapchains,
@@ -310,6 +447,35 @@ namespace Anvil
                                  Anvil::Semaphore* const*              in_wait_semaphore_ptrs,
                                  bool                                  in_should_lock);
 
+        bool change_image_layout(Anvil::Image*                       in_image_ptr,
+                                 Anvil::AccessFlags                  in_src_access_mask,
+                                 Anvil::ImageLayout                  in_src_layout,
+                                 Anvil::AccessFlags                  in_dst_access_mask,
+                                 Anvil::ImageLayout                  in_dst_layout,
+                                 const Anvil::ImageSubresourceRange& in_subresource_range,
+                                 uint32_t                            in_n_wait_semaphores,
+                                 const Anvil::PipelineStageFlags*    in_opt_wait_dst_stage_masks_ptr,
+                                 Anvil::Semaphore* const*            in_opt_wait_semaphore_ptrs,
+                                 uint32_t                            in_n_signal_semaphores,
+                                 Anvil::Semaphore* const*            in_opt_signal_semaphore_ptrs);
+        bool submit_internal    (const SubmitInfo&                   in_submit_info,
+                                 uint64_t*                           out_opt_submission_id_ptr,
+                                 const ImageLayoutChange*            in_opt_image_layout_change_ptr);
+
+        void     end_resource_state_resolution(bool                             in_have_been_submitted,
+                                               uint64_t                         in_submission_id,
+                                               Anvil::FenceUniquePtr*           inout_fence_ptr_ptr);
+        void     lock_resource_states         ();
+        bool     record_prologue_cmd_buffer   (Anvil::ResourceStateTracker*     in_tracker_ptr,
+                                               std::vector<VkCommandBuffer>*    out_cmd_buffers_vk_ptr);
+        void     recycle_prologue_cmd_buffers ();
+        void     resolve_image_layout_change  (const ImageLayoutChange&         in_image_layout_change,
+                                               std::vector<VkCommandBuffer>*    out_cmd_buffers_vk_ptr);
+        uint32_t resolve_resource_states      (uint32_t                         in_n_cmd_buffers,
+                                               Anvil::CommandBufferBase* const* in_cmd_buffer_ptrs,
+                                               std::vector<VkCommandBuffer>*    out_cmd_buffers_vk_ptr);
+        void     resolve_resource_states      (Anvil::SubmissionBatch*          in_batch_ptr);
+
         void bind_sparse_memory_lock_unlock    (Anvil::SparseMemoryBindingUpdateInfo& in_update,
                                                 bool                                  in_should_lock);
         void submit_command_buffers_lock_unlock(uint32_t                              in_n_command_buffers,
@@ -346,9 +512,45 @@ namespace Anvil
         const uint32_t                   m_queue_family_index;
         const Anvil::QueueGlobalPriority m_queue_global_priority;
         const uint32_t                   m_queue_index;
-        Anvil::FenceUniquePtr            m_submit_fence_ptr;
         bool                             m_supports_protected_memory_operations;
         bool                             m_supports_sparse_bindings;
+
+        std::atomic<uint64_t>     m_last_submission_id;
+        Anvil::SemaphoreUniquePtr m_submission_semaphore_ptr;
+
+        /* Prologue command buffers hold barriers generated when resolving resource usages declared for submitted
+         * command buffers. The pool must outlive the command buffers allocated from it. */
+        Anvil::CommandPoolUniquePtr                       m_prologue_command_pool_ptr;
+        std::vector<Anvil::PrimaryCommandBufferUniquePtr> m_available_prologue_cmd_buffers;
+        std::deque<InFlightPrologueCommandBuffers>        m_in_flight_prologue_cmd_buffers;
+        std::vector<Anvil::PrimaryCommandBufferUniquePtr> m_recorded_prologue_cmd_buffers;
+
+        /* Resource states resolved for the submission which is being made. Only published if the submission succeeds.
+         * The device's resource state mutex is held while any states are pending. */
+        bool                                       m_are_resource_states_locked;
+        Anvil::ResourceStateTrackerUniquePtr       m_image_layout_change_tracker_ptr;
+        Anvil::ResourceStateTracker::PendingStates m_pending_resource_states;
+
+        /* Scratch storage used at submission time. Retained between calls. Must only be accessed with the queue locked. */
+        std::vector<Anvil::BufferBarrier> m_prologue_buffer_barriers;
+        std::vector<Anvil::ImageBarrier>  m_prologue_image_barriers;
+        std::vector<uint32_t>             m_resolved_cmd_buffer_device_masks;
+        std::vector<VkCommandBuffer>      m_resolved_cmd_buffers_vk;
+
+        std::vector<uint32_t>        m_submit_cmd_buffer_device_masks;
+        std::vector<VkCommandBuffer> m_submit_cmd_buffers_vk;
+        std::vector<uint32_t>        m_submit_signal_semaphore_device_indices;
+        std::vector<VkSemaphore>     m_submit_signal_semaphores_vk;
+        std::vector<uint64_t>        m_submit_timeline_signal_semaphore_values;
+        std::vector<uint32_t>        m_submit_wait_semaphore_device_indices;
+        std::vector<VkSemaphore>     m_submit_wait_semaphores_vk;
+
+        #if defined(_WIN32)
+            std::vector<uint64_t>       m_submit_d3d12_fence_signal_semaphore_values;
+            std::vector<VkDeviceMemory> m_submit_keyed_mutex_syncs_vk;
+        #endif
+
+        friend class Anvil::Image; /* change_image_layout() */
     };
 }; /* namespace Anvil */
 
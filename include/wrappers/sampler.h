@@ -48,6 +48,9 @@ namespace Anvil
          *
          *  Creates a single Sampler instance and registers the object in Object Tracker.
          *
+         *  NOTE: This function always spawns a new Vulkan sampler. Consider using SamplerCache (available via
+         *        BaseDevice::get_sampler_cache() ) if many samplers sharing the same state are going to be needed.
+         *
          *  For argument discussion, please consult Vulkan API specification.
          */
         static Anvil::SamplerUniquePtr create(Anvil::SamplerCreateInfoUniquePtr in_create_info_ptr);
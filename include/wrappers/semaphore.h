@@ -70,6 +70,16 @@ namespace Anvil
             return m_create_info_ptr.get();
         }
 
+        /** Retrieves the current payload of a timeline semaphore.
+         *
+         *  Requires VK_KHR_timeline_semaphore. Can only be called for timeline semaphores.
+         *
+         *  @param out_value_ptr Deref will be set to the queried value. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool get_counter_value(uint64_t* out_value_ptr) const;
+
         /** Retrieves a raw handle to the underlying Vulkan semaphore instance  */
         VkSemaphore get_semaphore() const
         {
@@ -112,6 +122,27 @@ namespace Anvil
         /** Releases the underlying Vulkan Semaphore instance and creates a new Vulkan object. */
         bool reset();
 
+        /** Sets the payload of a timeline semaphore to @param in_value from the host.
+         *
+         *  @param in_value must be larger than the current payload of the semaphore, as well as smaller than
+         *  any value the semaphore is going to be signalled with by pending device-side operations.
+         *
+         *  Requires VK_KHR_timeline_semaphore. Can only be called for timeline semaphores.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool signal(uint64_t in_value);
+
+        /** Blocks until the payload of a timeline semaphore becomes equal to or larger than @param in_value,
+         *  or until @param in_timeout nanoseconds pass.
+         *
+         *  Requires VK_KHR_timeline_semaphore. Can only be called for timeline semaphores.
+         *
+         *  @return true if the semaphore reached the requested value, false if the wait timed out or failed.
+         **/
+        bool wait(uint64_t in_value,
+                  uint64_t in_timeout = UINT64_MAX) const;
+
     private:
         /* Private functions */
 
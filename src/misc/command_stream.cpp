@@ -0,0 +1,1452 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/command_stream.h"
+#include "misc/debug.h"
+#include "wrappers/command_buffer.h"
+
+namespace
+{
+    /* Plain data counterparts of barrier descriptors. Barrier descriptors retain the objects they refer to,
+     * so they cannot be copied into the stream directly.
+     */
+    typedef struct
+    {
+        Anvil::AccessFlags dst_access_mask;
+        Anvil::AccessFlags src_access_mask;
+    } MemoryBarrierData;
+
+    typedef struct
+    {
+        Anvil::AccessFlags dst_access_mask;
+        Anvil::AccessFlags src_access_mask;
+
+        Anvil::Buffer* buffer_ptr;
+        uint32_t       dst_queue_family_index;
+        VkDeviceSize   offset;
+        VkDeviceSize   size;
+        uint32_t       src_queue_family_index;
+    } BufferBarrierData;
+
+    typedef struct
+    {
+        Anvil::AccessFlags dst_access_mask;
+        Anvil::AccessFlags src_access_mask;
+
+        uint32_t                     dst_queue_family_index;
+        Anvil::Image*                image_ptr;
+        Anvil::ImageLayout           new_layout;
+        Anvil::ImageLayout           old_layout;
+        uint32_t                     src_queue_family_index;
+        Anvil::ImageSubresourceRange subresource_range;
+    } ImageBarrierData;
+
+    uint32_t get_n_command_bytes(uint32_t in_n_payload_bytes)
+    {
+        return static_cast<uint32_t>(sizeof(Anvil::CommandStream::CommandHeader) ) + Anvil::Utils::round_up(in_n_payload_bytes,
+                                                                                                            static_cast<uint32_t>(sizeof(uint64_t) ));
+    }
+};
+
+
+/** Constructor. */
+Anvil::CommandStream::CommandStream(uint32_t in_chunk_size)
+    :m_chunk_size   (Anvil::Utils::round_up(in_chunk_size,
+                                            static_cast<uint32_t>(sizeof(uint64_t) ))),
+     m_n_bytes_used (0),
+     m_n_chunks_used(0),
+     m_n_commands   (0)
+{
+    anvil_assert(in_chunk_size > 0);
+}
+
+/** Destructor */
+Anvil::CommandStream::~CommandStream()
+{
+    /* Stub */
+}
+
+/** Reserves space for a new command of the specified type in the stream and fills its header.
+ *
+ *  @param in_type            Type of the command.
+ *  @param in_n_payload_bytes Number of bytes to reserve for the command's payload.
+ *
+ *  @return Pointer to the payload storage of the new command.
+ **/
+uint8_t* Anvil::CommandStream::allocate_command(CommandType in_type,
+                                                uint32_t    in_n_payload_bytes)
+{
+    const uint32_t n_command_bytes = get_n_command_bytes(in_n_payload_bytes);
+    Chunk*         chunk_ptr       = (m_n_chunks_used > 0) ? m_chunks.at(m_n_chunks_used - 1).get()
+                                                           : nullptr;
+    CommandHeader* header_ptr      = nullptr;
+
+    if (chunk_ptr                    == nullptr ||
+        chunk_ptr->size - chunk_ptr->n_bytes_used < n_command_bytes)
+    {
+        /* Move to the next chunk. Reuse chunks retained by clear() whenever they are large enough. */
+        const uint32_t new_chunk_size = (n_command_bytes > m_chunk_size) ? n_command_bytes
+                                                                         : m_chunk_size;
+
+        if (m_n_chunks_used == static_cast<uint32_t>(m_chunks.size() ))
+        {
+            m_chunks.push_back(std::unique_ptr<Chunk>(new Chunk(new_chunk_size) ));
+        }
+        else
+        if (m_chunks.at(m_n_chunks_used)->size < n_command_bytes)
+        {
+            m_chunks.at(m_n_chunks_used).reset(new Chunk(new_chunk_size) );
+        }
+
+        chunk_ptr = m_chunks.at(m_n_chunks_used).get();
+
+        ++m_n_chunks_used;
+    }
+
+    header_ptr = reinterpret_cast<CommandHeader*>(reinterpret_cast<uint8_t*>(chunk_ptr->storage_ptr.get() ) + chunk_ptr->n_bytes_used);
+
+    header_ptr->n_payload_bytes = in_n_payload_bytes;
+    header_ptr->type            = in_type;
+
+    chunk_ptr->n_bytes_used += n_command_bytes;
+    m_n_bytes_used          += n_command_bytes;
+
+    ++m_n_commands;
+
+    return reinterpret_cast<uint8_t*>(header_ptr) + sizeof(CommandHeader);
+}
+
+/* Please see header for specification */
+Anvil::CommandStream::Iterator Anvil::CommandStream::begin() const
+{
+    return Iterator(this,
+                    (m_n_commands > 0) ? 0 : m_n_chunks_used,
+                    0); /* in_chunk_offset */
+}
+
+/* Please see header for specification */
+void Anvil::CommandStream::clear()
+{
+    for (uint32_t n_chunk = 0;
+                  n_chunk < m_n_chunks_used;
+                ++n_chunk)
+    {
+        m_chunks.at(n_chunk)->n_bytes_used = 0;
+    }
+
+    m_n_bytes_used  = 0;
+    m_n_chunks_used = 0;
+    m_n_commands    = 0;
+}
+
+/* Please see header for specification */
+Anvil::CommandStreamUniquePtr Anvil::CommandStream::create(uint32_t in_chunk_size)
+{
+    return Anvil::CommandStreamUniquePtr(new CommandStream(in_chunk_size),
+                                         std::default_delete<CommandStream>() );
+}
+
+/* Please see header for specification */
+Anvil::CommandStream::Iterator Anvil::CommandStream::end() const
+{
+    return Iterator(this,
+                    m_n_chunks_used,
+                    0); /* in_chunk_offset */
+}
+
+/* Please see header for specification */
+bool Anvil::CommandStream::replay(Anvil::CommandBufferBase* in_command_buffer_ptr) const
+{
+    auto primary_command_buffer_ptr = (in_command_buffer_ptr->get_command_buffer_type() == Anvil::COMMAND_BUFFER_TYPE_PRIMARY) ? static_cast<Anvil::PrimaryCommandBuffer*>(in_command_buffer_ptr)
+                                                                                                                                : nullptr;
+    bool result                     = true;
+
+    anvil_assert(in_command_buffer_ptr->get_command_stream() != this);
+
+    for (const auto& current_command : *this)
+    {
+        Reader reader(current_command);
+
+        switch (current_command.get_command_type() )
+        {
+            case Anvil::COMMAND_TYPE_BEGIN_QUERY:
+            {
+                const auto query_pool_ptr = reader.read<Anvil::QueryPool*>       ();
+                const auto entry          = reader.read<Anvil::QueryIndex>       ();
+                const auto flags          = reader.read<Anvil::QueryControlFlags>();
+
+                result &= in_command_buffer_ptr->record_begin_query(query_pool_ptr,
+                                                                    entry,
+                                                                    flags);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_BEGIN_QUERY_INDEXED_EXT:
+            {
+                const auto query_pool_ptr = reader.read<Anvil::QueryPool*>       ();
+                const auto query          = reader.read<Anvil::QueryIndex>       ();
+                const auto flags          = reader.read<Anvil::QueryControlFlags>();
+                const auto index          = reader.read<uint32_t>                ();
+
+                result &= in_command_buffer_ptr->record_begin_query_indexed(query_pool_ptr,
+                                                                            query,
+                                                                            flags,
+                                                                            index);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_BEGIN_RENDER_PASS:
+            case Anvil::COMMAND_TYPE_BEGIN_RENDER_PASS_2_KHR:
+            {
+                std::vector<Anvil::AttachmentSampleLocations> attachment_sample_locations;
+                uint32_t                                      n_clear_values  = 0;
+                uint32_t                                      n_render_areas  = 0;
+                std::vector<Anvil::SubpassSampleLocations>    subpass_sample_locations;
+
+                const auto clear_values_ptr = reader.read_array<VkClearValue>(&n_clear_values);
+                const auto fbo_ptr          = reader.read<Anvil::Framebuffer*>  ();
+                const auto device_mask      = reader.read<uint32_t>             ();
+                const auto render_areas_ptr = reader.read_array<VkRect2D>       (&n_render_areas);
+                const auto render_pass_ptr  = reader.read<Anvil::RenderPass*>   ();
+                const auto contents         = reader.read<Anvil::SubpassContents>();
+
+                reader.read_attachment_sample_locations(&attachment_sample_locations);
+                reader.read_subpass_sample_locations   (&subpass_sample_locations);
+
+                if (primary_command_buffer_ptr == nullptr)
+                {
+                    anvil_assert(primary_command_buffer_ptr != nullptr);
+
+                    result = false;
+                    break;
+                }
+
+                if (current_command.get_command_type() == Anvil::COMMAND_TYPE_BEGIN_RENDER_PASS)
+                {
+                    result &= primary_command_buffer_ptr->record_begin_render_pass(n_clear_values,
+                                                                                   clear_values_ptr,
+                                                                                   fbo_ptr,
+                                                                                   device_mask,
+                                                                                   n_render_areas,
+                                                                                   render_areas_ptr,
+                                                                                   render_pass_ptr,
+                                                                                   contents,
+                                                                                   static_cast<uint32_t>(attachment_sample_locations.size() ),
+                                                                                   (attachment_sample_locations.size() > 0) ? &attachment_sample_locations.at(0) : nullptr,
+                                                                                   static_cast<uint32_t>(subpass_sample_locations.size() ),
+                                                                                   (subpass_sample_locations.size() > 0)    ? &subpass_sample_locations.at(0)    : nullptr);
+                }
+                else
+                {
+                    result &= primary_command_buffer_ptr->record_begin_render_pass2_KHR(n_clear_values,
+                                                                                        clear_values_ptr,
+                                                                                        fbo_ptr,
+                                                                                        device_mask,
+                                                                                        n_render_areas,
+                                                                                        render_areas_ptr,
+                                                                                        render_pass_ptr,
+                                                                                        contents,
+                                                                                        static_cast<uint32_t>(attachment_sample_locations.size() ),
+                                                                                        (attachment_sample_locations.size() > 0) ? &attachment_sample_locations.at(0) : nullptr,
+                                                                                        static_cast<uint32_t>(subpass_sample_locations.size() ),
+                                                                                        (subpass_sample_locations.size() > 0)    ? &subpass_sample_locations.at(0)    : nullptr);
+                }
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_BEGIN_TRANSFORM_FEEDBACK_EXT:
+            case Anvil::COMMAND_TYPE_END_TRANSFORM_FEEDBACK_EXT:
+            {
+                uint32_t n_buffers = 0;
+                uint32_t n_offsets = 0;
+
+                const auto first_counter_buffer = reader.read<uint32_t>                 ();
+                const auto n_counter_buffers    = reader.read<uint32_t>                 ();
+                const auto buffer_ptrs          = reader.read_array<Anvil::Buffer*>     (&n_buffers);
+                const auto offsets_ptr          = reader.read_array<VkDeviceSize>       (&n_offsets);
+
+                if (current_command.get_command_type() == Anvil::COMMAND_TYPE_BEGIN_TRANSFORM_FEEDBACK_EXT)
+                {
+                    result &= in_command_buffer_ptr->record_begin_transform_feedback_EXT(first_counter_buffer,
+                                                                                         n_counter_buffers,
+                                                                                         const_cast<Anvil::Buffer**>(buffer_ptrs),
+                                                                                         offsets_ptr);
+                }
+                else
+                {
+                    result &= in_command_buffer_ptr->record_end_transform_feedback_EXT(first_counter_buffer,
+                                                                                       n_counter_buffers,
+                                                                                       const_cast<Anvil::Buffer**>(buffer_ptrs),
+                                                                                       offsets_ptr);
+                }
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_BIND_DESCRIPTOR_SETS:
+            {
+                uint32_t n_dynamic_offsets = 0;
+                uint32_t n_sets            = 0;
+
+                const auto bind_point          = reader.read<Anvil::PipelineBindPoint>         ();
+                const auto layout_ptr          = reader.read<Anvil::PipelineLayout*>           ();
+                const auto first_set           = reader.read<uint32_t>                         ();
+                const auto descriptor_set_ptrs = reader.read_array<const Anvil::DescriptorSet*>(&n_sets);
+                const auto dynamic_offsets_ptr = reader.read_array<uint32_t>                   (&n_dynamic_offsets);
+
+                result &= in_command_buffer_ptr->record_bind_descriptor_sets(bind_point,
+                                                                             layout_ptr,
+                                                                             first_set,
+                                                                             n_sets,
+                                                                             descriptor_set_ptrs,
+                                                                             n_dynamic_offsets,
+                                                                             dynamic_offsets_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_BIND_INDEX_BUFFER:
+            {
+                const auto buffer_ptr = reader.read<Anvil::Buffer*>  ();
+                const auto offset     = reader.read<VkDeviceSize>    ();
+                const auto index_type = reader.read<Anvil::IndexType>();
+
+                result &= in_command_buffer_ptr->record_bind_index_buffer(buffer_ptr,
+                                                                          offset,
+                                                                          index_type);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_BIND_PIPELINE:
+            {
+                const auto bind_point  = reader.read<Anvil::PipelineBindPoint>();
+                const auto pipeline_id = reader.read<Anvil::PipelineID>       ();
+
+                result &= in_command_buffer_ptr->record_bind_pipeline(bind_point,
+                                                                      pipeline_id);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_BIND_TRANSFORM_FEEDBACK_BUFFERS_EXT:
+            {
+                uint32_t n_buffers = 0;
+                uint32_t n_offsets = 0;
+                uint32_t n_sizes   = 0;
+
+                const auto first_binding = reader.read<uint32_t>            ();
+                const auto buffer_ptrs   = reader.read_array<Anvil::Buffer*>(&n_buffers);
+                const auto offsets_ptr   = reader.read_array<VkDeviceSize>  (&n_offsets);
+                const auto sizes_ptr     = reader.read_array<VkDeviceSize>  (&n_sizes);
+
+                result &= in_command_buffer_ptr->record_bind_transform_feedback_buffers_EXT(first_binding,
+                                                                                            n_buffers,
+                                                                                            const_cast<Anvil::Buffer**>(buffer_ptrs),
+                                                                                            offsets_ptr,
+                                                                                            sizes_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_BIND_VERTEX_BUFFER:
+            {
+                uint32_t n_buffers = 0;
+                uint32_t n_offsets = 0;
+
+                const auto start_binding = reader.read<uint32_t>            ();
+                const auto buffer_ptrs   = reader.read_array<Anvil::Buffer*>(&n_buffers);
+                const auto offsets_ptr   = reader.read_array<VkDeviceSize>  (&n_offsets);
+
+                result &= in_command_buffer_ptr->record_bind_vertex_buffers(start_binding,
+                                                                            n_buffers,
+                                                                            const_cast<Anvil::Buffer**>(buffer_ptrs),
+                                                                            offsets_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_BLIT_IMAGE:
+            {
+                uint32_t n_regions = 0;
+
+                const auto src_image_ptr    = reader.read<Anvil::Image*>         ();
+                const auto src_image_layout = reader.read<Anvil::ImageLayout>    ();
+                const auto dst_image_ptr    = reader.read<Anvil::Image*>         ();
+                const auto dst_image_layout = reader.read<Anvil::ImageLayout>    ();
+                const auto regions_ptr      = reader.read_array<Anvil::ImageBlit>(&n_regions);
+                const auto filter           = reader.read<Anvil::Filter>         ();
+
+                result &= in_command_buffer_ptr->record_blit_image(src_image_ptr,
+                                                                   src_image_layout,
+                                                                   dst_image_ptr,
+                                                                   dst_image_layout,
+                                                                   n_regions,
+                                                                   regions_ptr,
+                                                                   filter);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_CLEAR_ATTACHMENTS:
+            {
+                uint32_t n_attachments = 0;
+                uint32_t n_rects       = 0;
+
+                const auto attachments_ptr = reader.read_array<Anvil::ClearAttachment>(&n_attachments);
+                const auto rects_ptr       = reader.read_array<VkClearRect>           (&n_rects);
+
+                result &= in_command_buffer_ptr->record_clear_attachments(n_attachments,
+                                                                          attachments_ptr,
+                                                                          n_rects,
+                                                                          rects_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_CLEAR_COLOR_IMAGE:
+            {
+                uint32_t n_ranges = 0;
+
+                const auto  image_ptr    = reader.read<Anvil::Image*>                     ();
+                const auto  image_layout = reader.read<Anvil::ImageLayout>                ();
+                const auto& color        = reader.read<VkClearColorValue>                 ();
+                const auto  ranges_ptr   = reader.read_array<Anvil::ImageSubresourceRange>(&n_ranges);
+
+                result &= in_command_buffer_ptr->record_clear_color_image(image_ptr,
+                                                                          image_layout,
+                                                                         &color,
+                                                                          n_ranges,
+                                                                          ranges_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_CLEAR_DEPTH_STENCIL_IMAGE:
+            {
+                uint32_t n_ranges = 0;
+
+                const auto  image_ptr     = reader.read<Anvil::Image*>                     ();
+                const auto  image_layout  = reader.read<Anvil::ImageLayout>                ();
+                const auto& depth_stencil = reader.read<VkClearDepthStencilValue>          ();
+                const auto  ranges_ptr    = reader.read_array<Anvil::ImageSubresourceRange>(&n_ranges);
+
+                result &= in_command_buffer_ptr->record_clear_depth_stencil_image(image_ptr,
+                                                                                  image_layout,
+                                                                                 &depth_stencil,
+                                                                                  n_ranges,
+                                                                                  ranges_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_COPY_BUFFER:
+            {
+                uint32_t n_regions = 0;
+
+                const auto src_buffer_ptr = reader.read<Anvil::Buffer*>        ();
+                const auto dst_buffer_ptr = reader.read<Anvil::Buffer*>        ();
+                const auto regions_ptr    = reader.read_array<Anvil::BufferCopy>(&n_regions);
+
+                result &= in_command_buffer_ptr->record_copy_buffer(src_buffer_ptr,
+                                                                    dst_buffer_ptr,
+                                                                    n_regions,
+                                                                    regions_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_COPY_BUFFER_TO_IMAGE:
+            {
+                uint32_t n_regions = 0;
+
+                const auto src_buffer_ptr   = reader.read<Anvil::Buffer*>              ();
+                const auto dst_image_ptr    = reader.read<Anvil::Image*>               ();
+                const auto dst_image_layout = reader.read<Anvil::ImageLayout>          ();
+                const auto regions_ptr      = reader.read_array<Anvil::BufferImageCopy>(&n_regions);
+
+                result &= in_command_buffer_ptr->record_copy_buffer_to_image(src_buffer_ptr,
+                                                                             dst_image_ptr,
+                                                                             dst_image_layout,
+                                                                             n_regions,
+                                                                             regions_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_COPY_IMAGE:
+            {
+                uint32_t n_regions = 0;
+
+                const auto src_image_ptr    = reader.read<Anvil::Image*>         ();
+                const auto src_image_layout = reader.read<Anvil::ImageLayout>    ();
+                const auto dst_image_ptr    = reader.read<Anvil::Image*>         ();
+                const auto dst_image_layout = reader.read<Anvil::ImageLayout>    ();
+                const auto regions_ptr      = reader.read_array<Anvil::ImageCopy>(&n_regions);
+
+                result &= in_command_buffer_ptr->record_copy_image(src_image_ptr,
+                                                                   src_image_layout,
+                                                                   dst_image_ptr,
+                                                                   dst_image_layout,
+                                                                   n_regions,
+                                                                   regions_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_COPY_IMAGE_TO_BUFFER:
+            {
+                uint32_t n_regions = 0;
+
+                const auto src_image_ptr    = reader.read<Anvil::Image*>               ();
+                const auto src_image_layout = reader.read<Anvil::ImageLayout>          ();
+                const auto dst_buffer_ptr   = reader.read<Anvil::Buffer*>              ();
+                const auto regions_ptr      = reader.read_array<Anvil::BufferImageCopy>(&n_regions);
+
+                result &= in_command_buffer_ptr->record_copy_image_to_buffer(src_image_ptr,
+                                                                             src_image_layout,
+                                                                             dst_buffer_ptr,
+                                                                             n_regions,
+                                                                             regions_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_COPY_QUERY_POOL_RESULTS:
+            {
+                const auto query_pool_ptr = reader.read<Anvil::QueryPool*> ();
+                const auto start_query    = reader.read<Anvil::QueryIndex> ();
+                const auto query_count    = reader.read<uint32_t>          ();
+                const auto dst_buffer_ptr = reader.read<Anvil::Buffer*>    ();
+                const auto dst_offset     = reader.read<VkDeviceSize>      ();
+                const auto dst_stride     = reader.read<VkDeviceSize>      ();
+                const auto flags          = reader.read<VkQueryResultFlags>();
+
+                result &= in_command_buffer_ptr->record_copy_query_pool_results(query_pool_ptr,
+                                                                                start_query,
+                                                                                query_count,
+                                                                                dst_buffer_ptr,
+                                                                                dst_offset,
+                                                                                dst_stride,
+                                                                                flags);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DEBUG_MARKER_BEGIN_EXT:
+            case Anvil::COMMAND_TYPE_DEBUG_MARKER_INSERT_EXT:
+            {
+                uint32_t n_color_components = 0;
+
+                const auto marker_name   = std::string      (reader.read_string() );
+                const auto opt_color_ptr = reader.read_array<float>(&n_color_components);
+
+                if (current_command.get_command_type() == Anvil::COMMAND_TYPE_DEBUG_MARKER_BEGIN_EXT)
+                {
+                    result &= in_command_buffer_ptr->record_debug_marker_begin_EXT(marker_name,
+                                                                                   opt_color_ptr);
+                }
+                else
+                {
+                    result &= in_command_buffer_ptr->record_debug_marker_insert_EXT(marker_name,
+                                                                                    opt_color_ptr);
+                }
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DEBUG_MARKER_END_EXT:
+            {
+                result &= in_command_buffer_ptr->record_debug_marker_end_EXT();
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DISPATCH:
+            {
+                const auto x = reader.read<uint32_t>();
+                const auto y = reader.read<uint32_t>();
+                const auto z = reader.read<uint32_t>();
+
+                result &= in_command_buffer_ptr->record_dispatch(x,
+                                                                 y,
+                                                                 z);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DISPATCH_BASE_KHR:
+            {
+                const auto base_group_x  = reader.read<uint32_t>();
+                const auto base_group_y  = reader.read<uint32_t>();
+                const auto base_group_z  = reader.read<uint32_t>();
+                const auto group_count_x = reader.read<uint32_t>();
+                const auto group_count_y = reader.read<uint32_t>();
+                const auto group_count_z = reader.read<uint32_t>();
+
+                result &= in_command_buffer_ptr->record_dispatch_base_KHR(base_group_x,
+                                                                          base_group_y,
+                                                                          base_group_z,
+                                                                          group_count_x,
+                                                                          group_count_y,
+                                                                          group_count_z);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DISPATCH_INDIRECT:
+            {
+                const auto buffer_ptr = reader.read<Anvil::Buffer*>();
+                const auto offset     = reader.read<VkDeviceSize>  ();
+
+                result &= in_command_buffer_ptr->record_dispatch_indirect(buffer_ptr,
+                                                                          offset);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DRAW:
+            {
+                const auto vertex_count   = reader.read<uint32_t>();
+                const auto instance_count = reader.read<uint32_t>();
+                const auto first_vertex   = reader.read<uint32_t>();
+                const auto first_instance = reader.read<uint32_t>();
+
+                result &= in_command_buffer_ptr->record_draw(vertex_count,
+                                                             instance_count,
+                                                             first_vertex,
+                                                             first_instance);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DRAW_INDEXED:
+            {
+                const auto index_count    = reader.read<uint32_t>();
+                const auto instance_count = reader.read<uint32_t>();
+                const auto first_index    = reader.read<uint32_t>();
+                const auto vertex_offset  = reader.read<int32_t> ();
+                const auto first_instance = reader.read<uint32_t>();
+
+                result &= in_command_buffer_ptr->record_draw_indexed(index_count,
+                                                                     instance_count,
+                                                                     first_index,
+                                                                     vertex_offset,
+                                                                     first_instance);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DRAW_INDEXED_INDIRECT:
+            case Anvil::COMMAND_TYPE_DRAW_INDIRECT:
+            {
+                const auto buffer_ptr = reader.read<Anvil::Buffer*>();
+                const auto offset     = reader.read<VkDeviceSize>  ();
+                const auto count      = reader.read<uint32_t>      ();
+                const auto stride     = reader.read<uint32_t>      ();
+
+                if (current_command.get_command_type() == Anvil::COMMAND_TYPE_DRAW_INDEXED_INDIRECT)
+                {
+                    result &= in_command_buffer_ptr->record_draw_indexed_indirect(buffer_ptr,
+                                                                                  offset,
+                                                                                  count,
+                                                                                  stride);
+                }
+                else
+                {
+                    result &= in_command_buffer_ptr->record_draw_indirect(buffer_ptr,
+                                                                          offset,
+                                                                          count,
+                                                                          stride);
+                }
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DRAW_INDEXED_INDIRECT_COUNT_AMD:
+            case Anvil::COMMAND_TYPE_DRAW_INDEXED_INDIRECT_COUNT_KHR:
+            case Anvil::COMMAND_TYPE_DRAW_INDIRECT_COUNT_AMD:
+            case Anvil::COMMAND_TYPE_DRAW_INDIRECT_COUNT_KHR:
+            {
+                const auto buffer_ptr       = reader.read<Anvil::Buffer*>();
+                const auto offset           = reader.read<VkDeviceSize>  ();
+                const auto count_buffer_ptr = reader.read<Anvil::Buffer*>();
+                const auto count_offset     = reader.read<VkDeviceSize>  ();
+                const auto max_draw_count   = reader.read<uint32_t>      ();
+                const auto stride           = reader.read<uint32_t>      ();
+
+                switch (current_command.get_command_type() )
+                {
+                    case Anvil::COMMAND_TYPE_DRAW_INDEXED_INDIRECT_COUNT_AMD: result &= in_command_buffer_ptr->record_draw_indexed_indirect_count_AMD(buffer_ptr, offset, count_buffer_ptr, count_offset, max_draw_count, stride); break;
+                    case Anvil::COMMAND_TYPE_DRAW_INDEXED_INDIRECT_COUNT_KHR: result &= in_command_buffer_ptr->record_draw_indexed_indirect_count_KHR(buffer_ptr, offset, count_buffer_ptr, count_offset, max_draw_count, stride); break;
+                    case Anvil::COMMAND_TYPE_DRAW_INDIRECT_COUNT_AMD:         result &= in_command_buffer_ptr->record_draw_indirect_count_AMD        (buffer_ptr, offset, count_buffer_ptr, count_offset, max_draw_count, stride); break;
+                    case Anvil::COMMAND_TYPE_DRAW_INDIRECT_COUNT_KHR:         result &= in_command_buffer_ptr->record_draw_indirect_count_KHR        (buffer_ptr, offset, count_buffer_ptr, count_offset, max_draw_count, stride); break;
+
+                    default:
+                    {
+                        anvil_assert_fail();
+                    }
+                }
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_DRAW_INDIRECT_BYTE_COUNT_EXT:
+            {
+                const auto instance_count        = reader.read<uint32_t>      ();
+                const auto first_instance        = reader.read<uint32_t>      ();
+                const auto counter_buffer_ptr    = reader.read<Anvil::Buffer*>();
+                const auto counter_buffer_offset = reader.read<VkDeviceSize>  ();
+                const auto counter_offset        = reader.read<uint32_t>      ();
+                const auto vertex_stride         = reader.read<uint32_t>      ();
+
+                result &= in_command_buffer_ptr->record_draw_indirect_byte_count_EXT(instance_count,
+                                                                                     first_instance,
+                                                                                     counter_buffer_ptr,
+                                                                                     counter_buffer_offset,
+                                                                                     counter_offset,
+                                                                                     vertex_stride);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_END_QUERY:
+            {
+                const auto query_pool_ptr = reader.read<Anvil::QueryPool*>();
+                const auto entry          = reader.read<Anvil::QueryIndex>();
+
+                result &= in_command_buffer_ptr->record_end_query(query_pool_ptr,
+                                                                  entry);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_END_QUERY_INDEXED_EXT:
+            {
+                const auto query_pool_ptr = reader.read<Anvil::QueryPool*>();
+                const auto query          = reader.read<Anvil::QueryIndex>();
+                const auto index          = reader.read<uint32_t>         ();
+
+                result &= in_command_buffer_ptr->record_end_query_indexed_EXT(query_pool_ptr,
+                                                                              query,
+                                                                              index);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_END_RENDER_PASS:
+            case Anvil::COMMAND_TYPE_END_RENDER_PASS_2_KHR:
+            {
+                if (primary_command_buffer_ptr == nullptr)
+                {
+                    anvil_assert(primary_command_buffer_ptr != nullptr);
+
+                    result = false;
+                    break;
+                }
+
+                if (current_command.get_command_type() == Anvil::COMMAND_TYPE_END_RENDER_PASS)
+                {
+                    result &= primary_command_buffer_ptr->record_end_render_pass();
+                }
+                else
+                {
+                    result &= primary_command_buffer_ptr->record_end_render_pass2_KHR();
+                }
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_EXECUTE_COMMANDS:
+            {
+                uint32_t n_cmd_buffers = 0;
+
+                const auto cmd_buffer_ptrs = reader.read_array<Anvil::SecondaryCommandBuffer*>(&n_cmd_buffers);
+
+                if (primary_command_buffer_ptr == nullptr)
+                {
+                    anvil_assert(primary_command_buffer_ptr != nullptr);
+
+                    result = false;
+                    break;
+                }
+
+                result &= primary_command_buffer_ptr->record_execute_commands(n_cmd_buffers,
+                                                                              const_cast<Anvil::SecondaryCommandBuffer**>(cmd_buffer_ptrs) );
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_FILL_BUFFER:
+            {
+                const auto dst_buffer_ptr = reader.read<Anvil::Buffer*>();
+                const auto dst_offset     = reader.read<VkDeviceSize>  ();
+                const auto size           = reader.read<VkDeviceSize>  ();
+                const auto data           = reader.read<uint32_t>      ();
+
+                result &= in_command_buffer_ptr->record_fill_buffer(dst_buffer_ptr,
+                                                                    dst_offset,
+                                                                    size,
+                                                                    data);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_NEXT_SUBPASS:
+            case Anvil::COMMAND_TYPE_NEXT_SUBPASS_2_KHR:
+            {
+                const auto contents = reader.read<Anvil::SubpassContents>();
+
+                if (primary_command_buffer_ptr == nullptr)
+                {
+                    anvil_assert(primary_command_buffer_ptr != nullptr);
+
+                    result = false;
+                    break;
+                }
+
+                if (current_command.get_command_type() == Anvil::COMMAND_TYPE_NEXT_SUBPASS)
+                {
+                    result &= primary_command_buffer_ptr->record_next_subpass(contents);
+                }
+                else
+                {
+                    result &= primary_command_buffer_ptr->record_next_subpass2_KHR(contents);
+                }
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_PIPELINE_BARRIER:
+            {
+                std::vector<Anvil::BufferBarrier> buffer_barriers;
+                std::vector<Anvil::ImageBarrier>  image_barriers;
+                std::vector<Anvil::MemoryBarrier> memory_barriers;
+
+                const auto src_stage_mask   = reader.read<Anvil::PipelineStageFlags>();
+                const auto dst_stage_mask   = reader.read<Anvil::PipelineStageFlags>();
+                const auto dependency_flags = reader.read<Anvil::DependencyFlags>   ();
+
+                reader.read_memory_barriers(&memory_barriers);
+                reader.read_buffer_barriers(&buffer_barriers);
+                reader.read_image_barriers (&image_barriers);
+
+                result &= in_command_buffer_ptr->record_pipeline_barrier(src_stage_mask,
+                                                                         dst_stage_mask,
+                                                                         dependency_flags,
+                                                                         static_cast<uint32_t>(memory_barriers.size() ),
+                                                                         (memory_barriers.size() > 0) ? &memory_barriers.at(0) : nullptr,
+                                                                         static_cast<uint32_t>(buffer_barriers.size() ),
+                                                                         (buffer_barriers.size() > 0) ? &buffer_barriers.at(0) : nullptr,
+                                                                         static_cast<uint32_t>(image_barriers.size() ),
+                                                                         (image_barriers.size() > 0)  ? &image_barriers.at(0)  : nullptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_PUSH_CONSTANTS:
+            {
+                uint32_t n_bytes = 0;
+
+                const auto layout_ptr  = reader.read<Anvil::PipelineLayout*> ();
+                const auto stage_flags = reader.read<Anvil::ShaderStageFlags>();
+                const auto offset      = reader.read<uint32_t>               ();
+                const auto values_ptr  = reader.read_array<uint8_t>          (&n_bytes);
+
+                result &= in_command_buffer_ptr->record_push_constants(layout_ptr,
+                                                                       stage_flags,
+                                                                       offset,
+                                                                       n_bytes,
+                                                                       values_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_RESET_EVENT:
+            case Anvil::COMMAND_TYPE_SET_EVENT:
+            {
+                const auto event_ptr  = reader.read<Anvil::Event*>            ();
+                const auto stage_mask = reader.read<Anvil::PipelineStageFlags>();
+
+                if (current_command.get_command_type() == Anvil::COMMAND_TYPE_RESET_EVENT)
+                {
+                    result &= in_command_buffer_ptr->record_reset_event(event_ptr,
+                                                                        stage_mask);
+                }
+                else
+                {
+                    result &= in_command_buffer_ptr->record_set_event(event_ptr,
+                                                                      stage_mask);
+                }
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_RESET_QUERY_POOL:
+            {
+                const auto query_pool_ptr = reader.read<Anvil::QueryPool*>();
+                const auto start_query    = reader.read<Anvil::QueryIndex>();
+                const auto query_count    = reader.read<uint32_t>         ();
+
+                result &= in_command_buffer_ptr->record_reset_query_pool(query_pool_ptr,
+                                                                         start_query,
+                                                                         query_count);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_RESOLVE_IMAGE:
+            {
+                uint32_t n_regions = 0;
+
+                const auto src_image_ptr    = reader.read<Anvil::Image*>            ();
+                const auto src_image_layout = reader.read<Anvil::ImageLayout>       ();
+                const auto dst_image_ptr    = reader.read<Anvil::Image*>            ();
+                const auto dst_image_layout = reader.read<Anvil::ImageLayout>       ();
+                const auto regions_ptr      = reader.read_array<Anvil::ImageResolve>(&n_regions);
+
+                result &= in_command_buffer_ptr->record_resolve_image(src_image_ptr,
+                                                                      src_image_layout,
+                                                                      dst_image_ptr,
+                                                                      dst_image_layout,
+                                                                      n_regions,
+                                                                      regions_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_SET_BLEND_CONSTANTS:
+            {
+                uint32_t n_blend_constants = 0;
+
+                const auto blend_constants_ptr = reader.read_array<float>(&n_blend_constants);
+
+                anvil_assert(n_blend_constants == 4);
+
+                result &= in_command_buffer_ptr->record_set_blend_constants(blend_constants_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_SET_DEPTH_BIAS:
+            {
+                const auto depth_bias_constant_factor = reader.read<float>();
+                const auto depth_bias_clamp           = reader.read<float>();
+                const auto slope_scaled_depth_bias    = reader.read<float>();
+
+                result &= in_command_buffer_ptr->record_set_depth_bias(depth_bias_constant_factor,
+                                                                       depth_bias_clamp,
+                                                                       slope_scaled_depth_bias);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_SET_DEPTH_BOUNDS:
+            {
+                const auto min_depth_bounds = reader.read<float>();
+                const auto max_depth_bounds = reader.read<float>();
+
+                result &= in_command_buffer_ptr->record_set_depth_bounds(min_depth_bounds,
+                                                                         max_depth_bounds);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_SET_DEVICE_MASK_KHR:
+            {
+                result &= in_command_buffer_ptr->record_set_device_mask_KHR(reader.read<uint32_t>() );
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_SET_LINE_WIDTH:
+            {
+                result &= in_command_buffer_ptr->record_set_line_width(reader.read<float>() );
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_SET_SAMPLE_LOCATIONS_EXT:
+            {
+                Anvil::SampleLocationsInfo sample_locations_info;
+
+                reader.read_sample_locations_info(&sample_locations_info);
+
+                result &= in_command_buffer_ptr->record_set_sample_locations_EXT(sample_locations_info);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_SET_SCISSOR:
+            {
+                uint32_t n_scissors = 0;
+
+                const auto first_scissor = reader.read<uint32_t>      ();
+                const auto scissors_ptr  = reader.read_array<VkRect2D>(&n_scissors);
+
+                result &= in_command_buffer_ptr->record_set_scissor(first_scissor,
+                                                                    n_scissors,
+                                                                    scissors_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_SET_STENCIL_COMPARE_MASK:
+            case Anvil::COMMAND_TYPE_SET_STENCIL_REFERENCE:
+            case Anvil::COMMAND_TYPE_SET_STENCIL_WRITE_MASK:
+            {
+                const auto face_mask = reader.read<Anvil::StencilFaceFlags>();
+                const auto value     = reader.read<uint32_t>               ();
+
+                switch (current_command.get_command_type() )
+                {
+                    case Anvil::COMMAND_TYPE_SET_STENCIL_COMPARE_MASK: result &= in_command_buffer_ptr->record_set_stencil_compare_mask(face_mask, value); break;
+                    case Anvil::COMMAND_TYPE_SET_STENCIL_REFERENCE:    result &= in_command_buffer_ptr->record_set_stencil_reference   (face_mask, value); break;
+                    case Anvil::COMMAND_TYPE_SET_STENCIL_WRITE_MASK:   result &= in_command_buffer_ptr->record_set_stencil_write_mask  (face_mask, value); break;
+
+                    default:
+                    {
+                        anvil_assert_fail();
+                    }
+                }
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_SET_VIEWPORT:
+            {
+                uint32_t n_viewports = 0;
+
+                const auto first_viewport = reader.read<uint32_t>        ();
+                const auto viewports_ptr  = reader.read_array<VkViewport>(&n_viewports);
+
+                result &= in_command_buffer_ptr->record_set_viewport(first_viewport,
+                                                                     n_viewports,
+                                                                     viewports_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_UPDATE_BUFFER:
+            {
+                uint32_t n_bytes = 0;
+
+                const auto dst_buffer_ptr = reader.read<Anvil::Buffer*>();
+                const auto dst_offset     = reader.read<VkDeviceSize>  ();
+                const auto data_ptr       = reader.read_array<uint8_t> (&n_bytes);
+
+                result &= in_command_buffer_ptr->record_update_buffer(dst_buffer_ptr,
+                                                                      dst_offset,
+                                                                      n_bytes,
+                                                                      data_ptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_WAIT_EVENTS:
+            {
+                std::vector<Anvil::BufferBarrier> buffer_barriers;
+                std::vector<Anvil::ImageBarrier>  image_barriers;
+                std::vector<Anvil::MemoryBarrier> memory_barriers;
+                uint32_t                          n_events = 0;
+
+                const auto event_ptrs     = reader.read_array<Anvil::Event*>       (&n_events);
+                const auto src_stage_mask = reader.read<Anvil::PipelineStageFlags>();
+                const auto dst_stage_mask = reader.read<Anvil::PipelineStageFlags>();
+
+                reader.read_memory_barriers(&memory_barriers);
+                reader.read_buffer_barriers(&buffer_barriers);
+                reader.read_image_barriers (&image_barriers);
+
+                result &= in_command_buffer_ptr->record_wait_events(n_events,
+                                                                    event_ptrs,
+                                                                    src_stage_mask,
+                                                                    dst_stage_mask,
+                                                                    static_cast<uint32_t>(memory_barriers.size() ),
+                                                                    (memory_barriers.size() > 0) ? &memory_barriers.at(0) : nullptr,
+                                                                    static_cast<uint32_t>(buffer_barriers.size() ),
+                                                                    (buffer_barriers.size() > 0) ? &buffer_barriers.at(0) : nullptr,
+                                                                    static_cast<uint32_t>(image_barriers.size() ),
+                                                                    (image_barriers.size() > 0)  ? &image_barriers.at(0)  : nullptr);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_WRITE_BUFFER_MARKER_AMD:
+            {
+                const auto pipeline_stage = reader.read<Anvil::PipelineStageFlagBits>();
+                const auto dst_buffer_ptr = reader.read<Anvil::Buffer*>              ();
+                const auto dst_offset     = reader.read<VkDeviceSize>                ();
+                const auto marker         = reader.read<uint32_t>                    ();
+
+                result &= in_command_buffer_ptr->record_write_buffer_marker_AMD(pipeline_stage,
+                                                                                dst_buffer_ptr,
+                                                                                dst_offset,
+                                                                                marker);
+
+                break;
+            }
+
+            case Anvil::COMMAND_TYPE_WRITE_TIMESTAMP:
+            {
+                const auto pipeline_stage = reader.read<Anvil::PipelineStageFlagBits>();
+                const auto query_pool_ptr = reader.read<Anvil::QueryPool*>           ();
+                const auto query_index    = reader.read<Anvil::QueryIndex>           ();
+
+                result &= in_command_buffer_ptr->record_write_timestamp(pipeline_stage,
+                                                                        query_pool_ptr,
+                                                                        query_index);
+
+                break;
+            }
+
+            default:
+            {
+                anvil_assert_fail();
+
+                result = false;
+            }
+        }
+    }
+
+    return result;
+}
+
+/** Serializes an array of VK_EXT_sample_locations attachment sample locations. */
+void Anvil::CommandStream::serialize(PayloadWriter*                                 in_writer_ptr,
+                                     const Array<Anvil::AttachmentSampleLocations>& in_array)
+{
+    serialize(in_writer_ptr,
+              in_array.n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < in_array.n_items;
+                ++n_item)
+    {
+        serialize(in_writer_ptr,
+                  in_array.items_ptr[n_item].n_attachment);
+        serialize(in_writer_ptr,
+                  in_array.items_ptr[n_item].sample_locations_info);
+    }
+}
+
+/** Serializes an array of buffer barriers. Only the information needed to re-create the barriers is stored. */
+void Anvil::CommandStream::serialize(PayloadWriter*                     in_writer_ptr,
+                                     const Array<Anvil::BufferBarrier>& in_array)
+{
+    serialize(in_writer_ptr,
+              in_array.n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < in_array.n_items;
+                ++n_item)
+    {
+        const auto&       current_barrier = in_array.items_ptr[n_item];
+        BufferBarrierData data;
+
+        data.buffer_ptr             = current_barrier.buffer_ptr;
+        data.dst_access_mask        = current_barrier.dst_access_mask;
+        data.dst_queue_family_index = current_barrier.dst_queue_family_index;
+        data.offset                 = current_barrier.offset;
+        data.size                   = current_barrier.size;
+        data.src_access_mask        = current_barrier.src_access_mask;
+        data.src_queue_family_index = current_barrier.src_queue_family_index;
+
+        serialize(in_writer_ptr,
+                  data);
+    }
+}
+
+/** Serializes an array of image barriers. Only the information needed to re-create the barriers is stored. */
+void Anvil::CommandStream::serialize(PayloadWriter*                    in_writer_ptr,
+                                     const Array<Anvil::ImageBarrier>& in_array)
+{
+    serialize(in_writer_ptr,
+              in_array.n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < in_array.n_items;
+                ++n_item)
+    {
+        const auto&      current_barrier = in_array.items_ptr[n_item];
+        ImageBarrierData data;
+
+        data.dst_access_mask        = current_barrier.dst_access_mask;
+        data.dst_queue_family_index = current_barrier.dst_queue_family_index;
+        data.image_ptr              = current_barrier.image_ptr;
+        data.new_layout             = current_barrier.new_layout;
+        data.old_layout             = current_barrier.old_layout;
+        data.src_access_mask        = current_barrier.src_access_mask;
+        data.src_queue_family_index = current_barrier.src_queue_family_index;
+        data.subresource_range      = current_barrier.subresource_range;
+
+        serialize(in_writer_ptr,
+                  data);
+    }
+}
+
+/** Serializes an array of memory barriers. */
+void Anvil::CommandStream::serialize(PayloadWriter*                     in_writer_ptr,
+                                     const Array<Anvil::MemoryBarrier>& in_array)
+{
+    serialize(in_writer_ptr,
+              in_array.n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < in_array.n_items;
+                ++n_item)
+    {
+        MemoryBarrierData data;
+
+        data.dst_access_mask = in_array.items_ptr[n_item].destination_access_mask;
+        data.src_access_mask = in_array.items_ptr[n_item].source_access_mask;
+
+        serialize(in_writer_ptr,
+                  data);
+    }
+}
+
+/** Serializes an array of VK_EXT_sample_locations subpass sample locations. */
+void Anvil::CommandStream::serialize(PayloadWriter*                              in_writer_ptr,
+                                     const Array<Anvil::SubpassSampleLocations>& in_array)
+{
+    serialize(in_writer_ptr,
+              in_array.n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < in_array.n_items;
+                ++n_item)
+    {
+        serialize(in_writer_ptr,
+                  in_array.items_ptr[n_item].n_subpass);
+        serialize(in_writer_ptr,
+                  in_array.items_ptr[n_item].sample_locations_info);
+    }
+}
+
+/** Serializes a VK_EXT_sample_locations sample locations info structure. */
+void Anvil::CommandStream::serialize(PayloadWriter*                    in_writer_ptr,
+                                     const Anvil::SampleLocationsInfo& in_info)
+{
+    serialize(in_writer_ptr,
+              in_info.sample_locations_per_pixel);
+    serialize(in_writer_ptr,
+              in_info.sample_location_grid_size);
+    serialize(in_writer_ptr,
+              make_array( (in_info.sample_locations.size() > 0) ? &in_info.sample_locations.at(0) : nullptr,
+                          static_cast<uint32_t>(in_info.sample_locations.size() )) );
+}
+
+/** Serializes a string, including the terminating NULL character. */
+void Anvil::CommandStream::serialize(PayloadWriter*     in_writer_ptr,
+                                     const std::string& in_string)
+{
+    serialize(in_writer_ptr,
+              make_array(in_string.c_str(),
+                         static_cast<uint32_t>(in_string.size() + 1) ));
+}
+
+
+/** Constructor. */
+Anvil::CommandStream::Iterator::Iterator(const CommandStream* in_stream_ptr,
+                                         uint32_t             in_n_chunk,
+                                         uint32_t             in_chunk_offset)
+    :m_chunk_offset(in_chunk_offset),
+     m_n_chunk     (in_n_chunk),
+     m_stream_ptr  (in_stream_ptr)
+{
+    /* Stub */
+}
+
+/** Returns a pointer to the header of the command the iterator points at. */
+const Anvil::CommandStream::CommandHeader* Anvil::CommandStream::Iterator::get_header_ptr() const
+{
+    anvil_assert(m_n_chunk < m_stream_ptr->m_n_chunks_used);
+
+    return reinterpret_cast<const CommandHeader*>(reinterpret_cast<const uint8_t*>(m_stream_ptr->m_chunks.at(m_n_chunk)->storage_ptr.get() ) + m_chunk_offset);
+}
+
+/* Please see header for specification */
+Anvil::CommandStream::Iterator& Anvil::CommandStream::Iterator::operator++()
+{
+    m_chunk_offset += get_n_command_bytes(get_header_ptr()->n_payload_bytes);
+
+    if (m_chunk_offset >= m_stream_ptr->m_chunks.at(m_n_chunk)->n_bytes_used)
+    {
+        m_chunk_offset = 0;
+
+        ++m_n_chunk;
+    }
+
+    return *this;
+}
+
+
+/** Returns a pointer to the next @param in_n_bytes bytes of the payload, after aligning the read offset
+ *  to @param in_alignment.
+ **/
+const uint8_t* Anvil::CommandStream::Reader::get(uint32_t in_n_bytes,
+                                                 uint32_t in_alignment)
+{
+    const uint8_t* result_ptr = nullptr;
+
+    m_offset = Anvil::Utils::round_up(m_offset,
+                                      (in_alignment < sizeof(uint64_t) ) ? in_alignment
+                                                                         : static_cast<uint32_t>(sizeof(uint64_t) ));
+
+    anvil_assert(m_offset + in_n_bytes <= m_n_payload_bytes);
+
+    result_ptr = m_payload_ptr + m_offset;
+    m_offset  += in_n_bytes;
+
+    return result_ptr;
+}
+
+/* Please see header for specification */
+void Anvil::CommandStream::Reader::read_attachment_sample_locations(std::vector<Anvil::AttachmentSampleLocations>* out_result_ptr)
+{
+    const uint32_t n_items = read<uint32_t>();
+
+    out_result_ptr->resize(n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < n_items;
+                ++n_item)
+    {
+        out_result_ptr->at(n_item).n_attachment = read<uint32_t>();
+
+        read_sample_locations_info(&out_result_ptr->at(n_item).sample_locations_info);
+    }
+}
+
+/* Please see header for specification */
+void Anvil::CommandStream::Reader::read_buffer_barriers(std::vector<Anvil::BufferBarrier>* out_result_ptr)
+{
+    const uint32_t n_items = read<uint32_t>();
+
+    out_result_ptr->clear  ();
+    out_result_ptr->reserve(n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < n_items;
+                ++n_item)
+    {
+        const auto& data = read<BufferBarrierData>();
+
+        out_result_ptr->push_back(Anvil::BufferBarrier(data.src_access_mask,
+                                                       data.dst_access_mask,
+                                                       data.src_queue_family_index,
+                                                       data.dst_queue_family_index,
+                                                       data.buffer_ptr,
+                                                       data.offset,
+                                                       data.size) );
+    }
+}
+
+/* Please see header for specification */
+void Anvil::CommandStream::Reader::read_image_barriers(std::vector<Anvil::ImageBarrier>* out_result_ptr)
+{
+    const uint32_t n_items = read<uint32_t>();
+
+    out_result_ptr->clear  ();
+    out_result_ptr->reserve(n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < n_items;
+                ++n_item)
+    {
+        const auto& data = read<ImageBarrierData>();
+
+        out_result_ptr->push_back(Anvil::ImageBarrier(data.src_access_mask,
+                                                      data.dst_access_mask,
+                                                      data.old_layout,
+                                                      data.new_layout,
+                                                      data.src_queue_family_index,
+                                                      data.dst_queue_family_index,
+                                                      data.image_ptr,
+                                                      data.subresource_range) );
+    }
+}
+
+/* Please see header for specification */
+void Anvil::CommandStream::Reader::read_memory_barriers(std::vector<Anvil::MemoryBarrier>* out_result_ptr)
+{
+    const uint32_t n_items = read<uint32_t>();
+
+    out_result_ptr->clear  ();
+    out_result_ptr->reserve(n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < n_items;
+                ++n_item)
+    {
+        const auto& data = read<MemoryBarrierData>();
+
+        out_result_ptr->push_back(Anvil::MemoryBarrier(data.dst_access_mask,
+                                                       data.src_access_mask) );
+    }
+}
+
+/* Please see header for specification */
+void Anvil::CommandStream::Reader::read_sample_locations_info(Anvil::SampleLocationsInfo* out_result_ptr)
+{
+    uint32_t n_sample_locations   = 0;
+    const    Anvil::SampleLocation* sample_locations_ptr = nullptr;
+
+    out_result_ptr->sample_locations_per_pixel = read<Anvil::SampleCountFlagBits>();
+    out_result_ptr->sample_location_grid_size  = read<VkExtent2D>                ();
+    sample_locations_ptr                       = read_array<Anvil::SampleLocation>(&n_sample_locations);
+
+    out_result_ptr->sample_locations.assign(sample_locations_ptr,
+                                            sample_locations_ptr + n_sample_locations);
+}
+
+/* Please see header for specification */
+const char* Anvil::CommandStream::Reader::read_string()
+{
+    uint32_t    n_chars    = 0;
+    const char* result_ptr = read_array<char>(&n_chars);
+
+    anvil_assert(n_chars > 0 && result_ptr[n_chars - 1] == '\0');
+
+    return result_ptr;
+}
+
+/* Please see header for specification */
+void Anvil::CommandStream::Reader::read_subpass_sample_locations(std::vector<Anvil::SubpassSampleLocations>* out_result_ptr)
+{
+    const uint32_t n_items = read<uint32_t>();
+
+    out_result_ptr->resize(n_items);
+
+    for (uint32_t n_item = 0;
+                  n_item < n_items;
+                ++n_item)
+    {
+        out_result_ptr->at(n_item).n_subpass = read<uint32_t>();
+
+        read_sample_locations_info(&out_result_ptr->at(n_item).sample_locations_info);
+    }
+}
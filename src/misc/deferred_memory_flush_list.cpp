@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/deferred_memory_flush_list.h"
+#include "misc/object_tracker.h"
+#include "wrappers/device.h"
+#include "wrappers/memory_block.h"
+
+
+/** Constructor. */
+Anvil::DeferredMemoryFlushList::DeferredMemoryFlushList(const Anvil::BaseDevice* in_device_ptr,
+                                                        bool                     in_mt_safe)
+    :MTSafetySupportProvider  (in_mt_safe),
+     m_device_ptr             (in_device_ptr),
+     m_n_pending_memory_blocks(0),
+     m_n_flush_calls          (0),
+     m_n_flushed_ranges       (0)
+{
+    /* Register the object */
+    Anvil::ObjectTracker::get()->register_object(Anvil::ObjectType::ANVIL_DEFERRED_MEMORY_FLUSH_LIST,
+                                                  this);
+}
+
+/** Destructor */
+Anvil::DeferredMemoryFlushList::~DeferredMemoryFlushList()
+{
+    /* Memory blocks unregister themselves at release time, so anything left here has outlived the device */
+    anvil_assert(m_pending_memory_blocks.size() == 0);
+
+    /* Unregister the object */
+    Anvil::ObjectTracker::get()->unregister_object(Anvil::ObjectType::ANVIL_DEFERRED_MEMORY_FLUSH_LIST,
+                                                    this);
+}
+
+/* Please see header for specification */
+Anvil::DeferredMemoryFlushListUniquePtr Anvil::DeferredMemoryFlushList::create(const Anvil::BaseDevice* in_device_ptr,
+                                                                               bool                     in_mt_safe)
+{
+    DeferredMemoryFlushListUniquePtr result_ptr(nullptr,
+                                                std::default_delete<DeferredMemoryFlushList>() );
+
+    result_ptr.reset(
+        new Anvil::DeferredMemoryFlushList(in_device_ptr,
+                                           in_mt_safe)
+    );
+
+    anvil_assert(result_ptr != nullptr);
+    return result_ptr;
+}
+
+/* Please see header for specification */
+bool Anvil::DeferredMemoryFlushList::flush()
+{
+    bool result = true;
+
+    /* Fast path for the common case, where no memory block has deferred its flushes. */
+    if (m_n_pending_memory_blocks.load() == 0)
+    {
+        goto end;
+    }
+
+    lock();
+    {
+        m_ranges_vk.clear();
+
+        for (auto memory_block_ptr : m_pending_memory_blocks)
+        {
+            memory_block_ptr->pop_pending_flush_ranges(&m_ranges_vk);
+        }
+
+        m_pending_memory_blocks.clear();
+        m_n_pending_memory_blocks.store(0);
+
+        if (m_ranges_vk.size() > 0)
+        {
+            const VkResult result_vk = m_device_ptr->get_dispatch_table().vkFlushMappedMemoryRanges(m_device_ptr->get_device_vk(),
+                                                                                                    static_cast<uint32_t>(m_ranges_vk.size() ),
+                                                                                                    m_ranges_vk.data() );
+
+            anvil_assert_vk_call_succeeded(result_vk);
+
+            result = is_vk_call_successful(result_vk);
+
+            m_n_flush_calls    += 1;
+            m_n_flushed_ranges += m_ranges_vk.size();
+        }
+    }
+    unlock();
+
+end:
+    return result;
+}
+
+/** Called back by MemoryBlock::write() whenever a memory block, which had no dirty ranges, defers a flush.
+ *
+ *  @param in_memory_block_ptr Root memory block which holds the dirty ranges. Must not be nullptr.
+ **/
+void Anvil::DeferredMemoryFlushList::on_memory_block_dirtied(Anvil::MemoryBlock* in_memory_block_ptr)
+{
+    lock();
+    {
+        m_pending_memory_blocks.insert(in_memory_block_ptr);
+
+        m_n_pending_memory_blocks.store(static_cast<uint32_t>(m_pending_memory_blocks.size() ) );
+    }
+    unlock();
+}
+
+/** Called back by root memory blocks which have deferred flushes at some point, when they are about to be released.
+ *
+ *  @param in_memory_block_ptr Memory block which is being released. Must not be nullptr.
+ **/
+void Anvil::DeferredMemoryFlushList::on_memory_block_released(Anvil::MemoryBlock* in_memory_block_ptr)
+{
+    lock();
+    {
+        m_pending_memory_blocks.erase(in_memory_block_ptr);
+
+        m_n_pending_memory_blocks.store(static_cast<uint32_t>(m_pending_memory_blocks.size() ) );
+    }
+    unlock();
+}
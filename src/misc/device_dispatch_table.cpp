@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/device_dispatch_table.h"
+#include <cstring>
+
+/** Please see header for specification */
+Anvil::DeviceDispatchTable::DeviceDispatchTable()
+{
+    memset(this,
+           0,
+           sizeof(*this) );
+}
+
+/** Please see header for specification */
+bool Anvil::DeviceDispatchTable::init(VkDevice in_device_vk)
+{
+    typedef struct
+    {
+        const char* func_name;
+        void**      result_func_ptr;
+        bool        is_core_vk10;
+    } FunctionData;
+
+    const FunctionData functions[] =
+    {
+        {"vkDestroyDevice",                     reinterpret_cast<void**>(&vkDestroyDevice),                     true },
+        {"vkGetDeviceQueue",                    reinterpret_cast<void**>(&vkGetDeviceQueue),                    true },
+        {"vkQueueSubmit",                       reinterpret_cast<void**>(&vkQueueSubmit),                       true },
+        {"vkQueueWaitIdle",                     reinterpret_cast<void**>(&vkQueueWaitIdle),                     true },
+        {"vkDeviceWaitIdle",                    reinterpret_cast<void**>(&vkDeviceWaitIdle),                    true },
+        {"vkAllocateMemory",                    reinterpret_cast<void**>(&vkAllocateMemory),                    true },
+        {"vkFreeMemory",                        reinterpret_cast<void**>(&vkFreeMemory),                        true },
+        {"vkMapMemory",                         reinterpret_cast<void**>(&vkMapMemory),                         true },
+        {"vkUnmapMemory",                       reinterpret_cast<void**>(&vkUnmapMemory),                       true },
+        {"vkFlushMappedMemoryRanges",           reinterpret_cast<void**>(&vkFlushMappedMemoryRanges),           true },
+        {"vkInvalidateMappedMemoryRanges",      reinterpret_cast<void**>(&vkInvalidateMappedMemoryRanges),      true },
+        {"vkGetDeviceMemoryCommitment",         reinterpret_cast<void**>(&vkGetDeviceMemoryCommitment),         true },
+        {"vkBindBufferMemory",                  reinterpret_cast<void**>(&vkBindBufferMemory),                  true },
+        {"vkBindImageMemory",                   reinterpret_cast<void**>(&vkBindImageMemory),                   true },
+        {"vkGetBufferMemoryRequirements",       reinterpret_cast<void**>(&vkGetBufferMemoryRequirements),       true },
+        {"vkGetImageMemoryRequirements",        reinterpret_cast<void**>(&vkGetImageMemoryRequirements),        true },
+        {"vkGetImageSparseMemoryRequirements",  reinterpret_cast<void**>(&vkGetImageSparseMemoryRequirements),  true },
+        {"vkQueueBindSparse",                   reinterpret_cast<void**>(&vkQueueBindSparse),                   true },
+        {"vkCreateFence",                       reinterpret_cast<void**>(&vkCreateFence),                       true },
+        {"vkDestroyFence",                      reinterpret_cast<void**>(&vkDestroyFence),                      true },
+        {"vkResetFences",                       reinterpret_cast<void**>(&vkResetFences),                       true },
+        {"vkGetFenceStatus",                    reinterpret_cast<void**>(&vkGetFenceStatus),                    true },
+        {"vkWaitForFences",                     reinterpret_cast<void**>(&vkWaitForFences),                     true },
+        {"vkCreateSemaphore",                   reinterpret_cast<void**>(&vkCreateSemaphore),                   true },
+        {"vkDestroySemaphore",                  reinterpret_cast<void**>(&vkDestroySemaphore),                  true },
+        {"vkCreateEvent",                       reinterpret_cast<void**>(&vkCreateEvent),                       true },
+        {"vkDestroyEvent",                      reinterpret_cast<void**>(&vkDestroyEvent),                      true },
+        {"vkGetEventStatus",                    reinterpret_cast<void**>(&vkGetEventStatus),                    true },
+        {"vkSetEvent",                          reinterpret_cast<void**>(&vkSetEvent),                          true },
+        {"vkResetEvent",                        reinterpret_cast<void**>(&vkResetEvent),                        true },
+        {"vkCreateQueryPool",                   reinterpret_cast<void**>(&vkCreateQueryPool),                   true },
+        {"vkDestroyQueryPool",                  reinterpret_cast<void**>(&vkDestroyQueryPool),                  true },
+        {"vkGetQueryPoolResults",               reinterpret_cast<void**>(&vkGetQueryPoolResults),               true },
+        {"vkCreateBuffer",                      reinterpret_cast<void**>(&vkCreateBuffer),                      true },
+        {"vkDestroyBuffer",                     reinterpret_cast<void**>(&vkDestroyBuffer),                     true },
+        {"vkCreateBufferView",                  reinterpret_cast<void**>(&vkCreateBufferView),                  true },
+        {"vkDestroyBufferView",                 reinterpret_cast<void**>(&vkDestroyBufferView),                 true },
+        {"vkCreateImage",                       reinterpret_cast<void**>(&vkCreateImage),                       true },
+        {"vkDestroyImage",                      reinterpret_cast<void**>(&vkDestroyImage),                      true },
+        {"vkGetImageSubresourceLayout",         reinterpret_cast<void**>(&vkGetImageSubresourceLayout),         true },
+        {"vkCreateImageView",                   reinterpret_cast<void**>(&vkCreateImageView),                   true },
+        {"vkDestroyImageView",                  reinterpret_cast<void**>(&vkDestroyImageView),                  true },
+        {"vkCreateShaderModule",                reinterpret_cast<void**>(&vkCreateShaderModule),                true },
+        {"vkDestroyShaderModule",               reinterpret_cast<void**>(&vkDestroyShaderModule),               true },
+        {"vkCreatePipelineCache",               reinterpret_cast<void**>(&vkCreatePipelineCache),               true },
+        {"vkDestroyPipelineCache",              reinterpret_cast<void**>(&vkDestroyPipelineCache),              true },
+        {"vkGetPipelineCacheData",              reinterpret_cast<void**>(&vkGetPipelineCacheData),              true },
+        {"vkMergePipelineCaches",               reinterpret_cast<void**>(&vkMergePipelineCaches),               true },
+        {"vkCreateGraphicsPipelines",           reinterpret_cast<void**>(&vkCreateGraphicsPipelines),           true },
+        {"vkCreateComputePipelines",            reinterpret_cast<void**>(&vkCreateComputePipelines),            true },
+        {"vkDestroyPipeline",                   reinterpret_cast<void**>(&vkDestroyPipeline),                   true },
+        {"vkCreatePipelineLayout",              reinterpret_cast<void**>(&vkCreatePipelineLayout),              true },
+        {"vkDestroyPipelineLayout",             reinterpret_cast<void**>(&vkDestroyPipelineLayout),             true },
+        {"vkCreateSampler",                     reinterpret_cast<void**>(&vkCreateSampler),                     true },
+        {"vkDestroySampler",                    reinterpret_cast<void**>(&vkDestroySampler),                    true },
+        {"vkCreateDescriptorSetLayout",         reinterpret_cast<void**>(&vkCreateDescriptorSetLayout),         true },
+        {"vkDestroyDescriptorSetLayout",        reinterpret_cast<void**>(&vkDestroyDescriptorSetLayout),        true },
+        {"vkCreateDescriptorPool",              reinterpret_cast<void**>(&vkCreateDescriptorPool),              true },
+        {"vkDestroyDescriptorPool",             reinterpret_cast<void**>(&vkDestroyDescriptorPool),             true },
+        {"vkResetDescriptorPool",               reinterpret_cast<void**>(&vkResetDescriptorPool),               true },
+        {"vkAllocateDescriptorSets",            reinterpret_cast<void**>(&vkAllocateDescriptorSets),            true },
+        {"vkFreeDescriptorSets",                reinterpret_cast<void**>(&vkFreeDescriptorSets),                true },
+        {"vkUpdateDescriptorSets",              reinterpret_cast<void**>(&vkUpdateDescriptorSets),              true },
+        {"vkCreateFramebuffer",                 reinterpret_cast<void**>(&vkCreateFramebuffer),                 true },
+        {"vkDestroyFramebuffer",                reinterpret_cast<void**>(&vkDestroyFramebuffer),                true },
+        {"vkCreateRenderPass",                  reinterpret_cast<void**>(&vkCreateRenderPass),                  true },
+        {"vkDestroyRenderPass",                 reinterpret_cast<void**>(&vkDestroyRenderPass),                 true },
+        {"vkGetRenderAreaGranularity",          reinterpret_cast<void**>(&vkGetRenderAreaGranularity),          true },
+        {"vkCreateCommandPool",                 reinterpret_cast<void**>(&vkCreateCommandPool),                 true },
+        {"vkDestroyCommandPool",                reinterpret_cast<void**>(&vkDestroyCommandPool),                true },
+        {"vkResetCommandPool",                  reinterpret_cast<void**>(&vkResetCommandPool),                  true },
+        {"vkAllocateCommandBuffers",            reinterpret_cast<void**>(&vkAllocateCommandBuffers),            true },
+        {"vkFreeCommandBuffers",                reinterpret_cast<void**>(&vkFreeCommandBuffers),                true },
+        {"vkBeginCommandBuffer",                reinterpret_cast<void**>(&vkBeginCommandBuffer),                true },
+        {"vkEndCommandBuffer",                  reinterpret_cast<void**>(&vkEndCommandBuffer),                  true },
+        {"vkResetCommandBuffer",                reinterpret_cast<void**>(&vkResetCommandBuffer),                true },
+        {"vkCmdBindPipeline",                   reinterpret_cast<void**>(&vkCmdBindPipeline),                   true },
+        {"vkCmdSetViewport",                    reinterpret_cast<void**>(&vkCmdSetViewport),                    true },
+        {"vkCmdSetScissor",                     reinterpret_cast<void**>(&vkCmdSetScissor),                     true },
+        {"vkCmdSetLineWidth",                   reinterpret_cast<void**>(&vkCmdSetLineWidth),                   true },
+        {"vkCmdSetDepthBias",                   reinterpret_cast<void**>(&vkCmdSetDepthBias),                   true },
+        {"vkCmdSetBlendConstants",              reinterpret_cast<void**>(&vkCmdSetBlendConstants),              true },
+        {"vkCmdSetDepthBounds",                 reinterpret_cast<void**>(&vkCmdSetDepthBounds),                 true },
+        {"vkCmdSetStencilCompareMask",          reinterpret_cast<void**>(&vkCmdSetStencilCompareMask),          true },
+        {"vkCmdSetStencilWriteMask",            reinterpret_cast<void**>(&vkCmdSetStencilWriteMask),            true },
+        {"vkCmdSetStencilReference",            reinterpret_cast<void**>(&vkCmdSetStencilReference),            true },
+        {"vkCmdBindDescriptorSets",             reinterpret_cast<void**>(&vkCmdBindDescriptorSets),             true },
+        {"vkCmdBindIndexBuffer",                reinterpret_cast<void**>(&vkCmdBindIndexBuffer),                true },
+        {"vkCmdBindVertexBuffers",              reinterpret_cast<void**>(&vkCmdBindVertexBuffers),              true },
+        {"vkCmdDraw",                           reinterpret_cast<void**>(&vkCmdDraw),                           true },
+        {"vkCmdDrawIndexed",                    reinterpret_cast<void**>(&vkCmdDrawIndexed),                    true },
+        {"vkCmdDrawIndirect",                   reinterpret_cast<void**>(&vkCmdDrawIndirect),                   true },
+        {"vkCmdDrawIndexedIndirect",            reinterpret_cast<void**>(&vkCmdDrawIndexedIndirect),            true },
+        {"vkCmdDispatch",                       reinterpret_cast<void**>(&vkCmdDispatch),                       true },
+        {"vkCmdDispatchIndirect",               reinterpret_cast<void**>(&vkCmdDispatchIndirect),               true },
+        {"vkCmdCopyBuffer",                     reinterpret_cast<void**>(&vkCmdCopyBuffer),                     true },
+        {"vkCmdCopyImage",                      reinterpret_cast<void**>(&vkCmdCopyImage),                      true },
+        {"vkCmdBlitImage",                      reinterpret_cast<void**>(&vkCmdBlitImage),                      true },
+        {"vkCmdCopyBufferToImage",              reinterpret_cast<void**>(&vkCmdCopyBufferToImage),              true },
+        {"vkCmdCopyImageToBuffer",              reinterpret_cast<void**>(&vkCmdCopyImageToBuffer),              true },
+        {"vkCmdUpdateBuffer",                   reinterpret_cast<void**>(&vkCmdUpdateBuffer),                   true },
+        {"vkCmdFillBuffer",                     reinterpret_cast<void**>(&vkCmdFillBuffer),                     true },
+        {"vkCmdClearColorImage",                reinterpret_cast<void**>(&vkCmdClearColorImage),                true },
+        {"vkCmdClearDepthStencilImage",         reinterpret_cast<void**>(&vkCmdClearDepthStencilImage),         true },
+        {"vkCmdClearAttachments",               reinterpret_cast<void**>(&vkCmdClearAttachments),               true },
+        {"vkCmdResolveImage",                   reinterpret_cast<void**>(&vkCmdResolveImage),                   true },
+        {"vkCmdSetEvent",                       reinterpret_cast<void**>(&vkCmdSetEvent),                       true },
+        {"vkCmdResetEvent",                     reinterpret_cast<void**>(&vkCmdResetEvent),                     true },
+        {"vkCmdWaitEvents",                     reinterpret_cast<void**>(&vkCmdWaitEvents),                     true },
+        {"vkCmdPipelineBarrier",                reinterpret_cast<void**>(&vkCmdPipelineBarrier),                true },
+        {"vkCmdBeginQuery",                     reinterpret_cast<void**>(&vkCmdBeginQuery),                     true },
+        {"vkCmdEndQuery",                       reinterpret_cast<void**>(&vkCmdEndQuery),                       true },
+        {"vkCmdResetQueryPool",                 reinterpret_cast<void**>(&vkCmdResetQueryPool),                 true },
+        {"vkCmdWriteTimestamp",                 reinterpret_cast<void**>(&vkCmdWriteTimestamp),                 true },
+        {"vkCmdCopyQueryPoolResults",           reinterpret_cast<void**>(&vkCmdCopyQueryPoolResults),           true },
+        {"vkCmdPushConstants",                  reinterpret_cast<void**>(&vkCmdPushConstants),                  true },
+        {"vkCmdBeginRenderPass",                reinterpret_cast<void**>(&vkCmdBeginRenderPass),                true },
+        {"vkCmdNextSubpass",                    reinterpret_cast<void**>(&vkCmdNextSubpass),                    true },
+        {"vkCmdEndRenderPass",                  reinterpret_cast<void**>(&vkCmdEndRenderPass),                  true },
+        {"vkCmdExecuteCommands",                reinterpret_cast<void**>(&vkCmdExecuteCommands),                true },
+
+        {"vkBindBufferMemory2",                 reinterpret_cast<void**>(&vkBindBufferMemory2),                 false},
+        {"vkBindImageMemory2",                  reinterpret_cast<void**>(&vkBindImageMemory2),                  false},
+        {"vkCmdDispatchBase",                   reinterpret_cast<void**>(&vkCmdDispatchBase),                   false},
+        {"vkCmdSetDeviceMask",                  reinterpret_cast<void**>(&vkCmdSetDeviceMask),                  false},
+        {"vkCreateDescriptorUpdateTemplate",    reinterpret_cast<void**>(&vkCreateDescriptorUpdateTemplate),    false},
+        {"vkCreateSamplerYcbcrConversion",      reinterpret_cast<void**>(&vkCreateSamplerYcbcrConversion),      false},
+        {"vkDestroyDescriptorUpdateTemplate",   reinterpret_cast<void**>(&vkDestroyDescriptorUpdateTemplate),   false},
+        {"vkDestroySamplerYcbcrConversion",     reinterpret_cast<void**>(&vkDestroySamplerYcbcrConversion),     false},
+        {"vkGetBufferMemoryRequirements2",      reinterpret_cast<void**>(&vkGetBufferMemoryRequirements2),      false},
+        {"vkGetDescriptorSetLayoutSupport",     reinterpret_cast<void**>(&vkGetDescriptorSetLayoutSupport),     false},
+        {"vkGetDeviceGroupPeerMemoryFeatures",  reinterpret_cast<void**>(&vkGetDeviceGroupPeerMemoryFeatures),  false},
+        {"vkGetDeviceQueue2",                   reinterpret_cast<void**>(&vkGetDeviceQueue2),                   false},
+        {"vkGetImageMemoryRequirements2",       reinterpret_cast<void**>(&vkGetImageMemoryRequirements2),       false},
+        {"vkGetImageSparseMemoryRequirements2", reinterpret_cast<void**>(&vkGetImageSparseMemoryRequirements2), false},
+        {"vkTrimCommandPool",                   reinterpret_cast<void**>(&vkTrimCommandPool),                   false},
+        {"vkUpdateDescriptorSetWithTemplate",   reinterpret_cast<void**>(&vkUpdateDescriptorSetWithTemplate),   false},
+    };
+    bool result = true;
+
+    anvil_assert(in_device_vk != VK_NULL_HANDLE);
+
+    for (const auto& current_function : functions)
+    {
+        void* func_ptr = reinterpret_cast<void*>(Anvil::Vulkan::vkGetDeviceProcAddr(in_device_vk,
+                                                                                     current_function.func_name) );
+
+        /* VK 1.0 entrypoints must be exposed by all devices. Do not fall back to Anvil::Vulkan func pointers
+         * if one is missing, as these may dispatch to a different driver. */
+        if (func_ptr          == nullptr &&
+            current_function.is_core_vk10)
+        {
+            anvil_assert_fail();
+
+            result = false;
+        }
+
+        *current_function.result_func_ptr = func_ptr;
+    }
+
+    return result;
+}
@@ -21,18 +21,35 @@
 //
 #include "misc/buffer_create_info.h"
 #include "misc/dummy_window.h"
+#include "misc/fence_create_info.h"
 #include "misc/image_create_info.h"
 #include "misc/io.h"
 #include "misc/swapchain_create_info.h"
 #include "wrappers/buffer.h"
 #include "wrappers/command_buffer.h"
 #include "wrappers/command_pool.h"
+#include "wrappers/device.h"
+#include "wrappers/fence.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/query_pool.h"
+#include "wrappers/queue.h"
 #include "wrappers/semaphore.h"
 #include "wrappers/swapchain.h"
+#include <algorithm>
+#include <cstdio>
 #include <sstream>
 #include <thread>
 
-// #include "miniz/miniz.c"
+/* Number of frames DummyWindowWithPNGSnapshots can have in flight before it needs to read the oldest one back. */
+#define N_CAPTURE_SLOTS (3)
+
+/* Number of frames whose GPU timestamps can be in flight at the same time. */
+#define N_GPU_TIMING_SLOTS (4)
+
+/* Maximum number of threads DummyWindowWithPNGSnapshots may use to encode PNG files. */
+#define N_MAX_ENCODE_WORKER_THREADS (4)
+
+#include "miniz/miniz.c"
 
 /** Please see header for specification */
 Anvil::WindowUniquePtr Anvil::DummyWindow::create(const std::string&      in_title,
@@ -74,7 +91,12 @@ Anvil::DummyWindow::DummyWindow(const std::string&      in_title,
             in_height,
             false, /* in_closable */
             in_present_callback_func, 
-            in_input_callback_collection)
+            in_input_callback_collection),
+     m_benchmark_mode_enabled   (false),
+     m_gpu_timestamp_bits       (0),
+     m_gpu_timestamp_period_nsec(0.0),
+     m_n_benchmark_frames       (0),
+     m_n_gpu_timing_frames      (0)
 {
     m_window_owned = true;
 }
@@ -88,12 +110,256 @@ void Anvil::DummyWindow::close()
     }
 }
 
+/** Please see header for specification */
+bool Anvil::DummyWindow::enable_benchmark_mode(const BenchmarkModeSettings& in_settings)
+{
+    bool result = false;
+
+    anvil_assert(!m_benchmark_mode_enabled);
+
+    m_benchmark_mode_settings = in_settings;
+
+    if (m_benchmark_mode_settings.n_frames > 0)
+    {
+        m_cpu_frame_times_msec.reserve(m_benchmark_mode_settings.n_frames);
+    }
+
+    if (m_benchmark_mode_settings.device_ptr != nullptr)
+    {
+        if (!init_gpu_timing() )
+        {
+            goto end;
+        }
+    }
+
+    m_benchmark_mode_enabled = true;
+    result                   = true;
+end:
+    return result;
+}
+
 /** Creates a new system window and prepares it for usage. */
 bool Anvil::DummyWindow::init()
 {
     return true;
 }
 
+/** Allocates a timestamp query pool and pre-records command buffers which bracket frames with timestamp writes.
+ *
+ *  If the device does not support timestamp queries on the universal queue family, GPU timing is silently disabled.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::DummyWindow::init_gpu_timing()
+{
+    Anvil::CommandPool*      command_pool_ptr   = nullptr;
+    const Anvil::BaseDevice* device_ptr         = m_benchmark_mode_settings.device_ptr;
+    const auto&              limits             = device_ptr->get_physical_device_properties().core_vk1_0_properties_ptr->limits;
+    Anvil::Queue*            queue_ptr          = device_ptr->get_universal_queue(0);
+    const uint32_t           queue_family_index = (queue_ptr != nullptr) ? queue_ptr->get_queue_family_index() : UINT32_MAX;
+    bool                     result             = false;
+
+    if (device_ptr->get_type() != Anvil::DeviceType::SINGLE_GPU)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (queue_ptr == nullptr)
+    {
+        anvil_assert(queue_ptr != nullptr);
+
+        goto end;
+    }
+
+    m_gpu_timestamp_bits        = device_ptr->get_queue_family_info(queue_family_index)->n_timestamp_bits;
+    m_gpu_timestamp_period_nsec = static_cast<double>(limits.timestamp_period);
+
+    if (m_gpu_timestamp_bits == 0)
+    {
+        /* Timestamps are not supported. Fall back to CPU-only timing. */
+        m_benchmark_mode_settings.device_ptr = nullptr;
+        result                               = true;
+
+        goto end;
+    }
+
+    command_pool_ptr            = device_ptr->get_command_pool_for_queue_family_index(queue_family_index);
+    m_gpu_timing_query_pool_ptr = Anvil::QueryPool::create_non_ps_query_pool(device_ptr,
+                                                                             VK_QUERY_TYPE_TIMESTAMP,
+                                                                             N_GPU_TIMING_SLOTS * 2);
+
+    if (m_gpu_timing_query_pool_ptr == nullptr)
+    {
+        anvil_assert(m_gpu_timing_query_pool_ptr != nullptr);
+
+        goto end;
+    }
+
+    for (uint32_t n_slot = 0;
+                  n_slot < N_GPU_TIMING_SLOTS;
+                ++n_slot)
+    {
+        std::unique_ptr<GPUTimingSlot> slot_ptr(new GPUTimingSlot() );
+
+        slot_ptr->end_cmd_buffer_ptr   = command_pool_ptr->alloc_primary_level_command_buffer();
+        slot_ptr->fence_ptr            = Anvil::Fence::create(Anvil::FenceCreateInfo::create(device_ptr,
+                                                                                             false /* in_create_signalled */) );
+        slot_ptr->start_cmd_buffer_ptr = command_pool_ptr->alloc_primary_level_command_buffer();
+
+        if (slot_ptr->end_cmd_buffer_ptr   == nullptr ||
+            slot_ptr->fence_ptr            == nullptr ||
+            slot_ptr->start_cmd_buffer_ptr == nullptr)
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        slot_ptr->start_cmd_buffer_ptr->start_recording(false,  /* in_one_time_submit          */
+                                                        false); /* in_simultaneous_use_allowed */
+        {
+            slot_ptr->start_cmd_buffer_ptr->record_reset_query_pool(m_gpu_timing_query_pool_ptr.get(),
+                                                                    n_slot * 2, /* in_start_query */
+                                                                    2);         /* in_query_count */
+            slot_ptr->start_cmd_buffer_ptr->record_write_timestamp (Anvil::PipelineStageFlagBits::TOP_OF_PIPE_BIT,
+                                                                    m_gpu_timing_query_pool_ptr.get(),
+                                                                    n_slot * 2);
+        }
+        slot_ptr->start_cmd_buffer_ptr->stop_recording();
+
+        slot_ptr->end_cmd_buffer_ptr->start_recording(false,  /* in_one_time_submit          */
+                                                      false); /* in_simultaneous_use_allowed */
+        {
+            slot_ptr->end_cmd_buffer_ptr->record_write_timestamp(Anvil::PipelineStageFlagBits::BOTTOM_OF_PIPE_BIT,
+                                                                 m_gpu_timing_query_pool_ptr.get(),
+                                                                 n_slot * 2 + 1);
+        }
+        slot_ptr->end_cmd_buffer_ptr->stop_recording();
+
+        m_gpu_timing_slots.push_back(std::move(slot_ptr) );
+    }
+
+    if (m_benchmark_mode_settings.n_frames > 0)
+    {
+        m_gpu_frame_times_msec.reserve(m_benchmark_mode_settings.n_frames);
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/** Closes the benchmark frame started with a preceding on_frame_started() call. Stores the CPU frame time,
+ *  kicks off the closing GPU timestamp and, if a frame time target was specified, sleeps until it is met.
+ **/
+void Anvil::DummyWindow::on_frame_finished()
+{
+    if (!m_benchmark_mode_enabled)
+    {
+        return;
+    }
+
+    const auto frame_end_time = std::chrono::steady_clock::now();
+
+    m_cpu_frame_times_msec.push_back(std::chrono::duration<double, std::milli>(frame_end_time - m_frame_start_time).count() );
+
+    if (m_gpu_timing_slots.size() > 0)
+    {
+        Anvil::PrimaryCommandBuffer* cmd_buffer_ptr = nullptr;
+        Anvil::Queue*                queue_ptr      = m_benchmark_mode_settings.device_ptr->get_universal_queue(0);
+        auto                         slot_ptr       = m_gpu_timing_slots.at(m_n_gpu_timing_frames % N_GPU_TIMING_SLOTS).get();
+
+        cmd_buffer_ptr = slot_ptr->end_cmd_buffer_ptr.get();
+
+        queue_ptr->submit(
+            Anvil::SubmitInfo::create_execute(cmd_buffer_ptr,
+                                              false, /* in_should_block */
+                                              slot_ptr->fence_ptr.get() )
+        );
+
+        slot_ptr->is_pending = true;
+
+        ++m_n_gpu_timing_frames;
+    }
+
+    if (++m_n_benchmark_frames == m_benchmark_mode_settings.n_frames)
+    {
+        close();
+    }
+
+    if (m_benchmark_mode_settings.target_frame_time_usec > 0)
+    {
+        std::this_thread::sleep_until(m_frame_start_time + std::chrono::microseconds(m_benchmark_mode_settings.target_frame_time_usec) );
+    }
+}
+
+/** Marks the beginning of a benchmark frame. Submits the opening GPU timestamp, after retrieving results of
+ *  the frame which used the same timing slot before (if any).
+ **/
+void Anvil::DummyWindow::on_frame_started()
+{
+    if (!m_benchmark_mode_enabled)
+    {
+        return;
+    }
+
+    m_frame_start_time = std::chrono::steady_clock::now();
+
+    if (m_gpu_timing_slots.size() > 0)
+    {
+        Anvil::PrimaryCommandBuffer* cmd_buffer_ptr = nullptr;
+        const uint32_t               n_slot         = m_n_gpu_timing_frames % N_GPU_TIMING_SLOTS;
+        Anvil::Queue*                queue_ptr      = m_benchmark_mode_settings.device_ptr->get_universal_queue(0);
+        auto                         slot_ptr       = m_gpu_timing_slots.at(n_slot).get();
+
+        if (slot_ptr->is_pending)
+        {
+            retrieve_gpu_timing_results(slot_ptr,
+                                        n_slot);
+        }
+
+        cmd_buffer_ptr = slot_ptr->start_cmd_buffer_ptr.get();
+
+        queue_ptr->submit(
+            Anvil::SubmitInfo::create_execute(cmd_buffer_ptr,
+                                              false) /* in_should_block */
+        );
+    }
+}
+
+/** Waits until GPU-side execution of the frame assigned to the specified timing slot finishes, stores
+ *  the GPU frame time and makes the slot available for reuse.
+ **/
+void Anvil::DummyWindow::retrieve_gpu_timing_results(GPUTimingSlot* in_slot_ptr,
+                                                     uint32_t       in_n_slot)
+{
+    bool           all_results_retrieved = false;
+    const uint64_t timestamp_mask        = (m_gpu_timestamp_bits >= 64) ? UINT64_MAX
+                                                                        : ((1ull << m_gpu_timestamp_bits) - 1);
+    uint64_t       timestamps[2];
+
+    anvil_assert(in_slot_ptr->is_pending);
+
+    in_slot_ptr->fence_ptr->wait();
+    in_slot_ptr->fence_ptr->reset();
+
+    if (m_gpu_timing_query_pool_ptr->get_query_pool_results(in_n_slot * 2, /* in_first_query_index */
+                                                            2,             /* in_n_queries         */
+                                                            Anvil::QueryResultFlagBits::WAIT_BIT,
+                                                            timestamps,
+                                                           &all_results_retrieved) &&
+        all_results_retrieved)
+    {
+        const uint64_t n_ticks = (timestamps[1] - timestamps[0]) & timestamp_mask;
+
+        m_gpu_frame_times_msec.push_back(static_cast<double>(n_ticks) * m_gpu_timestamp_period_nsec / 1000000.0);
+    }
+
+    in_slot_ptr->is_pending = false;
+}
+
 /* Please see header for specification */
 void Anvil::DummyWindow::run()
 {
@@ -103,10 +369,16 @@ void Anvil::DummyWindow::run()
 
         while (running && !m_window_should_close)
         {
-            m_present_callback_func();
+            on_frame_started();
+            {
+                m_present_callback_func();
+            }
+            on_frame_finished();
 
             running = !m_window_should_close;
         }
+
+        write_benchmark_summary();
     }
     else
     {
@@ -120,6 +392,107 @@ void Anvil::DummyWindow::run()
     m_window_close_finished = true;
 }
 
+/** Retrieves GPU timings of all frames still in flight and writes a frame time summary to the file specified
+ *  at enable_benchmark_mode() call time (or stdout).
+ *
+ *  No-op if benchmark mode is disabled.
+ **/
+void Anvil::DummyWindow::write_benchmark_summary()
+{
+    FILE* file_ptr = nullptr;
+
+    if (!m_benchmark_mode_enabled)
+    {
+        return;
+    }
+
+    /* Frames are assigned to slots round-robin, so start with the oldest one */
+    for (uint32_t n_slot_iteration = 0;
+                  n_slot_iteration < static_cast<uint32_t>(m_gpu_timing_slots.size() );
+                ++n_slot_iteration)
+    {
+        const uint32_t n_slot   = (m_n_gpu_timing_frames + n_slot_iteration) % N_GPU_TIMING_SLOTS;
+        auto           slot_ptr = m_gpu_timing_slots.at(n_slot).get();
+
+        if (slot_ptr->is_pending)
+        {
+            retrieve_gpu_timing_results(slot_ptr,
+                                        n_slot);
+        }
+    }
+
+    if (m_benchmark_mode_settings.summary_file_name.empty() )
+    {
+        file_ptr = stdout;
+    }
+    else
+    {
+        file_ptr = fopen(m_benchmark_mode_settings.summary_file_name.c_str(),
+                         "wt");
+
+        if (file_ptr == nullptr)
+        {
+            anvil_assert(file_ptr != nullptr);
+
+            return;
+        }
+    }
+
+    fprintf(file_ptr,
+            "%s: %u frames\n",
+            m_title.c_str(),
+            m_n_benchmark_frames);
+
+    for (uint32_t n_timing_type = 0;
+                  n_timing_type < 2;
+                ++n_timing_type)
+    {
+        std::vector<double>& frame_times = (n_timing_type == 0) ? m_cpu_frame_times_msec
+                                                                : m_gpu_frame_times_msec;
+        const char*          name        = (n_timing_type == 0) ? "CPU" : "GPU";
+        double               sum         = 0.0;
+
+        if (frame_times.size() == 0)
+        {
+            continue;
+        }
+
+        std::sort(frame_times.begin(),
+                  frame_times.end() );
+
+        for (const auto& current_frame_time : frame_times)
+        {
+            sum += current_frame_time;
+        }
+
+        /* Nearest-rank percentiles */
+        auto get_percentile = [&frame_times](uint32_t in_percentile)
+        {
+            size_t rank = (frame_times.size() * in_percentile + 99) / 100;
+
+            return frame_times.at( (rank > 0) ? rank - 1 : 0);
+        };
+
+        fprintf(file_ptr,
+                "%s frame time [ms]: avg %.3f p50 %.3f p95 %.3f p99 %.3f max %.3f\n",
+                name,
+                sum / static_cast<double>(frame_times.size() ),
+                get_percentile(50),
+                get_percentile(95),
+                get_percentile(99),
+                frame_times.back() );
+    }
+
+    if (file_ptr != stdout)
+    {
+        fclose(file_ptr);
+    }
+    else
+    {
+        fflush(file_ptr);
+    }
+}
+
 
 /** Please see header for specification */
 Anvil::WindowUniquePtr Anvil::DummyWindowWithPNGSnapshots::create(const std::string&      in_title,
@@ -162,107 +535,316 @@ Anvil::DummyWindowWithPNGSnapshots::DummyWindowWithPNGSnapshots(const std::strin
                  in_present_callback_func,
                  in_input_callback_collection)
 {
-    m_height             = in_height;
-    m_n_frames_presented = 0;
-    m_swapchain_ptr      = nullptr;
-    m_title              = in_title;
-    m_width              = in_width;
-    m_window_owned       = true;
+    m_capture_image_height         = 0;
+    m_capture_image_width          = 0;
+    m_capture_pipeline_initialized = false;
+    m_encode_workers_should_quit   = false;
+    m_height                       = in_height;
+    m_n_frames_presented           = 0;
+    m_swapchain_ptr                = nullptr;
+    m_title                        = in_title;
+    m_width                        = in_width;
+    m_window_owned                 = true;
 }
 
 /** Please see header for specification */
-std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_image_raw_r8g8b8a8_unorm_data(Anvil::Image* in_swapchain_image_ptr)
+Anvil::DummyWindowWithPNGSnapshots::~DummyWindowWithPNGSnapshots()
 {
-    const Anvil::BaseDevice*           device_ptr                       (m_swapchain_ptr->get_create_info_ptr()->get_device() );
-    std::unique_ptr<uint8_t[]>         result_ptr;
-    Anvil::Format                      swapchain_image_format           (in_swapchain_image_ptr->get_create_info_ptr()->get_format() );
-    const Anvil::ImageSubresourceRange swapchain_image_subresource_range(in_swapchain_image_ptr->get_subresource_range            () );
+    finish_pending_captures();
+}
 
-    /* Sanity checks .. */
-    ANVIL_REDUNDANT_VARIABLE(swapchain_image_format);
+/** Entry-point for PNG encoder threads. Converts queued raw frames to PNG blobs and stores them in files,
+ *  until finish_pending_captures() asks the workers to quit and the job queue has been drained.
+ */
+void Anvil::DummyWindowWithPNGSnapshots::encode_worker_thread_entrypoint()
+{
+    while (true)
+    {
+        EncodeJob job;
 
-    anvil_assert(swapchain_image_subresource_range.aspect_mask == Anvil::ImageAspectFlagBits::COLOR_BIT);
+        {
+            std::unique_lock<std::mutex> lock(m_encode_jobs_mutex);
 
-    /* Initialize storage for the raw R8G8B8A8 image data */
-    Anvil::BufferUniquePtr raw_image_buffer_ptr;
-    uint32_t               raw_image_size         = 0;
-    uint32_t               swapchain_image_height = 0;
-    uint32_t               swapchain_image_width  = 0;
+            m_encode_jobs_cv.wait(lock,
+                                  [this]()
+                                  {
+                                      return m_encode_workers_should_quit || !m_encode_jobs.empty();
+                                  });
 
-    in_swapchain_image_ptr->get_image_mipmap_size(0, /* n_mipmap */
-                                                 &swapchain_image_width,
-                                                 &swapchain_image_height,
-                                                 nullptr); /* out_opt_depth_ptr */
+            if (m_encode_jobs.empty() )
+            {
+                /* Quit request, with no more work left to do */
+                break;
+            }
 
-    raw_image_size = 4 /* RGBA8 */ * swapchain_image_width * swapchain_image_height;
+            job = std::move(m_encode_jobs.front() );
 
-    result_ptr.reset(new unsigned char[raw_image_size]);
+            m_encode_jobs.pop_front();
+        }
 
-    {
-        auto create_info_ptr = Anvil::BufferCreateInfo::create_alloc(device_ptr,
-                                                                     raw_image_size,
-                                                                     Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
-                                                                     Anvil::SharingMode::EXCLUSIVE,
-                                                                     Anvil::BufferCreateFlagBits::NONE,
-                                                                     Anvil::BufferUsageFlagBits::TRANSFER_DST_BIT,
-                                                                     Anvil::MemoryFeatureFlagBits::MAPPABLE_BIT);
+        /* Wake up the render thread, in case it is waiting for the queue to shrink */
+        m_encode_jobs_cv.notify_all();
+
+        /* Convert the raw data to a PNG blob */
+        size_t result_data_size = 0;
+        void*  result_data_ptr  = tdefl_write_image_to_png_file_in_memory(job.raw_data_ptr.get(),
+                                                                          static_cast<int32_t>(m_capture_image_width),
+                                                                          static_cast<int32_t>(m_capture_image_height),
+                                                                          4, /* num_chans */
+                                                                         &result_data_size);
 
-        create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
+        anvil_assert(result_data_ptr != nullptr);
+
+        if (result_data_ptr != nullptr)
+        {
+            /* Store it in a file */
+            Anvil::IO::write_binary_file(job.file_name,
+                                         result_data_ptr,
+                                         static_cast<uint32_t>(result_data_size) );
 
-        raw_image_buffer_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
+            mz_free(result_data_ptr);
+        }
     }
+}
 
-    /* 2. Create the intermediate image */
-    Anvil::ImageBlit intermediate_image_blit;
-    ImageUniquePtr   intermediate_image_ptr;
+/** Reads back all frames still in flight, waits until the encoder threads store them and terminates
+ *  the threads. The capture pipeline is re-initialized if another frame is stored afterward.
+ */
+void Anvil::DummyWindowWithPNGSnapshots::finish_pending_captures()
+{
+    if (!m_capture_pipeline_initialized)
+    {
+        return;
+    }
+
+    /* Slots are used round-robin, so retire the oldest frame first */
+    const uint32_t n_capture_slots = static_cast<uint32_t>(m_capture_slots.size() );
+
+    for (uint32_t n_slot_iteration = 0;
+                  n_slot_iteration < n_capture_slots;
+                ++n_slot_iteration)
+    {
+        auto slot_ptr = m_capture_slots.at( (m_n_frames_presented + n_slot_iteration) % n_capture_slots).get();
+
+        if (slot_ptr->is_pending)
+        {
+            retire_capture_slot(slot_ptr);
+        }
+    }
 
     {
-        auto create_info_ptr = Anvil::ImageCreateInfo::create_alloc(device_ptr,
-                                                                    Anvil::ImageType::_2D,
-                                                                    Anvil::Format::R8G8B8A8_UNORM,
-                                                                    Anvil::ImageTiling::OPTIMAL,
-                                                                    Anvil::ImageUsageFlagBits::TRANSFER_SRC_BIT | Anvil::ImageUsageFlagBits::TRANSFER_DST_BIT,
-                                                                    swapchain_image_width,
-                                                                    swapchain_image_height,
-                                                                    1,      /* in_base_mipmap_depth */
-                                                                    1,      /* in_n_layers          */
-                                                                    Anvil::SampleCountFlagBits::_1_BIT,
-                                                                    Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
-                                                                    Anvil::SharingMode::EXCLUSIVE,
-                                                                    false,  /* in_use_full_mipmap_chain */
-                                                                    Anvil::MemoryFeatureFlagBits::NONE,
-                                                                    Anvil::ImageCreateFlagBits::NONE,
-                                                                    Anvil::ImageLayout::TRANSFER_DST_OPTIMAL);
+        std::unique_lock<std::mutex> lock(m_encode_jobs_mutex);
 
-        create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
+        m_encode_workers_should_quit = true;
+    }
+
+    m_encode_jobs_cv.notify_all();
 
-        intermediate_image_ptr = Anvil::Image::create(std::move(create_info_ptr) );
+    for (auto& current_thread : m_encode_worker_threads)
+    {
+        current_thread.join();
     }
 
-    /* 3. Set up the command buffer */
-    auto                command_buffer_ptr           = Anvil::PrimaryCommandBufferUniquePtr();
-    Anvil::CommandPool* universal_command_pool_ptr   = nullptr;
-    Anvil::Queue*       universal_queue_ptr          = device_ptr->get_universal_queue            (0);
-    const uint32_t      universal_queue_family_index = universal_queue_ptr->get_queue_family_index();
+    m_capture_slots.clear        ();
+    m_encode_worker_threads.clear();
+
+    m_capture_pipeline_initialized = false;
+    m_encode_workers_should_quit   = false;
+}
 
+/** Creates capture slots, pre-records readback command buffers for all swapchain images and spawns
+ *  the PNG encoder threads.
+ *
+ *  @return true if successful, false otherwise.
+ */
+bool Anvil::DummyWindowWithPNGSnapshots::init_capture_pipeline()
+{
+    const Anvil::BaseDevice* device_ptr                 = m_swapchain_ptr->get_create_info_ptr()->get_device();
+    uint32_t                 n_encode_worker_threads    = std::thread::hardware_concurrency() / 2;
+    const uint32_t           n_swapchain_images         = m_swapchain_ptr->get_n_images();
+    uint32_t                 raw_image_size             = 0;
+    bool                     result                     = false;
+    Anvil::CommandPool*      universal_command_pool_ptr = nullptr;
+    Anvil::Queue*            universal_queue_ptr        = device_ptr->get_universal_queue(0);
+
+    anvil_assert(!m_capture_pipeline_initialized);
+
+    m_swapchain_ptr->get_image(0)->get_image_mipmap_size(0, /* n_mipmap */
+                                                        &m_capture_image_width,
+                                                        &m_capture_image_height,
+                                                         nullptr); /* out_opt_depth_ptr */
+
+    raw_image_size             = 4 /* RGBA8 */ * m_capture_image_width * m_capture_image_height;
     universal_command_pool_ptr = device_ptr->get_command_pool_for_queue_family_index(universal_queue_ptr->get_queue_family_index() );
-    command_buffer_ptr         = universal_command_pool_ptr->alloc_primary_level_command_buffer();
 
-    command_buffer_ptr->start_recording(true,   /* one_time_submit          */
-                                        false); /* simultaneous_use_allowed */
+    for (uint32_t n_slot = 0;
+                  n_slot < N_CAPTURE_SLOTS;
+                ++n_slot)
     {
-        Anvil::BufferImageCopy buffer_image_copy_region;
+        std::unique_ptr<CaptureSlot> slot_ptr(new CaptureSlot() );
 
-        Anvil::ImageBarrier general_to_transfer_src_image_barrier(
-            Anvil::AccessFlagBits::COLOR_ATTACHMENT_WRITE_BIT | Anvil::AccessFlagBits::TRANSFER_WRITE_BIT | Anvil::AccessFlagBits::MEMORY_READ_BIT, /* source_access_mask      */
-            Anvil::AccessFlagBits::TRANSFER_READ_BIT,                                                                                               /* destination_access_mask */
-            Anvil::ImageLayout::GENERAL,
-            Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
-            universal_queue_family_index,
-            universal_queue_family_index,
-            in_swapchain_image_ptr,
-            swapchain_image_subresource_range
+        /* 1. Initialize storage for the raw R8G8B8A8 image data. The buffer stays mapped for the lifetime
+         *    of the slot, so that reading the data back does not require a map()/unmap() round-trip.
+         */
+        {
+            auto create_info_ptr = Anvil::BufferCreateInfo::create_alloc(device_ptr,
+                                                                         raw_image_size,
+                                                                         Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
+                                                                         Anvil::SharingMode::EXCLUSIVE,
+                                                                         Anvil::BufferCreateFlagBits::NONE,
+                                                                         Anvil::BufferUsageFlagBits::TRANSFER_DST_BIT,
+                                                                         Anvil::MemoryFeatureFlagBits::MAPPABLE_BIT);
+
+            create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
+
+            slot_ptr->readback_buffer_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
+        }
+
+        if (slot_ptr->readback_buffer_ptr == nullptr ||
+           !slot_ptr->readback_buffer_ptr->get_memory_block(0)->map(0, /* in_start_offset */
+                                                                    raw_image_size) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        /* 2. Create the intermediate image */
+        {
+            auto create_info_ptr = Anvil::ImageCreateInfo::create_alloc(device_ptr,
+                                                                        Anvil::ImageType::_2D,
+                                                                        Anvil::Format::R8G8B8A8_UNORM,
+                                                                        Anvil::ImageTiling::OPTIMAL,
+                                                                        Anvil::ImageUsageFlagBits::TRANSFER_SRC_BIT | Anvil::ImageUsageFlagBits::TRANSFER_DST_BIT,
+                                                                        m_capture_image_width,
+                                                                        m_capture_image_height,
+                                                                        1,      /* in_base_mipmap_depth */
+                                                                        1,      /* in_n_layers          */
+                                                                        Anvil::SampleCountFlagBits::_1_BIT,
+                                                                        Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
+                                                                        Anvil::SharingMode::EXCLUSIVE,
+                                                                        false,  /* in_use_full_mipmap_chain */
+                                                                        Anvil::MemoryFeatureFlagBits::NONE,
+                                                                        Anvil::ImageCreateFlagBits::NONE,
+                                                                        Anvil::ImageLayout::TRANSFER_DST_OPTIMAL);
+
+            create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
+
+            slot_ptr->intermediate_image_ptr = Anvil::Image::create(std::move(create_info_ptr) );
+        }
+
+        slot_ptr->fence_ptr = Anvil::Fence::create(Anvil::FenceCreateInfo::create(device_ptr,
+                                                                                  false /* in_create_signalled */) );
+
+        if (slot_ptr->intermediate_image_ptr == nullptr ||
+            slot_ptr->fence_ptr              == nullptr)
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        /* 3. Set up the command buffers */
+        for (uint32_t n_swapchain_image = 0;
+                      n_swapchain_image < n_swapchain_images;
+                    ++n_swapchain_image)
+        {
+            auto command_buffer_ptr = universal_command_pool_ptr->alloc_primary_level_command_buffer();
+
+            if (command_buffer_ptr == nullptr)
+            {
+                anvil_assert(command_buffer_ptr != nullptr);
+
+                goto end;
+            }
+
+            record_capture_commands(command_buffer_ptr.get(),
+                                    m_swapchain_ptr->get_image(n_swapchain_image),
+                                    slot_ptr.get() );
+
+            slot_ptr->cmd_buffer_ptrs.push_back(std::move(command_buffer_ptr) );
+        }
+
+        m_capture_slots.push_back(std::move(slot_ptr) );
+    }
+
+    /* 4. Spawn the encoder threads */
+    n_encode_worker_threads = std::max(1u,
+                                       std::min(n_encode_worker_threads,
+                                                static_cast<uint32_t>(N_MAX_ENCODE_WORKER_THREADS) ));
+
+    for (uint32_t n_thread = 0;
+                  n_thread < n_encode_worker_threads;
+                ++n_thread)
+    {
+        m_encode_worker_threads.push_back(
+            std::thread(&DummyWindowWithPNGSnapshots::encode_worker_thread_entrypoint,
+                        this)
         );
+    }
+
+    m_capture_pipeline_initialized = true;
+    result                         = true;
+end:
+    if (!result)
+    {
+        m_capture_slots.clear();
+    }
+
+    return result;
+}
+
+/** Records commands which copy contents of the specified swapchain image to the readback buffer of the specified
+ *  capture slot, converting them to R8G8B8A8_UNORM on the way.
+ *
+ *  The recorded command buffer can be submitted any number of times, as long as the previous submission
+ *  has finished executing.
+ */
+void Anvil::DummyWindowWithPNGSnapshots::record_capture_commands(Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr,
+                                                                 Anvil::Image*                in_swapchain_image_ptr,
+                                                                 CaptureSlot*                 in_slot_ptr)
+{
+    const Anvil::BaseDevice*           device_ptr                       (m_swapchain_ptr->get_create_info_ptr()->get_device() );
+    Anvil::Image*                      intermediate_image_ptr           (in_slot_ptr->intermediate_image_ptr.get() );
+    Anvil::Format                      swapchain_image_format           (in_swapchain_image_ptr->get_create_info_ptr()->get_format() );
+    const Anvil::ImageSubresourceRange swapchain_image_subresource_range(in_swapchain_image_ptr->get_subresource_range            () );
+    const uint32_t                     universal_queue_family_index     (device_ptr->get_universal_queue(0)->get_queue_family_index() );
+
+    /* Sanity checks .. */
+    ANVIL_REDUNDANT_VARIABLE(swapchain_image_format);
+
+    anvil_assert(swapchain_image_subresource_range.aspect_mask == Anvil::ImageAspectFlagBits::COLOR_BIT);
+
+    in_cmd_buffer_ptr->start_recording(false,  /* one_time_submit          */
+                                       false); /* simultaneous_use_allowed */
+    {
+        Anvil::BufferImageCopy buffer_image_copy_region;
+        Anvil::ImageBlit       intermediate_image_blit;
+
+        /* NOTE: The intermediate image is transitioned from UNDEFINED, since its contents from the previous
+         *       submission need not be preserved. */
+        const Anvil::ImageBarrier pre_blit_image_barriers[] =
+        {
+            Anvil::ImageBarrier(
+                Anvil::AccessFlagBits::COLOR_ATTACHMENT_WRITE_BIT | Anvil::AccessFlagBits::TRANSFER_WRITE_BIT | Anvil::AccessFlagBits::MEMORY_READ_BIT, /* source_access_mask      */
+                Anvil::AccessFlagBits::TRANSFER_READ_BIT,                                                                                               /* destination_access_mask */
+                Anvil::ImageLayout::GENERAL,
+                Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
+                universal_queue_family_index,
+                universal_queue_family_index,
+                in_swapchain_image_ptr,
+                swapchain_image_subresource_range),
+
+            Anvil::ImageBarrier(
+                Anvil::AccessFlagBits::TRANSFER_READ_BIT,  /* source_access_mask      */
+                Anvil::AccessFlagBits::TRANSFER_WRITE_BIT, /* destination_access_mask */
+                Anvil::ImageLayout::UNDEFINED,
+                Anvil::ImageLayout::TRANSFER_DST_OPTIMAL,
+                universal_queue_family_index,
+                universal_queue_family_index,
+                intermediate_image_ptr,
+                swapchain_image_subresource_range)
+        };
 
         Anvil::ImageBarrier transfer_dst_to_transfer_src_image_barrier(
             Anvil::AccessFlagBits::TRANSFER_WRITE_BIT, /* source_access_mask      */
@@ -271,7 +853,7 @@ std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_ima
             Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
             universal_queue_family_index,
             universal_queue_family_index,
-            intermediate_image_ptr.get(),
+            intermediate_image_ptr,
             swapchain_image_subresource_range);
 
         Anvil::ImageBarrier transfer_src_to_general_image_barrier(
@@ -284,21 +866,30 @@ std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_ima
             in_swapchain_image_ptr,
             swapchain_image_subresource_range);
 
-        command_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::COLOR_ATTACHMENT_OUTPUT_BIT | Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* src_stage_mask                 */
-                                                    Anvil::PipelineStageFlagBits::TRANSFER_BIT,                                                             /* dst_stage_mask                 */
-                                                    Anvil::DependencyFlagBits::NONE,
-                                                    0,                                                                                                      /* in_memory_barrier_count        */
-                                                    nullptr,                                                                                                /* in_memory_barrier_ptrs         */
-                                                    0,                                                                                                      /* in_buffer_memory_barrier_count */
-                                                    nullptr,                                                                                                /* in_buffer_memory_barrier_ptrs  */
-                                                    1,                                                                                                      /* in_image_memory_barrier_count  */
-                                                   &general_to_transfer_src_image_barrier);
+        Anvil::BufferBarrier transfer_dst_to_host_read_buffer_barrier(
+            Anvil::AccessFlagBits::TRANSFER_WRITE_BIT, /* source_access_mask      */
+            Anvil::AccessFlagBits::HOST_READ_BIT,      /* destination_access_mask */
+            universal_queue_family_index,
+            universal_queue_family_index,
+            in_slot_ptr->readback_buffer_ptr.get(),
+            0, /* in_offset */
+            in_slot_ptr->readback_buffer_ptr->get_create_info_ptr()->get_size() );
+
+        in_cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::COLOR_ATTACHMENT_OUTPUT_BIT | Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* src_stage_mask                 */
+                                                   Anvil::PipelineStageFlagBits::TRANSFER_BIT,                                                             /* dst_stage_mask                 */
+                                                   Anvil::DependencyFlagBits::NONE,
+                                                   0,                                                                                                      /* in_memory_barrier_count        */
+                                                   nullptr,                                                                                                /* in_memory_barrier_ptrs         */
+                                                   0,                                                                                                      /* in_buffer_memory_barrier_count */
+                                                   nullptr,                                                                                                /* in_buffer_memory_barrier_ptrs  */
+                                                   sizeof(pre_blit_image_barriers) / sizeof(pre_blit_image_barriers[0]),                                   /* in_image_memory_barrier_count  */
+                                                   pre_blit_image_barriers);
 
         intermediate_image_blit.dst_offsets[0].x                 = 0;
         intermediate_image_blit.dst_offsets[0].y                 = 0;
         intermediate_image_blit.dst_offsets[0].z                 = 0;
-        intermediate_image_blit.dst_offsets[1].x                 = static_cast<int32_t>(swapchain_image_width);
-        intermediate_image_blit.dst_offsets[1].y                 = static_cast<int32_t>(swapchain_image_height);
+        intermediate_image_blit.dst_offsets[1].x                 = static_cast<int32_t>(m_capture_image_width);
+        intermediate_image_blit.dst_offsets[1].y                 = static_cast<int32_t>(m_capture_image_height);
         intermediate_image_blit.dst_offsets[1].z                 = 1;
         intermediate_image_blit.dst_subresource.base_array_layer = 0;
         intermediate_image_blit.dst_subresource.layer_count      = 1;
@@ -308,30 +899,30 @@ std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_ima
         intermediate_image_blit.src_offsets[1]                   = intermediate_image_blit.dst_offsets[1];
         intermediate_image_blit.src_subresource                  = intermediate_image_blit.dst_subresource;
 
-        command_buffer_ptr->record_blit_image(in_swapchain_image_ptr,
-                                              Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
-                                              intermediate_image_ptr.get(),
-                                              Anvil::ImageLayout::TRANSFER_DST_OPTIMAL,
-                                              1, /* regionCount */
-                                             &intermediate_image_blit,
-                                              Anvil::Filter::NEAREST);
-
-        command_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* src_stage_mask                 */
-                                                    Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* dst_stage_mask                 */
-                                                    Anvil::DependencyFlagBits::NONE,
-                                                    0,                                          /* in_memory_barrier_count        */
-                                                    nullptr,                                    /* in_memory_barrier_ptrs         */
-                                                    0,                                          /* in_buffer_memory_barrier_count */
-                                                    nullptr,                                    /* in_buffer_memory_barrier_ptrs  */
-                                                    1,                                          /* in_image_memory_barrier_count  */
-                                                   &transfer_dst_to_transfer_src_image_barrier);
+        in_cmd_buffer_ptr->record_blit_image(in_swapchain_image_ptr,
+                                             Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
+                                             intermediate_image_ptr,
+                                             Anvil::ImageLayout::TRANSFER_DST_OPTIMAL,
+                                             1, /* regionCount */
+                                            &intermediate_image_blit,
+                                             Anvil::Filter::NEAREST);
+
+        in_cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* src_stage_mask                 */
+                                                   Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* dst_stage_mask                 */
+                                                   Anvil::DependencyFlagBits::NONE,
+                                                   0,                                          /* in_memory_barrier_count        */
+                                                   nullptr,                                    /* in_memory_barrier_ptrs         */
+                                                   0,                                          /* in_buffer_memory_barrier_count */
+                                                   nullptr,                                    /* in_buffer_memory_barrier_ptrs  */
+                                                   1,                                          /* in_image_memory_barrier_count  */
+                                                  &transfer_dst_to_transfer_src_image_barrier);
 
         buffer_image_copy_region.buffer_image_height                = 0; /* assume tight packing */
         buffer_image_copy_region.buffer_offset                      = 0;
         buffer_image_copy_region.buffer_row_length                  = 0; /* assume tight packing */
         buffer_image_copy_region.image_extent.depth                 = 1;
-        buffer_image_copy_region.image_extent.height                = swapchain_image_height;
-        buffer_image_copy_region.image_extent.width                 = swapchain_image_width;
+        buffer_image_copy_region.image_extent.height                = m_capture_image_height;
+        buffer_image_copy_region.image_extent.width                 = m_capture_image_width;
         buffer_image_copy_region.image_offset.x                     = 0;
         buffer_image_copy_region.image_offset.y                     = 0;
         buffer_image_copy_region.image_offset.z                     = 0;
@@ -340,40 +931,83 @@ std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_ima
         buffer_image_copy_region.image_subresource.layer_count      = 1;
         buffer_image_copy_region.image_subresource.mip_level        = 0;
 
-        command_buffer_ptr->record_copy_image_to_buffer(intermediate_image_ptr.get(),
-                                                        Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
-                                                        raw_image_buffer_ptr.get(),
-                                                        1, /* regionCount */
-                                                       &buffer_image_copy_region);
-
-        command_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT,    /* src_stage_mask */
-                                                    Anvil::PipelineStageFlagBits::TOP_OF_PIPE_BIT, /* dst_stage_mask */
-                                                    Anvil::DependencyFlagBits::NONE,
-                                                    0,                                             /* in_memory_barrier_count        */
-                                                    nullptr,                                       /* in_memory_barrier_ptrs         */
-                                                    0,                                             /* in_buffer_memory_barrier_count */
-                                                    nullptr,                                       /* in_buffer_memory_barrier_ptrs  */
-                                                    1,                                             /* in_image_memory_barrier_count  */
-                                                   &transfer_src_to_general_image_barrier);
+        in_cmd_buffer_ptr->record_copy_image_to_buffer(intermediate_image_ptr,
+                                                       Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
+                                                       in_slot_ptr->readback_buffer_ptr.get(),
+                                                       1, /* regionCount */
+                                                      &buffer_image_copy_region);
+
+        in_cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT,    /* src_stage_mask */
+                                                   Anvil::PipelineStageFlagBits::TOP_OF_PIPE_BIT, /* dst_stage_mask */
+                                                   Anvil::DependencyFlagBits::NONE,
+                                                   0,                                             /* in_memory_barrier_count        */
+                                                   nullptr,                                       /* in_memory_barrier_ptrs         */
+                                                   0,                                             /* in_buffer_memory_barrier_count */
+                                                   nullptr,                                       /* in_buffer_memory_barrier_ptrs  */
+                                                   1,                                             /* in_image_memory_barrier_count  */
+                                                  &transfer_src_to_general_image_barrier);
+
+        in_cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* src_stage_mask                 */
+                                                   Anvil::PipelineStageFlagBits::HOST_BIT,     /* dst_stage_mask                 */
+                                                   Anvil::DependencyFlagBits::NONE,
+                                                   0,                                          /* in_memory_barrier_count        */
+                                                   nullptr,                                    /* in_memory_barrier_ptrs         */
+                                                   1,                                          /* in_buffer_memory_barrier_count */
+                                                  &transfer_dst_to_host_read_buffer_barrier,
+                                                   0,                                          /* in_image_memory_barrier_count  */
+                                                   nullptr);                                   /* in_image_memory_barrier_ptrs   */
     }
-    command_buffer_ptr->stop_recording();
+    in_cmd_buffer_ptr->stop_recording();
+}
+
+/** Waits until the copy submitted for the specified slot finishes, reads the frame back and queues it for
+ *  encoding. If the encoders fall behind, blocks until the job queue shrinks, so that memory usage stays bounded.
+ */
+void Anvil::DummyWindowWithPNGSnapshots::retire_capture_slot(CaptureSlot* in_slot_ptr)
+{
+    EncodeJob         job;
+    const uint32_t    raw_image_size = 4 /* RGBA8 */ * m_capture_image_width * m_capture_image_height;
+    std::stringstream snapshot_file_name_sstream;
+
+    anvil_assert(in_slot_ptr->is_pending);
+
+    /* The copy has been submitted N_CAPTURE_SLOTS frames ago, so this normally does not block */
+    in_slot_ptr->fence_ptr->wait ();
+    in_slot_ptr->fence_ptr->reset();
+
+    /* Determine what name should be used for the snapshot file */
+    snapshot_file_name_sstream << m_title
+                               << "_"
+                               << in_slot_ptr->n_frame
+                               << ".png";
+
+    job.file_name = snapshot_file_name_sstream.str();
 
-    /* Execute the command buffer */
+    /* Read the data back. The buffer is persistently mapped, so this boils down to a cache invalidation
+     * (for non-coherent memory) and a memcpy(). */
+    job.raw_data_ptr.reset(new uint8_t[raw_image_size]);
+
+    in_slot_ptr->readback_buffer_ptr->read(0, /* in_start_offset */
+                                           raw_image_size,
+                                           job.raw_data_ptr.get() );
+
+    in_slot_ptr->is_pending = false;
+
+    /* Hand the frame over to the encoders */
     {
-        Anvil::CommandBufferBase* cmd_buffer_raw_ptr = command_buffer_ptr.get();
+        std::unique_lock<std::mutex> lock             (m_encode_jobs_mutex);
+        const size_t                 max_n_queued_jobs = m_encode_worker_threads.size() * 2;
 
-        universal_queue_ptr->submit(Anvil::SubmitInfo::create_execute(&cmd_buffer_raw_ptr,
-                                                                      1,    /* in_n_cmd_buffers */
-                                                                      true) /* should_block     */
-        );
-    }
+        m_encode_jobs_cv.wait(lock,
+                              [this, max_n_queued_jobs]()
+                              {
+                                  return m_encode_jobs.size() < max_n_queued_jobs;
+                              });
 
-    /* Read back the result data */
-    raw_image_buffer_ptr->read(0, /* offset */
-                               raw_image_size,
-                               result_ptr.get() );
+        m_encode_jobs.push_back(std::move(job) );
+    }
 
-    return result_ptr;
+    m_encode_jobs_cv.notify_all();
 }
 
 /** Please see header for specification */
@@ -383,13 +1017,20 @@ void Anvil::DummyWindowWithPNGSnapshots::run()
 
     while (running && !m_window_should_close)
     {
-        m_present_callback_func();
+        on_frame_started();
+        {
+            m_present_callback_func();
+        }
+        on_frame_finished();
 
         store_swapchain_frame();
 
         running = !m_window_should_close;
     }
 
+    finish_pending_captures();
+    write_benchmark_summary();
+
     m_window_close_finished = true;
 }
 
@@ -406,43 +1047,32 @@ void Anvil::DummyWindowWithPNGSnapshots::store_swapchain_frame()
 {
     anvil_assert(m_swapchain_ptr != nullptr);
 
-    /* Retrieve image contents */
-    const uint32_t swapchain_image_index        = m_swapchain_ptr->get_last_acquired_image_index();
-    Anvil::Image*  swapchain_image_ptr          = m_swapchain_ptr->get_image                    (swapchain_image_index);
-    auto           swapchain_image_raw_data_ptr = get_swapchain_image_raw_r8g8b8a8_unorm_data   (swapchain_image_ptr);
-    uint32_t       swapchain_image_size[2];
+    if (!m_capture_pipeline_initialized)
+    {
+        if (!init_capture_pipeline() )
+        {
+            return;
+        }
+    }
 
-    swapchain_image_ptr->get_image_mipmap_size(0, /* n_mipmap */
-                                               swapchain_image_size + 0,
-                                               swapchain_image_size + 1,
-                                               nullptr); /* out_opt_depth_ptr */
+    const uint32_t            swapchain_image_index = m_swapchain_ptr->get_last_acquired_image_index();
+    const uint32_t            n_frame               = m_n_frames_presented++;
+    auto                      slot_ptr              = m_capture_slots.at(n_frame % m_capture_slots.size() ).get();
+    Anvil::CommandBufferBase* cmd_buffer_ptr        = nullptr;
 
-    /* Determine what name should be used for the snapshot file */
-    std::stringstream snapshot_file_name_sstream;
+    if (slot_ptr->is_pending)
+    {
+        retire_capture_slot(slot_ptr);
+    }
 
-    snapshot_file_name_sstream << m_title
-                               << "_"
-                               << m_n_frames_presented++
-                               << ".png";
+    cmd_buffer_ptr = slot_ptr->cmd_buffer_ptrs.at(swapchain_image_index).get();
+
+    m_swapchain_ptr->get_create_info_ptr()->get_device()->get_universal_queue(0)->submit(
+        Anvil::SubmitInfo::create_execute(cmd_buffer_ptr,
+                                          false, /* in_should_block */
+                                          slot_ptr->fence_ptr.get() )
+    );
 
-    /* Convert the retrieved data to a PNG blob */
-    void*  result_data_ptr  = nullptr;
-    size_t result_data_size = 0;
-
-    /*
-    result_data_ptr = tdefl_write_image_to_png_file_in_memory(swapchain_image_raw_data_ptr.get(),
-                                                              static_cast<int32_t>(swapchain_image_size[0]),
-                                                              static_cast<int32_t>(swapchain_image_size[1]),
-                                                              4,
-                                                             &result_data_size);
-    */
-    anvil_assert(result_data_ptr != nullptr);
-
-    /* Store it in a file */
-    Anvil::IO::write_binary_file(snapshot_file_name_sstream.str(),
-                                 result_data_ptr,
-                                 static_cast<uint32_t>(result_data_size) );
-
-    /* Clean up */
-    free(result_data_ptr);
-}
\ No newline at end of file
+    slot_ptr->is_pending = true;
+    slot_ptr->n_frame    = n_frame;
+}
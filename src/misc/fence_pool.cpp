@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/fence_create_info.h"
+#include "misc/fence_pool.h"
+#include "misc/object_tracker.h"
+#include "wrappers/fence.h"
+#include <algorithm>
+#include <functional>
+
+
+/** Constructor. */
+Anvil::FencePool::FencePool(const Anvil::BaseDevice* in_device_ptr,
+                            bool                     in_mt_safe)
+    :MTSafetySupportProvider(in_mt_safe),
+     m_device_ptr           (in_device_ptr)
+{
+    /* Register the object */
+    Anvil::ObjectTracker::get()->register_object(Anvil::ObjectType::ANVIL_FENCE_POOL,
+                                                  this);
+}
+
+/** Destructor */
+Anvil::FencePool::~FencePool()
+{
+    /* All fences handed out by the pool must have been returned by the time the device goes down */
+    anvil_assert(m_available_fence_ptrs.size() + m_returned_fence_ptrs.size() == m_fence_ptrs.size() );
+
+    /* Unregister the object */
+    Anvil::ObjectTracker::get()->unregister_object(Anvil::ObjectType::ANVIL_FENCE_POOL,
+                                                    this);
+}
+
+/* Please see header for specification */
+Anvil::FencePoolUniquePtr Anvil::FencePool::create(const Anvil::BaseDevice* in_device_ptr,
+                                                   bool                     in_mt_safe)
+{
+    FencePoolUniquePtr result_ptr(nullptr,
+                                  std::default_delete<FencePool>() );
+
+    result_ptr.reset(
+        new Anvil::FencePool(in_device_ptr,
+                             in_mt_safe)
+    );
+
+    anvil_assert(result_ptr != nullptr);
+    return result_ptr;
+}
+
+/* Please see header for specification */
+Anvil::FenceUniquePtr Anvil::FencePool::get_fence()
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr        = get_mutex();
+    Anvil::Fence*                          result_fence_ptr = nullptr;
+    Anvil::FenceUniquePtr                  result_ptr;
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    if (m_available_fence_ptrs.size() == 0 &&
+        m_returned_fence_ptrs.size () >  0)
+    {
+        /* Recycle all fences which have been returned to the pool since last time, using a single call.
+         *
+         * Only submitted fences are put aside when returned. Those which have not been signalled yet are still
+         * used by a pending submission, and resetting them would be illegal. Leave them aside until they are
+         * signalled. */
+        const auto signalled_fence_ptrs_end = std::partition(m_returned_fence_ptrs.begin(),
+                                                             m_returned_fence_ptrs.end  (),
+                                                             [](const Anvil::Fence* in_fence_ptr)
+                                                             {
+                                                                 return in_fence_ptr->is_set();
+                                                             });
+        const auto n_signalled_fences       = static_cast<uint32_t>(signalled_fence_ptrs_end - m_returned_fence_ptrs.begin() );
+
+        if (n_signalled_fences > 0 &&
+            Anvil::Fence::reset_fences(n_signalled_fences,
+                                      &m_returned_fence_ptrs.at(0) ))
+        {
+            m_available_fence_ptrs.insert(m_available_fence_ptrs.end(),
+                                          m_returned_fence_ptrs.begin(),
+                                          signalled_fence_ptrs_end);
+
+            m_returned_fence_ptrs.erase(m_returned_fence_ptrs.begin(),
+                                        signalled_fence_ptrs_end);
+        }
+    }
+
+    if (m_available_fence_ptrs.size() > 0)
+    {
+        result_fence_ptr = m_available_fence_ptrs.back();
+
+        m_available_fence_ptrs.pop_back();
+    }
+    else
+    {
+        auto create_info_ptr = Anvil::FenceCreateInfo::create(m_device_ptr,
+                                                              false); /* in_create_signalled */
+
+        create_info_ptr->set_mt_safety(Anvil::Utils::convert_boolean_to_mt_safety_enum(is_mt_safe() ));
+
+        auto new_fence_ptr = Anvil::Fence::create(std::move(create_info_ptr) );
+
+        if (new_fence_ptr != nullptr)
+        {
+            result_fence_ptr = new_fence_ptr.get();
+
+            m_fence_ptrs.push_back(
+                std::move(new_fence_ptr)
+            );
+        }
+    }
+
+    if (result_fence_ptr != nullptr)
+    {
+        result_ptr = Anvil::FenceUniquePtr(result_fence_ptr,
+                                           std::bind(&FencePool::on_fence_returned,
+                                                     this,
+                                                     result_fence_ptr)
+        );
+    }
+
+    anvil_assert(result_ptr != nullptr);
+    return result_ptr;
+}
+
+/* Please see header for specification */
+uint32_t Anvil::FencePool::get_n_available_fences() const
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    return static_cast<uint32_t>(m_available_fence_ptrs.size() + m_returned_fence_ptrs.size() );
+}
+
+/* Please see header for specification */
+uint32_t Anvil::FencePool::get_n_fences() const
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    return static_cast<uint32_t>(m_fence_ptrs.size() );
+}
+
+/** Puts a fence released by the app aside, so that it can be reset together with other returned fences
+ *  next time the pool runs out of unsignalled fences. The fence may still be in use by a pending submission.
+ *
+ *  Fences which have never been submitted are still unsignalled, so they are made available right away.
+ **/
+void Anvil::FencePool::on_fence_returned(Anvil::Fence* in_fence_ptr)
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    if (in_fence_ptr->has_been_submitted() )
+    {
+        m_returned_fence_ptrs.push_back(in_fence_ptr);
+    }
+    else
+    {
+        m_available_fence_ptrs.push_back(in_fence_ptr);
+    }
+}
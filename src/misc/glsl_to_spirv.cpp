@@ -21,6 +21,7 @@
 //
 
 #include "misc/glsl_to_spirv.h"
+#include "misc/instrumentation.h"
 #include "misc/io.h"
 #include "misc/object_tracker.h"
 #include "wrappers/device.h"
@@ -516,6 +517,8 @@ end:
 /* Please see header for specification */
 bool Anvil::GLSLShaderToSPIRVGenerator::bake_spirv_blob() const
 {
+    ANVIL_INSTRUMENTATION_SCOPE("GLSLShaderToSPIRVGenerator::bake_spirv_blob");
+
     bool           glsl_filename_is_temporary = false;
     std::string    glsl_filename_with_path;
     bool           result                     = false;
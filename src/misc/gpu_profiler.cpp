@@ -0,0 +1,556 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/gpu_profiler.h"
+#include "misc/io.h"
+#include "misc/object_tracker.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
+#include "wrappers/device.h"
+#include "wrappers/query_pool.h"
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    /* Writes @param in_string to @param in_stream as a JSON string literal. */
+    void write_json_string(std::ostream&      in_stream,
+                           const std::string& in_string)
+    {
+        static const char* hex_digits = "0123456789abcdef";
+
+        in_stream << "\"";
+
+        for (const auto current_char : in_string)
+        {
+            if (current_char == '"' ||
+                current_char == '\\')
+            {
+                in_stream << '\\'
+                          << current_char;
+            }
+            else
+            if (static_cast<unsigned char>(current_char) < 0x20)
+            {
+                /* Control characters need to be escaped */
+                in_stream << "\\u00"
+                          << hex_digits[(current_char >> 4) & 0xF]
+                          << hex_digits[ current_char       & 0xF];
+            }
+            else
+            {
+                in_stream << current_char;
+            }
+        }
+
+        in_stream << "\"";
+    }
+}
+
+
+/** Constructor. */
+Anvil::GPUProfiler::GPUProfiler(const Anvil::BaseDevice* in_device_ptr,
+                                uint32_t                 in_n_max_zones_per_frame,
+                                uint32_t                 in_n_max_trace_frames,
+                                bool                     in_mt_safe)
+    :MTSafetySupportProvider (in_mt_safe),
+     m_current_frame_ptr     (nullptr),
+     m_device_ptr            (in_device_ptr),
+     m_has_time_origin       (false),
+     m_n_dropped_frames      (0),
+     m_n_frames_started      (0),
+     m_n_max_trace_frames    (in_n_max_trace_frames),
+     m_n_max_zones_per_frame (in_n_max_zones_per_frame),
+     m_n_timestamp_bits      (0),
+     m_time_origin_ticks     (0),
+     m_timestamp_period_nsec (0.0)
+{
+    /* Register the object */
+    Anvil::ObjectTracker::get()->register_object(Anvil::ObjectType::ANVIL_GPU_PROFILER,
+                                                  this);
+}
+
+/** Destructor */
+Anvil::GPUProfiler::~GPUProfiler()
+{
+    /* Unregister the object */
+    Anvil::ObjectTracker::get()->unregister_object(Anvil::ObjectType::ANVIL_GPU_PROFILER,
+                                                    this);
+}
+
+/* Please see header for specification */
+bool Anvil::GPUProfiler::begin_frame(Anvil::CommandBufferBase* in_cmd_buffer_ptr)
+{
+    const uint32_t queue_family_index = in_cmd_buffer_ptr->get_parent_command_pool()->get_queue_family_index();
+    bool           result             = false;
+
+    lock();
+    {
+        if (m_current_frame_ptr != nullptr)
+        {
+            anvil_assert(m_current_frame_ptr == nullptr);
+
+            goto end;
+        }
+
+        m_current_frame_ptr = m_frames.at(m_n_frames_started % m_frames.size() ).get();
+        m_n_timestamp_bits  = m_device_ptr->get_queue_family_info(queue_family_index)->n_timestamp_bits;
+
+        /* The frame which used this query pool before has been started m_frames.size() frames ago. Its results
+         * should be available by now. If they are not, the frame is dropped, since we are not going to stall
+         * the CPU waiting for them. */
+        if (m_current_frame_ptr->is_pending)
+        {
+            retrieve_frame_results(m_current_frame_ptr);
+        }
+
+        m_current_frame_ptr->n_frame        = m_n_frames_started++;
+        m_current_frame_ptr->n_queries_used = 0;
+
+        m_current_frame_ptr->zones.clear();
+        m_zone_stack.clear              ();
+
+        result = in_cmd_buffer_ptr->record_reset_query_pool(m_current_frame_ptr->query_pool_ptr.get(),
+                                                            0, /* in_start_query */
+                                                            m_n_max_zones_per_frame * 2);
+    }
+end:
+    unlock();
+
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::GPUProfiler::begin_zone(Anvil::CommandBufferBase*    in_cmd_buffer_ptr,
+                                    const std::string&           in_name,
+                                    const float*                 in_opt_color_vec4_ptr,
+                                    Anvil::PipelineStageFlagBits in_pipeline_stage)
+{
+    static const float default_color[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    bool               result          = false;
+    Zone               zone;
+
+    anvil_assert(in_name.find('/') == std::string::npos);
+
+    lock();
+    {
+        if (m_current_frame_ptr == nullptr)
+        {
+            anvil_assert(m_current_frame_ptr != nullptr);
+
+            goto end;
+        }
+
+        zone.depth             = static_cast<uint32_t>(m_zone_stack.size() );
+        zone.is_timed          = (m_n_timestamp_bits                  > 0 &&
+                                  m_current_frame_ptr->n_queries_used < m_n_max_zones_per_frame * 2);
+        zone.name              = in_name;
+        zone.parent_zone_index = (m_zone_stack.size() > 0) ? m_zone_stack.back() : UINT32_MAX;
+        zone.start_query_index = (zone.is_timed)           ? m_current_frame_ptr->n_queries_used : UINT32_MAX;
+
+        in_cmd_buffer_ptr->begin_debug_utils_label(in_name.c_str(),
+                                                   (in_opt_color_vec4_ptr != nullptr) ? in_opt_color_vec4_ptr : default_color);
+
+        if (zone.is_timed)
+        {
+            if (!in_cmd_buffer_ptr->record_write_timestamp(in_pipeline_stage,
+                                                           m_current_frame_ptr->query_pool_ptr.get(),
+                                                           zone.start_query_index) )
+            {
+                anvil_assert_fail();
+
+                zone.is_timed = false;
+            }
+            else
+            {
+                /* Reserve both the begin and the end query */
+                m_current_frame_ptr->n_queries_used += 2;
+            }
+        }
+
+        m_zone_stack.push_back              (static_cast<uint32_t>(m_current_frame_ptr->zones.size() ));
+        m_current_frame_ptr->zones.push_back(zone);
+
+        result = true;
+    }
+end:
+    unlock();
+
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::GPUProfilerUniquePtr Anvil::GPUProfiler::create(const Anvil::BaseDevice* in_device_ptr,
+                                                       uint32_t                 in_n_frames_in_flight,
+                                                       uint32_t                 in_n_max_zones_per_frame,
+                                                       uint32_t                 in_n_max_trace_frames,
+                                                       MTSafety                 in_mt_safety)
+{
+    const bool           mt_safe = Anvil::Utils::convert_mt_safety_enum_to_boolean(in_mt_safety,
+                                                                                   in_device_ptr);
+    GPUProfilerUniquePtr result_ptr(nullptr,
+                                    std::default_delete<GPUProfiler>() );
+
+    anvil_assert(in_n_frames_in_flight    > 0);
+    anvil_assert(in_n_max_zones_per_frame > 0);
+
+    result_ptr.reset(
+        new Anvil::GPUProfiler(in_device_ptr,
+                               in_n_max_zones_per_frame,
+                               in_n_max_trace_frames,
+                               mt_safe)
+    );
+
+    if (result_ptr != nullptr)
+    {
+        if (!result_ptr->init(in_n_frames_in_flight) )
+        {
+            result_ptr.reset();
+        }
+    }
+
+    return result_ptr;
+}
+
+/* Please see header for specification */
+bool Anvil::GPUProfiler::end_frame()
+{
+    bool result = false;
+
+    lock();
+    {
+        if (m_current_frame_ptr == nullptr)
+        {
+            anvil_assert(m_current_frame_ptr != nullptr);
+
+            goto end;
+        }
+
+        if (m_zone_stack.size() != 0)
+        {
+            anvil_assert(m_zone_stack.size() == 0);
+
+            goto end;
+        }
+
+        m_current_frame_ptr->is_pending = true;
+        m_current_frame_ptr             = nullptr;
+
+        result = true;
+    }
+end:
+    unlock();
+
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::GPUProfiler::end_zone(Anvil::CommandBufferBase*    in_cmd_buffer_ptr,
+                                  Anvil::PipelineStageFlagBits in_pipeline_stage)
+{
+    bool  result   = false;
+    Zone* zone_ptr = nullptr;
+
+    lock();
+    {
+        if (m_current_frame_ptr == nullptr ||
+            m_zone_stack.size() == 0)
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        zone_ptr = &m_current_frame_ptr->zones.at(m_zone_stack.back() );
+
+        m_zone_stack.pop_back();
+
+        if (zone_ptr->is_timed)
+        {
+            result = in_cmd_buffer_ptr->record_write_timestamp(in_pipeline_stage,
+                                                               m_current_frame_ptr->query_pool_ptr.get(),
+                                                               zone_ptr->start_query_index + 1);
+
+            anvil_assert(result);
+        }
+        else
+        {
+            result = true;
+        }
+
+        in_cmd_buffer_ptr->end_debug_utils_label();
+    }
+end:
+    unlock();
+
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::GPUProfiler::export_chrome_trace(const std::string& in_filename) const
+{
+    return Anvil::IO::write_text_file(in_filename,
+                                      get_chrome_trace_json() );
+}
+
+/* Please see header for specification */
+std::string Anvil::GPUProfiler::get_chrome_trace_json() const
+{
+    bool              is_first_event = true;
+    std::stringstream result_sstream;
+
+    result_sstream.precision(3);
+    result_sstream << std::fixed
+                   << "{\"traceEvents\":[";
+
+    lock();
+    {
+        for (const auto& current_frame_results : m_trace_frames)
+        {
+            for (const auto& current_zone_result : current_frame_results)
+            {
+                if (!is_first_event)
+                {
+                    result_sstream << ",";
+                }
+
+                result_sstream << "\n{\"name\":";
+
+                write_json_string(result_sstream,
+                                  current_zone_result.name);
+
+                result_sstream << ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+                               << ",\"ts\":"                << current_zone_result.start_usec
+                               << ",\"dur\":"               << current_zone_result.duration_usec
+                               << ",\"args\":{\"frame\":"   << current_zone_result.n_frame
+                               << "}}";
+
+                is_first_event = false;
+            }
+        }
+    }
+    unlock();
+
+    result_sstream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return result_sstream.str();
+}
+
+/* Please see header for specification */
+void Anvil::GPUProfiler::get_last_frame_results(std::vector<ZoneResult>* out_results_ptr) const
+{
+    lock();
+    {
+        *out_results_ptr = m_last_frame_results;
+    }
+    unlock();
+}
+
+/* Please see header for specification */
+uint64_t Anvil::GPUProfiler::get_n_dropped_frames() const
+{
+    uint64_t result;
+
+    lock();
+    {
+        result = m_n_dropped_frames;
+    }
+    unlock();
+
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::GPUProfiler::get_statistics(std::vector<ZoneStatistics>* out_statistics_ptr) const
+{
+    lock();
+    {
+        out_statistics_ptr->clear  ();
+        out_statistics_ptr->reserve(m_statistics.size() );
+
+        for (const auto& current_statistics : m_statistics)
+        {
+            out_statistics_ptr->push_back(current_statistics.second);
+        }
+    }
+    unlock();
+}
+
+/** Creates per-frame query pools.
+ *
+ *  @param in_n_frames_in_flight Number of query pools to create.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::GPUProfiler::init(uint32_t in_n_frames_in_flight)
+{
+    bool result = false;
+
+    m_timestamp_period_nsec = static_cast<double>(m_device_ptr->get_physical_device_properties().core_vk1_0_properties_ptr->limits.timestamp_period);
+
+    for (uint32_t n_frame = 0;
+                  n_frame < in_n_frames_in_flight;
+                ++n_frame)
+    {
+        std::unique_ptr<Frame> frame_ptr(new Frame() );
+
+        frame_ptr->query_pool_ptr = Anvil::QueryPool::create_non_ps_query_pool(m_device_ptr,
+                                                                               VK_QUERY_TYPE_TIMESTAMP,
+                                                                               m_n_max_zones_per_frame * 2,
+                                                                               (is_mt_safe() ) ? Anvil::MTSafety::ENABLED
+                                                                                               : Anvil::MTSafety::DISABLED);
+
+        if (frame_ptr->query_pool_ptr == nullptr)
+        {
+            anvil_assert(frame_ptr->query_pool_ptr != nullptr);
+
+            goto end;
+        }
+
+        frame_ptr->zones.reserve(m_n_max_zones_per_frame);
+
+        m_frames.push_back(std::move(frame_ptr) );
+    }
+
+    m_query_results.resize(m_n_max_zones_per_frame * 2);
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::GPUProfiler::reset_statistics()
+{
+    lock();
+    {
+        m_statistics.clear  ();
+        m_trace_frames.clear();
+    }
+    unlock();
+}
+
+/** Retrieves timestamps written for the specified frame without waiting for them to become available,
+ *  converts them to zone results and updates statistics. If the timestamps are not available yet,
+ *  the frame is dropped.
+ *
+ *  Must be called with the profiler locked.
+ **/
+void Anvil::GPUProfiler::retrieve_frame_results(Frame* in_frame_ptr)
+{
+    bool                     all_results_retrieved = false;
+    std::vector<std::string> zone_paths;
+    std::vector<ZoneResult>  zone_results;
+    const uint64_t           timestamp_mask        = (m_n_timestamp_bits >= 64) ? UINT64_MAX
+                                                                                : ((1ull << m_n_timestamp_bits) - 1);
+
+    anvil_assert(in_frame_ptr->is_pending);
+
+    in_frame_ptr->is_pending = false;
+
+    if (in_frame_ptr->n_queries_used > 0)
+    {
+        /* NOTE: No WAIT_BIT - the call fails with VK_NOT_READY if any of the timestamps is unavailable. */
+        in_frame_ptr->query_pool_ptr->get_query_pool_results(0, /* in_first_query_index */
+                                                             in_frame_ptr->n_queries_used,
+                                                             Anvil::QueryResultFlagBits::NONE,
+                                                             m_query_results.data(),
+                                                            &all_results_retrieved);
+
+        if (!all_results_retrieved)
+        {
+            ++m_n_dropped_frames;
+
+            return;
+        }
+
+        if (!m_has_time_origin)
+        {
+            m_has_time_origin   = true;
+            m_time_origin_ticks = m_query_results.at(0);
+        }
+    }
+
+    zone_paths.reserve  (in_frame_ptr->zones.size() );
+    zone_results.reserve(in_frame_ptr->zones.size() );
+
+    for (const auto& current_zone : in_frame_ptr->zones)
+    {
+        ZoneResult zone_result;
+
+        zone_paths.push_back( (current_zone.parent_zone_index != UINT32_MAX) ? zone_paths.at(current_zone.parent_zone_index) + "/" + current_zone.name
+                                                                             : current_zone.name);
+
+        zone_result.depth             = current_zone.depth;
+        zone_result.duration_usec     = 0.0;
+        zone_result.n_frame           = in_frame_ptr->n_frame;
+        zone_result.name              = current_zone.name;
+        zone_result.parent_zone_index = current_zone.parent_zone_index;
+        zone_result.start_usec        = 0.0;
+
+        if (current_zone.is_timed)
+        {
+            const uint64_t start_ticks = m_query_results.at(current_zone.start_query_index);
+            const uint64_t end_ticks   = m_query_results.at(current_zone.start_query_index + 1);
+
+            zone_result.duration_usec = static_cast<double>( (end_ticks   - start_ticks)         & timestamp_mask) * m_timestamp_period_nsec / 1000.0;
+            zone_result.start_usec    = static_cast<double>( (start_ticks - m_time_origin_ticks) & timestamp_mask) * m_timestamp_period_nsec / 1000.0;
+
+            /* Update hierarchical statistics */
+            auto& statistics = m_statistics[zone_paths.back()];
+
+            if (statistics.n_samples == 0)
+            {
+                statistics.depth             = current_zone.depth;
+                statistics.max_duration_usec = zone_result.duration_usec;
+                statistics.min_duration_usec = zone_result.duration_usec;
+                statistics.path              = zone_paths.back();
+            }
+            else
+            {
+                statistics.max_duration_usec = std::max(statistics.max_duration_usec,
+                                                        zone_result.duration_usec);
+                statistics.min_duration_usec = std::min(statistics.min_duration_usec,
+                                                        zone_result.duration_usec);
+            }
+
+            statistics.total_duration_usec += zone_result.duration_usec;
+
+            ++statistics.n_samples;
+        }
+
+        zone_results.push_back(zone_result);
+    }
+
+    if (m_n_max_trace_frames > 0)
+    {
+        if (m_trace_frames.size() == m_n_max_trace_frames)
+        {
+            m_trace_frames.pop_front();
+        }
+
+        m_trace_frames.push_back(zone_results);
+    }
+
+    m_last_frame_results = std::move(zone_results);
+}
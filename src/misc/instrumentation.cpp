@@ -0,0 +1,359 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/instrumentation.h"
+#include "misc/io.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <sstream>
+
+namespace
+{
+    /* Number of events each thread can buffer between flushes. Must be a power of two. */
+    const uint32_t N_EVENTS_PER_THREAD = 4096;
+
+    /* Single-producer, single-consumer ring buffer of events recorded by a single thread.
+     *
+     * The owning thread is the only one to ever write events and bump n_events_written. flush() is the only
+     * consumer and bumps n_events_read. Both counters grow monotonically; the ring is full when they are
+     * N_EVENTS_PER_THREAD apart.
+     */
+    typedef struct ThreadEventBuffer
+    {
+        Anvil::InstrumentationEvent events[N_EVENTS_PER_THREAD];
+        std::atomic<uint64_t>       n_events_read;
+        std::atomic<uint64_t>       n_events_written;
+        uint32_t                    thread_id;
+
+        explicit ThreadEventBuffer(uint32_t in_thread_id)
+            :n_events_read   (0),
+             n_events_written(0),
+             thread_id       (in_thread_id)
+        {
+            /* Stub */
+        }
+    } ThreadEventBuffer;
+
+    typedef struct Registry
+    {
+        /* Guards buffers, n_next_thread_id and serializes flushes */
+        std::mutex mutex;
+
+        std::vector<std::shared_ptr<ThreadEventBuffer> > buffers;
+        std::atomic<uint64_t>                            n_dropped_events;
+        uint32_t                                         n_next_thread_id;
+        std::atomic<Anvil::IInstrumentationSink*>        sink_ptr;
+
+        Registry()
+            :n_dropped_events(0),
+             n_next_thread_id(0),
+             sink_ptr        (nullptr)
+        {
+            /* Stub */
+        }
+    } Registry;
+
+    Registry& get_registry()
+    {
+        static Registry registry;
+
+        return registry;
+    }
+
+    /* Returns the calling thread's event buffer, creating and registering it at first call time.
+     *
+     * Buffers are co-owned by the registry, so that events recorded by threads which have since exited
+     * can still be flushed.
+     */
+    ThreadEventBuffer* get_thread_event_buffer()
+    {
+        static thread_local std::shared_ptr<ThreadEventBuffer> buffer_ptr;
+
+        if (buffer_ptr == nullptr)
+        {
+            auto&                       registry = get_registry();
+            std::lock_guard<std::mutex> lock    (registry.mutex);
+
+            buffer_ptr.reset(
+                new ThreadEventBuffer(registry.n_next_thread_id++)
+            );
+
+            registry.buffers.push_back(buffer_ptr);
+        }
+
+        return buffer_ptr.get();
+    }
+
+    void record_event(const char*                     in_name,
+                      uint64_t                        in_start_time_nsec,
+                      Anvil::InstrumentationEventType in_type,
+                      uint64_t                        in_value)
+    {
+        ThreadEventBuffer* buffer_ptr       = get_thread_event_buffer();
+        const uint64_t     n_events_written = buffer_ptr->n_events_written.load(std::memory_order_relaxed);
+        const uint64_t     n_events_read    = buffer_ptr->n_events_read.load   (std::memory_order_acquire);
+
+        if (n_events_written - n_events_read >= N_EVENTS_PER_THREAD)
+        {
+            get_registry().n_dropped_events.fetch_add(1,
+                                                      std::memory_order_relaxed);
+
+            return;
+        }
+
+        auto& event = buffer_ptr->events[n_events_written & (N_EVENTS_PER_THREAD - 1)];
+
+        event.name            = in_name;
+        event.start_time_nsec = in_start_time_nsec;
+        event.type            = in_type;
+        event.value           = in_value;
+
+        /* Publish the event */
+        buffer_ptr->n_events_written.store(n_events_written + 1,
+                                           std::memory_order_release);
+    }
+
+    /* Writes @param in_string to @param in_stream as a JSON string literal. */
+    void write_json_string(std::ostream& in_stream,
+                           const char*   in_string)
+    {
+        static const char* hex_digits = "0123456789abcdef";
+
+        in_stream << "\"";
+
+        for (const char* current_char_ptr = in_string;
+                        *current_char_ptr != 0;
+                       ++current_char_ptr)
+        {
+            const char current_char = *current_char_ptr;
+
+            if (current_char == '"' ||
+                current_char == '\\')
+            {
+                in_stream << '\\'
+                          << current_char;
+            }
+            else
+            if (static_cast<unsigned char>(current_char) < 0x20)
+            {
+                /* Control characters need to be escaped */
+                in_stream << "\\u00"
+                          << hex_digits[(current_char >> 4) & 0xF]
+                          << hex_digits[ current_char       & 0xF];
+            }
+            else
+            {
+                in_stream << current_char;
+            }
+        }
+
+        in_stream << "\"";
+    }
+}
+
+
+/** Please see header for specification */
+void Anvil::Instrumentation::flush()
+{
+    auto&                       registry = get_registry();
+    std::lock_guard<std::mutex> lock    (registry.mutex);
+    auto                        sink_ptr = registry.sink_ptr.load();
+
+    for (auto& current_buffer_ptr : registry.buffers)
+    {
+        const uint64_t n_events_read    = current_buffer_ptr->n_events_read.load   (std::memory_order_relaxed);
+        const uint64_t n_events_written = current_buffer_ptr->n_events_written.load(std::memory_order_acquire);
+
+        if (n_events_read == n_events_written)
+        {
+            continue;
+        }
+
+        if (sink_ptr != nullptr)
+        {
+            /* The pending range may wrap around the end of the ring. If so, report it in two chunks. */
+            const uint32_t first_event_index = static_cast<uint32_t>(n_events_read & (N_EVENTS_PER_THREAD - 1) );
+            const uint32_t n_pending_events  = static_cast<uint32_t>(n_events_written - n_events_read);
+            const uint32_t n_events_chunk0   = std::min(n_pending_events,
+                                                        N_EVENTS_PER_THREAD - first_event_index);
+
+            sink_ptr->on_events_flushed(current_buffer_ptr->thread_id,
+                                        current_buffer_ptr->events + first_event_index,
+                                        n_events_chunk0);
+
+            if (n_events_chunk0 < n_pending_events)
+            {
+                sink_ptr->on_events_flushed(current_buffer_ptr->thread_id,
+                                            current_buffer_ptr->events,
+                                            n_pending_events - n_events_chunk0);
+            }
+        }
+
+        /* Hand the slots back to the producer */
+        current_buffer_ptr->n_events_read.store(n_events_written,
+                                                std::memory_order_release);
+    }
+}
+
+/** Please see header for specification */
+uint64_t Anvil::Instrumentation::get_n_dropped_events()
+{
+    return get_registry().n_dropped_events.load();
+}
+
+/** Please see header for specification */
+void Anvil::Instrumentation::record_counter(const char* in_name,
+                                            uint64_t    in_delta)
+{
+    record_event(in_name,
+                 Anvil::Time::get_absolute_time_in_nsec(),
+                 Anvil::InstrumentationEventType::COUNTER,
+                 in_delta);
+}
+
+/** Please see header for specification */
+void Anvil::Instrumentation::record_zone(const char* in_name,
+                                         uint64_t    in_start_time_nsec,
+                                         uint64_t    in_end_time_nsec)
+{
+    record_event(in_name,
+                 in_start_time_nsec,
+                 Anvil::InstrumentationEventType::ZONE,
+                 in_end_time_nsec - in_start_time_nsec);
+}
+
+/** Please see header for specification */
+void Anvil::Instrumentation::set_sink(IInstrumentationSink* in_opt_sink_ptr)
+{
+    auto&                       registry = get_registry();
+    std::lock_guard<std::mutex> lock    (registry.mutex);
+
+    registry.sink_ptr.store(in_opt_sink_ptr);
+}
+
+
+/** Please see header for specification */
+Anvil::ChromeTraceInstrumentationSink::ChromeTraceInstrumentationSink()
+{
+    /* Stub */
+}
+
+/** Please see header for specification */
+Anvil::ChromeTraceInstrumentationSink::~ChromeTraceInstrumentationSink()
+{
+    /* Stub */
+}
+
+/** Please see header for specification */
+bool Anvil::ChromeTraceInstrumentationSink::export_chrome_trace(const std::string& in_filename) const
+{
+    return Anvil::IO::write_text_file(in_filename,
+                                      get_chrome_trace_json() );
+}
+
+/** Please see header for specification */
+std::string Anvil::ChromeTraceInstrumentationSink::get_chrome_trace_json() const
+{
+    std::map<std::string, uint64_t> counter_values;
+    bool                            is_first_event = true;
+    std::stringstream               result_sstream;
+
+    result_sstream.precision(3);
+    result_sstream << std::fixed
+                   << "{\"traceEvents\":[";
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (const auto& current_thread_event : m_events)
+        {
+            const auto& current_event = current_thread_event.event;
+
+            if (!is_first_event)
+            {
+                result_sstream << ",";
+            }
+
+            result_sstream << "\n{\"name\":";
+
+            write_json_string(result_sstream,
+                              current_event.name);
+
+            result_sstream << ",\"cat\":\"cpu\",\"pid\":0"
+                           << ",\"tid\":" << current_thread_event.thread_id
+                           << ",\"ts\":"  << static_cast<double>(current_event.start_time_nsec) / 1000.0;
+
+            if (current_event.type == Anvil::InstrumentationEventType::ZONE)
+            {
+                result_sstream << ",\"ph\":\"X\",\"dur\":" << static_cast<double>(current_event.value) / 1000.0
+                               << "}";
+            }
+            else
+            {
+                /* Chrome expects counter events to carry absolute values */
+                uint64_t& counter_value = counter_values[current_event.name];
+
+                counter_value += current_event.value;
+
+                result_sstream << ",\"ph\":\"C\",\"args\":{\"value\":" << counter_value
+                               << "}}";
+            }
+
+            is_first_event = false;
+        }
+    }
+
+    result_sstream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return result_sstream.str();
+}
+
+/** Please see header for specification */
+void Anvil::ChromeTraceInstrumentationSink::on_events_flushed(uint32_t                    in_thread_id,
+                                                              const InstrumentationEvent* in_events_ptr,
+                                                              uint32_t                    in_n_events)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (uint32_t n_event = 0;
+                  n_event < in_n_events;
+                ++n_event)
+    {
+        ThreadEvent thread_event;
+
+        thread_event.event     = in_events_ptr[n_event];
+        thread_event.thread_id = in_thread_id;
+
+        m_events.push_back(thread_event);
+    }
+}
+
+/** Please see header for specification */
+void Anvil::ChromeTraceInstrumentationSink::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_events.clear();
+}
@@ -35,9 +35,11 @@
 #include <cmath>
 
 /** Please see header for specification */
-Anvil::MemoryAllocatorBackends::OneShot::OneShot(const Anvil::BaseDevice* in_device_ptr)
-    :m_device_ptr(in_device_ptr),
-     m_is_baked  (false)
+Anvil::MemoryAllocatorBackends::OneShot::OneShot(const Anvil::BaseDevice* in_device_ptr,
+                                                  bool                     in_alias_items_with_disjoint_lifetimes)
+    :m_alias_items_with_disjoint_lifetimes(in_alias_items_with_disjoint_lifetimes),
+     m_device_ptr                         (in_device_ptr),
+     m_is_baked                           (false)
 {
     /* Stub */
 }
@@ -139,10 +141,42 @@ bool Anvil::MemoryAllocatorBackends::OneShot::bake(Anvil::MemoryAllocator::Items
     {
         /* Assign the item to supported memory types */
         const auto& required_memory_features = ((*item_iterator)->alloc_memory_required_features);
-        const auto& supported_memory_types   = (*item_iterator)->alloc_memory_supported_memory_types;
+        auto        supported_memory_types   = (*item_iterator)->alloc_memory_supported_memory_types;
+
+        /* Transient attachments are never stored to memory, so there is a chance the implementation will be able to avoid
+         * committing physical memory for them, if lazily allocated memory is used. */
+        if (m_alias_items_with_disjoint_lifetimes                                                                                       &&
+            (*item_iterator)->image_ptr                                                                      != nullptr                 &&
+            ((*item_iterator)->image_ptr->get_create_info_ptr()->get_usage_flags() & Anvil::ImageUsageFlagBits::TRANSIENT_ATTACHMENT_BIT) != 0)
+        {
+            uint32_t lazily_allocated_memory_types = 0;
+
+            for (uint32_t n_memory_type = 0;
+                          n_memory_type < n_memory_types;
+                        ++n_memory_type)
+            {
+                if ((memory_props.types.at(n_memory_type).flags & Anvil::MemoryPropertyFlagBits::LAZILY_ALLOCATED_BIT) != 0)
+                {
+                    lazily_allocated_memory_types |= (1u << n_memory_type);
+                }
+            }
+
+            if (!Anvil::MemoryAllocator::get_mem_types_supporting_mem_features(m_device_ptr,
+                                                                               supported_memory_types & lazily_allocated_memory_types,
+                                                                               required_memory_features,
+                                                                              &lazily_allocated_memory_types) )
+            {
+                lazily_allocated_memory_types = 0;
+            }
+
+            if (lazily_allocated_memory_types != 0)
+            {
+                supported_memory_types = lazily_allocated_memory_types;
+            }
+        }
 
         for (uint32_t n_memory_type = 0;
-                      (1u << n_memory_type) <= (*item_iterator)->alloc_memory_supported_memory_types;
+                      (1u << n_memory_type) <= supported_memory_types;
                      ++n_memory_type)
         {
             if (!(supported_memory_types & (1 << n_memory_type)) )
@@ -315,46 +349,10 @@ bool Anvil::MemoryAllocatorBackends::OneShot::bake(Anvil::MemoryAllocator::Items
 
                     /* Go through the items, calculate offsets and the total amount of memory we're going
                      * to need to alloc off the heap */
-                    {
-                        bool                          is_prev_item_linear = false;
-                        Anvil::MemoryAllocator::Item* prev_item_ptr       = nullptr;
-
-                        for (auto& current_item_ptr : current_items)
-                        {
-                            const bool is_current_item_buffer  = (current_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_BUFFER                   ||
-                                                                  current_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_SPARSE_BUFFER_REGION);
-                            const bool is_current_item_image   = (current_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_IMAGE_WHOLE              ||
-                                                                  current_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_SPARSE_IMAGE_MIPTAIL     ||
-                                                                  current_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_SPARSE_IMAGE_SUBRESOURCE);
-                            const bool is_current_item_linear = (is_current_item_buffer)                                                                                                  ||
-                                                                (is_current_item_image && current_item_ptr->image_ptr->get_create_info_ptr()->get_tiling() == Anvil::ImageTiling::LINEAR);
-
-                            anvil_assert(current_item_ptr->alloc_exportable_external_handle_types == 0);
-
-                            #if defined(_WIN32)
-                                anvil_assert(current_item_ptr->alloc_external_nt_handle_info_ptr == nullptr);
-                            #endif
-
-                            n_bytes_required = Anvil::Utils::round_up(n_bytes_required,
-                                                                      current_item_ptr->alloc_memory_required_alignment);
-
-                            if (prev_item_ptr != nullptr)
-                            {
-                                /* Make sure to adhere to the buffer-image granularity requirement */
-                                if (is_prev_item_linear != is_current_item_linear)
-                                {
-                                    n_bytes_required = Anvil::Utils::round_up(n_bytes_required,
-                                                                              m_device_ptr->get_physical_device_properties().core_vk1_0_properties_ptr->limits.buffer_image_granularity);
-                                }
-                            }
-
-                            alloc_offset_map[current_item_ptr]  = n_bytes_required;
-                            n_bytes_required                   += current_item_ptr->alloc_size;
-
-                            is_prev_item_linear = is_current_item_linear;
-                            prev_item_ptr       = current_item_ptr;
-                        }
-                    }
+                    n_bytes_required = (m_alias_items_with_disjoint_lifetimes) ? calculate_aliased_item_offsets(current_items,
+                                                                                                               &alloc_offset_map)
+                                                                               : calculate_item_offsets        (current_items,
+                                                                                                               &alloc_offset_map);
 
                     /* Bake the block and stash it */
                     {
@@ -419,6 +417,214 @@ end:
     return result;
 }
 
+/** Assigns offsets to the specified items, letting items whose lifetimes do not overlap share memory ranges.
+ *
+ *  Items are placed in descending size order. Each item is put at the lowest offset which does not collide with
+ *  any previously placed item used at the same time.
+ *
+ *  @param in_items        Items to calculate offsets for. All items must use the same memory type.
+ *  @param out_offsets_ptr Deref will be updated with offsets assigned to the items. Must not be nullptr.
+ *
+ *  @return Number of bytes required to hold all items.
+ **/
+VkDeviceSize Anvil::MemoryAllocatorBackends::OneShot::calculate_aliased_item_offsets(const std::vector<Anvil::MemoryAllocator::Item*>&      in_items,
+                                                                                     std::map<Anvil::MemoryAllocator::Item*, VkDeviceSize>* out_offsets_ptr) const
+{
+    typedef struct PlacedItem
+    {
+        VkDeviceSize end_offset;
+        uint32_t     first_use;
+        uint32_t     last_use;
+        VkDeviceSize start_offset;
+
+        PlacedItem(VkDeviceSize in_start_offset,
+                   VkDeviceSize in_end_offset,
+                   uint32_t     in_first_use,
+                   uint32_t     in_last_use)
+            :end_offset  (in_end_offset),
+             first_use   (in_first_use),
+             last_use    (in_last_use),
+             start_offset(in_start_offset)
+        {
+            /* Stub */
+        }
+
+        bool operator<(const PlacedItem& in_placed_item) const
+        {
+            return start_offset < in_placed_item.start_offset;
+        }
+    } PlacedItem;
+
+    const VkDeviceSize                         buffer_image_granularity = m_device_ptr->get_physical_device_properties().core_vk1_0_properties_ptr->limits.buffer_image_granularity;
+    std::vector<PlacedItem>                    colliding_items;
+    std::vector<Anvil::MemoryAllocator::Item*> sorted_items             (in_items);
+    std::vector<PlacedItem>                    placed_items;
+    VkDeviceSize                               result                   = 0;
+
+    std::stable_sort(sorted_items.begin(),
+                     sorted_items.end  (),
+                     [](const Anvil::MemoryAllocator::Item* in_item1_ptr,
+                        const Anvil::MemoryAllocator::Item* in_item2_ptr)
+                     {
+                         return in_item1_ptr->alloc_size > in_item2_ptr->alloc_size;
+                     });
+
+    placed_items.reserve(sorted_items.size() );
+
+    for (auto& current_item_ptr : sorted_items)
+    {
+        /* Non-linear resources are padded to buffer-image granularity at both ends. This guarantees they never share
+         * a granularity-sized page with linear resources, whichever order the two end up in. */
+        const bool         is_current_item_linear = is_linear_item(current_item_ptr);
+        const VkDeviceSize alignment              = (is_current_item_linear) ? current_item_ptr->alloc_memory_required_alignment
+                                                                             : std::max(current_item_ptr->alloc_memory_required_alignment,
+                                                                                        buffer_image_granularity);
+        const VkDeviceSize size                   = (is_current_item_linear) ? current_item_ptr->alloc_size
+                                                                             : Anvil::Utils::round_up(current_item_ptr->alloc_size,
+                                                                                                      buffer_image_granularity);
+        VkDeviceSize       start_offset           = 0;
+
+        anvil_assert(current_item_ptr->alloc_exportable_external_handle_types == 0);
+
+        #if defined(_WIN32)
+            anvil_assert(current_item_ptr->alloc_external_nt_handle_info_ptr == nullptr);
+        #endif
+
+        /* Find items which are alive at the same time as the current item. Their memory must not be reused. */
+        colliding_items.clear();
+
+        for (const auto& current_placed_item : placed_items)
+        {
+            if (current_placed_item.first_use <= current_item_ptr->last_use &&
+                current_item_ptr->first_use   <= current_placed_item.last_use)
+            {
+                colliding_items.push_back(current_placed_item);
+            }
+        }
+
+        std::sort(colliding_items.begin(),
+                  colliding_items.end  () );
+
+        /* Look for the first gap large enough to hold the item */
+        for (const auto& current_colliding_item : colliding_items)
+        {
+            start_offset = Anvil::Utils::round_up(start_offset,
+                                                  alignment);
+
+            if (start_offset + size <= current_colliding_item.start_offset)
+            {
+                break;
+            }
+
+            start_offset = std::max(start_offset,
+                                    current_colliding_item.end_offset);
+        }
+
+        start_offset = Anvil::Utils::round_up(start_offset,
+                                              alignment);
+
+        (*out_offsets_ptr)[current_item_ptr] = start_offset;
+
+        placed_items.push_back(
+            PlacedItem(start_offset,
+                       start_offset + size,
+                       current_item_ptr->first_use,
+                       current_item_ptr->last_use)
+        );
+
+        result = std::max(result,
+                          start_offset + size);
+    }
+
+    return result;
+}
+
+/** Assigns consecutive, non-overlapping offsets to the specified items.
+ *
+ *  @param in_items        Items to calculate offsets for. All items must use the same memory type.
+ *  @param out_offsets_ptr Deref will be updated with offsets assigned to the items. Must not be nullptr.
+ *
+ *  @return Number of bytes required to hold all items.
+ **/
+VkDeviceSize Anvil::MemoryAllocatorBackends::OneShot::calculate_item_offsets(const std::vector<Anvil::MemoryAllocator::Item*>&      in_items,
+                                                                             std::map<Anvil::MemoryAllocator::Item*, VkDeviceSize>* out_offsets_ptr) const
+{
+    bool                          is_prev_item_linear = false;
+    VkDeviceSize                  n_bytes_required    = 0;
+    Anvil::MemoryAllocator::Item* prev_item_ptr       = nullptr;
+
+    for (auto& current_item_ptr : in_items)
+    {
+        const bool is_current_item_linear = is_linear_item(current_item_ptr);
+
+        anvil_assert(current_item_ptr->alloc_exportable_external_handle_types == 0);
+
+        #if defined(_WIN32)
+            anvil_assert(current_item_ptr->alloc_external_nt_handle_info_ptr == nullptr);
+        #endif
+
+        n_bytes_required = Anvil::Utils::round_up(n_bytes_required,
+                                                  current_item_ptr->alloc_memory_required_alignment);
+
+        if (prev_item_ptr != nullptr)
+        {
+            /* Make sure to adhere to the buffer-image granularity requirement */
+            if (is_prev_item_linear != is_current_item_linear)
+            {
+                n_bytes_required = Anvil::Utils::round_up(n_bytes_required,
+                                                          m_device_ptr->get_physical_device_properties().core_vk1_0_properties_ptr->limits.buffer_image_granularity);
+            }
+        }
+
+        (*out_offsets_ptr)[current_item_ptr]  = n_bytes_required;
+        n_bytes_required                     += current_item_ptr->alloc_size;
+
+        is_prev_item_linear = is_current_item_linear;
+        prev_item_ptr       = current_item_ptr;
+    }
+
+    return n_bytes_required;
+}
+
+/** Sums up usage statistics of memory blocks allocated at bake time, grouping them by memory type. */
+void Anvil::MemoryAllocatorBackends::OneShot::get_memory_type_statistics(std::vector<Anvil::MemoryAllocator::MemoryTypeStatistics>* out_statistics_ptr) const
+{
+    for (const auto& current_memory_block_ptr : m_memory_blocks)
+    {
+        const auto block_statistics = current_memory_block_ptr->get_statistics();
+        const auto n_memory_type    = current_memory_block_ptr->get_create_info_ptr()->get_memory_type_index();
+
+        if (block_statistics.reserved_size == 0)
+        {
+            /* Memory block of a dedicated allocation, whose owner has already been released */
+            continue;
+        }
+
+        auto& memory_type_statistics = out_statistics_ptr->at(n_memory_type);
+
+        memory_type_statistics.largest_free_range_size  = std::max(memory_type_statistics.largest_free_range_size,
+                                                                   block_statistics.largest_free_range_size);
+        memory_type_statistics.n_allocations           += block_statistics.n_derived_blocks;
+        memory_type_statistics.n_blocks                ++;
+        memory_type_statistics.n_free_ranges           += block_statistics.n_free_ranges;
+        memory_type_statistics.reserved_size           += block_statistics.reserved_size;
+        memory_type_statistics.used_size               += block_statistics.used_size;
+    }
+}
+
+/** Tells whether the specified item is a buffer or a linearly tiled image, as far as buffer-image granularity is concerned. */
+bool Anvil::MemoryAllocatorBackends::OneShot::is_linear_item(const Anvil::MemoryAllocator::Item* in_item_ptr)
+{
+    const bool is_buffer = (in_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_BUFFER                   ||
+                            in_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_SPARSE_BUFFER_REGION);
+    const bool is_image  = (in_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_IMAGE_WHOLE              ||
+                            in_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_SPARSE_IMAGE_MIPTAIL     ||
+                            in_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_SPARSE_IMAGE_SUBRESOURCE);
+
+    return (is_buffer)                                                                                               ||
+           (is_image && in_item_ptr->image_ptr->get_create_info_ptr()->get_tiling() == Anvil::ImageTiling::LINEAR);
+}
+
 VkResult Anvil::MemoryAllocatorBackends::OneShot::map(void*        in_memory_object,
                                                       VkDeviceSize in_start_offset,
                                                       VkDeviceSize in_memory_block_start_offset,
@@ -427,12 +633,12 @@ VkResult Anvil::MemoryAllocatorBackends::OneShot::map(void*        in_memory_obj
 {
     ANVIL_REDUNDANT_VARIABLE(in_memory_block_start_offset);
 
-    return Anvil::Vulkan::vkMapMemory(m_device_ptr->get_device_vk(),
-                                      reinterpret_cast<VkDeviceMemory>(in_memory_object),
-                                      in_start_offset,
-                                      in_size,
-                                      0, /* flags */
-                                      out_result_ptr);
+    return m_device_ptr->get_dispatch_table().vkMapMemory(m_device_ptr->get_device_vk(),
+                                                          reinterpret_cast<VkDeviceMemory>(in_memory_object),
+                                                          in_start_offset,
+                                                          in_size,
+                                                          0, /* flags */
+                                                          out_result_ptr);
 }
 
 /** Tells whether or not the backend is ready to handle allocation request.
@@ -463,6 +669,6 @@ bool Anvil::MemoryAllocatorBackends::OneShot::supports_protected_memory() const
 
 void Anvil::MemoryAllocatorBackends::OneShot::unmap(void* in_memory_object)
 {
-    Anvil::Vulkan::vkUnmapMemory(m_device_ptr->get_device_vk(),
-                                 reinterpret_cast<VkDeviceMemory>(in_memory_object) );
+    m_device_ptr->get_dispatch_table().vkUnmapMemory(m_device_ptr->get_device_vk(),
+                                                     reinterpret_cast<VkDeviceMemory>(in_memory_object) );
 }
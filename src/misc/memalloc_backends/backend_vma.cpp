@@ -112,20 +112,20 @@ bool Anvil::MemoryAllocatorBackends::VMA::VMAAllocator::init()
         goto end;
     }
 
-    m_vma_func_ptrs->vkAllocateMemory                    = Vulkan::vkAllocateMemory;
-    m_vma_func_ptrs->vkBindBufferMemory                  = Vulkan::vkBindBufferMemory;
-    m_vma_func_ptrs->vkBindImageMemory                   = Vulkan::vkBindImageMemory;
-    m_vma_func_ptrs->vkCreateBuffer                      = Vulkan::vkCreateBuffer;
-    m_vma_func_ptrs->vkCreateImage                       = Vulkan::vkCreateImage;
-    m_vma_func_ptrs->vkDestroyBuffer                     = Vulkan::vkDestroyBuffer;
-    m_vma_func_ptrs->vkDestroyImage                      = Vulkan::vkDestroyImage;
-    m_vma_func_ptrs->vkFreeMemory                        = Vulkan::vkFreeMemory;
-    m_vma_func_ptrs->vkGetBufferMemoryRequirements       = Vulkan::vkGetBufferMemoryRequirements;
-    m_vma_func_ptrs->vkGetImageMemoryRequirements        = Vulkan::vkGetImageMemoryRequirements;
+    m_vma_func_ptrs->vkAllocateMemory                    = m_device_ptr->get_dispatch_table().vkAllocateMemory;
+    m_vma_func_ptrs->vkBindBufferMemory                  = m_device_ptr->get_dispatch_table().vkBindBufferMemory;
+    m_vma_func_ptrs->vkBindImageMemory                   = m_device_ptr->get_dispatch_table().vkBindImageMemory;
+    m_vma_func_ptrs->vkCreateBuffer                      = m_device_ptr->get_dispatch_table().vkCreateBuffer;
+    m_vma_func_ptrs->vkCreateImage                       = m_device_ptr->get_dispatch_table().vkCreateImage;
+    m_vma_func_ptrs->vkDestroyBuffer                     = m_device_ptr->get_dispatch_table().vkDestroyBuffer;
+    m_vma_func_ptrs->vkDestroyImage                      = m_device_ptr->get_dispatch_table().vkDestroyImage;
+    m_vma_func_ptrs->vkFreeMemory                        = m_device_ptr->get_dispatch_table().vkFreeMemory;
+    m_vma_func_ptrs->vkGetBufferMemoryRequirements       = m_device_ptr->get_dispatch_table().vkGetBufferMemoryRequirements;
+    m_vma_func_ptrs->vkGetImageMemoryRequirements        = m_device_ptr->get_dispatch_table().vkGetImageMemoryRequirements;
     m_vma_func_ptrs->vkGetPhysicalDeviceMemoryProperties = Vulkan::vkGetPhysicalDeviceMemoryProperties;
     m_vma_func_ptrs->vkGetPhysicalDeviceProperties       = Vulkan::vkGetPhysicalDeviceProperties;
-    m_vma_func_ptrs->vkMapMemory                         = Vulkan::vkMapMemory;
-    m_vma_func_ptrs->vkUnmapMemory                       = Vulkan::vkUnmapMemory;
+    m_vma_func_ptrs->vkMapMemory                         = m_device_ptr->get_dispatch_table().vkMapMemory;
+    m_vma_func_ptrs->vkUnmapMemory                       = m_device_ptr->get_dispatch_table().vkUnmapMemory;
 
     if (m_device_ptr->get_extension_info()->khr_get_memory_requirements2() )
     {
@@ -348,6 +348,31 @@ std::unique_ptr<Anvil::MemoryAllocatorBackends::VMA> Anvil::MemoryAllocatorBacke
     return result_ptr;
 }
 
+/** Retrieves per-memory type statistics from the VMA library. */
+void Anvil::MemoryAllocatorBackends::VMA::get_memory_type_statistics(std::vector<Anvil::MemoryAllocator::MemoryTypeStatistics>* out_statistics_ptr) const
+{
+    VmaStats vma_stats;
+
+    vmaCalculateStats(m_vma_allocator_ptr->get_handle(),
+                     &vma_stats);
+
+    for (uint32_t n_memory_type = 0;
+                  n_memory_type < static_cast<uint32_t>(out_statistics_ptr->size() );
+                ++n_memory_type)
+    {
+        auto&       memory_type_statistics = out_statistics_ptr->at(n_memory_type);
+        const auto& vma_stat_info          = vma_stats.memoryType[n_memory_type];
+
+        memory_type_statistics.largest_free_range_size = (vma_stat_info.unusedRangeCount > 0) ? vma_stat_info.unusedRangeSizeMax
+                                                                                               : 0;
+        memory_type_statistics.n_allocations           = vma_stat_info.allocationCount;
+        memory_type_statistics.n_blocks                = vma_stat_info.blockCount;
+        memory_type_statistics.n_free_ranges           = vma_stat_info.unusedRangeCount;
+        memory_type_statistics.reserved_size           = vma_stat_info.usedBytes + vma_stat_info.unusedBytes;
+        memory_type_statistics.used_size               = vma_stat_info.usedBytes;
+    }
+}
+
 /** Creates and stores a new VMAAllocator instance.
  *
  *  @return true if successful, false otherwise.
@@ -25,17 +25,58 @@
 #include "misc/formats.h"
 #include "misc/image_create_info.h"
 #include "misc/instance_create_info.h"
+#include "misc/instrumentation.h"
 #include "misc/memory_allocator.h"
 #include "misc/memalloc_backends/backend_oneshot.h"
 #include "misc/memalloc_backends/backend_vma.h"
 #include "wrappers/buffer.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
 #include "wrappers/device.h"
 #include "wrappers/fence.h"
 #include "wrappers/image.h"
 #include "wrappers/instance.h"
 #include "wrappers/memory_block.h"
 #include "wrappers/queue.h"
+#include <algorithm>
 #include <set>
+#include <sstream>
+
+namespace
+{
+    /* Writes @param in_string to @param in_stream as a JSON string literal. */
+    void write_json_string(std::ostream&      in_stream,
+                           const std::string& in_string)
+    {
+        static const char* hex_digits = "0123456789abcdef";
+
+        in_stream << "\"";
+
+        for (const auto current_char : in_string)
+        {
+            if (current_char == '"' ||
+                current_char == '\\')
+            {
+                in_stream << '\\'
+                          << current_char;
+            }
+            else
+            if (static_cast<unsigned char>(current_char) < 0x20)
+            {
+                /* Control characters need to be escaped */
+                in_stream << "\\u00"
+                          << hex_digits[(current_char >> 4) & 0xF]
+                          << hex_digits[ current_char       & 0xF];
+            }
+            else
+            {
+                in_stream << current_char;
+            }
+        }
+
+        in_stream << "\"";
+    }
+}
 
 /* Please see header for specification */
 Anvil::MemoryAllocator::Item::Item(Anvil::MemoryAllocator*                     in_memory_allocator_ptr,
@@ -76,12 +117,15 @@ Anvil::MemoryAllocator::Item::Item(Anvil::MemoryAllocator*                     i
     alloc_mgpu_peer_memory_reqs            = in_mgpu_peer_memory_reqs;
     alloc_size                             = in_alloc_size;
     buffer_ptr                             = in_buffer_ptr;
+    first_use                              = 0;
     image_ptr                              = nullptr;
     is_baked                               = false;
+    last_use                               = UINT32_MAX;
     memory_allocator_ptr                   = in_memory_allocator_ptr;
     memory_priority                        = in_memory_priority;
     n_layer                                = UINT32_MAX;
     n_plane                                = UINT32_MAX;
+    tag                                    = in_memory_allocator_ptr->m_allocation_tag;
     type                                   = ITEM_TYPE_BUFFER;
 
     register_for_callbacks();
@@ -127,12 +171,15 @@ Anvil::MemoryAllocator::Item::Item(Anvil::MemoryAllocator*                     i
     alloc_offset                           = in_alloc_offset;
     alloc_size                             = in_alloc_size;
     buffer_ptr                             = in_buffer_ptr;
+    first_use                              = 0;
     image_ptr                              = nullptr;
     is_baked                               = false;
+    last_use                               = UINT32_MAX;
     memory_allocator_ptr                   = in_memory_allocator_ptr;
     memory_priority                        = in_memory_priority;
     n_layer                                = UINT32_MAX;
     n_plane                                = UINT32_MAX;
+    tag                                    = in_memory_allocator_ptr->m_allocation_tag;
     type                                   = ITEM_TYPE_SPARSE_BUFFER_REGION;
 
     register_for_callbacks();
@@ -181,8 +228,10 @@ Anvil::MemoryAllocator::Item::Item(Anvil::MemoryAllocator*                     i
     alloc_offset                           = UINT64_MAX;
     alloc_size                             = in_alloc_size;
     buffer_ptr                             = nullptr;
+    first_use                              = 0;
     image_ptr                              = in_image_ptr;
     is_baked                               = false;
+    last_use                               = UINT32_MAX;
     memory_allocator_ptr                   = in_memory_allocator_ptr;
     memory_priority                        = in_memory_priority;
     miptail_offset                         = in_miptail_offset;
@@ -190,6 +239,7 @@ Anvil::MemoryAllocator::Item::Item(Anvil::MemoryAllocator*                     i
     n_plane                                = (in_alloc_aspect == Anvil::ImageAspectFlagBits::PLANE_1_BIT) ? 1
                                            : (in_alloc_aspect == Anvil::ImageAspectFlagBits::PLANE_2_BIT) ? 2
                                                                                                           : 0;
+    tag                                    = in_memory_allocator_ptr->m_allocation_tag;
     type                                   = ITEM_TYPE_SPARSE_IMAGE_MIPTAIL;
 
     register_for_callbacks();
@@ -239,8 +289,10 @@ Anvil::MemoryAllocator::Item::Item(Anvil::MemoryAllocator*                     i
     alloc_size                             = in_alloc_size;
     buffer_ptr                             = nullptr;
     extent                                 = in_extent;
+    first_use                              = 0;
     image_ptr                              = in_image_ptr;
     is_baked                               = false;
+    last_use                               = UINT32_MAX;
     memory_allocator_ptr                   = in_memory_allocator_ptr;
     memory_priority                        = in_memory_priority;
     n_layer                                = UINT32_MAX;
@@ -249,6 +301,7 @@ Anvil::MemoryAllocator::Item::Item(Anvil::MemoryAllocator*                     i
                                                                                                                      : 0;
     offset                                 = in_offset;
     subresource                            = in_subresource;
+    tag                                    = in_memory_allocator_ptr->m_allocation_tag;
     type                                   = ITEM_TYPE_SPARSE_IMAGE_SUBRESOURCE;
 
     register_for_callbacks();
@@ -295,12 +348,15 @@ Anvil::MemoryAllocator::Item::Item(Anvil::MemoryAllocator*                     i
     alloc_offset                           = UINT64_MAX;
     alloc_size                             = in_alloc_size;
     buffer_ptr                             = nullptr;
+    first_use                              = 0;
     image_ptr                              = in_image_ptr;
     is_baked                               = false;
+    last_use                               = UINT32_MAX;
     memory_allocator_ptr                   = in_memory_allocator_ptr;
     memory_priority                        = in_memory_priority;
     n_layer                                = UINT32_MAX;
     n_plane                                = in_n_plane;
+    tag                                    = in_memory_allocator_ptr->m_allocation_tag;
     type                                   = ITEM_TYPE_IMAGE_WHOLE;
 
     register_for_callbacks();
@@ -443,6 +499,30 @@ void Anvil::MemoryAllocator::Item::unregister_from_callbacks()
     }
 }
 
+/* Please see header for specification */
+std::vector<const Anvil::MemoryBlock*> Anvil::MemoryAllocator::IMemoryAllocatorBackend::get_baked_memory_blocks() const
+{
+    std::lock_guard<std::mutex> lock(m_baked_memory_blocks_mutex);
+
+    return std::vector<const Anvil::MemoryBlock*>(m_baked_memory_blocks.begin(),
+                                                  m_baked_memory_blocks.end  () );
+}
+
+/* Please see header for specification */
+void Anvil::MemoryAllocator::IMemoryAllocatorBackend::on_memory_block_baked(const Anvil::MemoryBlock* in_memory_block_ptr)
+{
+    std::lock_guard<std::mutex> lock(m_baked_memory_blocks_mutex);
+
+    m_baked_memory_blocks.insert(in_memory_block_ptr);
+}
+
+/* Please see header for specification */
+void Anvil::MemoryAllocator::IMemoryAllocatorBackend::on_memory_block_released(const Anvil::MemoryBlock* in_memory_block_ptr)
+{
+    std::lock_guard<std::mutex> lock(m_baked_memory_blocks_mutex);
+
+    m_baked_memory_blocks.erase(in_memory_block_ptr);
+}
 
 /* Please see header for specification */
 Anvil::MemoryAllocator::MemoryAllocator(const Anvil::BaseDevice*                 in_device_ptr,
@@ -1488,6 +1568,8 @@ end:
 /* Please see header for specification */
 bool Anvil::MemoryAllocator::bake()
 {
+    ANVIL_INSTRUMENTATION_SCOPE("MemoryAllocator::bake");
+
     Anvil::SparseMemoryBindInfoID                                          default_sparse_bind_info_id               = UINT32_MAX;
     std::map<ResourceMemoryDeviceIndexPair, Anvil::SparseMemoryBindInfoID> device_index_pair_to_sparse_bind_info_map;
     std::vector<Anvil::FenceUniquePtr>                                     fences;
@@ -1512,6 +1594,9 @@ bool Anvil::MemoryAllocator::bake()
         goto end;
     }
 
+    ANVIL_INSTRUMENTATION_COUNTER("MemoryAllocator::bake items",
+                                  m_items.size() );
+
     if (m_items.size() == 0)
     {
         result = true;
@@ -1520,6 +1605,24 @@ bool Anvil::MemoryAllocator::bake()
     }
 
     result = m_backend_ptr->bake(m_items);
+
+    /* Blocks are tagged and registered even if only some of the items have been baked, since the backend may have
+     * allocated memory for the successful ones. */
+    for (const auto& item_ptr : m_items)
+    {
+        if (item_ptr->alloc_memory_block_ptr == nullptr)
+        {
+            continue;
+        }
+
+        if (!item_ptr->tag.empty() )
+        {
+            item_ptr->alloc_memory_block_ptr->set_tag(item_ptr->tag);
+        }
+
+        m_backend_ptr->on_memory_block_baked(item_ptr->alloc_memory_block_ptr.get() );
+    }
+
     if (!result)
     {
         m_items.clear();
@@ -1949,11 +2052,11 @@ bool Anvil::MemoryAllocator::bake()
             anvil_assert(result);
 
             /* Block until the sparse memory bindings are in place */
-            Anvil::Vulkan::vkWaitForFences(m_device_ptr->get_device_vk(),
-                                           1, /* fenceCount */
-                                           sparse_memory_binding.get_fence()->get_fence_ptr(),
-                                           VK_FALSE, /* waitAll */
-                                           UINT64_MAX);
+            m_device_ptr->get_dispatch_table().vkWaitForFences(m_device_ptr->get_device_vk(),
+                                                               1, /* fenceCount */
+                                                               sparse_memory_binding.get_fence()->get_fence_ptr(),
+                                                               VK_FALSE, /* waitAll */
+                                                               UINT64_MAX);
         }
     }
 
@@ -2000,63 +2103,9 @@ bool Anvil::MemoryAllocator::bake()
     /* Perform post-alloc fill actions */
     if (m_post_bake_per_buffer_item_mem_assignment_callback_function == nullptr)
     {
-        for (const auto& current_item_ptr : m_items)
+        if (!fill_buffers_with_post_fill_data() )
         {
-            VkDeviceSize buffer_size   = 0;
-
-            if (current_item_ptr->type != Anvil::MemoryAllocator::ITEM_TYPE_BUFFER)
-            {
-                continue;
-            }
-
-            if (!current_item_ptr->is_baked)
-            {
-                continue;
-            }
-
-            buffer_size = current_item_ptr->buffer_ptr->get_create_info_ptr()->get_size();
-
-            if (current_item_ptr->buffer_ref_float_data_ptr != nullptr)
-            {
-                current_item_ptr->buffer_ptr->write(0, /* start_offset */
-                                                    buffer_size,
-                                                    current_item_ptr->buffer_ref_float_data_ptr.get() );
-            }
-            else
-            if (current_item_ptr->buffer_ref_float_vector_data_ptr != nullptr)
-            {
-                current_item_ptr->buffer_ptr->write(0, /* start_offset */
-                                                   buffer_size,
-                                                  &(*current_item_ptr->buffer_ref_float_vector_data_ptr)[0]);
-            }
-            else
-            if (current_item_ptr->buffer_ref_uchar8_data_ptr != nullptr)
-            {
-                current_item_ptr->buffer_ptr->write(0, /* start_offset */
-                                                    buffer_size,
-                                                    current_item_ptr->buffer_ref_uchar8_data_ptr.get() );
-            }
-            else
-            if (current_item_ptr->buffer_ref_uchar8_vector_data_ptr != nullptr)
-            {
-                current_item_ptr->buffer_ptr->write(0, /* start_offset */
-                                                    buffer_size,
-                                                   &(*current_item_ptr->buffer_ref_uchar8_vector_data_ptr)[0]);
-            }
-            else
-            if (current_item_ptr->buffer_ref_uint32_data_ptr != nullptr)
-            {
-                current_item_ptr->buffer_ptr->write(0, /* start_offset */
-                                                    buffer_size,
-                                                    current_item_ptr->buffer_ref_uint32_data_ptr.get() );
-            }
-            else
-            if (current_item_ptr->buffer_ref_uint32_vector_data_ptr != nullptr)
-            {
-                current_item_ptr->buffer_ptr->write(0, /* start_offset */
-                                                    buffer_size,
-                                                   &(*current_item_ptr->buffer_ref_uint32_vector_data_ptr)[0]);
-            }
+            anvil_assert_fail();
         }
     }
 
@@ -2087,7 +2136,35 @@ Anvil::MemoryAllocatorUniquePtr Anvil::MemoryAllocator::create_oneshot(const Anv
                                                          std::default_delete<MemoryAllocator>() );
 
     backend_ptr.reset(
-        new Anvil::MemoryAllocatorBackends::OneShot(in_device_ptr)
+        new Anvil::MemoryAllocatorBackends::OneShot(in_device_ptr,
+                                                    false) /* in_alias_items_with_disjoint_lifetimes */
+    );
+
+    if (backend_ptr != nullptr)
+    {
+        result_ptr.reset(
+            new Anvil::MemoryAllocator(in_device_ptr,
+                                       backend_ptr,
+                                       mt_safe)
+        );
+    }
+
+    return std::move(result_ptr);
+}
+
+/* Please see header for specification */
+Anvil::MemoryAllocatorUniquePtr Anvil::MemoryAllocator::create_transient(const Anvil::BaseDevice* in_device_ptr,
+                                                                         MTSafety                 in_mt_safety)
+{
+    std::shared_ptr<IMemoryAllocatorBackend> backend_ptr;
+    const bool                               mt_safe    (Anvil::Utils::convert_mt_safety_enum_to_boolean(in_mt_safety,
+                                                                                                         in_device_ptr) );
+    std::unique_ptr<MemoryAllocator>         result_ptr (nullptr,
+                                                         std::default_delete<MemoryAllocator>() );
+
+    backend_ptr.reset(
+        new Anvil::MemoryAllocatorBackends::OneShot(in_device_ptr,
+                                                    true) /* in_alias_items_with_disjoint_lifetimes */
     );
 
     if (backend_ptr != nullptr)
@@ -2126,6 +2203,264 @@ Anvil::MemoryAllocatorUniquePtr Anvil::MemoryAllocator::create_vma(const Anvil::
     return std::move(result_ptr);
 }
 
+/** Fills all baked buffer items with data specified at add_buffer_with_*_post_fill() call time.
+ *
+ *  Buffers backed by mappable memory are written to directly. Data of all other buffers is packed into a single
+ *  staging buffer per queue and copied to the destination buffers with a single command buffer, submitted once.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::MemoryAllocator::fill_buffers_with_post_fill_data()
+{
+    typedef struct PostFillCopy
+    {
+        Anvil::Buffer* buffer_ptr;
+        const void*    data_ptr;
+        VkDeviceSize   size;
+        VkDeviceSize   staging_buffer_offset;
+    } PostFillCopy;
+
+    typedef struct PostFillBatch
+    {
+        std::vector<PostFillCopy>  copies;
+        Anvil::QueueFamilyFlagBits queue_fam_bits;
+        VkDeviceSize               staging_buffer_size;
+
+        PostFillBatch()
+            :queue_fam_bits     (Anvil::QueueFamilyFlagBits::NONE),
+             staging_buffer_size(0)
+        {
+            /* Stub */
+        }
+    } PostFillBatch;
+
+    /* Keep staging regions aligned to a value which satisfies alignment requirements of all formats used by the
+     * most common buffer types (vertex, index, uniform). */
+    const VkDeviceSize                     staging_region_alignment = 16;
+    std::map<Anvil::Queue*, PostFillBatch> batches;
+    bool                                   result                   = true;
+
+    for (const auto& current_item_ptr : m_items)
+    {
+        Anvil::Buffer*      buffer_ptr       = nullptr;
+        VkDeviceSize        buffer_size      = 0;
+        const void*         data_ptr         = nullptr;
+        Anvil::MemoryBlock* memory_block_ptr = nullptr;
+
+        if (current_item_ptr->type != Anvil::MemoryAllocator::ITEM_TYPE_BUFFER ||
+           !current_item_ptr->is_baked)
+        {
+            continue;
+        }
+
+        data_ptr = get_post_fill_data_ptr(current_item_ptr.get() );
+
+        if (data_ptr == nullptr)
+        {
+            continue;
+        }
+
+        buffer_ptr       = current_item_ptr->buffer_ptr;
+        buffer_size      = buffer_ptr->get_create_info_ptr()->get_size();
+        memory_block_ptr = buffer_ptr->get_memory_block(0);
+
+        /* Mappable memory can be written to directly. Multi-GPU uploads may need to target more than one memory instance,
+         * so leave these to Buffer::write(), too.
+         */
+        if ((memory_block_ptr->get_create_info_ptr()->get_memory_features() & Anvil::MemoryFeatureFlagBits::MAPPABLE_BIT) != 0 ||
+            m_device_ptr->get_type()                                                                                     != Anvil::DeviceType::SINGLE_GPU)
+        {
+            if (!buffer_ptr->write(0, /* start_offset */
+                                   buffer_size,
+                                   data_ptr) )
+            {
+                result = false;
+            }
+
+            continue;
+        }
+
+        {
+            Anvil::QueueFamilyFlagBits queue_fam_bits = Anvil::QueueFamilyFlagBits::NONE;
+            Anvil::Queue*              queue_ptr      = buffer_ptr->get_staging_queue(nullptr, /* in_opt_queue_ptr */
+                                                                                     &queue_fam_bits);
+            PostFillCopy               new_copy;
+
+            if (queue_ptr == nullptr)
+            {
+                /* An EXCLUSIVE buffer which can be used with more than one queue family type. The data must be
+                 * uploaded using a queue of the family the buffer is going to be used with first, which we cannot
+                 * tell. Apps need to fill such buffers with Buffer::write(), passing the queue to use. */
+                result = false;
+
+                continue;
+            }
+
+            auto& batch = batches[queue_ptr];
+
+            new_copy.buffer_ptr            = buffer_ptr;
+            new_copy.data_ptr              = data_ptr;
+            new_copy.size                  = buffer_size;
+            new_copy.staging_buffer_offset = Anvil::Utils::round_up(batch.staging_buffer_size,
+                                                                    staging_region_alignment);
+
+            batch.copies.push_back(new_copy);
+
+            batch.queue_fam_bits      = queue_fam_bits;
+            batch.staging_buffer_size = new_copy.staging_buffer_offset + buffer_size;
+        }
+    }
+
+    for (const auto& current_batch : batches)
+    {
+        const auto&                          batch                    = current_batch.second;
+        Anvil::PrimaryCommandBufferUniquePtr copy_cmdbuf_ptr;
+        Anvil::Queue*                        queue_ptr                = current_batch.first;
+        Anvil::BufferUniquePtr               staging_buffer_ptr;
+        Anvil::MemoryBlock*                  staging_memory_block_ptr = nullptr;
+
+        /* Pack data of all buffers handled by the queue into a single staging buffer */
+        {
+            auto create_info_ptr = Anvil::BufferCreateInfo::create_alloc(m_device_ptr,
+                                                                         batch.staging_buffer_size,
+                                                                         batch.queue_fam_bits,
+                                                                         Anvil::SharingMode::EXCLUSIVE,
+                                                                         Anvil::BufferCreateFlagBits::NONE,
+                                                                         Anvil::BufferUsageFlagBits::TRANSFER_SRC_BIT,
+                                                                         Anvil::MemoryFeatureFlagBits::MAPPABLE_BIT);
+
+            create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
+
+            staging_buffer_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
+        }
+
+        if (staging_buffer_ptr == nullptr)
+        {
+            anvil_assert(staging_buffer_ptr != nullptr);
+
+            result = false;
+            continue;
+        }
+
+        staging_memory_block_ptr = staging_buffer_ptr->get_memory_block(0);
+
+        /* Keep the staging memory mapped while it is being filled, so that it only needs to be mapped once. */
+        if (!staging_memory_block_ptr->map(0, /* in_start_offset */
+                                           batch.staging_buffer_size) )
+        {
+            anvil_assert_fail();
+
+            result = false;
+            continue;
+        }
+
+        for (const auto& current_copy : batch.copies)
+        {
+            staging_memory_block_ptr->write(current_copy.staging_buffer_offset,
+                                            current_copy.size,
+                                            current_copy.data_ptr);
+        }
+
+        staging_memory_block_ptr->unmap();
+
+        /* Record all copy ops into a single command buffer */
+        copy_cmdbuf_ptr = m_device_ptr->get_command_pool_for_queue_family_index(queue_ptr->get_queue_family_index() )->alloc_primary_level_command_buffer();
+
+        if (copy_cmdbuf_ptr == nullptr)
+        {
+            anvil_assert(copy_cmdbuf_ptr != nullptr);
+
+            result = false;
+            continue;
+        }
+
+        copy_cmdbuf_ptr->start_recording(true,   /* one_time_submit          */
+                                         false); /* simultaneous_use_allowed */
+        {
+            Anvil::BufferBarrier staging_buffer_barrier(Anvil::AccessFlagBits::HOST_WRITE_BIT,
+                                                        Anvil::AccessFlagBits::TRANSFER_READ_BIT,
+                                                        VK_QUEUE_FAMILY_IGNORED,
+                                                        VK_QUEUE_FAMILY_IGNORED,
+                                                        staging_buffer_ptr.get(),
+                                                        0, /* in_offset */
+                                                        batch.staging_buffer_size);
+
+            copy_cmdbuf_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::HOST_BIT,
+                                                     Anvil::PipelineStageFlagBits::TRANSFER_BIT,
+                                                     Anvil::DependencyFlagBits::NONE,
+                                                     0,                       /* in_memory_barrier_count        */
+                                                     nullptr,                 /* in_memory_barriers_ptr         */
+                                                     1,                       /* in_buffer_memory_barrier_count */
+                                                    &staging_buffer_barrier,
+                                                     0,                       /* in_image_memory_barrier_count  */
+                                                     nullptr);                /* in_image_memory_barriers_ptr   */
+
+            for (const auto& current_copy : batch.copies)
+            {
+                Anvil::BufferCopy copy_region;
+
+                copy_region.dst_offset = 0;
+                copy_region.size       = current_copy.size;
+                copy_region.src_offset = current_copy.staging_buffer_offset;
+
+                copy_cmdbuf_ptr->record_copy_buffer(staging_buffer_ptr.get(),
+                                                    current_copy.buffer_ptr,
+                                                    1, /* in_region_count */
+                                                   &copy_region);
+            }
+        }
+        copy_cmdbuf_ptr->stop_recording();
+
+        if (!queue_ptr->submit(Anvil::SubmitInfo::create_execute(copy_cmdbuf_ptr.get(),
+                                                                 true /* should_block */) ))
+        {
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+/** Returns a pointer to data the buffer item should be filled with after it is assigned memory backing,
+ *  or nullptr if no post-fill data was specified for the item.
+ **/
+const void* Anvil::MemoryAllocator::get_post_fill_data_ptr(const Item* in_item_ptr)
+{
+    const void* result_ptr = nullptr;
+
+    if (in_item_ptr->buffer_ref_float_data_ptr != nullptr)
+    {
+        result_ptr = in_item_ptr->buffer_ref_float_data_ptr.get();
+    }
+    else
+    if (in_item_ptr->buffer_ref_float_vector_data_ptr != nullptr)
+    {
+        result_ptr = &(*in_item_ptr->buffer_ref_float_vector_data_ptr)[0];
+    }
+    else
+    if (in_item_ptr->buffer_ref_uchar8_data_ptr != nullptr)
+    {
+        result_ptr = in_item_ptr->buffer_ref_uchar8_data_ptr.get();
+    }
+    else
+    if (in_item_ptr->buffer_ref_uchar8_vector_data_ptr != nullptr)
+    {
+        result_ptr = &(*in_item_ptr->buffer_ref_uchar8_vector_data_ptr)[0];
+    }
+    else
+    if (in_item_ptr->buffer_ref_uint32_data_ptr != nullptr)
+    {
+        result_ptr = in_item_ptr->buffer_ref_uint32_data_ptr.get();
+    }
+    else
+    if (in_item_ptr->buffer_ref_uint32_vector_data_ptr != nullptr)
+    {
+        result_ptr = &(*in_item_ptr->buffer_ref_uint32_vector_data_ptr)[0];
+    }
+
+    return result_ptr;
+}
+
 bool Anvil::MemoryAllocator::do_external_memory_handle_type_sanity_checks(const Anvil::ExternalMemoryHandleTypeFlags& in_external_memory_handle_types) const
 {
     bool result = true;
@@ -2202,6 +2537,116 @@ end:
     return result;
 }
 
+/* Please see header for specification */
+void Anvil::MemoryAllocator::get_statistics(std::vector<MemoryTypeStatistics>* out_statistics_ptr) const
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    out_statistics_ptr->clear ();
+    out_statistics_ptr->resize(m_device_ptr->get_physical_device_memory_properties().types.size() );
+
+    m_backend_ptr->get_memory_type_statistics(out_statistics_ptr);
+}
+
+/* Please see header for specification */
+std::string Anvil::MemoryAllocator::get_statistics_json() const
+{
+    std::vector<const Anvil::MemoryBlock*> memory_blocks     (m_backend_ptr->get_baked_memory_blocks() );
+    const auto&                            memory_props      (m_device_ptr->get_physical_device_memory_properties() );
+    bool                                   needs_separator   (false);
+    std::stringstream                      result_sstream;
+    std::vector<MemoryTypeStatistics>      statistics;
+
+    get_statistics(&statistics);
+
+    /* Sort the allocations, so that reports taken at different times can be easily compared */
+    std::sort(memory_blocks.begin(),
+              memory_blocks.end  (),
+              [](const Anvil::MemoryBlock* in_block1_ptr,
+                 const Anvil::MemoryBlock* in_block2_ptr)
+              {
+                  if (in_block1_ptr->get_tag() != in_block2_ptr->get_tag() )
+                  {
+                      return in_block1_ptr->get_tag() < in_block2_ptr->get_tag();
+                  }
+
+                  if (in_block1_ptr->get_memory() != in_block2_ptr->get_memory() )
+                  {
+                      return in_block1_ptr->get_memory() < in_block2_ptr->get_memory();
+                  }
+
+                  return in_block1_ptr->get_start_offset() < in_block2_ptr->get_start_offset();
+              });
+
+    result_sstream << "{\"memory_types\":[";
+
+    for (uint32_t n_memory_type = 0;
+                  n_memory_type < static_cast<uint32_t>(statistics.size() );
+                ++n_memory_type)
+    {
+        const auto& current_statistics = statistics.at(n_memory_type);
+
+        if (current_statistics.n_blocks == 0)
+        {
+            continue;
+        }
+
+        if (needs_separator)
+        {
+            result_sstream << ",";
+        }
+
+        result_sstream << "{\"index\":"                   << n_memory_type
+                       << ",\"heap\":"                    << memory_props.types.at(n_memory_type).heap_ptr->index
+                       << ",\"n_blocks\":"                << current_statistics.n_blocks
+                       << ",\"n_allocations\":"           << current_statistics.n_allocations
+                       << ",\"reserved_size\":"           << current_statistics.reserved_size
+                       << ",\"used_size\":"               << current_statistics.used_size
+                       << ",\"n_free_ranges\":"           << current_statistics.n_free_ranges
+                       << ",\"largest_free_range_size\":" << current_statistics.largest_free_range_size
+                       << ",\"fragmentation\":"           << current_statistics.get_fragmentation()
+                       << "}";
+
+        needs_separator = true;
+    }
+
+    result_sstream << "],\"allocations\":[";
+
+    needs_separator = false;
+
+    for (const auto current_memory_block_ptr : memory_blocks)
+    {
+        if (needs_separator)
+        {
+            result_sstream << ",";
+        }
+
+        result_sstream << "{\"tag\":";
+
+        write_json_string(result_sstream,
+                          current_memory_block_ptr->get_tag() );
+
+        result_sstream << ",\"memory_type\":" << current_memory_block_ptr->get_create_info_ptr()->get_memory_type_index()
+                       << ",\"offset\":"      << current_memory_block_ptr->get_start_offset()
+                       << ",\"size\":"        << current_memory_block_ptr->get_create_info_ptr()->get_size()
+                       << "}";
+
+        needs_separator = true;
+    }
+
+    result_sstream << "]}";
+
+    return result_sstream.str();
+}
+
 /* Please see header for specification */
 void Anvil::MemoryAllocator::on_is_alloc_pending_for_buffer_query(CallbackArgument* in_callback_arg_ptr)
 {
@@ -2253,6 +2698,85 @@ void Anvil::MemoryAllocator::on_implicit_bake_needed()
     bake();
 }
 
+/* Please see header for specification */
+void Anvil::MemoryAllocator::set_allocation_tag(const std::string& in_tag)
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    m_allocation_tag = in_tag;
+}
+
+/* Please see header for specification */
+bool Anvil::MemoryAllocator::set_lifetime(Anvil::Buffer* in_buffer_ptr,
+                                          uint32_t       in_first_use,
+                                          uint32_t       in_last_use)
+{
+    return set_lifetime_internal(in_buffer_ptr,
+                                 in_first_use,
+                                 in_last_use);
+}
+
+/* Please see header for specification */
+bool Anvil::MemoryAllocator::set_lifetime(Anvil::Image* in_image_ptr,
+                                          uint32_t      in_first_use,
+                                          uint32_t      in_last_use)
+{
+    return set_lifetime_internal(in_image_ptr,
+                                 in_first_use,
+                                 in_last_use);
+}
+
+/** Assigns the specified lifetime to all items which have been added for the specified buffer or image.
+ *
+ *  @return true if at least one item has been updated, false otherwise.
+ **/
+bool Anvil::MemoryAllocator::set_lifetime_internal(const void* in_buffer_or_image_ptr,
+                                                   uint32_t    in_first_use,
+                                                   uint32_t    in_last_use)
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+    bool                                   result    = false;
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    if (in_first_use > in_last_use)
+    {
+        anvil_assert(in_first_use <= in_last_use);
+
+        goto end;
+    }
+
+    for (auto& current_item_ptr : m_items)
+    {
+        if (current_item_ptr->buffer_ptr == in_buffer_or_image_ptr ||
+            current_item_ptr->image_ptr  == in_buffer_or_image_ptr)
+        {
+            current_item_ptr->first_use = in_first_use;
+            current_item_ptr->last_use  = in_last_use;
+
+            result = true;
+        }
+    }
+
+    anvil_assert(result);
+end:
+    return result;
+}
+
 /* Please see header for specification */
 void Anvil::MemoryAllocator::set_post_bake_callback(MemoryAllocatorBakeCallbackFunction in_post_bake_callback_function)
 {
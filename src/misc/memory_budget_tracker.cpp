@@ -0,0 +1,405 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "misc/debug.h"
+#include "misc/memory_block_create_info.h"
+#include "misc/memory_budget_tracker.h"
+#include "misc/object_tracker.h"
+#include "wrappers/device.h"
+#include "wrappers/instance.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/physical_device.h"
+#include <algorithm>
+
+
+/** Constructor. */
+Anvil::MemoryBudgetTracker::MemoryBudgetTracker(const Anvil::BaseDevice* in_device_ptr,
+                                                bool                     in_mt_safe)
+    :CallbacksSupportProvider   (MEMORY_BUDGET_TRACKER_CALLBACK_ID_COUNT),
+     MTSafetySupportProvider    (in_mt_safe),
+     m_device_ptr               (in_device_ptr),
+     m_is_budget_query_supported(false)
+{
+    const auto& memory_props        = in_device_ptr->get_physical_device_memory_properties();
+    const auto  physical_device_ptr = in_device_ptr->get_create_info_ptr()->get_physical_device_ptrs().at(0);
+
+    m_heaps.resize                      (memory_props.n_heaps);
+    m_memory_type_allocated_sizes.resize(memory_props.types.size(),
+                                         0);
+    m_memory_type_heap_indices.resize   (memory_props.types.size(),
+                                         0);
+
+    for (uint32_t n_memory_type = 0;
+                  n_memory_type < static_cast<uint32_t>(memory_props.types.size() );
+                ++n_memory_type)
+    {
+        m_memory_type_heap_indices.at(n_memory_type) = memory_props.types.at(n_memory_type).heap_ptr->index;
+    }
+
+    /* VkPhysicalDeviceMemoryBudgetPropertiesEXT may only be chained if the extension has been enabled on the device */
+    m_is_budget_query_supported = physical_device_ptr->get_instance()->get_enabled_extensions_info()->khr_get_physical_device_properties2() &&
+                                  in_device_ptr->get_extension_info                                  ()->ext_memory_budget                  ();
+
+    m_pressure_thresholds.push_back(0.75f);
+    m_pressure_thresholds.push_back(0.90f);
+    m_pressure_thresholds.push_back(0.95f);
+
+    query_budget();
+
+    /* Register the object */
+    Anvil::ObjectTracker::get()->register_object(Anvil::ObjectType::ANVIL_MEMORY_BUDGET_TRACKER,
+                                                  this);
+}
+
+/** Destructor */
+Anvil::MemoryBudgetTracker::~MemoryBudgetTracker()
+{
+    /* All memory blocks must have been released by the time the device goes down */
+    #ifdef _DEBUG
+    {
+        for (const auto& current_heap : m_heaps)
+        {
+            anvil_assert(current_heap.allocated_size == 0);
+        }
+    }
+    #endif
+
+    /* Unregister the object */
+    Anvil::ObjectTracker::get()->unregister_object(Anvil::ObjectType::ANVIL_MEMORY_BUDGET_TRACKER,
+                                                    this);
+}
+
+/* Please see header for specification */
+Anvil::MemoryBudgetTrackerUniquePtr Anvil::MemoryBudgetTracker::create(const Anvil::BaseDevice* in_device_ptr,
+                                                                       bool                     in_mt_safe)
+{
+    MemoryBudgetTrackerUniquePtr result_ptr(nullptr,
+                                            std::default_delete<MemoryBudgetTracker>() );
+
+    result_ptr.reset(
+        new Anvil::MemoryBudgetTracker(in_device_ptr,
+                                       in_mt_safe)
+    );
+
+    anvil_assert(result_ptr != nullptr);
+    return result_ptr;
+}
+
+/* Please see header for specification */
+VkDeviceSize Anvil::MemoryBudgetTracker::get_allocated_size_for_heap(uint32_t in_n_heap) const
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    anvil_assert(in_n_heap < m_heaps.size() );
+
+    return m_heaps.at(in_n_heap).allocated_size;
+}
+
+/* Please see header for specification */
+VkDeviceSize Anvil::MemoryBudgetTracker::get_allocated_size_for_memory_type(uint32_t in_n_memory_type) const
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    anvil_assert(in_n_memory_type < m_memory_type_allocated_sizes.size() );
+
+    return m_memory_type_allocated_sizes.at(in_n_memory_type);
+}
+
+/** Returns the estimated process-wide usage of the specified heap. Please see class documentation for details. */
+VkDeviceSize Anvil::MemoryBudgetTracker::get_estimated_heap_usage(const HeapData& in_heap_data) const
+{
+    VkDeviceSize result = in_heap_data.allocated_size;
+
+    if (m_is_budget_query_supported)
+    {
+        /* Anvil's own allocations are included in the driver-reported usage. Only account for the delta. */
+        if (in_heap_data.allocated_size >= in_heap_data.allocated_size_at_last_refresh)
+        {
+            result = in_heap_data.usage_at_last_refresh + (in_heap_data.allocated_size - in_heap_data.allocated_size_at_last_refresh);
+        }
+        else
+        {
+            const VkDeviceSize released_size = in_heap_data.allocated_size_at_last_refresh - in_heap_data.allocated_size;
+
+            result = (in_heap_data.usage_at_last_refresh > released_size) ? in_heap_data.usage_at_last_refresh - released_size
+                                                                          : 0;
+        }
+    }
+
+    return result;
+}
+
+/** Returns the number of pressure thresholds exceeded by @param in_usage, given heap budget @param in_budget. */
+uint32_t Anvil::MemoryBudgetTracker::get_n_thresholds_exceeded(VkDeviceSize in_usage,
+                                                               VkDeviceSize in_budget) const
+{
+    uint32_t result = 0;
+
+    while (result                          <  static_cast<uint32_t>(m_pressure_thresholds.size() )                      &&
+           static_cast<double>(in_usage) >  static_cast<double>(in_budget) * m_pressure_thresholds.at(result) )
+    {
+        ++result;
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::MemoryBudgetTracker::HeapBudget Anvil::MemoryBudgetTracker::get_heap_budget(uint32_t in_n_heap) const
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+    HeapBudget                             result;
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    anvil_assert(in_n_heap < m_heaps.size() );
+
+    {
+        const auto& heap_data = m_heaps.at(in_n_heap);
+
+        result.allocated_size = heap_data.allocated_size;
+        result.budget         = heap_data.budget;
+        result.usage          = get_estimated_heap_usage(heap_data);
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+std::vector<float> Anvil::MemoryBudgetTracker::get_pressure_thresholds() const
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    return m_pressure_thresholds;
+}
+
+/** Accounts for a new memory allocation. Called by MemoryBlock at creation time. */
+void Anvil::MemoryBudgetTracker::on_memory_block_allocated(const Anvil::MemoryBlock* in_memory_block_ptr)
+{
+    const auto n_memory_type = in_memory_block_ptr->get_create_info_ptr()->get_memory_type_index();
+    const auto size          = in_memory_block_ptr->get_create_info_ptr()->get_size             ();
+
+    lock();
+    {
+        anvil_assert(n_memory_type < m_memory_type_allocated_sizes.size() );
+
+        m_heaps.at                      (m_memory_type_heap_indices.at(n_memory_type) ).allocated_size += size;
+        m_memory_type_allocated_sizes.at(n_memory_type)                                                += size;
+    }
+    unlock();
+
+    update_pressure_levels(true); /* in_allow_budget_query */
+}
+
+/** Accounts for a memory allocation being released. Called by MemoryBlock at destruction time. */
+void Anvil::MemoryBudgetTracker::on_memory_block_released(const Anvil::MemoryBlock* in_memory_block_ptr)
+{
+    const auto n_memory_type = in_memory_block_ptr->get_create_info_ptr()->get_memory_type_index();
+    const auto size          = in_memory_block_ptr->get_create_info_ptr()->get_size             ();
+
+    lock();
+    {
+        auto& heap_data = m_heaps.at(m_memory_type_heap_indices.at(n_memory_type) );
+
+        anvil_assert(heap_data.allocated_size                         >= size);
+        anvil_assert(m_memory_type_allocated_sizes.at(n_memory_type) >= size);
+
+        heap_data.allocated_size                       -= size;
+        m_memory_type_allocated_sizes.at(n_memory_type) -= size;
+    }
+    unlock();
+
+    update_pressure_levels(false); /* in_allow_budget_query */
+}
+
+/** Re-queries heap budgets & usage from the driver. If VK_EXT_memory_budget is unsupported, heap sizes are
+ *  used as budgets.
+ *
+ *  Must be called with the mutex held.
+ **/
+void Anvil::MemoryBudgetTracker::query_budget()
+{
+    const auto& memory_props = m_device_ptr->get_physical_device_memory_properties();
+
+    if (m_is_budget_query_supported)
+    {
+        const auto budget = m_device_ptr->get_create_info_ptr()->get_physical_device_ptrs().at(0)->get_available_memory_budget();
+
+        for (uint32_t n_heap = 0;
+                      n_heap < static_cast<uint32_t>(m_heaps.size() );
+                    ++n_heap)
+        {
+            auto& heap_data = m_heaps.at(n_heap);
+
+            heap_data.allocated_size_at_last_refresh = heap_data.allocated_size;
+            heap_data.budget                         = budget.heap_budget.at(n_heap);
+            heap_data.usage_at_last_refresh          = budget.heap_usage.at (n_heap);
+        }
+    }
+    else
+    {
+        for (uint32_t n_heap = 0;
+                      n_heap < static_cast<uint32_t>(m_heaps.size() );
+                    ++n_heap)
+        {
+            m_heaps.at(n_heap).budget = memory_props.heaps[n_heap].size;
+        }
+    }
+}
+
+/* Please see header for specification */
+void Anvil::MemoryBudgetTracker::refresh_budget()
+{
+    lock();
+    {
+        query_budget();
+    }
+    unlock();
+
+    update_pressure_levels(false); /* in_allow_budget_query */
+}
+
+/* Please see header for specification */
+void Anvil::MemoryBudgetTracker::set_pressure_thresholds(const std::vector<float>& in_thresholds)
+{
+    lock();
+    {
+        m_pressure_thresholds = in_thresholds;
+
+        std::sort(m_pressure_thresholds.begin(),
+                  m_pressure_thresholds.end  () );
+
+        #ifdef _DEBUG
+        {
+            for (const auto& current_threshold : m_pressure_thresholds)
+            {
+                anvil_assert(current_threshold > 0.0f &&
+                             current_threshold <= 1.0f);
+            }
+        }
+        #endif
+
+        /* Re-evaluate all heaps against the new set of thresholds */
+        for (auto& current_heap : m_heaps)
+        {
+            current_heap.n_thresholds_exceeded = 0;
+        }
+    }
+    unlock();
+
+    update_pressure_levels(false); /* in_allow_budget_query */
+}
+
+/** Determines how many pressure thresholds the estimated usage of each heap exceeds, and fires notifications
+ *  for thresholds which have been exceeded since last time.
+ *
+ *  @param in_allow_budget_query True if the budget may be re-queried from the driver to confirm that a new threshold
+ *                               has really been exceeded before firing a notification.
+ **/
+void Anvil::MemoryBudgetTracker::update_pressure_levels(bool in_allow_budget_query)
+{
+    std::vector<OnMemoryPressureThresholdCrossedCallbackArgument> pending_notifications;
+
+    lock();
+    {
+        /* The usage estimate may be stale. If any heap seems to have exceeded a new threshold, confirm with the driver
+         * before notifying anyone. */
+        if (in_allow_budget_query       &&
+            m_is_budget_query_supported)
+        {
+            for (const auto& current_heap : m_heaps)
+            {
+                if (get_n_thresholds_exceeded(get_estimated_heap_usage(current_heap),
+                                              current_heap.budget) > current_heap.n_thresholds_exceeded)
+                {
+                    query_budget();
+
+                    break;
+                }
+            }
+        }
+
+        for (uint32_t n_heap = 0;
+                      n_heap < static_cast<uint32_t>(m_heaps.size() );
+                    ++n_heap)
+        {
+            auto&              heap_data             = m_heaps.at(n_heap);
+            const VkDeviceSize usage                 = get_estimated_heap_usage (heap_data);
+            const uint32_t     n_thresholds_exceeded = get_n_thresholds_exceeded(usage,
+                                                                                 heap_data.budget);
+
+            for (uint32_t n_threshold = heap_data.n_thresholds_exceeded;
+                          n_threshold < n_thresholds_exceeded;
+                        ++n_threshold)
+            {
+                pending_notifications.push_back(
+                    OnMemoryPressureThresholdCrossedCallbackArgument(this,
+                                                                     n_heap,
+                                                                     m_pressure_thresholds.at(n_threshold),
+                                                                     usage,
+                                                                     heap_data.budget)
+                );
+            }
+
+            heap_data.n_thresholds_exceeded = n_thresholds_exceeded;
+        }
+    }
+    unlock();
+
+    /* Fire the notifications without holding the lock, so that subscribers can release memory blocks in response. */
+    for (auto& current_notification : pending_notifications)
+    {
+        callback_safe(MEMORY_BUDGET_TRACKER_CALLBACK_ID_PRESSURE_THRESHOLD_CROSSED,
+                     &current_notification);
+    }
+}
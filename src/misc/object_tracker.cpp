@@ -123,12 +123,17 @@ const char* Anvil::ObjectTracker::get_object_type_name(const Anvil::ObjectType&
         case Anvil::ObjectType::SWAPCHAIN:                  result_ptr = "Swapchain";                  break;
 
         case Anvil::ObjectType::ANVIL_COMPUTE_PIPELINE_MANAGER:       result_ptr = "Anvil Compute Pipeline Manager";      break;
+        case Anvil::ObjectType::ANVIL_DEFERRED_MEMORY_FLUSH_LIST:     result_ptr = "Anvil Deferred Memory Flush List";    break;
         case Anvil::ObjectType::ANVIL_DESCRIPTOR_SET_GROUP:           result_ptr = "Anvil Descriptor Set Group";          break;
         case Anvil::ObjectType::ANVIL_DESCRIPTOR_SET_LAYOUT_MANAGER:  result_ptr = "Anvil Descriptor Set Layout Manager"; break;
+        case Anvil::ObjectType::ANVIL_FENCE_POOL:                     result_ptr = "Anvil Fence Pool";                    break;
         case Anvil::ObjectType::ANVIL_GLSL_SHADER_TO_SPIRV_GENERATOR: result_ptr = "Anvil GLSL Shader->SPIRV Generator";  break;
+        case Anvil::ObjectType::ANVIL_GPU_PROFILER:                   result_ptr = "Anvil GPU Profiler";                  break;
         case Anvil::ObjectType::ANVIL_GRAPHICS_PIPELINE_MANAGER:      result_ptr = "Anvil Graphics Pipeline Manager";     break;
         case Anvil::ObjectType::ANVIL_MEMORY_BLOCK:                   result_ptr = "Anvil Memory Block";                  break;
+        case Anvil::ObjectType::ANVIL_MEMORY_BUDGET_TRACKER:          result_ptr = "Anvil Memory Budget Tracker";         break;
         case Anvil::ObjectType::ANVIL_PIPELINE_LAYOUT_MANAGER:        result_ptr = "Anvil Pipeline Layout Manager";       break;
+        case Anvil::ObjectType::ANVIL_SAMPLER_CACHE:                  result_ptr = "Anvil Sampler Cache";                 break;
 
         default:
         {
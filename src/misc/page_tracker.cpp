@@ -23,19 +23,19 @@
 #include "wrappers/memory_block.h"
 #include "misc/debug.h"
 #include "misc/page_tracker.h"
+#include <algorithm>
+#include <iterator>
 
 /** Please see header for specification */
 Anvil::PageTracker::PageTracker(VkDeviceSize in_region_size,
                                 VkDeviceSize in_page_size)
-    :m_n_total_pages              (static_cast<uint32_t>(in_region_size / in_page_size) ),
+    :m_n_pages_with_memory_backing(0),
+     m_n_total_pages              (static_cast<uint32_t>(Anvil::Utils::round_up(in_region_size,
+                                                                                in_page_size) / in_page_size) ),
      m_page_size                  (in_page_size),
-     m_n_pages_with_memory_backing(0),
      m_region_size                (in_region_size)
 {
-    m_sparse_page_occupancy.resize(
-        1 + m_n_total_pages / (sizeof(uint32_t) * 8 /* bits in byte */)
-    );
-
+    /* Stub */
 }
 
 /** Please see header for specification */
@@ -43,7 +43,8 @@ Anvil::MemoryBlock* Anvil::PageTracker::get_memory_block(VkDeviceSize  in_start_
                                                          VkDeviceSize  in_size,
                                                          VkDeviceSize* out_memory_region_start_offset_ptr) const
 {
-    Anvil::MemoryBlock* result_ptr = nullptr;
+    Bindings::const_iterator binding_iterator;
+    Anvil::MemoryBlock*      result_ptr       = nullptr;
 
     if (in_size > m_page_size)
     {
@@ -52,16 +53,23 @@ Anvil::MemoryBlock* Anvil::PageTracker::get_memory_block(VkDeviceSize  in_start_
         goto end;
     }
 
-    /* Handle the request */
-    for (const auto& current_memory_block : m_memory_blocks)
+    /* Find the last run which starts at or before the requested offset */
+    binding_iterator = m_bindings.upper_bound(in_start_offset);
+
+    if (binding_iterator == m_bindings.begin() )
     {
-        if (current_memory_block.start_offset                             <= in_start_offset           &&
-            current_memory_block.start_offset + current_memory_block.size >= in_start_offset + in_size)
-        {
-            result_ptr                          = current_memory_block.memory_block_ptr;
-            *out_memory_region_start_offset_ptr = in_start_offset - current_memory_block.start_offset;
+        goto end;
+    }
 
-            break;
+    --binding_iterator;
+
+    {
+        const auto& binding = binding_iterator->second;
+
+        if (binding.start_offset + binding.size >= in_start_offset + in_size)
+        {
+            result_ptr                          = binding.memory_block_ptr;
+            *out_memory_region_start_offset_ptr = binding.memory_block_start_offset + (in_start_offset - binding.start_offset);
         }
     }
 
@@ -69,23 +77,69 @@ end:
     return result_ptr;
 }
 
+/** Returns the number of pages which overlap with the region <in_start_offset, in_end_offset). @param in_start_offset
+ *  must be page-aligned.
+ **/
+uint32_t Anvil::PageTracker::get_n_pages_in_range(VkDeviceSize in_start_offset,
+                                                  VkDeviceSize in_end_offset) const
+{
+    return static_cast<uint32_t>((Anvil::Utils::round_up(in_end_offset,
+                                                         m_page_size) - in_start_offset) / m_page_size);
+}
+
+/** Merges the specified run with the runs directly preceding and following it, if these continue the same region
+ *  of the same memory block.
+ **/
+void Anvil::PageTracker::merge_with_neighbors(Bindings::iterator in_binding_iterator)
+{
+    auto next_binding_iterator = std::next(in_binding_iterator);
+
+    if (next_binding_iterator != m_bindings.end() )
+    {
+        auto&       binding      = in_binding_iterator->second;
+        const auto& next_binding = next_binding_iterator->second;
+
+        if (next_binding.memory_block_ptr          == binding.memory_block_ptr                            &&
+            next_binding.start_offset              == binding.start_offset              + binding.size    &&
+            next_binding.memory_block_start_offset == binding.memory_block_start_offset + binding.size)
+        {
+            binding.size += next_binding.size;
+
+            m_bindings.erase(next_binding_iterator);
+        }
+    }
+
+    if (in_binding_iterator != m_bindings.begin() )
+    {
+        auto        prev_binding_iterator = std::prev(in_binding_iterator);
+        auto&       prev_binding          = prev_binding_iterator->second;
+        const auto& binding               = in_binding_iterator->second;
+
+        if (prev_binding.memory_block_ptr          == binding.memory_block_ptr                                 &&
+            prev_binding.start_offset              + prev_binding.size == binding.start_offset                 &&
+            prev_binding.memory_block_start_offset + prev_binding.size == binding.memory_block_start_offset)
+        {
+            prev_binding.size += binding.size;
+
+            m_bindings.erase(in_binding_iterator);
+        }
+    }
+}
+
 /** Please see header for specification */
 bool Anvil::PageTracker::set_binding(MemoryBlock* in_memory_block_ptr,
                                      VkDeviceSize in_memory_block_start_offset,
                                      VkDeviceSize in_start_offset,
                                      VkDeviceSize in_size)
 {
-    const auto     end_offset_page_aligned    = Anvil::Utils::round_up(in_start_offset + in_size,
-                                                                       m_page_size);
-    uint32_t       n_pages;
-    uint32_t       occupancy_item_start_index;
-    const uint32_t pages_per_vec_item         = 32;
-    bool           result                     = false;
+    Bindings::iterator binding_iterator;
+    const auto         end_offset = in_start_offset + in_size;
+    bool               result     = false;
 
     /* Sanity checks */
-    if (in_start_offset + in_size > m_region_size)
+    if (end_offset > m_region_size)
     {
-        anvil_assert(!(in_start_offset + in_size > m_region_size) );
+        anvil_assert(!(end_offset > m_region_size) );
 
         goto end;
     }
@@ -97,140 +151,88 @@ bool Anvil::PageTracker::set_binding(MemoryBlock* in_memory_block_ptr,
         goto end;
     }
 
-    if (((in_start_offset + in_size) % m_page_size) != 0              &&
-        end_offset_page_aligned                     != m_region_size)
+    /* The region may only end mid-page if it extends up to the end of the tracked region */
+    if ((end_offset % m_page_size) != 0 &&
+        end_offset                 != m_region_size)
     {
-        anvil_assert(!((in_start_offset + in_size) % m_page_size) != 0              &&
-                       end_offset_page_aligned                    != m_region_size);
+        anvil_assert(!((end_offset % m_page_size) != 0 &&
+                        end_offset                 != m_region_size) );
 
         goto end;
     }
 
-    /* Store the memory block binding */
-    for (auto mem_binding_iterator  = m_memory_blocks.begin();
-              mem_binding_iterator != m_memory_blocks.end();
-            ++mem_binding_iterator)
+    if (in_size == 0)
     {
-        auto& mem_binding = *mem_binding_iterator;
-
-        const bool does_not_overlap = (in_start_offset + in_size -1                    < mem_binding.start_offset || /* XXYY , X = new binding, Y = this binding */
-                                       mem_binding.start_offset + mem_binding.size - 1 < in_start_offset);           /* YYXX */
-
-        if (does_not_overlap)
-        {
-            continue;
-        }
+        result = true;
 
-        /* There are four cases we need to handle separately :
-         *
-         * 1)  ###      - The new block _ interleaves with current memory block # from the left side.
-         *    __          Need to truncate # from the left side.
-         *
-         * 2)  ###      - The new block _ splits current memory block # in half.
-         *      _         Need to split # to two separate memory blocks.
-         *
-         * 3)  ###      - The new block _ interleaves with current memory block # from the right side.
-         *       __       Need to truncate # from the right side.
-         *
-         * 4)  ###      - The new block _ is going to be completely overwritten by _
-         *    _____       Need to remove it.
-         */
-        if ( in_start_offset            <=  mem_binding.start_offset                     &&
-             in_start_offset            <  (mem_binding.start_offset + mem_binding.size) &&
-            (in_start_offset + in_size) >=  mem_binding.start_offset                     &&
-            (in_start_offset + in_size) <  (mem_binding.start_offset + mem_binding.size) )
-        {
-            /* Case 1 */
-            mem_binding.size         -= in_start_offset + in_size - (mem_binding.start_offset);
-            mem_binding.start_offset  = in_start_offset + in_size;
-        }
-        else
-        if ( in_start_offset            >  mem_binding.start_offset                     &&
-             in_start_offset            < (mem_binding.start_offset + mem_binding.size) &&
-            (in_start_offset + in_size) >  mem_binding.start_offset                     &&
-            (in_start_offset + in_size) < (mem_binding.start_offset + mem_binding.size))
-        {
-            /* Case 2 */
-            MemoryBlockBinding left_half (mem_binding.memory_block_ptr,
-                                          mem_binding.memory_block_start_offset,
-                                          in_start_offset - mem_binding.start_offset, /* in_size         */
-                                          mem_binding.start_offset);                  /* in_start_offset */
-            MemoryBlockBinding right_half(mem_binding.memory_block_ptr,
-                                          mem_binding.memory_block_start_offset,
-                                          mem_binding.start_offset + mem_binding.size - (in_start_offset + in_size) + 1, /* in_size         */
-                                          in_start_offset + in_size);                                                    /* in_start_offset */
-
-            m_memory_blocks.push_back(left_half);
-            m_memory_blocks.push_back(right_half);
-
-            m_memory_blocks.erase(mem_binding_iterator);
-        }
-        else
-        if ( in_start_offset            >  mem_binding.start_offset                     &&
-             in_start_offset            > (mem_binding.start_offset + mem_binding.size) &&
-            (in_start_offset + in_size) >  mem_binding.start_offset                     &&
-            (in_start_offset + in_size) > (mem_binding.start_offset + mem_binding.size) )
-        {
-            /* Case 3 */
-            mem_binding.size = (mem_binding.start_offset + mem_binding.size) - in_start_offset + 1;
-        }
-        else
-        {
-            /* Must be case 4 */
-            anvil_assert( in_start_offset            <=  mem_binding.start_offset                     &&
-                         (in_start_offset + in_size) >= (mem_binding.start_offset + mem_binding.size) );
+        goto end;
+    }
 
-            m_memory_blocks.erase(mem_binding_iterator);
-        }
+    /* Carve the region out of existing runs. Only the run starting before the region can stick out on the left,
+     * and only the last run overlapping with the region can stick out on the right. */
+    binding_iterator = m_bindings.upper_bound(in_start_offset);
 
-        /* No more than one memory binding can be assigned to the same memory region */
-        break;
+    if (binding_iterator                                                  != m_bindings.begin() &&
+        std::prev(binding_iterator)->second.start_offset + std::prev(binding_iterator)->second.size > in_start_offset)
+    {
+        --binding_iterator;
     }
 
-    m_memory_blocks.push_back(
-        MemoryBlockBinding(
-            in_memory_block_ptr,
-            in_memory_block_start_offset,
-            in_size,
-            in_start_offset)
-        );
-
-    /* Update page occupancy info */
-    n_pages                    = static_cast<uint32_t>(in_size         / m_page_size);
-    occupancy_item_start_index = static_cast<uint32_t>(in_start_offset / m_page_size);
-
-    /* TODO: Perf of the code below could definitely be improved */
-    for (uint32_t n_page = 0;
-                  n_page < n_pages;
-                ++n_page)
+    while (binding_iterator                      != m_bindings.end() &&
+           binding_iterator->second.start_offset <  end_offset)
     {
-        const uint32_t occupancy_item_index = (occupancy_item_start_index + n_page) % pages_per_vec_item;
-        const uint32_t occupancy_vec_index  = (occupancy_item_start_index + n_page) / pages_per_vec_item;
-        const uint32_t n_page_mask          = m_sparse_page_occupancy[occupancy_vec_index].raw & (1 << occupancy_item_index);
+        const MemoryBlockBinding binding            = binding_iterator->second;
+        const VkDeviceSize       binding_end_offset = binding.start_offset + binding.size;
 
-        /* Change the number of memory-backed pages only if a bit would be flipped */
-        if (in_memory_block_ptr != nullptr)
-        {
-            if (n_page_mask == 0)
-            {
-                m_sparse_page_occupancy[occupancy_vec_index].raw |= (1 << occupancy_item_index);
+        m_n_pages_with_memory_backing -= get_n_pages_in_range(std::max(binding.start_offset, in_start_offset),
+                                                              std::min(binding_end_offset,   end_offset) );
+
+        binding_iterator = m_bindings.erase(binding_iterator);
 
-                ++m_n_pages_with_memory_backing;
-            }
+        if (binding.start_offset < in_start_offset)
+        {
+            m_bindings.insert(
+                std::make_pair(binding.start_offset,
+                               MemoryBlockBinding(binding.memory_block_ptr,
+                                                  binding.memory_block_start_offset,
+                                                  in_start_offset - binding.start_offset, /* in_size         */
+                                                  binding.start_offset) )                 /* in_start_offset */
+            );
         }
-        else
+
+        if (binding_end_offset > end_offset)
         {
-            if (n_page_mask != 0)
-            {
-                m_sparse_page_occupancy[occupancy_vec_index].raw &= ~(1 << occupancy_item_index);
+            binding_iterator = m_bindings.insert(
+                std::make_pair(end_offset,
+                               MemoryBlockBinding(binding.memory_block_ptr,
+                                                  binding.memory_block_start_offset + (end_offset - binding.start_offset),
+                                                  binding_end_offset - end_offset, /* in_size         */
+                                                  end_offset) )                    /* in_start_offset */
+            ).first;
 
-                --m_n_pages_with_memory_backing;
-            }
+            break;
         }
     }
 
+    /* Store the new run. Unbound regions are not stored. */
+    if (in_memory_block_ptr != nullptr)
+    {
+        binding_iterator = m_bindings.insert(
+            std::make_pair(in_start_offset,
+                           MemoryBlockBinding(in_memory_block_ptr,
+                                              in_memory_block_start_offset,
+                                              in_size,
+                                              in_start_offset) )
+        ).first;
+
+        m_n_pages_with_memory_backing += get_n_pages_in_range(in_start_offset,
+                                                              end_offset);
+
+        merge_with_neighbors(binding_iterator);
+    }
+
     anvil_assert(m_n_pages_with_memory_backing <= m_n_total_pages);
     result = true;
 end:
     return result;
-}
\ No newline at end of file
+}
@@ -0,0 +1,376 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/pipeline_barrier_batch.h"
+
+
+/** Tells whether two ranges, described by start and length, overlap. @param in_all_value is used to indicate
+ *  the range spans till the end of the resource (eg. VK_WHOLE_SIZE).
+ **/
+template<typename Type>
+static bool do_ranges_overlap(Type in_range1_start,
+                              Type in_range1_size,
+                              Type in_range2_start,
+                              Type in_range2_size,
+                              Type in_all_value)
+{
+    const bool is_range1_unbounded = (in_range1_size == in_all_value);
+    const bool is_range2_unbounded = (in_range2_size == in_all_value);
+
+    return (is_range2_unbounded || in_range1_start < in_range2_start + in_range2_size) &&
+           (is_range1_unbounded || in_range2_start < in_range1_start + in_range1_size);
+}
+
+/** Tells whether the barrier neither transfers queue family ownership, nor defines a memory dependency. */
+static bool is_buffer_barrier_noop(const VkBufferMemoryBarrier& in_barrier)
+{
+    return (in_barrier.srcAccessMask       == 0                                 &&
+            in_barrier.dstAccessMask       == 0                                 &&
+            in_barrier.srcQueueFamilyIndex == in_barrier.dstQueueFamilyIndex);
+}
+
+/** Tells whether the barrier neither transitions image layout, nor transfers queue family ownership, nor defines
+ *  a memory dependency.
+ **/
+static bool is_image_barrier_noop(const VkImageMemoryBarrier& in_barrier)
+{
+    return (in_barrier.srcAccessMask       == 0                                 &&
+            in_barrier.dstAccessMask       == 0                                 &&
+            in_barrier.oldLayout           == in_barrier.newLayout              &&
+            in_barrier.srcQueueFamilyIndex == in_barrier.dstQueueFamilyIndex);
+}
+
+static bool are_buffer_barriers_equal(const VkBufferMemoryBarrier& in_barrier1,
+                                      const VkBufferMemoryBarrier& in_barrier2)
+{
+    return (in_barrier1.pNext               == nullptr                         &&
+            in_barrier2.pNext               == nullptr                         &&
+            in_barrier1.srcAccessMask       == in_barrier2.srcAccessMask       &&
+            in_barrier1.dstAccessMask       == in_barrier2.dstAccessMask       &&
+            in_barrier1.srcQueueFamilyIndex == in_barrier2.srcQueueFamilyIndex &&
+            in_barrier1.dstQueueFamilyIndex == in_barrier2.dstQueueFamilyIndex &&
+            in_barrier1.buffer              == in_barrier2.buffer              &&
+            in_barrier1.offset              == in_barrier2.offset              &&
+            in_barrier1.size                == in_barrier2.size);
+}
+
+static bool are_image_barriers_equal(const VkImageMemoryBarrier& in_barrier1,
+                                     const VkImageMemoryBarrier& in_barrier2)
+{
+    return (in_barrier1.pNext                           == nullptr                                     &&
+            in_barrier2.pNext                           == nullptr                                     &&
+            in_barrier1.srcAccessMask                   == in_barrier2.srcAccessMask                   &&
+            in_barrier1.dstAccessMask                   == in_barrier2.dstAccessMask                   &&
+            in_barrier1.oldLayout                       == in_barrier2.oldLayout                       &&
+            in_barrier1.newLayout                       == in_barrier2.newLayout                       &&
+            in_barrier1.srcQueueFamilyIndex             == in_barrier2.srcQueueFamilyIndex             &&
+            in_barrier1.dstQueueFamilyIndex             == in_barrier2.dstQueueFamilyIndex             &&
+            in_barrier1.image                           == in_barrier2.image                           &&
+            in_barrier1.subresourceRange.aspectMask     == in_barrier2.subresourceRange.aspectMask     &&
+            in_barrier1.subresourceRange.baseMipLevel   == in_barrier2.subresourceRange.baseMipLevel   &&
+            in_barrier1.subresourceRange.levelCount     == in_barrier2.subresourceRange.levelCount     &&
+            in_barrier1.subresourceRange.baseArrayLayer == in_barrier2.subresourceRange.baseArrayLayer &&
+            in_barrier1.subresourceRange.layerCount     == in_barrier2.subresourceRange.layerCount);
+}
+
+static bool do_buffer_barriers_overlap(const VkBufferMemoryBarrier& in_barrier1,
+                                       const VkBufferMemoryBarrier& in_barrier2)
+{
+    return (in_barrier1.buffer == in_barrier2.buffer) &&
+           do_ranges_overlap<VkDeviceSize>(in_barrier1.offset,
+                                           in_barrier1.size,
+                                           in_barrier2.offset,
+                                           in_barrier2.size,
+                                           VK_WHOLE_SIZE);
+}
+
+static bool do_image_barriers_overlap(const VkImageMemoryBarrier& in_barrier1,
+                                      const VkImageMemoryBarrier& in_barrier2)
+{
+    const VkImageSubresourceRange& range1 = in_barrier1.subresourceRange;
+    const VkImageSubresourceRange& range2 = in_barrier2.subresourceRange;
+
+    return (in_barrier1.image == in_barrier2.image)                      &&
+           ((range1.aspectMask & range2.aspectMask) != 0)                &&
+           do_ranges_overlap<uint32_t>(range1.baseMipLevel,
+                                       range1.levelCount,
+                                       range2.baseMipLevel,
+                                       range2.levelCount,
+                                       VK_REMAINING_MIP_LEVELS)          &&
+           do_ranges_overlap<uint32_t>(range1.baseArrayLayer,
+                                       range1.layerCount,
+                                       range2.baseArrayLayer,
+                                       range2.layerCount,
+                                       VK_REMAINING_ARRAY_LAYERS);
+}
+
+
+/** Constructor. */
+Anvil::PipelineBarrierBatch::PipelineBarrierBatch()
+    :m_n_dropped_barriers(0),
+     m_n_merged_commands (0),
+     m_n_pending_commands(0)
+{
+    /* Stub */
+}
+
+/** Destructor */
+Anvil::PipelineBarrierBatch::~PipelineBarrierBatch()
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+bool Anvil::PipelineBarrierBatch::add(Anvil::PipelineStageFlags    in_src_stage_mask,
+                                      Anvil::PipelineStageFlags    in_dst_stage_mask,
+                                      Anvil::DependencyFlags       in_dependency_flags,
+                                      uint32_t                     in_memory_barrier_count,
+                                      const VkMemoryBarrier*       in_memory_barriers_ptr,
+                                      uint32_t                     in_buffer_memory_barrier_count,
+                                      const VkBufferMemoryBarrier* in_buffer_memory_barriers_ptr,
+                                      uint32_t                     in_image_memory_barrier_count,
+                                      const VkImageMemoryBarrier*  in_image_memory_barriers_ptr)
+{
+    bool result = false;
+
+    if (m_n_pending_commands > 0)
+    {
+        if (m_dependency_flags != in_dependency_flags)
+        {
+            goto end;
+        }
+
+        if (depends_on_pending_barriers(in_buffer_memory_barrier_count,
+                                        in_buffer_memory_barriers_ptr,
+                                        in_image_memory_barrier_count,
+                                        in_image_memory_barriers_ptr) )
+        {
+            goto end;
+        }
+
+        ++m_n_merged_commands;
+    }
+    else
+    {
+        m_dependency_flags = in_dependency_flags;
+    }
+
+    for (uint32_t n_memory_barrier = 0;
+                  n_memory_barrier < in_memory_barrier_count;
+                ++n_memory_barrier)
+    {
+        const auto& barrier = in_memory_barriers_ptr[n_memory_barrier];
+
+        if (barrier.srcAccessMask == 0 &&
+            barrier.dstAccessMask == 0)
+        {
+            ++m_n_dropped_barriers;
+
+            continue;
+        }
+
+        m_memory_barriers.push_back(barrier);
+    }
+
+    for (uint32_t n_buffer_barrier = 0;
+                  n_buffer_barrier < in_buffer_memory_barrier_count;
+                ++n_buffer_barrier)
+    {
+        const auto& barrier = in_buffer_memory_barriers_ptr[n_buffer_barrier];
+
+        if (is_buffer_barrier_noop(barrier) ||
+            is_pending            (barrier) )
+        {
+            ++m_n_dropped_barriers;
+
+            continue;
+        }
+
+        m_buffer_memory_barriers.push_back(barrier);
+        m_pending_buffers.insert          (barrier.buffer);
+    }
+
+    for (uint32_t n_image_barrier = 0;
+                  n_image_barrier < in_image_memory_barrier_count;
+                ++n_image_barrier)
+    {
+        const auto& barrier = in_image_memory_barriers_ptr[n_image_barrier];
+
+        if (is_image_barrier_noop(barrier) ||
+            is_pending           (barrier) )
+        {
+            ++m_n_dropped_barriers;
+
+            continue;
+        }
+
+        m_image_memory_barriers.push_back(barrier);
+        m_pending_images.insert          (barrier.image);
+    }
+
+    m_dst_stage_mask |= in_dst_stage_mask;
+    m_src_stage_mask |= in_src_stage_mask;
+
+    ++m_n_pending_commands;
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::PipelineBarrierBatch::clear()
+{
+    m_buffer_memory_barriers.clear();
+    m_image_memory_barriers.clear ();
+    m_memory_barriers.clear       ();
+    m_pending_buffers.clear       ();
+    m_pending_images.clear        ();
+
+    m_dependency_flags   = Anvil::DependencyFlags   ();
+    m_dst_stage_mask     = Anvil::PipelineStageFlags();
+    m_n_pending_commands = 0;
+    m_src_stage_mask     = Anvil::PipelineStageFlags();
+}
+
+/* Please see header for specification */
+Anvil::PipelineBarrierBatchUniquePtr Anvil::PipelineBarrierBatch::create()
+{
+    return Anvil::PipelineBarrierBatchUniquePtr(new PipelineBarrierBatch(),
+                                                std::default_delete<PipelineBarrierBatch>() );
+}
+
+/** Tells whether any of the specified barriers refers to a range, which one of the pending barriers also refers to.
+ *  No-op barriers and barriers identical to a pending barrier are not considered dependent, since they are dropped
+ *  at add() time.
+ **/
+bool Anvil::PipelineBarrierBatch::depends_on_pending_barriers(uint32_t                     in_buffer_memory_barrier_count,
+                                                              const VkBufferMemoryBarrier* in_buffer_memory_barriers_ptr,
+                                                              uint32_t                     in_image_memory_barrier_count,
+                                                              const VkImageMemoryBarrier*  in_image_memory_barriers_ptr) const
+{
+    bool result = false;
+
+    for (uint32_t n_buffer_barrier = 0;
+                  n_buffer_barrier < in_buffer_memory_barrier_count && !result;
+                ++n_buffer_barrier)
+    {
+        const auto& barrier = in_buffer_memory_barriers_ptr[n_buffer_barrier];
+
+        if (is_buffer_barrier_noop(barrier)                                   ||
+            m_pending_buffers.find(barrier.buffer) == m_pending_buffers.end() )
+        {
+            continue;
+        }
+
+        for (const auto& pending_barrier : m_buffer_memory_barriers)
+        {
+            if (!are_buffer_barriers_equal (barrier, pending_barrier) &&
+                 do_buffer_barriers_overlap(barrier, pending_barrier) )
+            {
+                result = true;
+
+                break;
+            }
+        }
+    }
+
+    for (uint32_t n_image_barrier = 0;
+                  n_image_barrier < in_image_memory_barrier_count && !result;
+                ++n_image_barrier)
+    {
+        const auto& barrier = in_image_memory_barriers_ptr[n_image_barrier];
+
+        if (is_image_barrier_noop(barrier)                                 ||
+            m_pending_images.find(barrier.image) == m_pending_images.end() )
+        {
+            continue;
+        }
+
+        for (const auto& pending_barrier : m_image_memory_barriers)
+        {
+            if (!are_image_barriers_equal (barrier, pending_barrier) &&
+                 do_image_barriers_overlap(barrier, pending_barrier) )
+            {
+                result = true;
+
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/** Tells whether a barrier identical to @param in_barrier has already been added to the batch. */
+bool Anvil::PipelineBarrierBatch::is_pending(const VkBufferMemoryBarrier& in_barrier) const
+{
+    bool result = false;
+
+    if (m_pending_buffers.find(in_barrier.buffer) != m_pending_buffers.end() )
+    {
+        for (const auto& pending_barrier : m_buffer_memory_barriers)
+        {
+            if (are_buffer_barriers_equal(in_barrier,
+                                          pending_barrier) )
+            {
+                result = true;
+
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/** Tells whether a barrier identical to @param in_barrier has already been added to the batch. */
+bool Anvil::PipelineBarrierBatch::is_pending(const VkImageMemoryBarrier& in_barrier) const
+{
+    bool result = false;
+
+    if (m_pending_images.find(in_barrier.image) != m_pending_images.end() )
+    {
+        for (const auto& pending_barrier : m_image_memory_barriers)
+        {
+            if (are_image_barriers_equal(in_barrier,
+                                         pending_barrier) )
+            {
+                result = true;
+
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::PipelineBarrierBatch::reset()
+{
+    clear();
+
+    m_n_dropped_barriers = 0;
+    m_n_merged_commands  = 0;
+}
@@ -0,0 +1,383 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/redundant_state_filter.h"
+#include <cstring>
+
+
+/** Constructor. */
+Anvil::RedundantStateFilter::RedundantStateFilter()
+    :m_n_elided_commands(0)
+{
+    invalidate();
+}
+
+/** Destructor */
+Anvil::RedundantStateFilter::~RedundantStateFilter()
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::RedundantStateFilterUniquePtr Anvil::RedundantStateFilter::create()
+{
+    return Anvil::RedundantStateFilterUniquePtr(new RedundantStateFilter(),
+                                                std::default_delete<RedundantStateFilter>() );
+}
+
+/* Please see header for specification */
+bool Anvil::RedundantStateFilter::filter_bind_descriptor_sets(Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                                              VkPipelineLayout         in_layout,
+                                                              uint32_t                 in_first_set,
+                                                              uint32_t                 in_set_count,
+                                                              const VkDescriptorSet*   in_descriptor_sets_ptr,
+                                                              uint32_t                 in_dynamic_offset_count,
+                                                              const uint32_t*          in_dynamic_offsets_ptr)
+{
+    const uint32_t         n_bind_point = static_cast<uint32_t>(in_pipeline_bind_point);
+    DescriptorSetBindings* bindings_ptr = nullptr;
+    bool                   result       = true;
+
+    if (n_bind_point >= N_SHADOWED_BIND_POINTS)
+    {
+        result = false;
+
+        goto end;
+    }
+
+    bindings_ptr = &m_descriptor_set_bindings[n_bind_point];
+
+    if (bindings_ptr->layout != in_layout)
+    {
+        bindings_ptr->reset();
+
+        bindings_ptr->layout = in_layout;
+        result               = false;
+    }
+
+    if (bindings_ptr->sets.size() < in_first_set + in_set_count)
+    {
+        bindings_ptr->sets.resize(in_first_set + in_set_count,
+                                  VK_NULL_HANDLE);
+    }
+
+    for (uint32_t n_set = 0;
+                  n_set < in_set_count;
+                ++n_set)
+    {
+        auto& current_set = bindings_ptr->sets.at(in_first_set + n_set);
+
+        if (current_set                   != in_descriptor_sets_ptr[n_set] ||
+            in_descriptor_sets_ptr[n_set] == VK_NULL_HANDLE)
+        {
+            current_set = in_descriptor_sets_ptr[n_set];
+            result      = false;
+        }
+    }
+
+    /* Dynamic offsets cannot be attributed to individual sets without inspecting their layouts. Only consider
+     * the command redundant if it re-binds the same range of sets, with the same offsets, as the last command
+     * which specified dynamic offsets.
+     */
+    if (in_dynamic_offset_count > 0)
+    {
+        if (bindings_ptr->dynamic_offsets_first_set != in_first_set                ||
+            bindings_ptr->dynamic_offsets_n_sets    != in_set_count                ||
+            bindings_ptr->dynamic_offsets.size()    != in_dynamic_offset_count     ||
+            memcmp(&bindings_ptr->dynamic_offsets.at(0),
+                   in_dynamic_offsets_ptr,
+                   sizeof(uint32_t) * in_dynamic_offset_count) != 0)
+        {
+            bindings_ptr->dynamic_offsets.assign(in_dynamic_offsets_ptr,
+                                                 in_dynamic_offsets_ptr + in_dynamic_offset_count);
+
+            bindings_ptr->dynamic_offsets_first_set = in_first_set;
+            bindings_ptr->dynamic_offsets_n_sets    = in_set_count;
+            result                                  = false;
+        }
+    }
+
+    if (result)
+    {
+        ++m_n_elided_commands;
+    }
+
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RedundantStateFilter::filter_bind_pipeline(Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                                       VkPipeline               in_pipeline)
+{
+    const uint32_t n_bind_point = static_cast<uint32_t>(in_pipeline_bind_point);
+    bool           result       = false;
+
+    if (n_bind_point >= N_SHADOWED_BIND_POINTS)
+    {
+        goto end;
+    }
+
+    if (m_pipelines[n_bind_point] == in_pipeline &&
+        in_pipeline               != VK_NULL_HANDLE)
+    {
+        ++m_n_elided_commands;
+
+        result = true;
+        goto end;
+    }
+
+    m_pipelines[n_bind_point] = in_pipeline;
+
+    if (in_pipeline_bind_point == Anvil::PipelineBindPoint::GRAPHICS)
+    {
+        /* Viewports and scissors are overwritten by graphics pipelines which do not declare them as dynamic. */
+        m_scissors_set.assign (m_scissors_set.size(),
+                               false);
+        m_viewports_set.assign(m_viewports_set.size(),
+                               false);
+    }
+
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RedundantStateFilter::filter_bind_vertex_buffers(uint32_t            in_first_binding,
+                                                             uint32_t            in_binding_count,
+                                                             const VkBuffer*     in_buffers_ptr,
+                                                             const VkDeviceSize* in_offsets_ptr)
+{
+    bool result = true;
+
+    if (m_vertex_buffer_bindings.size() < in_first_binding + in_binding_count)
+    {
+        const VertexBufferBinding unknown_binding = {VK_NULL_HANDLE, 0};
+
+        m_vertex_buffer_bindings.resize(in_first_binding + in_binding_count,
+                                        unknown_binding);
+    }
+
+    for (uint32_t n_binding = 0;
+                  n_binding < in_binding_count;
+                ++n_binding)
+    {
+        auto& current_binding = m_vertex_buffer_bindings.at(in_first_binding + n_binding);
+
+        if (current_binding.buffer != in_buffers_ptr[n_binding] ||
+            current_binding.offset != in_offsets_ptr[n_binding] ||
+            in_buffers_ptr[n_binding] == VK_NULL_HANDLE)
+        {
+            current_binding.buffer = in_buffers_ptr[n_binding];
+            current_binding.offset = in_offsets_ptr[n_binding];
+            result                 = false;
+        }
+    }
+
+    if (result)
+    {
+        ++m_n_elided_commands;
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RedundantStateFilter::filter_push_constants(VkPipelineLayout        in_layout,
+                                                        Anvil::ShaderStageFlags in_stage_flags,
+                                                        uint32_t                in_offset,
+                                                        uint32_t                in_size,
+                                                        const void*             in_values_ptr)
+{
+    const VkShaderStageFlags stage_flags_vk = in_stage_flags.get_vk();
+    bool                     result         = ((stage_flags_vk & ~((1u << N_SHADOWED_SHADER_STAGES) - 1)) == 0);
+    const uint8_t*           values_ptr     = static_cast<const uint8_t*>(in_values_ptr);
+
+    if (m_push_constant_layout != in_layout)
+    {
+        for (uint32_t n_stage = 0;
+                      n_stage < N_SHADOWED_SHADER_STAGES;
+                    ++n_stage)
+        {
+            m_push_constant_values_set[n_stage].assign(m_push_constant_values_set[n_stage].size(),
+                                                       false);
+        }
+
+        m_push_constant_layout = in_layout;
+        result                 = false;
+    }
+
+    for (uint32_t n_stage = 0;
+                  n_stage < N_SHADOWED_SHADER_STAGES;
+                ++n_stage)
+    {
+        auto& stage_values     = m_push_constant_values    [n_stage];
+        auto& stage_values_set = m_push_constant_values_set[n_stage];
+
+        if ((stage_flags_vk & (1u << n_stage)) == 0)
+        {
+            continue;
+        }
+
+        if (stage_values.size() < in_offset + in_size)
+        {
+            stage_values.resize    (in_offset + in_size,
+                                    0);
+            stage_values_set.resize(in_offset + in_size,
+                                    false);
+        }
+
+        for (uint32_t n_byte = 0;
+                      n_byte < in_size;
+                    ++n_byte)
+        {
+            if (!stage_values_set.at(in_offset + n_byte)                      ||
+                 stage_values.at    (in_offset + n_byte) != values_ptr[n_byte])
+            {
+                stage_values.at    (in_offset + n_byte) = values_ptr[n_byte];
+                stage_values_set.at(in_offset + n_byte) = true;
+                result                                  = false;
+            }
+        }
+    }
+
+    if (result)
+    {
+        ++m_n_elided_commands;
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RedundantStateFilter::filter_set_scissor(uint32_t        in_first_scissor,
+                                                     uint32_t        in_scissor_count,
+                                                     const VkRect2D* in_scissors_ptr)
+{
+    bool result = true;
+
+    if (m_scissors.size() < in_first_scissor + in_scissor_count)
+    {
+        m_scissors.resize    (in_first_scissor + in_scissor_count);
+        m_scissors_set.resize(in_first_scissor + in_scissor_count,
+                              false);
+    }
+
+    for (uint32_t n_scissor = 0;
+                  n_scissor < in_scissor_count;
+                ++n_scissor)
+    {
+        if (!m_scissors_set.at(in_first_scissor + n_scissor)       ||
+             memcmp(&m_scissors.at(in_first_scissor + n_scissor),
+                    in_scissors_ptr + n_scissor,
+                    sizeof(VkRect2D) ) != 0)
+        {
+            m_scissors.at    (in_first_scissor + n_scissor) = in_scissors_ptr[n_scissor];
+            m_scissors_set.at(in_first_scissor + n_scissor) = true;
+            result                                          = false;
+        }
+    }
+
+    if (result)
+    {
+        ++m_n_elided_commands;
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RedundantStateFilter::filter_set_viewport(uint32_t          in_first_viewport,
+                                                      uint32_t          in_viewport_count,
+                                                      const VkViewport* in_viewports_ptr)
+{
+    bool result = true;
+
+    if (m_viewports.size() < in_first_viewport + in_viewport_count)
+    {
+        m_viewports.resize    (in_first_viewport + in_viewport_count);
+        m_viewports_set.resize(in_first_viewport + in_viewport_count,
+                               false);
+    }
+
+    for (uint32_t n_viewport = 0;
+                  n_viewport < in_viewport_count;
+                ++n_viewport)
+    {
+        /* NOTE: Bitwise comparison may report -0.0f and 0.0f as different values. This only makes the filter more conservative. */
+        if (!m_viewports_set.at(in_first_viewport + n_viewport)       ||
+             memcmp(&m_viewports.at(in_first_viewport + n_viewport),
+                    in_viewports_ptr + n_viewport,
+                    sizeof(VkViewport) ) != 0)
+        {
+            m_viewports.at    (in_first_viewport + n_viewport) = in_viewports_ptr[n_viewport];
+            m_viewports_set.at(in_first_viewport + n_viewport) = true;
+            result                                             = false;
+        }
+    }
+
+    if (result)
+    {
+        ++m_n_elided_commands;
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::RedundantStateFilter::invalidate()
+{
+    for (uint32_t n_bind_point = 0;
+                  n_bind_point < N_SHADOWED_BIND_POINTS;
+                ++n_bind_point)
+    {
+        m_descriptor_set_bindings[n_bind_point].reset();
+
+        m_pipelines[n_bind_point] = VK_NULL_HANDLE;
+    }
+
+    for (uint32_t n_stage = 0;
+                  n_stage < N_SHADOWED_SHADER_STAGES;
+                ++n_stage)
+    {
+        m_push_constant_values_set[n_stage].assign(m_push_constant_values_set[n_stage].size(),
+                                                   false);
+    }
+
+    m_push_constant_layout = VK_NULL_HANDLE;
+
+    m_scissors_set.assign (m_scissors_set.size(),
+                           false);
+    m_viewports_set.assign(m_viewports_set.size(),
+                           false);
+
+    m_vertex_buffer_bindings.clear();
+}
+
+/* Please see header for specification */
+void Anvil::RedundantStateFilter::reset()
+{
+    invalidate();
+
+    m_n_elided_commands = 0;
+}
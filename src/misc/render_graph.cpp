@@ -0,0 +1,2230 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/buffer_create_info.h"
+#include "misc/debug.h"
+#include "misc/formats.h"
+#include "misc/framebuffer_create_info.h"
+#include "misc/image_create_info.h"
+#include "misc/image_view_create_info.h"
+#include "misc/memory_block_create_info.h"
+#include "misc/render_graph.h"
+#include "misc/render_pass_create_info.h"
+#include "misc/resource_state_tracker.h"
+#include "wrappers/buffer.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
+#include "wrappers/device.h"
+#include "wrappers/framebuffer.h"
+#include "wrappers/image.h"
+#include "wrappers/image_view.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/render_pass.h"
+#include <algorithm>
+
+
+/* Access types which modify the contents of a resource. */
+static const Anvil::AccessFlags g_write_access_mask = Anvil::AccessFlagBits::COLOR_ATTACHMENT_WRITE_BIT               |
+                                                      Anvil::AccessFlagBits::DEPTH_STENCIL_ATTACHMENT_WRITE_BIT       |
+                                                      Anvil::AccessFlagBits::HOST_WRITE_BIT                           |
+                                                      Anvil::AccessFlagBits::MEMORY_WRITE_BIT                         |
+                                                      Anvil::AccessFlagBits::SHADER_WRITE_BIT                         |
+                                                      Anvil::AccessFlagBits::TRANSFER_WRITE_BIT                       |
+                                                      Anvil::AccessFlagBits::TRANSFORM_FEEDBACK_COUNTER_WRITE_BIT_EXT |
+                                                      Anvil::AccessFlagBits::TRANSFORM_FEEDBACK_WRITE_BIT_EXT;
+
+
+/** Returns aspects of the specified format. */
+static Anvil::ImageAspectFlags get_aspects(Anvil::Format in_format)
+{
+    Anvil::ImageAspectFlags result;
+
+    if (Anvil::Formats::has_depth_aspect(in_format) )
+    {
+        result |= Anvil::ImageAspectFlagBits::DEPTH_BIT;
+    }
+
+    if (Anvil::Formats::has_stencil_aspect(in_format) )
+    {
+        result |= Anvil::ImageAspectFlagBits::STENCIL_BIT;
+    }
+
+    if (result == 0)
+    {
+        result = Anvil::ImageAspectFlagBits::COLOR_BIT;
+    }
+
+    return result;
+}
+
+/** Constructor. */
+Anvil::RenderGraph::Access::Access()
+    :layout      (Anvil::ImageLayout::UNDEFINED),
+     resource_id (UINT32_MAX),
+     should_clear(false),
+     type        (AccessType::BUFFER)
+{
+    memset(&clear_value,
+           0,
+           sizeof(clear_value) );
+}
+
+/** Constructor. */
+Anvil::RenderGraph::Pass::Pass()
+    :is_alive    (false),
+     n_step      (UINT32_MAX),
+     sample_count(Anvil::SampleCountFlagBits::_1_BIT),
+     subpass_id  (UINT32_MAX)
+{
+    extent.height = 0;
+    extent.width  = 0;
+}
+
+/** Constructor. */
+Anvil::RenderGraph::Resource::Resource()
+    :buffer_ptr  (nullptr),
+     image_ptr   (nullptr),
+     is_image    (false),
+     is_imported (false),
+     is_output   (false),
+     format      (Anvil::Format::UNKNOWN),
+     height      (0),
+     sample_count(Anvil::SampleCountFlagBits::_1_BIT),
+     size        (0),
+     width       (0),
+     first_step  (UINT32_MAX),
+     heap_offset (0),
+     last_step   (0),
+     n_heap      (UINT32_MAX),
+     is_used     (false)
+{
+    /* Stub */
+}
+
+/** Constructor. Please see create() for specification */
+Anvil::RenderGraph::RenderGraph(Anvil::BaseDevice* in_device_ptr,
+                                uint32_t           in_queue_family_index,
+                                uint32_t           in_n_frames_in_flight,
+                                uint32_t           in_n_recording_threads)
+    :m_device_ptr         (in_device_ptr),
+     m_is_baked           (false),
+     m_n_culled_passes    (0),
+     m_n_current_frame    (0),
+     m_n_frames_in_flight (in_n_frames_in_flight),
+     m_n_recording_threads(in_n_recording_threads),
+     m_n_render_passes    (0),
+     m_queue_family_index (in_queue_family_index),
+     m_jobs_generation    (0),
+     m_n_next_job         (0),
+     m_n_busy_workers     (0),
+     m_workers_should_quit(false)
+{
+    m_transient_state_tracker_ptr = Anvil::ResourceStateTracker::create();
+}
+
+/** Destructor */
+Anvil::RenderGraph::~RenderGraph()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_jobs_mutex);
+
+        m_workers_should_quit = true;
+    }
+
+    m_jobs_cv.notify_all();
+
+    for (auto& current_thread : m_worker_threads)
+    {
+        current_thread.join();
+    }
+
+    /* Release objects before objects they refer to */
+    m_steps.clear                ();
+    m_image_views.clear          ();
+    m_secondary_cmd_buffers.clear();
+    m_command_pools.clear        ();
+    m_resources.clear            ();
+    m_heaps.clear                ();
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::add_pass(const std::string&               in_name,
+                                  Anvil::RenderGraphRecordFunction in_record_function,
+                                  Anvil::RenderGraphPassID*        out_pass_id_ptr)
+{
+    Pass new_pass;
+    bool result = false;
+
+    if (m_is_baked)
+    {
+        anvil_assert(!m_is_baked);
+
+        goto end;
+    }
+
+    if (!in_record_function)
+    {
+        anvil_assert(in_record_function);
+
+        goto end;
+    }
+
+    new_pass.name            = in_name;
+    new_pass.record_function = in_record_function;
+
+    *out_pass_id_ptr = static_cast<Anvil::RenderGraphPassID>(m_passes.size() );
+
+    m_passes.push_back(new_pass);
+
+    result = true;
+end:
+    return result;
+}
+
+/** Validates and stores a resource access declared for a pass.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::RenderGraph::add_pass_access(Anvil::RenderGraphPassID in_pass_id,
+                                         const Access&            in_access)
+{
+    const bool expects_image = (in_access.type != AccessType::BUFFER);
+    bool       result        = false;
+
+    if (m_is_baked)
+    {
+        anvil_assert(!m_is_baked);
+
+        goto end;
+    }
+
+    if (in_pass_id            >= m_passes.size   () ||
+        in_access.resource_id >= m_resources.size() )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (m_resources.at(in_access.resource_id).is_image != expects_image ||
+        in_access.stage_mask                           == 0)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    for (const auto& current_access : m_passes.at(in_pass_id).accesses)
+    {
+        /* Each resource can only be accessed once per pass, since barriers cannot be recorded within a subpass. */
+        if (current_access.resource_id == in_access.resource_id)
+        {
+            anvil_assert(current_access.resource_id != in_access.resource_id);
+
+            goto end;
+        }
+
+        if (current_access.type == AccessType::DEPTH_STENCIL_ATTACHMENT &&
+            in_access.type      == AccessType::DEPTH_STENCIL_ATTACHMENT)
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+    }
+
+    m_passes.at(in_pass_id).accesses.push_back(in_access);
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::add_pass_buffer_access(Anvil::RenderGraphPassID     in_pass_id,
+                                                Anvil::RenderGraphResourceID in_resource_id,
+                                                Anvil::PipelineStageFlags    in_stage_mask,
+                                                Anvil::AccessFlags           in_access_mask)
+{
+    Access access;
+
+    access.access_mask = in_access_mask;
+    access.resource_id = in_resource_id;
+    access.stage_mask  = in_stage_mask;
+    access.type        = AccessType::BUFFER;
+
+    return add_pass_access(in_pass_id,
+                           access);
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::add_pass_color_attachment(Anvil::RenderGraphPassID     in_pass_id,
+                                                   Anvil::RenderGraphResourceID in_resource_id,
+                                                   const VkClearColorValue*     in_opt_clear_value_ptr)
+{
+    Access access;
+
+    access.access_mask  = Anvil::AccessFlagBits::COLOR_ATTACHMENT_READ_BIT | Anvil::AccessFlagBits::COLOR_ATTACHMENT_WRITE_BIT;
+    access.layout       = Anvil::ImageLayout::COLOR_ATTACHMENT_OPTIMAL;
+    access.resource_id  = in_resource_id;
+    access.should_clear = (in_opt_clear_value_ptr != nullptr);
+    access.stage_mask   = Anvil::PipelineStageFlagBits::COLOR_ATTACHMENT_OUTPUT_BIT;
+    access.type         = AccessType::COLOR_ATTACHMENT;
+
+    if (in_opt_clear_value_ptr != nullptr)
+    {
+        access.clear_value.color = *in_opt_clear_value_ptr;
+    }
+
+    return add_pass_access(in_pass_id,
+                           access);
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::add_pass_depth_stencil_attachment(Anvil::RenderGraphPassID        in_pass_id,
+                                                           Anvil::RenderGraphResourceID    in_resource_id,
+                                                           const VkClearDepthStencilValue* in_opt_clear_value_ptr)
+{
+    Access access;
+
+    access.access_mask  = Anvil::AccessFlagBits::DEPTH_STENCIL_ATTACHMENT_READ_BIT | Anvil::AccessFlagBits::DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    access.layout       = Anvil::ImageLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    access.resource_id  = in_resource_id;
+    access.should_clear = (in_opt_clear_value_ptr != nullptr);
+    access.stage_mask   = Anvil::PipelineStageFlagBits::EARLY_FRAGMENT_TESTS_BIT | Anvil::PipelineStageFlagBits::LATE_FRAGMENT_TESTS_BIT;
+    access.type         = AccessType::DEPTH_STENCIL_ATTACHMENT;
+
+    if (in_opt_clear_value_ptr != nullptr)
+    {
+        access.clear_value.depthStencil = *in_opt_clear_value_ptr;
+    }
+
+    return add_pass_access(in_pass_id,
+                           access);
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::add_pass_image_access(Anvil::RenderGraphPassID     in_pass_id,
+                                               Anvil::RenderGraphResourceID in_resource_id,
+                                               Anvil::ImageLayout           in_layout,
+                                               Anvil::PipelineStageFlags    in_stage_mask,
+                                               Anvil::AccessFlags           in_access_mask)
+{
+    Access access;
+
+    access.access_mask = in_access_mask;
+    access.layout      = in_layout;
+    access.resource_id = in_resource_id;
+    access.stage_mask  = in_stage_mask;
+    access.type        = AccessType::IMAGE;
+
+    return add_pass_access(in_pass_id,
+                           access);
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::add_pass_input_attachment(Anvil::RenderGraphPassID     in_pass_id,
+                                                   Anvil::RenderGraphResourceID in_resource_id)
+{
+    Access access;
+
+    /* NOTE: The layout is determined at bake time, depending on how other subpasses use the attachment. */
+    access.access_mask = Anvil::AccessFlagBits::INPUT_ATTACHMENT_READ_BIT;
+    access.resource_id = in_resource_id;
+    access.stage_mask  = Anvil::PipelineStageFlagBits::FRAGMENT_SHADER_BIT;
+    access.type        = AccessType::INPUT_ATTACHMENT;
+
+    return add_pass_access(in_pass_id,
+                           access);
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::add_transient_buffer(VkDeviceSize                  in_size,
+                                              Anvil::BufferUsageFlags       in_usage,
+                                              Anvil::RenderGraphResourceID* out_resource_id_ptr)
+{
+    Resource new_resource;
+    bool     result       = false;
+
+    if (m_is_baked  ||
+        in_size == 0)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    new_resource.buffer_usage = in_usage;
+    new_resource.size         = in_size;
+
+    *out_resource_id_ptr = static_cast<Anvil::RenderGraphResourceID>(m_resources.size() );
+
+    m_resources.push_back(std::move(new_resource) );
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::add_transient_image(Anvil::Format                 in_format,
+                                             uint32_t                      in_width,
+                                             uint32_t                      in_height,
+                                             Anvil::SampleCountFlagBits    in_sample_count,
+                                             Anvil::ImageUsageFlags        in_usage,
+                                             Anvil::RenderGraphResourceID* out_resource_id_ptr)
+{
+    Resource new_resource;
+    bool     result       = false;
+
+    if (m_is_baked     ||
+        in_width  == 0 ||
+        in_height == 0)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    new_resource.format       = in_format;
+    new_resource.height       = in_height;
+    new_resource.image_usage  = in_usage;
+    new_resource.is_image     = true;
+    new_resource.sample_count = in_sample_count;
+    new_resource.width        = in_width;
+
+    *out_resource_id_ptr = static_cast<Anvil::RenderGraphResourceID>(m_resources.size() );
+
+    m_resources.push_back(std::move(new_resource) );
+
+    result = true;
+end:
+    return result;
+}
+
+/** Creates transient resources used by passes which have not been culled, and binds them to memory.
+ *
+ *  Resources of the same kind whose lifetimes do not overlap are assigned overlapping regions of the same
+ *  memory block. Larger resources are placed first, each at the lowest offset which does not collide with
+ *  any resource placed earlier whose lifetime overlaps. Buffers and images never share memory blocks, so that
+ *  bufferImageGranularity does not need to be taken into account.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::RenderGraph::allocate_transient_resources()
+{
+    std::vector<std::vector<uint32_t> > heap_resource_indices;
+    std::vector<VkDeviceSize>           memory_alignments      (m_resources.size(), 0);
+    std::vector<uint32_t>               memory_types           (m_resources.size(), 0);
+    std::vector<VkDeviceSize>           memory_sizes           (m_resources.size(), 0);
+    std::vector<uint32_t>               resource_indices;
+    bool                                result                 = false;
+
+    for (uint32_t n_resource = 0;
+                  n_resource < static_cast<uint32_t>(m_resources.size() );
+                ++n_resource)
+    {
+        auto& current_resource = m_resources.at(n_resource);
+
+        if (current_resource.is_imported               ||
+            current_resource.first_step == UINT32_MAX)
+        {
+            continue;
+        }
+
+        if (current_resource.is_image)
+        {
+            auto create_info_ptr = Anvil::ImageCreateInfo::create_no_alloc(m_device_ptr,
+                                                                           Anvil::ImageType::_2D,
+                                                                           current_resource.format,
+                                                                           Anvil::ImageTiling::OPTIMAL,
+                                                                           current_resource.image_usage,
+                                                                           current_resource.width,
+                                                                           current_resource.height,
+                                                                           1, /* in_base_mipmap_depth */
+                                                                           1, /* in_n_layers          */
+                                                                           current_resource.sample_count,
+                                                                           Anvil::QueueFamilyFlagBits::COMPUTE_BIT | Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
+                                                                           Anvil::SharingMode::EXCLUSIVE,
+                                                                           false, /* in_use_full_mipmap_chain */
+                                                                           Anvil::ImageCreateFlagBits::NONE);
+
+            current_resource.owned_image_ptr = Anvil::Image::create(std::move(create_info_ptr) );
+
+            if (current_resource.owned_image_ptr == nullptr)
+            {
+                anvil_assert(current_resource.owned_image_ptr != nullptr);
+
+                goto end;
+            }
+
+            current_resource.image_ptr = current_resource.owned_image_ptr.get();
+
+            memory_alignments.at(n_resource) = current_resource.image_ptr->get_image_alignment   (0 /* in_n_plane */);
+            memory_sizes.at     (n_resource) = current_resource.image_ptr->get_image_storage_size(0 /* in_n_plane */);
+            memory_types.at     (n_resource) = current_resource.image_ptr->get_image_memory_types(0 /* in_n_plane */);
+        }
+        else
+        {
+            auto create_info_ptr = Anvil::BufferCreateInfo::create_no_alloc(m_device_ptr,
+                                                                            current_resource.size,
+                                                                            Anvil::QueueFamilyFlagBits::COMPUTE_BIT | Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
+                                                                            Anvil::SharingMode::EXCLUSIVE,
+                                                                            Anvil::BufferCreateFlagBits::NONE,
+                                                                            current_resource.buffer_usage);
+
+            current_resource.owned_buffer_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
+
+            if (current_resource.owned_buffer_ptr == nullptr)
+            {
+                anvil_assert(current_resource.owned_buffer_ptr != nullptr);
+
+                goto end;
+            }
+
+            current_resource.buffer_ptr = current_resource.owned_buffer_ptr.get();
+
+            {
+                const auto memory_reqs = current_resource.buffer_ptr->get_memory_requirements();
+
+                memory_alignments.at(n_resource) = memory_reqs.alignment;
+                memory_sizes.at     (n_resource) = memory_reqs.size;
+                memory_types.at     (n_resource) = memory_reqs.memoryTypeBits;
+            }
+        }
+
+        resource_indices.push_back(n_resource);
+    }
+
+    std::stable_sort(resource_indices.begin(),
+                     resource_indices.end  (),
+                     [&memory_sizes](uint32_t in_n_resource_a,
+                                     uint32_t in_n_resource_b)
+                     {
+                         return memory_sizes.at(in_n_resource_a) > memory_sizes.at(in_n_resource_b);
+                     });
+
+    /* Assign memory regions */
+    for (const auto n_resource : resource_indices)
+    {
+        auto& current_resource = m_resources.at(n_resource);
+
+        for (uint32_t n_heap = 0;
+                      n_heap < static_cast<uint32_t>(m_heaps.size() ) && current_resource.n_heap == UINT32_MAX;
+                    ++n_heap)
+        {
+            auto&        current_heap = m_heaps.at(n_heap);
+            VkDeviceSize offset       = 0;
+            bool         is_offset_ok = false;
+
+            if (current_heap.is_image                                != current_resource.is_image ||
+                (current_heap.memory_types & memory_types.at(n_resource)) == 0)
+            {
+                continue;
+            }
+
+            /* Candidate offsets are 0 and ends of regions used by colliding resources. Try them in increasing
+             * order until a free spot is found. The end of the heap always qualifies. */
+            while (!is_offset_ok)
+            {
+                VkDeviceSize next_offset = UINT64_MAX;
+
+                is_offset_ok = true;
+
+                for (const auto n_placed_resource : heap_resource_indices.at(n_heap) )
+                {
+                    const auto&        placed_resource = m_resources.at(n_placed_resource);
+                    const VkDeviceSize placed_end      = placed_resource.heap_offset + memory_sizes.at(n_placed_resource);
+
+                    if (placed_resource.last_step  < current_resource.first_step ||
+                        placed_resource.first_step > current_resource.last_step)
+                    {
+                        /* Lifetimes do not overlap */
+                        continue;
+                    }
+
+                    if (placed_resource.heap_offset < offset + memory_sizes.at(n_resource) &&
+                        placed_end                  > offset)
+                    {
+                        is_offset_ok = false;
+                        next_offset  = std::min(next_offset,
+                                                placed_end);
+                    }
+                }
+
+                if (!is_offset_ok)
+                {
+                    offset = Anvil::Utils::round_up(next_offset,
+                                                    memory_alignments.at(n_resource) );
+                }
+            }
+
+            current_heap.memory_types &= memory_types.at(n_resource);
+            current_heap.size          = std::max(current_heap.size,
+                                                  offset + memory_sizes.at(n_resource) );
+
+            current_resource.heap_offset = offset;
+            current_resource.n_heap      = n_heap;
+
+            heap_resource_indices.at(n_heap).push_back(n_resource);
+        }
+
+        if (current_resource.n_heap == UINT32_MAX)
+        {
+            Heap new_heap;
+
+            new_heap.is_image     = current_resource.is_image;
+            new_heap.memory_types = memory_types.at(n_resource);
+            new_heap.size         = memory_sizes.at(n_resource);
+
+            current_resource.heap_offset = 0;
+            current_resource.n_heap      = static_cast<uint32_t>(m_heaps.size() );
+
+            m_heaps.push_back              (std::move(new_heap) );
+            heap_resource_indices.push_back(std::vector<uint32_t>(1, n_resource) );
+        }
+    }
+
+    /* Allocate memory blocks */
+    for (auto& current_heap : m_heaps)
+    {
+        auto create_info_ptr = Anvil::MemoryBlockCreateInfo::create_regular(m_device_ptr,
+                                                                            current_heap.memory_types,
+                                                                            current_heap.size,
+                                                                            Anvil::MemoryFeatureFlagBits::DEVICE_LOCAL_BIT);
+
+        current_heap.memory_block_ptr = Anvil::MemoryBlock::create(std::move(create_info_ptr) );
+
+        if (current_heap.memory_block_ptr == nullptr)
+        {
+            anvil_assert(current_heap.memory_block_ptr != nullptr);
+
+            goto end;
+        }
+    }
+
+    /* Bind resources to memory, and determine which accesses need to finish before resources can be used for
+     * the first time in a frame. This includes accesses made by any resource sharing memory with the resource,
+     * as well as its own accesses, made in the previous frame. */
+    for (const auto n_resource : resource_indices)
+    {
+        auto&        current_resource = m_resources.at(n_resource);
+        const auto   memory_block_ptr = m_heaps.at(current_resource.n_heap).memory_block_ptr.get();
+        const auto   resource_end     = current_resource.heap_offset + memory_sizes.at(n_resource);
+        bool         bind_result      = false;
+
+        for (const auto n_heap_resource : heap_resource_indices.at(current_resource.n_heap) )
+        {
+            const auto& heap_resource = m_resources.at(n_heap_resource);
+
+            if (heap_resource.heap_offset                                    < resource_end &&
+                heap_resource.heap_offset + memory_sizes.at(n_heap_resource) > current_resource.heap_offset)
+            {
+                current_resource.alias_src_access_mask |= (heap_resource.all_access_mask & g_write_access_mask);
+                current_resource.alias_src_stage_mask  |=  heap_resource.all_stage_mask;
+            }
+        }
+
+        {
+            auto memory_block_create_info_ptr = Anvil::MemoryBlockCreateInfo::create_derived(memory_block_ptr,
+                                                                                             current_resource.heap_offset,
+                                                                                             memory_sizes.at(n_resource) );
+
+            if (current_resource.is_image)
+            {
+                bind_result = current_resource.image_ptr->set_memory(Anvil::MemoryBlock::create(std::move(memory_block_create_info_ptr) ));
+            }
+            else
+            {
+                bind_result = current_resource.buffer_ptr->set_nonsparse_memory(Anvil::MemoryBlock::create(std::move(memory_block_create_info_ptr) ));
+            }
+        }
+
+        if (!bind_result)
+        {
+            anvil_assert(bind_result);
+
+            goto end;
+        }
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::bake()
+{
+    bool result = false;
+
+    if (m_is_baked)
+    {
+        anvil_assert(!m_is_baked);
+
+        goto end;
+    }
+
+    cull_passes();
+
+    /* Determine render areas of passes which use attachments */
+    for (auto& current_pass : m_passes)
+    {
+        if (!current_pass.is_alive)
+        {
+            continue;
+        }
+
+        for (const auto& current_access : current_pass.accesses)
+        {
+            const auto& current_resource = m_resources.at(current_access.resource_id);
+
+            if (!current_access.is_attachment() )
+            {
+                continue;
+            }
+
+            if (!current_pass.has_attachments() )
+            {
+                current_pass.extent.height = current_resource.height;
+                current_pass.extent.width  = current_resource.width;
+                current_pass.sample_count  = current_resource.sample_count;
+            }
+            else
+            if (current_pass.extent.height != current_resource.height ||
+                current_pass.extent.width  != current_resource.width  ||
+                current_pass.sample_count  != current_resource.sample_count)
+            {
+                /* All attachments used by a pass must be of the same size */
+                anvil_assert_fail();
+
+                goto end;
+            }
+        }
+    }
+
+    if (!order_passes() )
+    {
+        goto end;
+    }
+
+    /* Determine lifetimes of resources, and how they are accessed */
+    for (uint32_t n_step = 0;
+                  n_step < static_cast<uint32_t>(m_steps.size() );
+                ++n_step)
+    {
+        const auto& current_step = m_steps.at(n_step);
+
+        for (uint32_t n_pass = current_step.first_pass;
+                      n_pass < current_step.first_pass + current_step.n_passes;
+                    ++n_pass)
+        {
+            for (const auto& current_access : m_passes.at(m_ordered_pass_indices.at(n_pass) ).accesses)
+            {
+                auto& current_resource = m_resources.at(current_access.resource_id);
+
+                current_resource.all_access_mask |= current_access.access_mask;
+                current_resource.all_stage_mask  |= current_access.stage_mask;
+                current_resource.first_step       = std::min(current_resource.first_step,
+                                                             n_step);
+                current_resource.last_step        = std::max(current_resource.last_step,
+                                                             n_step);
+
+                switch (current_access.type)
+                {
+                    case AccessType::COLOR_ATTACHMENT:         current_resource.image_usage |= Anvil::ImageUsageFlagBits::COLOR_ATTACHMENT_BIT;         break;
+                    case AccessType::DEPTH_STENCIL_ATTACHMENT: current_resource.image_usage |= Anvil::ImageUsageFlagBits::DEPTH_STENCIL_ATTACHMENT_BIT; break;
+                    case AccessType::INPUT_ATTACHMENT:         current_resource.image_usage |= Anvil::ImageUsageFlagBits::INPUT_ATTACHMENT_BIT;         break;
+
+                    default:
+                    {
+                        /* Usage needs to be specified by the app */
+                    }
+                }
+            }
+        }
+    }
+
+    if (!allocate_transient_resources() )
+    {
+        goto end;
+    }
+
+    for (uint32_t n_step = 0;
+                  n_step < static_cast<uint32_t>(m_steps.size() );
+                ++n_step)
+    {
+        if (!m_passes.at(m_ordered_pass_indices.at(m_steps.at(n_step).first_pass) ).has_attachments() )
+        {
+            continue;
+        }
+
+        if (!bake_render_pass(n_step) )
+        {
+            goto end;
+        }
+
+        ++m_n_render_passes;
+    }
+
+    m_is_baked = true;
+    result     = true;
+end:
+    return result;
+}
+
+/** Creates a render pass for the specified step. Each pass in the step is assigned a subpass.
+ *
+ *  All subpasses use an attachment in the same layout, which is also used as the initial and the final layout
+ *  of the attachment. This way no layout transitions happen within the render pass, and barriers recorded
+ *  before the render pass begins cover all subpasses.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::RenderGraph::bake_render_pass(uint32_t in_n_step)
+{
+    std::vector<Anvil::RenderPassAttachmentID> attachment_ids;
+    Anvil::RenderPassCreateInfoUniquePtr       create_info_ptr(new Anvil::RenderPassCreateInfo(m_device_ptr) );
+    auto&                                      current_step   = m_steps.at(in_n_step);
+    bool                                       result         = false;
+
+    /* Gather attachments used by all subpasses */
+    for (uint32_t n_pass = current_step.first_pass;
+                  n_pass < current_step.first_pass + current_step.n_passes;
+                ++n_pass)
+    {
+        for (const auto& current_access : m_passes.at(m_ordered_pass_indices.at(n_pass) ).accesses)
+        {
+            uint32_t n_attachment = 0;
+
+            if (!current_access.is_attachment() )
+            {
+                continue;
+            }
+
+            while (n_attachment < current_step.attachment_resource_ids.size()                                 &&
+                   current_step.attachment_resource_ids.at(n_attachment) != current_access.resource_id)
+            {
+                ++n_attachment;
+            }
+
+            if (n_attachment == current_step.attachment_resource_ids.size() )
+            {
+                VkClearValue clear_value;
+
+                memset(&clear_value,
+                       0,
+                       sizeof(clear_value) );
+
+                current_step.attachment_access_masks.push_back(Anvil::AccessFlags       () );
+                current_step.attachment_layouts.push_back     (Anvil::ImageLayout::UNDEFINED);
+                current_step.attachment_resource_ids.push_back(current_access.resource_id);
+                current_step.attachment_stage_masks.push_back (Anvil::PipelineStageFlags() );
+                current_step.clear_values.push_back           (clear_value);
+            }
+
+            current_step.attachment_access_masks.at(n_attachment) |= current_access.access_mask;
+            current_step.attachment_stage_masks.at (n_attachment) |= current_access.stage_mask;
+        }
+    }
+
+    /* Configure attachments */
+    for (uint32_t n_attachment = 0;
+                  n_attachment < static_cast<uint32_t>(current_step.attachment_resource_ids.size() );
+                ++n_attachment)
+    {
+        const auto              resource_id      = current_step.attachment_resource_ids.at(n_attachment);
+        const auto&             current_resource = m_resources.at(resource_id);
+        const Access*           first_access_ptr = nullptr;
+        bool                    has_input        = false;
+        bool                    has_output       = false;
+        const bool              is_depth_stencil = (Anvil::Formats::has_depth_aspect  (current_resource.format) ||
+                                                    Anvil::Formats::has_stencil_aspect(current_resource.format) );
+        Anvil::ImageLayout      layout;
+        Anvil::AttachmentLoadOp load_op;
+        Anvil::RenderPassAttachmentID new_attachment_id;
+        Anvil::AttachmentStoreOp      store_op;
+
+        for (uint32_t n_pass = current_step.first_pass;
+                      n_pass < current_step.first_pass + current_step.n_passes;
+                    ++n_pass)
+        {
+            for (const auto& current_access : m_passes.at(m_ordered_pass_indices.at(n_pass) ).accesses)
+            {
+                if (current_access.resource_id != resource_id)
+                {
+                    continue;
+                }
+
+                if (first_access_ptr == nullptr)
+                {
+                    first_access_ptr = &current_access;
+                }
+
+                if (current_access.type == AccessType::INPUT_ATTACHMENT)
+                {
+                    has_input = true;
+                }
+                else
+                {
+                    has_output = true;
+                }
+            }
+        }
+
+        if (has_input && has_output)
+        {
+            layout = Anvil::ImageLayout::GENERAL;
+        }
+        else
+        if (has_output)
+        {
+            layout = (is_depth_stencil) ? Anvil::ImageLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+                                        : Anvil::ImageLayout::COLOR_ATTACHMENT_OPTIMAL;
+        }
+        else
+        {
+            layout = (is_depth_stencil) ? Anvil::ImageLayout::DEPTH_STENCIL_READ_ONLY_OPTIMAL
+                                        : Anvil::ImageLayout::SHADER_READ_ONLY_OPTIMAL;
+        }
+
+        /* Contents are only loaded if they have been produced before the render pass, and only stored if they are
+         * going to be consumed afterward. */
+        if (first_access_ptr->should_clear)
+        {
+            load_op = Anvil::AttachmentLoadOp::CLEAR;
+
+            current_step.clear_values.at(n_attachment) = first_access_ptr->clear_value;
+        }
+        else
+        if (!current_resource.is_imported             &&
+             current_resource.first_step == in_n_step)
+        {
+            load_op = Anvil::AttachmentLoadOp::DONT_CARE;
+        }
+        else
+        {
+            load_op = Anvil::AttachmentLoadOp::LOAD;
+        }
+
+        store_op = (current_resource.is_imported            ||
+                    current_resource.is_output              ||
+                    current_resource.last_step > in_n_step) ? Anvil::AttachmentStoreOp::STORE
+                                                            : Anvil::AttachmentStoreOp::DONT_CARE;
+
+        if (is_depth_stencil)
+        {
+            const bool has_stencil = Anvil::Formats::has_stencil_aspect(current_resource.format);
+
+            result = create_info_ptr->add_depth_stencil_attachment(current_resource.format,
+                                                                   current_resource.sample_count,
+                                                                   load_op,
+                                                                   store_op,
+                                                                   (has_stencil) ? load_op  : Anvil::AttachmentLoadOp::DONT_CARE,
+                                                                   (has_stencil) ? store_op : Anvil::AttachmentStoreOp::DONT_CARE,
+                                                                   layout,
+                                                                   layout,
+                                                                   false, /* in_may_alias */
+                                                                  &new_attachment_id);
+        }
+        else
+        {
+            result = create_info_ptr->add_color_attachment(current_resource.format,
+                                                           current_resource.sample_count,
+                                                           load_op,
+                                                           store_op,
+                                                           layout,
+                                                           layout,
+                                                           false, /* in_may_alias */
+                                                          &new_attachment_id);
+        }
+
+        if (!result)
+        {
+            anvil_assert(result);
+
+            goto end;
+        }
+
+        attachment_ids.push_back(new_attachment_id);
+
+        current_step.attachment_layouts.at(n_attachment) = layout;
+    }
+
+    /* Configure subpasses */
+    for (uint32_t n_pass = current_step.first_pass;
+                  n_pass < current_step.first_pass + current_step.n_passes;
+                ++n_pass)
+    {
+        auto&    current_pass      = m_passes.at(m_ordered_pass_indices.at(n_pass) );
+        uint32_t n_color_attachment = 0;
+        uint32_t n_input_attachment = 0;
+
+        result = create_info_ptr->add_subpass(&current_pass.subpass_id);
+        anvil_assert(result);
+
+        for (const auto& current_access : current_pass.accesses)
+        {
+            uint32_t n_attachment = 0;
+
+            if (!current_access.is_attachment() )
+            {
+                continue;
+            }
+
+            while (current_step.attachment_resource_ids.at(n_attachment) != current_access.resource_id)
+            {
+                ++n_attachment;
+            }
+
+            switch (current_access.type)
+            {
+                case AccessType::COLOR_ATTACHMENT:
+                {
+                    result = create_info_ptr->add_subpass_color_attachment(current_pass.subpass_id,
+                                                                           current_step.attachment_layouts.at(n_attachment),
+                                                                           attachment_ids.at(n_attachment),
+                                                                           n_color_attachment++);
+
+                    break;
+                }
+
+                case AccessType::DEPTH_STENCIL_ATTACHMENT:
+                {
+                    result = create_info_ptr->add_subpass_depth_stencil_attachment(current_pass.subpass_id,
+                                                                                   current_step.attachment_layouts.at(n_attachment),
+                                                                                   attachment_ids.at(n_attachment) );
+
+                    break;
+                }
+
+                case AccessType::INPUT_ATTACHMENT:
+                {
+                    result = create_info_ptr->add_subpass_input_attachment(current_pass.subpass_id,
+                                                                           current_step.attachment_layouts.at(n_attachment),
+                                                                           attachment_ids.at(n_attachment),
+                                                                           n_input_attachment++);
+
+                    break;
+                }
+
+                default:
+                {
+                    anvil_assert_fail();
+                }
+            }
+
+            if (!result)
+            {
+                anvil_assert(result);
+
+                goto end;
+            }
+        }
+    }
+
+    /* Subpasses which share an attachment, at least one of which writes to it, need to be ordered. Since all
+     * accesses are to the same pixel, by-region dependencies suffice. */
+    for (uint32_t n_dst_pass = current_step.first_pass + 1;
+                  n_dst_pass < current_step.first_pass + current_step.n_passes;
+                ++n_dst_pass)
+    {
+        const auto& dst_pass = m_passes.at(m_ordered_pass_indices.at(n_dst_pass) );
+
+        for (uint32_t n_src_pass = current_step.first_pass;
+                      n_src_pass < n_dst_pass;
+                    ++n_src_pass)
+        {
+            Anvil::AccessFlags        dst_access_mask;
+            Anvil::PipelineStageFlags dst_stage_mask;
+            Anvil::AccessFlags        src_access_mask;
+            const auto&               src_pass        = m_passes.at(m_ordered_pass_indices.at(n_src_pass) );
+            Anvil::PipelineStageFlags src_stage_mask;
+
+            for (const auto& src_access : src_pass.accesses)
+            {
+                for (const auto& dst_access : dst_pass.accesses)
+                {
+                    if (src_access.resource_id != dst_access.resource_id                   ||
+                        !src_access.is_attachment()                                        ||
+                        (!is_write(src_access) && !is_write(dst_access) ))
+                    {
+                        continue;
+                    }
+
+                    dst_access_mask |=  dst_access.access_mask;
+                    dst_stage_mask  |=  dst_access.stage_mask;
+                    src_access_mask |= (src_access.access_mask & g_write_access_mask);
+                    src_stage_mask  |=  src_access.stage_mask;
+                }
+            }
+
+            if (src_stage_mask != 0)
+            {
+                result = create_info_ptr->add_subpass_to_subpass_dependency(src_pass.subpass_id,
+                                                                            dst_pass.subpass_id,
+                                                                            src_stage_mask,
+                                                                            dst_stage_mask,
+                                                                            src_access_mask,
+                                                                            dst_access_mask,
+                                                                            Anvil::DependencyFlagBits::BY_REGION_BIT);
+
+                if (!result)
+                {
+                    anvil_assert(result);
+
+                    goto end;
+                }
+            }
+        }
+    }
+
+    current_step.render_pass_ptr = Anvil::RenderPass::create(std::move(create_info_ptr),
+                                                             nullptr); /* in_opt_swapchain_ptr */
+
+    result = (current_step.render_pass_ptr != nullptr);
+    anvil_assert(result);
+end:
+    return result;
+}
+
+/** Tells whether the specified pass can be executed as the next subpass of the render pass of the specified step.
+ *
+ *  This is the case if both use attachments of the same size, and the only resources they share are attachments,
+ *  or resources which are only read from in the same layout. Any other kind of sharing would require a barrier
+ *  between the subpasses.
+ **/
+bool Anvil::RenderGraph::can_merge(const Step& in_step,
+                                   uint32_t    in_n_pass) const
+{
+    const auto& first_pass = m_passes.at(m_ordered_pass_indices.at(in_step.first_pass) );
+    const auto& new_pass   = m_passes.at(in_n_pass);
+
+    if (!first_pass.has_attachments()                         ||
+        !new_pass.has_attachments  ()                         ||
+         first_pass.extent.height != new_pass.extent.height   ||
+         first_pass.extent.width  != new_pass.extent.width    ||
+         first_pass.sample_count  != new_pass.sample_count)
+    {
+        return false;
+    }
+
+    for (uint32_t n_pass = in_step.first_pass;
+                  n_pass < in_step.first_pass + in_step.n_passes;
+                ++n_pass)
+    {
+        for (const auto& step_access : m_passes.at(m_ordered_pass_indices.at(n_pass) ).accesses)
+        {
+            for (const auto& new_access : new_pass.accesses)
+            {
+                if (step_access.resource_id != new_access.resource_id)
+                {
+                    continue;
+                }
+
+                if (step_access.is_attachment() &&
+                    new_access.is_attachment () )
+                {
+                    continue;
+                }
+
+                if (!step_access.is_attachment()            &&
+                    !new_access.is_attachment ()            &&
+                    !is_write(step_access)                  &&
+                    !is_write(new_access)                   &&
+                     step_access.layout == new_access.layout)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/* Please see header for specification */
+Anvil::RenderGraphUniquePtr Anvil::RenderGraph::create(Anvil::BaseDevice* in_device_ptr,
+                                                       uint32_t           in_queue_family_index,
+                                                       uint32_t           in_n_frames_in_flight,
+                                                       uint32_t           in_n_recording_threads)
+{
+    RenderGraphUniquePtr result_ptr(nullptr,
+                                    std::default_delete<RenderGraph>() );
+
+    if (in_n_frames_in_flight  == 0 ||
+        in_n_recording_threads == 0)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    /* Passes recorded on multiple threads create and use device-level objects concurrently */
+    if ( in_n_recording_threads > 1 &&
+        !in_device_ptr->is_mt_safe() )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    result_ptr.reset(
+        new Anvil::RenderGraph(in_device_ptr,
+                               in_queue_family_index,
+                               in_n_frames_in_flight,
+                               in_n_recording_threads)
+    );
+
+    if (in_n_recording_threads > 1)
+    {
+        /* Command pools are only ever accessed from a single thread at a time */
+        for (uint32_t n_command_pool = 0;
+                      n_command_pool < in_n_frames_in_flight * in_n_recording_threads;
+                    ++n_command_pool)
+        {
+            auto command_pool_ptr = Anvil::CommandPool::create(in_device_ptr,
+                                                               Anvil::CommandPoolCreateFlagBits::CREATE_TRANSIENT_BIT,
+                                                               in_queue_family_index,
+                                                               Anvil::MTSafety::DISABLED);
+
+            if (command_pool_ptr == nullptr)
+            {
+                anvil_assert(command_pool_ptr != nullptr);
+
+                result_ptr.reset();
+                goto end;
+            }
+
+            result_ptr->m_command_pools.push_back(std::move(command_pool_ptr) );
+        }
+
+        result_ptr->m_secondary_cmd_buffers.resize(in_n_frames_in_flight * in_n_recording_threads);
+
+        /* The calling thread acts as worker 0 */
+        for (uint32_t n_thread = 1;
+                      n_thread < in_n_recording_threads;
+                    ++n_thread)
+        {
+            result_ptr->m_worker_threads.push_back(
+                std::thread(&RenderGraph::worker_thread_entrypoint,
+                            result_ptr.get(),
+                            n_thread)
+            );
+        }
+    }
+
+end:
+    return result_ptr;
+}
+
+/** Marks passes which do not contribute to any imported resource or resource marked as an output as culled.
+ *
+ *  Passes are visited in reverse order. A pass is kept alive if it writes to a resource whose contents are
+ *  needed by a later pass which is alive, or after the graph executes. All resources read by a pass which is
+ *  kept alive are needed.
+ **/
+void Anvil::RenderGraph::cull_passes()
+{
+    std::vector<bool> is_resource_needed(m_resources.size(),
+                                         false);
+
+    for (uint32_t n_resource = 0;
+                  n_resource < static_cast<uint32_t>(m_resources.size() );
+                ++n_resource)
+    {
+        is_resource_needed.at(n_resource) = (m_resources.at(n_resource).is_imported ||
+                                             m_resources.at(n_resource).is_output);
+    }
+
+    m_n_culled_passes = 0;
+
+    for (auto pass_iterator  = m_passes.rbegin();
+              pass_iterator != m_passes.rend  ();
+            ++pass_iterator)
+    {
+        pass_iterator->is_alive = false;
+
+        for (const auto& current_access : pass_iterator->accesses)
+        {
+            if (is_write(current_access)                                &&
+                is_resource_needed.at(current_access.resource_id) )
+            {
+                pass_iterator->is_alive = true;
+
+                break;
+            }
+        }
+
+        if (!pass_iterator->is_alive)
+        {
+            ++m_n_culled_passes;
+
+            continue;
+        }
+
+        for (const auto& current_access : pass_iterator->accesses)
+        {
+            if (is_read(current_access) )
+            {
+                is_resource_needed.at(current_access.resource_id) = true;
+            }
+        }
+    }
+}
+
+/** Declares how commands recorded next are going to access a resource.
+ *
+ *  Usages of imported resources are forwarded to the command buffer, so that they are tracked across frames
+ *  and command buffers. Usages of transient resources are tracked by the graph. Contents of transient resources
+ *  are undefined when they are first used in a frame, so the first usage only needs to wait for accesses made
+ *  to the same memory by aliasing resources, or by the previous frame.
+ *
+ *  Barriers for transient resources are accumulated in scratch storage, and are recorded by declare_step_usages().
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::RenderGraph::declare_usage(Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr,
+                                       Anvil::RenderGraphResourceID in_resource_id,
+                                       bool                         in_is_attachment,
+                                       Anvil::ImageLayout           in_layout,
+                                       Anvil::PipelineStageFlags    in_stage_mask,
+                                       Anvil::AccessFlags           in_access_mask)
+{
+    auto&                        current_resource = m_resources.at(in_resource_id);
+    Anvil::ImageSubresourceRange range;
+    bool                         result           = true;
+
+    if (current_resource.is_image)
+    {
+        if (in_is_attachment)
+        {
+            range.aspect_mask      = get_aspects(current_resource.format);
+            range.base_array_layer = 0;
+            range.base_mip_level   = 0;
+            range.layer_count      = 1;
+            range.level_count      = 1;
+        }
+        else
+        {
+            range = current_resource.image_ptr->get_subresource_range();
+        }
+    }
+
+    if (current_resource.is_imported)
+    {
+        if (current_resource.is_image)
+        {
+            result = in_cmd_buffer_ptr->declare_image_usage(current_resource.image_ptr,
+                                                            range,
+                                                            in_layout,
+                                                            in_stage_mask,
+                                                            in_access_mask);
+        }
+        else
+        {
+            result = in_cmd_buffer_ptr->declare_buffer_usage(current_resource.buffer_ptr,
+                                                             in_stage_mask,
+                                                             in_access_mask);
+        }
+
+        goto end;
+    }
+
+    if (!current_resource.is_used)
+    {
+        Anvil::AccessFlags        dst_access_mask = in_access_mask;
+        Anvil::PipelineStageFlags dst_stage_mask  = in_stage_mask;
+
+        if ((in_access_mask & g_write_access_mask) == 0)
+        {
+            /* Further reads using the same layout are not going to result in barriers, so make the transition
+             * visible to all of them. */
+            dst_access_mask |= current_resource.all_access_mask;
+            dst_stage_mask  |= current_resource.all_stage_mask;
+        }
+
+        m_transient_dst_stage_mask         |= dst_stage_mask;
+        m_transient_memory_dst_access_mask |= dst_access_mask;
+        m_transient_memory_src_access_mask |= current_resource.alias_src_access_mask;
+        m_transient_src_stage_mask         |= current_resource.alias_src_stage_mask;
+
+        if (current_resource.is_image)
+        {
+            m_transient_image_barriers.push_back(
+                Anvil::ImageBarrier(Anvil::AccessFlagBits::NONE,
+                                    dst_access_mask,
+                                    Anvil::ImageLayout::UNDEFINED,
+                                    in_layout,
+                                    VK_QUEUE_FAMILY_IGNORED,
+                                    VK_QUEUE_FAMILY_IGNORED,
+                                    current_resource.image_ptr,
+                                    range)
+            );
+        }
+
+        current_resource.is_used = true;
+    }
+
+    if (current_resource.is_image)
+    {
+        m_transient_state_tracker_ptr->use_image(current_resource.image_ptr,
+                                                 range,
+                                                 in_layout,
+                                                 in_stage_mask,
+                                                 in_access_mask,
+                                                &m_transient_src_stage_mask,
+                                                &m_transient_dst_stage_mask,
+                                                &m_transient_image_barriers);
+    }
+    else
+    {
+        m_transient_state_tracker_ptr->use_buffer(current_resource.buffer_ptr,
+                                                  in_stage_mask,
+                                                  in_access_mask,
+                                                 &m_transient_src_stage_mask,
+                                                 &m_transient_dst_stage_mask,
+                                                 &m_transient_buffer_barriers);
+    }
+
+end:
+    return result;
+}
+
+/** Declares usages of all resources accessed by passes of the specified step, and records barriers needed
+ *  to make these accesses safe.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::RenderGraph::declare_step_usages(Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr,
+                                             uint32_t                     in_n_step)
+{
+    const auto& current_step = m_steps.at(in_n_step);
+    bool        result       = true;
+
+    m_transient_buffer_barriers.clear();
+    m_transient_image_barriers.clear ();
+
+    m_transient_dst_stage_mask         = Anvil::PipelineStageFlags();
+    m_transient_memory_dst_access_mask = Anvil::AccessFlags       ();
+    m_transient_memory_src_access_mask = Anvil::AccessFlags       ();
+    m_transient_src_stage_mask         = Anvil::PipelineStageFlags();
+
+    for (uint32_t n_pass = current_step.first_pass;
+                  n_pass < current_step.first_pass + current_step.n_passes && result;
+                ++n_pass)
+    {
+        for (const auto& current_access : m_passes.at(m_ordered_pass_indices.at(n_pass) ).accesses)
+        {
+            if (current_access.is_attachment() )
+            {
+                continue;
+            }
+
+            result &= declare_usage(in_cmd_buffer_ptr,
+                                    current_access.resource_id,
+                                    false, /* in_is_attachment */
+                                    current_access.layout,
+                                    current_access.stage_mask,
+                                    current_access.access_mask);
+        }
+    }
+
+    for (uint32_t n_attachment = 0;
+                  n_attachment < static_cast<uint32_t>(current_step.attachment_resource_ids.size() ) && result;
+                ++n_attachment)
+    {
+        result &= declare_usage(in_cmd_buffer_ptr,
+                                current_step.attachment_resource_ids.at(n_attachment),
+                                true, /* in_is_attachment */
+                                current_step.attachment_layouts.at     (n_attachment),
+                                current_step.attachment_stage_masks.at (n_attachment),
+                                current_step.attachment_access_masks.at(n_attachment) );
+    }
+
+    if (!result)
+    {
+        anvil_assert(result);
+
+        goto end;
+    }
+
+    if (m_transient_src_stage_mask != 0)
+    {
+        const bool          has_memory_barrier = (m_transient_memory_src_access_mask != 0);
+        Anvil::MemoryBarrier memory_barrier    (m_transient_memory_dst_access_mask,
+                                                m_transient_memory_src_access_mask);
+
+        result = in_cmd_buffer_ptr->record_pipeline_barrier(m_transient_src_stage_mask,
+                                                            m_transient_dst_stage_mask,
+                                                            Anvil::DependencyFlagBits::NONE,
+                                                            (has_memory_barrier) ? 1                : 0,
+                                                            (has_memory_barrier) ? &memory_barrier : nullptr,
+                                                            static_cast<uint32_t>(m_transient_buffer_barriers.size() ),
+                                                            (m_transient_buffer_barriers.size() > 0) ? &m_transient_buffer_barriers.at(0) : nullptr,
+                                                            static_cast<uint32_t>(m_transient_image_barriers.size() ),
+                                                            (m_transient_image_barriers.size() > 0)  ? &m_transient_image_barriers.at(0)  : nullptr);
+    }
+
+end:
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::Buffer* Anvil::RenderGraph::get_buffer(Anvil::RenderGraphResourceID in_resource_id) const
+{
+    if (in_resource_id >= m_resources.size() )
+    {
+        return nullptr;
+    }
+
+    return m_resources.at(in_resource_id).buffer_ptr;
+}
+
+/** Returns a framebuffer which binds images currently assigned to attachments of the specified step. Framebuffers
+ *  are created at first use, and cached for subsequent frames.
+ *
+ *  @return Requested framebuffer, or nullptr if the framebuffer could not be created.
+ **/
+Anvil::Framebuffer* Anvil::RenderGraph::get_framebuffer(uint32_t in_n_step)
+{
+    auto&                                current_step    = m_steps.at(in_n_step);
+    Anvil::FramebufferCreateInfoUniquePtr create_info_ptr;
+    const auto&                          first_pass      = m_passes.at(m_ordered_pass_indices.at(current_step.first_pass) );
+    decltype(current_step.framebuffers)::iterator framebuffer_iterator;
+    Anvil::Framebuffer*                  result_ptr      = nullptr;
+
+    m_scratch_image_view_ptrs.clear();
+
+    for (const auto resource_id : current_step.attachment_resource_ids)
+    {
+        auto image_view_ptr = get_image_view(resource_id);
+
+        if (image_view_ptr == nullptr)
+        {
+            anvil_assert(image_view_ptr != nullptr);
+
+            goto end;
+        }
+
+        m_scratch_image_view_ptrs.push_back(image_view_ptr);
+    }
+
+    framebuffer_iterator = current_step.framebuffers.find(m_scratch_image_view_ptrs);
+
+    if (framebuffer_iterator != current_step.framebuffers.end() )
+    {
+        result_ptr = framebuffer_iterator->second.get();
+
+        goto end;
+    }
+
+    create_info_ptr = Anvil::FramebufferCreateInfo::create(m_device_ptr,
+                                                           first_pass.extent.width,
+                                                           first_pass.extent.height,
+                                                           1); /* n_layers */
+
+    for (const auto image_view_ptr : m_scratch_image_view_ptrs)
+    {
+        if (!create_info_ptr->add_attachment(image_view_ptr,
+                                             nullptr) ) /* out_opt_attachment_id_ptr */
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+    }
+
+    {
+        auto new_framebuffer_ptr = Anvil::Framebuffer::create(std::move(create_info_ptr) );
+
+        if (new_framebuffer_ptr == nullptr)
+        {
+            anvil_assert(new_framebuffer_ptr != nullptr);
+
+            goto end;
+        }
+
+        result_ptr = new_framebuffer_ptr.get();
+
+        current_step.framebuffers[m_scratch_image_view_ptrs] = std::move(new_framebuffer_ptr);
+    }
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+Anvil::Image* Anvil::RenderGraph::get_image(Anvil::RenderGraphResourceID in_resource_id) const
+{
+    if (in_resource_id >= m_resources.size() )
+    {
+        return nullptr;
+    }
+
+    return m_resources.at(in_resource_id).image_ptr;
+}
+
+/* Please see header for specification */
+Anvil::ImageView* Anvil::RenderGraph::get_image_view(Anvil::RenderGraphResourceID in_resource_id)
+{
+    Anvil::Image*     image_ptr  = get_image(in_resource_id);
+    Anvil::ImageView* result_ptr = nullptr;
+
+    if (image_ptr == nullptr)
+    {
+        goto end;
+    }
+
+    {
+        auto view_iterator = m_image_views.find(image_ptr);
+
+        if (view_iterator == m_image_views.end() )
+        {
+            const auto format          = m_resources.at(in_resource_id).format;
+            auto       create_info_ptr = Anvil::ImageViewCreateInfo::create_2D(m_device_ptr,
+                                                                               image_ptr,
+                                                                               0, /* in_n_base_layer        */
+                                                                               0, /* in_n_base_mipmap_level */
+                                                                               1, /* in_n_mipmaps           */
+                                                                               get_aspects(format),
+                                                                               format,
+                                                                               Anvil::ComponentSwizzle::IDENTITY,
+                                                                               Anvil::ComponentSwizzle::IDENTITY,
+                                                                               Anvil::ComponentSwizzle::IDENTITY,
+                                                                               Anvil::ComponentSwizzle::IDENTITY);
+            auto       image_view_ptr  = Anvil::ImageView::create(std::move(create_info_ptr) );
+
+            if (image_view_ptr == nullptr)
+            {
+                anvil_assert(image_view_ptr != nullptr);
+
+                goto end;
+            }
+
+            view_iterator = m_image_views.insert(std::make_pair(image_ptr,
+                                                                std::move(image_view_ptr) )).first;
+        }
+
+        result_ptr = view_iterator->second.get();
+    }
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::get_pass_render_pass(Anvil::RenderGraphPassID in_pass_id,
+                                              Anvil::RenderPass**      out_render_pass_ptr_ptr,
+                                              Anvil::SubPassID*        out_subpass_id_ptr) const
+{
+    bool result = false;
+
+    if (!m_is_baked                   ||
+        in_pass_id >= m_passes.size() )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (!m_passes.at(in_pass_id).is_alive          ||
+        !m_passes.at(in_pass_id).has_attachments() )
+    {
+        goto end;
+    }
+
+    *out_render_pass_ptr_ptr = m_steps.at(m_passes.at(in_pass_id).n_step).render_pass_ptr.get();
+    *out_subpass_id_ptr      = m_passes.at(in_pass_id).subpass_id;
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::import_buffer(Anvil::Buffer*                in_buffer_ptr,
+                                       Anvil::RenderGraphResourceID* out_resource_id_ptr)
+{
+    Resource new_resource;
+    bool     result       = false;
+
+    if (m_is_baked                ||
+        in_buffer_ptr == nullptr)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    new_resource.buffer_ptr  = in_buffer_ptr;
+    new_resource.is_imported = true;
+
+    *out_resource_id_ptr = static_cast<Anvil::RenderGraphResourceID>(m_resources.size() );
+
+    m_resources.push_back(std::move(new_resource) );
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::import_image(Anvil::Image*                 in_image_ptr,
+                                      Anvil::RenderGraphResourceID* out_resource_id_ptr)
+{
+    VkExtent2D extent;
+    Resource   new_resource;
+    bool       result       = false;
+
+    if (m_is_baked               ||
+        in_image_ptr == nullptr)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    extent = in_image_ptr->get_image_extent_2D(0 /* in_n_mipmap */);
+
+    new_resource.format       = in_image_ptr->get_create_info_ptr()->get_format      ();
+    new_resource.height       = extent.height;
+    new_resource.image_ptr    = in_image_ptr;
+    new_resource.is_image     = true;
+    new_resource.is_imported  = true;
+    new_resource.sample_count = in_image_ptr->get_create_info_ptr()->get_sample_count();
+    new_resource.width        = extent.width;
+
+    *out_resource_id_ptr = static_cast<Anvil::RenderGraphResourceID>(m_resources.size() );
+
+    m_resources.push_back(std::move(new_resource) );
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::is_pass_culled(Anvil::RenderGraphPassID in_pass_id) const
+{
+    return (m_is_baked                           &&
+            in_pass_id < m_passes.size()         &&
+            !m_passes.at(in_pass_id).is_alive);
+}
+
+/** Tells whether an access reads the contents of a resource. Attachments which are not cleared are considered
+ *  read, since their contents are preserved. Accesses which neither read nor write (eg. execution-only
+ *  dependencies) are considered reads.
+ **/
+bool Anvil::RenderGraph::is_read(const Access& in_access)
+{
+    switch (in_access.type)
+    {
+        case AccessType::COLOR_ATTACHMENT:
+        case AccessType::DEPTH_STENCIL_ATTACHMENT:
+        {
+            return !in_access.should_clear;
+        }
+
+        case AccessType::INPUT_ATTACHMENT:
+        {
+            return true;
+        }
+
+        default:
+        {
+            const auto access_mask = in_access.access_mask.get_vk();
+            const auto write_mask  = g_write_access_mask.get_vk   ();
+
+            return ((access_mask & ~write_mask) != 0 ||
+                    (access_mask &  write_mask) == 0);
+        }
+    }
+}
+
+/** Tells whether an access modifies the contents of a resource. */
+bool Anvil::RenderGraph::is_write(const Access& in_access)
+{
+    switch (in_access.type)
+    {
+        case AccessType::COLOR_ATTACHMENT:
+        case AccessType::DEPTH_STENCIL_ATTACHMENT:
+        {
+            return true;
+        }
+
+        case AccessType::INPUT_ATTACHMENT:
+        {
+            return false;
+        }
+
+        default:
+        {
+            return ((in_access.access_mask & g_write_access_mask) != 0);
+        }
+    }
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::mark_resource_as_output(Anvil::RenderGraphResourceID in_resource_id)
+{
+    bool result = false;
+
+    if (m_is_baked                             ||
+        in_resource_id >= m_resources.size() )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    m_resources.at(in_resource_id).is_output = true;
+
+    result = true;
+end:
+    return result;
+}
+
+/** Orders passes which have not been culled and groups them into steps.
+ *
+ *  Passes are scheduled in declaration order, as soon as all passes they depend on have been scheduled, except
+ *  that passes which can be merged into the render pass of the last step are preferred. This moves independent
+ *  passes out of the way of passes which render to the same attachments.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::RenderGraph::order_passes()
+{
+    std::vector<uint32_t>               n_pending_dependencies(m_passes.size(), 0);
+    uint32_t                            n_alive_passes        = 0;
+    std::vector<uint32_t>               ready_pass_indices;
+    std::vector<std::vector<uint32_t> > successor_pass_indices(m_passes.size() );
+
+    /* Determine dependencies. A pass depends on the last pass which wrote to any resource it accesses, and, if it
+     * writes to a resource, on all passes which read the resource since it was last written to. */
+    {
+        std::vector<uint32_t>               last_writer_pass_indices(m_resources.size(), UINT32_MAX);
+        std::vector<std::vector<uint32_t> > reader_pass_indices     (m_resources.size() );
+
+        for (uint32_t n_pass = 0;
+                      n_pass < static_cast<uint32_t>(m_passes.size() );
+                    ++n_pass)
+        {
+            const auto& current_pass = m_passes.at(n_pass);
+
+            if (!current_pass.is_alive)
+            {
+                continue;
+            }
+
+            ++n_alive_passes;
+
+            for (const auto& current_access : current_pass.accesses)
+            {
+                const auto last_writer_pass_index = last_writer_pass_indices.at(current_access.resource_id);
+
+                if (last_writer_pass_index != UINT32_MAX)
+                {
+                    successor_pass_indices.at(last_writer_pass_index).push_back(n_pass);
+                    ++n_pending_dependencies.at(n_pass);
+                }
+
+                if (is_write(current_access) )
+                {
+                    for (const auto reader_pass_index : reader_pass_indices.at(current_access.resource_id) )
+                    {
+                        successor_pass_indices.at(reader_pass_index).push_back(n_pass);
+                        ++n_pending_dependencies.at(n_pass);
+                    }
+                }
+            }
+
+            for (const auto& current_access : current_pass.accesses)
+            {
+                if (is_write(current_access) )
+                {
+                    last_writer_pass_indices.at(current_access.resource_id) = n_pass;
+                    reader_pass_indices.at     (current_access.resource_id).clear();
+                }
+                else
+                {
+                    reader_pass_indices.at(current_access.resource_id).push_back(n_pass);
+                }
+            }
+
+            if (n_pending_dependencies.at(n_pass) == 0)
+            {
+                ready_pass_indices.push_back(n_pass);
+            }
+        }
+    }
+
+    m_ordered_pass_indices.clear();
+    m_steps.clear               ();
+
+    while (ready_pass_indices.size() > 0)
+    {
+        auto     chosen_iterator = ready_pass_indices.begin();
+        uint32_t n_chosen_pass;
+
+        if (m_steps.size() > 0)
+        {
+            for (auto ready_iterator  = ready_pass_indices.begin();
+                      ready_iterator != ready_pass_indices.end  ();
+                    ++ready_iterator)
+            {
+                if (can_merge(m_steps.back(),
+                              *ready_iterator) )
+                {
+                    chosen_iterator = ready_iterator;
+
+                    break;
+                }
+            }
+        }
+
+        n_chosen_pass = *chosen_iterator;
+
+        ready_pass_indices.erase(chosen_iterator);
+
+        if (m_steps.size() == 0                  ||
+            !can_merge(m_steps.back(),
+                       n_chosen_pass) )
+        {
+            Step new_step;
+
+            new_step.first_pass = static_cast<uint32_t>(m_ordered_pass_indices.size() );
+            new_step.n_passes   = 0;
+
+            m_steps.push_back(std::move(new_step) );
+        }
+
+        m_passes.at(n_chosen_pass).n_step = static_cast<uint32_t>(m_steps.size() - 1);
+
+        m_ordered_pass_indices.push_back(n_chosen_pass);
+        ++m_steps.back().n_passes;
+
+        for (const auto successor_pass_index : successor_pass_indices.at(n_chosen_pass) )
+        {
+            if (--n_pending_dependencies.at(successor_pass_index) == 0)
+            {
+                ready_pass_indices.insert(std::lower_bound(ready_pass_indices.begin(),
+                                                           ready_pass_indices.end  (),
+                                                           successor_pass_index),
+                                          successor_pass_index);
+            }
+        }
+    }
+
+    /* Dependencies always point from earlier to later passes, so all passes are expected to be scheduled */
+    anvil_assert(m_ordered_pass_indices.size() == n_alive_passes);
+
+    return (m_ordered_pass_indices.size() == n_alive_passes);
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::record(Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr)
+{
+    const auto contents = (m_n_recording_threads > 1) ? Anvil::SubpassContents::SECONDARY_COMMAND_BUFFERS
+                                                      : Anvil::SubpassContents::INLINE;
+    bool       result   = false;
+
+    if (!m_is_baked                      ||
+        in_cmd_buffer_ptr == nullptr)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    m_transient_state_tracker_ptr->reset();
+
+    for (auto& current_resource : m_resources)
+    {
+        current_resource.is_used = false;
+    }
+
+    /* Framebuffers are created lazily, so they need to be retrieved before passes are recorded in parallel */
+    m_step_framebuffer_ptrs.resize(m_steps.size() );
+
+    for (uint32_t n_step = 0;
+                  n_step < static_cast<uint32_t>(m_steps.size() );
+                ++n_step)
+    {
+        auto& framebuffer_ptr = m_step_framebuffer_ptrs.at(n_step);
+
+        framebuffer_ptr = nullptr;
+
+        if (m_steps.at(n_step).render_pass_ptr != nullptr)
+        {
+            framebuffer_ptr = get_framebuffer(n_step);
+
+            if (framebuffer_ptr == nullptr)
+            {
+                goto end;
+            }
+
+            /* Bake the framebuffer for the render pass on this thread */
+            framebuffer_ptr->get_framebuffer(m_steps.at(n_step).render_pass_ptr.get() );
+        }
+    }
+
+    if (m_n_recording_threads > 1)
+    {
+        const uint32_t n_first_command_pool = (m_n_current_frame % m_n_frames_in_flight) * m_n_recording_threads;
+
+        for (uint32_t n_thread = 0;
+                      n_thread < m_n_recording_threads;
+                    ++n_thread)
+        {
+            m_command_pools.at(n_first_command_pool + n_thread)->reset(false); /* in_release_resources */
+        }
+
+        m_pass_cmd_buffer_ptrs.resize(m_ordered_pass_indices.size() );
+
+        {
+            std::unique_lock<std::mutex> lock(m_jobs_mutex);
+
+            m_n_busy_workers = m_n_recording_threads - 1;
+            m_n_next_job     = 0;
+
+            ++m_jobs_generation;
+        }
+
+        m_jobs_cv.notify_all();
+
+        record_passes(0 /* in_n_thread */);
+
+        {
+            std::unique_lock<std::mutex> lock(m_jobs_mutex);
+
+            m_jobs_cv.wait(lock,
+                           [this]()
+                           {
+                               return (m_n_busy_workers == 0);
+                           });
+        }
+    }
+
+    for (uint32_t n_step = 0;
+                  n_step < static_cast<uint32_t>(m_steps.size() );
+                ++n_step)
+    {
+        const auto& current_step    = m_steps.at(n_step);
+        const auto  render_pass_ptr = current_step.render_pass_ptr.get();
+
+        if (!declare_step_usages(in_cmd_buffer_ptr,
+                                 n_step) )
+        {
+            goto end;
+        }
+
+        if (render_pass_ptr != nullptr)
+        {
+            VkRect2D render_area;
+
+            render_area.extent   = m_passes.at(m_ordered_pass_indices.at(current_step.first_pass) ).extent;
+            render_area.offset.x = 0;
+            render_area.offset.y = 0;
+
+            if (!in_cmd_buffer_ptr->record_begin_render_pass(static_cast<uint32_t>(current_step.clear_values.size() ),
+                                                            &current_step.clear_values.at(0),
+                                                             m_step_framebuffer_ptrs.at(n_step),
+                                                             render_area,
+                                                             render_pass_ptr,
+                                                             contents) )
+            {
+                goto end;
+            }
+        }
+
+        for (uint32_t n_pass = current_step.first_pass;
+                      n_pass < current_step.first_pass + current_step.n_passes;
+                    ++n_pass)
+        {
+            const auto pass_id = m_ordered_pass_indices.at(n_pass);
+
+            if (render_pass_ptr != nullptr      &&
+                n_pass          != current_step.first_pass)
+            {
+                in_cmd_buffer_ptr->record_next_subpass(contents);
+            }
+
+            if (m_n_recording_threads > 1)
+            {
+                in_cmd_buffer_ptr->record_execute_commands(1, /* in_cmd_buffers_count */
+                                                          &m_pass_cmd_buffer_ptrs.at(n_pass) );
+            }
+            else
+            {
+                m_passes.at(pass_id).record_function(in_cmd_buffer_ptr,
+                                                     pass_id);
+            }
+        }
+
+        if (render_pass_ptr != nullptr)
+        {
+            in_cmd_buffer_ptr->record_end_render_pass();
+        }
+    }
+
+    ++m_n_current_frame;
+
+    result = true;
+end:
+    return result;
+}
+
+/** Records passes into secondary command buffers, until there are no more passes left to record. Can be called
+ *  from many threads at the same time. Each thread uses its own command pool.
+ *
+ *  @param in_n_thread Index of the calling thread. 0 for the thread which called record().
+ **/
+void Anvil::RenderGraph::record_passes(uint32_t in_n_thread)
+{
+    const uint32_t n_command_pool   = (m_n_current_frame % m_n_frames_in_flight) * m_n_recording_threads + in_n_thread;
+    auto           command_pool_ptr = m_command_pools.at(n_command_pool).get();
+    auto&          cmd_buffers      = m_secondary_cmd_buffers.at(n_command_pool);
+    uint32_t       n_used_cmd_buffers = 0;
+
+    while (true)
+    {
+        Anvil::SecondaryCommandBuffer* cmd_buffer_ptr = nullptr;
+        const uint32_t                 n_job          = m_n_next_job.fetch_add(1);
+        uint32_t                       pass_id;
+
+        if (n_job >= m_ordered_pass_indices.size() )
+        {
+            break;
+        }
+
+        pass_id = m_ordered_pass_indices.at(n_job);
+
+        if (n_used_cmd_buffers == cmd_buffers.size() )
+        {
+            cmd_buffers.push_back(command_pool_ptr->alloc_secondary_level_command_buffer() );
+        }
+
+        cmd_buffer_ptr = cmd_buffers.at(n_used_cmd_buffers++).get();
+
+        {
+            const auto& current_pass = m_passes.at(pass_id);
+            const auto  n_step       = current_pass.n_step;
+
+            cmd_buffer_ptr->start_recording(true,  /* in_one_time_submit          */
+                                            false, /* in_simultaneous_use_allowed */
+                                            current_pass.has_attachments(),
+                                            m_step_framebuffer_ptrs.at(n_step),
+                                            m_steps.at(n_step).render_pass_ptr.get(),
+                                            (current_pass.has_attachments() ) ? current_pass.subpass_id : 0,
+                                            Anvil::OcclusionQuerySupportScope::NOT_REQUIRED,
+                                            false, /* in_occlusion_query_used_by_primary_command_buffer */
+                                            Anvil::QueryPipelineStatisticFlagBits::NONE);
+            {
+                current_pass.record_function(cmd_buffer_ptr,
+                                             pass_id);
+            }
+            cmd_buffer_ptr->stop_recording();
+        }
+
+        m_pass_cmd_buffer_ptrs.at(n_job) = cmd_buffer_ptr;
+    }
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::set_imported_image(Anvil::RenderGraphResourceID in_resource_id,
+                                            Anvil::Image*                in_image_ptr)
+{
+    VkExtent2D extent;
+    bool       result = false;
+
+    if (in_resource_id >= m_resources.size()             ||
+        in_image_ptr   == nullptr                        ||
+        !m_resources.at(in_resource_id).is_imported      ||
+        !m_resources.at(in_resource_id).is_image)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    extent = in_image_ptr->get_image_extent_2D(0 /* in_n_mipmap */);
+
+    {
+        auto& current_resource = m_resources.at(in_resource_id);
+
+        if (current_resource.format       != in_image_ptr->get_create_info_ptr()->get_format      () ||
+            current_resource.height       != extent.height                                            ||
+            current_resource.sample_count != in_image_ptr->get_create_info_ptr()->get_sample_count() ||
+            current_resource.width        != extent.width)
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        current_resource.image_ptr = in_image_ptr;
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/** Entry-point of worker threads. Waits for record() to hand over passes to record, and records them. */
+void Anvil::RenderGraph::worker_thread_entrypoint(uint32_t in_n_thread)
+{
+    uint64_t n_last_generation = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_jobs_mutex);
+
+            m_jobs_cv.wait(lock,
+                           [this, &n_last_generation]()
+                           {
+                               return m_workers_should_quit || m_jobs_generation != n_last_generation;
+                           });
+
+            if (m_workers_should_quit)
+            {
+                break;
+            }
+
+            n_last_generation = m_jobs_generation;
+        }
+
+        record_passes(in_n_thread);
+
+        {
+            std::unique_lock<std::mutex> lock(m_jobs_mutex);
+
+            --m_n_busy_workers;
+        }
+
+        /* Wake up the thread waiting in record() */
+        m_jobs_cv.notify_all();
+    }
+}
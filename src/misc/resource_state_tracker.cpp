@@ -0,0 +1,806 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/image_create_info.h"
+#include "misc/resource_state_tracker.h"
+#include "wrappers/buffer.h"
+#include "wrappers/device.h"
+#include "wrappers/image.h"
+
+
+/* Access types which modify the contents of a resource. */
+static const Anvil::AccessFlags g_write_access_mask = Anvil::AccessFlagBits::COLOR_ATTACHMENT_WRITE_BIT               |
+                                                      Anvil::AccessFlagBits::DEPTH_STENCIL_ATTACHMENT_WRITE_BIT       |
+                                                      Anvil::AccessFlagBits::HOST_WRITE_BIT                           |
+                                                      Anvil::AccessFlagBits::MEMORY_WRITE_BIT                         |
+                                                      Anvil::AccessFlagBits::SHADER_WRITE_BIT                         |
+                                                      Anvil::AccessFlagBits::TRANSFER_WRITE_BIT                       |
+                                                      Anvil::AccessFlagBits::TRANSFORM_FEEDBACK_COUNTER_WRITE_BIT_EXT |
+                                                      Anvil::AccessFlagBits::TRANSFORM_FEEDBACK_WRITE_BIT_EXT;
+
+/** Updates @param inout_state_ptr with the state a resource is left in after it is accessed in the specified
+ *  way, and tells whether a barrier needs to be recorded before the access.
+ *
+ *  @param out_src_stage_mask_ptr  If the function returns true, deref will be set to the source stage mask
+ *                                 the barrier should use.
+ *  @param out_src_access_mask_ptr If the function returns true, deref will be set to the source access mask
+ *                                 the barrier should use.
+ **/
+static bool transition(Anvil::ResourceAccessState* inout_state_ptr,
+                       Anvil::ImageLayout          in_layout,
+                       Anvil::PipelineStageFlags   in_stage_mask,
+                       Anvil::AccessFlags          in_access_mask,
+                       Anvil::PipelineStageFlags*  out_src_stage_mask_ptr,
+                       Anvil::AccessFlags*         out_src_access_mask_ptr)
+{
+    const bool               is_layout_change  = (inout_state_ptr->layout != in_layout);
+    bool                     result            = false;
+    const Anvil::AccessFlags write_access_mask = (in_access_mask & g_write_access_mask);
+
+    if (is_layout_change || write_access_mask != 0)
+    {
+        /* Layout transitions and writes must not start before all preceding accesses finish (WAR and WAW hazards) */
+        *out_src_access_mask_ptr = inout_state_ptr->write_access;
+        *out_src_stage_mask_ptr  = inout_state_ptr->write_stages | inout_state_ptr->read_stages;
+
+        if (is_layout_change)
+        {
+            if (*out_src_stage_mask_ptr == 0)
+            {
+                *out_src_stage_mask_ptr = Anvil::PipelineStageFlagBits::TOP_OF_PIPE_BIT;
+            }
+
+            result = true;
+        }
+        else
+        {
+            result = (*out_src_stage_mask_ptr != 0);
+        }
+
+        inout_state_ptr->layout = in_layout;
+
+        if (write_access_mask != 0)
+        {
+            inout_state_ptr->read_stages    = Anvil::PipelineStageFlagBits::NONE;
+            inout_state_ptr->visible_access = Anvil::AccessFlagBits::NONE;
+            inout_state_ptr->visible_stages = Anvil::PipelineStageFlagBits::NONE;
+            inout_state_ptr->write_access   = write_access_mask;
+            inout_state_ptr->write_stages   = in_stage_mask;
+        }
+        else
+        {
+            /* Layout transition is made available by the barrier itself, and visible to the requested access. Any
+             * later access needs to wait for the stages the transition has been made visible to.
+             */
+            inout_state_ptr->read_stages    = in_stage_mask;
+            inout_state_ptr->visible_access = in_access_mask;
+            inout_state_ptr->visible_stages = in_stage_mask;
+            inout_state_ptr->write_access   = Anvil::AccessFlagBits::NONE;
+            inout_state_ptr->write_stages   = in_stage_mask;
+        }
+    }
+    else
+    {
+        /* Reads only need a barrier if the last write has not been made visible to them yet (RAW hazard) */
+        if (inout_state_ptr->write_stages != 0                                       &&
+            ((inout_state_ptr->visible_stages & in_stage_mask)  != in_stage_mask      ||
+             (inout_state_ptr->visible_access & in_access_mask) != in_access_mask) )
+        {
+            *out_src_access_mask_ptr = inout_state_ptr->write_access;
+            *out_src_stage_mask_ptr  = inout_state_ptr->write_stages;
+            result                   = true;
+
+            inout_state_ptr->visible_access |= in_access_mask;
+            inout_state_ptr->visible_stages |= in_stage_mask;
+        }
+
+        inout_state_ptr->read_stages |= in_stage_mask;
+    }
+
+    return result;
+}
+
+/** Constructor. */
+Anvil::ResourceStateTracker::ResourceStateTracker()
+{
+    /* Stub */
+}
+
+/** Destructor */
+Anvil::ResourceStateTracker::~ResourceStateTracker()
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+void Anvil::ResourceStateTracker::PendingStates::clear()
+{
+    m_buffer_states.clear();
+    m_image_states.clear ();
+}
+
+/** Returns pending state of the specified buffer. If the buffer has no pending state yet, it is initialized with
+ *  the global state of the buffer.
+ **/
+Anvil::ResourceAccessState& Anvil::ResourceStateTracker::PendingStates::get_buffer_state(Anvil::Buffer* in_buffer_ptr)
+{
+    auto iterator = m_buffer_states.find(in_buffer_ptr);
+
+    if (iterator == m_buffer_states.end() )
+    {
+        iterator = m_buffer_states.emplace(in_buffer_ptr,
+                                           in_buffer_ptr->m_tracked_state).first;
+    }
+
+    return iterator->second;
+}
+
+/** Returns pending states of all subresources of the specified image, indexed the same way global states are.
+ *  If the image has no pending states yet, they are initialized with the global states of the image.
+ **/
+std::vector<Anvil::ResourceAccessState>& Anvil::ResourceStateTracker::PendingStates::get_image_states(Anvil::Image* in_image_ptr)
+{
+    auto iterator = m_image_states.find(in_image_ptr);
+
+    if (iterator == m_image_states.end() )
+    {
+        iterator = m_image_states.emplace(in_image_ptr,
+                                          ResourceStateTracker::get_image_states(in_image_ptr) ).first;
+    }
+
+    return iterator->second;
+}
+
+/* Please see header for specification */
+void Anvil::ResourceStateTracker::PendingStates::publish()
+{
+    for (auto& current_buffer_state : m_buffer_states)
+    {
+        current_buffer_state.first->m_tracked_state = current_buffer_state.second;
+    }
+
+    for (auto& current_image_states : m_image_states)
+    {
+        current_image_states.first->m_tracked_subresource_states.swap(current_image_states.second);
+    }
+
+    clear();
+}
+
+/* Please see header for specification */
+void Anvil::ResourceStateTracker::PendingStates::set_image_state(Anvil::Image*                       in_image_ptr,
+                                                                 const Anvil::ImageSubresourceRange& in_subresource_range,
+                                                                 const Anvil::ResourceAccessState&   in_state)
+{
+    ResourceStateTracker::set_subresource_states(in_image_ptr,
+                                                 in_subresource_range,
+                                                 in_state,
+                                                &get_image_states(in_image_ptr) );
+}
+
+/* Please see header for specification */
+void Anvil::ResourceStateTracker::append(const Anvil::ResourceStateTracker& in_tracker,
+                                         Anvil::PipelineStageFlags*         inout_src_stage_mask_ptr,
+                                         Anvil::PipelineStageFlags*         inout_dst_stage_mask_ptr,
+                                         std::vector<Anvil::BufferBarrier>* out_buffer_barriers_ptr,
+                                         std::vector<Anvil::ImageBarrier>*  out_image_barriers_ptr)
+{
+    anvil_assert(&in_tracker != this);
+
+    for (const auto& current_buffer_track : in_tracker.m_buffer_tracks)
+    {
+        const auto& src_track   = current_buffer_track.second;
+        auto&       track       = m_buffer_tracks[current_buffer_track.first];
+        auto        src_access  = Anvil::AccessFlags       ();
+        auto        src_stages  = Anvil::PipelineStageFlags();
+
+        if (use(Anvil::ImageLayout::UNDEFINED,
+                src_track.first_stage_mask,
+                src_track.first_access_mask,
+               &track,
+               &src_stages,
+               &src_access) )
+        {
+            *inout_src_stage_mask_ptr |= src_stages;
+            *inout_dst_stage_mask_ptr |= src_track.first_stage_mask;
+
+            out_buffer_barriers_ptr->push_back(
+                Anvil::BufferBarrier(src_access,
+                                     src_track.first_access_mask,
+                                     VK_QUEUE_FAMILY_IGNORED,
+                                     VK_QUEUE_FAMILY_IGNORED,
+                                     current_buffer_track.first,
+                                     0, /* in_offset */
+                                     VK_WHOLE_SIZE)
+            );
+        }
+
+        if (!src_track.is_first_access_open)
+        {
+            track.current_state        = src_track.current_state;
+            track.is_first_access_open = false;
+        }
+    }
+
+    for (const auto& current_image_track : in_tracker.m_image_tracks)
+    {
+        auto        image_ptr  = current_image_track.first;
+        const auto& src_tracks = current_image_track.second;
+        auto&       tracks     = m_image_tracks[image_ptr];
+        const auto  n_mips     = image_ptr->get_n_mipmaps();
+
+        if (tracks.size() == 0)
+        {
+            tracks.resize(src_tracks.size() );
+        }
+
+        m_subresource_barriers.clear();
+
+        for (uint32_t n_track = 0;
+                      n_track < static_cast<uint32_t>(src_tracks.size() );
+                    ++n_track)
+        {
+            const auto& src_track  = src_tracks.at(n_track);
+            auto&       track      = tracks.at    (n_track);
+            const auto  old_layout = track.current_state.layout;
+            auto        src_access = Anvil::AccessFlags       ();
+            auto        src_stages = Anvil::PipelineStageFlags();
+
+            if (!src_track.is_used)
+            {
+                continue;
+            }
+
+            if (use(src_track.first_layout,
+                    src_track.first_stage_mask,
+                    src_track.first_access_mask,
+                   &track,
+                   &src_stages,
+                   &src_access) )
+            {
+                SubresourceBarrier barrier;
+
+                barrier.dst_access_mask = src_track.first_access_mask;
+                barrier.n_layer         = n_track / n_mips;
+                barrier.n_layers        = 1;
+                barrier.n_mip           = n_track % n_mips;
+                barrier.n_mips          = 1;
+                barrier.new_layout      = src_track.first_layout;
+                barrier.old_layout      = old_layout;
+                barrier.src_access_mask = src_access;
+
+                m_subresource_barriers.push_back(barrier);
+
+                *inout_src_stage_mask_ptr |= src_stages;
+                *inout_dst_stage_mask_ptr |= src_track.first_stage_mask;
+            }
+
+            if (!src_track.is_first_access_open)
+            {
+                track.current_state        = src_track.current_state;
+                track.is_first_access_open = false;
+            }
+        }
+
+        bake_image_barriers(image_ptr,
+                            out_image_barriers_ptr);
+    }
+}
+
+/** Coalesces barriers stored in m_subresource_barriers into as few image barriers as possible, and appends them to
+ *  @param out_image_barriers_ptr.
+ *
+ *  Subresource barriers are expected to be sorted by layer index, then by mip index.
+ **/
+void Anvil::ResourceStateTracker::bake_image_barriers(Anvil::Image*                     in_image_ptr,
+                                                      std::vector<Anvil::ImageBarrier>* out_image_barriers_ptr)
+{
+    const auto aspect_mask = in_image_ptr->get_subresource_range().aspect_mask;
+    uint32_t   n_runs      = 0;
+
+    if (m_subresource_barriers.size() == 0)
+    {
+        goto end;
+    }
+
+    /* 1. Merge barriers for consecutive mips of the same layer. */
+    for (uint32_t n_barrier = 0;
+                  n_barrier < static_cast<uint32_t>(m_subresource_barriers.size() );
+                ++n_barrier)
+    {
+        const auto& current_barrier = m_subresource_barriers.at(n_barrier);
+
+        if (n_runs > 0)
+        {
+            auto& last_run = m_subresource_barriers.at(n_runs - 1);
+
+            if (last_run.n_layer                   == current_barrier.n_layer         &&
+                last_run.n_mip + last_run.n_mips   == current_barrier.n_mip           &&
+                last_run.dst_access_mask           == current_barrier.dst_access_mask &&
+                last_run.new_layout                == current_barrier.new_layout      &&
+                last_run.old_layout                == current_barrier.old_layout      &&
+                last_run.src_access_mask           == current_barrier.src_access_mask)
+            {
+                ++last_run.n_mips;
+
+                continue;
+            }
+        }
+
+        m_subresource_barriers.at(n_runs++) = current_barrier;
+    }
+
+    m_subresource_barriers.resize(n_runs);
+
+    /* 2. Merge runs which cover the same mips of consecutive layers. */
+    n_runs = 0;
+
+    for (uint32_t n_barrier = 0;
+                  n_barrier < static_cast<uint32_t>(m_subresource_barriers.size() );
+                ++n_barrier)
+    {
+        const auto& current_run = m_subresource_barriers.at(n_barrier);
+        bool        has_merged  = false;
+
+        for (uint32_t n_run = n_runs;
+                      n_run > 0;
+                    --n_run)
+        {
+            auto& candidate_run = m_subresource_barriers.at(n_run - 1);
+
+            if (candidate_run.n_layer + candidate_run.n_layers == current_run.n_layer         &&
+                candidate_run.n_mip                            == current_run.n_mip           &&
+                candidate_run.n_mips                           == current_run.n_mips          &&
+                candidate_run.dst_access_mask                  == current_run.dst_access_mask &&
+                candidate_run.new_layout                       == current_run.new_layout      &&
+                candidate_run.old_layout                       == current_run.old_layout      &&
+                candidate_run.src_access_mask                  == current_run.src_access_mask)
+            {
+                ++candidate_run.n_layers;
+
+                has_merged = true;
+                break;
+            }
+        }
+
+        if (!has_merged)
+        {
+            m_subresource_barriers.at(n_runs++) = current_run;
+        }
+    }
+
+    m_subresource_barriers.resize(n_runs);
+
+    /* 3. Convert the runs to image barriers */
+    for (const auto& current_run : m_subresource_barriers)
+    {
+        Anvil::ImageSubresourceRange range;
+
+        range.aspect_mask      = aspect_mask;
+        range.base_array_layer = current_run.n_layer;
+        range.base_mip_level   = current_run.n_mip;
+        range.layer_count      = current_run.n_layers;
+        range.level_count      = current_run.n_mips;
+
+        out_image_barriers_ptr->push_back(
+            Anvil::ImageBarrier(current_run.src_access_mask,
+                                current_run.dst_access_mask,
+                                current_run.old_layout,
+                                current_run.new_layout,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                in_image_ptr,
+                                range)
+        );
+    }
+
+    m_subresource_barriers.clear();
+
+end:
+    ;
+}
+
+/* Please see header for specification */
+Anvil::ResourceStateTrackerUniquePtr Anvil::ResourceStateTracker::create()
+{
+    Anvil::ResourceStateTrackerUniquePtr result_ptr(new ResourceStateTracker(),
+                                                    std::default_delete<ResourceStateTracker>() );
+
+    return result_ptr;
+}
+
+/** Returns global states of all subresources of the specified image, indexed by (n_layer * n_mips + n_mip).
+ *
+ *  Subresource states are lazily initialized with the layout the image has been created with.
+ **/
+std::vector<Anvil::ResourceAccessState>& Anvil::ResourceStateTracker::get_image_states(Anvil::Image* in_image_ptr)
+{
+    auto& result = in_image_ptr->m_tracked_subresource_states;
+
+    if (result.size() == 0)
+    {
+        const auto create_info_ptr = in_image_ptr->get_create_info_ptr();
+
+        result.resize(create_info_ptr->get_n_layers() * in_image_ptr->get_n_mipmaps(),
+                      Anvil::ResourceAccessState(create_info_ptr->get_post_create_image_layout() ));
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::ResourceStateTracker::reset()
+{
+    m_buffer_tracks.clear();
+    m_image_tracks.clear ();
+}
+
+/* Please see header for specification */
+void Anvil::ResourceStateTracker::resolve(PendingStates*                     inout_pending_states_ptr,
+                                          Anvil::PipelineStageFlags*         inout_src_stage_mask_ptr,
+                                          Anvil::PipelineStageFlags*         inout_dst_stage_mask_ptr,
+                                          std::vector<Anvil::BufferBarrier>* out_buffer_barriers_ptr,
+                                          std::vector<Anvil::ImageBarrier>*  out_image_barriers_ptr)
+{
+    for (const auto& current_buffer_track : m_buffer_tracks)
+    {
+        auto        buffer_ptr = current_buffer_track.first;
+        auto&       state      = inout_pending_states_ptr->get_buffer_state(buffer_ptr);
+        const auto& track      = current_buffer_track.second;
+        auto        src_access = Anvil::AccessFlags       ();
+        auto        src_stages = Anvil::PipelineStageFlags();
+
+        if (transition(&state,
+                       Anvil::ImageLayout::UNDEFINED,
+                       track.first_stage_mask,
+                       track.first_access_mask,
+                      &src_stages,
+                      &src_access) )
+        {
+            *inout_src_stage_mask_ptr |= src_stages;
+            *inout_dst_stage_mask_ptr |= track.first_stage_mask;
+
+            out_buffer_barriers_ptr->push_back(
+                Anvil::BufferBarrier(src_access,
+                                     track.first_access_mask,
+                                     VK_QUEUE_FAMILY_IGNORED,
+                                     VK_QUEUE_FAMILY_IGNORED,
+                                     buffer_ptr,
+                                     0, /* in_offset */
+                                     VK_WHOLE_SIZE)
+            );
+        }
+
+        if (!track.is_first_access_open)
+        {
+            state = track.current_state;
+        }
+    }
+
+    for (const auto& current_image_track : m_image_tracks)
+    {
+        auto        image_ptr = current_image_track.first;
+        const auto  n_mips    = image_ptr->get_n_mipmaps();
+        auto&       states    = inout_pending_states_ptr->get_image_states(image_ptr);
+        const auto& tracks    = current_image_track.second;
+
+        anvil_assert(states.size() == tracks.size() );
+
+        m_subresource_barriers.clear();
+
+        for (uint32_t n_track = 0;
+                      n_track < static_cast<uint32_t>(tracks.size() );
+                    ++n_track)
+        {
+            auto&       state      = states.at(n_track);
+            const auto  old_layout = state.layout;
+            auto        src_access = Anvil::AccessFlags       ();
+            auto        src_stages = Anvil::PipelineStageFlags();
+            const auto& track      = tracks.at(n_track);
+
+            if (!track.is_used)
+            {
+                continue;
+            }
+
+            if (old_layout == Anvil::ImageLayout::PRESENT_SRC_KHR)
+            {
+                /* Presentation engine accesses are not tracked. Make sure the barrier chains with whichever stage
+                 * the swapchain image acquisition semaphore is waited on at.
+                 */
+                state.write_stages = Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT;
+            }
+
+            if (transition(&state,
+                           track.first_layout,
+                           track.first_stage_mask,
+                           track.first_access_mask,
+                          &src_stages,
+                          &src_access) )
+            {
+                SubresourceBarrier barrier;
+
+                barrier.dst_access_mask = track.first_access_mask;
+                barrier.n_layer         = n_track / n_mips;
+                barrier.n_layers        = 1;
+                barrier.n_mip           = n_track % n_mips;
+                barrier.n_mips          = 1;
+                barrier.new_layout      = track.first_layout;
+                barrier.old_layout      = old_layout;
+                barrier.src_access_mask = src_access;
+
+                m_subresource_barriers.push_back(barrier);
+
+                *inout_src_stage_mask_ptr |= src_stages;
+                *inout_dst_stage_mask_ptr |= track.first_stage_mask;
+            }
+
+            if (!track.is_first_access_open)
+            {
+                state = track.current_state;
+            }
+        }
+
+        bake_image_barriers(image_ptr,
+                            out_image_barriers_ptr);
+    }
+}
+
+/* Please see header for specification */
+void Anvil::ResourceStateTracker::set_image_layout(Anvil::Image*                       in_image_ptr,
+                                                   const Anvil::ImageSubresourceRange& in_subresource_range,
+                                                   Anvil::ImageLayout                  in_layout)
+{
+    auto mutex_ptr = in_image_ptr->get_create_info_ptr()->get_device()->get_resource_state_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_ptr->lock();
+    }
+
+    set_subresource_states(in_image_ptr,
+                           in_subresource_range,
+                           Anvil::ResourceAccessState(in_layout),
+                          &get_image_states(in_image_ptr) );
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_ptr->unlock();
+    }
+}
+
+/** Sets states of the specified range of image subresources to @param in_state.
+ *
+ *  @param inout_states_ptr Subresource states of @param in_image_ptr to modify, indexed the same way global states are.
+ *                          Must not be nullptr.
+ **/
+void Anvil::ResourceStateTracker::set_subresource_states(Anvil::Image*                       in_image_ptr,
+                                                         const Anvil::ImageSubresourceRange& in_subresource_range,
+                                                         const Anvil::ResourceAccessState&   in_state,
+                                                         std::vector<ResourceAccessState>*   inout_states_ptr)
+{
+    const uint32_t n_mips   = in_image_ptr->get_n_mipmaps();
+    const uint32_t n_layers = in_image_ptr->get_create_info_ptr()->get_n_layers();
+
+    const uint32_t layer_count = (in_subresource_range.layer_count == VK_REMAINING_ARRAY_LAYERS) ? n_layers - in_subresource_range.base_array_layer
+                                                                                                 : in_subresource_range.layer_count;
+    const uint32_t level_count = (in_subresource_range.level_count == VK_REMAINING_MIP_LEVELS)   ? n_mips   - in_subresource_range.base_mip_level
+                                                                                                 : in_subresource_range.level_count;
+
+    anvil_assert(in_subresource_range.base_array_layer + layer_count <= n_layers);
+    anvil_assert(in_subresource_range.base_mip_level   + level_count <= n_mips);
+
+    for (uint32_t n_layer = in_subresource_range.base_array_layer;
+                  n_layer < in_subresource_range.base_array_layer + layer_count;
+                ++n_layer)
+    {
+        for (uint32_t n_mip = in_subresource_range.base_mip_level;
+                      n_mip < in_subresource_range.base_mip_level + level_count;
+                    ++n_mip)
+        {
+            inout_states_ptr->at(n_layer * n_mips + n_mip) = in_state;
+        }
+    }
+}
+
+/** Records a single resource usage in @param inout_track_ptr.
+ *
+ *  @return true if a barrier needs to be recorded before the access. In this case, @param out_src_stage_mask_ptr
+ *          and @param out_src_access_mask_ptr are set to source masks the barrier should use.
+ **/
+bool Anvil::ResourceStateTracker::use(Anvil::ImageLayout         in_layout,
+                                      Anvil::PipelineStageFlags  in_stage_mask,
+                                      Anvil::AccessFlags         in_access_mask,
+                                      Track*                     inout_track_ptr,
+                                      Anvil::PipelineStageFlags* out_src_stage_mask_ptr,
+                                      Anvil::AccessFlags*        out_src_access_mask_ptr)
+{
+    const Anvil::AccessFlags write_access_mask = (in_access_mask & g_write_access_mask);
+    bool                     result            = false;
+
+    if (!inout_track_ptr->is_used)
+    {
+        auto& state = inout_track_ptr->current_state;
+
+        /* First use. The resource is going to be brought to the requested state at submission time. */
+        inout_track_ptr->first_access_mask    = in_access_mask;
+        inout_track_ptr->first_layout         = in_layout;
+        inout_track_ptr->first_stage_mask     = in_stage_mask;
+        inout_track_ptr->is_first_access_open = (write_access_mask == 0);
+        inout_track_ptr->is_used              = true;
+
+        state = Anvil::ResourceAccessState(in_layout);
+
+        if (write_access_mask != 0)
+        {
+            state.write_access = write_access_mask;
+            state.write_stages = in_stage_mask;
+        }
+        else
+        {
+            state.read_stages    = in_stage_mask;
+            state.visible_access = in_access_mask;
+            state.visible_stages = in_stage_mask;
+            state.write_stages   = in_stage_mask;
+        }
+    }
+    else
+    if (inout_track_ptr->is_first_access_open              &&
+        inout_track_ptr->first_layout         == in_layout &&
+        write_access_mask                     == 0)
+    {
+        auto& state = inout_track_ptr->current_state;
+
+        /* No write has been recorded yet. Fold the read into the requirement. */
+        inout_track_ptr->first_access_mask |= in_access_mask;
+        inout_track_ptr->first_stage_mask  |= in_stage_mask;
+
+        state.read_stages    |= in_stage_mask;
+        state.visible_access |= in_access_mask;
+        state.visible_stages |= in_stage_mask;
+    }
+    else
+    {
+        inout_track_ptr->is_first_access_open = false;
+
+        result = transition(&inout_track_ptr->current_state,
+                            in_layout,
+                            in_stage_mask,
+                            in_access_mask,
+                            out_src_stage_mask_ptr,
+                            out_src_access_mask_ptr);
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::ResourceStateTracker::use_buffer(Anvil::Buffer*                     in_buffer_ptr,
+                                             Anvil::PipelineStageFlags          in_stage_mask,
+                                             Anvil::AccessFlags                 in_access_mask,
+                                             Anvil::PipelineStageFlags*         inout_src_stage_mask_ptr,
+                                             Anvil::PipelineStageFlags*         inout_dst_stage_mask_ptr,
+                                             std::vector<Anvil::BufferBarrier>* out_buffer_barriers_ptr)
+{
+    auto src_access = Anvil::AccessFlags       ();
+    auto src_stages = Anvil::PipelineStageFlags();
+
+    anvil_assert(in_buffer_ptr != nullptr);
+    anvil_assert(in_stage_mask != 0);
+
+    if (use(Anvil::ImageLayout::UNDEFINED,
+            in_stage_mask,
+            in_access_mask,
+           &m_buffer_tracks[in_buffer_ptr],
+           &src_stages,
+           &src_access) )
+    {
+        *inout_src_stage_mask_ptr |= src_stages;
+        *inout_dst_stage_mask_ptr |= in_stage_mask;
+
+        out_buffer_barriers_ptr->push_back(
+            Anvil::BufferBarrier(src_access,
+                                 in_access_mask,
+                                 VK_QUEUE_FAMILY_IGNORED,
+                                 VK_QUEUE_FAMILY_IGNORED,
+                                 in_buffer_ptr,
+                                 0, /* in_offset */
+                                 VK_WHOLE_SIZE)
+        );
+    }
+}
+
+/* Please see header for specification */
+void Anvil::ResourceStateTracker::use_image(Anvil::Image*                       in_image_ptr,
+                                            const Anvil::ImageSubresourceRange& in_subresource_range,
+                                            Anvil::ImageLayout                  in_layout,
+                                            Anvil::PipelineStageFlags           in_stage_mask,
+                                            Anvil::AccessFlags                  in_access_mask,
+                                            Anvil::PipelineStageFlags*          inout_src_stage_mask_ptr,
+                                            Anvil::PipelineStageFlags*          inout_dst_stage_mask_ptr,
+                                            std::vector<Anvil::ImageBarrier>*   out_image_barriers_ptr)
+{
+    anvil_assert(in_image_ptr  != nullptr);
+    anvil_assert(in_stage_mask != 0);
+
+    const uint32_t n_mips   = in_image_ptr->get_n_mipmaps();
+    const uint32_t n_layers = in_image_ptr->get_create_info_ptr()->get_n_layers();
+    auto&          tracks   = m_image_tracks[in_image_ptr];
+
+    const uint32_t layer_count = (in_subresource_range.layer_count == VK_REMAINING_ARRAY_LAYERS) ? n_layers - in_subresource_range.base_array_layer
+                                                                                                 : in_subresource_range.layer_count;
+    const uint32_t level_count = (in_subresource_range.level_count == VK_REMAINING_MIP_LEVELS)   ? n_mips   - in_subresource_range.base_mip_level
+                                                                                                 : in_subresource_range.level_count;
+
+    anvil_assert(in_subresource_range.base_array_layer + layer_count <= n_layers);
+    anvil_assert(in_subresource_range.base_mip_level   + level_count <= n_mips);
+
+    if (tracks.size() == 0)
+    {
+        tracks.resize(n_layers * n_mips);
+    }
+
+    m_subresource_barriers.clear();
+
+    for (uint32_t n_layer = in_subresource_range.base_array_layer;
+                  n_layer < in_subresource_range.base_array_layer + layer_count;
+                ++n_layer)
+    {
+        for (uint32_t n_mip = in_subresource_range.base_mip_level;
+                      n_mip < in_subresource_range.base_mip_level + level_count;
+                    ++n_mip)
+        {
+            auto&      track      = tracks.at(n_layer * n_mips + n_mip);
+            const auto old_layout = track.current_state.layout;
+            auto       src_access = Anvil::AccessFlags       ();
+            auto       src_stages = Anvil::PipelineStageFlags();
+
+            if (use(in_layout,
+                    in_stage_mask,
+                    in_access_mask,
+                   &track,
+                   &src_stages,
+                   &src_access) )
+            {
+                SubresourceBarrier barrier;
+
+                barrier.dst_access_mask = in_access_mask;
+                barrier.n_layer         = n_layer;
+                barrier.n_layers        = 1;
+                barrier.n_mip           = n_mip;
+                barrier.n_mips          = 1;
+                barrier.new_layout      = in_layout;
+                barrier.old_layout      = old_layout;
+                barrier.src_access_mask = src_access;
+
+                m_subresource_barriers.push_back(barrier);
+
+                *inout_src_stage_mask_ptr |= src_stages;
+                *inout_dst_stage_mask_ptr |= in_stage_mask;
+            }
+        }
+    }
+
+    bake_image_barriers(in_image_ptr,
+                        out_image_barriers_ptr);
+}
@@ -0,0 +1,393 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/object_tracker.h"
+#include "misc/sampler_cache.h"
+#include "misc/sampler_create_info.h"
+#include "misc/sampler_ycbcr_conversion_create_info.h"
+#include "wrappers/sampler.h"
+#include "wrappers/sampler_ycbcr_conversion.h"
+#include <functional>
+
+
+/** Constructor. */
+Anvil::SamplerCache::SamplerCache(const Anvil::BaseDevice* in_device_ptr,
+                                  bool                     in_mt_safe)
+    :MTSafetySupportProvider(in_mt_safe),
+     m_device_ptr           (in_device_ptr),
+     m_n_live_samplers      (0),
+     m_n_hits               (0),
+     m_n_misses             (0)
+{
+    /* Register the object */
+    Anvil::ObjectTracker::get()->register_object(Anvil::ObjectType::ANVIL_SAMPLER_CACHE,
+                                                  this);
+}
+
+/** Destructor */
+Anvil::SamplerCache::~SamplerCache()
+{
+    /* All samplers handed out by the cache must have been released by the time the device goes down */
+    anvil_assert(m_n_live_samplers == 0);
+
+    /* Unregister the object */
+    Anvil::ObjectTracker::get()->unregister_object(Anvil::ObjectType::ANVIL_SAMPLER_CACHE,
+                                                    this);
+}
+
+/** Creates a new SamplerCreateInfo instance, holding the same state as @param in_create_info_ptr.
+ *
+ *  The cloned structure is owned by the cached sampler, so that the caller is free to release
+ *  or modify the original structure after get_sampler() returns.
+ **/
+Anvil::SamplerCreateInfoUniquePtr Anvil::SamplerCache::clone_create_info(const Anvil::SamplerCreateInfo* in_create_info_ptr) const
+{
+    Anvil::SamplerCreateInfoUniquePtr result_ptr;
+
+    result_ptr = Anvil::SamplerCreateInfo::create(m_device_ptr,
+                                                  in_create_info_ptr->get_mag_filter                (),
+                                                  in_create_info_ptr->get_min_filter                (),
+                                                  in_create_info_ptr->get_mipmap_mode               (),
+                                                  in_create_info_ptr->get_address_mode_u            (),
+                                                  in_create_info_ptr->get_address_mode_v            (),
+                                                  in_create_info_ptr->get_address_mode_w            (),
+                                                  in_create_info_ptr->get_lod_bias                  (),
+                                                  in_create_info_ptr->get_max_anisotropy            (),
+                                                  in_create_info_ptr->is_compare_enabled            (),
+                                                  in_create_info_ptr->get_compare_op                (),
+                                                  in_create_info_ptr->get_min_lod                   (),
+                                                  in_create_info_ptr->get_max_lod                   (),
+                                                  in_create_info_ptr->get_border_color              (),
+                                                  in_create_info_ptr->uses_unnormalized_coordinates (),
+                                                  Anvil::Utils::convert_boolean_to_mt_safety_enum(is_mt_safe() ));
+
+    if (result_ptr != nullptr)
+    {
+        result_ptr->set_sampler_reduction_mode      (in_create_info_ptr->get_sampler_reduction_mode      () );
+        result_ptr->set_sampler_ycbcr_conversion_ptr(in_create_info_ptr->get_sampler_ycbcr_conversion_ptr() );
+    }
+
+    return result_ptr;
+}
+
+/** Creates a new SamplerYCbCrConversionCreateInfo instance, holding the same state as the Y'CbCr conversion
+ *  attached to @param in_create_info_ptr.
+ *
+ *  @return New structure, or nullptr if no conversion is attached to @param in_create_info_ptr.
+ **/
+Anvil::SamplerYCbCrConversionCreateInfoUniquePtr Anvil::SamplerCache::clone_ycbcr_conversion_create_info(const Anvil::SamplerCreateInfo* in_create_info_ptr) const
+{
+    const auto                                       ycbcr_conversion_ptr = in_create_info_ptr->get_sampler_ycbcr_conversion_ptr();
+    Anvil::SamplerYCbCrConversionCreateInfoUniquePtr result_ptr;
+
+    if (ycbcr_conversion_ptr != nullptr)
+    {
+        const auto conversion_create_info_ptr = ycbcr_conversion_ptr->get_create_info_ptr();
+
+        result_ptr = Anvil::SamplerYCbCrConversionCreateInfo::create(conversion_create_info_ptr->get_device                          (),
+                                                                     conversion_create_info_ptr->get_format                          (),
+                                                                     conversion_create_info_ptr->get_ycbcr_model_conversion          (),
+                                                                     conversion_create_info_ptr->get_ycbcr_range                     (),
+                                                                     conversion_create_info_ptr->get_components                      (),
+                                                                     conversion_create_info_ptr->get_x_chroma_offset                 (),
+                                                                     conversion_create_info_ptr->get_y_chroma_offset                 (),
+                                                                     conversion_create_info_ptr->get_chroma_filter                   (),
+                                                                     conversion_create_info_ptr->should_force_explicit_reconstruction(),
+                                                                     conversion_create_info_ptr->get_mt_safety                       () );
+
+        anvil_assert(result_ptr != nullptr);
+    }
+
+    return result_ptr;
+}
+
+/* Please see header for specification */
+Anvil::SamplerCacheUniquePtr Anvil::SamplerCache::create(const Anvil::BaseDevice* in_device_ptr,
+                                                         bool                     in_mt_safe)
+{
+    SamplerCacheUniquePtr result_ptr(nullptr,
+                                     std::default_delete<SamplerCache>() );
+
+    result_ptr.reset(
+        new Anvil::SamplerCache(in_device_ptr,
+                                in_mt_safe)
+    );
+
+    anvil_assert(result_ptr != nullptr);
+    return result_ptr;
+}
+
+/** Computes a hash value for the specified sampler create info structure. All sampler state is taken into
+ *  account, including properties of the Y'CbCr conversion object, if one is attached.
+ **/
+size_t Anvil::SamplerCache::get_hash(const Anvil::SamplerCreateInfo* in_create_info_ptr)
+{
+    std::hash<float>    hash_float;
+    std::hash<uint32_t> hash_uint32;
+    size_t              result_hash      = 0;
+    const auto          ycbcr_conversion = in_create_info_ptr->get_sampler_ycbcr_conversion_ptr();
+
+    auto hash_combine = [&result_hash](const size_t& in_hash)
+    {
+        result_hash ^= in_hash + 0x9e3779b9 + (result_hash << 6) + (result_hash >> 2);
+    };
+
+    hash_combine(hash_uint32(static_cast<uint32_t>(in_create_info_ptr->get_address_mode_u        () )));
+    hash_combine(hash_uint32(static_cast<uint32_t>(in_create_info_ptr->get_address_mode_v        () )));
+    hash_combine(hash_uint32(static_cast<uint32_t>(in_create_info_ptr->get_address_mode_w        () )));
+    hash_combine(hash_uint32(static_cast<uint32_t>(in_create_info_ptr->get_border_color          () )));
+    hash_combine(hash_uint32(static_cast<uint32_t>(in_create_info_ptr->get_compare_op            () )));
+    hash_combine(hash_uint32(static_cast<uint32_t>(in_create_info_ptr->get_mag_filter            () )));
+    hash_combine(hash_uint32(static_cast<uint32_t>(in_create_info_ptr->get_min_filter            () )));
+    hash_combine(hash_uint32(static_cast<uint32_t>(in_create_info_ptr->get_mipmap_mode           () )));
+    hash_combine(hash_uint32(static_cast<uint32_t>(in_create_info_ptr->get_sampler_reduction_mode() )));
+    hash_combine(hash_uint32(in_create_info_ptr->is_compare_enabled           () ? 1u : 0u) );
+    hash_combine(hash_uint32(in_create_info_ptr->uses_unnormalized_coordinates() ? 1u : 0u) );
+    hash_combine(hash_float (in_create_info_ptr->get_lod_bias                 () ));
+    hash_combine(hash_float (in_create_info_ptr->get_max_anisotropy           () ));
+    hash_combine(hash_float (in_create_info_ptr->get_max_lod                  () ));
+    hash_combine(hash_float (in_create_info_ptr->get_min_lod                  () ));
+
+    if (ycbcr_conversion != nullptr)
+    {
+        const auto  conversion_create_info_ptr = ycbcr_conversion->get_create_info_ptr();
+        const auto& components                 = conversion_create_info_ptr->get_components();
+
+        hash_combine(hash_uint32(static_cast<uint32_t>(conversion_create_info_ptr->get_chroma_filter         () )));
+        hash_combine(hash_uint32(static_cast<uint32_t>(conversion_create_info_ptr->get_format                () )));
+        hash_combine(hash_uint32(static_cast<uint32_t>(conversion_create_info_ptr->get_x_chroma_offset       () )));
+        hash_combine(hash_uint32(static_cast<uint32_t>(conversion_create_info_ptr->get_y_chroma_offset       () )));
+        hash_combine(hash_uint32(static_cast<uint32_t>(conversion_create_info_ptr->get_ycbcr_model_conversion() )));
+        hash_combine(hash_uint32(static_cast<uint32_t>(conversion_create_info_ptr->get_ycbcr_range           () )));
+        hash_combine(hash_uint32(static_cast<uint32_t>(components.r) ));
+        hash_combine(hash_uint32(static_cast<uint32_t>(components.g) ));
+        hash_combine(hash_uint32(static_cast<uint32_t>(components.b) ));
+        hash_combine(hash_uint32(static_cast<uint32_t>(components.a) ));
+        hash_combine(hash_uint32(conversion_create_info_ptr->should_force_explicit_reconstruction() ? 1u : 0u) );
+    }
+
+    return result_hash;
+}
+
+/* Please see header for specification */
+bool Anvil::SamplerCache::get_sampler(const Anvil::SamplerCreateInfo* in_create_info_ptr,
+                                      Anvil::SamplerUniquePtr*        out_sampler_ptr_ptr)
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr          = get_mutex();
+    bool                                   result             = false;
+    Anvil::Sampler*                        result_sampler_ptr = nullptr;
+    size_t                                 hash               = 0;
+
+    anvil_assert(in_create_info_ptr                != nullptr);
+    anvil_assert(in_create_info_ptr->get_device() == m_device_ptr);
+    anvil_assert(out_sampler_ptr_ptr               != nullptr);
+
+    hash = get_hash(in_create_info_ptr);
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    {
+        auto& containers = m_samplers[hash];
+
+        for (auto& current_container_ptr : containers)
+        {
+            if (is_match(current_container_ptr.get(),
+                         in_create_info_ptr) )
+            {
+                result             = true;
+                result_sampler_ptr = current_container_ptr->sampler_ptr.get();
+
+                current_container_ptr->n_references++;
+                m_n_hits.fetch_add(1);
+
+                break;
+            }
+        }
+
+        if (!result)
+        {
+            auto new_sampler_ptr = Anvil::Sampler::create(clone_create_info(in_create_info_ptr) );
+
+            if (new_sampler_ptr != nullptr)
+            {
+                auto new_container_ptr = std::unique_ptr<SamplerContainer>(new SamplerContainer() );
+
+                result                                              = true;
+                result_sampler_ptr                                  = new_sampler_ptr.get();
+                new_container_ptr->sampler_ptr                      = std::move(new_sampler_ptr);
+                new_container_ptr->ycbcr_conversion_create_info_ptr = clone_ycbcr_conversion_create_info(in_create_info_ptr);
+
+                containers.push_back(
+                    std::move(new_container_ptr)
+                );
+
+                m_n_live_samplers++;
+            }
+            else if (containers.size() == 0)
+            {
+                m_samplers.erase(hash);
+            }
+
+            m_n_misses.fetch_add(1);
+        }
+    }
+
+    if (result)
+    {
+        anvil_assert(result_sampler_ptr != nullptr);
+
+        *out_sampler_ptr_ptr = Anvil::SamplerUniquePtr(result_sampler_ptr,
+                                                       std::bind(&SamplerCache::on_sampler_dereferenced,
+                                                                 this,
+                                                                 hash,
+                                                                 result_sampler_ptr)
+        );
+    }
+
+    return result;
+}
+
+/** Tells whether the sampler held by @param in_container_ptr can be used in place of a sampler described by
+ *  @param in_create_info_ptr.
+ *
+ *  Y'CbCr conversions are compared against the state copied at sampler creation time. The conversion object
+ *  referred to by the cached sampler's create info is never accessed, as it may have been released since.
+ **/
+bool Anvil::SamplerCache::is_match(const SamplerContainer*         in_container_ptr,
+                                   const Anvil::SamplerCreateInfo* in_create_info_ptr) const
+{
+    const auto ycbcr_conversion_ptr = in_create_info_ptr->get_sampler_ycbcr_conversion_ptr();
+    bool       result               = false;
+
+    if (!in_container_ptr->sampler_ptr->get_create_info_ptr()->is_equal_ignoring_ycbcr_conversion(*in_create_info_ptr) )
+    {
+        goto end;
+    }
+
+    if (in_container_ptr->ycbcr_conversion_create_info_ptr == nullptr ||
+        ycbcr_conversion_ptr                               == nullptr)
+    {
+        result = (in_container_ptr->ycbcr_conversion_create_info_ptr == nullptr &&
+                  ycbcr_conversion_ptr                               == nullptr);
+
+        goto end;
+    }
+
+    result = (*in_container_ptr->ycbcr_conversion_create_info_ptr == *ycbcr_conversion_ptr->get_create_info_ptr() );
+end:
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::SamplerCache::Statistics Anvil::SamplerCache::get_statistics() const
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+    Statistics                             result;
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    result.n_hits          = m_n_hits.load  ();
+    result.n_live_samplers = m_n_live_samplers;
+    result.n_misses        = m_n_misses.load();
+
+    return result;
+}
+
+/** Drops a single reference from a sampler owned by the cache. The sampler is released when the last
+ *  reference goes away.
+ **/
+void Anvil::SamplerCache::on_sampler_dereferenced(size_t          in_hash,
+                                                  Anvil::Sampler* in_sampler_ptr)
+{
+    bool                                   has_found  = false;
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr  = get_mutex();
+
+    ANVIL_REDUNDANT_VARIABLE(has_found);
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    {
+        auto map_iterator = m_samplers.find(in_hash);
+
+        anvil_assert(map_iterator != m_samplers.end() );
+
+        if (map_iterator != m_samplers.end() )
+        {
+            auto& containers = map_iterator->second;
+
+            for (auto container_iterator  = containers.begin();
+                      container_iterator != containers.end();
+                    ++container_iterator)
+            {
+                auto& current_container_ptr = *container_iterator;
+
+                if (current_container_ptr->sampler_ptr.get() == in_sampler_ptr)
+                {
+                    has_found = true;
+
+                    if (--current_container_ptr->n_references == 0)
+                    {
+                        containers.erase(container_iterator);
+
+                        anvil_assert(m_n_live_samplers > 0);
+                        m_n_live_samplers--;
+                    }
+
+                    break;
+                }
+            }
+
+            if (containers.size() == 0)
+            {
+                m_samplers.erase(map_iterator);
+            }
+        }
+    }
+
+    anvil_assert(has_found);
+}
+
+/* Please see header for specification */
+void Anvil::SamplerCache::reset_statistics()
+{
+    m_n_hits.store  (0);
+    m_n_misses.store(0);
+}
@@ -21,6 +21,8 @@
 //
 
 #include "misc/sampler_create_info.h"
+#include "misc/sampler_ycbcr_conversion_create_info.h"
+#include "wrappers/sampler_ycbcr_conversion.h"
 
 Anvil::SamplerCreateInfoUniquePtr Anvil::SamplerCreateInfo::create(const Anvil::BaseDevice*  in_device_ptr,
                                                                    Anvil::Filter             in_mag_filter,
@@ -63,6 +65,39 @@ Anvil::SamplerCreateInfoUniquePtr Anvil::SamplerCreateInfo::create(const Anvil::
     return result_ptr;
 }
 
+/** Tells whether all sampler state, other than the attached Y'CbCr conversion, matches @param in_create_info. */
+bool Anvil::SamplerCreateInfo::is_equal_ignoring_ycbcr_conversion(const Anvil::SamplerCreateInfo& in_create_info) const
+{
+    return (m_address_mode_u               == in_create_info.m_address_mode_u               &&
+            m_address_mode_v               == in_create_info.m_address_mode_v               &&
+            m_address_mode_w               == in_create_info.m_address_mode_w               &&
+            m_border_color                 == in_create_info.m_border_color                 &&
+            m_compare_enable               == in_create_info.m_compare_enable               &&
+            m_compare_op                   == in_create_info.m_compare_op                   &&
+            m_device_ptr                   == in_create_info.m_device_ptr                   &&
+            m_lod_bias                     == in_create_info.m_lod_bias                     &&
+            m_mag_filter                   == in_create_info.m_mag_filter                   &&
+            m_max_anisotropy               == in_create_info.m_max_anisotropy               &&
+            m_max_lod                      == in_create_info.m_max_lod                      &&
+            m_min_filter                   == in_create_info.m_min_filter                   &&
+            m_min_lod                      == in_create_info.m_min_lod                      &&
+            m_mipmap_mode                  == in_create_info.m_mipmap_mode                  &&
+            m_sampler_reduction_mode       == in_create_info.m_sampler_reduction_mode       &&
+            m_use_unnormalized_coordinates == in_create_info.m_use_unnormalized_coordinates);
+}
+
+bool Anvil::SamplerCreateInfo::operator==(const Anvil::SamplerCreateInfo& in_create_info) const
+{
+    /* Distinct conversion objects which have been created with the same state are interchangeable */
+    const bool conversions_match = (m_sampler_ycbcr_conversion_ptr == in_create_info.m_sampler_ycbcr_conversion_ptr) ||
+                                   (m_sampler_ycbcr_conversion_ptr                != nullptr                     &&
+                                    in_create_info.m_sampler_ycbcr_conversion_ptr != nullptr                     &&
+                                    *m_sampler_ycbcr_conversion_ptr->get_create_info_ptr() == *in_create_info.m_sampler_ycbcr_conversion_ptr->get_create_info_ptr() );
+
+    return (conversions_match &&
+            is_equal_ignoring_ycbcr_conversion(in_create_info) );
+}
+
 Anvil::SamplerCreateInfo::SamplerCreateInfo(const Anvil::BaseDevice*    in_device_ptr,
                                             Anvil::Filter               in_mag_filter,
                                             Anvil::Filter               in_min_filter,
@@ -75,3 +75,20 @@ Anvil::SamplerYCbCrConversionCreateInfo::SamplerYCbCrConversionCreateInfo(const
 {
     /* Stub */
 }
+
+/** Please see header for specification */
+bool Anvil::SamplerYCbCrConversionCreateInfo::operator==(const Anvil::SamplerYCbCrConversionCreateInfo& in_create_info) const
+{
+    return (m_chroma_filter                        == in_create_info.m_chroma_filter                        &&
+            m_components.r                         == in_create_info.m_components.r                         &&
+            m_components.g                         == in_create_info.m_components.g                         &&
+            m_components.b                         == in_create_info.m_components.b                         &&
+            m_components.a                         == in_create_info.m_components.a                         &&
+            m_device_ptr                           == in_create_info.m_device_ptr                           &&
+            m_format                               == in_create_info.m_format                               &&
+            m_should_force_explicit_reconstruction == in_create_info.m_should_force_explicit_reconstruction &&
+            m_x_chroma_offset                      == in_create_info.m_x_chroma_offset                      &&
+            m_y_chroma_offset                      == in_create_info.m_y_chroma_offset                      &&
+            m_ycbcr_model_conversion               == in_create_info.m_ycbcr_model_conversion               &&
+            m_ycbcr_range                          == in_create_info.m_ycbcr_range);
+}
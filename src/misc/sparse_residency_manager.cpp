@@ -0,0 +1,1014 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include "misc/buffer_create_info.h"
+#include "misc/debug.h"
+#include "misc/image_create_info.h"
+#include "misc/memory_block_create_info.h"
+#include "misc/sparse_residency_manager.h"
+#include "wrappers/buffer.h"
+#include "wrappers/image.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/queue.h"
+#include <algorithm>
+
+static const uint32_t g_lru_none          = UINT32_MAX;
+static const uint32_t g_page_not_resident = UINT32_MAX;
+static const uint32_t g_page_pending      = UINT32_MAX - 1;
+
+
+/** Constructor. */
+Anvil::SparseResidencyManager::PhysicalPage::PhysicalPage(Anvil::MemoryBlock* in_memory_block_ptr,
+                                                          VkDeviceSize        in_memory_block_start_offset)
+    :last_used_frame          (0),
+     memory_block_ptr         (in_memory_block_ptr),
+     memory_block_start_offset(in_memory_block_start_offset),
+     n_lru_next               (g_lru_none),
+     n_lru_prev               (g_lru_none),
+     n_virtual_page           (UINT32_MAX),
+     resource_id              (UINT32_MAX)
+{
+    /* Stub */
+}
+
+/** Constructor. */
+Anvil::SparseResidencyManager::Resource::Resource()
+    :buffer_ptr       (nullptr),
+     image_ptr        (nullptr),
+     size             (0),
+     n_pages_per_layer(0),
+     mip_tail_offset  (0),
+     mip_tail_size    (0),
+     mip_tail_stride  (0),
+     n_mip_tails      (0)
+{
+    granularity = {0u, 0u, 0u};
+}
+
+/** Please see header for specification */
+Anvil::SparseResidencyManager::SparseResidencyManager(Anvil::BaseDevice*        in_device_ptr,
+                                                      VkDeviceSize              in_page_size,
+                                                      uint32_t                  in_n_pages_per_memory_block,
+                                                      uint32_t                  in_max_n_resident_pages,
+                                                      uint32_t                  in_n_frames_in_flight,
+                                                      Anvil::MemoryFeatureFlags in_memory_features)
+    :m_device_ptr                   (in_device_ptr),
+     m_max_n_resident_pages         (in_max_n_resident_pages),
+     m_memory_features              (in_memory_features),
+     m_memory_types                 (UINT32_MAX),
+     m_n_frames_in_flight           (in_n_frames_in_flight),
+     m_n_pages_per_memory_block     (in_n_pages_per_memory_block),
+     m_page_size                    (in_page_size),
+     m_n_current_frame              (0),
+     m_n_lru_head                   (g_lru_none),
+     m_n_lru_tail                   (g_lru_none),
+     m_n_resident_pages             (0),
+     m_last_flush_n_dropped_requests(0),
+     m_last_flush_n_evicted_pages   (0)
+{
+    /* Stub */
+}
+
+/** Destructor */
+Anvil::SparseResidencyManager::~SparseResidencyManager()
+{
+    /* Release objects before objects they refer to */
+    m_resources.clear     ();
+    m_physical_pages.clear();
+    m_memory_blocks.clear ();
+}
+
+/** Retrieves a physical page which can be bound to a virtual page. Free pages are used first. If there are none,
+ *  a new memory block is allocated, as long as the budget permits. Otherwise, the least recently used page is
+ *  evicted, unless it may still be used by a frame in flight.
+ *
+ *  The returned page is not linked into the LRU list.
+ *
+ *  @param in_update_ptr           Update to append an unbind operation for the evicted page to, if any.
+ *  @param in_bind_info_id         ID of the bind info to use.
+ *  @param out_n_physical_page_ptr Deref will be set to index of the physical page. Must not be nullptr.
+ *
+ *  @return true if successful, false if no physical page is available.
+ **/
+bool Anvil::SparseResidencyManager::acquire_physical_page(Anvil::SparseMemoryBindingUpdateInfo* in_update_ptr,
+                                                          Anvil::SparseMemoryBindInfoID         in_bind_info_id,
+                                                          uint32_t*                             out_n_physical_page_ptr)
+{
+    bool result = false;
+
+    if (m_free_physical_pages.size() == 0                   &&
+        m_physical_pages.size()      <  m_max_n_resident_pages)
+    {
+        Anvil::MemoryBlockUniquePtr memory_block_ptr;
+        const uint32_t              n_pages          = std::min(m_n_pages_per_memory_block,
+                                                                m_max_n_resident_pages - static_cast<uint32_t>(m_physical_pages.size() ));
+
+        {
+            auto create_info_ptr = Anvil::MemoryBlockCreateInfo::create_regular(m_device_ptr,
+                                                                                m_memory_types,
+                                                                                m_page_size * n_pages,
+                                                                                m_memory_features);
+
+            if (create_info_ptr != nullptr)
+            {
+                memory_block_ptr = Anvil::MemoryBlock::create(std::move(create_info_ptr) );
+            }
+        }
+
+        if (memory_block_ptr != nullptr)
+        {
+            /* Push pages in reverse order, so that they are handed out in the order of increasing offsets */
+            for (uint32_t n_page = 0;
+                          n_page < n_pages;
+                        ++n_page)
+            {
+                m_free_physical_pages.push_back(static_cast<uint32_t>(m_physical_pages.size() ) + n_pages - n_page - 1);
+            }
+
+            for (uint32_t n_page = 0;
+                          n_page < n_pages;
+                        ++n_page)
+            {
+                m_physical_pages.push_back(
+                    PhysicalPage(memory_block_ptr.get(),
+                                 m_page_size * n_page)
+                );
+            }
+
+            m_memory_blocks.push_back(
+                std::move(memory_block_ptr)
+            );
+        }
+    }
+
+    if (m_free_physical_pages.size() > 0)
+    {
+        *out_n_physical_page_ptr = m_free_physical_pages.back();
+        result                   = true;
+
+        m_free_physical_pages.pop_back();
+    }
+    else
+    if (m_n_lru_head != g_lru_none)
+    {
+        PhysicalPage& victim_page = m_physical_pages.at(m_n_lru_head);
+
+        /* If the least recently used page may still be in use, so are all the other ones */
+        if (victim_page.last_used_frame + m_n_frames_in_flight <= m_n_current_frame)
+        {
+            Resource*      victim_resource_ptr = get_resource(victim_page.resource_id);
+            const uint32_t n_physical_page     = m_n_lru_head;
+
+            anvil_assert(victim_resource_ptr != nullptr);
+
+            append_page_update(in_update_ptr,
+                               in_bind_info_id,
+                               *victim_resource_ptr,
+                               victim_page.n_virtual_page,
+                               nullptr, /* in_opt_memory_block_ptr */
+                               0);      /* in_memory_block_start_offset */
+
+            victim_resource_ptr->physical_pages.at(victim_page.n_virtual_page) = g_page_not_resident;
+
+            lru_remove(n_physical_page);
+
+            victim_page.n_virtual_page = UINT32_MAX;
+            victim_page.resource_id    = UINT32_MAX;
+
+            ++m_last_flush_n_evicted_pages;
+            --m_n_resident_pages;
+
+            *out_n_physical_page_ptr = n_physical_page;
+            result                   = true;
+        }
+    }
+
+    return result;
+}
+
+/** Appends an operation, which binds a memory region to (or unbinds memory from) a single virtual page, to
+ *  a sparse memory binding update.
+ *
+ *  @param in_update_ptr                Update to append the operation to.
+ *  @param in_bind_info_id              ID of the bind info to use.
+ *  @param in_resource                  Resource the page belongs to.
+ *  @param in_n_virtual_page            Index of the page.
+ *  @param in_opt_memory_block_ptr      Memory block to bind, or nullptr to unbind memory.
+ *  @param in_memory_block_start_offset Start offset of the region within @param in_opt_memory_block_ptr.
+ **/
+void Anvil::SparseResidencyManager::append_page_update(Anvil::SparseMemoryBindingUpdateInfo* in_update_ptr,
+                                                       Anvil::SparseMemoryBindInfoID         in_bind_info_id,
+                                                       const Resource&                       in_resource,
+                                                       uint32_t                              in_n_virtual_page,
+                                                       Anvil::MemoryBlock*                   in_opt_memory_block_ptr,
+                                                       VkDeviceSize                          in_memory_block_start_offset) const
+{
+    if (in_resource.buffer_ptr != nullptr)
+    {
+        const VkDeviceSize buffer_offset = m_page_size * in_n_virtual_page;
+
+        in_update_ptr->append_buffer_memory_update(in_bind_info_id,
+                                                   in_resource.buffer_ptr,
+                                                   buffer_offset,
+                                                   in_opt_memory_block_ptr,
+                                                   in_memory_block_start_offset,
+                                                   false, /* in_opt_memory_block_owned_by_buffer */
+                                                   std::min(m_page_size,
+                                                            in_resource.size - buffer_offset) );
+    }
+    else
+    {
+        VkExtent3D              extent;
+        VkOffset3D              offset;
+        Anvil::ImageSubresource subresource;
+
+        get_image_page_region(in_resource,
+                              in_n_virtual_page,
+                             &subresource,
+                             &offset,
+                             &extent);
+
+        in_update_ptr->append_image_memory_update(in_bind_info_id,
+                                                  in_resource.image_ptr,
+                                                  subresource,
+                                                  offset,
+                                                  extent,
+                                                  Anvil::SparseMemoryBindFlagBits::NONE,
+                                                  in_opt_memory_block_ptr,
+                                                  in_memory_block_start_offset,
+                                                  false); /* in_opt_memory_block_owned_by_image */
+    }
+}
+
+/** Tells whether memory blocks backing physical pages can be bound to a resource supporting the specified
+ *  memory types.
+ **/
+bool Anvil::SparseResidencyManager::are_memory_types_compatible(uint32_t in_memory_types) const
+{
+    if (m_memory_blocks.size() == 0)
+    {
+        return (m_memory_types & in_memory_types) != 0;
+    }
+    else
+    {
+        return (in_memory_types & (1u << m_memory_blocks.at(0)->get_create_info_ptr()->get_memory_type_index() )) != 0;
+    }
+}
+
+/** Please see header for specification */
+Anvil::SparseResidencyManagerUniquePtr Anvil::SparseResidencyManager::create(Anvil::BaseDevice*        in_device_ptr,
+                                                                             VkDeviceSize              in_page_size,
+                                                                             uint32_t                  in_n_pages_per_memory_block,
+                                                                             uint32_t                  in_max_n_resident_pages,
+                                                                             uint32_t                  in_n_frames_in_flight,
+                                                                             Anvil::MemoryFeatureFlags in_memory_features)
+{
+    SparseResidencyManagerUniquePtr result_ptr(nullptr,
+                                               std::default_delete<SparseResidencyManager>() );
+
+    if (in_device_ptr               == nullptr ||
+        in_page_size                == 0       ||
+        in_n_pages_per_memory_block == 0       ||
+        in_max_n_resident_pages     == 0       ||
+        in_n_frames_in_flight       == 0)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    result_ptr.reset(
+        new Anvil::SparseResidencyManager(in_device_ptr,
+                                          in_page_size,
+                                          in_n_pages_per_memory_block,
+                                          in_max_n_resident_pages,
+                                          in_n_frames_in_flight,
+                                          in_memory_features)
+    );
+
+end:
+    return result_ptr;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::flush(Anvil::Queue*            in_queue_ptr,
+                                          uint32_t                 in_n_wait_semaphores,
+                                          Anvil::Semaphore* const* in_opt_wait_semaphore_ptrs,
+                                          uint32_t                 in_n_signal_semaphores,
+                                          Anvil::Semaphore* const* in_opt_signal_semaphore_ptrs,
+                                          Anvil::Fence*            in_opt_fence_ptr)
+{
+    Anvil::SparseMemoryBindInfoID        bind_info_id;
+    uint32_t                             n_updates    = 0;
+    bool                                 result       = false;
+    Anvil::SparseMemoryBindingUpdateInfo update;
+
+    m_last_flush_bound_pages.clear();
+
+    m_last_flush_n_dropped_requests = 0;
+    m_last_flush_n_evicted_pages    = 0;
+
+    if (in_queue_ptr == nullptr                 ||
+        !in_queue_ptr->supports_sparse_bindings() )
+    {
+        anvil_assert(in_queue_ptr != nullptr                 &&
+                     in_queue_ptr->supports_sparse_bindings() );
+
+        goto end;
+    }
+
+    bind_info_id = update.add_bind_info(in_n_signal_semaphores,
+                                        in_opt_signal_semaphore_ptrs,
+                                        in_n_wait_semaphores,
+                                        in_opt_wait_semaphore_ptrs);
+
+    /* Bind mip tails of images registered since the last flush. The first update hands ownership of the memory
+     * block over to the image. */
+    for (auto& current_resource_ptr : m_resources)
+    {
+        if (current_resource_ptr                            == nullptr ||
+            current_resource_ptr->mip_tail_memory_block_ptr == nullptr)
+        {
+            continue;
+        }
+
+        for (uint32_t n_mip_tail = 0;
+                      n_mip_tail < current_resource_ptr->n_mip_tails;
+                    ++n_mip_tail)
+        {
+            update.append_opaque_image_memory_update(bind_info_id,
+                                                     current_resource_ptr->image_ptr,
+                                                     current_resource_ptr->mip_tail_offset + current_resource_ptr->mip_tail_stride * n_mip_tail,
+                                                     current_resource_ptr->mip_tail_size,
+                                                     Anvil::SparseMemoryBindFlagBits::NONE,
+                                                     current_resource_ptr->mip_tail_memory_block_ptr.get(),
+                                                     current_resource_ptr->mip_tail_size * n_mip_tail,
+                                                     (n_mip_tail == 0), /* in_opt_memory_block_owned_by_image */
+                                                     0);                /* in_n_plane                         */
+
+            ++n_updates;
+        }
+
+        current_resource_ptr->mip_tail_memory_block_ptr.release();
+    }
+
+    /* Bind physical pages to requested virtual pages, evicting least recently used pages if needed */
+    for (const auto& current_page : m_pending_pages)
+    {
+        uint32_t  n_physical_page   = UINT32_MAX;
+        Resource* resource_ptr      = get_resource(current_page.resource_id);
+
+        anvil_assert(resource_ptr                                            != nullptr        &&
+                     resource_ptr->physical_pages.at(current_page.n_page) == g_page_pending);
+
+        if (!acquire_physical_page(&update,
+                                    bind_info_id,
+                                   &n_physical_page) )
+        {
+            resource_ptr->physical_pages.at(current_page.n_page) = g_page_not_resident;
+
+            ++m_last_flush_n_dropped_requests;
+
+            continue;
+        }
+
+        {
+            PhysicalPage& physical_page = m_physical_pages.at(n_physical_page);
+
+            physical_page.last_used_frame = m_n_current_frame;
+            physical_page.n_virtual_page  = current_page.n_page;
+            physical_page.resource_id     = current_page.resource_id;
+
+            lru_append(n_physical_page);
+
+            resource_ptr->physical_pages.at(current_page.n_page) = n_physical_page;
+
+            append_page_update(&update,
+                               bind_info_id,
+                               *resource_ptr,
+                               current_page.n_page,
+                               physical_page.memory_block_ptr,
+                               physical_page.memory_block_start_offset);
+        }
+
+        m_last_flush_bound_pages.push_back(current_page);
+
+        ++m_n_resident_pages;
+    }
+
+    n_updates += static_cast<uint32_t>(m_last_flush_bound_pages.size() ) + m_last_flush_n_evicted_pages;
+
+    m_pending_pages.clear();
+
+    /* Coalesce all updates into a single vkQueueBindSparse() call. Skip it if there is nothing to do. */
+    if (n_updates              >  0       ||
+        in_n_wait_semaphores   >  0       ||
+        in_n_signal_semaphores >  0       ||
+        in_opt_fence_ptr       != nullptr)
+    {
+        update.set_fence(in_opt_fence_ptr);
+
+        result = in_queue_ptr->bind_sparse_memory(update);
+    }
+    else
+    {
+        result = true;
+    }
+
+    ++m_n_current_frame;
+
+end:
+    return result;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::get_buffer_page_region(Anvil::SparseResourceID in_resource_id,
+                                                           uint32_t                in_n_page,
+                                                           VkDeviceSize*           out_offset_ptr,
+                                                           VkDeviceSize*           out_size_ptr) const
+{
+    const Resource* resource_ptr = get_resource(in_resource_id);
+    bool            result       = false;
+
+    if (resource_ptr             == nullptr                                ||
+        resource_ptr->buffer_ptr == nullptr                                ||
+        in_n_page                >= resource_ptr->physical_pages.size() )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    *out_offset_ptr = m_page_size * in_n_page;
+    *out_size_ptr   = std::min(m_page_size,
+                               resource_ptr->size - *out_offset_ptr);
+    result          = true;
+
+end:
+    return result;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::get_image_page_index(Anvil::SparseResourceID in_resource_id,
+                                                         uint32_t                in_n_mip,
+                                                         uint32_t                in_n_layer,
+                                                         uint32_t                in_x,
+                                                         uint32_t                in_y,
+                                                         uint32_t                in_z,
+                                                         uint32_t*               out_n_page_ptr) const
+{
+    const MipInfo*  mip_ptr      = nullptr;
+    const Resource* resource_ptr = get_resource(in_resource_id);
+    bool            result       = false;
+
+    if (resource_ptr            == nullptr                                                                       ||
+        resource_ptr->image_ptr == nullptr                                                                       ||
+        in_n_mip                >= resource_ptr->mips.size()                                                     ||
+        in_n_layer              >= resource_ptr->physical_pages.size() / std::max(resource_ptr->n_pages_per_layer,
+                                                                                   1u) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    mip_ptr = &resource_ptr->mips.at(in_n_mip);
+
+    if (in_x >= mip_ptr->extent.width  ||
+        in_y >= mip_ptr->extent.height ||
+        in_z >= mip_ptr->extent.depth)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    *out_n_page_ptr = resource_ptr->n_pages_per_layer * in_n_layer +
+                      mip_ptr->n_first_page                         +
+                      ((in_z / resource_ptr->granularity.depth)  * mip_ptr->n_tiles.height +
+                       (in_y / resource_ptr->granularity.height)) * mip_ptr->n_tiles.width +
+                       (in_x / resource_ptr->granularity.width);
+    result          = true;
+
+end:
+    return result;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::get_image_page_region(Anvil::SparseResourceID  in_resource_id,
+                                                          uint32_t                 in_n_page,
+                                                          Anvil::ImageSubresource* out_subresource_ptr,
+                                                          VkOffset3D*              out_offset_ptr,
+                                                          VkExtent3D*              out_extent_ptr) const
+{
+    const Resource* resource_ptr = get_resource(in_resource_id);
+    bool            result       = false;
+
+    if (resource_ptr            == nullptr                                ||
+        resource_ptr->image_ptr == nullptr                                ||
+        in_n_page               >= resource_ptr->physical_pages.size() )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    get_image_page_region(*resource_ptr,
+                          in_n_page,
+                          out_subresource_ptr,
+                          out_offset_ptr,
+                          out_extent_ptr);
+
+    result = true;
+
+end:
+    return result;
+}
+
+/** Maps a virtual page of a registered image to the region it corresponds to.
+ *
+ *  @param in_resource         Image resource. Must describe an image.
+ *  @param in_n_page           Index of the page. Must be valid.
+ *  @param out_subresource_ptr Deref will be set to the subresource the page belongs to.
+ *  @param out_offset_ptr      Deref will be set to the offset of the region, in texels.
+ *  @param out_extent_ptr      Deref will be set to the extent of the region, in texels, clamped to the subresource.
+ **/
+void Anvil::SparseResidencyManager::get_image_page_region(const Resource&          in_resource,
+                                                          uint32_t                 in_n_page,
+                                                          Anvil::ImageSubresource* out_subresource_ptr,
+                                                          VkOffset3D*              out_offset_ptr,
+                                                          VkExtent3D*              out_extent_ptr)
+{
+    const uint32_t n_layer           = in_n_page / in_resource.n_pages_per_layer;
+    const uint32_t n_page_in_layer   = in_n_page % in_resource.n_pages_per_layer;
+    uint32_t       n_mip             = static_cast<uint32_t>(in_resource.mips.size() ) - 1;
+    uint32_t       n_tile            = 0;
+    uint32_t       tile_xyz[3];
+
+    /* Mips hold few enough pages for a linear search to be fine */
+    while (in_resource.mips.at(n_mip).n_first_page > n_page_in_layer)
+    {
+        --n_mip;
+    }
+
+    const MipInfo& mip = in_resource.mips.at(n_mip);
+
+    n_tile      = n_page_in_layer - mip.n_first_page;
+    tile_xyz[0] = n_tile % mip.n_tiles.width;
+    tile_xyz[1] = (n_tile / mip.n_tiles.width) % mip.n_tiles.height;
+    tile_xyz[2] = n_tile / (mip.n_tiles.width * mip.n_tiles.height);
+
+    out_subresource_ptr->aspect_mask = Anvil::ImageAspectFlagBits::COLOR_BIT;
+    out_subresource_ptr->array_layer = n_layer;
+    out_subresource_ptr->mip_level   = n_mip;
+
+    out_offset_ptr->x = static_cast<int32_t>(tile_xyz[0] * in_resource.granularity.width);
+    out_offset_ptr->y = static_cast<int32_t>(tile_xyz[1] * in_resource.granularity.height);
+    out_offset_ptr->z = static_cast<int32_t>(tile_xyz[2] * in_resource.granularity.depth);
+
+    out_extent_ptr->width  = std::min(in_resource.granularity.width,
+                                      mip.extent.width  - static_cast<uint32_t>(out_offset_ptr->x) );
+    out_extent_ptr->height = std::min(in_resource.granularity.height,
+                                      mip.extent.height - static_cast<uint32_t>(out_offset_ptr->y) );
+    out_extent_ptr->depth  = std::min(in_resource.granularity.depth,
+                                      mip.extent.depth  - static_cast<uint32_t>(out_offset_ptr->z) );
+}
+
+/** Please see header for specification */
+uint32_t Anvil::SparseResidencyManager::get_n_pages(Anvil::SparseResourceID in_resource_id) const
+{
+    const Resource* resource_ptr = get_resource(in_resource_id);
+
+    return (resource_ptr != nullptr) ? static_cast<uint32_t>(resource_ptr->physical_pages.size() )
+                                     : 0;
+}
+
+/** Returns a registered resource with the specified ID, or nullptr if the ID does not refer to a registered
+ *  resource.
+ **/
+Anvil::SparseResidencyManager::Resource* Anvil::SparseResidencyManager::get_resource(Anvil::SparseResourceID in_resource_id) const
+{
+    return (in_resource_id < m_resources.size() ) ? m_resources.at(in_resource_id).get()
+                                                  : nullptr;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::is_page_resident(Anvil::SparseResourceID in_resource_id,
+                                                     uint32_t                in_n_page) const
+{
+    const Resource* resource_ptr = get_resource(in_resource_id);
+
+    if (resource_ptr == nullptr                             ||
+        in_n_page    >= resource_ptr->physical_pages.size() )
+    {
+        anvil_assert_fail();
+
+        return false;
+    }
+
+    return resource_ptr->physical_pages.at(in_n_page) < g_page_pending;
+}
+
+/** Links a physical page to the end of the LRU list, as the most recently used one. */
+void Anvil::SparseResidencyManager::lru_append(uint32_t in_n_physical_page)
+{
+    PhysicalPage& page = m_physical_pages.at(in_n_physical_page);
+
+    page.n_lru_next = g_lru_none;
+    page.n_lru_prev = m_n_lru_tail;
+
+    if (m_n_lru_tail != g_lru_none)
+    {
+        m_physical_pages.at(m_n_lru_tail).n_lru_next = in_n_physical_page;
+    }
+    else
+    {
+        m_n_lru_head = in_n_physical_page;
+    }
+
+    m_n_lru_tail = in_n_physical_page;
+}
+
+/** Unlinks a physical page from the LRU list. */
+void Anvil::SparseResidencyManager::lru_remove(uint32_t in_n_physical_page)
+{
+    PhysicalPage& page = m_physical_pages.at(in_n_physical_page);
+
+    if (page.n_lru_prev != g_lru_none)
+    {
+        m_physical_pages.at(page.n_lru_prev).n_lru_next = page.n_lru_next;
+    }
+    else
+    {
+        m_n_lru_head = page.n_lru_next;
+    }
+
+    if (page.n_lru_next != g_lru_none)
+    {
+        m_physical_pages.at(page.n_lru_next).n_lru_prev = page.n_lru_prev;
+    }
+    else
+    {
+        m_n_lru_tail = page.n_lru_prev;
+    }
+
+    page.n_lru_next = g_lru_none;
+    page.n_lru_prev = g_lru_none;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::register_buffer(Anvil::Buffer*           in_buffer_ptr,
+                                                    Anvil::SparseResourceID* out_resource_id_ptr)
+{
+    VkMemoryRequirements      memory_reqs;
+    std::unique_ptr<Resource> resource_ptr;
+    bool                      result       = false;
+
+    if (in_buffer_ptr == nullptr)
+    {
+        anvil_assert(in_buffer_ptr != nullptr);
+
+        goto end;
+    }
+
+    if ((in_buffer_ptr->get_create_info_ptr()->get_create_flags() & Anvil::BufferCreateFlagBits::SPARSE_RESIDENCY_BIT) == 0)
+    {
+        anvil_assert((in_buffer_ptr->get_create_info_ptr()->get_create_flags() & Anvil::BufferCreateFlagBits::SPARSE_RESIDENCY_BIT) != 0);
+
+        goto end;
+    }
+
+    memory_reqs = in_buffer_ptr->get_memory_requirements();
+
+    if ((m_page_size % memory_reqs.alignment) != 0)
+    {
+        anvil_assert((m_page_size % memory_reqs.alignment) == 0);
+
+        goto end;
+    }
+
+    resource_ptr.reset(new Resource() );
+
+    resource_ptr->buffer_ptr = in_buffer_ptr;
+    resource_ptr->size       = memory_reqs.size;
+
+    resource_ptr->physical_pages.resize(static_cast<uint32_t>(Anvil::Utils::round_up(memory_reqs.size,
+                                                                                     m_page_size) / m_page_size),
+                                        g_page_not_resident);
+
+    result = register_resource(std::move(resource_ptr),
+                               memory_reqs.memoryTypeBits,
+                               out_resource_id_ptr);
+
+end:
+    return result;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::register_image(Anvil::Image*            in_image_ptr,
+                                                   Anvil::SparseResourceID* out_resource_id_ptr)
+{
+    const Anvil::SparseImageAspectProperties* aspect_props_ptr = nullptr;
+    uint32_t                                  n_layers         = 0;
+    uint32_t                                  n_paged_mips     = 0;
+    std::unique_ptr<Resource>                 resource_ptr;
+    bool                                      result           = false;
+
+    if (in_image_ptr == nullptr)
+    {
+        anvil_assert(in_image_ptr != nullptr);
+
+        goto end;
+    }
+
+    if (!in_image_ptr->get_sparse_image_aspect_properties(Anvil::ImageAspectFlagBits::COLOR_BIT,
+                                                         &aspect_props_ptr) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (in_image_ptr->get_image_alignment(0 /* in_n_plane */) != m_page_size)
+    {
+        anvil_assert(in_image_ptr->get_image_alignment(0 /* in_n_plane */) == m_page_size);
+
+        goto end;
+    }
+
+    if (!are_memory_types_compatible(in_image_ptr->get_image_memory_types(0 /* in_n_plane */) ))
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    n_layers     = in_image_ptr->get_create_info_ptr()->get_n_layers();
+    n_paged_mips = std::min(aspect_props_ptr->mip_tail_first_lod,
+                            in_image_ptr->get_n_mipmaps() );
+    resource_ptr.reset(new Resource() );
+
+    resource_ptr->granularity = aspect_props_ptr->granularity;
+    resource_ptr->image_ptr   = in_image_ptr;
+
+    for (uint32_t n_mip = 0;
+                  n_mip < n_paged_mips;
+                ++n_mip)
+    {
+        MipInfo mip;
+
+        mip.extent         = in_image_ptr->get_image_extent_3D(n_mip);
+        mip.n_first_page   = resource_ptr->n_pages_per_layer;
+        mip.n_tiles.width  = Anvil::Utils::round_up(mip.extent.width,  resource_ptr->granularity.width)  / resource_ptr->granularity.width;
+        mip.n_tiles.height = Anvil::Utils::round_up(mip.extent.height, resource_ptr->granularity.height) / resource_ptr->granularity.height;
+        mip.n_tiles.depth  = Anvil::Utils::round_up(mip.extent.depth,  resource_ptr->granularity.depth)  / resource_ptr->granularity.depth;
+
+        resource_ptr->n_pages_per_layer += mip.n_tiles.width * mip.n_tiles.height * mip.n_tiles.depth;
+
+        resource_ptr->mips.push_back(mip);
+    }
+
+    resource_ptr->physical_pages.resize(resource_ptr->n_pages_per_layer * n_layers,
+                                        g_page_not_resident);
+
+    /* Mip tails stay resident for as long as the image is registered. Back them with a dedicated memory block,
+     * which is bound by the next flush. */
+    if (aspect_props_ptr->mip_tail_first_lod < in_image_ptr->get_n_mipmaps() &&
+        aspect_props_ptr->mip_tail_size      >  0)
+    {
+        resource_ptr->mip_tail_offset = aspect_props_ptr->mip_tail_offset;
+        resource_ptr->mip_tail_size   = aspect_props_ptr->mip_tail_size;
+        resource_ptr->mip_tail_stride = aspect_props_ptr->mip_tail_stride;
+        resource_ptr->n_mip_tails     = ((aspect_props_ptr->flags & Anvil::SparseImageFormatFlagBits::SINGLE_MIPTAIL_BIT) != 0) ? 1
+                                                                                                                                 : n_layers;
+
+        {
+            auto create_info_ptr = Anvil::MemoryBlockCreateInfo::create_regular(m_device_ptr,
+                                                                                in_image_ptr->get_image_memory_types(0 /* in_n_plane */),
+                                                                                resource_ptr->mip_tail_size * resource_ptr->n_mip_tails,
+                                                                                m_memory_features);
+
+            if (create_info_ptr != nullptr)
+            {
+                resource_ptr->mip_tail_memory_block_ptr = Anvil::MemoryBlock::create(std::move(create_info_ptr) );
+            }
+        }
+
+        if (resource_ptr->mip_tail_memory_block_ptr == nullptr)
+        {
+            anvil_assert(resource_ptr->mip_tail_memory_block_ptr != nullptr);
+
+            goto end;
+        }
+    }
+
+    result = register_resource(std::move(resource_ptr),
+                               in_image_ptr->get_image_memory_types(0 /* in_n_plane */),
+                               out_resource_id_ptr);
+
+end:
+    return result;
+}
+
+/** Stores a new resource and narrows down memory types physical pages can be allocated from.
+ *
+ *  @param in_resource_ptr     Resource to store.
+ *  @param in_memory_types     Memory types supported by the resource.
+ *  @param out_resource_id_ptr Deref will be set to ID of the resource.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::SparseResidencyManager::register_resource(std::unique_ptr<Resource> in_resource_ptr,
+                                                      uint32_t                  in_memory_types,
+                                                      Anvil::SparseResourceID*  out_resource_id_ptr)
+{
+    if (!are_memory_types_compatible(in_memory_types) )
+    {
+        anvil_assert_fail();
+
+        return false;
+    }
+
+    if (m_memory_blocks.size() == 0)
+    {
+        m_memory_types &= in_memory_types;
+    }
+
+    *out_resource_id_ptr = static_cast<Anvil::SparseResourceID>(m_resources.size() );
+
+    m_resources.push_back(
+        std::move(in_resource_ptr)
+    );
+
+    return true;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::request_page(Anvil::SparseResourceID in_resource_id,
+                                                 uint32_t                in_n_page)
+{
+    uint32_t  n_physical_page = UINT32_MAX;
+    Resource* resource_ptr    = get_resource(in_resource_id);
+    bool      result          = false;
+
+    if (resource_ptr == nullptr                             ||
+        in_n_page    >= resource_ptr->physical_pages.size() )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    n_physical_page = resource_ptr->physical_pages.at(in_n_page);
+
+    if (n_physical_page == g_page_not_resident)
+    {
+        resource_ptr->physical_pages.at(in_n_page) = g_page_pending;
+
+        m_pending_pages.push_back(
+            Page(in_resource_id,
+                 in_n_page)
+        );
+    }
+    else
+    if (n_physical_page != g_page_pending)
+    {
+        m_physical_pages.at(n_physical_page).last_used_frame = m_n_current_frame;
+
+        lru_remove(n_physical_page);
+        lru_append(n_physical_page);
+    }
+
+    result = true;
+
+end:
+    return result;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::request_pages_from_feedback(Anvil::SparseResourceID in_resource_id,
+                                                                const uint32_t*         in_bitmask_ptr,
+                                                                uint32_t                in_n_words)
+{
+    uint32_t n_pages = get_n_pages(in_resource_id);
+    bool     result  = false;
+
+    if (n_pages        == 0 ||
+        in_bitmask_ptr == nullptr)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    in_n_words = std::min(in_n_words,
+                          (n_pages + 31) / 32);
+
+    for (uint32_t n_word = 0;
+                  n_word < in_n_words;
+                ++n_word)
+    {
+        uint32_t word = in_bitmask_ptr[n_word];
+
+        for (uint32_t n_bit = 0;
+                      word != 0;
+                    ++n_bit, word >>= 1)
+        {
+            const uint32_t n_page = n_word * 32 + n_bit;
+
+            if ((word & 1) == 0)
+            {
+                continue;
+            }
+
+            if (n_page >= n_pages)
+            {
+                break;
+            }
+
+            request_page(in_resource_id,
+                         n_page);
+        }
+    }
+
+    result = true;
+
+end:
+    return result;
+}
+
+/** Please see header for specification */
+bool Anvil::SparseResidencyManager::unregister_resource(Anvil::SparseResourceID in_resource_id)
+{
+    Resource* resource_ptr = get_resource(in_resource_id);
+    bool      result       = false;
+
+    if (resource_ptr == nullptr)
+    {
+        anvil_assert(resource_ptr != nullptr);
+
+        goto end;
+    }
+
+    for (const auto& current_n_physical_page : resource_ptr->physical_pages)
+    {
+        if (current_n_physical_page >= g_page_pending)
+        {
+            continue;
+        }
+
+        lru_remove(current_n_physical_page);
+
+        m_physical_pages.at(current_n_physical_page).n_virtual_page = UINT32_MAX;
+        m_physical_pages.at(current_n_physical_page).resource_id    = UINT32_MAX;
+
+        m_free_physical_pages.push_back(current_n_physical_page);
+
+        --m_n_resident_pages;
+    }
+
+    m_pending_pages.erase(
+        std::remove_if(m_pending_pages.begin(),
+                       m_pending_pages.end(),
+                       [in_resource_id](const Page& in_page)
+                       {
+                           return in_page.resource_id == in_resource_id;
+                       }),
+        m_pending_pages.end()
+    );
+
+    m_last_flush_bound_pages.erase(
+        std::remove_if(m_last_flush_bound_pages.begin(),
+                       m_last_flush_bound_pages.end(),
+                       [in_resource_id](const Page& in_page)
+                       {
+                           return in_page.resource_id == in_resource_id;
+                       }),
+        m_last_flush_bound_pages.end()
+    );
+
+    m_resources.at(in_resource_id).reset();
+
+    result = true;
+
+end:
+    return result;
+}
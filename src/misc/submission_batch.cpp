@@ -0,0 +1,541 @@
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/submission_batch.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/fence.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/semaphore.h"
+#include <algorithm>
+
+
+/* Please see header for specification */
+Anvil::SubmissionBatch::SubmissionBatch()
+    :m_fence_ptr   (nullptr),
+     m_should_block(false),
+     m_timeout     (UINT64_MAX)
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::SubmissionBatch::~SubmissionBatch()
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+bool Anvil::SubmissionBatch::add(const Anvil::SubmitInfo& in_submit_info)
+{
+    Anvil::Fence* const fence_ptr = in_submit_info.get_fence();
+    bool                result    = false;
+    Submission          submission;
+
+    if (fence_ptr   != nullptr   &&
+        m_fence_ptr != nullptr   &&
+        m_fence_ptr != fence_ptr)
+    {
+        /* vkQueueSubmit() only accepts one fence per call */
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    submission.first_cmd_buffer       = static_cast<uint32_t>(m_cmd_buffers_vk.size      () );
+    submission.first_signal_semaphore = static_cast<uint32_t>(m_signal_semaphores_vk.size() );
+    submission.first_wait_semaphore   = static_cast<uint32_t>(m_wait_semaphores_vk.size  () );
+    submission.is_mgpu                = (in_submit_info.get_type() == Anvil::SubmissionType::MGPU);
+    submission.is_protected           = in_submit_info.is_protected_submission();
+    submission.n_signal_semaphores    = in_submit_info.get_n_signal_semaphores();
+    submission.n_wait_semaphores      = in_submit_info.get_n_wait_semaphores  ();
+
+    if (submission.is_mgpu)
+    {
+        const auto cmd_buffer_submissions_ptr       = in_submit_info.get_command_buffers_mgpu  ();
+        const auto signal_semaphore_submissions_ptr = in_submit_info.get_signal_semaphores_mgpu();
+        const auto wait_semaphore_submissions_ptr   = in_submit_info.get_wait_semaphores_mgpu  ();
+
+        for (uint32_t n_cmd_buffer_submission = 0;
+                      n_cmd_buffer_submission < in_submit_info.get_n_command_buffers();
+                    ++n_cmd_buffer_submission)
+        {
+            const auto& current_submission = cmd_buffer_submissions_ptr[n_cmd_buffer_submission];
+
+            if (current_submission.cmd_buffer_ptr != nullptr)
+            {
+                m_cmd_buffer_device_masks.push_back(current_submission.device_mask);
+                m_cmd_buffer_ptrs.push_back        (current_submission.cmd_buffer_ptr);
+                m_cmd_buffers_vk.push_back         (current_submission.cmd_buffer_ptr->get_command_buffer() );
+
+                ++submission.n_cmd_buffers;
+            }
+        }
+
+        for (uint32_t n_signal_semaphore_submission = 0;
+                      n_signal_semaphore_submission < submission.n_signal_semaphores;
+                    ++n_signal_semaphore_submission)
+        {
+            const auto& current_submission = signal_semaphore_submissions_ptr[n_signal_semaphore_submission];
+
+            m_signal_semaphore_device_indices.push_back(current_submission.device_index);
+            m_signal_semaphore_ptrs.push_back          (current_submission.semaphore_ptr);
+            m_signal_semaphores_vk.push_back           (current_submission.semaphore_ptr->get_semaphore() );
+        }
+
+        for (uint32_t n_wait_semaphore_submission = 0;
+                      n_wait_semaphore_submission < submission.n_wait_semaphores;
+                    ++n_wait_semaphore_submission)
+        {
+            const auto& current_submission = wait_semaphore_submissions_ptr[n_wait_semaphore_submission];
+
+            m_wait_semaphore_device_indices.push_back(current_submission.device_index);
+            m_wait_semaphore_ptrs.push_back          (current_submission.semaphore_ptr);
+            m_wait_semaphores_vk.push_back           (current_submission.semaphore_ptr->get_semaphore() );
+        }
+    }
+    else
+    {
+        const auto cmd_buffer_ptrs       = in_submit_info.get_command_buffers_sgpu  ();
+        const auto signal_semaphore_ptrs = in_submit_info.get_signal_semaphores_sgpu();
+        const auto wait_semaphore_ptrs   = in_submit_info.get_wait_semaphores_sgpu  ();
+
+        submission.n_cmd_buffers = in_submit_info.get_n_command_buffers();
+
+        for (uint32_t n_cmd_buffer = 0;
+                      n_cmd_buffer < submission.n_cmd_buffers;
+                    ++n_cmd_buffer)
+        {
+            m_cmd_buffer_device_masks.push_back(0);
+            m_cmd_buffer_ptrs.push_back        (cmd_buffer_ptrs[n_cmd_buffer]);
+            m_cmd_buffers_vk.push_back         (cmd_buffer_ptrs[n_cmd_buffer]->get_command_buffer() );
+        }
+
+        for (uint32_t n_signal_semaphore = 0;
+                      n_signal_semaphore < submission.n_signal_semaphores;
+                    ++n_signal_semaphore)
+        {
+            m_signal_semaphore_device_indices.push_back(0);
+            m_signal_semaphore_ptrs.push_back          (signal_semaphore_ptrs[n_signal_semaphore]);
+            m_signal_semaphores_vk.push_back           (signal_semaphore_ptrs[n_signal_semaphore]->get_semaphore() );
+        }
+
+        for (uint32_t n_wait_semaphore = 0;
+                      n_wait_semaphore < submission.n_wait_semaphores;
+                    ++n_wait_semaphore)
+        {
+            m_wait_semaphore_device_indices.push_back(0);
+            m_wait_semaphore_ptrs.push_back          (wait_semaphore_ptrs[n_wait_semaphore]);
+            m_wait_semaphores_vk.push_back           (wait_semaphore_ptrs[n_wait_semaphore]->get_semaphore() );
+        }
+    }
+
+    if (submission.n_wait_semaphores > 0)
+    {
+        const VkPipelineStageFlags* dst_stage_masks_ptr = in_submit_info.get_destination_stage_wait_masks();
+
+        m_wait_semaphore_dst_stage_masks.insert(m_wait_semaphore_dst_stage_masks.end(),
+                                                dst_stage_masks_ptr,
+                                                dst_stage_masks_ptr + submission.n_wait_semaphores);
+    }
+
+    {
+        const uint64_t* timeline_signal_semaphore_values_ptr = nullptr;
+        const uint64_t* timeline_wait_semaphore_values_ptr   = nullptr;
+
+        submission.has_timeline_semaphore_values = in_submit_info.get_timeline_semaphore_values(&timeline_signal_semaphore_values_ptr,
+                                                                                                &timeline_wait_semaphore_values_ptr);
+
+        m_timeline_signal_semaphore_values.resize(m_signal_semaphores_vk.size(),
+                                                  0);
+        m_timeline_wait_semaphore_values.resize  (m_wait_semaphores_vk.size(),
+                                                  0);
+
+        if (submission.has_timeline_semaphore_values)
+        {
+            if (timeline_signal_semaphore_values_ptr != nullptr)
+            {
+                std::copy(timeline_signal_semaphore_values_ptr,
+                          timeline_signal_semaphore_values_ptr + submission.n_signal_semaphores,
+                          m_timeline_signal_semaphore_values.begin() + submission.first_signal_semaphore);
+            }
+
+            if (timeline_wait_semaphore_values_ptr != nullptr)
+            {
+                std::copy(timeline_wait_semaphore_values_ptr,
+                          timeline_wait_semaphore_values_ptr + submission.n_wait_semaphores,
+                          m_timeline_wait_semaphore_values.begin() + submission.first_wait_semaphore);
+            }
+        }
+    }
+
+    #if defined(_WIN32)
+    {
+        const uint64_t* d3d12_fence_signal_semaphore_values_ptr = nullptr;
+        const uint64_t* d3d12_fence_wait_semaphore_values_ptr   = nullptr;
+
+        submission.has_d3d12_fence_semaphore_values = in_submit_info.get_d3d12_fence_semaphore_values(&d3d12_fence_signal_semaphore_values_ptr,
+                                                                                                      &d3d12_fence_wait_semaphore_values_ptr);
+
+        /* Keep the value arrays in sync with semaphore arrays, so that the same offsets can be used for both */
+        m_d3d12_fence_signal_semaphore_values.resize(m_signal_semaphores_vk.size(),
+                                                     0);
+        m_d3d12_fence_wait_semaphore_values.resize  (m_wait_semaphores_vk.size(),
+                                                     0);
+
+        if (submission.has_d3d12_fence_semaphore_values)
+        {
+            if (d3d12_fence_signal_semaphore_values_ptr != nullptr)
+            {
+                std::copy(d3d12_fence_signal_semaphore_values_ptr,
+                          d3d12_fence_signal_semaphore_values_ptr + submission.n_signal_semaphores,
+                          m_d3d12_fence_signal_semaphore_values.begin() + submission.first_signal_semaphore);
+            }
+
+            if (d3d12_fence_wait_semaphore_values_ptr != nullptr)
+            {
+                std::copy(d3d12_fence_wait_semaphore_values_ptr,
+                          d3d12_fence_wait_semaphore_values_ptr + submission.n_wait_semaphores,
+                          m_d3d12_fence_wait_semaphore_values.begin() + submission.first_wait_semaphore);
+            }
+        }
+    }
+
+    {
+        const Anvil::MemoryBlock** acquire_d3d11_memory_block_ptrs = nullptr;
+        const uint64_t*            acquire_mutex_key_value_ptrs    = nullptr;
+        const uint32_t*            acquire_timeout_ptrs            = nullptr;
+        uint32_t                   n_acquire_keys                  = 0;
+        uint32_t                   n_release_keys                  = 0;
+        const Anvil::MemoryBlock** release_d3d11_memory_block_ptrs = nullptr;
+        const uint64_t*            release_mutex_key_value_ptrs    = nullptr;
+
+        submission.first_keyed_mutex_acquire_key = static_cast<uint32_t>(m_keyed_mutex_acquire_syncs.size() );
+        submission.first_keyed_mutex_release_key = static_cast<uint32_t>(m_keyed_mutex_release_syncs.size() );
+
+        if (in_submit_info.get_keyed_mutex_acquire_release_info(&n_acquire_keys,
+                                                                &acquire_d3d11_memory_block_ptrs,
+                                                                &acquire_mutex_key_value_ptrs,
+                                                                &acquire_timeout_ptrs,
+                                                                &n_release_keys,
+                                                                &release_d3d11_memory_block_ptrs,
+                                                                &release_mutex_key_value_ptrs) )
+        {
+            for (uint32_t n_acquire_key = 0;
+                          n_acquire_key < n_acquire_keys;
+                        ++n_acquire_key)
+            {
+                m_keyed_mutex_acquire_keys.push_back    (acquire_mutex_key_value_ptrs   [n_acquire_key]);
+                m_keyed_mutex_acquire_syncs.push_back   (acquire_d3d11_memory_block_ptrs[n_acquire_key]->get_memory() );
+                m_keyed_mutex_acquire_timeouts.push_back(acquire_timeout_ptrs           [n_acquire_key]);
+            }
+
+            for (uint32_t n_release_key = 0;
+                          n_release_key < n_release_keys;
+                        ++n_release_key)
+            {
+                m_keyed_mutex_release_keys.push_back (release_mutex_key_value_ptrs   [n_release_key]);
+                m_keyed_mutex_release_syncs.push_back(release_d3d11_memory_block_ptrs[n_release_key]->get_memory() );
+            }
+
+            submission.n_keyed_mutex_acquire_keys = n_acquire_keys;
+            submission.n_keyed_mutex_release_keys = n_release_keys;
+        }
+    }
+    #endif
+
+    m_submissions.push_back(submission);
+
+    if (fence_ptr != nullptr)
+    {
+        m_fence_ptr = fence_ptr;
+    }
+
+    if (in_submit_info.get_should_block() )
+    {
+        m_should_block = true;
+        m_timeout      = std::min(m_timeout,
+                                  in_submit_info.get_timeout() );
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/** Fills Vulkan submit info structures (and structures chained to them) for all submissions added to the batch.
+ *
+ *  Pointers stored in the returned structures point to storage owned by the batch and stay valid until
+ *  the batch is modified or cleared.
+ *
+ *  @param in_opt_tracking_semaphore   If not VK_NULL_HANDLE, the last submission additionally signals this timeline
+ *                                     semaphore, after all semaphores specified for the submission.
+ *  @param in_tracking_semaphore_value Value to signal @param in_opt_tracking_semaphore with. Ignored if
+ *                                     @param in_opt_tracking_semaphore is VK_NULL_HANDLE.
+ *
+ *  @return Pointer to an array of get_n_submissions() VkSubmitInfo structures.
+ **/
+const VkSubmitInfo* Anvil::SubmissionBatch::bake_submit_infos(VkSemaphore in_opt_tracking_semaphore,
+                                                              uint64_t    in_tracking_semaphore_value)
+{
+    const uint32_t n_submissions = static_cast<uint32_t>(m_submissions.size() );
+
+    anvil_assert(n_submissions > 0);
+
+    /* Signal semaphores of the last submission are stored at the end of the semaphore arrays, so the tracking
+     * semaphore can be appended right after them. Drop the one appended by an earlier bake first, if any. */
+    {
+        const Submission& last_submission     = m_submissions.back();
+        const uint32_t    n_signal_semaphores = last_submission.first_signal_semaphore + last_submission.n_signal_semaphores;
+
+        m_signal_semaphore_device_indices.resize (n_signal_semaphores);
+        m_signal_semaphores_vk.resize            (n_signal_semaphores);
+        m_timeline_signal_semaphore_values.resize(n_signal_semaphores);
+
+        #if defined(_WIN32)
+        {
+            m_d3d12_fence_signal_semaphore_values.resize(n_signal_semaphores);
+        }
+        #endif
+
+        if (in_opt_tracking_semaphore != VK_NULL_HANDLE)
+        {
+            m_signal_semaphore_device_indices.push_back (0);
+            m_signal_semaphores_vk.push_back            (in_opt_tracking_semaphore);
+            m_timeline_signal_semaphore_values.push_back(in_tracking_semaphore_value);
+
+            #if defined(_WIN32)
+            {
+                m_d3d12_fence_signal_semaphore_values.push_back(0);
+            }
+            #endif
+        }
+    }
+
+    /* NOTE: These vectors must not be resized after pointers to their elements have been taken below. */
+    m_device_group_submit_infos_vk.resize      (n_submissions);
+    m_protected_submit_infos_vk.resize         (n_submissions);
+    m_submit_infos_vk.resize                   (n_submissions);
+    m_timeline_semaphore_submit_infos_vk.resize(n_submissions);
+
+    #if defined(_WIN32)
+    {
+        m_d3d12_fence_submit_infos_vk.resize         (n_submissions);
+        m_keyed_mutex_acquire_release_infos_vk.resize(n_submissions);
+    }
+    #endif
+
+    for (uint32_t n_submission = 0;
+                  n_submission < n_submissions;
+                ++n_submission)
+    {
+        const auto&    current_submission  = m_submissions.at(n_submission);
+        const bool     is_tracked          = (in_opt_tracking_semaphore != VK_NULL_HANDLE && n_submission == n_submissions - 1);
+        const uint32_t n_signal_semaphores = current_submission.n_signal_semaphores + ((is_tracked) ? 1 : 0);
+        VkSubmitInfo&  submit_info         = m_submit_infos_vk.at(n_submission);
+        const void**   next_ptr_ptr        = &submit_info.pNext;
+
+        submit_info.commandBufferCount   = current_submission.n_cmd_buffers;
+        submit_info.pCommandBuffers      = (current_submission.n_cmd_buffers       != 0) ? &m_cmd_buffers_vk.at                (current_submission.first_cmd_buffer)       : nullptr;
+        submit_info.pNext                = nullptr;
+        submit_info.pSignalSemaphores    = (n_signal_semaphores                   != 0) ? &m_signal_semaphores_vk.at          (current_submission.first_signal_semaphore) : nullptr;
+        submit_info.pWaitDstStageMask    = (current_submission.n_wait_semaphores   != 0) ? &m_wait_semaphore_dst_stage_masks.at(current_submission.first_wait_semaphore)   : nullptr;
+        submit_info.pWaitSemaphores      = (current_submission.n_wait_semaphores   != 0) ? &m_wait_semaphores_vk.at            (current_submission.first_wait_semaphore)   : nullptr;
+        submit_info.signalSemaphoreCount = n_signal_semaphores;
+        submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.waitSemaphoreCount   = current_submission.n_wait_semaphores;
+
+        if (current_submission.is_mgpu)
+        {
+            VkDeviceGroupSubmitInfoKHR& device_group_submit_info = m_device_group_submit_infos_vk.at(n_submission);
+
+            device_group_submit_info.commandBufferCount            = current_submission.n_cmd_buffers;
+            device_group_submit_info.pCommandBufferDeviceMasks     = (current_submission.n_cmd_buffers       != 0) ? &m_cmd_buffer_device_masks.at        (current_submission.first_cmd_buffer)       : nullptr;
+            device_group_submit_info.pNext                         = nullptr;
+            device_group_submit_info.pSignalSemaphoreDeviceIndices = (n_signal_semaphores                   != 0) ? &m_signal_semaphore_device_indices.at(current_submission.first_signal_semaphore) : nullptr;
+            device_group_submit_info.pWaitSemaphoreDeviceIndices   = (current_submission.n_wait_semaphores   != 0) ? &m_wait_semaphore_device_indices.at  (current_submission.first_wait_semaphore)   : nullptr;
+            device_group_submit_info.signalSemaphoreCount          = n_signal_semaphores;
+            device_group_submit_info.sType                         = VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR;
+            device_group_submit_info.waitSemaphoreCount            = current_submission.n_wait_semaphores;
+
+            *next_ptr_ptr = &device_group_submit_info;
+            next_ptr_ptr  = &device_group_submit_info.pNext;
+        }
+
+        #if defined(_WIN32)
+        {
+            if (current_submission.has_d3d12_fence_semaphore_values)
+            {
+                VkD3D12FenceSubmitInfoKHR& fence_info = m_d3d12_fence_submit_infos_vk.at(n_submission);
+
+                fence_info.pNext                      = nullptr;
+                fence_info.pSignalSemaphoreValues     = (n_signal_semaphores                   != 0) ? &m_d3d12_fence_signal_semaphore_values.at(current_submission.first_signal_semaphore) : nullptr;
+                fence_info.pWaitSemaphoreValues       = (current_submission.n_wait_semaphores   != 0) ? &m_d3d12_fence_wait_semaphore_values.at  (current_submission.first_wait_semaphore)   : nullptr;
+                fence_info.signalSemaphoreValuesCount = n_signal_semaphores;
+                fence_info.sType                      = VK_STRUCTURE_TYPE_D3D12_FENCE_SUBMIT_INFO_KHR;
+                fence_info.waitSemaphoreValuesCount   = current_submission.n_wait_semaphores;
+
+                *next_ptr_ptr = &fence_info;
+                next_ptr_ptr  = &fence_info.pNext;
+            }
+
+            if (current_submission.n_keyed_mutex_acquire_keys + current_submission.n_keyed_mutex_release_keys > 0)
+            {
+                VkWin32KeyedMutexAcquireReleaseInfoKHR& info = m_keyed_mutex_acquire_release_infos_vk.at(n_submission);
+
+                info.acquireCount     = current_submission.n_keyed_mutex_acquire_keys;
+                info.pAcquireKeys     = (current_submission.n_keyed_mutex_acquire_keys != 0) ? &m_keyed_mutex_acquire_keys.at    (current_submission.first_keyed_mutex_acquire_key) : nullptr;
+                info.pAcquireSyncs    = (current_submission.n_keyed_mutex_acquire_keys != 0) ? &m_keyed_mutex_acquire_syncs.at   (current_submission.first_keyed_mutex_acquire_key) : nullptr;
+                info.pAcquireTimeouts = (current_submission.n_keyed_mutex_acquire_keys != 0) ? &m_keyed_mutex_acquire_timeouts.at(current_submission.first_keyed_mutex_acquire_key) : nullptr;
+                info.pNext            = nullptr;
+                info.pReleaseKeys     = (current_submission.n_keyed_mutex_release_keys != 0) ? &m_keyed_mutex_release_keys.at    (current_submission.first_keyed_mutex_release_key) : nullptr;
+                info.pReleaseSyncs    = (current_submission.n_keyed_mutex_release_keys != 0) ? &m_keyed_mutex_release_syncs.at   (current_submission.first_keyed_mutex_release_key) : nullptr;
+                info.releaseCount     = current_submission.n_keyed_mutex_release_keys;
+                info.sType            = VK_STRUCTURE_TYPE_WIN32_KEYED_MUTEX_ACQUIRE_RELEASE_INFO_KHR;
+
+                *next_ptr_ptr = &info;
+                next_ptr_ptr  = &info.pNext;
+            }
+        }
+        #endif
+
+        if (current_submission.has_timeline_semaphore_values ||
+            is_tracked)
+        {
+            VkTimelineSemaphoreSubmitInfoKHR& timeline_info = m_timeline_semaphore_submit_infos_vk.at(n_submission);
+
+            timeline_info.pNext                     = nullptr;
+            timeline_info.pSignalSemaphoreValues    = (n_signal_semaphores                   != 0) ? &m_timeline_signal_semaphore_values.at(current_submission.first_signal_semaphore) : nullptr;
+            timeline_info.pWaitSemaphoreValues      = (current_submission.n_wait_semaphores   != 0) ? &m_timeline_wait_semaphore_values.at  (current_submission.first_wait_semaphore)   : nullptr;
+            timeline_info.signalSemaphoreValueCount = n_signal_semaphores;
+            timeline_info.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+            timeline_info.waitSemaphoreValueCount   = current_submission.n_wait_semaphores;
+
+            *next_ptr_ptr = &timeline_info;
+            next_ptr_ptr  = &timeline_info.pNext;
+        }
+
+        if (current_submission.is_protected)
+        {
+            VkProtectedSubmitInfo& protected_submit_info = m_protected_submit_infos_vk.at(n_submission);
+
+            protected_submit_info.pNext           = nullptr;
+            protected_submit_info.protectedSubmit = VK_TRUE;
+            protected_submit_info.sType           = VK_STRUCTURE_TYPE_PROTECTED_SUBMIT_INFO;
+
+            *next_ptr_ptr = &protected_submit_info;
+            next_ptr_ptr  = &protected_submit_info.pNext;
+        }
+    }
+
+    return &m_submit_infos_vk.at(0);
+}
+
+/* Please see header for specification */
+void Anvil::SubmissionBatch::clear()
+{
+    /* NOTE: clear() does not release the memory backing the vectors, which is exactly what we want here. */
+    m_cmd_buffer_device_masks.clear         ();
+    m_cmd_buffer_ptrs.clear                 ();
+    m_cmd_buffers_vk.clear                  ();
+    m_signal_semaphore_device_indices.clear ();
+    m_signal_semaphore_ptrs.clear           ();
+    m_signal_semaphores_vk.clear            ();
+    m_submissions.clear                     ();
+    m_timeline_signal_semaphore_values.clear();
+    m_timeline_wait_semaphore_values.clear  ();
+    m_wait_semaphore_device_indices.clear   ();
+    m_wait_semaphore_dst_stage_masks.clear  ();
+    m_wait_semaphore_ptrs.clear             ();
+    m_wait_semaphores_vk.clear              ();
+
+    #if defined(_WIN32)
+    {
+        m_d3d12_fence_signal_semaphore_values.clear();
+        m_d3d12_fence_wait_semaphore_values.clear  ();
+        m_keyed_mutex_acquire_keys.clear           ();
+        m_keyed_mutex_acquire_syncs.clear          ();
+        m_keyed_mutex_acquire_timeouts.clear       ();
+        m_keyed_mutex_release_keys.clear           ();
+        m_keyed_mutex_release_syncs.clear          ();
+    }
+    #endif
+
+    m_fence_ptr    = nullptr;
+    m_should_block = false;
+    m_timeout      = UINT64_MAX;
+}
+
+/** Locks or unlocks all command buffers, semaphores and the fence referred to by the batch.
+ *
+ *  @param in_should_lock true to lock the objects, false to unlock them.
+ **/
+void Anvil::SubmissionBatch::lock_unlock(bool in_should_lock) const
+{
+    for (auto cmd_buffer_ptr : m_cmd_buffer_ptrs)
+    {
+        if (in_should_lock)
+        {
+            cmd_buffer_ptr->lock();
+        }
+        else
+        {
+            cmd_buffer_ptr->unlock();
+        }
+    }
+
+    for (auto semaphore_ptr : m_signal_semaphore_ptrs)
+    {
+        if (in_should_lock)
+        {
+            semaphore_ptr->lock();
+        }
+        else
+        {
+            semaphore_ptr->unlock();
+        }
+    }
+
+    for (auto semaphore_ptr : m_wait_semaphore_ptrs)
+    {
+        if (in_should_lock)
+        {
+            semaphore_ptr->lock();
+        }
+        else
+        {
+            semaphore_ptr->unlock();
+        }
+    }
+
+    if (m_fence_ptr != nullptr)
+    {
+        if (in_should_lock)
+        {
+            m_fence_ptr->lock();
+        }
+        else
+        {
+            m_fence_ptr->unlock();
+        }
+    }
+}
@@ -26,20 +26,7 @@
 /** Please see header for specification */
 Anvil::Time::Time()
 {
-    #ifdef _WIN32
-    {
-        QueryPerformanceFrequency(&m_frequency);
-        QueryPerformanceCounter  (&m_start_time);
-    }
-    #else
-    {
-        struct timespec current_timespec;
-
-        clock_gettime(CLOCK_MONOTONIC, &current_timespec);
-
-        m_start_time = static_cast<uint64_t>(1000LL /* SEC_TO_MSEC */ * current_timespec.tv_sec + current_timespec.tv_nsec / 1000000LL /* MSEC_TO_NSEC */);
-    }
-    #endif
+    m_start_time_nsec = get_absolute_time_in_nsec();
 }
 
 /** Please see header for specification */
@@ -49,17 +36,25 @@ Anvil::Time::~Time()
 }
 
 /** Please see header for specification */
-uint64_t Anvil::Time::get_time_in_msec()
+uint64_t Anvil::Time::get_absolute_time_in_nsec()
 {
     uint64_t result = 0;
 
     #ifdef _WIN32
     {
-        LARGE_INTEGER current_time;
+        static LARGE_INTEGER frequency = {};
+        LARGE_INTEGER        current_time;
+
+        if (frequency.QuadPart == 0)
+        {
+            QueryPerformanceFrequency(&frequency);
+        }
 
         QueryPerformanceCounter(&current_time);
 
-        result = static_cast<uint64_t>(((current_time.QuadPart - m_start_time.QuadPart) * 1000LL /* ms in s */ / m_frequency.QuadPart));
+        /* Split the conversion into whole seconds and the remainder, so that the multiplication does not overflow */
+        result = static_cast<uint64_t>( (current_time.QuadPart / frequency.QuadPart) * 1000000000LL /* SEC_TO_NSEC */ +
+                                        (current_time.QuadPart % frequency.QuadPart) * 1000000000LL /* SEC_TO_NSEC */ / frequency.QuadPart);
     }
     #else
     {
@@ -67,9 +62,21 @@ uint64_t Anvil::Time::get_time_in_msec()
 
         clock_gettime(CLOCK_MONOTONIC, &current_timespec);
 
-        result = 1000LL /* SEC_TO_MSEC */ * current_timespec.tv_sec + current_timespec.tv_nsec / 1000000LL /* MSEC_TO_NSEC */ - m_start_time;
+        result = static_cast<uint64_t>(1000000000LL /* SEC_TO_NSEC */ * current_timespec.tv_sec + current_timespec.tv_nsec);
     }
     #endif
 
     return result;
 }
+
+/** Please see header for specification */
+uint64_t Anvil::Time::get_time_in_msec()
+{
+    return get_time_in_nsec() / 1000000ull /* MSEC_TO_NSEC */;
+}
+
+/** Please see header for specification */
+uint64_t Anvil::Time::get_time_in_nsec()
+{
+    return get_absolute_time_in_nsec() - m_start_time_nsec;
+}
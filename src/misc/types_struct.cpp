@@ -531,6 +531,13 @@ Anvil::ExtensionKHRSwapchainEntrypoints::ExtensionKHRSwapchainEntrypoints()
     vkQueuePresentKHR       = nullptr;
 }
 
+Anvil::ExtensionKHRTimelineSemaphoreEntrypoints::ExtensionKHRTimelineSemaphoreEntrypoints()
+{
+    vkGetSemaphoreCounterValueKHR = nullptr;
+    vkSignalSemaphoreKHR          = nullptr;
+    vkWaitSemaphoresKHR           = nullptr;
+}
+
 #ifdef _WIN32
     #if defined(ANVIL_INCLUDE_WIN3264_WINDOW_SYSTEM_SUPPORT)
         Anvil::ExtensionKHRWin32SurfaceEntrypoints::ExtensionKHRWin32SurfaceEntrypoints()
@@ -1692,6 +1699,33 @@ bool Anvil::KHRShaderAtomicInt64Features::operator==(const KHRShaderAtomicInt64F
            (in_features.shader_shared_int64_atomics == shader_shared_int64_atomics);
 }
 
+Anvil::KHRTimelineSemaphoreFeatures::KHRTimelineSemaphoreFeatures()
+    :timeline_semaphore(false)
+{
+    /* Stub */
+}
+
+Anvil::KHRTimelineSemaphoreFeatures::KHRTimelineSemaphoreFeatures(const VkPhysicalDeviceTimelineSemaphoreFeaturesKHR& in_features)
+{
+    timeline_semaphore = VK_BOOL32_TO_BOOL(in_features.timelineSemaphore);
+}
+
+VkPhysicalDeviceTimelineSemaphoreFeaturesKHR Anvil::KHRTimelineSemaphoreFeatures::get_vk_physical_device_timeline_semaphore_features() const
+{
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR result;
+
+    result.pNext             = nullptr;
+    result.sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    result.timelineSemaphore = BOOL_TO_VK_BOOL32(timeline_semaphore);
+
+    return result;
+}
+
+bool Anvil::KHRTimelineSemaphoreFeatures::operator==(const KHRTimelineSemaphoreFeatures& in_features) const
+{
+    return (in_features.timeline_semaphore == timeline_semaphore);
+}
+
 Anvil::KHRShaderFloatControlsProperties::KHRShaderFloatControlsProperties()
     :separate_denorm_settings                   (false),
      separate_rounding_mode_settings            (false),
@@ -2859,6 +2893,7 @@ Anvil::PhysicalDeviceFeatures::PhysicalDeviceFeatures()
     khr_multiview_features_ptr                = nullptr;
     khr_sampler_ycbcr_conversion_features_ptr = nullptr;
     khr_shader_atomic_int64_features_ptr      = nullptr;
+    khr_timeline_semaphore_features_ptr       = nullptr;
     khr_variable_pointer_features_ptr         = nullptr;
     khr_vulkan_memory_model_features_ptr      = nullptr;
 }
@@ -2877,6 +2912,7 @@ Anvil::PhysicalDeviceFeatures::PhysicalDeviceFeatures(const PhysicalDeviceFeatur
                                                       const KHRMultiviewFeatures*              in_khr_multiview_features_ptr,
                                                       const KHRSamplerYCbCrConversionFeatures* in_khr_sampler_ycbcr_conversion_features_ptr,
                                                       const KHRShaderAtomicInt64Features*      in_khr_shader_atomic_int64_features_ptr,
+                                                      const KHRTimelineSemaphoreFeatures*      in_khr_timeline_semaphore_features_ptr,
                                                       const KHRVariablePointerFeatures*        in_khr_variable_pointer_features_ptr,
                                                       const KHRVulkanMemoryModelFeatures*      in_khr_vulkan_memory_model_features_ptr)
 {
@@ -2894,6 +2930,7 @@ Anvil::PhysicalDeviceFeatures::PhysicalDeviceFeatures(const PhysicalDeviceFeatur
     khr_multiview_features_ptr                = in_khr_multiview_features_ptr;
     khr_sampler_ycbcr_conversion_features_ptr = in_khr_sampler_ycbcr_conversion_features_ptr;
     khr_shader_atomic_int64_features_ptr      = in_khr_shader_atomic_int64_features_ptr;
+    khr_timeline_semaphore_features_ptr       = in_khr_timeline_semaphore_features_ptr;
     khr_variable_pointer_features_ptr         = in_khr_variable_pointer_features_ptr;
     khr_vulkan_memory_model_features_ptr      = in_khr_vulkan_memory_model_features_ptr;
 }
@@ -2915,6 +2952,7 @@ bool Anvil::PhysicalDeviceFeatures::operator==(const PhysicalDeviceFeatures& in_
     bool       khr_multiview_features_match                = false;
     bool       khr_sampler_ycbcr_conversion_features_match = false;
     bool       khr_shader_atomic_int64_features_match      = false;
+    bool       khr_timeline_semaphore_features_match       = false;
     bool       khr_variable_pointer_features_match         = false;
     bool       khr_vulkan_memory_features_match            = false;
 
@@ -3045,6 +3083,17 @@ bool Anvil::PhysicalDeviceFeatures::operator==(const PhysicalDeviceFeatures& in_
                                                   in_physical_device_features.khr_shader_atomic_int64_features_ptr == nullptr);
     }
 
+    if (khr_timeline_semaphore_features_ptr                             != nullptr &&
+        in_physical_device_features.khr_timeline_semaphore_features_ptr != nullptr)
+    {
+        khr_timeline_semaphore_features_match = (*khr_timeline_semaphore_features_ptr == *in_physical_device_features.khr_timeline_semaphore_features_ptr);
+    }
+    else
+    {
+        khr_timeline_semaphore_features_match = (khr_timeline_semaphore_features_ptr                             == nullptr &&
+                                                 in_physical_device_features.khr_timeline_semaphore_features_ptr == nullptr);
+    }
+
     if (khr_variable_pointer_features_ptr                             != nullptr &&
         in_physical_device_features.khr_variable_pointer_features_ptr != nullptr)
     {
@@ -3081,6 +3130,7 @@ bool Anvil::PhysicalDeviceFeatures::operator==(const PhysicalDeviceFeatures& in_
            khr_multiview_features_match                &&
            khr_sampler_ycbcr_conversion_features_match &&
            khr_shader_atomic_int64_features_match      &&
+           khr_timeline_semaphore_features_match       &&
            khr_variable_pointer_features_match         &&
            khr_vulkan_memory_features_match;
 }
@@ -4137,6 +4187,8 @@ Anvil::SubmitInfo::SubmitInfo(uint32_t                         in_n_command_buff
      signal_semaphores_mgpu_ptr                    (nullptr),
      signal_semaphores_sgpu_ptr                    (in_opt_semaphore_to_signal_ptrs_ptr),
      should_block                                  (in_should_block),
+     timeline_signal_semaphore_values_ptr          (nullptr),
+     timeline_wait_semaphore_values_ptr            (nullptr),
      timeout                                       (UINT64_MAX),
      type                                          (SubmissionType::SGPU),
      wait_semaphores_mgpu_ptr                      (nullptr),
@@ -4202,6 +4254,8 @@ Anvil::SubmitInfo::SubmitInfo(uint32_t                           in_n_command_bu
      signal_semaphores_mgpu_ptr                    (in_opt_signal_semaphore_submissions_ptr),
      signal_semaphores_sgpu_ptr                    (nullptr),
      should_block                                  (in_should_block),
+     timeline_signal_semaphore_values_ptr          (nullptr),
+     timeline_wait_semaphore_values_ptr            (nullptr),
      timeout                                       (UINT64_MAX),
      type                                          (SubmissionType::MGPU),
      wait_semaphores_mgpu_ptr                      (in_opt_wait_semaphore_submissions_ptr),
@@ -78,9 +78,9 @@ Anvil::Buffer::~Buffer()
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroyBuffer(m_device_ptr->get_device_vk(),
-                                           m_buffer,
-                                           nullptr /* pAllocator */);
+            m_device_ptr->get_dispatch_table().vkDestroyBuffer(m_device_ptr->get_device_vk(),
+                                                               m_buffer,
+                                                               nullptr /* pAllocator */);
         }
         unlock();
 
@@ -181,7 +181,13 @@ Anvil::MemoryBlock* Anvil::Buffer::get_memory_block(uint32_t in_n_memory_block)
 
     if (is_sparse)
     {
-        return m_page_tracker_ptr->get_memory_block(in_n_memory_block);
+        const auto& bindings = m_page_tracker_ptr->get_bindings();
+
+        anvil_assert(in_n_memory_block < bindings.size() );
+
+        return (in_n_memory_block < bindings.size() ) ? std::next(bindings.begin(),
+                                                                  in_n_memory_block)->second.memory_block_ptr
+                                                      : nullptr;
     }
     else
     {
@@ -277,12 +283,12 @@ bool Anvil::Buffer::init()
 
         /* Create the buffer object */
         {
-            auto struct_chain_ptr = struct_chainer.create_chain();
+            auto root_struct_ptr = struct_chainer.bake_chain();
 
-            result = Anvil::Vulkan::vkCreateBuffer(m_device_ptr->get_device_vk(),
-                                                   struct_chain_ptr->get_root_struct(),
-                                                   nullptr, /* pAllocator */
-                                                  &m_buffer);
+            result = m_device_ptr->get_dispatch_table().vkCreateBuffer(m_device_ptr->get_device_vk(),
+                                                                       root_struct_ptr,
+                                                                       nullptr, /* pAllocator */
+                                                                      &m_buffer);
         }
 
         anvil_assert_vk_call_succeeded(result);
@@ -353,9 +359,9 @@ bool Anvil::Buffer::init()
             }
             else
             {
-                Anvil::Vulkan::vkGetBufferMemoryRequirements(m_device_ptr->get_device_vk(),
-                                                             m_buffer,
-                                                            &m_buffer_memory_reqs);
+                m_device_ptr->get_dispatch_table().vkGetBufferMemoryRequirements(m_device_ptr->get_device_vk(),
+                                                                                 m_buffer,
+                                                                                &m_buffer_memory_reqs);
             }
         }
     }
@@ -479,17 +485,14 @@ end:
     return is_vk_call_successful(result);
 }
 
-/* TODO */
-bool Anvil::Buffer::init_staging_buffer(const VkDeviceSize& in_size,
-                                        Anvil::Queue*       in_opt_queue_ptr)
+/* Please see header for specification */
+Anvil::Queue* Anvil::Buffer::get_staging_queue(Anvil::Queue*               in_opt_queue_ptr,
+                                               Anvil::QueueFamilyFlagBits* out_queue_fam_bits_ptr) const
 {
-    Anvil::PrimaryCommandBufferUniquePtr      copy_cmdbuf_ptr;
-    std::vector<const Anvil::PhysicalDevice*> helper_vec;
-    const auto                                queue_fams                    = m_create_info_ptr->get_queue_families();
-    Anvil::QueueFamilyFlagBits                staging_buffer_queue_fam_bits = Anvil::QueueFamilyFlagBits::NONE;
+    const auto    queue_fams = m_create_info_ptr->get_queue_families();
+    Anvil::Queue* result_ptr = nullptr;
 
-    m_staging_buffer_ptr.reset();
-    m_staging_buffer_queue_ptr = nullptr;
+    *out_queue_fam_bits_ptr = Anvil::QueueFamilyFlagBits::NONE;
 
     if (m_create_info_ptr->get_sharing_mode() == Anvil::SharingMode::EXCLUSIVE)
     {
@@ -501,9 +504,9 @@ bool Anvil::Buffer::init_staging_buffer(const VkDeviceSize& in_size,
         {
             switch (queue_fams.get_vk() )
             {
-                case static_cast<uint32_t>(Anvil::QueueFamilyFlagBits::COMPUTE_BIT):  m_staging_buffer_queue_ptr = m_device_ptr->get_compute_queue  (0); break;
-                case static_cast<uint32_t>(Anvil::QueueFamilyFlagBits::DMA_BIT):      m_staging_buffer_queue_ptr = m_device_ptr->get_transfer_queue (0); break;
-                case static_cast<uint32_t>(Anvil::QueueFamilyFlagBits::GRAPHICS_BIT): m_staging_buffer_queue_ptr = m_device_ptr->get_universal_queue(0); break;
+                case static_cast<uint32_t>(Anvil::QueueFamilyFlagBits::COMPUTE_BIT):  result_ptr = m_device_ptr->get_compute_queue  (0); break;
+                case static_cast<uint32_t>(Anvil::QueueFamilyFlagBits::DMA_BIT):      result_ptr = m_device_ptr->get_transfer_queue (0); break;
+                case static_cast<uint32_t>(Anvil::QueueFamilyFlagBits::GRAPHICS_BIT): result_ptr = m_device_ptr->get_universal_queue(0); break;
 
                 default:
                 {
@@ -515,16 +518,21 @@ bool Anvil::Buffer::init_staging_buffer(const VkDeviceSize& in_size,
         {
             anvil_assert(in_opt_queue_ptr != nullptr);
 
-            m_staging_buffer_queue_ptr = in_opt_queue_ptr;
+            result_ptr = in_opt_queue_ptr;
         }
 
-        anvil_assert(m_staging_buffer_queue_ptr != nullptr);
+        anvil_assert(result_ptr != nullptr);
 
-        switch (m_device_ptr->get_queue_family_type(m_staging_buffer_queue_ptr->get_queue_family_index() ) )
+        if (result_ptr == nullptr)
         {
-            case Anvil::QueueFamilyType::COMPUTE:   staging_buffer_queue_fam_bits = Anvil::QueueFamilyFlagBits::COMPUTE_BIT;  break;
-            case Anvil::QueueFamilyType::TRANSFER:  staging_buffer_queue_fam_bits = Anvil::QueueFamilyFlagBits::DMA_BIT;      break;
-            case Anvil::QueueFamilyType::UNIVERSAL: staging_buffer_queue_fam_bits = Anvil::QueueFamilyFlagBits::GRAPHICS_BIT; break;
+            goto end;
+        }
+
+        switch (m_device_ptr->get_queue_family_type(result_ptr->get_queue_family_index() ) )
+        {
+            case Anvil::QueueFamilyType::COMPUTE:   *out_queue_fam_bits_ptr = Anvil::QueueFamilyFlagBits::COMPUTE_BIT;  break;
+            case Anvil::QueueFamilyType::TRANSFER:  *out_queue_fam_bits_ptr = Anvil::QueueFamilyFlagBits::DMA_BIT;      break;
+            case Anvil::QueueFamilyType::UNIVERSAL: *out_queue_fam_bits_ptr = Anvil::QueueFamilyFlagBits::GRAPHICS_BIT; break;
 
             default:
             {
@@ -537,24 +545,45 @@ bool Anvil::Buffer::init_staging_buffer(const VkDeviceSize& in_size,
         /* We can use any queue from the list of queue fams this buffer is compatible with, in order to perform the copy op. */
         if ((queue_fams & Anvil::QueueFamilyFlagBits::GRAPHICS_BIT) != 0)
         {
-            m_staging_buffer_queue_ptr    = m_device_ptr->get_universal_queue(0);
-            staging_buffer_queue_fam_bits = Anvil::QueueFamilyFlagBits::GRAPHICS_BIT;
+            result_ptr              = m_device_ptr->get_universal_queue(0);
+            *out_queue_fam_bits_ptr = Anvil::QueueFamilyFlagBits::GRAPHICS_BIT;
         }
         else
         if ((queue_fams & Anvil::QueueFamilyFlagBits::DMA_BIT) != 0)
         {
-            m_staging_buffer_queue_ptr    = m_device_ptr->get_transfer_queue(0);
-            staging_buffer_queue_fam_bits = Anvil::QueueFamilyFlagBits::DMA_BIT;
+            result_ptr              = m_device_ptr->get_transfer_queue(0);
+            *out_queue_fam_bits_ptr = Anvil::QueueFamilyFlagBits::DMA_BIT;
         }
         else
         {
             anvil_assert((queue_fams & Anvil::QueueFamilyFlagBits::COMPUTE_BIT) != 0)
 
-            m_staging_buffer_queue_ptr    = m_device_ptr->get_compute_queue(0);
-            staging_buffer_queue_fam_bits = Anvil::QueueFamilyFlagBits::COMPUTE_BIT;
+            result_ptr              = m_device_ptr->get_compute_queue(0);
+            *out_queue_fam_bits_ptr = Anvil::QueueFamilyFlagBits::COMPUTE_BIT;
         }
     }
 
+end:
+    return result_ptr;
+}
+
+/* TODO */
+bool Anvil::Buffer::init_staging_buffer(const VkDeviceSize& in_size,
+                                        Anvil::Queue*       in_opt_queue_ptr)
+{
+    Anvil::QueueFamilyFlagBits staging_buffer_queue_fam_bits = Anvil::QueueFamilyFlagBits::NONE;
+
+    m_staging_buffer_ptr.reset();
+
+    m_staging_buffer_queue_ptr = get_staging_queue(in_opt_queue_ptr,
+                                                  &staging_buffer_queue_fam_bits);
+
+    if (m_staging_buffer_queue_ptr == nullptr)
+    {
+        /* Cannot tell which queue to use for the copy op */
+        goto end;
+    }
+
     if (m_staging_buffer_ptr == nullptr                                   ||
         m_staging_buffer_ptr->get_create_info_ptr()->get_size() < in_size)
     {
@@ -581,6 +610,7 @@ bool Anvil::Buffer::init_staging_buffer(const VkDeviceSize& in_size,
         }
     }
 
+end:
     return (m_staging_buffer_ptr != nullptr);
 }
 
@@ -779,10 +809,10 @@ bool Anvil::Buffer::set_memory_nonsparse_internal(MemoryBlockUniquePtr  in_memor
     {
         lock();
         {
-            result_vk = Anvil::Vulkan::vkBindBufferMemory(m_device_ptr->get_device_vk(),
-                                                          m_buffer,
-                                                          in_memory_block_ptr->get_memory      (),
-                                                          in_memory_block_ptr->get_start_offset() );
+            result_vk = m_device_ptr->get_dispatch_table().vkBindBufferMemory(m_device_ptr->get_device_vk(),
+                                                                              m_buffer,
+                                                                              in_memory_block_ptr->get_memory      (),
+                                                                              in_memory_block_ptr->get_start_offset() );
         }
         unlock();
     }
@@ -21,9 +21,13 @@
 //
 
 #include "misc/callbacks.h"
+#include "misc/command_stream.h"
 #include "misc/debug.h"
 #include "misc/descriptor_set_create_info.h"
 #include "misc/memory_block_create_info.h"
+#include "misc/pipeline_barrier_batch.h"
+#include "misc/redundant_state_filter.h"
+#include "misc/resource_state_tracker.h"
 #include "misc/struct_chainer.h"
 #include "wrappers/buffer.h"
 #include "wrappers/buffer_view.h"
@@ -50,31 +54,6 @@
 bool Anvil::CommandBufferBase::m_command_stashing_disabled = false;
 
 
-/** Please see header for specification */
-Anvil::CommandBufferBase::BeginQueryCommand::BeginQueryCommand(Anvil::QueryPool*        in_query_pool_ptr,
-                                                               Anvil::QueryIndex        in_entry,
-                                                               Anvil::QueryControlFlags in_flags)
-    :Command(COMMAND_TYPE_BEGIN_QUERY)
-{
-    entry          = in_entry;
-    flags          = in_flags;
-    query_pool_ptr = in_query_pool_ptr;
-}
-
-/** Please see header for specification */
-Anvil::BeginQueryIndexedEXTCommand::BeginQueryIndexedEXTCommand(Anvil::QueryPool*               in_query_pool_ptr,
-                                                                const uint32_t&                 in_query,
-                                                                const Anvil::QueryControlFlags& in_flags,
-                                                                const uint32_t&                 in_index)
-    :Command       (COMMAND_TYPE_BEGIN_QUERY_INDEXED_EXT),
-     flags         (in_flags),
-     index         (in_index),
-     query         (in_query),
-     query_pool_ptr(in_query_pool_ptr)
-{
-    /* Stub */
-}
-
 /** Please see header for specification */
 Anvil::BeginRenderPassCommand::BeginRenderPassCommand(uint32_t                                in_n_clear_values,
                                                       const VkClearValue*                     in_clear_value_ptrs,
@@ -128,629 +107,12 @@ Anvil::BeginRenderPassCommand::BeginRenderPassCommand(uint32_t
     }
 }
 
-/** Please see header for specification */
-Anvil::BeginTransformFeedbackEXTCommand::BeginTransformFeedbackEXTCommand(const uint32_t&                          in_first_counter_buffer,
-                                                                          const std::vector<const Anvil::Buffer*>& in_counter_buffer_ptrs,
-                                                                          const std::vector<VkDeviceSize>&         in_counter_buffer_offsets)
-    :Command               (COMMAND_TYPE_BEGIN_TRANSFORM_FEEDBACK_EXT),
-     counter_buffer_ptrs   (in_counter_buffer_ptrs),
-     counter_buffer_offsets(in_counter_buffer_offsets),
-     first_counter_buffer  (in_first_counter_buffer)
-{
-    /* Stub */
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::BindDescriptorSetsCommand::BindDescriptorSetsCommand(Anvil::PipelineBindPoint           in_pipeline_bind_point,
-                                                                               Anvil::PipelineLayout*             in_layout_ptr,
-                                                                               uint32_t                           in_first_set,
-                                                                               uint32_t                           in_set_count,
-                                                                               const Anvil::DescriptorSet* const* in_descriptor_set_ptrs,
-                                                                               uint32_t                           in_dynamic_offset_count,
-                                                                               const uint32_t*                    in_dynamic_offset_ptrs)
-    :Command(COMMAND_TYPE_BIND_DESCRIPTOR_SETS)
-{
-    first_set           = in_first_set;
-    layout_ptr          = in_layout_ptr;
-    pipeline_bind_point = in_pipeline_bind_point;
-
-    for (uint32_t n_set = 0;
-                  n_set < in_set_count;
-                ++n_set)
-    {
-        descriptor_sets.push_back(in_descriptor_set_ptrs[n_set]);
-    }
-
-    for (uint32_t n_dynamic_offset = 0;
-                  n_dynamic_offset < in_dynamic_offset_count;
-                ++n_dynamic_offset)
-    {
-        dynamic_offsets.push_back(in_dynamic_offset_ptrs[n_dynamic_offset]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::BindIndexBufferCommand::BindIndexBufferCommand(Anvil::Buffer*   in_buffer_ptr,
-                                                                         VkDeviceSize     in_offset,
-                                                                         Anvil::IndexType in_index_type)
-    :Command(COMMAND_TYPE_BIND_INDEX_BUFFER)
-{
-    buffer     = in_buffer_ptr->get_buffer();
-    buffer_ptr = in_buffer_ptr;
-    index_type = in_index_type;
-    offset     = in_offset;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::BindPipelineCommand::BindPipelineCommand(Anvil::PipelineBindPoint in_pipeline_bind_point,
-                                                                   Anvil::PipelineID        in_pipeline_id)
-    :Command(COMMAND_TYPE_BIND_PIPELINE)
-{
-    pipeline_bind_point = in_pipeline_bind_point;
-    pipeline_id         = in_pipeline_id;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::BindVertexBuffersCommand::BindVertexBuffersCommand(uint32_t            in_start_binding,
-                                                                             uint32_t            in_binding_count,
-                                                                             Anvil::Buffer**     in_buffer_ptrs,
-                                                                             const VkDeviceSize* in_offset_ptrs)
-    :Command(COMMAND_TYPE_BIND_VERTEX_BUFFER)
-{
-    start_binding = in_start_binding;
-
-    for (uint32_t n_binding = 0;
-                  n_binding < in_binding_count;
-                ++n_binding)
-    {
-        bindings.push_back(BindVertexBuffersCommandBinding(in_buffer_ptrs[n_binding],
-                                                           in_offset_ptrs[n_binding]) );
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::BindVertexBuffersCommandBinding::BindVertexBuffersCommandBinding(const BindVertexBuffersCommandBinding& in)
-{
-    buffer     = in.buffer;
-    buffer_ptr = in.buffer_ptr;
-    offset     = in.offset;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::BindVertexBuffersCommandBinding::BindVertexBuffersCommandBinding(Anvil::Buffer* in_buffer_ptr,
-                                                                                           VkDeviceSize   in_offset)
-{
-    buffer     = in_buffer_ptr->get_buffer();
-    buffer_ptr = in_buffer_ptr;
-    offset     = in_offset;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::BlitImageCommand::BlitImageCommand(Anvil::Image*           in_src_image_ptr,
-                                                             Anvil::ImageLayout      in_src_image_layout,
-                                                             Anvil::Image*           in_dst_image_ptr,
-                                                             Anvil::ImageLayout      in_dst_image_layout,
-                                                             uint32_t                in_region_count,
-                                                             const Anvil::ImageBlit* in_region_ptrs,
-                                                             Anvil::Filter           in_filter)
-    :Command(COMMAND_TYPE_BLIT_IMAGE)
-{
-    dst_image        = in_dst_image_ptr->get_image();
-    dst_image_layout = in_dst_image_layout;
-    dst_image_ptr    = in_dst_image_ptr;
-    filter           = in_filter;
-    src_image        = in_src_image_ptr->get_image();
-    src_image_layout = in_src_image_layout;
-    src_image_ptr    = in_src_image_ptr;
-
-    for (uint32_t n_region = 0;
-                  n_region < in_region_count;
-                ++n_region)
-    {
-        regions.push_back(in_region_ptrs[n_region]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::BindTransformFeedbackBuffersEXTCommand::BindTransformFeedbackBuffersEXTCommand(const uint32_t&                    in_first_binding,
-                                                                                      const uint32_t&                    in_n_bindings,
-                                                                                      const std::vector<Anvil::Buffer*>& in_buffer_ptrs,
-                                                                                      const std::vector<VkDeviceSize>&   in_offsets,
-                                                                                      const std::vector<VkDeviceSize>&   in_sizes)
-    :Command      (COMMAND_TYPE_BIND_TRANSFORM_FEEDBACK_BUFFERS_EXT),
-     buffer_ptrs  (in_buffer_ptrs),
-     first_binding(in_first_binding),
-     n_bindings   (in_n_bindings),
-     offsets      (in_offsets),
-     sizes        (in_sizes)
-{
-    /* Stub */
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::ClearAttachmentsCommand::ClearAttachmentsCommand(uint32_t                      in_n_attachments,
-                                                                           const Anvil::ClearAttachment* in_attachments,
-                                                                           uint32_t                      in_n_rects,
-                                                                           const VkClearRect*            in_rect_ptrs)
-    :Command(COMMAND_TYPE_CLEAR_ATTACHMENTS)
-{
-    for (uint32_t n_attachment = 0;
-                  n_attachment < in_n_attachments;
-                ++n_attachment)
-    {
-        attachments.push_back(ClearAttachmentsCommandAttachment(in_attachments[n_attachment].aspect_mask,
-                                                                in_attachments[n_attachment].clear_value,
-                                                                in_attachments[n_attachment].color_attachment) );
-    }
-
-    for (uint32_t n_rect = 0;
-                  n_rect < in_n_rects;
-                ++n_rect)
-    {
-        rects.push_back(in_rect_ptrs[n_rect]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::ClearColorImageCommand::ClearColorImageCommand(Anvil::Image*                       in_image_ptr,
-                                                                         Anvil::ImageLayout                  in_image_layout,
-                                                                         const VkClearColorValue*            in_color_ptr,
-                                                                         uint32_t                            in_range_count,
-                                                                         const Anvil::ImageSubresourceRange* in_range_ptrs)
-    :Command(COMMAND_TYPE_CLEAR_COLOR_IMAGE)
-{
-    color        = *in_color_ptr;
-    image        = in_image_ptr->get_image();
-    image_layout = in_image_layout;
-    image_ptr    = in_image_ptr;
-
-    for (uint32_t n_range = 0;
-                  n_range < in_range_count;
-                ++n_range)
-    {
-        ranges.push_back(in_range_ptrs[n_range]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::ClearDepthStencilImageCommand::ClearDepthStencilImageCommand(Anvil::Image*                       in_image_ptr,
-                                                                                       Anvil::ImageLayout                  in_image_layout,
-                                                                                       const VkClearDepthStencilValue*     in_depth_stencil_ptr,
-                                                                                       uint32_t                            in_range_count,
-                                                                                       const Anvil::ImageSubresourceRange* in_range_ptrs)
-    :Command(COMMAND_TYPE_CLEAR_DEPTH_STENCIL_IMAGE)
-{
-    depth_stencil = *in_depth_stencil_ptr;
-    image         =  in_image_ptr->get_image();
-    image_layout  =  in_image_layout;
-    image_ptr     =  in_image_ptr;
-
-    for (uint32_t n_range = 0;
-                  n_range < in_range_count;
-                ++n_range)
-    {
-        ranges.push_back(in_range_ptrs[n_range]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::CopyBufferCommand::CopyBufferCommand(Anvil::Buffer*           in_src_buffer_ptr,
-                                                               Anvil::Buffer*           in_dst_buffer_ptr,
-                                                               uint32_t                 in_region_count,
-                                                               const Anvil::BufferCopy* in_region_ptrs)
-    :Command(COMMAND_TYPE_COPY_BUFFER)
-{
-    dst_buffer     = in_dst_buffer_ptr->get_buffer();
-    dst_buffer_ptr = in_dst_buffer_ptr;
-    src_buffer     = in_src_buffer_ptr->get_buffer();
-    src_buffer_ptr = in_src_buffer_ptr;
-
-    for (uint32_t n_region = 0;
-                  n_region < in_region_count;
-                ++n_region)
-    {
-        regions.push_back(in_region_ptrs[n_region]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::CopyBufferToImageCommand::CopyBufferToImageCommand(Anvil::Buffer*                in_src_buffer_ptr,
-                                                                             Anvil::Image*                 in_dst_image_ptr,
-                                                                             Anvil::ImageLayout            in_dst_image_layout,
-                                                                             uint32_t                      in_region_count,
-                                                                             const Anvil::BufferImageCopy* in_region_ptrs)
-    :Command(COMMAND_TYPE_COPY_BUFFER_TO_IMAGE)
-{
-    dst_image        = in_dst_image_ptr->get_image();
-    dst_image_layout = in_dst_image_layout;
-    dst_image_ptr    = in_dst_image_ptr;
-    src_buffer       = in_src_buffer_ptr->get_buffer();
-    src_buffer_ptr   = in_src_buffer_ptr;
-
-    for (uint32_t n_region = 0;
-                  n_region < in_region_count;
-                ++n_region)
-    {
-        regions.push_back(in_region_ptrs[n_region]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::CopyImageCommand::CopyImageCommand(Anvil::Image*           in_src_image_ptr,
-                                                             Anvil::ImageLayout      in_src_image_layout,
-                                                             Anvil::Image*           in_dst_image_ptr,
-                                                             Anvil::ImageLayout      in_dst_image_layout,
-                                                             uint32_t                in_region_count,
-                                                             const Anvil::ImageCopy* in_region_ptrs)
-    :Command(COMMAND_TYPE_COPY_IMAGE)
-{
-    dst_image        = in_dst_image_ptr->get_image();
-    dst_image_layout = in_dst_image_layout;
-    dst_image_ptr    = in_dst_image_ptr;
-    src_image        = in_src_image_ptr->get_image();
-    src_image_layout = in_src_image_layout;
-    src_image_ptr    = in_src_image_ptr;
-
-    for (uint32_t n_region = 0;
-                  n_region < in_region_count;
-                ++n_region)
-    {
-        regions.push_back(in_region_ptrs[n_region]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::CopyImageToBufferCommand::CopyImageToBufferCommand(Anvil::Image*                 in_src_image_ptr,
-                                                                             Anvil::ImageLayout            in_src_image_layout,
-                                                                             Anvil::Buffer*                in_dst_buffer_ptr,
-                                                                             uint32_t                      in_region_count,
-                                                                             const Anvil::BufferImageCopy* in_region_ptrs)
-    :Command(COMMAND_TYPE_COPY_IMAGE_TO_BUFFER)
-{
-    dst_buffer       = in_dst_buffer_ptr->get_buffer();
-    dst_buffer_ptr   = in_dst_buffer_ptr;
-    src_image        = in_src_image_ptr->get_image();
-    src_image_layout = in_src_image_layout;
-    src_image_ptr    = in_src_image_ptr;
-
-    for (uint32_t n_region = 0;
-                  n_region < in_region_count;
-                ++n_region)
-    {
-        regions.push_back(in_region_ptrs[n_region]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::CopyQueryPoolResultsCommand::CopyQueryPoolResultsCommand(Anvil::QueryPool*  in_query_pool_ptr,
-                                                                                   Anvil::QueryIndex  in_start_query,
-                                                                                   uint32_t           in_query_count,
-                                                                                   Anvil::Buffer*     in_dst_buffer_ptr,
-                                                                                   VkDeviceSize       in_dst_offset,
-                                                                                   VkDeviceSize       in_dst_stride,
-                                                                                   VkQueryResultFlags in_flags)
-    :Command(COMMAND_TYPE_COPY_QUERY_POOL_RESULTS)
-{
-    dst_buffer     = in_dst_buffer_ptr->get_buffer();
-    dst_buffer_ptr = in_dst_buffer_ptr;
-    dst_offset     = in_dst_offset;
-    dst_stride     = in_dst_stride;
-    flags          = in_flags;
-    query_count    = in_query_count;
-    query_pool_ptr = in_query_pool_ptr;
-    start_query    = in_start_query;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DebugMarkerBeginEXTCommand::DebugMarkerBeginEXTCommand(const std::string& in_marker_name,
-                                                                                 const float*       in_color)
-    :Command(Anvil::COMMAND_TYPE_DEBUG_MARKER_BEGIN_EXT)
-{
-    if (in_color != nullptr)
-    {
-        memcpy(color,
-               in_color,
-               sizeof(color) );
-    }
-    else
-    {
-        memset(color,
-               0,
-               sizeof(color) );
-    }
-
-    marker_name = in_marker_name;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DebugMarkerEndEXTCommand::DebugMarkerEndEXTCommand()
-    :Command(Anvil::COMMAND_TYPE_DEBUG_MARKER_END_EXT)
-{
-    /* Stub */
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DebugMarkerInsertEXTCommand::DebugMarkerInsertEXTCommand(const std::string& in_marker_name,
-                                                                                   const float*       in_color)
-    :Command(Anvil::COMMAND_TYPE_DEBUG_MARKER_INSERT_EXT)
-{
-    if (in_color != nullptr)
-    {
-        memcpy(color,
-               in_color,
-               sizeof(color) );
-    }
-    else
-    {
-        memset(color,
-               0,
-               sizeof(color) );
-    }
-
-    marker_name = in_marker_name;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DispatchCommand::DispatchCommand(uint32_t in_x,
-                                                           uint32_t in_y,
-                                                           uint32_t in_z)
-    :Command(COMMAND_TYPE_DISPATCH)
-{
-    x = in_x;
-    y = in_y;
-    z = in_z;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DispatchBaseKHRCommand::DispatchBaseKHRCommand(uint32_t in_base_group_x,
-                                                                         uint32_t in_base_group_y,
-                                                                         uint32_t in_base_group_z,
-                                                                         uint32_t in_group_count_x,
-                                                                         uint32_t in_group_count_y,
-                                                                         uint32_t in_group_count_z)
-    :Command(COMMAND_TYPE_DISPATCH_BASE_KHR)
-{
-    base_group_x  = in_base_group_x;
-    base_group_y  = in_base_group_y;
-    base_group_z  = in_base_group_z;
-    group_count_x = in_group_count_x;
-    group_count_y = in_group_count_y;
-    group_count_z = in_group_count_z;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DispatchIndirectCommand::DispatchIndirectCommand(Anvil::Buffer* in_buffer_ptr,
-                                                                           VkDeviceSize   in_offset)
-    :Command(COMMAND_TYPE_DISPATCH_INDIRECT)
-{
-    buffer     = in_buffer_ptr->get_buffer();
-    buffer_ptr = in_buffer_ptr;
-    offset     = in_offset;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DrawCommand::DrawCommand(uint32_t in_vertex_count,
-                                                   uint32_t in_instance_count,
-                                                   uint32_t in_first_vertex,
-                                                   uint32_t in_first_instance)
-    :Command(COMMAND_TYPE_DRAW)
-{
-    first_instance = in_first_instance;
-    first_vertex   = in_first_vertex;
-    instance_count = in_instance_count;
-    vertex_count   = in_vertex_count;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DrawIndexedCommand::DrawIndexedCommand(uint32_t in_index_count,
-                                                                 uint32_t in_instance_count,
-                                                                 uint32_t in_first_index,
-                                                                 int32_t  in_vertex_offset,
-                                                                 uint32_t in_first_instance)
-    :Command(COMMAND_TYPE_DRAW_INDEXED)
-{
-    first_index    = in_first_index;
-    first_instance = in_first_instance;
-    index_count    = in_index_count;
-    instance_count = in_instance_count;
-    vertex_offset  = in_vertex_offset;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DrawIndexedIndirectCommand::DrawIndexedIndirectCommand(Anvil::Buffer* in_buffer_ptr,
-                                                                                 VkDeviceSize   in_offset,
-                                                                                 uint32_t       in_draw_count,
-                                                                                 uint32_t       in_stride)
-    :Command(COMMAND_TYPE_DRAW_INDEXED_INDIRECT)
-{
-    buffer     = in_buffer_ptr->get_buffer();
-    buffer_ptr = in_buffer_ptr;
-    draw_count = in_draw_count;
-    offset     = in_offset;
-    stride     = in_stride;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DrawIndirectByteCountEXTCommand::DrawIndirectByteCountEXTCommand(const uint32_t&     in_instance_count,
-                                                                                           const uint32_t&     in_first_instance,
-                                                                                           Anvil::Buffer*      in_counter_buffer_ptr,
-                                                                                           const VkDeviceSize& in_counter_buffer_offset,
-                                                                                           const uint32_t&     in_counter_offset,
-                                                                                           const uint32_t&     in_vertex_stride)
-    :Command(COMMAND_TYPE_DRAW_INDIRECT_BYTE_COUNT_EXT)
-{
-    counter_buffer_offset = in_counter_buffer_offset;
-    counter_buffer_ptr    = in_counter_buffer_ptr;
-    counter_offset        = in_counter_offset;
-    first_instance        = in_first_instance;
-    instance_count        = in_instance_count;
-    vertex_stride         = in_vertex_stride;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DrawIndexedIndirectCountAMDCommand::DrawIndexedIndirectCountAMDCommand(Anvil::Buffer* in_buffer_ptr,
-                                                                                                 VkDeviceSize   in_offset,
-                                                                                                 Anvil::Buffer* in_count_buffer_ptr,
-                                                                                                 VkDeviceSize   in_count_offset,
-                                                                                                 uint32_t       in_max_draw_count,
-                                                                                                 uint32_t       in_stride)
-    :Command(COMMAND_TYPE_DRAW_INDEXED_INDIRECT_COUNT_AMD)
-{
-    buffer           = in_buffer_ptr->get_buffer();
-    buffer_ptr       = in_buffer_ptr;
-    count_buffer     = in_count_buffer_ptr->get_buffer();
-    count_buffer_ptr = in_count_buffer_ptr;
-    count_offset     = in_count_offset;
-    max_draw_count   = in_max_draw_count;
-    offset           = in_offset;
-    stride           = in_stride;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DrawIndexedIndirectCountKHRCommand::DrawIndexedIndirectCountKHRCommand(Anvil::Buffer* in_buffer_ptr,
-                                                                                                 VkDeviceSize   in_offset,
-                                                                                                 Anvil::Buffer* in_count_buffer_ptr,
-                                                                                                 VkDeviceSize   in_count_offset,
-                                                                                                 uint32_t       in_max_draw_count,
-                                                                                                 uint32_t       in_stride)
-    :Command(COMMAND_TYPE_DRAW_INDEXED_INDIRECT_COUNT_KHR)
-{
-    buffer           = in_buffer_ptr->get_buffer();
-    buffer_ptr       = in_buffer_ptr;
-    count_buffer     = in_count_buffer_ptr->get_buffer();
-    count_buffer_ptr = in_count_buffer_ptr;
-    count_offset     = in_count_offset;
-    max_draw_count   = in_max_draw_count;
-    offset           = in_offset;
-    stride           = in_stride;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DrawIndirectCommand::DrawIndirectCommand(Anvil::Buffer* in_buffer_ptr,
-                                                                   VkDeviceSize   in_offset,
-                                                                   uint32_t       in_count,
-                                                                   uint32_t       in_stride)
-    :Command(COMMAND_TYPE_DRAW_INDIRECT)
-{
-    buffer     = in_buffer_ptr->get_buffer();
-    buffer_ptr = in_buffer_ptr;
-    count      = in_count;
-    offset     = in_offset;
-    stride     = in_stride;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DrawIndirectCountAMDCommand::DrawIndirectCountAMDCommand(Anvil::Buffer* in_buffer_ptr,
-                                                                                   VkDeviceSize   in_offset,
-                                                                                   Anvil::Buffer* in_count_buffer_ptr,
-                                                                                   VkDeviceSize   in_count_offset,
-                                                                                   uint32_t       in_max_draw_count,
-                                                                                   uint32_t       in_stride)
-    :Command(COMMAND_TYPE_DRAW_INDIRECT_COUNT_AMD)
-{
-    buffer           = in_buffer_ptr->get_buffer();
-    buffer_ptr       = in_buffer_ptr;
-    count_buffer     = in_count_buffer_ptr->get_buffer();
-    count_buffer_ptr = in_count_buffer_ptr;
-    count_offset     = in_count_offset;
-    max_draw_count   = in_max_draw_count;
-    offset           = in_offset;
-    stride           = in_stride;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::DrawIndirectCountKHRCommand::DrawIndirectCountKHRCommand(Anvil::Buffer* in_buffer_ptr,
-                                                                                   VkDeviceSize   in_offset,
-                                                                                   Anvil::Buffer* in_count_buffer_ptr,
-                                                                                   VkDeviceSize   in_count_offset,
-                                                                                   uint32_t       in_max_draw_count,
-                                                                                   uint32_t       in_stride)
-    :Command(COMMAND_TYPE_DRAW_INDIRECT_COUNT_KHR)
-{
-    buffer           = in_buffer_ptr->get_buffer();
-    buffer_ptr       = in_buffer_ptr;
-    count_buffer     = in_count_buffer_ptr->get_buffer();
-    count_buffer_ptr = in_count_buffer_ptr;
-    count_offset     = in_count_offset;
-    max_draw_count   = in_max_draw_count;
-    offset           = in_offset;
-    stride           = in_stride;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::EndQueryCommand::EndQueryCommand(Anvil::QueryPool* in_query_pool_ptr,
-                                                           Anvil::QueryIndex in_entry)
-    :Command(COMMAND_TYPE_END_QUERY)
-{
-    entry          = in_entry;
-    query_pool_ptr = in_query_pool_ptr;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::EndQueryIndexedEXTCommand::EndQueryIndexedEXTCommand(Anvil::QueryPool*        in_query_pool_ptr,
-                                                                               const Anvil::QueryIndex& in_query,
-                                                                               const uint32_t&          in_index)
-    :Command       (COMMAND_TYPE_END_QUERY_INDEXED_EXT),
-     index         (in_index),
-     query         (in_query),
-     query_pool_ptr(in_query_pool_ptr)
-{
-    /* Stub */
-}
-
 /** Please see header for specification */
 Anvil::EndRenderPassCommand::EndRenderPassCommand()
     :Command(COMMAND_TYPE_END_RENDER_PASS)
 {
 }
 
-/** Please see header for specification */
-Anvil::CommandBufferBase::EndTransformFeedbackEXTCommand::EndTransformFeedbackEXTCommand(const uint32_t&                          in_first_counter_buffer,
-                                                                                         const std::vector<const Anvil::Buffer*>& in_counter_buffer_ptrs,
-                                                                                         const std::vector<VkDeviceSize>&         in_counter_buffer_offsets)
-    :Command               (COMMAND_TYPE_END_TRANSFORM_FEEDBACK_EXT),
-     first_counter_buffer  (in_first_counter_buffer),
-     counter_buffer_ptrs   (in_counter_buffer_ptrs),
-     counter_buffer_offsets(in_counter_buffer_offsets)
-{
-    /* Stub */
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::ExecuteCommandsCommand::ExecuteCommandsCommand(uint32_t                        in_cmd_buffers_count,
-                                                                         Anvil::SecondaryCommandBuffer** in_cmd_buffer_ptrs)
-    :Command(COMMAND_TYPE_EXECUTE_COMMANDS)
-{
-    for (uint32_t n_cmd_buffer = 0;
-                  n_cmd_buffer < in_cmd_buffers_count;
-                ++n_cmd_buffer)
-    {
-        command_buffers.push_back    (in_cmd_buffer_ptrs[n_cmd_buffer]->get_command_buffer() );
-        command_buffer_ptrs.push_back(in_cmd_buffer_ptrs[n_cmd_buffer]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::FillBufferCommand::FillBufferCommand(Anvil::Buffer* in_dst_buffer_ptr,
-                                                               VkDeviceSize   in_dst_offset,
-                                                               VkDeviceSize   in_size,
-                                                               uint32_t       in_data)
-    :Command(COMMAND_TYPE_FILL_BUFFER)
-{
-    data           = in_data;
-    dst_buffer     = in_dst_buffer_ptr->get_buffer();
-    dst_buffer_ptr = in_dst_buffer_ptr;
-    dst_offset     = in_dst_offset;
-    size           = in_size;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::NextSubpassCommand::NextSubpassCommand(Anvil::SubpassContents in_contents)
-    :Command(COMMAND_TYPE_NEXT_SUBPASS)
-{
-    contents = in_contents;
-}
-
 /** Please see header for specification */
 Anvil::PipelineBarrierCommand::PipelineBarrierCommand(Anvil::PipelineStageFlags  in_src_stage_mask,
                                                       Anvil::PipelineStageFlags  in_dst_stage_mask,
@@ -789,270 +151,6 @@ Anvil::PipelineBarrierCommand::PipelineBarrierCommand(Anvil::PipelineStageFlags
     }
 }
 
-/** Please see header for specification */
-Anvil::CommandBufferBase::PushConstantsCommand::PushConstantsCommand(Anvil::PipelineLayout*  in_layout_ptr,
-                                                                     Anvil::ShaderStageFlags in_stage_flags,
-                                                                     uint32_t                in_offset,
-                                                                     uint32_t                in_size,
-                                                                     const void*             in_values)
-    :Command(COMMAND_TYPE_PUSH_CONSTANTS)
-{
-    layout_ptr  = in_layout_ptr;
-    offset      = in_offset;
-    size        = in_size;
-    stage_flags = in_stage_flags;
-    values      = in_values;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::ResetEventCommand::ResetEventCommand(Anvil::Event*             in_event_ptr,
-                                                               Anvil::PipelineStageFlags in_stage_mask)
-    :Command(COMMAND_TYPE_RESET_EVENT)
-{
-    event      = in_event_ptr->get_event();
-    event_ptr  = in_event_ptr;
-    stage_mask = in_stage_mask;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::ResetQueryPoolCommand::ResetQueryPoolCommand(Anvil::QueryPool* in_query_pool_ptr,
-                                                                       Anvil::QueryIndex in_start_query,
-                                                                       uint32_t          in_query_count)
-    :Command(COMMAND_TYPE_RESET_QUERY_POOL)
-{
-    query_count    = in_query_count;
-    query_pool_ptr = in_query_pool_ptr;
-    start_query    = in_start_query;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::ResolveImageCommand::ResolveImageCommand(Anvil::Image*             in_src_image_ptr,
-                                                                   Anvil::ImageLayout        in_src_image_layout,
-                                                                   Anvil::Image*             in_dst_image_ptr,
-                                                                   Anvil::ImageLayout        in_dst_image_layout,
-                                                                   uint32_t                  in_region_count,
-                                                                   const Anvil::ImageResolve* in_region_ptrs)
-    :Command(COMMAND_TYPE_RESOLVE_IMAGE)
-{
-    dst_image        = in_dst_image_ptr->get_image();
-    dst_image_layout = in_dst_image_layout;
-    dst_image_ptr    = in_dst_image_ptr;
-    src_image        = in_src_image_ptr->get_image();
-    src_image_layout = in_src_image_layout;
-    src_image_ptr    = in_src_image_ptr;
-
-    for (uint32_t n_region = 0;
-                  n_region < in_region_count;
-                ++n_region)
-    {
-        regions.push_back(in_region_ptrs[n_region]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetBlendConstantsCommand::SetBlendConstantsCommand(const float in_blend_constants[4])
-    :Command(COMMAND_TYPE_SET_BLEND_CONSTANTS)
-{
-    memcpy(blend_constants,
-           in_blend_constants,
-           sizeof(float) * 4);
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetDepthBiasCommand::SetDepthBiasCommand(float in_depth_bias_constant_factor,
-                                                                   float in_depth_bias_clamp,
-                                                                   float in_slope_scaled_depth_bias)
-    :Command(COMMAND_TYPE_SET_DEPTH_BIAS)
-{
-    depth_bias_clamp           = in_depth_bias_clamp;
-    depth_bias_constant_factor = in_depth_bias_constant_factor;
-    slope_scaled_depth_bias    = in_slope_scaled_depth_bias;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetDepthBoundsCommand::SetDepthBoundsCommand(float in_min_depth_bounds,
-                                                                       float in_max_depth_bounds)
-    :Command(COMMAND_TYPE_SET_DEPTH_BOUNDS)
-{
-    max_depth_bounds = in_max_depth_bounds;
-    min_depth_bounds = in_min_depth_bounds;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetDeviceMaskKHRCommand::SetDeviceMaskKHRCommand(uint32_t in_device_mask)
-    :Command(COMMAND_TYPE_SET_DEVICE_MASK_KHR),
-    device_mask(in_device_mask)
-{
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetEventCommand::SetEventCommand(Anvil::Event*             in_event_ptr,
-                                                           Anvil::PipelineStageFlags in_stage_mask)
-    :Command(COMMAND_TYPE_SET_EVENT)
-{
-    event      = in_event_ptr->get_event();
-    event_ptr  = in_event_ptr;
-    stage_mask = in_stage_mask;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetLineWidthCommand::SetLineWidthCommand(float in_line_width)
-    :Command(COMMAND_TYPE_SET_LINE_WIDTH)
-{
-    line_width = in_line_width;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetSampleLocationsEXTCommand::SetSampleLocationsEXTCommand(const Anvil::SampleLocationsInfo& in_sample_locations_info)
-    :Command(COMMAND_TYPE_SET_SAMPLE_LOCATIONS_EXT)
-{
-    sample_locations_info = in_sample_locations_info;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetScissorCommand::SetScissorCommand(uint32_t        in_first_scissor,
-                                                               uint32_t        in_scissor_count,
-                                                               const VkRect2D* in_scissor_ptrs)
-    :Command(COMMAND_TYPE_SET_SCISSOR)
-{
-    first_scissor = in_first_scissor;
-
-    for (uint32_t n_scissor = 0;
-                  n_scissor < in_scissor_count;
-                ++n_scissor)
-    {
-        scissors.push_back(in_scissor_ptrs[n_scissor]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetStencilCompareMaskCommand::SetStencilCompareMaskCommand(Anvil::StencilFaceFlags in_face_mask,
-                                                                                     uint32_t                in_stencil_compare_mask)
-    :Command(COMMAND_TYPE_SET_STENCIL_COMPARE_MASK)
-{
-    face_mask            = in_face_mask;
-    stencil_compare_mask = in_stencil_compare_mask;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetStencilReferenceCommand::SetStencilReferenceCommand(Anvil::StencilFaceFlags in_face_mask,
-                                                                                 uint32_t                in_stencil_reference)
-    :Command(COMMAND_TYPE_SET_STENCIL_REFERENCE)
-{
-    face_mask         = in_face_mask;
-    stencil_reference = in_stencil_reference;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetStencilWriteMaskCommand::SetStencilWriteMaskCommand(Anvil::StencilFaceFlags in_face_mask,
-                                                                                 uint32_t                in_stencil_write_mask)
-    :Command(COMMAND_TYPE_SET_STENCIL_WRITE_MASK)
-{
-    face_mask          = in_face_mask;
-    stencil_write_mask = in_stencil_write_mask;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::SetViewportCommand::SetViewportCommand(uint32_t          in_first_viewport,
-                                                                 uint32_t          in_viewport_count,
-                                                                 const VkViewport* in_viewport_ptrs)
-    :Command(COMMAND_TYPE_SET_VIEWPORT)
-{
-    first_viewport = in_first_viewport;
-
-    for (uint32_t n_viewport = 0;
-                  n_viewport < in_viewport_count;
-                ++n_viewport)
-    {
-        viewports.push_back(in_viewport_ptrs[n_viewport]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::UpdateBufferCommand::UpdateBufferCommand(Anvil::Buffer* in_dst_buffer_ptr,
-                                                                   VkDeviceSize   in_dst_offset,
-                                                                   VkDeviceSize   in_data_size,
-                                                                   const void*    in_data_ptr)
-    :Command(COMMAND_TYPE_UPDATE_BUFFER)
-{
-    data_ptr       = in_data_ptr;
-    data_size      = in_data_size;
-    dst_buffer     = in_dst_buffer_ptr->get_buffer();
-    dst_buffer_ptr = in_dst_buffer_ptr;
-    dst_offset     = in_dst_offset;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::WaitEventsCommand::WaitEventsCommand(uint32_t                   in_event_count,
-                                                               Anvil::Event* const*       in_event_ptrs,
-                                                               Anvil::PipelineStageFlags  in_src_stage_mask,
-                                                               Anvil::PipelineStageFlags  in_dst_stage_mask,
-                                                               uint32_t                   in_memory_barrier_count,
-                                                               const MemoryBarrier* const in_memory_barriers_ptr,
-                                                               uint32_t                   in_buffer_memory_barrier_count,
-                                                               const BufferBarrier* const in_buffer_memory_barriers_ptr,
-                                                               uint32_t                   in_image_memory_barrier_count,
-                                                               const ImageBarrier* const  in_image_memory_barriers_ptr)
-    :Command(COMMAND_TYPE_WAIT_EVENTS)
-{
-    dst_stage_mask = in_dst_stage_mask;
-    src_stage_mask = in_src_stage_mask;
-
-    for (uint32_t n_event = 0;
-                  n_event < in_event_count;
-                ++n_event)
-    {
-        events.push_back    (in_event_ptrs[n_event]->get_event() );
-        event_ptrs.push_back(in_event_ptrs[n_event]);
-    }
-
-    for (uint32_t n_buffer_memory_barrier = 0;
-                  n_buffer_memory_barrier < in_buffer_memory_barrier_count;
-                ++n_buffer_memory_barrier)
-    {
-        buffer_barriers.push_back(in_buffer_memory_barriers_ptr[n_buffer_memory_barrier]);
-    }
-
-    for (uint32_t n_image_memory_barrier = 0;
-                  n_image_memory_barrier < in_image_memory_barrier_count;
-                ++n_image_memory_barrier)
-    {
-        image_barriers.push_back(in_image_memory_barriers_ptr[n_image_memory_barrier]);
-    }
-
-    for (uint32_t n_memory_barrier = 0;
-                  n_memory_barrier < in_memory_barrier_count;
-                ++n_memory_barrier)
-    {
-        memory_barriers.push_back(in_memory_barriers_ptr[n_memory_barrier]);
-    }
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::WriteBufferMarkerAMDCommand::WriteBufferMarkerAMDCommand(const Anvil::PipelineStageFlagBits& in_pipeline_stage,
-                                                                                   Anvil::Buffer*                      in_dst_buffer_ptr,
-                                                                                   VkDeviceSize                        in_dst_offset,
-                                                                                   const uint32_t&                     in_marker)
-    :Command(COMMAND_TYPE_WRITE_BUFFER_MARKER_AMD)
-{
-    dst_buffer_ptr = in_dst_buffer_ptr;
-    dst_offset     = in_dst_offset;
-    marker         = in_marker;
-    pipeline_stage = in_pipeline_stage;
-}
-
-/** Please see header for specification */
-Anvil::CommandBufferBase::WriteTimestampCommand::WriteTimestampCommand(Anvil::PipelineStageFlagBits in_pipeline_stage,
-                                                                       Anvil::QueryPool*            in_query_pool_ptr,
-                                                                       Anvil::QueryIndex            in_entry)
-    :Command(COMMAND_TYPE_WRITE_TIMESTAMP)
-{
-    entry          = in_entry;
-    pipeline_stage = in_pipeline_stage;
-    query_pool_ptr = in_query_pool_ptr;
-}
-
-
 /** Constructor.
  *
  *  @param device_ptr              Device to use.
@@ -1068,6 +166,7 @@ Anvil::CommandBufferBase::CommandBufferBase(const Anvil::BaseDevice* in_device_p
                                      Anvil::ObjectType::COMMAND_BUFFER),
      CallbacksSupportProvider       (COMMAND_BUFFER_CALLBACK_ID_COUNT),
      m_command_buffer               (VK_NULL_HANDLE),
+     m_command_stream_ptr           (nullptr),
      m_device_mask                  (0),
      m_device_ptr                   (in_device_ptr),
      m_is_renderpass_active         (false),
@@ -1078,6 +177,16 @@ Anvil::CommandBufferBase::CommandBufferBase(const Anvil::BaseDevice* in_device_p
      m_type                         (in_type)
 {
     anvil_assert(in_parent_command_pool_ptr != nullptr);
+
+    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    {
+        if (!m_command_stashing_disabled)
+        {
+            m_owned_command_stream_ptr = Anvil::CommandStream::create();
+            m_command_stream_ptr       = m_owned_command_stream_ptr.get();
+        }
+    }
+    #endif
 }
 
 /** Destructor.
@@ -1097,22 +206,16 @@ Anvil::CommandBufferBase::~CommandBufferBase()
         m_parent_command_pool_ptr->lock();
         lock();
         {
-            Anvil::Vulkan::vkFreeCommandBuffers(m_device_ptr->get_device_vk(),
-                                                m_parent_command_pool_ptr->get_command_pool(),
-                                                1, /* commandBufferCount */
-                                               &m_command_buffer);
+            m_device_ptr->get_dispatch_table().vkFreeCommandBuffers(m_device_ptr->get_device_vk(),
+                                                                    m_parent_command_pool_ptr->get_command_pool(),
+                                                                    1, /* commandBufferCount */
+                                                                   &m_command_buffer);
         }
         unlock();
         m_parent_command_pool_ptr->unlock();
 
         m_command_buffer = VK_NULL_HANDLE;
     }
-
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
-    {
-        clear_commands();
-    }
-    #endif
 }
 
 /** Please see header for specification */
@@ -1124,6 +227,8 @@ void Anvil::CommandBufferBase::begin_debug_utils_label(const char*  in_label_nam
         goto end;
     }
 
+    flush_pending_pipeline_barriers();
+
     {
         const auto&          entrypoints = m_device_ptr->get_parent_instance()->get_extension_ext_debug_utils_entrypoints();
         VkDebugUtilsLabelEXT label_info;
@@ -1146,13 +251,139 @@ end:
 }
 
 #ifdef STORE_COMMAND_BUFFER_COMMANDS
-    /** Clears the command vector by releasing all command descriptors back to the heap memory. */
+    /** Clears the internally owned command stream. Memory allocated for the stream is retained.
+     *
+     *  Streams attached by the app with set_command_stream() are left intact.
+     **/
     void Anvil::CommandBufferBase::clear_commands()
     {
-        m_commands.clear();
+        if (m_owned_command_stream_ptr != nullptr)
+        {
+            m_owned_command_stream_ptr->clear();
+        }
     }
 #endif
 
+/* Please see header for specification */
+bool Anvil::CommandBufferBase::declare_buffer_usage(Anvil::Buffer*            in_buffer_ptr,
+                                                    Anvil::PipelineStageFlags in_stage_mask,
+                                                    Anvil::AccessFlags        in_access_mask)
+{
+    Anvil::PipelineStageFlags dst_stage_mask;
+    bool                      result         = false;
+    Anvil::PipelineStageFlags src_stage_mask;
+
+    if (!m_recording_in_progress)
+    {
+        anvil_assert(m_recording_in_progress);
+
+        goto end;
+    }
+
+    if (m_resource_state_tracker_ptr == nullptr)
+    {
+        m_resource_state_tracker_ptr = Anvil::ResourceStateTracker::create();
+    }
+
+    m_tracked_buffer_barriers.clear();
+
+    m_resource_state_tracker_ptr->use_buffer(in_buffer_ptr,
+                                             in_stage_mask,
+                                             in_access_mask,
+                                            &src_stage_mask,
+                                            &dst_stage_mask,
+                                            &m_tracked_buffer_barriers);
+
+    if (m_tracked_buffer_barriers.size() > 0)
+    {
+        if (m_is_renderpass_active)
+        {
+            anvil_assert(!m_is_renderpass_active);
+
+            goto end;
+        }
+
+        result = record_pipeline_barrier(src_stage_mask,
+                                         dst_stage_mask,
+                                         Anvil::DependencyFlagBits::NONE,
+                                         0,       /* in_memory_barrier_count */
+                                         nullptr, /* in_memory_barriers_ptr  */
+                                         static_cast<uint32_t>(m_tracked_buffer_barriers.size() ),
+                                        &m_tracked_buffer_barriers.at(0),
+                                         0,        /* in_image_memory_barrier_count */
+                                         nullptr); /* in_image_memory_barriers_ptr  */
+    }
+    else
+    {
+        result = true;
+    }
+
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::CommandBufferBase::declare_image_usage(Anvil::Image*                       in_image_ptr,
+                                                   const Anvil::ImageSubresourceRange& in_subresource_range,
+                                                   Anvil::ImageLayout                  in_layout,
+                                                   Anvil::PipelineStageFlags           in_stage_mask,
+                                                   Anvil::AccessFlags                  in_access_mask)
+{
+    Anvil::PipelineStageFlags dst_stage_mask;
+    bool                      result         = false;
+    Anvil::PipelineStageFlags src_stage_mask;
+
+    if (!m_recording_in_progress)
+    {
+        anvil_assert(m_recording_in_progress);
+
+        goto end;
+    }
+
+    if (m_resource_state_tracker_ptr == nullptr)
+    {
+        m_resource_state_tracker_ptr = Anvil::ResourceStateTracker::create();
+    }
+
+    m_tracked_image_barriers.clear();
+
+    m_resource_state_tracker_ptr->use_image(in_image_ptr,
+                                            in_subresource_range,
+                                            in_layout,
+                                            in_stage_mask,
+                                            in_access_mask,
+                                           &src_stage_mask,
+                                           &dst_stage_mask,
+                                           &m_tracked_image_barriers);
+
+    if (m_tracked_image_barriers.size() > 0)
+    {
+        if (m_is_renderpass_active)
+        {
+            anvil_assert(!m_is_renderpass_active);
+
+            goto end;
+        }
+
+        result = record_pipeline_barrier(src_stage_mask,
+                                         dst_stage_mask,
+                                         Anvil::DependencyFlagBits::NONE,
+                                         0,       /* in_memory_barrier_count        */
+                                         nullptr, /* in_memory_barriers_ptr         */
+                                         0,       /* in_buffer_memory_barrier_count */
+                                         nullptr, /* in_buffer_memory_barriers_ptr  */
+                                         static_cast<uint32_t>(m_tracked_image_barriers.size() ),
+                                        &m_tracked_image_barriers.at(0) );
+    }
+    else
+    {
+        result = true;
+    }
+
+end:
+    return result;
+}
+
 /* Please see header for specification */
 void Anvil::CommandBufferBase::end_debug_utils_label()
 {
@@ -1168,15 +399,77 @@ void Anvil::CommandBufferBase::end_debug_utils_label()
         goto end;
     }
 
+    flush_pending_pipeline_barriers();
+
     {
         const auto& entrypoints = m_device_ptr->get_parent_instance()->get_extension_ext_debug_utils_entrypoints();
 
         entrypoints.vkCmdEndDebugUtilsLabelEXT(m_command_buffer);
     }
 
-    --m_n_debug_label_regions_started;
-end:
-    ;
+    --m_n_debug_label_regions_started;
+end:
+    ;
+}
+
+/** Issues a single vkCmdPipelineBarrier() call for all barriers accumulated by the pipeline barrier batch,
+ *  if batching is enabled and any barriers are pending.
+ **/
+void Anvil::CommandBufferBase::flush_pending_pipeline_barriers()
+{
+    if (m_pipeline_barrier_batch_ptr == nullptr  ||
+        m_pipeline_barrier_batch_ptr->is_empty() )
+    {
+        goto end;
+    }
+
+    {
+        const auto& buffer_barriers = m_pipeline_barrier_batch_ptr->get_buffer_memory_barriers();
+        const auto& image_barriers  = m_pipeline_barrier_batch_ptr->get_image_memory_barriers ();
+        const auto& memory_barriers = m_pipeline_barrier_batch_ptr->get_memory_barriers       ();
+
+        m_parent_command_pool_ptr->lock();
+        lock();
+        {
+            m_device_ptr->get_dispatch_table().vkCmdPipelineBarrier(m_command_buffer,
+                                                                    m_pipeline_barrier_batch_ptr->get_src_stage_mask  ().get_vk(),
+                                                                    m_pipeline_barrier_batch_ptr->get_dst_stage_mask  ().get_vk(),
+                                                                    m_pipeline_barrier_batch_ptr->get_dependency_flags().get_vk(),
+                                                                    static_cast<uint32_t>(memory_barriers.size() ),
+                                                                    (memory_barriers.size() > 0) ? &memory_barriers.at(0) : nullptr,
+                                                                    static_cast<uint32_t>(buffer_barriers.size() ),
+                                                                    (buffer_barriers.size() > 0) ? &buffer_barriers.at(0) : nullptr,
+                                                                    static_cast<uint32_t>(image_barriers.size() ),
+                                                                    (image_barriers.size() > 0) ? &image_barriers.at(0) : nullptr);
+        }
+        unlock();
+        m_parent_command_pool_ptr->unlock();
+    }
+
+    m_pipeline_barrier_batch_ptr->clear();
+end:
+    ;
+}
+
+/* Please see header for specification */
+uint32_t Anvil::CommandBufferBase::get_n_dropped_pipeline_barriers() const
+{
+    return (m_pipeline_barrier_batch_ptr != nullptr) ? m_pipeline_barrier_batch_ptr->get_n_dropped_barriers()
+                                                     : 0;
+}
+
+/* Please see header for specification */
+uint32_t Anvil::CommandBufferBase::get_n_elided_commands() const
+{
+    return (m_redundant_state_filter_ptr != nullptr) ? m_redundant_state_filter_ptr->get_n_elided_commands()
+                                                     : 0;
+}
+
+/* Please see header for specification */
+uint32_t Anvil::CommandBufferBase::get_n_merged_pipeline_barrier_commands() const
+{
+    return (m_pipeline_barrier_batch_ptr != nullptr) ? m_pipeline_barrier_batch_ptr->get_n_merged_commands()
+                                                     : 0;
 }
 
 /** Please see header for specification */
@@ -1188,6 +481,8 @@ void Anvil::CommandBufferBase::insert_debug_utils_label(const char*  in_label_na
         goto end;
     }
 
+    flush_pending_pipeline_barriers();
+
     {
         const auto&          entrypoints = m_device_ptr->get_parent_instance()->get_extension_ext_debug_utils_entrypoints();
         VkDebugUtilsLabelEXT label_info;
@@ -1223,24 +518,23 @@ bool Anvil::CommandBufferBase::record_begin_query(Anvil::QueryPool*        in_qu
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(BeginQueryCommand(in_query_pool_ptr,
-                                                   in_entry,
-                                                   in_flags) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_BEGIN_QUERY,
+                                             in_query_pool_ptr,
+                                             in_entry,
+                                             in_flags);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdBeginQuery(m_command_buffer,
-                                       in_query_pool_ptr->get_query_pool(),
-                                       in_entry,
-                                       in_flags.get_vk() );
+        m_device_ptr->get_dispatch_table().vkCmdBeginQuery(m_command_buffer,
+                                                           in_query_pool_ptr->get_query_pool(),
+                                                           in_entry,
+                                                           in_flags.get_vk() );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1267,17 +561,16 @@ bool Anvil::CommandBufferBase::record_begin_query_indexed(Anvil::QueryPool*
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(BeginQueryIndexedEXTCommand(in_query_pool_ptr,
-                                                             in_query,
-                                                             in_flags,
-                                                             in_index) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_BEGIN_QUERY_INDEXED_EXT,
+                                             in_query_pool_ptr,
+                                             in_query,
+                                             in_flags,
+                                             in_index);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
@@ -1328,36 +621,16 @@ bool Anvil::CommandBufferBase::record_begin_transform_feedback_EXT(const uint32_
                                                                                                                                                       : VK_NULL_HANDLE;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            std::vector<const Anvil::Buffer*> buffer_ptr_vec(in_n_counter_buffers,
-                                                             nullptr);
-            std::vector<VkDeviceSize>         offset_vec    (in_n_counter_buffers);
-
-            for (uint32_t n_counter_buffer = 0;
-                          n_counter_buffer < in_n_counter_buffers;
-                        ++n_counter_buffer)
-            {
-                if (in_opt_counter_buffer_ptrs                   != nullptr &&
-                    in_opt_counter_buffer_ptrs[n_counter_buffer] != nullptr)
-                {
-                    buffer_ptr_vec.at(n_counter_buffer) = in_opt_counter_buffer_ptrs[n_counter_buffer];
-                }
-
-                if (in_opt_counter_buffer_offsets != nullptr)
-                {
-                    offset_vec.at(n_counter_buffer) = in_opt_counter_buffer_offsets[n_counter_buffer];
-                }
-            }
-
-            m_commands.push_back(BeginTransformFeedbackEXTCommand(in_first_counter_buffer,
-                                                                  buffer_ptr_vec,
-                                                                  offset_vec) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_BEGIN_TRANSFORM_FEEDBACK_EXT,
+                                             in_first_counter_buffer,
+                                             in_n_counter_buffers,
+                                             Anvil::CommandStream::make_array(in_opt_counter_buffer_ptrs, in_n_counter_buffers),
+                                             Anvil::CommandStream::make_array(in_opt_counter_buffer_offsets, in_n_counter_buffers));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
@@ -1403,32 +676,43 @@ bool Anvil::CommandBufferBase::record_bind_descriptor_sets(Anvil::PipelineBindPo
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_redundant_state_filter_ptr != nullptr                                                                 &&
+        m_redundant_state_filter_ptr->filter_bind_descriptor_sets(in_pipeline_bind_point,
+                                                                  in_layout_ptr->get_pipeline_layout(),
+                                                                  in_first_set,
+                                                                  in_set_count,
+                                                                  (in_set_count > 0) ? &dss_vk.at(0) : nullptr,
+                                                                  in_dynamic_offset_count,
+                                                                  in_dynamic_offset_ptrs) )
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(BindDescriptorSetsCommand(in_pipeline_bind_point,
-                                                           in_layout_ptr,
-                                                           in_first_set,
-                                                           in_set_count,
-                                                           in_descriptor_set_ptrs,
-                                                           in_dynamic_offset_count,
-                                                           in_dynamic_offset_ptrs) );
-        }
+        result = true;
+
+        goto end;
     }
-    #endif
+
+    if (m_command_stream_ptr != nullptr)
+    {
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_BIND_DESCRIPTOR_SETS,
+                                             in_pipeline_bind_point,
+                                             in_layout_ptr,
+                                             in_first_set,
+                                             Anvil::CommandStream::make_array(in_descriptor_set_ptrs, in_set_count),
+                                             Anvil::CommandStream::make_array(in_dynamic_offset_ptrs, in_dynamic_offset_count));
+    }
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdBindDescriptorSets(m_command_buffer,
-                                               static_cast<VkPipelineBindPoint>(in_pipeline_bind_point),
-                                               in_layout_ptr->get_pipeline_layout(),
-                                               in_first_set,
-                                               in_set_count,
-                                               (in_set_count > 0) ? &dss_vk.at(0) : nullptr,
-                                               in_dynamic_offset_count,
-                                               in_dynamic_offset_ptrs);
+        m_device_ptr->get_dispatch_table().vkCmdBindDescriptorSets(m_command_buffer,
+                                                                   static_cast<VkPipelineBindPoint>(in_pipeline_bind_point),
+                                                                   in_layout_ptr->get_pipeline_layout(),
+                                                                   in_first_set,
+                                                                   in_set_count,
+                                                                   (in_set_count > 0) ? &dss_vk.at(0) : nullptr,
+                                                                   in_dynamic_offset_count,
+                                                                   in_dynamic_offset_ptrs);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1453,24 +737,23 @@ bool Anvil::CommandBufferBase::record_bind_index_buffer(Anvil::Buffer*   in_buff
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(BindIndexBufferCommand(in_buffer_ptr,
-                                                        in_offset,
-                                                        in_index_type) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_BIND_INDEX_BUFFER,
+                                             in_buffer_ptr,
+                                             in_offset,
+                                             in_index_type);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdBindIndexBuffer(m_command_buffer,
-                                            in_buffer_ptr->get_buffer(),
-                                            in_offset,
-                                            static_cast<VkIndexType>(in_index_type) );
+        m_device_ptr->get_dispatch_table().vkCmdBindIndexBuffer(m_command_buffer,
+                                                                in_buffer_ptr->get_buffer(),
+                                                                in_offset,
+                                                                static_cast<VkIndexType>(in_index_type) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1501,22 +784,30 @@ bool Anvil::CommandBufferBase::record_bind_pipeline(Anvil::PipelineBindPoint in_
     pipeline_vk = (in_pipeline_bind_point == Anvil::PipelineBindPoint::COMPUTE) ? m_device_ptr->get_compute_pipeline_manager ()->get_pipeline(in_pipeline_id)
                                                                                 : m_device_ptr->get_graphics_pipeline_manager()->get_pipeline(in_pipeline_id);
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_redundant_state_filter_ptr != nullptr                                          &&
+        m_redundant_state_filter_ptr->filter_bind_pipeline(in_pipeline_bind_point,
+                                                           pipeline_vk) )
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(BindPipelineCommand(in_pipeline_bind_point,
-                                                     in_pipeline_id) );
-        }
+        result = true;
+
+        goto end;
+    }
+
+    if (m_command_stream_ptr != nullptr)
+    {
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_BIND_PIPELINE,
+                                             in_pipeline_bind_point,
+                                             in_pipeline_id);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdBindPipeline(m_command_buffer,
-                                         static_cast<VkPipelineBindPoint>(in_pipeline_bind_point),
-                                         pipeline_vk);
+        m_device_ptr->get_dispatch_table().vkCmdBindPipeline(m_command_buffer,
+                                                             static_cast<VkPipelineBindPoint>(in_pipeline_bind_point),
+                                                             pipeline_vk);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1545,31 +836,14 @@ bool Anvil::CommandBufferBase::record_bind_transform_feedback_buffers_EXT(const
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            std::vector<Anvil::Buffer*> buffer_vec(in_n_bindings);
-            std::vector<VkDeviceSize>   offset_vec(in_n_bindings);
-            std::vector<VkDeviceSize>   size_vec  (in_n_bindings);
-
-            for (uint32_t n_binding = 0;
-                          n_binding < in_n_bindings;
-                        ++n_binding)
-            {
-                buffer_vec.at(n_binding) = in_buffer_ptrs[n_binding];
-                offset_vec.at(n_binding) = in_offsets_ptr[n_binding];
-                size_vec.at  (n_binding) = in_sizes_ptr  [n_binding];
-            }
-
-            m_commands.push_back(BindTransformFeedbackBuffersEXTCommand(in_first_binding,
-                                                                        in_n_bindings,
-                                                                        buffer_vec,
-                                                                        offset_vec,
-                                                                        size_vec) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_BIND_TRANSFORM_FEEDBACK_BUFFERS_EXT,
+                                             in_first_binding,
+                                             Anvil::CommandStream::make_array(in_buffer_ptrs, in_n_bindings),
+                                             Anvil::CommandStream::make_array(in_offsets_ptr, in_n_bindings),
+                                             Anvil::CommandStream::make_array(in_sizes_ptr, in_n_bindings));
     }
-    #endif
 
     for (uint32_t n_binding = 0;
                   n_binding < in_n_bindings;
@@ -1578,6 +852,8 @@ bool Anvil::CommandBufferBase::record_bind_transform_feedback_buffers_EXT(const
         buffers.at(n_binding) = in_buffer_ptrs[n_binding]->get_buffer();
     }
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
@@ -1613,18 +889,6 @@ bool Anvil::CommandBufferBase::record_bind_vertex_buffers(uint32_t            in
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
-    {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(BindVertexBuffersCommand(in_start_binding,
-                                                          in_binding_count,
-                                                          in_buffer_ptrs,
-                                                          in_offset_ptrs) );
-        }
-    }
-    #endif
-
     for (uint32_t n_binding = 0;
                   n_binding < in_binding_count;
                 ++n_binding)
@@ -1632,14 +896,35 @@ bool Anvil::CommandBufferBase::record_bind_vertex_buffers(uint32_t            in
         buffers.at(n_binding) = in_buffer_ptrs[n_binding]->get_buffer();
     }
 
+    if (m_redundant_state_filter_ptr != nullptr                                                      &&
+        m_redundant_state_filter_ptr->filter_bind_vertex_buffers(in_start_binding,
+                                                                 in_binding_count,
+                                                                 (in_binding_count > 0) ? &buffers.at(0) : nullptr,
+                                                                 in_offset_ptrs) )
+    {
+        result = true;
+
+        goto end;
+    }
+
+    if (m_command_stream_ptr != nullptr)
+    {
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_BIND_VERTEX_BUFFER,
+                                             in_start_binding,
+                                             Anvil::CommandStream::make_array(in_buffer_ptrs, in_binding_count),
+                                             Anvil::CommandStream::make_array(in_offset_ptrs, in_binding_count));
+    }
+
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdBindVertexBuffers(m_command_buffer,
-                                              in_start_binding,
-                                              in_binding_count,
-                                              (in_binding_count > 0) ? &buffers.at(0) : nullptr,
-                                              in_offset_ptrs);
+        m_device_ptr->get_dispatch_table().vkCmdBindVertexBuffers(m_command_buffer,
+                                                                  in_start_binding,
+                                                                  in_binding_count,
+                                                                  (in_binding_count > 0) ? &buffers.at(0) : nullptr,
+                                                                  in_offset_ptrs);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1674,32 +959,30 @@ bool Anvil::CommandBufferBase::record_blit_image(Anvil::Image*           in_src_
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(BlitImageCommand(in_src_image_ptr,
-                                                  in_src_image_layout,
-                                                  in_dst_image_ptr,
-                                                  in_dst_image_layout,
-                                                  in_region_count,
-                                                  in_region_ptrs,
-                                                  in_filter) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_BLIT_IMAGE,
+                                             in_src_image_ptr,
+                                             in_src_image_layout,
+                                             in_dst_image_ptr,
+                                             in_dst_image_layout,
+                                             Anvil::CommandStream::make_array(in_region_ptrs, in_region_count),
+                                             in_filter);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdBlitImage(m_command_buffer,
-                                      in_src_image_ptr->get_image(),
-                                      static_cast<VkImageLayout>(in_src_image_layout),
-                                      in_dst_image_ptr->get_image(),
-                                      static_cast<VkImageLayout>(in_dst_image_layout),
-                                      in_region_count,
-                                      reinterpret_cast<const VkImageBlit*>(in_region_ptrs),
-                                      static_cast<VkFilter>(in_filter) );
+        m_device_ptr->get_dispatch_table().vkCmdBlitImage(m_command_buffer,
+                                                          in_src_image_ptr->get_image(),
+                                                          static_cast<VkImageLayout>(in_src_image_layout),
+                                                          in_dst_image_ptr->get_image(),
+                                                          static_cast<VkImageLayout>(in_dst_image_layout),
+                                                          in_region_count,
+                                                          reinterpret_cast<const VkImageBlit*>(in_region_ptrs),
+                                                          static_cast<VkFilter>(in_filter) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1731,26 +1014,23 @@ bool Anvil::CommandBufferBase::record_clear_attachments(uint32_t
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(ClearAttachmentsCommand(in_n_attachments,
-                                                         in_attachment_ptrs,
-                                                         in_n_rects,
-                                                         in_rect_ptrs) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_CLEAR_ATTACHMENTS,
+                                             Anvil::CommandStream::make_array(in_attachment_ptrs, in_n_attachments),
+                                             Anvil::CommandStream::make_array(in_rect_ptrs, in_n_rects));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdClearAttachments(m_command_buffer,
-                                             in_n_attachments,
-                                             reinterpret_cast<const VkClearAttachment*>(in_attachment_ptrs),
-                                             in_n_rects,
-                                             in_rect_ptrs);
+        m_device_ptr->get_dispatch_table().vkCmdClearAttachments(m_command_buffer,
+                                                                 in_n_attachments,
+                                                                 reinterpret_cast<const VkClearAttachment*>(in_attachment_ptrs),
+                                                                 in_n_rects,
+                                                                 in_rect_ptrs);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1783,28 +1063,26 @@ bool Anvil::CommandBufferBase::record_clear_color_image(Anvil::Image*
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(ClearColorImageCommand(in_image_ptr,
-                                                        in_image_layout,
-                                                        in_color_ptr,
-                                                        in_range_count,
-                                                        in_range_ptrs) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_CLEAR_COLOR_IMAGE,
+                                             in_image_ptr,
+                                             in_image_layout,
+                                             *in_color_ptr,
+                                             Anvil::CommandStream::make_array(in_range_ptrs, in_range_count));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdClearColorImage(m_command_buffer,
-                                            in_image_ptr->get_image(),
-                                            static_cast<VkImageLayout>(in_image_layout),
-                                            in_color_ptr,
-                                            in_range_count,
-                                            reinterpret_cast<const VkImageSubresourceRange*>(in_range_ptrs) );
+        m_device_ptr->get_dispatch_table().vkCmdClearColorImage(m_command_buffer,
+                                                                in_image_ptr->get_image(),
+                                                                static_cast<VkImageLayout>(in_image_layout),
+                                                                in_color_ptr,
+                                                                in_range_count,
+                                                                reinterpret_cast<const VkImageSubresourceRange*>(in_range_ptrs) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1837,28 +1115,26 @@ bool Anvil::CommandBufferBase::record_clear_depth_stencil_image(Anvil::Image*
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(ClearDepthStencilImageCommand(in_image_ptr,
-                                                               in_image_layout,
-                                                               in_depth_stencil_ptr,
-                                                               in_range_count,
-                                                               in_range_ptrs) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_CLEAR_DEPTH_STENCIL_IMAGE,
+                                             in_image_ptr,
+                                             in_image_layout,
+                                             *in_depth_stencil_ptr,
+                                             Anvil::CommandStream::make_array(in_range_ptrs, in_range_count));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdClearDepthStencilImage(m_command_buffer,
-                                                   in_image_ptr->get_image(),
-                                                   static_cast<VkImageLayout>(in_image_layout),
-                                                   in_depth_stencil_ptr,
-                                                   in_range_count,
-                                                   reinterpret_cast<const VkImageSubresourceRange*>(in_range_ptrs) );
+        m_device_ptr->get_dispatch_table().vkCmdClearDepthStencilImage(m_command_buffer,
+                                                                       in_image_ptr->get_image(),
+                                                                       static_cast<VkImageLayout>(in_image_layout),
+                                                                       in_depth_stencil_ptr,
+                                                                       in_range_count,
+                                                                       reinterpret_cast<const VkImageSubresourceRange*>(in_range_ptrs) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1890,26 +1166,24 @@ bool Anvil::CommandBufferBase::record_copy_buffer(Anvil::Buffer*           in_sr
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(CopyBufferCommand(in_src_buffer_ptr,
-                                                   in_dst_buffer_ptr,
-                                                   in_region_count,
-                                                   in_region_ptrs) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_COPY_BUFFER,
+                                             in_src_buffer_ptr,
+                                             in_dst_buffer_ptr,
+                                             Anvil::CommandStream::make_array(in_region_ptrs, in_region_count));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdCopyBuffer(m_command_buffer,
-                                       in_src_buffer_ptr->get_buffer(),
-                                       in_dst_buffer_ptr->get_buffer(),
-                                       in_region_count,
-                                       reinterpret_cast<const VkBufferCopy*>(in_region_ptrs) );
+        m_device_ptr->get_dispatch_table().vkCmdCopyBuffer(m_command_buffer,
+                                                           in_src_buffer_ptr->get_buffer(),
+                                                           in_dst_buffer_ptr->get_buffer(),
+                                                           in_region_count,
+                                                           reinterpret_cast<const VkBufferCopy*>(in_region_ptrs) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1942,28 +1216,26 @@ bool Anvil::CommandBufferBase::record_copy_buffer_to_image(Anvil::Buffer*
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(CopyBufferToImageCommand(in_src_buffer_ptr,
-                                                          in_dst_image_ptr,
-                                                          in_dst_image_layout,
-                                                          in_region_count,
-                                                          in_region_ptrs) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_COPY_BUFFER_TO_IMAGE,
+                                             in_src_buffer_ptr,
+                                             in_dst_image_ptr,
+                                             in_dst_image_layout,
+                                             Anvil::CommandStream::make_array(in_region_ptrs, in_region_count));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdCopyBufferToImage(m_command_buffer,
-                                              in_src_buffer_ptr->get_buffer(),
-                                              in_dst_image_ptr->get_image(),
-                                              static_cast<VkImageLayout>(in_dst_image_layout),
-                                              in_region_count,
-                                              reinterpret_cast<const VkBufferImageCopy*>(in_region_ptrs) );
+        m_device_ptr->get_dispatch_table().vkCmdCopyBufferToImage(m_command_buffer,
+                                                                  in_src_buffer_ptr->get_buffer(),
+                                                                  in_dst_image_ptr->get_image(),
+                                                                  static_cast<VkImageLayout>(in_dst_image_layout),
+                                                                  in_region_count,
+                                                                  reinterpret_cast<const VkBufferImageCopy*>(in_region_ptrs) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1997,30 +1269,28 @@ bool Anvil::CommandBufferBase::record_copy_image(Anvil::Image*           in_src_
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(CopyImageCommand(in_src_image_ptr,
-                                                  in_src_image_layout,
-                                                  in_dst_image_ptr,
-                                                  in_dst_image_layout,
-                                                  in_region_count,
-                                                  in_region_ptrs) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_COPY_IMAGE,
+                                             in_src_image_ptr,
+                                             in_src_image_layout,
+                                             in_dst_image_ptr,
+                                             in_dst_image_layout,
+                                             Anvil::CommandStream::make_array(in_region_ptrs, in_region_count));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdCopyImage(m_command_buffer,
-                                      in_src_image_ptr->get_image(),
-                                      static_cast<VkImageLayout>(in_src_image_layout),
-                                      in_dst_image_ptr->get_image(),
-                                      static_cast<VkImageLayout>(in_dst_image_layout),
-                                      in_region_count,
-                                      reinterpret_cast<const VkImageCopy*>(in_region_ptrs) );
+        m_device_ptr->get_dispatch_table().vkCmdCopyImage(m_command_buffer,
+                                                          in_src_image_ptr->get_image(),
+                                                          static_cast<VkImageLayout>(in_src_image_layout),
+                                                          in_dst_image_ptr->get_image(),
+                                                          static_cast<VkImageLayout>(in_dst_image_layout),
+                                                          in_region_count,
+                                                          reinterpret_cast<const VkImageCopy*>(in_region_ptrs) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2053,28 +1323,26 @@ bool Anvil::CommandBufferBase::record_copy_image_to_buffer(Anvil::Image*
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(CopyImageToBufferCommand(in_src_image_ptr,
-                                                          in_src_image_layout,
-                                                          in_dst_buffer_ptr,
-                                                          in_region_count,
-                                                          in_region_ptrs) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_COPY_IMAGE_TO_BUFFER,
+                                             in_src_image_ptr,
+                                             in_src_image_layout,
+                                             in_dst_buffer_ptr,
+                                             Anvil::CommandStream::make_array(in_region_ptrs, in_region_count));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdCopyImageToBuffer(m_command_buffer,
-                                              in_src_image_ptr->get_image(),
-                                              static_cast<VkImageLayout>(in_src_image_layout),
-                                              in_dst_buffer_ptr->get_buffer(),
-                                              in_region_count,
-                                              reinterpret_cast<const VkBufferImageCopy*>(in_region_ptrs) );
+        m_device_ptr->get_dispatch_table().vkCmdCopyImageToBuffer(m_command_buffer,
+                                                                  in_src_image_ptr->get_image(),
+                                                                  static_cast<VkImageLayout>(in_src_image_layout),
+                                                                  in_dst_buffer_ptr->get_buffer(),
+                                                                  in_region_count,
+                                                                  reinterpret_cast<const VkBufferImageCopy*>(in_region_ptrs) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2109,32 +1377,31 @@ bool Anvil::CommandBufferBase::record_copy_query_pool_results(Anvil::QueryPool*
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(CopyQueryPoolResultsCommand(in_query_pool_ptr,
-                                                             in_start_query,
-                                                             in_query_count,
-                                                             in_dst_buffer_ptr,
-                                                             in_dst_offset,
-                                                             in_dst_stride,
-                                                             in_flags) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_COPY_QUERY_POOL_RESULTS,
+                                             in_query_pool_ptr,
+                                             in_start_query,
+                                             in_query_count,
+                                             in_dst_buffer_ptr,
+                                             in_dst_offset,
+                                             in_dst_stride,
+                                             in_flags);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdCopyQueryPoolResults(m_command_buffer,
-                                                 in_query_pool_ptr->get_query_pool(),
-                                                 in_start_query,
-                                                 in_query_count,
-                                                 in_dst_buffer_ptr->get_buffer(),
-                                                 in_dst_offset,
-                                                 in_dst_stride,
-                                                 in_flags);
+        m_device_ptr->get_dispatch_table().vkCmdCopyQueryPoolResults(m_command_buffer,
+                                                                     in_query_pool_ptr->get_query_pool(),
+                                                                     in_start_query,
+                                                                     in_query_count,
+                                                                     in_dst_buffer_ptr->get_buffer(),
+                                                                     in_dst_offset,
+                                                                     in_dst_stride,
+                                                                     in_flags);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2165,24 +1432,23 @@ bool Anvil::CommandBufferBase::record_dispatch(uint32_t in_x,
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DispatchCommand(in_x,
-                                                 in_y,
-                                                 in_z) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DISPATCH,
+                                             in_x,
+                                             in_y,
+                                             in_z);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdDispatch(m_command_buffer,
-                                     in_x,
-                                     in_y,
-                                     in_z);
+        m_device_ptr->get_dispatch_table().vkCmdDispatch(m_command_buffer,
+                                                         in_x,
+                                                         in_y,
+                                                         in_z);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2207,15 +1473,12 @@ bool Anvil::CommandBufferBase::record_debug_marker_begin_EXT(const std::string&
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DebugMarkerBeginEXTCommand(in_marker_name,
-                                                            in_opt_color) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DEBUG_MARKER_BEGIN_EXT,
+                                             in_marker_name,
+                                             Anvil::CommandStream::make_array(in_opt_color, 4));
     }
-    #endif
 
     anvil_assert(m_device_ptr->get_extension_info()->ext_debug_marker() );
 
@@ -2237,6 +1500,8 @@ bool Anvil::CommandBufferBase::record_debug_marker_begin_EXT(const std::string&
     marker_info.pNext       = nullptr;
     marker_info.sType       = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     {
         entrypoints.vkCmdDebugMarkerBeginEXT(m_command_buffer,
@@ -2265,14 +1530,12 @@ bool Anvil::CommandBufferBase::record_debug_marker_end_EXT()
     anvil_assert(m_device_ptr->get_extension_info()->ext_debug_marker() );
 
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DebugMarkerEndEXTCommand() );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DEBUG_MARKER_END_EXT);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     {
@@ -2303,15 +1566,12 @@ bool Anvil::CommandBufferBase::record_debug_marker_insert_EXT(const std::string&
     anvil_assert(m_device_ptr->get_extension_info()->ext_debug_marker() );
 
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DebugMarkerInsertEXTCommand(in_marker_name,
-                                                             in_opt_color) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DEBUG_MARKER_INSERT_EXT,
+                                             in_marker_name,
+                                             Anvil::CommandStream::make_array(in_opt_color, 4));
     }
-    #endif
 
     if (in_opt_color != nullptr)
     {
@@ -2331,6 +1591,8 @@ bool Anvil::CommandBufferBase::record_debug_marker_insert_EXT(const std::string&
     marker_info.pNext       = nullptr;
     marker_info.sType       = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     {
         entrypoints.vkCmdDebugMarkerInsertEXT(m_command_buffer,
@@ -2371,19 +1633,18 @@ bool Anvil::CommandBufferBase::record_dispatch_base_KHR(uint32_t in_base_group_x
     anvil_assert(m_device_ptr->get_extension_info()->khr_device_group() );
 
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DispatchBaseKHRCommand(in_base_group_x,
-                                                        in_base_group_y,
-                                                        in_base_group_z,
-                                                        in_group_count_x,
-                                                        in_group_count_y,
-                                                        in_group_count_z) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DISPATCH_BASE_KHR,
+                                             in_base_group_x,
+                                             in_base_group_y,
+                                             in_base_group_z,
+                                             in_group_count_x,
+                                             in_group_count_y,
+                                             in_group_count_z);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
@@ -2424,22 +1685,21 @@ bool Anvil::CommandBufferBase::record_dispatch_indirect(Anvil::Buffer* in_buffer
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DispatchIndirectCommand(in_buffer_ptr,
-                                                         in_offset) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DISPATCH_INDIRECT,
+                                             in_buffer_ptr,
+                                             in_offset);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdDispatchIndirect(m_command_buffer,
-                                             in_buffer_ptr->get_buffer(),
-                                             in_offset);
+        m_device_ptr->get_dispatch_table().vkCmdDispatchIndirect(m_command_buffer,
+                                                                 in_buffer_ptr->get_buffer(),
+                                                                 in_offset);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2471,26 +1731,25 @@ bool Anvil::CommandBufferBase::record_draw(uint32_t in_vertex_count,
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DrawCommand(in_vertex_count,
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DRAW,
+                                             in_vertex_count,
                                              in_instance_count,
                                              in_first_vertex,
-                                             in_first_instance) );
-        }
+                                             in_first_instance);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdDraw(m_command_buffer,
-                                 in_vertex_count,
-                                 in_instance_count,
-                                 in_first_vertex,
-                                 in_first_instance);
+        m_device_ptr->get_dispatch_table().vkCmdDraw(m_command_buffer,
+                                                     in_vertex_count,
+                                                     in_instance_count,
+                                                     in_first_vertex,
+                                                     in_first_instance);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2523,28 +1782,27 @@ bool Anvil::CommandBufferBase::record_draw_indexed(uint32_t in_index_count,
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DrawIndexedCommand(in_index_count,
-                                                    in_instance_count,
-                                                    in_first_index,
-                                                    in_vertex_offset,
-                                                    in_first_instance) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DRAW_INDEXED,
+                                             in_index_count,
+                                             in_instance_count,
+                                             in_first_index,
+                                             in_vertex_offset,
+                                             in_first_instance);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdDrawIndexed(m_command_buffer,
-                                        in_index_count,
-                                        in_instance_count,
-                                        in_first_index,
-                                        in_vertex_offset,
-                                        in_first_instance);
+        m_device_ptr->get_dispatch_table().vkCmdDrawIndexed(m_command_buffer,
+                                                            in_index_count,
+                                                            in_instance_count,
+                                                            in_first_index,
+                                                            in_vertex_offset,
+                                                            in_first_instance);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2576,26 +1834,25 @@ bool Anvil::CommandBufferBase::record_draw_indexed_indirect(Anvil::Buffer* in_bu
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DrawIndexedIndirectCommand(in_buffer_ptr,
-                                                            in_offset,
-                                                            in_count,
-                                                            in_stride) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DRAW_INDEXED_INDIRECT,
+                                             in_buffer_ptr,
+                                             in_offset,
+                                             in_count,
+                                             in_stride);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdDrawIndexedIndirect(m_command_buffer,
-                                                in_buffer_ptr->get_buffer(),
-                                                in_offset,
-                                                in_count,
-                                                in_stride);
+        m_device_ptr->get_dispatch_table().vkCmdDrawIndexedIndirect(m_command_buffer,
+                                                                    in_buffer_ptr->get_buffer(),
+                                                                    in_offset,
+                                                                    in_count,
+                                                                    in_stride);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2630,19 +1887,18 @@ bool Anvil::CommandBufferBase::record_draw_indirect_byte_count_EXT(const uint32_
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DrawIndirectByteCountEXTCommand(in_instance_count,
-                                                                 in_first_instance,
-                                                                 in_counter_buffer_ptr,
-                                                                 in_counter_buffer_offset,
-                                                                 in_counter_offset,
-                                                                 in_vertex_stride) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DRAW_INDIRECT_BYTE_COUNT_EXT,
+                                             in_instance_count,
+                                             in_first_instance,
+                                             in_counter_buffer_ptr,
+                                             in_counter_buffer_offset,
+                                             in_counter_offset,
+                                             in_vertex_stride);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
@@ -2691,22 +1947,21 @@ bool Anvil::CommandBufferBase::record_draw_indexed_indirect_count_AMD(Anvil::Buf
     anvil_assert(m_device_ptr->get_extension_info()->amd_draw_indirect_count() );
 
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DrawIndexedIndirectCountAMDCommand(in_buffer_ptr,
-                                                                    in_offset,
-                                                                    in_count_buffer_ptr,
-                                                                    in_count_offset,
-                                                                    in_max_draw_count,
-                                                                    in_stride) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DRAW_INDEXED_INDIRECT_COUNT_AMD,
+                                             in_buffer_ptr,
+                                             in_offset,
+                                             in_count_buffer_ptr,
+                                             in_count_offset,
+                                             in_max_draw_count,
+                                             in_stride);
     }
-    #endif
 
     entrypoints = m_device_ptr->get_extension_amd_draw_indirect_count_entrypoints();
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
@@ -2754,22 +2009,21 @@ bool Anvil::CommandBufferBase::record_draw_indexed_indirect_count_KHR(Anvil::Buf
     anvil_assert(m_device_ptr->get_extension_info()->khr_draw_indirect_count() );
 
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DrawIndexedIndirectCountKHRCommand(in_buffer_ptr,
-                                                                    in_offset,
-                                                                    in_count_buffer_ptr,
-                                                                    in_count_offset,
-                                                                    in_max_draw_count,
-                                                                    in_stride) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DRAW_INDEXED_INDIRECT_COUNT_KHR,
+                                             in_buffer_ptr,
+                                             in_offset,
+                                             in_count_buffer_ptr,
+                                             in_count_offset,
+                                             in_max_draw_count,
+                                             in_stride);
     }
-    #endif
 
     entrypoints = m_device_ptr->get_extension_khr_draw_indirect_count_entrypoints();
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
@@ -2811,26 +2065,25 @@ bool Anvil::CommandBufferBase::record_draw_indirect(Anvil::Buffer* in_buffer_ptr
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DrawIndirectCommand(in_buffer_ptr,
-                                                     in_offset,
-                                                     in_count,
-                                                     in_stride) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DRAW_INDIRECT,
+                                             in_buffer_ptr,
+                                             in_offset,
+                                             in_count,
+                                             in_stride);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdDrawIndirect(m_command_buffer,
-                                         in_buffer_ptr->get_buffer(),
-                                         in_offset,
-                                         in_count,
-                                         in_stride);
+        m_device_ptr->get_dispatch_table().vkCmdDrawIndirect(m_command_buffer,
+                                                             in_buffer_ptr->get_buffer(),
+                                                             in_offset,
+                                                             in_count,
+                                                             in_stride);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2868,22 +2121,21 @@ bool Anvil::CommandBufferBase::record_draw_indirect_count_AMD(Anvil::Buffer* in_
     anvil_assert(m_device_ptr->get_extension_info()->amd_draw_indirect_count() );
 
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DrawIndirectCountAMDCommand(in_buffer_ptr,
-                                                             in_offset,
-                                                             in_count_buffer_ptr,
-                                                             in_count_offset,
-                                                             in_max_draw_count,
-                                                             in_stride) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DRAW_INDIRECT_COUNT_AMD,
+                                             in_buffer_ptr,
+                                             in_offset,
+                                             in_count_buffer_ptr,
+                                             in_count_offset,
+                                             in_max_draw_count,
+                                             in_stride);
     }
-    #endif
 
     entrypoints = m_device_ptr->get_extension_amd_draw_indirect_count_entrypoints();
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
@@ -2931,22 +2183,21 @@ bool Anvil::CommandBufferBase::record_draw_indirect_count_KHR(Anvil::Buffer* in_
     anvil_assert(m_device_ptr->get_extension_info()->khr_draw_indirect_count() );
 
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(DrawIndirectCountKHRCommand(in_buffer_ptr,
-                                                             in_offset,
-                                                             in_count_buffer_ptr,
-                                                             in_count_offset,
-                                                             in_max_draw_count,
-                                                             in_stride) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_DRAW_INDIRECT_COUNT_KHR,
+                                             in_buffer_ptr,
+                                             in_offset,
+                                             in_count_buffer_ptr,
+                                             in_count_offset,
+                                             in_max_draw_count,
+                                             in_stride);
     }
-    #endif
 
     entrypoints = m_device_ptr->get_extension_khr_draw_indirect_count_entrypoints();
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
@@ -2980,22 +2231,21 @@ bool Anvil::CommandBufferBase::record_end_query(Anvil::QueryPool* in_query_pool_
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(EndQueryCommand(in_query_pool_ptr,
-                                                 in_entry) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_END_QUERY,
+                                             in_query_pool_ptr,
+                                             in_entry);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdEndQuery(m_command_buffer,
-                                     in_query_pool_ptr->get_query_pool(),
-                                     in_entry);
+        m_device_ptr->get_dispatch_table().vkCmdEndQuery(m_command_buffer,
+                                                         in_query_pool_ptr->get_query_pool(),
+                                                         in_entry);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3021,16 +2271,15 @@ bool Anvil::CommandBufferBase::record_end_query_indexed_EXT(Anvil::QueryPool*
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(EndQueryIndexedEXTCommand(in_query_pool_ptr,
-                                                           in_query,
-                                                           in_index) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_END_QUERY_INDEXED_EXT,
+                                             in_query_pool_ptr,
+                                             in_query,
+                                             in_index);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
@@ -3080,35 +2329,16 @@ bool Anvil::CommandBufferBase::record_end_transform_feedback_EXT(const uint32_t&
                                                                                                                                                       : VK_NULL_HANDLE;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            std::vector<const Anvil::Buffer*> buffer_ptr_vec(in_n_counter_buffers);
-            std::vector<VkDeviceSize>         offset_vec    (in_n_counter_buffers);
-
-            for (uint32_t n_counter_buffer = 0;
-                          n_counter_buffer < in_n_counter_buffers;
-                        ++n_counter_buffer)
-            {
-                if (in_opt_counter_buffer_ptrs                   != nullptr &&
-                    in_opt_counter_buffer_ptrs[n_counter_buffer] != nullptr)
-                {
-                    buffer_ptr_vec.at(n_counter_buffer) = in_opt_counter_buffer_ptrs[n_counter_buffer];
-                }
-
-                if (in_opt_counter_buffer_offsets != nullptr)
-                {
-                    offset_vec.at(n_counter_buffer) = in_opt_counter_buffer_offsets[n_counter_buffer];
-                }
-            }
-
-            m_commands.push_back(EndTransformFeedbackEXTCommand(in_first_counter_buffer,
-                                                                buffer_ptr_vec,
-                                                                offset_vec) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_END_TRANSFORM_FEEDBACK_EXT,
+                                             in_first_counter_buffer,
+                                             in_n_counter_buffers,
+                                             Anvil::CommandStream::make_array(in_opt_counter_buffer_ptrs, in_n_counter_buffers),
+                                             Anvil::CommandStream::make_array(in_opt_counter_buffer_offsets, in_n_counter_buffers));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
@@ -3149,26 +2379,25 @@ bool Anvil::CommandBufferBase::record_fill_buffer(Anvil::Buffer* in_dst_buffer_p
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(FillBufferCommand(in_dst_buffer_ptr,
-                                                   in_dst_offset,
-                                                   in_size,
-                                                   in_data) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_FILL_BUFFER,
+                                             in_dst_buffer_ptr,
+                                             in_dst_offset,
+                                             in_size,
+                                             in_data);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdFillBuffer(m_command_buffer,
-                                       in_dst_buffer_ptr->get_buffer(),
-                                       in_dst_offset,
-                                       in_size,
-                                       in_data);
+        m_device_ptr->get_dispatch_table().vkCmdFillBuffer(m_command_buffer,
+                                                           in_dst_buffer_ptr->get_buffer(),
+                                                           in_dst_offset,
+                                                           in_size,
+                                                           in_data);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3205,22 +2434,16 @@ bool Anvil::CommandBufferBase::record_pipeline_barrier(Anvil::PipelineStageFlags
     anvil_assert((!m_is_renderpass_active)                                                                           ||
                  ((m_is_renderpass_active) && (in_dependency_flags & Anvil::DependencyFlagBits::VIEW_LOCAL_BIT) == 0));
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(PipelineBarrierCommand(in_src_stage_mask,
-                                                        in_dst_stage_mask,
-                                                        in_dependency_flags,
-                                                        in_memory_barrier_count,
-                                                        in_memory_barriers_ptr,
-                                                        in_buffer_memory_barrier_count,
-                                                        in_buffer_memory_barriers_ptr,
-                                                        in_image_memory_barrier_count,
-                                                        in_image_memory_barriers_ptr) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_PIPELINE_BARRIER,
+                                             in_src_stage_mask,
+                                             in_dst_stage_mask,
+                                             in_dependency_flags,
+                                             Anvil::CommandStream::make_array(in_memory_barriers_ptr, in_memory_barrier_count),
+                                             Anvil::CommandStream::make_array(in_buffer_memory_barriers_ptr, in_buffer_memory_barrier_count),
+                                             Anvil::CommandStream::make_array(in_image_memory_barriers_ptr, in_image_memory_barrier_count));
     }
-    #endif
 
     if (get_n_of_callback_subscribers(COMMAND_BUFFER_CALLBACK_ID_PIPELINE_BARRIER_COMMAND_RECORDED) > 0)
     {
@@ -3261,19 +2484,53 @@ bool Anvil::CommandBufferBase::record_pipeline_barrier(Anvil::PipelineStageFlags
         memory_barriers_vk.at(n_memory_barrier) = in_memory_barriers_ptr[n_memory_barrier].get_barrier_vk();
     }
 
+    if ( m_pipeline_barrier_batch_ptr != nullptr &&
+        !m_is_renderpass_active)
+    {
+        if (!m_pipeline_barrier_batch_ptr->add(in_src_stage_mask,
+                                               in_dst_stage_mask,
+                                               in_dependency_flags,
+                                               in_memory_barrier_count,
+                                               (in_memory_barrier_count > 0) ? &memory_barriers_vk.at(0) : nullptr,
+                                               in_buffer_memory_barrier_count,
+                                               (in_buffer_memory_barrier_count > 0) ? &buffer_barriers_vk.at(0) : nullptr,
+                                               in_image_memory_barrier_count,
+                                               (in_image_memory_barrier_count > 0) ? &image_barriers_vk.at(0) : nullptr) )
+        {
+            /* The barriers depend on pending ones, which need to be issued first */
+            flush_pending_pipeline_barriers();
+
+            m_pipeline_barrier_batch_ptr->add(in_src_stage_mask,
+                                              in_dst_stage_mask,
+                                              in_dependency_flags,
+                                              in_memory_barrier_count,
+                                              (in_memory_barrier_count > 0) ? &memory_barriers_vk.at(0) : nullptr,
+                                              in_buffer_memory_barrier_count,
+                                              (in_buffer_memory_barrier_count > 0) ? &buffer_barriers_vk.at(0) : nullptr,
+                                              in_image_memory_barrier_count,
+                                              (in_image_memory_barrier_count > 0) ? &image_barriers_vk.at(0) : nullptr);
+        }
+
+        result = true;
+
+        goto end;
+    }
+
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdPipelineBarrier(m_command_buffer,
-                                            in_src_stage_mask.get_vk  (),
-                                            in_dst_stage_mask.get_vk  (),
-                                            in_dependency_flags.get_vk(),
-                                            in_memory_barrier_count,
-                                            (in_memory_barrier_count > 0) ? &memory_barriers_vk.at(0) : nullptr,
-                                            in_buffer_memory_barrier_count,
-                                            (in_buffer_memory_barrier_count > 0) ? &buffer_barriers_vk.at(0) : nullptr,
-                                            in_image_memory_barrier_count,
-                                            (in_image_memory_barrier_count > 0) ? &image_barriers_vk.at(0) : nullptr);
+        m_device_ptr->get_dispatch_table().vkCmdPipelineBarrier(m_command_buffer,
+                                                                in_src_stage_mask.get_vk  (),
+                                                                in_dst_stage_mask.get_vk  (),
+                                                                in_dependency_flags.get_vk(),
+                                                                in_memory_barrier_count,
+                                                                (in_memory_barrier_count > 0) ? &memory_barriers_vk.at(0) : nullptr,
+                                                                in_buffer_memory_barrier_count,
+                                                                (in_buffer_memory_barrier_count > 0) ? &buffer_barriers_vk.at(0) : nullptr,
+                                                                in_image_memory_barrier_count,
+                                                                (in_image_memory_barrier_count > 0) ? &image_barriers_vk.at(0) : nullptr);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3300,28 +2557,38 @@ bool Anvil::CommandBufferBase::record_push_constants(Anvil::PipelineLayout*  in_
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_redundant_state_filter_ptr != nullptr                                                &&
+        m_redundant_state_filter_ptr->filter_push_constants(in_layout_ptr->get_pipeline_layout(),
+                                                            in_stage_flags,
+                                                            in_offset,
+                                                            in_size,
+                                                            in_values) )
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(PushConstantsCommand(in_layout_ptr,
-                                                      in_stage_flags,
-                                                      in_offset,
-                                                      in_size,
-                                                      in_values) );
-        }
+        result = true;
+
+        goto end;
     }
-    #endif
+
+    if (m_command_stream_ptr != nullptr)
+    {
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_PUSH_CONSTANTS,
+                                             in_layout_ptr,
+                                             in_stage_flags,
+                                             in_offset,
+                                             Anvil::CommandStream::make_array(static_cast<const uint8_t*>(in_values), in_size));
+    }
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdPushConstants(m_command_buffer,
-                                          in_layout_ptr->get_pipeline_layout(),
-                                          in_stage_flags.get_vk(),
-                                          in_offset,
-                                          in_size,
-                                          in_values);
+        m_device_ptr->get_dispatch_table().vkCmdPushConstants(m_command_buffer,
+                                                              in_layout_ptr->get_pipeline_layout(),
+                                                              in_stage_flags.get_vk(),
+                                                              in_offset,
+                                                              in_size,
+                                                              in_values);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3351,22 +2618,21 @@ bool Anvil::CommandBufferBase::record_reset_event(Anvil::Event*             in_e
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(ResetEventCommand(in_event_ptr,
-                                                   in_stage_mask) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_RESET_EVENT,
+                                             in_event_ptr,
+                                             in_stage_mask);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdResetEvent(m_command_buffer,
-                                       in_event_ptr->get_event(),
-                                       in_stage_mask.get_vk() );
+        m_device_ptr->get_dispatch_table().vkCmdResetEvent(m_command_buffer,
+                                                           in_event_ptr->get_event(),
+                                                           in_stage_mask.get_vk() );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3397,24 +2663,23 @@ bool Anvil::CommandBufferBase::record_reset_query_pool(Anvil::QueryPool* in_quer
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(ResetQueryPoolCommand(in_query_pool_ptr,
-                                                       in_start_query,
-                                                       in_query_count) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_RESET_QUERY_POOL,
+                                             in_query_pool_ptr,
+                                             in_start_query,
+                                             in_query_count);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdResetQueryPool(m_command_buffer,
-                                           in_query_pool_ptr->get_query_pool(),
-                                           in_start_query,
-                                           in_query_count);
+        m_device_ptr->get_dispatch_table().vkCmdResetQueryPool(m_command_buffer,
+                                                               in_query_pool_ptr->get_query_pool(),
+                                                               in_start_query,
+                                                               in_query_count);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3448,30 +2713,28 @@ bool Anvil::CommandBufferBase::record_resolve_image(Anvil::Image*              i
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(ResolveImageCommand(in_src_image_ptr,
-                                                     in_src_image_layout,
-                                                     in_dst_image_ptr,
-                                                     in_dst_image_layout,
-                                                     in_region_count,
-                                                     in_region_ptrs) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_RESOLVE_IMAGE,
+                                             in_src_image_ptr,
+                                             in_src_image_layout,
+                                             in_dst_image_ptr,
+                                             in_dst_image_layout,
+                                             Anvil::CommandStream::make_array(in_region_ptrs, in_region_count));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdResolveImage(m_command_buffer,
-                                         in_src_image_ptr->get_image(),
-                                         static_cast<VkImageLayout>(in_src_image_layout),
-                                         in_dst_image_ptr->get_image(),
-                                         static_cast<VkImageLayout>(in_dst_image_layout),
-                                         in_region_count,
-                                         reinterpret_cast<const VkImageResolve*>(in_region_ptrs) );
+        m_device_ptr->get_dispatch_table().vkCmdResolveImage(m_command_buffer,
+                                                             in_src_image_ptr->get_image(),
+                                                             static_cast<VkImageLayout>(in_src_image_layout),
+                                                             in_dst_image_ptr->get_image(),
+                                                             static_cast<VkImageLayout>(in_dst_image_layout),
+                                                             in_region_count,
+                                                             reinterpret_cast<const VkImageResolve*>(in_region_ptrs) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3494,20 +2757,19 @@ bool Anvil::CommandBufferBase::record_set_blend_constants(const float in_blend_c
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetBlendConstantsCommand(in_blend_constants));
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_BLEND_CONSTANTS,
+                                             Anvil::CommandStream::make_array(in_blend_constants, 4));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetBlendConstants(m_command_buffer,
-                                              in_blend_constants);
+        m_device_ptr->get_dispatch_table().vkCmdSetBlendConstants(m_command_buffer,
+                                                                  in_blend_constants);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3532,24 +2794,23 @@ bool Anvil::CommandBufferBase::record_set_depth_bias(float in_depth_bias_constan
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetDepthBiasCommand(in_depth_bias_constant_factor,
-                                                     in_depth_bias_clamp,
-                                                     in_slope_scaled_depth_bias) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_DEPTH_BIAS,
+                                             in_depth_bias_constant_factor,
+                                             in_depth_bias_clamp,
+                                             in_slope_scaled_depth_bias);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetDepthBias(m_command_buffer,
-                                         in_depth_bias_constant_factor,
-                                         in_depth_bias_clamp,
-                                         in_slope_scaled_depth_bias);
+        m_device_ptr->get_dispatch_table().vkCmdSetDepthBias(m_command_buffer,
+                                                             in_depth_bias_constant_factor,
+                                                             in_depth_bias_clamp,
+                                                             in_slope_scaled_depth_bias);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3573,22 +2834,21 @@ bool Anvil::CommandBufferBase::record_set_depth_bounds(float in_min_depth_bounds
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetDepthBoundsCommand(in_min_depth_bounds,
-                                                       in_max_depth_bounds) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_DEPTH_BOUNDS,
+                                             in_min_depth_bounds,
+                                             in_max_depth_bounds);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetDepthBounds(m_command_buffer,
-                                           in_min_depth_bounds,
-                                           in_max_depth_bounds);
+        m_device_ptr->get_dispatch_table().vkCmdSetDepthBounds(m_command_buffer,
+                                                               in_min_depth_bounds,
+                                                               in_max_depth_bounds);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3615,14 +2875,11 @@ bool Anvil::CommandBufferBase::record_set_device_mask_KHR(uint32_t in_device_mas
     anvil_assert(m_device_ptr->get_extension_info()->khr_device_group() );
     anvil_assert(in_device_mask != 0);
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetDeviceMaskKHRCommand(in_device_mask) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_DEVICE_MASK_KHR,
+                                             in_device_mask);
     }
-    #endif
 
     if (m_is_renderpass_active)
     {
@@ -3637,6 +2894,8 @@ bool Anvil::CommandBufferBase::record_set_device_mask_KHR(uint32_t in_device_mas
         }
     }
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
@@ -3682,22 +2941,21 @@ bool Anvil::CommandBufferBase::record_set_event(Anvil::Event*             in_eve
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetEventCommand(in_event_ptr,
-                                                 in_stage_mask) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_EVENT,
+                                             in_event_ptr,
+                                             in_stage_mask);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetEvent(m_command_buffer,
-                                     in_event_ptr->get_event(),
-                                     in_stage_mask.get_vk() );
+        m_device_ptr->get_dispatch_table().vkCmdSetEvent(m_command_buffer,
+                                                         in_event_ptr->get_event(),
+                                                         in_stage_mask.get_vk() );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3720,20 +2978,19 @@ bool Anvil::CommandBufferBase::record_set_line_width(float in_line_width)
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetLineWidthCommand(in_line_width) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_LINE_WIDTH,
+                                             in_line_width);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetLineWidth(m_command_buffer,
-                                         in_line_width);
+        m_device_ptr->get_dispatch_table().vkCmdSetLineWidth(m_command_buffer,
+                                                             in_line_width);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3758,17 +3015,16 @@ bool Anvil::CommandBufferBase::record_set_sample_locations_EXT(const Anvil::Samp
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetSampleLocationsEXTCommand(in_sample_locations_info) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_SAMPLE_LOCATIONS_EXT,
+                                             in_sample_locations_info);
     }
-    #endif
 
     sample_locations_info_vk = in_sample_locations_info.get_vk();
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
@@ -3798,24 +3054,32 @@ bool Anvil::CommandBufferBase::record_set_scissor(uint32_t        in_first_sciss
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_redundant_state_filter_ptr != nullptr                          &&
+        m_redundant_state_filter_ptr->filter_set_scissor(in_first_scissor,
+                                                         in_scissor_count,
+                                                         in_scissor_ptrs) )
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetScissorCommand(in_first_scissor,
-                                                   in_scissor_count,
-                                                   in_scissor_ptrs) );
-        }
+        result = true;
+
+        goto end;
+    }
+
+    if (m_command_stream_ptr != nullptr)
+    {
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_SCISSOR,
+                                             in_first_scissor,
+                                             Anvil::CommandStream::make_array(in_scissor_ptrs, in_scissor_count));
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetScissor(m_command_buffer,
-                                       in_first_scissor,
-                                       in_scissor_count,
-                                       in_scissor_ptrs);
+        m_device_ptr->get_dispatch_table().vkCmdSetScissor(m_command_buffer,
+                                                           in_first_scissor,
+                                                           in_scissor_count,
+                                                           in_scissor_ptrs);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3839,22 +3103,21 @@ bool Anvil::CommandBufferBase::record_set_stencil_compare_mask(Anvil::StencilFac
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetStencilCompareMaskCommand(in_face_mask,
-                                                              in_stencil_compare_mask) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_STENCIL_COMPARE_MASK,
+                                             in_face_mask,
+                                             in_stencil_compare_mask);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetStencilCompareMask(m_command_buffer,
-                                                  in_face_mask.get_vk(),
-                                                  in_stencil_compare_mask);
+        m_device_ptr->get_dispatch_table().vkCmdSetStencilCompareMask(m_command_buffer,
+                                                                      in_face_mask.get_vk(),
+                                                                      in_stencil_compare_mask);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3878,22 +3141,21 @@ bool Anvil::CommandBufferBase::record_set_stencil_reference(Anvil::StencilFaceFl
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetStencilReferenceCommand(in_face_mask,
-                                                            in_stencil_reference) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_STENCIL_REFERENCE,
+                                             in_face_mask,
+                                             in_stencil_reference);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetStencilReference(m_command_buffer,
-                                                in_face_mask.get_vk(),
-                                                in_stencil_reference);
+        m_device_ptr->get_dispatch_table().vkCmdSetStencilReference(m_command_buffer,
+                                                                    in_face_mask.get_vk(),
+                                                                    in_stencil_reference);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3917,22 +3179,21 @@ bool Anvil::CommandBufferBase::record_set_stencil_write_mask(Anvil::StencilFaceF
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetStencilWriteMaskCommand(in_face_mask,
-                                                            in_stencil_write_mask) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_STENCIL_WRITE_MASK,
+                                             in_face_mask,
+                                             in_stencil_write_mask);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetStencilWriteMask(m_command_buffer,
-                                                in_face_mask.get_vk(),
-                                                in_stencil_write_mask);
+        m_device_ptr->get_dispatch_table().vkCmdSetStencilWriteMask(m_command_buffer,
+                                                                    in_face_mask.get_vk(),
+                                                                    in_stencil_write_mask);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3957,24 +3218,32 @@ bool Anvil::CommandBufferBase::record_set_viewport(uint32_t          in_first_vi
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_redundant_state_filter_ptr != nullptr                            &&
+        m_redundant_state_filter_ptr->filter_set_viewport(in_first_viewport,
+                                                          in_viewport_count,
+                                                          in_viewport_ptrs) )
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(SetViewportCommand(in_first_viewport,
-                                                    in_viewport_count,
-                                                    in_viewport_ptrs) );
-        }
+        result = true;
+
+        goto end;
     }
-    #endif
+
+    if (m_command_stream_ptr != nullptr)
+    {
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_SET_VIEWPORT,
+                                             in_first_viewport,
+                                             Anvil::CommandStream::make_array(in_viewport_ptrs, in_viewport_count));
+    }
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdSetViewport(m_command_buffer,
-                                        in_first_viewport,
-                                        in_viewport_count,
-                                        in_viewport_ptrs);
+        m_device_ptr->get_dispatch_table().vkCmdSetViewport(m_command_buffer,
+                                                            in_first_viewport,
+                                                            in_viewport_count,
+                                                            in_viewport_ptrs);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -4006,27 +3275,25 @@ bool Anvil::CommandBufferBase::record_update_buffer(Anvil::Buffer* in_dst_buffer
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(UpdateBufferCommand(in_dst_buffer_ptr,
-                                                     in_dst_offset,
-                                                     in_data_size,
-                                                     in_data_ptr) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_UPDATE_BUFFER,
+                                             in_dst_buffer_ptr,
+                                             in_dst_offset,
+                                             Anvil::CommandStream::make_array(static_cast<const uint8_t*>(in_data_ptr), static_cast<uint32_t>(in_data_size)));
     }
-    #endif
 
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdUpdateBuffer(m_command_buffer,
-                                         in_dst_buffer_ptr->get_buffer(),
-                                         in_dst_offset,
-                                         in_data_size,
-                                         in_data_ptr);
+        m_device_ptr->get_dispatch_table().vkCmdUpdateBuffer(m_command_buffer,
+                                                             in_dst_buffer_ptr->get_buffer(),
+                                                             in_dst_offset,
+                                                             in_data_size,
+                                                             in_data_ptr);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -4065,23 +3332,16 @@ bool Anvil::CommandBufferBase::record_wait_events(uint32_t                   in_
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(WaitEventsCommand(in_event_count,
-                                                   in_events,
-                                                   in_src_stage_mask,
-                                                   in_dst_stage_mask,
-                                                   in_memory_barrier_count,
-                                                   in_memory_barriers_ptr,
-                                                   in_buffer_memory_barrier_count,
-                                                   in_buffer_memory_barriers_ptr,
-                                                   in_image_memory_barrier_count,
-                                                   in_image_memory_barriers_ptr) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_WAIT_EVENTS,
+                                             Anvil::CommandStream::make_array(in_events, in_event_count),
+                                             in_src_stage_mask,
+                                             in_dst_stage_mask,
+                                             Anvil::CommandStream::make_array(in_memory_barriers_ptr, in_memory_barrier_count),
+                                             Anvil::CommandStream::make_array(in_buffer_memory_barriers_ptr, in_buffer_memory_barrier_count),
+                                             Anvil::CommandStream::make_array(in_image_memory_barriers_ptr, in_image_memory_barrier_count));
     }
-    #endif
 
 
     for (uint32_t n_event = 0;
@@ -4112,20 +3372,22 @@ bool Anvil::CommandBufferBase::record_wait_events(uint32_t                   in_
         memory_barriers_vk.at(n_memory_barrier) = in_memory_barriers_ptr[n_memory_barrier].get_barrier_vk();
     }
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdWaitEvents(m_command_buffer,
-                                       in_event_count,
-                                       (in_event_count > 0) ? &events.at(0) : nullptr,
-                                       in_src_stage_mask.get_vk(),
-                                       in_dst_stage_mask.get_vk(),
-                                       in_memory_barrier_count,
-                                       (in_memory_barrier_count > 0) ? &memory_barriers_vk.at(0) : nullptr,
-                                       in_buffer_memory_barrier_count,
-                                       (in_buffer_memory_barrier_count > 0) ? &buffer_barriers_vk.at(0) : nullptr,
-                                       in_image_memory_barrier_count,
-                                       (in_image_memory_barrier_count > 0) ? &image_barriers_vk.at(0) : nullptr);
+        m_device_ptr->get_dispatch_table().vkCmdWaitEvents(m_command_buffer,
+                                                           in_event_count,
+                                                           (in_event_count > 0) ? &events.at(0) : nullptr,
+                                                           in_src_stage_mask.get_vk(),
+                                                           in_dst_stage_mask.get_vk(),
+                                                           in_memory_barrier_count,
+                                                           (in_memory_barrier_count > 0) ? &memory_barriers_vk.at(0) : nullptr,
+                                                           in_buffer_memory_barrier_count,
+                                                           (in_buffer_memory_barrier_count > 0) ? &buffer_barriers_vk.at(0) : nullptr,
+                                                           in_image_memory_barrier_count,
+                                                           (in_image_memory_barrier_count > 0) ? &image_barriers_vk.at(0) : nullptr);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -4152,17 +3414,16 @@ bool Anvil::CommandBufferBase::record_write_buffer_marker_AMD(const Anvil::Pipel
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(WriteBufferMarkerAMDCommand(in_pipeline_stage,
-                                                             in_dst_buffer_ptr,
-                                                             in_dst_offset,
-                                                             in_marker) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_WRITE_BUFFER_MARKER_AMD,
+                                             in_pipeline_stage,
+                                             in_dst_buffer_ptr,
+                                             in_dst_offset,
+                                             in_marker);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
@@ -4196,24 +3457,23 @@ bool Anvil::CommandBufferBase::record_write_timestamp(Anvil::PipelineStageFlagBi
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            m_commands.push_back(WriteTimestampCommand(in_pipeline_stage,
-                                                       in_query_pool_ptr,
-                                                       in_query_index) );
-        }
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_WRITE_TIMESTAMP,
+                                             in_pipeline_stage,
+                                             in_query_pool_ptr,
+                                             in_query_index);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdWriteTimestamp(m_command_buffer,
-                                           static_cast<VkPipelineStageFlagBits>(in_pipeline_stage),
-                                           in_query_pool_ptr->get_query_pool(),
-                                           in_query_index);
+        m_device_ptr->get_dispatch_table().vkCmdWriteTimestamp(m_command_buffer,
+                                                               static_cast<VkPipelineStageFlagBits>(in_pipeline_stage),
+                                                               in_query_pool_ptr->get_query_pool(),
+                                                               in_query_index);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -4239,8 +3499,8 @@ bool Anvil::CommandBufferBase::reset(bool in_should_release_resources)
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        result_vk = Anvil::Vulkan::vkResetCommandBuffer(m_command_buffer,
-                                                        (in_should_release_resources) ? VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT : 0u);
+        result_vk = m_device_ptr->get_dispatch_table().vkResetCommandBuffer(m_command_buffer,
+                                                                            (in_should_release_resources) ? VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT : 0u);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -4258,11 +3518,57 @@ bool Anvil::CommandBufferBase::reset(bool in_should_release_resources)
     }
     #endif
 
+    if (m_pipeline_barrier_batch_ptr != nullptr)
+    {
+        m_pipeline_barrier_batch_ptr->reset();
+    }
+
+    if (m_redundant_state_filter_ptr != nullptr)
+    {
+        m_redundant_state_filter_ptr->reset();
+    }
+
+    if (m_resource_state_tracker_ptr != nullptr)
+    {
+        m_resource_state_tracker_ptr->reset();
+    }
+
     result = true;
 end:
     return result;
 }
 
+/* Please see header for specification */
+void Anvil::CommandBufferBase::set_pipeline_barrier_batching_enabled(bool in_enabled)
+{
+    if (!in_enabled)
+    {
+        flush_pending_pipeline_barriers();
+
+        m_pipeline_barrier_batch_ptr.reset();
+    }
+    else
+    if (m_pipeline_barrier_batch_ptr == nullptr)
+    {
+        m_pipeline_barrier_batch_ptr = Anvil::PipelineBarrierBatch::create();
+    }
+}
+
+/* Please see header for specification */
+void Anvil::CommandBufferBase::set_redundant_state_filtering_enabled(bool in_enabled)
+{
+    if (!in_enabled)
+    {
+        m_redundant_state_filter_ptr.reset();
+    }
+    else
+    if (m_redundant_state_filter_ptr == nullptr)
+    {
+        /* A new filter assumes no state is known, so it is safe to create it mid-recording. */
+        m_redundant_state_filter_ptr = Anvil::RedundantStateFilter::create();
+    }
+}
+
 /* Please see header for specification */
 bool Anvil::CommandBufferBase::stop_recording()
 {
@@ -4276,10 +3582,12 @@ bool Anvil::CommandBufferBase::stop_recording()
         goto end;
     }
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        result_vk = Anvil::Vulkan::vkEndCommandBuffer(m_command_buffer);
+        result_vk = m_device_ptr->get_dispatch_table().vkEndCommandBuffer(m_command_buffer);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -4319,9 +3627,9 @@ Anvil::PrimaryCommandBuffer::PrimaryCommandBuffer(const Anvil::BaseDevice* in_de
 
     in_parent_command_pool_ptr->lock();
     {
-        result_vk = Anvil::Vulkan::vkAllocateCommandBuffers(m_device_ptr->get_device_vk(),
-                                                            &alloc_info,
-                                                            &m_command_buffer);
+        result_vk = m_device_ptr->get_dispatch_table().vkAllocateCommandBuffers(m_device_ptr->get_device_vk(),
+                                                                                &alloc_info,
+                                                                                &m_command_buffer);
     }
     in_parent_command_pool_ptr->unlock();
 
@@ -4474,43 +3782,19 @@ bool Anvil::PrimaryCommandBuffer::record_begin_render_pass_internal(const bool&
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            if (in_use_khr_create_rp2_extension)
-            {
-                m_commands.push_back(BeginRenderPass2KHRCommand(in_n_clear_values,
-                                                                in_clear_value_ptrs,
-                                                                in_fbo_ptr,
-                                                                in_device_mask,
-                                                                in_n_render_areas,
-                                                                in_render_areas_ptr,
-                                                                in_render_pass_ptr,
-                                                                in_contents,
-                                                                in_opt_n_attachment_initial_sample_locations,
-                                                                in_opt_attachment_initial_sample_locations_ptr,
-                                                                in_opt_n_post_subpass_sample_locations,
-                                                                in_opt_post_subpass_sample_locations_ptr) );
-            }
-            else
-            {
-                m_commands.push_back(BeginRenderPassCommand(in_n_clear_values,
-                                                            in_clear_value_ptrs,
-                                                            in_fbo_ptr,
-                                                            in_device_mask,
-                                                            in_n_render_areas,
-                                                            in_render_areas_ptr,
-                                                            in_render_pass_ptr,
-                                                            in_contents,
-                                                            in_opt_n_attachment_initial_sample_locations,
-                                                            in_opt_attachment_initial_sample_locations_ptr,
-                                                            in_opt_n_post_subpass_sample_locations,
-                                                            in_opt_post_subpass_sample_locations_ptr) );
-            }
-        }
+        m_command_stream_ptr->append_command((in_use_khr_create_rp2_extension) ? Anvil::COMMAND_TYPE_BEGIN_RENDER_PASS_2_KHR
+                                                                               : Anvil::COMMAND_TYPE_BEGIN_RENDER_PASS,
+                                             Anvil::CommandStream::make_array(in_clear_value_ptrs, in_n_clear_values),
+                                             in_fbo_ptr,
+                                             in_device_mask,
+                                             Anvil::CommandStream::make_array(in_render_areas_ptr, in_n_render_areas),
+                                             in_render_pass_ptr,
+                                             in_contents,
+                                             Anvil::CommandStream::make_array(in_opt_attachment_initial_sample_locations_ptr, in_opt_n_attachment_initial_sample_locations),
+                                             Anvil::CommandStream::make_array(in_opt_post_subpass_sample_locations_ptr, in_opt_n_post_subpass_sample_locations));
     }
-    #endif
 
     anvil_assert(in_render_areas_ptr != nullptr);
 
@@ -4578,16 +3862,18 @@ bool Anvil::PrimaryCommandBuffer::record_begin_render_pass_internal(const bool&
         render_pass_begin_info_chain.append_struct(sl_begin_info);
     }
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        auto chain_ptr = render_pass_begin_info_chain.create_chain();
+        auto root_struct_ptr = render_pass_begin_info_chain.bake_chain();
 
         if (!in_use_khr_create_rp2_extension)
         {
-            Anvil::Vulkan::vkCmdBeginRenderPass(m_command_buffer,
-                                                chain_ptr->get_root_struct(),
-                                                static_cast<VkSubpassContents>(in_contents) );
+            m_device_ptr->get_dispatch_table().vkCmdBeginRenderPass(m_command_buffer,
+                                                                    root_struct_ptr,
+                                                                    static_cast<VkSubpassContents>(in_contents) );
         }
         else
         {
@@ -4599,7 +3885,7 @@ bool Anvil::PrimaryCommandBuffer::record_begin_render_pass_internal(const bool&
             subpass_begin_info.sType    = VK_STRUCTURE_TYPE_SUBPASS_BEGIN_INFO_KHR;
 
             crp2_entrypoints.vkCmdBeginRenderPass2KHR(m_command_buffer,
-                                                      chain_ptr->get_root_struct(),
+                                                      root_struct_ptr,
                                                      &subpass_begin_info);
         }
     }
@@ -4645,21 +3931,13 @@ bool Anvil::PrimaryCommandBuffer::record_end_render_pass_internal(const bool& in
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            if (in_use_khr_create_rp2_extension)
-            {
-                m_commands.push_back(EndRenderPass2KHRCommand() );
-            }
-            else
-            {
-                m_commands.push_back(EndRenderPassCommand() );
-            }
-        }
+        m_command_stream_ptr->append_command((in_use_khr_create_rp2_extension) ? Anvil::COMMAND_TYPE_END_RENDER_PASS_2_KHR
+                                                                               : Anvil::COMMAND_TYPE_END_RENDER_PASS);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
@@ -4677,7 +3955,7 @@ bool Anvil::PrimaryCommandBuffer::record_end_render_pass_internal(const bool& in
         }
         else
         {
-            Anvil::Vulkan::vkCmdEndRenderPass(m_command_buffer);
+            m_device_ptr->get_dispatch_table().vkCmdEndRenderPass(m_command_buffer);
         }
     }
     unlock();
@@ -4694,8 +3972,10 @@ bool Anvil::PrimaryCommandBuffer::record_execute_commands(uint32_t
                                                           Anvil::SecondaryCommandBuffer** in_cmd_buffer_ptrs)
 {
     /* NOTE: The command can be executed both inside and outside a renderpass */
-    auto cmd_buffers = std::vector<VkCommandBuffer>(in_cmd_buffers_count);
-    bool result      = false;
+    auto                      cmd_buffers    = std::vector<VkCommandBuffer>(in_cmd_buffers_count);
+    Anvil::PipelineStageFlags dst_stage_mask;
+    bool                      result         = false;
+    Anvil::PipelineStageFlags src_stage_mask;
 
     if (!m_recording_in_progress)
     {
@@ -4704,15 +3984,60 @@ bool Anvil::PrimaryCommandBuffer::record_execute_commands(uint32_t
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    /* Account for resource usages declared by the secondary command buffers */
+    m_tracked_buffer_barriers.clear();
+    m_tracked_image_barriers.clear ();
+
+    for (uint32_t n_cmd_buffer = 0;
+                  n_cmd_buffer < in_cmd_buffers_count;
+                ++n_cmd_buffer)
     {
-        if (!m_command_stashing_disabled)
+        const auto tracker_ptr = in_cmd_buffer_ptrs[n_cmd_buffer]->get_resource_state_tracker();
+
+        if (tracker_ptr == nullptr  ||
+            tracker_ptr->is_empty() )
         {
-            m_commands.push_back(ExecuteCommandsCommand(in_cmd_buffers_count,
-                                                        in_cmd_buffer_ptrs) );
+            continue;
         }
+
+        if (m_resource_state_tracker_ptr == nullptr)
+        {
+            m_resource_state_tracker_ptr = Anvil::ResourceStateTracker::create();
+        }
+
+        m_resource_state_tracker_ptr->append(*tracker_ptr,
+                                            &src_stage_mask,
+                                            &dst_stage_mask,
+                                            &m_tracked_buffer_barriers,
+                                            &m_tracked_image_barriers);
+    }
+
+    if (m_tracked_buffer_barriers.size() > 0 ||
+        m_tracked_image_barriers.size () > 0)
+    {
+        if (m_is_renderpass_active)
+        {
+            anvil_assert(!m_is_renderpass_active);
+
+            goto end;
+        }
+
+        record_pipeline_barrier(src_stage_mask,
+                                dst_stage_mask,
+                                Anvil::DependencyFlagBits::NONE,
+                                0,       /* in_memory_barrier_count */
+                                nullptr, /* in_memory_barriers_ptr  */
+                                static_cast<uint32_t>(m_tracked_buffer_barriers.size() ),
+                                (m_tracked_buffer_barriers.size() > 0) ? &m_tracked_buffer_barriers.at(0) : nullptr,
+                                static_cast<uint32_t>(m_tracked_image_barriers.size() ),
+                                (m_tracked_image_barriers.size() > 0)  ? &m_tracked_image_barriers.at(0)  : nullptr);
+    }
+
+    if (m_command_stream_ptr != nullptr)
+    {
+        m_command_stream_ptr->append_command(Anvil::COMMAND_TYPE_EXECUTE_COMMANDS,
+                                             Anvil::CommandStream::make_array(in_cmd_buffer_ptrs, in_cmd_buffers_count));
     }
-    #endif
 
     for (uint32_t n_cmd_buffer = 0;
                   n_cmd_buffer < in_cmd_buffers_count;
@@ -4721,16 +4046,24 @@ bool Anvil::PrimaryCommandBuffer::record_execute_commands(uint32_t
         cmd_buffers.at(n_cmd_buffer) = in_cmd_buffer_ptrs[n_cmd_buffer]->get_command_buffer();
     }
 
+    flush_pending_pipeline_barriers();
+
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        Anvil::Vulkan::vkCmdExecuteCommands(m_command_buffer,
-                                            in_cmd_buffers_count,
-                                            (in_cmd_buffers_count > 0) ? &cmd_buffers.at(0) : nullptr);
+        m_device_ptr->get_dispatch_table().vkCmdExecuteCommands(m_command_buffer,
+                                                                in_cmd_buffers_count,
+                                                                (in_cmd_buffers_count > 0) ? &cmd_buffers.at(0) : nullptr);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
 
+    if (m_redundant_state_filter_ptr != nullptr)
+    {
+        /* State of a primary command buffer is undefined after vkCmdExecuteCommands() */
+        m_redundant_state_filter_ptr->invalidate();
+    }
+
     result = true;
 end:
     return result;
@@ -4772,21 +4105,14 @@ bool Anvil::PrimaryCommandBuffer::record_next_subpass_internal(const bool&
         goto end;
     }
 
-    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    if (m_command_stream_ptr != nullptr)
     {
-        if (!m_command_stashing_disabled)
-        {
-            if (in_use_khr_create_rp2_extension)
-            {
-                m_commands.push_back(NextSubpass2KHRCommand(in_contents) );
-            }
-            else
-            {
-                m_commands.push_back(NextSubpassCommand(in_contents) );
-            }
-        }
+        m_command_stream_ptr->append_command((in_use_khr_create_rp2_extension) ? Anvil::COMMAND_TYPE_NEXT_SUBPASS_2_KHR
+                                                                               : Anvil::COMMAND_TYPE_NEXT_SUBPASS,
+                                             in_contents);
     }
-    #endif
+
+    flush_pending_pipeline_barriers();
 
     m_parent_command_pool_ptr->lock();
     lock();
@@ -4810,8 +4136,8 @@ bool Anvil::PrimaryCommandBuffer::record_next_subpass_internal(const bool&
         }
         else
         {
-            Anvil::Vulkan::vkCmdNextSubpass(m_command_buffer,
-                                            static_cast<VkSubpassContents>(in_contents) );
+            m_device_ptr->get_dispatch_table().vkCmdNextSubpass(m_command_buffer,
+                                                                static_cast<VkSubpassContents>(in_contents) );
         }
     }
     unlock();
@@ -4879,8 +4205,8 @@ bool Anvil::PrimaryCommandBuffer::start_recording(bool
     {
         auto chain_ptr = struct_chainer.create_chain();
 
-        result_vk = Anvil::Vulkan::vkBeginCommandBuffer(m_command_buffer,
-                                                        chain_ptr->get_root_struct() );
+        result_vk = m_device_ptr->get_dispatch_table().vkBeginCommandBuffer(m_command_buffer,
+                                                                            chain_ptr->get_root_struct() );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -4899,6 +4225,24 @@ bool Anvil::PrimaryCommandBuffer::start_recording(bool
     }
     #endif
 
+    if (m_pipeline_barrier_batch_ptr != nullptr)
+    {
+        /* Barriers left pending by a previous recording were implicitly discarded by vkBeginCommandBuffer() */
+        m_pipeline_barrier_batch_ptr->reset();
+    }
+
+    if (m_redundant_state_filter_ptr != nullptr)
+    {
+        /* State of a command buffer is undefined when recording starts */
+        m_redundant_state_filter_ptr->reset();
+    }
+
+    if (m_resource_state_tracker_ptr != nullptr)
+    {
+        /* Resource usages declared by a previous recording no longer apply */
+        m_resource_state_tracker_ptr->reset();
+    }
+
     m_device_mask           = in_opt_device_mask;
     m_recording_in_progress = true;
     result                  = true;
@@ -4930,9 +4274,9 @@ Anvil::SecondaryCommandBuffer::SecondaryCommandBuffer(const Anvil::BaseDevice* i
 
     in_parent_command_pool_ptr->lock();
     {
-        result_vk = Anvil::Vulkan::vkAllocateCommandBuffers(m_device_ptr->get_device_vk(),
-                                                           &command_buffer_alloc_info,
-                                                           &m_command_buffer);
+        result_vk = m_device_ptr->get_dispatch_table().vkAllocateCommandBuffers(m_device_ptr->get_device_vk(),
+                                                                               &command_buffer_alloc_info,
+                                                                               &m_command_buffer);
     }
     in_parent_command_pool_ptr->unlock();
 
@@ -5015,8 +4359,8 @@ bool Anvil::SecondaryCommandBuffer::start_recording(bool
     {
         auto chain_ptr = struct_chainer.create_chain();
 
-        result_vk = Anvil::Vulkan::vkBeginCommandBuffer(m_command_buffer,
-                                                        chain_ptr->get_root_struct() );
+        result_vk = m_device_ptr->get_dispatch_table().vkBeginCommandBuffer(m_command_buffer,
+                                                                            chain_ptr->get_root_struct() );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -5035,6 +4379,24 @@ bool Anvil::SecondaryCommandBuffer::start_recording(bool
     }
     #endif
 
+    if (m_pipeline_barrier_batch_ptr != nullptr)
+    {
+        /* Barriers left pending by a previous recording were implicitly discarded by vkBeginCommandBuffer() */
+        m_pipeline_barrier_batch_ptr->reset();
+    }
+
+    if (m_redundant_state_filter_ptr != nullptr)
+    {
+        /* State of a command buffer is undefined when recording starts */
+        m_redundant_state_filter_ptr->reset();
+    }
+
+    if (m_resource_state_tracker_ptr != nullptr)
+    {
+        /* Resource usages declared by a previous recording no longer apply */
+        m_resource_state_tracker_ptr->reset();
+    }
+
     m_is_renderpass_active  = in_renderpass_usage_only;
     m_recording_in_progress = true;
     result                  = true;
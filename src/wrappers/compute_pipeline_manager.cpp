@@ -252,12 +252,12 @@ bool Anvil::ComputePipelineManager::bake()
 
         m_pipeline_cache_ptr->lock();
         {
-            result_vk = Anvil::Vulkan::vkCreateComputePipelines(m_device_ptr->get_device_vk(),
-                                                                m_pipeline_cache_ptr->get_pipeline_cache(),
-                                                                static_cast<uint32_t>(pipeline_create_info_items_vk.size() ),
-                                                               &pipeline_create_info_items_vk[0],
-                                                                nullptr, /* pAllocator */
-                                                               &result_pipeline_items_vk[0]);
+            result_vk = m_device_ptr->get_dispatch_table().vkCreateComputePipelines(m_device_ptr->get_device_vk(),
+                                                                                    m_pipeline_cache_ptr->get_pipeline_cache(),
+                                                                                    static_cast<uint32_t>(pipeline_create_info_items_vk.size() ),
+                                                                                   &pipeline_create_info_items_vk[0],
+                                                                                    nullptr, /* pAllocator */
+                                                                                   &result_pipeline_items_vk[0]);
         }
         m_pipeline_cache_ptr->unlock();
 
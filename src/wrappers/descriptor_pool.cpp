@@ -58,9 +58,9 @@ Anvil::DescriptorPool::~DescriptorPool()
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroyDescriptorPool(m_device_ptr->get_device_vk(),
-                                                   m_pool,
-                                                   nullptr /* pAllocator */);
+            m_device_ptr->get_dispatch_table().vkDestroyDescriptorPool(m_device_ptr->get_device_vk(),
+                                                                       m_pool,
+                                                                       nullptr /* pAllocator */);
         }
         unlock();
 
@@ -201,9 +201,9 @@ bool Anvil::DescriptorPool::alloc_descriptor_sets(uint32_t
         {
             auto chain_ptr = struct_chainer.create_chain();
 
-            result_vk = Anvil::Vulkan::vkAllocateDescriptorSets(m_device_ptr->get_device_vk(),
-                                                                chain_ptr->get_root_struct(),
-                                                                out_descriptor_sets_vk_ptr);
+            result_vk = m_device_ptr->get_dispatch_table().vkAllocateDescriptorSets(m_device_ptr->get_device_vk(),
+                                                                                    chain_ptr->get_root_struct(),
+                                                                                    out_descriptor_sets_vk_ptr);
         }
     }
     unlock();
@@ -329,10 +329,10 @@ bool Anvil::DescriptorPool::init()
     {
         auto chain_ptr = struct_chainer.create_chain();
 
-        result_vk = Anvil::Vulkan::vkCreateDescriptorPool(m_device_ptr->get_device_vk(),
-                                                          chain_ptr->get_root_struct (),
-                                                          nullptr, /* pAllocator */
-                                                         &m_pool);
+        result_vk = m_device_ptr->get_dispatch_table().vkCreateDescriptorPool(m_device_ptr->get_device_vk(),
+                                                                              chain_ptr->get_root_struct (),
+                                                                              nullptr, /* pAllocator */
+                                                                             &m_pool);
     }
 
     anvil_assert_vk_call_succeeded(result_vk);
@@ -362,9 +362,9 @@ bool Anvil::DescriptorPool::reset()
         /* TODO: Host synchronization to VkDescriptorSetObjects alloc'ed from the pool. */
         lock();
         {
-            result_vk = Anvil::Vulkan::vkResetDescriptorPool(m_device_ptr->get_device_vk(),
-                                                             m_pool,
-                                                             0 /* flags */);
+            result_vk = m_device_ptr->get_dispatch_table().vkResetDescriptorPool(m_device_ptr->get_device_vk(),
+                                                                                 m_pool,
+                                                                                 0 /* flags */);
         }
         unlock();
 
@@ -23,6 +23,7 @@
 #include "misc/buffer_create_info.h"
 #include "misc/debug.h"
 #include "misc/descriptor_set_create_info.h"
+#include "misc/instrumentation.h"
 #include "misc/object_tracker.h"
 #include "wrappers/buffer.h"
 #include "wrappers/buffer_view.h"
@@ -689,6 +690,10 @@ bool Anvil::DescriptorSet::set_inline_uniform_block_binding_data(const BindingIn
 
 bool Anvil::DescriptorSet::update(const DescriptorSetUpdateMethod& in_update_method) const
 {
+    ANVIL_INSTRUMENTATION_SCOPE  ("DescriptorSet::update");
+    ANVIL_INSTRUMENTATION_COUNTER("DescriptorSet::update calls",
+                                  1);
+
     bool result;
 
     lock();
@@ -952,11 +957,11 @@ bool Anvil::DescriptorSet::update_using_core_method() const
         /* Issue the Vulkan call */
         if (m_cached_ds_write_items_vk.size() > 0)
         {
-            Anvil::Vulkan::vkUpdateDescriptorSets(m_device_ptr->get_device_vk(),
-                                                  static_cast<uint32_t>(m_cached_ds_write_items_vk.size() ),
-                                                 &m_cached_ds_write_items_vk[0],
-                                                  0,        /* copyCount         */
-                                                  nullptr); /* pDescriptorCopies */
+            m_device_ptr->get_dispatch_table().vkUpdateDescriptorSets(m_device_ptr->get_device_vk(),
+                                                                      static_cast<uint32_t>(m_cached_ds_write_items_vk.size() ),
+                                                                     &m_cached_ds_write_items_vk[0],
+                                                                      0,        /* copyCount         */
+                                                                      nullptr); /* pDescriptorCopies */
 
             /* If any IUB bindings have been processed, wipe out binding items associated with these, as the corresponding updates have already
              * been performed.
@@ -21,7 +21,11 @@
 //
 
 #include "misc/debug.h"
+#include "misc/deferred_memory_flush_list.h"
+#include "misc/fence_pool.h"
+#include "misc/memory_budget_tracker.h"
 #include "misc/object_tracker.h"
+#include "misc/sampler_cache.h"
 #include "misc/shader_module_cache.h"
 #include "misc/struct_chainer.h"
 #include "misc/swapchain_create_info.h"
@@ -78,14 +82,18 @@ Anvil::BaseDevice::~BaseDevice()
     m_descriptor_set_layout_manager_ptr.reset();
     m_pipeline_cache_ptr.reset               ();
     m_pipeline_layout_manager_ptr.reset      ();
+    m_sampler_cache_ptr.reset                ();
     m_owned_queues.clear                     ();
+    m_fence_pool_ptr.reset                   ();
+    m_memory_budget_tracker_ptr.reset        ();
+    m_deferred_memory_flush_list_ptr.reset   ();
 
     if (m_device != VK_NULL_HANDLE)
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroyDevice(m_device,
-                                           nullptr); /* pAllocator */
+            m_dispatch_table.vkDestroyDevice(m_device,
+                                             nullptr); /* pAllocator */
         }
         unlock();
 
@@ -566,6 +574,11 @@ void Anvil::BaseDevice::add_physical_device_features_to_chainer(Anvil::StructCha
         in_struct_chainer_ptr->append_struct(features.khr_float16_int8_features_ptr->get_vk_physical_device_float16_int8_features() );
     }
 
+    if (m_extension_enabled_info_ptr->get_device_extension_info()->khr_timeline_semaphore() )
+    {
+        in_struct_chainer_ptr->append_struct(features.khr_timeline_semaphore_features_ptr->get_vk_physical_device_timeline_semaphore_features() );
+    }
+
     if (m_extension_enabled_info_ptr->get_device_extension_info()->khr_variable_pointers() )
     {
         in_struct_chainer_ptr->append_struct(features.khr_variable_pointer_features_ptr->get_vk_physical_device_variable_pointer_features() );
@@ -1043,6 +1056,18 @@ bool Anvil::BaseDevice::init()
             anvil_assert(m_device != VK_NULL_HANDLE);
         }
 
+        /* Retrieve device-level func pointers. These need to be available before any other device-level call is made. */
+        if (!m_dispatch_table.init(m_device) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        /* Set up memory accounting. This needs to happen before any memory block is created. */
+        m_memory_budget_tracker_ptr = Anvil::MemoryBudgetTracker::create(this,
+                                                                         is_mt_safe() );
+
         /* Re-create the "extension enabled info" variable, this time taking into account contexts newer than 1.0.
          *
          * This is important for applications that use VK 1.1 contexts (or newer) and do not take into account that Vulkan does not
@@ -1082,6 +1107,14 @@ bool Anvil::BaseDevice::init()
         goto end;
     }
 
+    /* Set up the deferred memory flush list. Queues flush it at submission time. */
+    m_deferred_memory_flush_list_ptr = Anvil::DeferredMemoryFlushList::create(this,
+                                                                              is_mt_safe() );
+
+    /* Set up the fence pool. This needs to happen before queues are created, since they use pooled fences for blocking submissions. */
+    m_fence_pool_ptr = Anvil::FencePool::create(this,
+                                                is_mt_safe() );
+
     /* Spawn queue wrappers */
     for (Anvil::QueueFamilyType queue_family_type = Anvil::QueueFamilyType::FIRST;
                                 queue_family_type < Anvil::QueueFamilyType::COUNT;
@@ -1198,6 +1231,10 @@ bool Anvil::BaseDevice::init()
     m_descriptor_set_layout_manager_ptr = Anvil::DescriptorSetLayoutManager::create(this,
                                                                                     is_mt_safe() );
 
+    /* Set up the sampler cache */
+    m_sampler_cache_ptr = Anvil::SamplerCache::create(this,
+                                                      is_mt_safe() );
+
     /* Initialize compute & graphics pipeline managers */
     m_compute_pipeline_manager_ptr  = Anvil::ComputePipelineManager::create (this,
                                                                              is_mt_safe() ,
@@ -1560,6 +1597,17 @@ bool Anvil::BaseDevice::init_extension_func_ptrs()
         anvil_assert(m_khr_swapchain_extension_entrypoints.vkQueuePresentKHR       != nullptr);
     }
 
+    if (m_extension_enabled_info_ptr->get_device_extension_info()->khr_timeline_semaphore() )
+    {
+        m_khr_timeline_semaphore_extension_entrypoints.vkGetSemaphoreCounterValueKHR = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(get_proc_address("vkGetSemaphoreCounterValueKHR") );
+        m_khr_timeline_semaphore_extension_entrypoints.vkSignalSemaphoreKHR          = reinterpret_cast<PFN_vkSignalSemaphoreKHR>         (get_proc_address("vkSignalSemaphoreKHR") );
+        m_khr_timeline_semaphore_extension_entrypoints.vkWaitSemaphoresKHR           = reinterpret_cast<PFN_vkWaitSemaphoresKHR>          (get_proc_address("vkWaitSemaphoresKHR") );
+
+        anvil_assert(m_khr_timeline_semaphore_extension_entrypoints.vkGetSemaphoreCounterValueKHR != nullptr);
+        anvil_assert(m_khr_timeline_semaphore_extension_entrypoints.vkSignalSemaphoreKHR          != nullptr);
+        anvil_assert(m_khr_timeline_semaphore_extension_entrypoints.vkWaitSemaphoresKHR           != nullptr);
+    }
+
     return true;
 }
 
@@ -1602,7 +1650,7 @@ bool Anvil::BaseDevice::wait_idle() const
         }
     }
 
-    result_vk = Anvil::Vulkan::vkDeviceWaitIdle(m_device);
+    result_vk = m_dispatch_table.vkDeviceWaitIdle(m_device);
 
     if (mt_safe)
     {
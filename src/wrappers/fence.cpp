@@ -36,7 +36,8 @@ Anvil::Fence::Fence(Anvil::FenceCreateInfoUniquePtr in_create_info_ptr)
                                 Anvil::ObjectType::FENCE),
      MTSafetySupportProvider   (Anvil::Utils::convert_mt_safety_enum_to_boolean(in_create_info_ptr->get_mt_safety(),
                                                                                 in_create_info_ptr->get_device   () )),
-     m_fence                   (VK_NULL_HANDLE)
+     m_fence                   (VK_NULL_HANDLE),
+     m_has_been_submitted      (false)
 {
     m_create_info_ptr = std::move(in_create_info_ptr);
 
@@ -335,10 +336,10 @@ bool Anvil::Fence::init()
         goto end;
     }
 
-    result = Anvil::Vulkan::vkCreateFence(m_device_ptr->get_device_vk(),
-                                          struct_chain_ptr->get_root_struct(),
-                                          nullptr, /* pAllocator */
-                                         &m_fence);
+    result = m_device_ptr->get_dispatch_table().vkCreateFence(m_device_ptr->get_device_vk(),
+                                                              struct_chain_ptr->get_root_struct(),
+                                                              nullptr, /* pAllocator */
+                                                             &m_fence);
 
     anvil_assert_vk_call_succeeded(result);
     if (is_vk_call_successful(result) )
@@ -355,8 +356,8 @@ bool Anvil::Fence::is_set() const
 {
     VkResult result;
 
-    result = Anvil::Vulkan::vkGetFenceStatus(m_device_ptr->get_device_vk(),
-                                             m_fence);
+    result = m_device_ptr->get_dispatch_table().vkGetFenceStatus(m_device_ptr->get_device_vk(),
+                                                                 m_fence);
 
     anvil_assert(result == VK_SUCCESS  ||
                  result == VK_NOT_READY);
@@ -371,9 +372,9 @@ void Anvil::Fence::release_fence()
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroyFence(m_device_ptr->get_device_vk(),
-                                          m_fence,
-                                          nullptr /* pAllocator */);
+            m_device_ptr->get_dispatch_table().vkDestroyFence(m_device_ptr->get_device_vk(),
+                                                              m_fence,
+                                                              nullptr /* pAllocator */);
         }
         unlock();
 
@@ -388,12 +389,17 @@ bool Anvil::Fence::reset()
 
     lock();
     {
-        result = Anvil::Vulkan::vkResetFences(m_device_ptr->get_device_vk(),
-                                              1, /* fenceCount */
-                                             &m_fence);
+        result = m_device_ptr->get_dispatch_table().vkResetFences(m_device_ptr->get_device_vk(),
+                                                                  1, /* fenceCount */
+                                                                 &m_fence);
     }
     unlock();
 
+    if (result == VK_SUCCESS)
+    {
+        m_has_been_submitted = false;
+    }
+
     return (result == VK_SUCCESS);
 }
 
@@ -401,59 +407,197 @@ bool Anvil::Fence::reset()
 bool Anvil::Fence::reset_fences(const uint32_t in_n_fences,
                                 Fence*         in_fences)
 {
-    const Anvil::BaseDevice* device_ptr           = nullptr;
-    auto                     fence_cache          = std::vector<VkFence>(in_n_fences);
-    static const uint32_t    fence_cache_capacity = sizeof(fence_cache) / sizeof(fence_cache[0]);
-    bool                     result               = true;
-    VkResult                 result_vk;
+    std::vector<Anvil::Fence*> fence_ptrs(in_n_fences);
+
+    for (uint32_t n_fence = 0;
+                  n_fence < in_n_fences;
+                ++n_fence)
+    {
+        fence_ptrs.at(n_fence) = in_fences + n_fence;
+    }
+
+    return reset_fences(in_n_fences,
+                        (in_n_fences > 0) ? &fence_ptrs.at(0) : nullptr);
+}
+
+/* Please see header for specification */
+bool Anvil::Fence::reset_fences(const uint32_t in_n_fences,
+                                Fence* const*  in_fence_ptrs)
+{
+    const Anvil::BaseDevice* device_ptr      = nullptr;
+    std::vector<VkFence>     fences_vk_heap;
+    VkFence                  fences_vk_local[16];
+    VkFence*                 fences_vk_ptr   = fences_vk_local;
+    VkResult                 result_vk       = VK_SUCCESS;
 
     if (in_n_fences == 0)
     {
         goto end;
     }
 
-    for (uint32_t n_fence_batch = 0;
-                  n_fence_batch < 1 + in_n_fences / fence_cache_capacity;
-                ++n_fence_batch)
+    if (in_n_fences > sizeof(fences_vk_local) / sizeof(fences_vk_local[0]) )
+    {
+        fences_vk_heap.resize(in_n_fences);
+
+        fences_vk_ptr = &fences_vk_heap.at(0);
+    }
+
+    device_ptr = in_fence_ptrs[0]->m_device_ptr;
+
+    for (uint32_t n_fence = 0;
+                  n_fence < in_n_fences;
+                ++n_fence)
     {
-        const uint32_t n_fences_remaining = in_n_fences - n_fence_batch * fence_cache_capacity;
+        Anvil::Fence* current_fence_ptr = in_fence_ptrs[n_fence];
+
+        anvil_assert(current_fence_ptr->m_device_ptr == device_ptr);
 
+        fences_vk_ptr[n_fence] = current_fence_ptr->m_fence;
+
+        current_fence_ptr->lock();
+    }
+    {
+        result_vk = device_ptr->get_dispatch_table().vkResetFences(device_ptr->get_device_vk(),
+                                                                   in_n_fences,
+                                                                   fences_vk_ptr);
+    }
+    for (uint32_t n_fence = 0;
+                  n_fence < in_n_fences;
+                ++n_fence)
+    {
+        in_fence_ptrs[n_fence]->unlock();
+    }
+
+    anvil_assert_vk_call_succeeded(result_vk);
+
+    if (is_vk_call_successful(result_vk) )
+    {
         for (uint32_t n_fence = 0;
-                      n_fence < n_fences_remaining;
+                      n_fence < in_n_fences;
                     ++n_fence)
         {
-            Anvil::Fence& current_fence = in_fences[n_fence_batch * fence_cache_capacity + n_fence];
+            in_fence_ptrs[n_fence]->m_has_been_submitted = false;
+        }
+    }
 
-            anvil_assert((device_ptr == nullptr)                                          ||
-                         (device_ptr != nullptr && current_fence.m_device_ptr != nullptr) );
+end:
+    return is_vk_call_successful(result_vk);
+}
 
-            device_ptr           = current_fence.m_device_ptr;
-            fence_cache[n_fence] = current_fence.m_fence;
+/* Please see header for specification */
+bool Anvil::Fence::wait(uint64_t in_timeout) const
+{
+    VkResult result;
+
+    result = m_device_ptr->get_dispatch_table().vkWaitForFences(m_device_ptr->get_device_vk(),
+                                                                1, /* fenceCount */
+                                                               &m_fence,
+                                                                VK_TRUE, /* waitAll */
+                                                                in_timeout);
+
+    anvil_assert(result == VK_SUCCESS  ||
+                 result == VK_TIMEOUT);
+
+    return (result == VK_SUCCESS);
+}
+
+/* Please see header for specification */
+bool Anvil::Fence::wait_all(const uint32_t in_n_fences,
+                            Fence* const*  in_fence_ptrs,
+                            uint64_t       in_timeout)
+{
+    return wait_for_fences(in_n_fences,
+                           in_fence_ptrs,
+                           true, /* in_wait_all */
+                           in_timeout);
+}
+
+/* Please see header for specification */
+bool Anvil::Fence::wait_any(const uint32_t in_n_fences,
+                            Fence* const*  in_fence_ptrs,
+                            uint64_t       in_timeout,
+                            uint32_t*      out_opt_signalled_fence_idx_ptr)
+{
+    bool result = false;
+
+    anvil_assert(in_n_fences > 0);
+
+    result = wait_for_fences(in_n_fences,
+                             in_fence_ptrs,
+                             false, /* in_wait_all */
+                             in_timeout);
+
+    if (result                          &&
+        out_opt_signalled_fence_idx_ptr != nullptr)
+    {
+        /* vkWaitForFences() does not report which fence has been signalled, so we need to find out ourselves. */
+        *out_opt_signalled_fence_idx_ptr = UINT32_MAX;
 
-            current_fence.lock();
-        }
-        {
-            result_vk = Anvil::Vulkan::vkResetFences(device_ptr->get_device_vk(),
-                                                     n_fences_remaining,
-                                                     (n_fences_remaining > 0) ? &fence_cache.at(0) : nullptr);
-        }
         for (uint32_t n_fence = 0;
-                      n_fence < n_fences_remaining;
+                      n_fence < in_n_fences;
                     ++n_fence)
         {
-            Anvil::Fence& current_fence = in_fences[n_fence_batch * fence_cache_capacity + n_fence];
+            if (in_fence_ptrs[n_fence]->is_set() )
+            {
+                *out_opt_signalled_fence_idx_ptr = n_fence;
 
-            current_fence.unlock();
+                break;
+            }
         }
 
-        anvil_assert_vk_call_succeeded(result_vk);
+        anvil_assert(*out_opt_signalled_fence_idx_ptr != UINT32_MAX);
+    }
 
-        if (!is_vk_call_successful(result_vk) )
-        {
-            result = false;
-        }
+    return result;
+}
+
+/** Waits on the specified fences with a single vkWaitForFences() call.
+ *
+ *  @return true if the wait condition was met, false if the wait timed out or failed.
+ **/
+bool Anvil::Fence::wait_for_fences(const uint32_t in_n_fences,
+                                   Fence* const*  in_fence_ptrs,
+                                   bool           in_wait_all,
+                                   uint64_t       in_timeout)
+{
+    const Anvil::BaseDevice* device_ptr      = nullptr;
+    std::vector<VkFence>     fences_vk_heap;
+    VkFence                  fences_vk_local[16];
+    VkFence*                 fences_vk_ptr   = fences_vk_local;
+    VkResult                 result_vk       = VK_SUCCESS;
+
+    if (in_n_fences == 0)
+    {
+        goto end;
     }
 
+    if (in_n_fences > sizeof(fences_vk_local) / sizeof(fences_vk_local[0]) )
+    {
+        fences_vk_heap.resize(in_n_fences);
+
+        fences_vk_ptr = &fences_vk_heap.at(0);
+    }
+
+    device_ptr = in_fence_ptrs[0]->m_device_ptr;
+
+    for (uint32_t n_fence = 0;
+                  n_fence < in_n_fences;
+                ++n_fence)
+    {
+        anvil_assert(in_fence_ptrs[n_fence]->m_device_ptr == device_ptr);
+
+        fences_vk_ptr[n_fence] = in_fence_ptrs[n_fence]->m_fence;
+    }
+
+    result_vk = device_ptr->get_dispatch_table().vkWaitForFences(device_ptr->get_device_vk(),
+                                                                 in_n_fences,
+                                                                 fences_vk_ptr,
+                                                                 (in_wait_all) ? VK_TRUE : VK_FALSE,
+                                                                 in_timeout);
+
+    anvil_assert(result_vk == VK_SUCCESS  ||
+                 result_vk == VK_TIMEOUT);
+
 end:
-    return result;
+    return (result_vk == VK_SUCCESS);
 }
@@ -24,6 +24,7 @@
 #include "misc/base_pipeline_create_info.h"
 #include "misc/base_pipeline_manager.h"
 #include "misc/debug.h"
+#include "misc/instrumentation.h"
 #include "misc/object_tracker.h"
 #include "misc/render_pass_create_info.h"
 #include "wrappers/device.h"
@@ -68,6 +69,8 @@ Anvil::GraphicsPipelineManager::~GraphicsPipelineManager()
 /* Please see header for specification */
 bool Anvil::GraphicsPipelineManager::bake()
 {
+    ANVIL_INSTRUMENTATION_SCOPE("GraphicsPipelineManager::bake");
+
     typedef struct BakeItem
     {
         PipelineID pipeline_id;
@@ -130,6 +133,9 @@ bool Anvil::GraphicsPipelineManager::bake()
         );
     }
 
+    ANVIL_INSTRUMENTATION_COUNTER("GraphicsPipelineManager::bake pipelines",
+                                  bake_items.size() );
+
     if (bake_items.size() == 0)
     {
         result = true;
@@ -421,12 +427,12 @@ bool Anvil::GraphicsPipelineManager::bake()
 
     m_pipeline_cache_ptr->lock();
     {
-        result_vk = Anvil::Vulkan::vkCreateGraphicsPipelines(m_device_ptr->get_device_vk(),
-                                                             m_pipeline_cache_ptr->get_pipeline_cache(),
-                                                             graphics_pipeline_create_info_chains.get_n_structs   (),
-                                                             graphics_pipeline_create_info_chains.get_root_structs(),
-                                                             nullptr, /* pAllocator */
-                                                            &result_graphics_pipelines[0]);
+        result_vk = m_device_ptr->get_dispatch_table().vkCreateGraphicsPipelines(m_device_ptr->get_device_vk(),
+                                                                                 m_pipeline_cache_ptr->get_pipeline_cache(),
+                                                                                 graphics_pipeline_create_info_chains.get_n_structs   (),
+                                                                                 graphics_pipeline_create_info_chains.get_root_structs(),
+                                                                                 nullptr, /* pAllocator */
+                                                                                &result_graphics_pipelines[0]);
     }
     m_pipeline_cache_ptr->unlock();
 
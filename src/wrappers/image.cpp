@@ -26,6 +26,7 @@
 #include "misc/image_create_info.h"
 #include "misc/memory_block_create_info.h"
 #include "misc/object_tracker.h"
+#include "misc/resource_state_tracker.h"
 #include "misc/struct_chainer.h"
 #include "misc/swapchain_create_info.h"
 #include "wrappers/buffer.h"
@@ -76,9 +77,9 @@ Anvil::Image::~Image()
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroyImage(m_device_ptr->get_device_vk(),
-                                          m_image,
-                                          nullptr /* pAllocator */);
+            m_device_ptr->get_dispatch_table().vkDestroyImage(m_device_ptr->get_device_vk(),
+                                                              m_image,
+                                                              nullptr /* pAllocator */);
         }
         unlock();
 
@@ -113,6 +114,25 @@ void Anvil::Image::change_image_layout(Anvil::Queue*                       in_qu
      */
     ANVIL_REDUNDANT_VARIABLE(mem_block_ptr);
 
+    if (device_type == Anvil::DeviceType::SINGLE_GPU)
+    {
+        /* The queue records the barrier into one of its prologue command buffers and updates tracked resource states
+         * once the submission has been made, so there is no need to wait for the transition to finish. */
+        in_queue_ptr->change_image_layout(this,
+                                          in_src_access_mask,
+                                          in_src_layout,
+                                          in_dst_access_mask,
+                                          in_dst_layout,
+                                          in_subresource_range,
+                                          in_opt_n_wait_semaphores,
+                                          in_opt_wait_dst_stage_mask_ptrs,
+                                          in_opt_wait_semaphore_ptrs,
+                                          in_opt_n_set_semaphores,
+                                          in_opt_set_semaphore_ptrs);
+
+        goto end;
+    }
+
     transition_command_buffer_ptr = m_device_ptr->get_command_pool_for_queue_family_index(in_queue_ptr->get_queue_family_index())->alloc_primary_level_command_buffer();
 
     transition_command_buffer_ptr->start_recording(true,   /* one_time_submit          */
@@ -142,22 +162,6 @@ void Anvil::Image::change_image_layout(Anvil::Queue*                       in_qu
     }
     transition_command_buffer_ptr->stop_recording();
 
-    if (device_type == Anvil::DeviceType::SINGLE_GPU)
-    {
-        Anvil::CommandBufferBase* cmd_buffer_ptr = transition_command_buffer_ptr.get();
-
-        in_queue_ptr->submit(
-            Anvil::SubmitInfo::create(1, /* in_n_cmd_bufers */
-                                     &cmd_buffer_ptr,
-                                      in_opt_n_set_semaphores,
-                                      in_opt_set_semaphore_ptrs,
-                                      in_opt_n_wait_semaphores,
-                                      in_opt_wait_semaphore_ptrs,
-                                      in_opt_wait_dst_stage_mask_ptrs,
-                                      true /* should_block */)
-        );
-    }
-    else
     {
         Anvil::CommandBufferMGPUSubmission cmd_buffer_submission;
         const Anvil::MGPUDevice*           mgpu_device_ptr(dynamic_cast<const Anvil::MGPUDevice*>(m_device_ptr) );
@@ -175,6 +179,13 @@ void Anvil::Image::change_image_layout(Anvil::Queue*                       in_qu
                                               true /* should_block */)
         );
     }
+
+    Anvil::ResourceStateTracker::set_image_layout(this,
+                                                  in_subresource_range,
+                                                  in_dst_layout);
+
+end:
+    ;
 }
 
 /** Please see header for specification */
@@ -439,7 +450,12 @@ Anvil::MemoryBlock* Anvil::Image::get_memory_block(const uint32_t& in_n_plane)
 
             anvil_assert(plane_memory_reqs.page_tracker_ptr != nullptr);
 
-            return plane_memory_reqs.page_tracker_ptr->get_memory_block(0);
+            const auto& bindings = plane_memory_reqs.page_tracker_ptr->get_bindings();
+
+            anvil_assert(!bindings.empty() );
+
+            return (!bindings.empty() ) ? bindings.begin()->second.memory_block_ptr
+                                        : nullptr;
         }
         else
         {
@@ -612,12 +628,12 @@ bool Anvil::Image::init()
         }
 
         {
-            auto struct_chain_ptr = struct_chainer.create_chain();
+            auto root_struct_ptr = struct_chainer.bake_chain();
 
-            result = Anvil::Vulkan::vkCreateImage(m_device_ptr->get_device_vk      (),
-                                                  struct_chain_ptr->get_root_struct(),
-                                                  nullptr, /* pAllocator */
-                                                 &m_image);
+            result = m_device_ptr->get_dispatch_table().vkCreateImage(m_device_ptr->get_device_vk      (),
+                                                                      root_struct_ptr,
+                                                                      nullptr, /* pAllocator */
+                                                                     &m_image);
         }
 
         if (!is_vk_call_successful(result) )
@@ -752,9 +768,9 @@ bool Anvil::Image::init()
 
                 anvil_assert(!is_yuv_format);
 
-                Anvil::Vulkan::vkGetImageMemoryRequirements(m_device_ptr->get_device_vk(),
-                                                            m_image,
-                                                           &memory_reqs);
+                m_device_ptr->get_dispatch_table().vkGetImageMemoryRequirements(m_device_ptr->get_device_vk(),
+                                                                                m_image,
+                                                                               &memory_reqs);
 
                 current_plane_properties.alignment    = memory_reqs.alignment;
                 current_plane_properties.memory_types = memory_reqs.memoryTypeBits;
@@ -790,10 +806,10 @@ bool Anvil::Image::init()
 
                         subresource.mip_level = n_mip;
 
-                        Anvil::Vulkan::vkGetImageSubresourceLayout(m_device_ptr->get_device_vk(),
-                                                                   m_image,
-                                                                   reinterpret_cast<const VkImageSubresource*>(&subresource),
-                                                                   reinterpret_cast<VkSubresourceLayout*>     (&subresource_layout) );
+                        m_device_ptr->get_dispatch_table().vkGetImageSubresourceLayout(m_device_ptr->get_device_vk(),
+                                                                                       m_image,
+                                                                                       reinterpret_cast<const VkImageSubresource*>(&subresource),
+                                                                                       reinterpret_cast<VkSubresourceLayout*>     (&subresource_layout) );
 
                         m_linear_image_aspect_data[static_cast<Anvil::ImageAspectFlagBits>(current_aspect.get_vk() )][LayerMipKey(n_layer, n_mip)] = subresource_layout;
                     }
@@ -852,18 +868,18 @@ bool Anvil::Image::init()
             }
             else
             {
-                Anvil::Vulkan::vkGetImageSparseMemoryRequirements(m_device_ptr->get_device_vk(),
-                                                                  m_image,
-                                                                 &n_reqs,
-                                                                  nullptr);
+                m_device_ptr->get_dispatch_table().vkGetImageSparseMemoryRequirements(m_device_ptr->get_device_vk(),
+                                                                                      m_image,
+                                                                                     &n_reqs,
+                                                                                      nullptr);
 
                 anvil_assert(n_reqs >= 1);
                 sparse_image_memory_reqs.resize(n_reqs);
 
-                Anvil::Vulkan::vkGetImageSparseMemoryRequirements(m_device_ptr->get_device_vk(),
-                                                                  m_image,
-                                                                 &n_reqs,
-                                                                  reinterpret_cast<VkSparseImageMemoryRequirements*>(&sparse_image_memory_reqs[0]) );
+                m_device_ptr->get_dispatch_table().vkGetImageSparseMemoryRequirements(m_device_ptr->get_device_vk(),
+                                                                                      m_image,
+                                                                                     &n_reqs,
+                                                                                      reinterpret_cast<VkSparseImageMemoryRequirements*>(&sparse_image_memory_reqs[0]) );
             }
 
             for (const auto& image_memory_req : sparse_image_memory_reqs)
@@ -1639,7 +1655,7 @@ void Anvil::Image::on_memory_backing_opaque_update(uint32_t            in_n_plan
 
     if (in_memory_block_ptr != nullptr)
     {
-        anvil_assert(in_memory_block_ptr->get_create_info_ptr()->get_size() <= in_memory_block_start_offset + in_size);
+        anvil_assert(in_memory_block_start_offset + in_size <= in_memory_block_ptr->get_create_info_ptr()->get_size() );
     }
 
     if ((m_create_info_ptr->get_create_flags() & Anvil::ImageCreateFlagBits::SPARSE_RESIDENCY_BIT) == 0)
@@ -1814,9 +1830,17 @@ void Anvil::Image::on_memory_backing_update(const Anvil::ImageSubresource& in_su
     anvil_assert((in_offset.x      % aspect_props_iterator->second.granularity.width)  == 0 &&
                  (in_offset.y      % aspect_props_iterator->second.granularity.height) == 0 &&
                  (in_offset.z      % aspect_props_iterator->second.granularity.depth)  == 0);
-    anvil_assert((in_extent.width  % aspect_props_iterator->second.granularity.width)  == 0 &&
-                 (in_extent.height % aspect_props_iterator->second.granularity.height) == 0 &&
-                 (in_extent.depth  % aspect_props_iterator->second.granularity.depth)  == 0);
+
+    /* Extents need not be a multiple of the granularity only if the region reaches the edge of the subresource */
+    {
+        const VkExtent3D mip_extent = get_image_extent_3D(in_subresource.mip_level);
+
+        ANVIL_REDUNDANT_VARIABLE_CONST(mip_extent);
+
+        anvil_assert(((in_extent.width  % aspect_props_iterator->second.granularity.width)  == 0 || static_cast<uint32_t>(in_offset.x) + in_extent.width  == mip_extent.width)  &&
+                     ((in_extent.height % aspect_props_iterator->second.granularity.height) == 0 || static_cast<uint32_t>(in_offset.y) + in_extent.height == mip_extent.height) &&
+                     ((in_extent.depth  % aspect_props_iterator->second.granularity.depth)  == 0 || static_cast<uint32_t>(in_offset.z) + in_extent.depth  == mip_extent.depth) );
+    }
 
     anvil_assert(aspect_page_occupancy_iterator->second->layers.size() >= in_subresource.array_layer);
     aspect_layer_ptr = &aspect_page_occupancy_iterator->second->layers.at(in_subresource.array_layer);
@@ -1824,11 +1848,12 @@ void Anvil::Image::on_memory_backing_update(const Anvil::ImageSubresource& in_su
     anvil_assert(aspect_layer_ptr->mips.size() > in_subresource.mip_level);
     aspect_layer_mip_ptr = &aspect_layer_ptr->mips.at(in_subresource.mip_level);
 
+    /* Round up, so that partial tiles at subresource edges are accounted for */
     const uint32_t extent_tile[] =
     {
-        in_extent.width  / aspect_props_iterator->second.granularity.width,
-        in_extent.height / aspect_props_iterator->second.granularity.height,
-        in_extent.depth  / aspect_props_iterator->second.granularity.depth
+        Anvil::Utils::round_up(in_extent.width,  aspect_props_iterator->second.granularity.width)  / aspect_props_iterator->second.granularity.width,
+        Anvil::Utils::round_up(in_extent.height, aspect_props_iterator->second.granularity.height) / aspect_props_iterator->second.granularity.height,
+        Anvil::Utils::round_up(in_extent.depth,  aspect_props_iterator->second.granularity.depth)  / aspect_props_iterator->second.granularity.depth
     };
     const uint32_t offset_tile[] =
     {
@@ -2204,11 +2229,11 @@ bool Anvil::Image::set_swapchain_memory_internal(uint32_t        in_swapchain_im
 
     m_create_info_ptr->get_swapchain()->lock();
     {
-        auto chain_ptr = struct_chainer.create_chain();
+        auto root_struct_ptr = struct_chainer.bake_chain();
 
         result = entrypoints.vkBindImageMemory2KHR(m_device_ptr->get_device_vk(),
                                                    1, /* bindInfoCount */
-                                                   chain_ptr->get_root_struct() );
+                                                   root_struct_ptr);
     }
     m_create_info_ptr->get_swapchain()->unlock();
 
@@ -2335,10 +2360,10 @@ void Anvil::Image::upload_mipmaps(const std::vector<MipmapRawData>* in_mipmaps_p
                 image_subresource.aspect_mask = current_aspect;
                 image_subresource.mip_level   = current_mipmap_raw_data_item_ptr->n_mipmap;
 
-                Anvil::Vulkan::vkGetImageSubresourceLayout(m_device_ptr->get_device_vk(),
-                                                           m_image,
-                                                           reinterpret_cast<const VkImageSubresource*>(&image_subresource),
-                                                           reinterpret_cast<VkSubresourceLayout*>     (&image_subresource_layout) );
+                m_device_ptr->get_dispatch_table().vkGetImageSubresourceLayout(m_device_ptr->get_device_vk(),
+                                                                               m_image,
+                                                                               reinterpret_cast<const VkImageSubresource*>(&image_subresource),
+                                                                               reinterpret_cast<VkSubresourceLayout*>     (&image_subresource_layout) );
 
                 /* Determine row size for the mipmap.
                  *
@@ -2638,4 +2663,8 @@ void Anvil::Image::upload_mipmaps(const std::vector<MipmapRawData>* in_mipmaps_p
             );
         }
     }
+
+    Anvil::ResourceStateTracker::set_image_layout(this,
+                                                  image_subresource_range,
+                                                 *out_new_image_layout_ptr);
 }
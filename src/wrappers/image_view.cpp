@@ -75,9 +75,9 @@ Anvil::ImageView::~ImageView()
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroyImageView(m_device_ptr->get_device_vk(),
-                                              m_image_view,
-                                              nullptr /* pAllocator */);
+            m_device_ptr->get_dispatch_table().vkDestroyImageView(m_device_ptr->get_device_vk(),
+                                                                  m_image_view,
+                                                                  nullptr /* pAllocator */);
         }
         unlock();
 
@@ -269,12 +269,12 @@ bool Anvil::ImageView::init()
     }
 
     {
-        auto chain_ptr = struct_chainer.create_chain();
+        auto root_struct_ptr = struct_chainer.bake_chain();
 
-        result_vk = Anvil::Vulkan::vkCreateImageView(m_device_ptr->get_device_vk(),
-                                                     chain_ptr->get_root_struct(),
-                                                     nullptr, /* pAllocator */
-                                                    &m_image_view);
+        result_vk = m_device_ptr->get_dispatch_table().vkCreateImageView(m_device_ptr->get_device_vk(),
+                                                                         root_struct_ptr,
+                                                                         nullptr, /* pAllocator */
+                                                                        &m_image_view);
     }
 
     if (!is_vk_call_successful(result_vk) )
@@ -934,7 +934,7 @@ void Anvil::Instance::init_func_pointers()
 bool Anvil::Instance::init_vk_func_ptrs()
 {
     std::lock_guard<std::mutex> lock  (g_vk_func_ptr_init_mutex);
-    bool                        result(true);
+    bool                        result(false);
 
     typedef struct
     {
@@ -1201,6 +1201,7 @@ bool Anvil::Instance::init_vk_func_ptrs()
         g_instance_func_ptrs_inited = true;
     }
 
+    result = true;
 end:
     return result;
 }
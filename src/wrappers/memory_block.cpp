@@ -21,9 +21,11 @@
 //
 
 #include "misc/debug.h"
+#include "misc/deferred_memory_flush_list.h"
 #include "misc/external_handle.h"
 #include "misc/memory_allocator.h"
 #include "misc/memory_block_create_info.h"
+#include "misc/memory_budget_tracker.h"
 #include "misc/object_tracker.h"
 #include "misc/struct_chainer.h"
 #include "wrappers/buffer.h"
@@ -31,6 +33,7 @@
 #include "wrappers/image.h"
 #include "wrappers/memory_block.h"
 #include "wrappers/physical_device.h"
+#include <algorithm>
 
 /* Please see header for specification */
 Anvil::MemoryBlock::MemoryBlock(Anvil::MemoryBlockCreateInfoUniquePtr in_create_info_ptr)
@@ -39,7 +42,10 @@ Anvil::MemoryBlock::MemoryBlock(Anvil::MemoryBlockCreateInfoUniquePtr in_create_
      m_backend_object                     (nullptr),
      m_gpu_data_map_count                 (0),
      m_gpu_data_ptr                       (nullptr),
+     m_mapping_mode                       (Anvil::MemoryBlockMappingMode::ON_DEMAND),
+     m_is_budget_tracked                  (false),
      m_memory                             (VK_NULL_HANDLE),
+     m_root_memory_block_ptr              (nullptr),
      m_parent_memory_allocator_backend_ptr(nullptr)
 {
     m_create_info_ptr = std::move(in_create_info_ptr);
@@ -63,6 +69,13 @@ Anvil::MemoryBlock::~MemoryBlock()
 {
     auto on_release_callback_function = m_create_info_ptr->get_on_release_callback_function();
 
+    /* Flush any deferred writes and drop the persistent mapping, if one is held. */
+    if (m_create_info_ptr->get_parent_memory_block() == nullptr            &&
+        m_mapping_mode                               != Anvil::MemoryBlockMappingMode::ON_DEMAND)
+    {
+        set_mapping_mode(Anvil::MemoryBlockMappingMode::ON_DEMAND);
+    }
+
     #ifdef _DEBUG
     {
         auto parent_memory_block_ptr = m_create_info_ptr->get_parent_memory_block();
@@ -89,15 +102,102 @@ Anvil::MemoryBlock::~MemoryBlock()
         {
             lock();
             {
-                Anvil::Vulkan::vkFreeMemory(m_create_info_ptr->get_device()->get_device_vk(),
-                                            m_memory,
-                                            nullptr /* pAllocator */);
+                m_create_info_ptr->get_device()->get_dispatch_table().vkFreeMemory(m_create_info_ptr->get_device()->get_device_vk(),
+                                                                                   m_memory,
+                                                                                   nullptr /* pAllocator */);
             }
             unlock();
         }
 
         m_memory = VK_NULL_HANDLE;
     }
+
+    if (m_is_budget_tracked)
+    {
+        auto budget_tracker_ptr = m_create_info_ptr->get_device()->get_memory_budget_tracker();
+
+        if (budget_tracker_ptr != nullptr)
+        {
+            budget_tracker_ptr->on_memory_block_released(this);
+        }
+    }
+
+    if (m_root_memory_block_ptr != nullptr)
+    {
+        m_root_memory_block_ptr->unregister_derived_memory_block(this);
+    }
+
+    /* Derived memory blocks may outlive the root block (eg. dedicated allocations made by one-shot allocator backend),
+     * so make sure they do not try to unregister themselves from an object which is gone. */
+    lock();
+    {
+        for (auto derived_memory_block_ptr : m_derived_memory_blocks)
+        {
+            derived_memory_block_ptr->m_root_memory_block_ptr = nullptr;
+        }
+
+        m_derived_memory_blocks.clear();
+    }
+    unlock();
+
+    if (m_owned_parent_memory_allocator_backend_ptr != nullptr)
+    {
+        m_owned_parent_memory_allocator_backend_ptr->on_memory_block_released(this);
+    }
+}
+
+/** Records a modified range of a root memory block, whose flush has been deferred. The range is merged with the most recently
+ *  recorded one if the two overlap or are adjacent, which is the common case for sequential writes.
+ *
+ *  If this is the first range recorded since the last flush, the memory block is added to the device-wide deferred memory
+ *  flush list.
+ *
+ *  @param in_start_offset Start offset of the range, relative to the beginning of the memory allocation. Must be aligned
+ *                         to nonCoherentAtomSize.
+ *  @param in_size         Size of the range. Must be a multiple of nonCoherentAtomSize, or reach the end of the allocation.
+ **/
+void Anvil::MemoryBlock::add_pending_flush_range(VkDeviceSize in_start_offset,
+                                                 VkDeviceSize in_size)
+{
+    const VkDeviceSize end_offset             = in_start_offset + in_size;
+    bool               is_first_pending_range = false;
+
+    anvil_assert(m_create_info_ptr->get_parent_memory_block() == nullptr);
+
+    lock();
+    {
+        is_first_pending_range = m_pending_flush_ranges.empty();
+
+        if (!is_first_pending_range                              &&
+            m_pending_flush_ranges.back().first  <= end_offset   &&
+            m_pending_flush_ranges.back().second >= in_start_offset)
+        {
+            auto& last_range = m_pending_flush_ranges.back();
+
+            last_range.first  = std::min(last_range.first,
+                                         in_start_offset);
+            last_range.second = std::max(last_range.second,
+                                         end_offset);
+        }
+        else
+        {
+            m_pending_flush_ranges.push_back(
+                std::make_pair(in_start_offset,
+                               end_offset)
+            );
+        }
+    }
+    unlock();
+
+    if (is_first_pending_range)
+    {
+        auto flush_list_ptr = m_create_info_ptr->get_device()->get_deferred_memory_flush_list();
+
+        if (flush_list_ptr != nullptr)
+        {
+            flush_list_ptr->on_memory_block_dirtied(this);
+        }
+    }
 }
 
 /** Finishes the memory mapping process, opened earlier with a open_gpu_memory_access() call. */
@@ -124,8 +224,8 @@ void Anvil::MemoryBlock::close_gpu_memory_access()
                 else
                 {
                     /* This block will be entered for memory blocks instantiated without a memory allocator */
-                    Anvil::Vulkan::vkUnmapMemory(m_create_info_ptr->get_device()->get_device_vk(),
-                                                 m_memory);
+                    m_create_info_ptr->get_device()->get_dispatch_table().vkUnmapMemory(m_create_info_ptr->get_device()->get_device_vk(),
+                                                                                        m_memory);
                 }
             }
             unlock();
@@ -167,6 +267,17 @@ Anvil::MemoryBlockUniquePtr Anvil::MemoryBlock::create(Anvil::MemoryBlockCreateI
             {
                 result_ptr->m_memory = result_ptr->m_create_info_ptr->get_memory();
             }
+            else
+            {
+                auto root_memory_block_ptr = result_ptr->m_create_info_ptr->get_parent_memory_block();
+
+                while (root_memory_block_ptr->get_create_info_ptr()->get_parent_memory_block() != nullptr)
+                {
+                    root_memory_block_ptr = root_memory_block_ptr->get_create_info_ptr()->get_parent_memory_block();
+                }
+
+                root_memory_block_ptr->register_derived_memory_block(result_ptr.get() );
+            }
 
             if (out_opt_result_ptr != nullptr)
             {
@@ -175,6 +286,22 @@ Anvil::MemoryBlockUniquePtr Anvil::MemoryBlock::create(Anvil::MemoryBlockCreateI
         }
     }
 
+    /* Derived blocks refer to memory which has already been accounted for by their parent block, so only
+     * report blocks which own a Vulkan memory allocation, or a sub-allocation of one (VMA backend).
+     */
+    if (result_ptr != nullptr                        &&
+        type       != Anvil::MemoryBlockType::DERIVED)
+    {
+        auto budget_tracker_ptr = result_ptr->m_create_info_ptr->get_device()->get_memory_budget_tracker();
+
+        if (budget_tracker_ptr != nullptr)
+        {
+            budget_tracker_ptr->on_memory_block_allocated(result_ptr.get() );
+
+            result_ptr->m_is_budget_tracked = true;
+        }
+    }
+
     return result_ptr;
 }
 
@@ -314,6 +441,28 @@ end:
     return result_returned_ptr;
 }
 
+/* Please see header for specification */
+bool Anvil::MemoryBlock::flush_pending_writes()
+{
+    std::vector<VkMappedMemoryRange> ranges_vk;
+    bool                             result = true;
+
+    get_root_memory_block()->pop_pending_flush_ranges(&ranges_vk);
+
+    if (ranges_vk.size() > 0)
+    {
+        const VkResult result_vk = m_create_info_ptr->get_device()->get_dispatch_table().vkFlushMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
+                                                                                                                   static_cast<uint32_t>(ranges_vk.size() ),
+                                                                                                                   ranges_vk.data() );
+
+        anvil_assert_vk_call_succeeded(result_vk);
+
+        result = is_vk_call_successful(result_vk);
+    }
+
+    return result;
+}
+
 /** Returns index of a memory type which meets the specified requirements
  *
  *  NOTE: @param coherent_memory_required may only be true if @param mappable_memory_required is also true.
@@ -355,6 +504,101 @@ end:
     return result;
 }
 
+/** Returns the memory block which owns the memory allocation this memory block belongs to. For root memory blocks,
+ *  this is the memory block itself.
+ **/
+const Anvil::MemoryBlock* Anvil::MemoryBlock::get_root_memory_block() const
+{
+    const MemoryBlock* result_ptr = this;
+
+    while (result_ptr->m_create_info_ptr->get_parent_memory_block() != nullptr)
+    {
+        result_ptr = result_ptr->m_create_info_ptr->get_parent_memory_block();
+    }
+
+    return result_ptr;
+}
+
+/** Please see the const version of the function for specification */
+Anvil::MemoryBlock* Anvil::MemoryBlock::get_root_memory_block()
+{
+    return const_cast<MemoryBlock*>(static_cast<const MemoryBlock*>(this)->get_root_memory_block() );
+}
+
+/* Please see header for specification */
+Anvil::MemoryBlock::Statistics Anvil::MemoryBlock::get_statistics() const
+{
+    std::vector<std::pair<VkDeviceSize, VkDeviceSize> > derived_ranges;
+    Statistics                                          result;
+    const MemoryBlock*                                  root_memory_block_ptr = (m_create_info_ptr->get_parent_memory_block() != nullptr) ? m_root_memory_block_ptr
+                                                                                                                                          : this;
+    VkDeviceSize                                        scan_offset           = 0;
+
+    if (root_memory_block_ptr == nullptr)
+    {
+        goto end;
+    }
+
+    root_memory_block_ptr->lock();
+    {
+        derived_ranges.reserve(root_memory_block_ptr->m_derived_memory_blocks.size() );
+
+        for (const auto derived_memory_block_ptr : root_memory_block_ptr->m_derived_memory_blocks)
+        {
+            const VkDeviceSize start_offset = derived_memory_block_ptr->m_start_offset - root_memory_block_ptr->m_start_offset;
+
+            derived_ranges.push_back(
+                std::make_pair(start_offset,
+                               start_offset + derived_memory_block_ptr->m_create_info_ptr->get_size() )
+            );
+        }
+    }
+    root_memory_block_ptr->unlock();
+
+    result.n_derived_blocks = static_cast<uint32_t>(derived_ranges.size() );
+    result.reserved_size    = root_memory_block_ptr->m_create_info_ptr->get_size();
+
+    if (derived_ranges.size() == 0)
+    {
+        result.used_size = result.reserved_size;
+
+        goto end;
+    }
+
+    /* Derived blocks are allowed to alias, so merge the ranges before looking for gaps in between */
+    std::sort(derived_ranges.begin(),
+              derived_ranges.end  () );
+
+    for (const auto& current_range : derived_ranges)
+    {
+        if (current_range.first > scan_offset)
+        {
+            const VkDeviceSize free_range_size = current_range.first - scan_offset;
+
+            result.largest_free_range_size = std::max(result.largest_free_range_size,
+                                                      free_range_size);
+            result.n_free_ranges          ++;
+        }
+
+        if (current_range.second > scan_offset)
+        {
+            result.used_size += current_range.second - std::max(scan_offset,
+                                                                current_range.first);
+            scan_offset       = current_range.second;
+        }
+    }
+
+    if (result.reserved_size > scan_offset)
+    {
+        result.largest_free_range_size = std::max(result.largest_free_range_size,
+                                                  result.reserved_size - scan_offset);
+        result.n_free_ranges          ++;
+    }
+
+end:
+    return result;
+}
+
 /* Allocates actual memory and caches a number of properties used to spawn the memory block */
 bool Anvil::MemoryBlock::init(VkResult* out_opt_result)
 {
@@ -537,12 +781,12 @@ bool Anvil::MemoryBlock::init(VkResult* out_opt_result)
     }
 
     {
-        auto chain_ptr = struct_chainer.create_chain();
+        auto root_struct_ptr = struct_chainer.bake_chain();
 
-        result = Anvil::Vulkan::vkAllocateMemory(m_create_info_ptr->get_device()->get_device_vk(),
-                                                 chain_ptr->get_root_struct(),
-                                                 nullptr, /* pAllocator */
-                                                &m_memory);
+        result = m_create_info_ptr->get_device()->get_dispatch_table().vkAllocateMemory(m_create_info_ptr->get_device()->get_device_vk(),
+                                                                                        root_struct_ptr,
+                                                                                        nullptr, /* pAllocator */
+                                                                                       &m_memory);
     }
 
     if (out_opt_result != nullptr)
@@ -612,6 +856,12 @@ bool Anvil::MemoryBlock::map(VkDeviceSize in_start_offset,
 
         if ((memory_features & Anvil::MemoryFeatureFlagBits::HOST_COHERENT_BIT) == 0)
         {
+            /* Invalidating a range discards host writes which have not been flushed yet, so flush deferred writes first */
+            if (m_mapping_mode == Anvil::MemoryBlockMappingMode::PERSISTENT_WITH_DEFERRED_FLUSHES)
+            {
+                flush_pending_writes();
+            }
+
             /* Make sure the mapped region is invalidated before letting the user read from it */
             VkMappedMemoryRange mapped_memory_range;
             const auto          non_coherent_atom_size(m_create_info_ptr->get_device()->get_physical_device_properties().core_vk1_0_properties_ptr->limits.non_coherent_atom_size);
@@ -632,9 +882,9 @@ bool Anvil::MemoryBlock::map(VkDeviceSize in_start_offset,
                 mapped_memory_range.size = VK_WHOLE_SIZE;
             }
 
-            result_vk = Anvil::Vulkan::vkInvalidateMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
-                                                                      1, /* memRangeCount */
-                                                                     &mapped_memory_range);
+            result_vk = m_create_info_ptr->get_device()->get_dispatch_table().vkInvalidateMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
+                                                                                                             1, /* memRangeCount */
+                                                                                                            &mapped_memory_range);
             anvil_assert_vk_call_succeeded(result_vk);
         }
 
@@ -701,12 +951,12 @@ bool Anvil::MemoryBlock::open_gpu_memory_access()
                  *       less readable. Might want to consider doing this nevertheless one day.
                  *
                  */
-                result_vk = Anvil::Vulkan::vkMapMemory(m_create_info_ptr->get_device()->get_device_vk(),
-                                                       m_memory,
-                                                       0, /* offset */
-                                                       m_create_info_ptr->get_size(),
-                                                       0, /* flags */
-                                                       static_cast<void**>(&m_gpu_data_ptr) );
+                result_vk = m_create_info_ptr->get_device()->get_dispatch_table().vkMapMemory(m_create_info_ptr->get_device()->get_device_vk(),
+                                                                                              m_memory,
+                                                                                              0, /* offset */
+                                                                                              m_create_info_ptr->get_size(),
+                                                                                              0, /* flags */
+                                                                                              static_cast<void**>(&m_gpu_data_ptr) );
             }
         }
         unlock();
@@ -723,6 +973,57 @@ end:
     return result;
 }
 
+/** Moves all pending flush ranges of a root memory block to @param out_ranges_ptr, after sorting them & merging
+ *  those which overlap or are adjacent.
+ *
+ *  @param out_ranges_ptr Vector to append the ranges to. Must not be nullptr.
+ **/
+void Anvil::MemoryBlock::pop_pending_flush_ranges(std::vector<VkMappedMemoryRange>* out_ranges_ptr)
+{
+    anvil_assert(m_create_info_ptr->get_parent_memory_block() == nullptr);
+
+    lock();
+    {
+        if (m_pending_flush_ranges.size() > 0)
+        {
+            VkMappedMemoryRange current_range;
+            VkDeviceSize        current_range_end;
+
+            std::sort(m_pending_flush_ranges.begin(),
+                      m_pending_flush_ranges.end  () );
+
+            current_range.memory = m_memory;
+            current_range.offset = m_pending_flush_ranges.front().first;
+            current_range.pNext  = nullptr;
+            current_range.size   = 0;
+            current_range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            current_range_end    = m_pending_flush_ranges.front().second;
+
+            for (const auto& pending_range : m_pending_flush_ranges)
+            {
+                if (pending_range.first > current_range_end)
+                {
+                    current_range.size = current_range_end - current_range.offset;
+
+                    out_ranges_ptr->push_back(current_range);
+
+                    current_range.offset = pending_range.first;
+                }
+
+                current_range_end = std::max(current_range_end,
+                                             pending_range.second);
+            }
+
+            current_range.size = current_range_end - current_range.offset;
+
+            out_ranges_ptr->push_back(current_range);
+
+            m_pending_flush_ranges.clear();
+        }
+    }
+    unlock();
+}
+
 /* Please see header for specification */
 bool Anvil::MemoryBlock::read(VkDeviceSize in_start_offset,
                               VkDeviceSize in_size,
@@ -759,6 +1060,12 @@ bool Anvil::MemoryBlock::read(VkDeviceSize in_start_offset,
             anvil_assert            (m_start_offset == 0);
             ANVIL_REDUNDANT_VARIABLE(result_vk);
 
+            /* Invalidating a range discards host writes which have not been flushed yet, so flush deferred writes first */
+            if (m_mapping_mode == Anvil::MemoryBlockMappingMode::PERSISTENT_WITH_DEFERRED_FLUSHES)
+            {
+                flush_pending_writes();
+            }
+
             mapped_memory_range.memory = m_memory;
             mapped_memory_range.offset = Anvil::Utils::round_down(in_start_offset,
                                                                   non_coherent_atom_size);
@@ -772,9 +1079,9 @@ bool Anvil::MemoryBlock::read(VkDeviceSize in_start_offset,
                 mapped_memory_range.size = mem_block_size - mapped_memory_range.offset;
             }
 
-            result_vk = Anvil::Vulkan::vkInvalidateMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
-                                                                      1, /* memRangeCount */
-                                                                     &mapped_memory_range);
+            result_vk = m_create_info_ptr->get_device()->get_dispatch_table().vkInvalidateMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
+                                                                                                             1, /* memRangeCount */
+                                                                                                            &mapped_memory_range);
             anvil_assert_vk_call_succeeded(result_vk);
         }
 
@@ -791,6 +1098,72 @@ end:
     return result;
 }
 
+/** Adds @param in_memory_block_ptr to the set of alive memory blocks derived from this root memory block. */
+void Anvil::MemoryBlock::register_derived_memory_block(MemoryBlock* in_memory_block_ptr)
+{
+    anvil_assert(m_create_info_ptr->get_parent_memory_block() == nullptr);
+
+    lock();
+    {
+        m_derived_memory_blocks.insert(in_memory_block_ptr);
+    }
+    unlock();
+
+    in_memory_block_ptr->m_root_memory_block_ptr = this;
+}
+
+/* Please see header for specification */
+bool Anvil::MemoryBlock::set_mapping_mode(Anvil::MemoryBlockMappingMode in_mapping_mode)
+{
+    bool result = false;
+
+    if (m_create_info_ptr->get_parent_memory_block() != nullptr)
+    {
+        result = get_root_memory_block()->set_mapping_mode(in_mapping_mode);
+
+        goto end;
+    }
+
+    if (in_mapping_mode == m_mapping_mode)
+    {
+        result = true;
+
+        goto end;
+    }
+
+    if (m_mapping_mode == Anvil::MemoryBlockMappingMode::PERSISTENT_WITH_DEFERRED_FLUSHES)
+    {
+        auto flush_list_ptr = m_create_info_ptr->get_device()->get_deferred_memory_flush_list();
+
+        flush_pending_writes();
+
+        if (flush_list_ptr != nullptr)
+        {
+            flush_list_ptr->on_memory_block_released(this);
+        }
+    }
+
+    if (m_mapping_mode == Anvil::MemoryBlockMappingMode::ON_DEMAND)
+    {
+        /* Hold an extra mapping reference for as long as the block stays in one of the persistent modes */
+        if (!open_gpu_memory_access() )
+        {
+            goto end;
+        }
+    }
+    else
+    if (in_mapping_mode == Anvil::MemoryBlockMappingMode::ON_DEMAND)
+    {
+        close_gpu_memory_access();
+    }
+
+    m_mapping_mode = in_mapping_mode;
+    result         = true;
+
+end:
+    return result;
+}
+
 /* Please see header for specification */
 bool Anvil::MemoryBlock::unmap()
 {
@@ -820,6 +1193,16 @@ end:
     return result;
 }
 
+/** Removes @param in_memory_block_ptr from the set of alive memory blocks derived from this root memory block. */
+void Anvil::MemoryBlock::unregister_derived_memory_block(MemoryBlock* in_memory_block_ptr)
+{
+    lock();
+    {
+        m_derived_memory_blocks.erase(in_memory_block_ptr);
+    }
+    unlock();
+}
+
 /* Please see header for specification */
 bool Anvil::MemoryBlock::write(VkDeviceSize in_start_offset,
                                VkDeviceSize in_size,
@@ -870,10 +1253,22 @@ bool Anvil::MemoryBlock::write(VkDeviceSize in_start_offset,
                 mapped_memory_range.size = mem_block_size - mapped_memory_range.offset;
             }
 
-            result_vk = Anvil::Vulkan::vkFlushMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
-                                                                 1, /* memRangeCount */
-                                                                &mapped_memory_range);
-            anvil_assert_vk_call_succeeded(result_vk);
+            if (m_mapping_mode == Anvil::MemoryBlockMappingMode::PERSISTENT_WITH_DEFERRED_FLUSHES)
+            {
+                const VkDeviceSize end_offset = std::min(Anvil::Utils::round_up(in_start_offset + in_size,
+                                                                                non_coherent_atom_size),
+                                                         mem_block_size);
+
+                add_pending_flush_range(mapped_memory_range.offset,
+                                        end_offset - mapped_memory_range.offset);
+            }
+            else
+            {
+                result_vk = m_create_info_ptr->get_device()->get_dispatch_table().vkFlushMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
+                                                                                                            1, /* memRangeCount */
+                                                                                                           &mapped_memory_range);
+                anvil_assert_vk_call_succeeded(result_vk);
+            }
         }
 
         close_gpu_memory_access();
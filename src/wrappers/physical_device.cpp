@@ -151,6 +151,7 @@ bool Anvil::PhysicalDevice::init()
             Anvil::StructID                                           storage_features8_struct_id                 = UINT32_MAX;
             Anvil::StructChainUniquePtr<VkPhysicalDeviceFeatures2KHR> struct_chain_ptr;
             Anvil::StructChainer<VkPhysicalDeviceFeatures2KHR>        struct_chainer;
+            Anvil::StructID                                           timeline_semaphore_features_struct_id       = UINT32_MAX;
             Anvil::StructID                                           transform_feedback_features_struct_id       = UINT32_MAX;
             Anvil::StructID                                           variable_pointer_features_struct_id         = UINT32_MAX;
             Anvil::StructID                                           vulkan_memory_model_features_struct_id      = UINT32_MAX;
@@ -288,6 +289,16 @@ bool Anvil::PhysicalDevice::init()
                 shader_float16_int8_struct_id = struct_chainer.append_struct(shader_float16_int8_features);
             }
 
+            if (m_extension_info_ptr->get_device_extension_info()->khr_timeline_semaphore() )
+            {
+                VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore_features;
+
+                timeline_semaphore_features.pNext = nullptr;
+                timeline_semaphore_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+
+                timeline_semaphore_features_struct_id = struct_chainer.append_struct(timeline_semaphore_features);
+            }
+
             if (m_extension_info_ptr->get_device_extension_info()->khr_variable_pointers() ||
                 supports_vk1_1)
             {
@@ -432,6 +443,21 @@ bool Anvil::PhysicalDevice::init()
                 }
             }
 
+            if (timeline_semaphore_features_struct_id != UINT32_MAX)
+            {
+                m_khr_timeline_semaphore_features_ptr.reset(
+                    new KHRTimelineSemaphoreFeatures(*struct_chain_ptr->get_struct_with_id<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(timeline_semaphore_features_struct_id) )
+                );
+
+                if (m_khr_timeline_semaphore_features_ptr == nullptr)
+                {
+                    anvil_assert(m_khr_timeline_semaphore_features_ptr != nullptr);
+
+                    result = false;
+                    goto end;
+                }
+            }
+
             if (transform_feedback_features_struct_id != UINT32_MAX)
             {
                 m_ext_transform_feedback_features_ptr.reset(
@@ -581,6 +607,7 @@ bool Anvil::PhysicalDevice::init()
                                                    m_khr_multiview_features_ptr.get               (),
                                                    m_khr_sampler_ycbcr_conversion_features_ptr.get(),
                                                    m_khr_shader_atomic_int64_features_ptr.get     (),
+                                                   m_khr_timeline_semaphore_features_ptr.get      (),
                                                    m_khr_variable_pointer_features_ptr.get        (),
                                                    m_khr_vulkan_memory_model_features_ptr.get     () );
     }
@@ -48,10 +48,10 @@ Anvil::PipelineCache::PipelineCache(const Anvil::BaseDevice* in_device_ptr,
     cache_create_info.pNext           = nullptr;
     cache_create_info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 
-    result_vk = Anvil::Vulkan::vkCreatePipelineCache(m_device_ptr->get_device_vk(),
-                                                    &cache_create_info,
-                                                     nullptr, /* pAllocator */
-                                                    &m_pipeline_cache);
+    result_vk = m_device_ptr->get_dispatch_table().vkCreatePipelineCache(m_device_ptr->get_device_vk(),
+                                                                        &cache_create_info,
+                                                                         nullptr, /* pAllocator */
+                                                                        &m_pipeline_cache);
 
     anvil_assert_vk_call_succeeded(result_vk);
     if (is_vk_call_successful(result_vk) )
@@ -77,9 +77,9 @@ Anvil::PipelineCache::~PipelineCache()
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroyPipelineCache(m_device_ptr->get_device_vk(),
-                                                  m_pipeline_cache,
-                                                  nullptr /* pAllocator */);
+            m_device_ptr->get_dispatch_table().vkDestroyPipelineCache(m_device_ptr->get_device_vk(),
+                                                                      m_pipeline_cache,
+                                                                      nullptr /* pAllocator */);
         }
         unlock();
 
@@ -112,10 +112,10 @@ bool Anvil::PipelineCache::get_data(size_t* out_n_data_bytes_ptr,
 {
     VkResult result_vk;
 
-    result_vk = Anvil::Vulkan::vkGetPipelineCacheData(m_device_ptr->get_device_vk(),
-                                                      m_pipeline_cache,
-                                                      out_n_data_bytes_ptr,
-                                                      out_data_ptr);
+    result_vk = m_device_ptr->get_dispatch_table().vkGetPipelineCacheData(m_device_ptr->get_device_vk(),
+                                                                          m_pipeline_cache,
+                                                                          out_n_data_bytes_ptr,
+                                                                          out_data_ptr);
 
     return is_vk_call_successful(result_vk);
 }
@@ -139,10 +139,10 @@ bool Anvil::PipelineCache::merge(uint32_t                           in_n_pipelin
 
     lock();
     {
-        result_vk = Anvil::Vulkan::vkMergePipelineCaches(m_device_ptr->get_device_vk(),
-                                                         m_pipeline_cache,
-                                                         in_n_pipeline_caches,
-                                                        &src_pipeline_caches.at(0) );
+        result_vk = m_device_ptr->get_dispatch_table().vkMergePipelineCaches(m_device_ptr->get_device_vk(),
+                                                                             m_pipeline_cache,
+                                                                             in_n_pipeline_caches,
+                                                                            &src_pipeline_caches.at(0) );
     }
     unlock();
 
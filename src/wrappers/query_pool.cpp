@@ -86,9 +86,9 @@ Anvil::QueryPool::~QueryPool()
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroyQueryPool(m_device_ptr->get_device_vk(),
-                                              m_query_pool_vk,
-                                              nullptr /* pAllocator */);
+            m_device_ptr->get_dispatch_table().vkDestroyQueryPool(m_device_ptr->get_device_vk(),
+                                                                  m_query_pool_vk,
+                                                                  nullptr /* pAllocator */);
         }
         unlock();
 
@@ -192,14 +192,14 @@ bool Anvil::QueryPool::get_query_pool_results_internal(const uint32_t&
     }
 
     /* Execute the request */
-    result_vk = Anvil::Vulkan::vkGetQueryPoolResults(m_device_ptr->get_device_vk(),
-                                                     m_query_pool_vk,
-                                                     in_first_query_index,
-                                                     in_n_queries,
-                                                     result_query_size * in_n_queries,
-                                                     out_results_ptr,
-                                                     (in_should_return_uint64) ? sizeof(uint64_t) : sizeof(uint32_t),
-                                                     flags);
+    result_vk = m_device_ptr->get_dispatch_table().vkGetQueryPoolResults(m_device_ptr->get_device_vk(),
+                                                                         m_query_pool_vk,
+                                                                         in_first_query_index,
+                                                                         in_n_queries,
+                                                                         result_query_size * in_n_queries,
+                                                                         out_results_ptr,
+                                                                         (in_should_return_uint64) ? sizeof(uint64_t) : sizeof(uint32_t),
+                                                                         flags);
 
     if ((in_query_props & Anvil::QueryResultFlagBits::PARTIAL_BIT) != 0)
     {
@@ -235,10 +235,10 @@ void Anvil::QueryPool::init(VkQueryType                        in_query_type,
     create_info.queryType          = in_query_type;
     create_info.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
 
-    result_vk = Anvil::Vulkan::vkCreateQueryPool(m_device_ptr->get_device_vk(),
-                                                &create_info,
-                                                 nullptr, /* pAllocator */
-                                                &m_query_pool_vk);
+    result_vk = m_device_ptr->get_dispatch_table().vkCreateQueryPool(m_device_ptr->get_device_vk(),
+                                                                    &create_info,
+                                                                     nullptr, /* pAllocator */
+                                                                    &m_query_pool_vk);
 
     anvil_assert_vk_call_succeeded(result_vk);
     if (is_vk_call_successful(result_vk) )
@@ -21,13 +21,19 @@
 //
 
 #include "misc/debug.h"
-#include "misc/fence_create_info.h"
+#include "misc/deferred_memory_flush_list.h"
+#include "misc/fence_pool.h"
+#include "misc/instrumentation.h"
 #include "misc/object_tracker.h"
+#include "misc/resource_state_tracker.h"
+#include "misc/semaphore_create_info.h"
 #include "misc/struct_chainer.h"
+#include "misc/submission_batch.h"
 #include "misc/swapchain_create_info.h"
 #include "misc/window.h"
 #include "wrappers/buffer.h"
 #include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
 #include "wrappers/device.h"
 #include "wrappers/fence.h"
 #include "wrappers/instance.h"
@@ -37,7 +43,8 @@
 #include "wrappers/semaphore.h"
 #include "wrappers/swapchain.h"
 
-#define MAX_SWAPCHAINS (32)
+#define MAX_SWAPCHAINS                     (32)
+#define MAX_UNTRACKED_PROLOGUE_SUBMISSIONS (8)
 
 
 /** Please see header for specification */
@@ -56,13 +63,15 @@ Anvil::Queue::Queue(const Anvil::BaseDevice*          in_device_ptr,
      m_queue                        (VK_NULL_HANDLE),
      m_queue_family_index           (in_queue_family_index),
      m_queue_global_priority        (in_global_priority),
-     m_queue_index                  (in_queue_index)
+     m_queue_index                  (in_queue_index),
+     m_last_submission_id           (0),
+     m_are_resource_states_locked   (false)
 {
     /* Retrieve the Vulkan handle */
-    Anvil::Vulkan::vkGetDeviceQueue(m_device_ptr->get_device_vk(),
-                                    in_queue_family_index,
-                                    in_queue_index,
-                                   &m_queue);
+    m_device_ptr->get_dispatch_table().vkGetDeviceQueue(m_device_ptr->get_device_vk(),
+                                                        in_queue_family_index,
+                                                        in_queue_index,
+                                                       &m_queue);
 
     anvil_assert(m_queue != VK_NULL_HANDLE);
 
@@ -70,14 +79,21 @@ Anvil::Queue::Queue(const Anvil::BaseDevice*          in_device_ptr,
     m_supports_protected_memory_operations = (m_device_ptr->get_queue_family_info(in_queue_family_index)->flags & Anvil::QueueFlagBits::PROTECTED_BIT)      != 0;
     m_supports_sparse_bindings             = (m_device_ptr->get_queue_family_info(in_queue_family_index)->flags & Anvil::QueueFlagBits::SPARSE_BINDING_BIT) != 0;
 
-    /* Cache a fence that may be optionally used for submissions */
+    /* If supported, create a timeline semaphore which is going to be signalled with submission IDs */
     {
-        auto create_info_ptr = Anvil::FenceCreateInfo::create(m_device_ptr,
-                                                              false); /* create_signalled */
+        const auto timeline_semaphore_features_ptr = m_device_ptr->get_physical_device_features().khr_timeline_semaphore_features_ptr;
 
-        create_info_ptr->set_mt_safety(Anvil::Utils::convert_boolean_to_mt_safety_enum(is_mt_safe()) );
+        if (m_device_ptr->get_extension_info()->khr_timeline_semaphore()            &&
+            timeline_semaphore_features_ptr                              != nullptr &&
+            timeline_semaphore_features_ptr->timeline_semaphore)
+        {
+            auto create_info_ptr = Anvil::SemaphoreCreateInfo::create(m_device_ptr);
+
+            create_info_ptr->set_mt_safety     (Anvil::Utils::convert_boolean_to_mt_safety_enum(is_mt_safe()) );
+            create_info_ptr->set_semaphore_type(Anvil::SemaphoreType::TIMELINE_KHR);
 
-        m_submit_fence_ptr = Anvil::Fence::create(std::move(create_info_ptr) );
+            m_submission_semaphore_ptr = Anvil::Semaphore::create(std::move(create_info_ptr) );
+        }
     }
 
     /* OK, register the wrapper instance and leave */
@@ -164,10 +180,10 @@ bool Anvil::Queue::bind_sparse_memory(Anvil::SparseMemoryBindingUpdateInfo& in_u
                                        true); /* in_should_lock */
     }
     {
-        result = Anvil::Vulkan::vkQueueBindSparse(m_queue,
-                                                  n_bind_info_items,
-                                                  bind_info_items,
-                                                  (fence_ptr != nullptr) ? fence_ptr->get_fence() : VK_NULL_HANDLE);
+        result = m_device_ptr->get_dispatch_table().vkQueueBindSparse(m_queue,
+                                                                      n_bind_info_items,
+                                                                      bind_info_items,
+                                                                      (fence_ptr != nullptr) ? fence_ptr->get_fence() : VK_NULL_HANDLE);
     }
     if (mt_safe)
     {
@@ -177,6 +193,12 @@ bool Anvil::Queue::bind_sparse_memory(Anvil::SparseMemoryBindingUpdateInfo& in_u
 
     anvil_assert(result == VK_SUCCESS);
 
+    if (result    == VK_SUCCESS &&
+        fence_ptr != nullptr)
+    {
+        fence_ptr->m_has_been_submitted = true;
+    }
+
     for (uint32_t n_bind_info = 0;
                   n_bind_info < n_bind_info_items;
                 ++n_bind_info)
@@ -452,6 +474,47 @@ void Anvil::Queue::bind_sparse_memory_lock_unlock(Anvil::SparseMemoryBindingUpda
     }
 }
 
+/** Transitions a range of image subresources from one layout to another without blocking. Implements
+ *  Image::change_image_layout() for single-GPU devices. Please see its documentation for more details.
+ *
+ *  The layout change is resolved like a requirement of a tracked command buffer, so the barrier is recorded into
+ *  a prologue command buffer, and global resource states are only updated once the submission has been made.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::Queue::change_image_layout(Anvil::Image*                       in_image_ptr,
+                                       Anvil::AccessFlags                  in_src_access_mask,
+                                       Anvil::ImageLayout                  in_src_layout,
+                                       Anvil::AccessFlags                  in_dst_access_mask,
+                                       Anvil::ImageLayout                  in_dst_layout,
+                                       const Anvil::ImageSubresourceRange& in_subresource_range,
+                                       uint32_t                            in_n_wait_semaphores,
+                                       const Anvil::PipelineStageFlags*    in_opt_wait_dst_stage_masks_ptr,
+                                       Anvil::Semaphore* const*            in_opt_wait_semaphore_ptrs,
+                                       uint32_t                            in_n_signal_semaphores,
+                                       Anvil::Semaphore* const*            in_opt_signal_semaphore_ptrs)
+{
+    ImageLayoutChange layout_change;
+
+    layout_change.dst_access_mask   = in_dst_access_mask;
+    layout_change.dst_layout        = in_dst_layout;
+    layout_change.image_ptr         = in_image_ptr;
+    layout_change.src_access_mask   = in_src_access_mask;
+    layout_change.src_layout        = in_src_layout;
+    layout_change.subresource_range = in_subresource_range;
+
+    return submit_internal(Anvil::SubmitInfo::create(0,       /* in_n_cmd_buffers */
+                                                     nullptr, /* in_opt_cmd_buffer_ptrs_ptr */
+                                                     in_n_signal_semaphores,
+                                                     in_opt_signal_semaphore_ptrs,
+                                                     in_n_wait_semaphores,
+                                                     in_opt_wait_semaphore_ptrs,
+                                                     in_opt_wait_dst_stage_masks_ptr,
+                                                     false), /* in_should_block */
+                           nullptr, /* out_opt_submission_id_ptr */
+                          &layout_change);
+}
+
 /** Please see header for specification */
 std::unique_ptr<Anvil::Queue> Anvil::Queue::create(const Anvil::BaseDevice*          in_device_ptr,
                                                    uint32_t                          in_queue_family_index,
@@ -498,6 +561,14 @@ end:
     ;
 }
 
+/* Please see header for specification */
+bool Anvil::Queue::get_completed_submission_id(uint64_t* out_submission_id_ptr) const
+{
+    anvil_assert(m_submission_semaphore_ptr != nullptr);
+
+    return m_submission_semaphore_ptr->get_counter_value(out_submission_id_ptr);
+}
+
 /** Please see header for specification */
 void Anvil::Queue::insert_debug_utils_label(const char*  in_label_name_ptr,
                                             const float* in_color_vec4_ptr)
@@ -940,10 +1011,10 @@ bool Anvil::Queue::present_internal(DeviceGroupPresentModeFlagBits      in_prese
                         in_wait_semaphore_ptrs,
                         true);
     {
-        auto chain_ptr = struct_chainer.create_chain();
+        auto root_struct_ptr = struct_chainer.bake_chain();
 
         result_vk = swapchain_entrypoints_ptr->vkQueuePresentKHR(m_queue,
-                                                                 chain_ptr->get_root_struct() );
+                                                                 root_struct_ptr);
     }
     present_lock_unlock(in_n_swapchains,
                         in_swapchains,
@@ -1016,25 +1087,530 @@ void Anvil::Queue::present_lock_unlock(uint32_t                       in_n_swapc
     }
 }
 
+/** Locks the device's resource state mutex, unless it has already been locked for the submission which is being
+ *  prepared. The mutex is released by end_resource_state_resolution().
+ **/
+void Anvil::Queue::lock_resource_states()
+{
+    if (!m_are_resource_states_locked)
+    {
+        auto mutex_ptr = m_device_ptr->get_resource_state_mutex();
+
+        if (mutex_ptr != nullptr)
+        {
+            mutex_ptr->lock();
+        }
+
+        m_are_resource_states_locked = true;
+    }
+}
+
+/** Resolves resource usages declared in @param in_tracker_ptr against the current state of the resources, and
+ *  records a prologue command buffer holding barriers needed to bring the resources into the expected state.
+ *
+ *  Resulting resource states are stored in m_pending_resource_states. Prologue command buffers recorded by this
+ *  function must be passed to end_resource_state_resolution() after the submission is made.
+ *
+ *  @param in_tracker_ptr         Tracker to resolve. May be nullptr.
+ *  @param out_cmd_buffers_vk_ptr If a prologue command buffer is recorded, its handle will be appended to this vector.
+ *                                Must not be nullptr.
+ *
+ *  @return true if a prologue command buffer has been recorded, false otherwise.
+ **/
+bool Anvil::Queue::record_prologue_cmd_buffer(Anvil::ResourceStateTracker*  in_tracker_ptr,
+                                              std::vector<VkCommandBuffer>* out_cmd_buffers_vk_ptr)
+{
+    Anvil::PipelineStageFlags            dst_stage_mask;
+    Anvil::PrimaryCommandBufferUniquePtr prologue_cmd_buffer_ptr;
+    bool                                 result = false;
+    Anvil::PipelineStageFlags            src_stage_mask;
+
+    if (in_tracker_ptr == nullptr     ||
+        in_tracker_ptr->is_empty   () )
+    {
+        goto end;
+    }
+
+    lock_resource_states();
+
+    m_prologue_buffer_barriers.clear();
+    m_prologue_image_barriers.clear ();
+
+    in_tracker_ptr->resolve(&m_pending_resource_states,
+                            &src_stage_mask,
+                            &dst_stage_mask,
+                            &m_prologue_buffer_barriers,
+                            &m_prologue_image_barriers);
+
+    if (m_prologue_buffer_barriers.size() == 0 &&
+        m_prologue_image_barriers.size () == 0)
+    {
+        goto end;
+    }
+
+    if (m_available_prologue_cmd_buffers.size() == 0)
+    {
+        recycle_prologue_cmd_buffers();
+    }
+
+    if (m_available_prologue_cmd_buffers.size() > 0)
+    {
+        prologue_cmd_buffer_ptr = std::move(m_available_prologue_cmd_buffers.back() );
+
+        m_available_prologue_cmd_buffers.pop_back();
+    }
+    else
+    {
+        if (m_prologue_command_pool_ptr == nullptr)
+        {
+            m_prologue_command_pool_ptr = Anvil::CommandPool::create(const_cast<Anvil::BaseDevice*>(m_device_ptr),
+                                                                     Anvil::CommandPoolCreateFlagBits::CREATE_RESET_COMMAND_BUFFER_BIT,
+                                                                     m_queue_family_index,
+                                                                     Anvil::MTSafety::DISABLED);
+        }
+
+        prologue_cmd_buffer_ptr = m_prologue_command_pool_ptr->alloc_primary_level_command_buffer();
+    }
+
+    prologue_cmd_buffer_ptr->start_recording(true,   /* one_time_submit          */
+                                             false); /* simultaneous_use_allowed */
+    {
+        prologue_cmd_buffer_ptr->record_pipeline_barrier(src_stage_mask,
+                                                         dst_stage_mask,
+                                                         Anvil::DependencyFlagBits::NONE,
+                                                         0,       /* in_memory_barrier_count */
+                                                         nullptr, /* in_memory_barriers_ptr  */
+                                                         static_cast<uint32_t>(m_prologue_buffer_barriers.size() ),
+                                                         (m_prologue_buffer_barriers.size() > 0) ? &m_prologue_buffer_barriers.at(0) : nullptr,
+                                                         static_cast<uint32_t>(m_prologue_image_barriers.size() ),
+                                                         (m_prologue_image_barriers.size() > 0)  ? &m_prologue_image_barriers.at(0)  : nullptr);
+    }
+    prologue_cmd_buffer_ptr->stop_recording();
+
+    out_cmd_buffers_vk_ptr->push_back(prologue_cmd_buffer_ptr->get_command_buffer() );
+
+    m_recorded_prologue_cmd_buffers.push_back(std::move(prologue_cmd_buffer_ptr) );
+
+    result = true;
+end:
+    m_prologue_buffer_barriers.clear();
+    m_prologue_image_barriers.clear ();
+
+    return result;
+}
+
+/** Makes prologue command buffers which have finished executing available for reuse.
+ *
+ *  Submissions complete in order, so an in-flight item has finished executing if its own fence or submission ID
+ *  says so, or if any item which follows it has. Items submitted with a fence the queue does not own carry neither,
+ *  and are retired together with the next item which does. If too many of these pile up, a retirement point is
+ *  inserted with an empty submission, so that they do not stay in flight forever.
+ **/
+void Anvil::Queue::recycle_prologue_cmd_buffers()
+{
+    uint64_t completed_submission_id = 0;
+    uint32_t n_completed_items       = 0;
+    uint32_t n_item                  = 0;
+    uint32_t n_untracked_items       = 0;
+
+    if (m_submission_semaphore_ptr != nullptr)
+    {
+        get_completed_submission_id(&completed_submission_id);
+    }
+
+    for (const auto& current_item : m_in_flight_prologue_cmd_buffers)
+    {
+        ++n_item;
+
+        if (current_item.fence_ptr != nullptr)
+        {
+            if (!current_item.fence_ptr->is_set() )
+            {
+                break;
+            }
+
+            n_completed_items = n_item;
+        }
+        else
+        if (current_item.submission_id != 0)
+        {
+            if (current_item.submission_id > completed_submission_id)
+            {
+                break;
+            }
+
+            n_completed_items = n_item;
+        }
+    }
+
+    for (uint32_t n_completed_item = 0;
+                  n_completed_item < n_completed_items;
+                ++n_completed_item)
+    {
+        for (auto& current_cmd_buffer_ptr : m_in_flight_prologue_cmd_buffers.front().cmd_buffer_ptrs)
+        {
+            m_available_prologue_cmd_buffers.push_back(std::move(current_cmd_buffer_ptr) );
+        }
+
+        m_in_flight_prologue_cmd_buffers.pop_front();
+    }
+
+    for (auto item_iterator  = m_in_flight_prologue_cmd_buffers.rbegin();
+              item_iterator != m_in_flight_prologue_cmd_buffers.rend() && item_iterator->fence_ptr     == nullptr
+                                                                       && item_iterator->submission_id == 0;
+            ++item_iterator)
+    {
+        ++n_untracked_items;
+    }
+
+    if (n_untracked_items >= MAX_UNTRACKED_PROLOGUE_SUBMISSIONS)
+    {
+        InFlightPrologueCommandBuffers retirement_point;
+        VkResult                       result;
+
+        /* Fence signal operations cover all work submitted earlier to the queue */
+        retirement_point.fence_ptr = m_device_ptr->get_fence_pool()->get_fence();
+
+        result = m_device_ptr->get_dispatch_table().vkQueueSubmit(m_queue,
+                                                                  0,       /* submitCount */
+                                                                  nullptr, /* pSubmits    */
+                                                                  retirement_point.fence_ptr->get_fence() );
+
+        if (is_vk_call_successful(result) )
+        {
+            retirement_point.fence_ptr->m_has_been_submitted = true;
+
+            m_in_flight_prologue_cmd_buffers.push_back(std::move(retirement_point) );
+        }
+        else
+        {
+            anvil_assert_vk_call_succeeded(result);
+        }
+    }
+}
+
+/** Resolves an image layout change requested with change_image_layout(), as if it was a requirement of a command
+ *  buffer, and records a prologue command buffer which performs it.
+ *
+ *  The source state of the subresources is taken from the request, rather than from the tracked state, since
+ *  the image may have been accessed by commands which are not tracked.
+ *
+ *  @param in_image_layout_change Layout change to resolve.
+ *  @param out_cmd_buffers_vk_ptr Please see record_prologue_cmd_buffer() for more details.
+ **/
+void Anvil::Queue::resolve_image_layout_change(const ImageLayoutChange&      in_image_layout_change,
+                                               std::vector<VkCommandBuffer>* out_cmd_buffers_vk_ptr)
+{
+    Anvil::PipelineStageFlags  dst_stage_mask;
+    Anvil::PipelineStageFlags  src_stage_mask;
+    Anvil::ResourceAccessState src_state     (in_image_layout_change.src_layout);
+
+    /* Stages the subresources have last been accessed at are not known, so the barrier needs to wait for all commands
+     * submitted earlier. For the same reason, the destination stage mask covers all commands. */
+    src_state.write_access = in_image_layout_change.src_access_mask;
+    src_state.write_stages = Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT;
+
+    lock_resource_states();
+
+    m_pending_resource_states.set_image_state(in_image_layout_change.image_ptr,
+                                              in_image_layout_change.subresource_range,
+                                              src_state);
+
+    if (m_image_layout_change_tracker_ptr == nullptr)
+    {
+        m_image_layout_change_tracker_ptr = Anvil::ResourceStateTracker::create();
+    }
+    else
+    {
+        m_image_layout_change_tracker_ptr->reset();
+    }
+
+    /* The first usage recorded by a tracker never results in a barrier */
+    m_image_layout_change_tracker_ptr->use_image(in_image_layout_change.image_ptr,
+                                                 in_image_layout_change.subresource_range,
+                                                 in_image_layout_change.dst_layout,
+                                                 Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT,
+                                                 in_image_layout_change.dst_access_mask,
+                                                &src_stage_mask,
+                                                &dst_stage_mask,
+                                                &m_prologue_image_barriers);
+
+    anvil_assert(m_prologue_image_barriers.size() == 0);
+
+    record_prologue_cmd_buffer(m_image_layout_change_tracker_ptr.get(),
+                               out_cmd_buffers_vk_ptr);
+}
+
+/** Resolves resource usages declared for command buffers which are about to be submitted against the current
+ *  state of the resources, and interleaves the command buffers with prologue command buffers holding barriers
+ *  needed to bring the resources into the expected state.
+ *
+ *  Please see record_prologue_cmd_buffer() for more details.
+ *
+ *  @param in_n_cmd_buffers       Number of command buffers under @param in_cmd_buffer_ptrs.
+ *  @param in_cmd_buffer_ptrs     Command buffers to be submitted, in submission order.
+ *  @param out_cmd_buffers_vk_ptr Handles of the command buffers to submit, including the prologue command buffers,
+ *                                will be appended to this vector. Must not be nullptr.
+ *
+ *  @return Number of prologue command buffers recorded.
+ **/
+uint32_t Anvil::Queue::resolve_resource_states(uint32_t                         in_n_cmd_buffers,
+                                               Anvil::CommandBufferBase* const* in_cmd_buffer_ptrs,
+                                               std::vector<VkCommandBuffer>*    out_cmd_buffers_vk_ptr)
+{
+    uint32_t result = 0;
+
+    for (uint32_t n_cmd_buffer = 0;
+                  n_cmd_buffer < in_n_cmd_buffers;
+                ++n_cmd_buffer)
+    {
+        auto cmd_buffer_ptr = in_cmd_buffer_ptrs[n_cmd_buffer];
+
+        if (record_prologue_cmd_buffer(cmd_buffer_ptr->get_resource_state_tracker(),
+                                       out_cmd_buffers_vk_ptr) )
+        {
+            ++result;
+        }
+
+        out_cmd_buffers_vk_ptr->push_back(cmd_buffer_ptr->get_command_buffer() );
+    }
+
+    return result;
+}
+
+/** Resolves resource usages declared for command buffers of all single-GPU, unprotected submissions accumulated
+ *  in @param in_batch_ptr, and inserts prologue command buffers into the batch where needed.
+ *
+ *  Please see resolve_resource_states(uint32_t, CommandBufferBase* const*, std::vector<VkCommandBuffer>*) for
+ *  more details. Must be called before the batch is baked.
+ **/
+void Anvil::Queue::resolve_resource_states(Anvil::SubmissionBatch* in_batch_ptr)
+{
+    bool is_resolve_needed = false;
+
+    for (const auto cmd_buffer_ptr : in_batch_ptr->m_cmd_buffer_ptrs)
+    {
+        auto tracker_ptr = cmd_buffer_ptr->get_resource_state_tracker();
+
+        if (tracker_ptr != nullptr    &&
+           !tracker_ptr->is_empty  () )
+        {
+            is_resolve_needed = true;
+
+            break;
+        }
+    }
+
+    if (!is_resolve_needed)
+    {
+        goto end;
+    }
+
+    m_resolved_cmd_buffer_device_masks.clear();
+    m_resolved_cmd_buffers_vk.clear         ();
+
+    /* NOTE: For all submissions, n-th command buffer in m_cmd_buffer_ptrs corresponds to n-th item in m_cmd_buffers_vk */
+    for (auto& current_submission : in_batch_ptr->m_submissions)
+    {
+        const uint32_t first_cmd_buffer = current_submission.first_cmd_buffer;
+
+        current_submission.first_cmd_buffer = static_cast<uint32_t>(m_resolved_cmd_buffers_vk.size() );
+
+        if (current_submission.is_mgpu      ||
+            current_submission.is_protected)
+        {
+            for (uint32_t n_cmd_buffer = first_cmd_buffer;
+                          n_cmd_buffer < first_cmd_buffer + current_submission.n_cmd_buffers;
+                        ++n_cmd_buffer)
+            {
+                m_resolved_cmd_buffer_device_masks.push_back(in_batch_ptr->m_cmd_buffer_device_masks.at(n_cmd_buffer) );
+                m_resolved_cmd_buffers_vk.push_back         (in_batch_ptr->m_cmd_buffers_vk.at         (n_cmd_buffer) );
+            }
+        }
+        else
+        if (current_submission.n_cmd_buffers > 0)
+        {
+            current_submission.n_cmd_buffers += resolve_resource_states(current_submission.n_cmd_buffers,
+                                                                       &in_batch_ptr->m_cmd_buffer_ptrs.at(first_cmd_buffer),
+                                                                       &m_resolved_cmd_buffers_vk);
+
+            m_resolved_cmd_buffer_device_masks.resize(m_resolved_cmd_buffers_vk.size(),
+                                                      0);
+        }
+    }
+
+    /* Scratch storage is swapped, so that both the batch and the queue retain their allocations */
+    in_batch_ptr->m_cmd_buffer_device_masks.swap(m_resolved_cmd_buffer_device_masks);
+    in_batch_ptr->m_cmd_buffers_vk.swap         (m_resolved_cmd_buffers_vk);
+
+end:
+    ;
+}
+
 /** Please see header for specification */
-bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
+bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info,
+                          uint64_t*                out_opt_submission_id_ptr)
 {
-    Anvil::Fence*                      fence_ptr        (in_submit_info.get_fence() );
-    bool                               needs_fence_reset(false);
-    VkResult                           result           (VK_ERROR_INITIALIZATION_FAILED);
+    return submit_internal(in_submit_info,
+                           out_opt_submission_id_ptr,
+                           nullptr); /* in_opt_image_layout_change_ptr */
+}
+
+/** Implements submit(const SubmitInfo&).
+ *
+ *  @param in_opt_image_layout_change_ptr If not nullptr, describes an image layout change which is resolved like
+ *                                        a requirement of a command buffer submitted before all other command buffers.
+ *                                        Only supported for single-GPU, unprotected submissions.
+ *
+ *  Remaining arguments and the return value have the same meaning as for submit(const SubmitInfo&).
+ **/
+bool Anvil::Queue::submit_internal(const Anvil::SubmitInfo& in_submit_info,
+                                   uint64_t*                out_opt_submission_id_ptr,
+                                   const ImageLayoutChange* in_opt_image_layout_change_ptr)
+{
+    ANVIL_INSTRUMENTATION_SCOPE("Queue::submit");
+
+    Anvil::Fence*                      fence_ptr             (in_submit_info.get_fence() );
+    bool                               is_tracked            (false);
+    uint32_t                           n_signal_semaphores_vk(0);
+    Anvil::FenceUniquePtr              pooled_fence_ptr;
+    Anvil::FenceUniquePtr              prologue_fence_ptr;
+    VkResult                           result                (VK_ERROR_INITIALIZATION_FAILED);
     Anvil::StructChainer<VkSubmitInfo> struct_chainer;
+    uint64_t                           submission_id         (0);
+    Anvil::Fence*                      submit_fence_ptr      (nullptr);
 
-    std::vector<VkCommandBuffer> cmd_buffers_vk         (in_submit_info.get_n_command_buffers  () );
-    std::vector<VkDeviceMemory>  device_memory_block_vec(0);
-    std::vector<VkSemaphore>     signal_semaphores_vk   (in_submit_info.get_n_signal_semaphores() );
-    std::vector<VkSemaphore>     wait_semaphores_vk     (in_submit_info.get_n_wait_semaphores  () );
+    ANVIL_REDUNDANT_VARIABLE(result);
 
-    std::vector<uint32_t> cmd_buffer_device_masks         = std::vector<uint32_t>(in_submit_info.get_n_command_buffers() );
-    std::vector<uint32_t> signal_semaphore_device_indices = std::vector<uint32_t>(in_submit_info.get_n_signal_semaphores() );
-    std::vector<uint32_t> wait_semaphore_device_indices   = std::vector<uint32_t>(in_submit_info.get_n_wait_semaphores  () );
+    ANVIL_INSTRUMENTATION_COUNTER("Queue::submit command buffers",
+                                  in_submit_info.get_n_command_buffers() );
 
+    /* Make sure host writes deferred by persistently mapped memory blocks are visible to the submitted work.
+     * The check boils down to a single atomic load if no writes have been deferred. */
+    if (m_device_ptr->get_deferred_memory_flush_list()->get_n_pending_memory_blocks() > 0)
+    {
+        m_device_ptr->get_deferred_memory_flush_list()->flush();
+    }
 
-    ANVIL_REDUNDANT_VARIABLE(result);
+    /* If the submission is tracked, blocking submissions are waited on using the submission semaphore,
+     * so a helper fence is only needed if tracking is unavailable. */
+    if (fence_ptr                         == nullptr &&
+        in_submit_info.get_should_block()            &&
+        m_submission_semaphore_ptr        == nullptr)
+    {
+        pooled_fence_ptr = m_device_ptr->get_fence_pool()->get_fence();
+        fence_ptr        = pooled_fence_ptr.get();
+    }
+
+    /* Scratch storage used below is owned by the queue, so the queue must be locked before it is touched. */
+    switch (in_submit_info.get_type() )
+    {
+        case SubmissionType::MGPU:
+        {
+            submit_command_buffers_lock_unlock(in_submit_info.get_n_command_buffers     (),
+                                               in_submit_info.get_command_buffers_mgpu  (),
+                                               in_submit_info.get_n_signal_semaphores   (),
+                                               in_submit_info.get_signal_semaphores_mgpu(),
+                                               in_submit_info.get_n_wait_semaphores     (),
+                                               in_submit_info.get_wait_semaphores_mgpu  (),
+                                               fence_ptr,
+                                               true); /* in_should_lock */
+
+            break;
+        }
+
+        case SubmissionType::SGPU:
+        {
+            submit_command_buffers_lock_unlock(in_submit_info.get_n_command_buffers     (),
+                                               in_submit_info.get_command_buffers_sgpu  (),
+                                               in_submit_info.get_n_signal_semaphores   (),
+                                               in_submit_info.get_signal_semaphores_sgpu(),
+                                               in_submit_info.get_n_wait_semaphores     (),
+                                               in_submit_info.get_wait_semaphores_sgpu  (),
+                                               fence_ptr,
+                                               true); /* in_should_lock */
+
+            break;
+        }
+
+        default:
+        {
+            anvil_assert_fail();
+        }
+    }
+
+    if (in_submit_info.get_type() == SubmissionType::SGPU)
+    {
+        m_submit_cmd_buffers_vk.clear();
+
+        if (in_submit_info.is_protected_submission() )
+        {
+            anvil_assert(reinterpret_cast<const SGPUDevice*>(m_device_ptr)->get_physical_device()->supports_core_vk1_1() );
+
+            for (uint32_t n_command_buffer = 0;
+                          n_command_buffer < in_submit_info.get_n_command_buffers();
+                        ++n_command_buffer)
+            {
+                m_submit_cmd_buffers_vk.push_back(in_submit_info.get_command_buffers_sgpu()[n_command_buffer]->get_command_buffer() );
+            }
+        }
+        else
+        {
+            if (in_opt_image_layout_change_ptr != nullptr)
+            {
+                resolve_image_layout_change(*in_opt_image_layout_change_ptr,
+                                            &m_submit_cmd_buffers_vk);
+            }
+
+            /* Also interleaves the command buffers with prologue command buffers, if any are needed */
+            resolve_resource_states(in_submit_info.get_n_command_buffers(),
+                                    in_submit_info.get_command_buffers_sgpu(),
+                                   &m_submit_cmd_buffers_vk);
+        }
+    }
+    else
+    {
+        anvil_assert(in_opt_image_layout_change_ptr == nullptr);
+    }
+
+    /* If the queue cannot track submissions, prologue command buffers are recycled once the submission's fence is
+     * signalled. Fences specified by the app may be reset or released at any time, so use one owned by the queue
+     * if possible. */
+    if (m_submission_semaphore_ptr            == nullptr &&
+        m_recorded_prologue_cmd_buffers.size() > 0       &&
+        fence_ptr                             == nullptr)
+    {
+        prologue_fence_ptr = m_device_ptr->get_fence_pool()->get_fence();
+    }
+
+    submit_fence_ptr = (fence_ptr != nullptr) ? fence_ptr
+                                              : prologue_fence_ptr.get();
+
+    /* Signalling the submission semaphore is only worth it if somebody is going to make use of the submission ID:
+     * the caller, a blocking submission which has no fence to wait on, or prologue command buffers which need
+     * to be recycled once they finish executing. */
+    is_tracked = (m_submission_semaphore_ptr != nullptr &&
+                  (out_opt_submission_id_ptr             != nullptr ||
+                   m_recorded_prologue_cmd_buffers.size() > 0       ||
+                   (in_submit_info.get_should_block() && fence_ptr == nullptr) ));
+
+    if (is_tracked)
+    {
+        /* The queue is locked at this point, so submission IDs are assigned in the same order the submissions
+         * are made in. The queue's submission semaphore is signalled after all user-specified semaphores. */
+        submission_id          = m_last_submission_id + 1;
+        n_signal_semaphores_vk = in_submit_info.get_n_signal_semaphores() + 1;
+    }
+    else
+    {
+        n_signal_semaphores_vk = in_submit_info.get_n_signal_semaphores();
+    }
+
+    /* Scratch vectors retain their capacity between calls, so steady-state submissions do not allocate. */
+    m_submit_signal_semaphore_device_indices.resize(n_signal_semaphores_vk);
+    m_submit_signal_semaphores_vk.resize           (n_signal_semaphores_vk);
+    m_submit_wait_semaphore_device_indices.resize  (in_submit_info.get_n_wait_semaphores() );
+    m_submit_wait_semaphores_vk.resize             (in_submit_info.get_n_wait_semaphores() );
 
     /* Prepare for the submission */
     switch (in_submit_info.get_type() )
@@ -1048,6 +1624,9 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
                 anvil_assert(reinterpret_cast<const MGPUDevice*>(m_device_ptr)->get_physical_device(0)->supports_core_vk1_1() );
             }
 
+            m_submit_cmd_buffer_device_masks.resize(in_submit_info.get_n_command_buffers() );
+            m_submit_cmd_buffers_vk.resize         (in_submit_info.get_n_command_buffers() );
+
             for (uint32_t n_command_buffer_submission = 0;
                           n_command_buffer_submission < in_submit_info.get_n_command_buffers();
                         ++n_command_buffer_submission)
@@ -1056,8 +1635,8 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
 
                 if (current_submission.cmd_buffer_ptr != nullptr)
                 {
-                    cmd_buffers_vk.at         (n_cmd_buffers) = current_submission.cmd_buffer_ptr->get_command_buffer();
-                    cmd_buffer_device_masks.at(n_cmd_buffers) = current_submission.device_mask;
+                    m_submit_cmd_buffers_vk.at         (n_cmd_buffers) = current_submission.cmd_buffer_ptr->get_command_buffer();
+                    m_submit_cmd_buffer_device_masks.at(n_cmd_buffers) = current_submission.device_mask;
 
                     ++n_cmd_buffers;
                 }
@@ -1071,8 +1650,8 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
 
                 anvil_assert(current_submission.device_index < reinterpret_cast<const Anvil::MGPUDevice*>(m_device_ptr)->get_n_physical_devices() );
 
-                signal_semaphore_device_indices.at(n_signal_semaphore_submission) = current_submission.device_index;
-                signal_semaphores_vk.at           (n_signal_semaphore_submission) = current_submission.semaphore_ptr->get_semaphore();
+                m_submit_signal_semaphore_device_indices.at(n_signal_semaphore_submission) = current_submission.device_index;
+                m_submit_signal_semaphores_vk.at           (n_signal_semaphore_submission) = current_submission.semaphore_ptr->get_semaphore();
             }
 
             for (uint32_t n_wait_semaphore_submission = 0;
@@ -1083,20 +1662,26 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
 
                 anvil_assert(current_submission.device_index < reinterpret_cast<const Anvil::MGPUDevice*>(m_device_ptr)->get_n_physical_devices() );
 
-                wait_semaphore_device_indices.at(n_wait_semaphore_submission) = current_submission.device_index;
-                wait_semaphores_vk.at           (n_wait_semaphore_submission) = current_submission.semaphore_ptr->get_semaphore();
+                m_submit_wait_semaphore_device_indices.at(n_wait_semaphore_submission) = current_submission.device_index;
+                m_submit_wait_semaphores_vk.at           (n_wait_semaphore_submission) = current_submission.semaphore_ptr->get_semaphore();
+            }
+
+            if (is_tracked)
+            {
+                m_submit_signal_semaphore_device_indices.back() = 0;
+                m_submit_signal_semaphores_vk.back           () = m_submission_semaphore_ptr->get_semaphore();
             }
 
             {
                 VkSubmitInfo submit_info;
 
                 submit_info.commandBufferCount   = in_submit_info.get_n_command_buffers();
-                submit_info.pCommandBuffers      = (submit_info.commandBufferCount           != 0) ? &cmd_buffers_vk.at(0)       : nullptr;
+                submit_info.pCommandBuffers      = (submit_info.commandBufferCount           != 0) ? &m_submit_cmd_buffers_vk.at(0)       : nullptr;
                 submit_info.pNext                = nullptr;
-                submit_info.pSignalSemaphores    = (in_submit_info.get_n_signal_semaphores() != 0) ? &signal_semaphores_vk.at(0) : nullptr;
+                submit_info.pSignalSemaphores    = (n_signal_semaphores_vk                   != 0) ? &m_submit_signal_semaphores_vk.at(0) : nullptr;
                 submit_info.pWaitDstStageMask    = in_submit_info.get_destination_stage_wait_masks();
-                submit_info.pWaitSemaphores      = (in_submit_info.get_n_wait_semaphores()   != 0) ? &wait_semaphores_vk.at(0)   : nullptr;
-                submit_info.signalSemaphoreCount = in_submit_info.get_n_signal_semaphores();
+                submit_info.pWaitSemaphores      = (in_submit_info.get_n_wait_semaphores()   != 0) ? &m_submit_wait_semaphores_vk.at(0)   : nullptr;
+                submit_info.signalSemaphoreCount = n_signal_semaphores_vk;
                 submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
                 submit_info.waitSemaphoreCount   = in_submit_info.get_n_wait_semaphores();
 
@@ -1107,11 +1692,11 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
                 VkDeviceGroupSubmitInfoKHR submit_info_device_group;
 
                 submit_info_device_group.commandBufferCount            = n_cmd_buffers;
-                submit_info_device_group.pCommandBufferDeviceMasks     = (n_cmd_buffers != 0) ? &cmd_buffer_device_masks.at(0) : nullptr;
+                submit_info_device_group.pCommandBufferDeviceMasks     = (n_cmd_buffers != 0) ? &m_submit_cmd_buffer_device_masks.at(0) : nullptr;
                 submit_info_device_group.pNext                         = nullptr;
-                submit_info_device_group.pSignalSemaphoreDeviceIndices = (in_submit_info.get_n_signal_semaphores() != 0) ? &signal_semaphore_device_indices.at(0) : nullptr;
-                submit_info_device_group.pWaitSemaphoreDeviceIndices   = (in_submit_info.get_n_wait_semaphores  () != 0) ? &wait_semaphore_device_indices.at  (0) : nullptr;
-                submit_info_device_group.signalSemaphoreCount          = in_submit_info.get_n_signal_semaphores();
+                submit_info_device_group.pSignalSemaphoreDeviceIndices = (n_signal_semaphores_vk                     != 0) ? &m_submit_signal_semaphore_device_indices.at(0) : nullptr;
+                submit_info_device_group.pWaitSemaphoreDeviceIndices   = (in_submit_info.get_n_wait_semaphores  () != 0) ? &m_submit_wait_semaphore_device_indices.at  (0) : nullptr;
+                submit_info_device_group.signalSemaphoreCount          = n_signal_semaphores_vk;
                 submit_info_device_group.sType                         = VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR;
                 submit_info_device_group.waitSemaphoreCount            = in_submit_info.get_n_wait_semaphores();
 
@@ -1125,41 +1710,34 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
         {
             VkSubmitInfo submit_info;
 
-            if (in_submit_info.is_protected_submission() )
-            {
-                anvil_assert(reinterpret_cast<const SGPUDevice*>(m_device_ptr)->get_physical_device()->supports_core_vk1_1() );
-            }
-
-            for (uint32_t n_command_buffer = 0;
-                          n_command_buffer < in_submit_info.get_n_command_buffers();
-                        ++n_command_buffer)
-            {
-                cmd_buffers_vk.at(n_command_buffer) = in_submit_info.get_command_buffers_sgpu()[n_command_buffer]->get_command_buffer();
-            }
-
             for (uint32_t n_signal_semaphore = 0;
                           n_signal_semaphore < in_submit_info.get_n_signal_semaphores();
                         ++n_signal_semaphore)
             {
                 auto sem_ptr = in_submit_info.get_signal_semaphores_sgpu()[n_signal_semaphore];
 
-                signal_semaphores_vk.at(n_signal_semaphore) = sem_ptr->get_semaphore();
+                m_submit_signal_semaphores_vk.at(n_signal_semaphore) = sem_ptr->get_semaphore();
             }
 
             for (uint32_t n_wait_semaphore = 0;
                           n_wait_semaphore < in_submit_info.get_n_wait_semaphores();
                         ++n_wait_semaphore)
             {
-                wait_semaphores_vk.at(n_wait_semaphore) = in_submit_info.get_wait_semaphores_sgpu()[n_wait_semaphore]->get_semaphore();
+                m_submit_wait_semaphores_vk.at(n_wait_semaphore) = in_submit_info.get_wait_semaphores_sgpu()[n_wait_semaphore]->get_semaphore();
             }
 
-            submit_info.commandBufferCount   = in_submit_info.get_n_command_buffers ();
-            submit_info.pCommandBuffers      = (in_submit_info.get_n_command_buffers()   != 0) ? &cmd_buffers_vk.at(0)       : nullptr;
+            if (is_tracked)
+            {
+                m_submit_signal_semaphores_vk.back() = m_submission_semaphore_ptr->get_semaphore();
+            }
+
+            submit_info.commandBufferCount   = static_cast<uint32_t>(m_submit_cmd_buffers_vk.size() );
+            submit_info.pCommandBuffers      = (m_submit_cmd_buffers_vk.size()           != 0) ? &m_submit_cmd_buffers_vk.at(0)       : nullptr;
             submit_info.pNext                = nullptr;
-            submit_info.pSignalSemaphores    = (in_submit_info.get_n_signal_semaphores() != 0) ? &signal_semaphores_vk.at(0) : nullptr;
+            submit_info.pSignalSemaphores    = (n_signal_semaphores_vk                   != 0) ? &m_submit_signal_semaphores_vk.at(0) : nullptr;
             submit_info.pWaitDstStageMask    = in_submit_info.get_destination_stage_wait_masks();
-            submit_info.pWaitSemaphores      = (in_submit_info.get_n_wait_semaphores()   != 0) ? &wait_semaphores_vk.at(0)   : nullptr;
-            submit_info.signalSemaphoreCount = in_submit_info.get_n_signal_semaphores();
+            submit_info.pWaitSemaphores      = (in_submit_info.get_n_wait_semaphores()   != 0) ? &m_submit_wait_semaphores_vk.at(0)   : nullptr;
+            submit_info.signalSemaphoreCount = n_signal_semaphores_vk;
             submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
             submit_info.waitSemaphoreCount   = in_submit_info.get_n_wait_semaphores();
 
@@ -1185,10 +1763,24 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
         {
             VkD3D12FenceSubmitInfoKHR fence_info;
 
+            if (is_tracked                                         &&
+                d3d12_fence_signal_semaphore_values_ptr != nullptr)
+            {
+                /* Value arrays must cover the submission semaphore, too. The value is ignored. */
+                m_submit_d3d12_fence_signal_semaphore_values.resize(n_signal_semaphores_vk);
+
+                std::copy(d3d12_fence_signal_semaphore_values_ptr,
+                          d3d12_fence_signal_semaphore_values_ptr + in_submit_info.get_n_signal_semaphores(),
+                          m_submit_d3d12_fence_signal_semaphore_values.begin() );
+
+                m_submit_d3d12_fence_signal_semaphore_values.back() = 0;
+                d3d12_fence_signal_semaphore_values_ptr             = &m_submit_d3d12_fence_signal_semaphore_values.at(0);
+            }
+
             fence_info.pNext                      = nullptr;
             fence_info.pSignalSemaphoreValues     = d3d12_fence_signal_semaphore_values_ptr;
             fence_info.pWaitSemaphoreValues       = d3d12_fence_wait_semaphore_values_ptr;
-            fence_info.signalSemaphoreValuesCount = in_submit_info.get_n_signal_semaphores();
+            fence_info.signalSemaphoreValuesCount = n_signal_semaphores_vk;
             fence_info.sType                      = VK_STRUCTURE_TYPE_D3D12_FENCE_SUBMIT_INFO_KHR;
             fence_info.waitSemaphoreValuesCount   = in_submit_info.get_n_wait_semaphores();
 
@@ -1219,11 +1811,11 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
 
             anvil_assert(n_acquire_keys + n_release_keys > 0);
 
-            device_memory_block_vec.resize(n_acquire_keys + n_release_keys);
+            m_submit_keyed_mutex_syncs_vk.resize(n_acquire_keys + n_release_keys);
 
-            VkDeviceMemory* acquire_sync_ptr = (n_acquire_keys > 0) ? &device_memory_block_vec.at(0)
+            VkDeviceMemory* acquire_sync_ptr = (n_acquire_keys > 0) ? &m_submit_keyed_mutex_syncs_vk.at(0)
                                                                     : nullptr;
-            VkDeviceMemory* release_sync_ptr = (n_release_keys > 0) ? &device_memory_block_vec.at(n_acquire_keys)
+            VkDeviceMemory* release_sync_ptr = (n_release_keys > 0) ? &m_submit_keyed_mutex_syncs_vk.at(n_acquire_keys)
                                                                     : nullptr;
 
             for (uint32_t n_acquire_sync = 0;
@@ -1266,12 +1858,105 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
         struct_chainer.append_struct(submit_info);
     }
 
+    {
+        const uint64_t* timeline_signal_semaphore_values_ptr = nullptr;
+        const uint64_t* timeline_wait_semaphore_values_ptr   = nullptr;
+
+        if (in_submit_info.get_timeline_semaphore_values(&timeline_signal_semaphore_values_ptr,
+                                                         &timeline_wait_semaphore_values_ptr) ||
+            is_tracked)
+        {
+            VkTimelineSemaphoreSubmitInfoKHR timeline_info;
+
+            anvil_assert(m_device_ptr->get_extension_info()->khr_timeline_semaphore() );
+
+            if (is_tracked)
+            {
+                /* User-specified values are followed by the submission ID. Values specified for binary semaphores
+                 * are ignored. */
+                m_submit_timeline_signal_semaphore_values.resize(n_signal_semaphores_vk);
+
+                if (timeline_signal_semaphore_values_ptr != nullptr)
+                {
+                    std::copy(timeline_signal_semaphore_values_ptr,
+                              timeline_signal_semaphore_values_ptr + in_submit_info.get_n_signal_semaphores(),
+                              m_submit_timeline_signal_semaphore_values.begin() );
+                }
+                else
+                {
+                    std::fill(m_submit_timeline_signal_semaphore_values.begin(),
+                              m_submit_timeline_signal_semaphore_values.end  (),
+                              0);
+                }
+
+                m_submit_timeline_signal_semaphore_values.back() = submission_id;
+                timeline_signal_semaphore_values_ptr             = &m_submit_timeline_signal_semaphore_values.at(0);
+            }
+
+            timeline_info.pNext                     = nullptr;
+            timeline_info.pSignalSemaphoreValues    = timeline_signal_semaphore_values_ptr;
+            timeline_info.pWaitSemaphoreValues      = timeline_wait_semaphore_values_ptr;
+            timeline_info.signalSemaphoreValueCount = (timeline_signal_semaphore_values_ptr != nullptr) ? n_signal_semaphores_vk
+                                                                                                        : 0;
+            timeline_info.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+            timeline_info.waitSemaphoreValueCount   = (timeline_wait_semaphore_values_ptr   != nullptr) ? in_submit_info.get_n_wait_semaphores()
+                                                                                                        : 0;
+
+            struct_chainer.append_struct(timeline_info);
+        }
+    }
+
     /* Go for it */
-    if (fence_ptr                         == nullptr &&
-        in_submit_info.get_should_block() )
     {
-        fence_ptr         = m_submit_fence_ptr.get();
-        needs_fence_reset = true;
+        auto root_struct_ptr = struct_chainer.bake_chain();
+
+        result = m_device_ptr->get_dispatch_table().vkQueueSubmit(m_queue,
+                                                                  1, /* submitCount */
+                                                                  root_struct_ptr,
+                                                                  (submit_fence_ptr != nullptr) ? submit_fence_ptr->get_fence()
+                                                                                                : VK_NULL_HANDLE);
+
+        if (result           == VK_SUCCESS &&
+            submit_fence_ptr != nullptr)
+        {
+            submit_fence_ptr->m_has_been_submitted = true;
+        }
+
+        end_resource_state_resolution(result == VK_SUCCESS,
+                                      submission_id,
+                                      (prologue_fence_ptr != nullptr) ? &prologue_fence_ptr
+                                                                      : &pooled_fence_ptr);
+
+        if (result     == VK_SUCCESS &&
+            is_tracked)
+        {
+            m_last_submission_id = submission_id;
+
+            if (out_opt_submission_id_ptr != nullptr)
+            {
+                *out_opt_submission_id_ptr = submission_id;
+            }
+        }
+
+        if (in_submit_info.get_should_block() )
+        {
+            /* Wait till initialization finishes GPU-side */
+            if (fence_ptr != nullptr)
+            {
+                result = m_device_ptr->get_dispatch_table().vkWaitForFences(m_device_ptr->get_device_vk(),
+                                                                            1, /* fenceCount */
+                                                                            fence_ptr->get_fence_ptr(),
+                                                                            VK_TRUE,     /* waitAll */
+                                                                            in_submit_info.get_timeout() );
+            }
+            else
+            if (result == VK_SUCCESS)
+            {
+                result = (m_submission_semaphore_ptr->wait(submission_id,
+                                                           in_submit_info.get_timeout() )) ? VK_SUCCESS
+                                                                                           : VK_TIMEOUT;
+            }
+        }
     }
 
     switch (in_submit_info.get_type() )
@@ -1285,93 +1970,169 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
                                                in_submit_info.get_n_wait_semaphores     (),
                                                in_submit_info.get_wait_semaphores_mgpu  (),
                                                fence_ptr,
-                                               true);
+                                               false); /* in_should_lock */
 
             break;
         }
 
         case SubmissionType::SGPU:
         {
-             submit_command_buffers_lock_unlock(in_submit_info.get_n_command_buffers     (),
-                                                in_submit_info.get_command_buffers_sgpu  (),
-                                                in_submit_info.get_n_signal_semaphores   (),
-                                                in_submit_info.get_signal_semaphores_sgpu(),
-                                                in_submit_info.get_n_wait_semaphores     (),
-                                                in_submit_info.get_wait_semaphores_sgpu  (),
-                                                fence_ptr,
-                                                true); /* in_should_lock */
+            submit_command_buffers_lock_unlock(in_submit_info.get_n_command_buffers     (),
+                                               in_submit_info.get_command_buffers_sgpu  (),
+                                               in_submit_info.get_n_signal_semaphores   (),
+                                               in_submit_info.get_signal_semaphores_sgpu(),
+                                               in_submit_info.get_n_wait_semaphores     (),
+                                               in_submit_info.get_wait_semaphores_sgpu  (),
+                                               fence_ptr,
+                                               false); /* in_should_lock */
 
-             break;
+            break;
         }
 
         default:
         {
             anvil_assert_fail();
         }
-     }
+    }
 
-     {
-        auto chain_ptr = struct_chainer.create_chain();
+    return (result == VK_SUCCESS);
+}
+
+/* Please see header for specification */
+bool Anvil::Queue::submit(Anvil::SubmissionBatch* in_batch_ptr,
+                          uint64_t*               out_opt_submission_id_ptr)
+{
+    ANVIL_INSTRUMENTATION_SCOPE("Queue::submit (batch)");
+
+    Anvil::Fence*         fence_ptr        = in_batch_ptr->get_fence();
+    bool                  is_tracked       = false;
+    const uint32_t        n_submissions    = in_batch_ptr->get_n_submissions();
+    Anvil::FenceUniquePtr pooled_fence_ptr;
+    Anvil::FenceUniquePtr prologue_fence_ptr;
+    VkResult              result           = VK_ERROR_INITIALIZATION_FAILED;
+    Anvil::Fence*         submit_fence_ptr = nullptr;
+    uint64_t              submission_id    = 0;
+    const VkSubmitInfo*   submit_infos_ptr = nullptr;
+
+    ANVIL_INSTRUMENTATION_COUNTER("Queue::submit submissions",
+                                  n_submissions);
+
+    /* Make sure host writes deferred by persistently mapped memory blocks are visible to the submitted work.
+     * The check boils down to a single atomic load if no writes have been deferred. */
+    if (m_device_ptr->get_deferred_memory_flush_list()->get_n_pending_memory_blocks() > 0)
+    {
+        m_device_ptr->get_deferred_memory_flush_list()->flush();
+    }
+
+    if (n_submissions == 0)
+    {
+        /* Nothing to do */
+        result = VK_SUCCESS;
 
-        if (needs_fence_reset)
+        goto end;
+    }
+
+    if (fence_ptr                      == nullptr &&
+        in_batch_ptr->get_should_block()          &&
+        m_submission_semaphore_ptr     == nullptr)
+    {
+        pooled_fence_ptr = m_device_ptr->get_fence_pool()->get_fence();
+        fence_ptr        = pooled_fence_ptr.get();
+    }
+
+    lock();
+    in_batch_ptr->lock_unlock(true); /* in_should_lock */
+
+    resolve_resource_states(in_batch_ptr);
+
+    /* Please see submit_internal() for the reasoning */
+    if (m_submission_semaphore_ptr            == nullptr &&
+        m_recorded_prologue_cmd_buffers.size() > 0       &&
+        fence_ptr                             == nullptr)
+    {
+        prologue_fence_ptr = m_device_ptr->get_fence_pool()->get_fence();
+        submit_fence_ptr   = prologue_fence_ptr.get();
+    }
+    else
+    {
+        submit_fence_ptr = fence_ptr;
+    }
+
+    /* Please see submit(const SubmitInfo&) for the reasoning */
+    is_tracked = (m_submission_semaphore_ptr != nullptr &&
+                  (out_opt_submission_id_ptr             != nullptr ||
+                   m_recorded_prologue_cmd_buffers.size() > 0       ||
+                   (in_batch_ptr->get_should_block() && fence_ptr == nullptr) ));
+
+    if (is_tracked)
+    {
+        /* The whole batch is assigned a single submission ID. The queue is locked at this point, so submission IDs
+         * are assigned in the same order the submissions are made in. */
+        submission_id    = m_last_submission_id + 1;
+        submit_infos_ptr = in_batch_ptr->bake_submit_infos(m_submission_semaphore_ptr->get_semaphore(),
+                                                           submission_id);
+    }
+    else
+    {
+        submit_infos_ptr = in_batch_ptr->bake_submit_infos(VK_NULL_HANDLE, /* in_opt_tracking_semaphore */
+                                                           0);             /* in_tracking_semaphore_value */
+    }
+
+    result = m_device_ptr->get_dispatch_table().vkQueueSubmit(m_queue,
+                                                              n_submissions,
+                                                              submit_infos_ptr,
+                                                              (submit_fence_ptr != nullptr) ? submit_fence_ptr->get_fence()
+                                                                                            : VK_NULL_HANDLE);
+
+    if (result           == VK_SUCCESS &&
+        submit_fence_ptr != nullptr)
+    {
+        submit_fence_ptr->m_has_been_submitted = true;
+    }
+
+    end_resource_state_resolution(result == VK_SUCCESS,
+                                  submission_id,
+                                  (prologue_fence_ptr != nullptr) ? &prologue_fence_ptr
+                                                                  : &pooled_fence_ptr);
+
+    if (result     == VK_SUCCESS &&
+        is_tracked)
+    {
+        m_last_submission_id = submission_id;
+
+        if (out_opt_submission_id_ptr != nullptr)
         {
-            m_submit_fence_ptr->reset();
+            *out_opt_submission_id_ptr = submission_id;
         }
+    }
 
-         result = Anvil::Vulkan::vkQueueSubmit(m_queue,
-                                               1, /* submitCount */
-                                               chain_ptr->get_root_struct(),
-                                              (fence_ptr != nullptr) ? fence_ptr->get_fence()
-                                                                     : VK_NULL_HANDLE);
-
-        if (in_submit_info.get_should_block() )
+    if (result                         == VK_SUCCESS &&
+        in_batch_ptr->get_should_block() )
+    {
+        /* Wait till the whole batch finishes executing GPU-side */
+        if (fence_ptr != nullptr)
         {
-            /* Wait till initialization finishes GPU-side */
-            result = Anvil::Vulkan::vkWaitForFences(m_device_ptr->get_device_vk(),
-                                                    1, /* fenceCount */
-                                                    fence_ptr->get_fence_ptr(),
-                                                    VK_TRUE,     /* waitAll */
-                                                    in_submit_info.get_timeout() );
-        }
-     }
-
-     switch (in_submit_info.get_type() )
-     {
-         case SubmissionType::MGPU:
-         {
-             submit_command_buffers_lock_unlock(in_submit_info.get_n_command_buffers     (),
-                                                in_submit_info.get_command_buffers_mgpu  (),
-                                                in_submit_info.get_n_signal_semaphores   (),
-                                                in_submit_info.get_signal_semaphores_mgpu(),
-                                                in_submit_info.get_n_wait_semaphores     (),
-                                                in_submit_info.get_wait_semaphores_mgpu  (),
-                                                fence_ptr,
-                                                false); /* in_should_lock */
-
-             break;
-         }
-
-         case SubmissionType::SGPU:
-         {
-             submit_command_buffers_lock_unlock(in_submit_info.get_n_command_buffers     (),
-                                                in_submit_info.get_command_buffers_sgpu  (),
-                                                in_submit_info.get_n_signal_semaphores   (),
-                                                in_submit_info.get_signal_semaphores_sgpu(),
-                                                in_submit_info.get_n_wait_semaphores     (),
-                                                in_submit_info.get_wait_semaphores_sgpu  (),
-                                                fence_ptr,
-                                                false); /* in_should_lock */
-
-             break;
-         }
-
-         default:
-         {
-             anvil_assert_fail();
-         }
-     }
-
-     return (result == VK_SUCCESS);
+            result = m_device_ptr->get_dispatch_table().vkWaitForFences(m_device_ptr->get_device_vk(),
+                                                                        1, /* fenceCount */
+                                                                        fence_ptr->get_fence_ptr(),
+                                                                        VK_TRUE, /* waitAll */
+                                                                        in_batch_ptr->get_timeout() );
+        }
+        else
+        {
+            result = (m_submission_semaphore_ptr->wait(submission_id,
+                                                       in_batch_ptr->get_timeout() )) ? VK_SUCCESS
+                                                                                      : VK_TIMEOUT;
+        }
+    }
+
+    in_batch_ptr->lock_unlock(false); /* in_should_lock */
+    unlock();
+
+    in_batch_ptr->clear();
+
+end:
+    return (result == VK_SUCCESS);
 }
 
 void Anvil::Queue::submit_command_buffers_lock_unlock(uint32_t                         in_n_command_buffers,
@@ -1525,11 +2286,95 @@ void Anvil::Queue::submit_command_buffers_lock_unlock(uint32_t
     }
 }
 
+/** Finishes resolution of resource states for a submission, once the submission has been attempted.
+ *
+ *  If the submission has been made, resource states it leaves the resources in are published, and prologue
+ *  command buffers recorded for it are moved to the in-flight list, so that they can be recycled once they
+ *  finish executing. Otherwise, the pending states are dropped and the command buffers are made available
+ *  for reuse immediately. Either way, the device's resource state mutex is released if it has been locked.
+ *
+ *  @param in_have_been_submitted true if the submission has been made.
+ *  @param in_submission_id       ID assigned to the submission, or 0 if the submission is not tracked.
+ *  @param inout_fence_ptr_ptr    Fence owned by the queue which the submission has been made with, if any. Ownership
+ *                                is taken over if the fence is needed to find out when the prologue command buffers
+ *                                finish executing. Must not be nullptr.
+ **/
+void Anvil::Queue::end_resource_state_resolution(bool                   in_have_been_submitted,
+                                                 uint64_t               in_submission_id,
+                                                 Anvil::FenceUniquePtr* inout_fence_ptr_ptr)
+{
+    InFlightPrologueCommandBuffers in_flight_item;
+
+    if (in_have_been_submitted)
+    {
+        m_pending_resource_states.publish();
+    }
+    else
+    {
+        m_pending_resource_states.clear();
+    }
+
+    if (m_are_resource_states_locked)
+    {
+        auto mutex_ptr = m_device_ptr->get_resource_state_mutex();
+
+        if (mutex_ptr != nullptr)
+        {
+            mutex_ptr->unlock();
+        }
+
+        m_are_resource_states_locked = false;
+    }
+
+    if (m_recorded_prologue_cmd_buffers.size() == 0)
+    {
+        goto end;
+    }
+
+    if (!in_have_been_submitted)
+    {
+        for (auto& current_cmd_buffer_ptr : m_recorded_prologue_cmd_buffers)
+        {
+            m_available_prologue_cmd_buffers.push_back(std::move(current_cmd_buffer_ptr) );
+        }
+
+        m_recorded_prologue_cmd_buffers.clear();
+
+        goto end;
+    }
+
+    /* Submissions which need prologue command buffers are always tracked if the queue supports it. Otherwise,
+     * the submission's own fence is used, as long as it is owned by the queue. */
+    in_flight_item.cmd_buffer_ptrs.swap(m_recorded_prologue_cmd_buffers);
+    in_flight_item.submission_id = in_submission_id;
+
+    if (in_submission_id == 0)
+    {
+        in_flight_item.fence_ptr = std::move(*inout_fence_ptr_ptr);
+    }
+
+    m_in_flight_prologue_cmd_buffers.push_back(std::move(in_flight_item) );
+
+end:
+    ;
+}
+
+/* Please see header for specification */
+bool Anvil::Queue::wait_for_submission(uint64_t in_submission_id,
+                                       uint64_t in_timeout) const
+{
+    anvil_assert(m_submission_semaphore_ptr != nullptr);
+    anvil_assert(in_submission_id           <= m_last_submission_id);
+
+    return m_submission_semaphore_ptr->wait(in_submission_id,
+                                            in_timeout);
+}
+
 void Anvil::Queue::wait_idle()
 {
     lock();
     {
-        Anvil::Vulkan::vkQueueWaitIdle(m_queue);
+        m_device_ptr->get_dispatch_table().vkQueueWaitIdle(m_queue);
     }
     unlock();
 }
\ No newline at end of file
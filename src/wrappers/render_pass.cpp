@@ -55,9 +55,9 @@ Anvil::RenderPass::~RenderPass()
 
     if (m_render_pass != VK_NULL_HANDLE)
     {
-        Anvil::Vulkan::vkDestroyRenderPass(m_render_pass_create_info_ptr->get_device()->get_device_vk(),
-                                           m_render_pass,
-                                           nullptr /* pAllocator */);
+        m_render_pass_create_info_ptr->get_device()->get_dispatch_table().vkDestroyRenderPass(m_render_pass_create_info_ptr->get_device()->get_device_vk(),
+                                                                                              m_render_pass,
+                                                                                              nullptr /* pAllocator */);
 
         m_render_pass = VK_NULL_HANDLE;
     }
@@ -541,10 +541,10 @@ bool Anvil::RenderPass::init_using_core_vk10()
     {
         auto create_info_chain_ptr = render_pass_create_info_chainer.create_chain();
 
-        result_vk = Anvil::Vulkan::vkCreateRenderPass(m_device_ptr->get_device_vk(),
-                                                      create_info_chain_ptr->get_root_struct(),
-                                                      nullptr, /* pAllocator */
-                                                     &m_render_pass);
+        result_vk = m_device_ptr->get_dispatch_table().vkCreateRenderPass(m_device_ptr->get_device_vk(),
+                                                                          create_info_chain_ptr->get_root_struct(),
+                                                                          nullptr, /* pAllocator */
+                                                                         &m_render_pass);
     }
 
     if (!is_vk_call_successful(result_vk) )
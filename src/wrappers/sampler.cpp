@@ -53,9 +53,9 @@ Anvil::Sampler::~Sampler()
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroySampler(m_device_ptr->get_device_vk(),
-                                            m_sampler,
-                                            nullptr /* pAllocator */);
+            m_device_ptr->get_dispatch_table().vkDestroySampler(m_device_ptr->get_device_vk(),
+                                                                m_sampler,
+                                                                nullptr /* pAllocator */);
         }
         unlock();
 
@@ -143,12 +143,12 @@ bool Anvil::Sampler::init()
     }
 
     {
-        auto chain_ptr = struct_chainer.create_chain();
+        auto root_struct_ptr = struct_chainer.bake_chain();
 
-        result = Anvil::Vulkan::vkCreateSampler(m_device_ptr->get_device_vk(),
-                                                chain_ptr->get_root_struct(),
-                                                nullptr, /* pAllocator */
-                                               &m_sampler);
+        result = m_device_ptr->get_dispatch_table().vkCreateSampler(m_device_ptr->get_device_vk(),
+                                                                    root_struct_ptr,
+                                                                    nullptr, /* pAllocator */
+                                                                   &m_sampler);
     }
 
     anvil_assert_vk_call_succeeded(result);
@@ -266,6 +266,22 @@ end:
     return result;
 }
 
+/* Please see header for specification */
+bool Anvil::Semaphore::get_counter_value(uint64_t* out_value_ptr) const
+{
+    VkResult result = VK_ERROR_INITIALIZATION_FAILED;
+
+    anvil_assert(m_create_info_ptr->get_semaphore_type() == Anvil::SemaphoreType::TIMELINE_KHR);
+    anvil_assert(out_value_ptr                            != nullptr);
+
+    result = m_device_ptr->get_extension_khr_timeline_semaphore_entrypoints().vkGetSemaphoreCounterValueKHR(m_device_ptr->get_device_vk(),
+                                                                                                             m_semaphore,
+                                                                                                             out_value_ptr);
+
+    anvil_assert_vk_call_succeeded(result);
+    return is_vk_call_successful(result);
+}
+
 /** Destroys the underlying Vulkan Semaphore instance. */
 void Anvil::Semaphore::release_semaphore()
 {
@@ -273,9 +289,9 @@ void Anvil::Semaphore::release_semaphore()
     {
         lock();
         {
-            Anvil::Vulkan::vkDestroySemaphore(m_device_ptr->get_device_vk(),
-                                              m_semaphore,
-                                              nullptr /* pAllocator */);
+            m_device_ptr->get_dispatch_table().vkDestroySemaphore(m_device_ptr->get_device_vk(),
+                                                                  m_semaphore,
+                                                                  nullptr /* pAllocator */);
         }
         unlock();
 
@@ -304,6 +320,16 @@ bool Anvil::Semaphore::reset()
         }
     }
 
+    if (m_create_info_ptr->get_semaphore_type() == Anvil::SemaphoreType::TIMELINE_KHR)
+    {
+        if (!m_device_ptr->get_extension_info()->khr_timeline_semaphore() )
+        {
+            anvil_assert(m_device_ptr->get_extension_info()->khr_timeline_semaphore() );
+
+            goto end;
+        }
+    }
+
     /* Spawn a new semaphore */
     {
         VkSemaphoreCreateInfo semaphore_create_info;
@@ -315,6 +341,18 @@ bool Anvil::Semaphore::reset()
         struct_chainer.append_struct(semaphore_create_info);
     }
 
+    if (m_create_info_ptr->get_semaphore_type() != Anvil::SemaphoreType::BINARY_KHR)
+    {
+        VkSemaphoreTypeCreateInfoKHR type_create_info;
+
+        type_create_info.initialValue  = m_create_info_ptr->get_initial_value();
+        type_create_info.pNext         = nullptr;
+        type_create_info.semaphoreType = static_cast<VkSemaphoreTypeKHR>(m_create_info_ptr->get_semaphore_type() );
+        type_create_info.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+
+        struct_chainer.append_struct(type_create_info);
+    }
+
     if (m_create_info_ptr->get_exportable_external_semaphore_handle_types() != Anvil::ExternalSemaphoreHandleTypeFlagBits::NONE)
     {
         VkExportSemaphoreCreateInfo create_info;
@@ -358,10 +396,10 @@ bool Anvil::Semaphore::reset()
         goto end;
     }
 
-    result = Anvil::Vulkan::vkCreateSemaphore(m_device_ptr->get_device_vk(),
-                                              struct_chain_ptr->get_root_struct(),
-                                              nullptr, /* pAllocator */
-                                             &m_semaphore);
+    result = m_device_ptr->get_dispatch_table().vkCreateSemaphore(m_device_ptr->get_device_vk(),
+                                                                  struct_chain_ptr->get_root_struct(),
+                                                                  nullptr, /* pAllocator */
+                                                                 &m_semaphore);
 
     anvil_assert_vk_call_succeeded(result);
     if (is_vk_call_successful(result) )
@@ -372,3 +410,53 @@ bool Anvil::Semaphore::reset()
 end:
     return is_vk_call_successful(result);
 }
+
+/* Please see header for specification */
+bool Anvil::Semaphore::signal(uint64_t in_value)
+{
+    VkResult                 result;
+    VkSemaphoreSignalInfoKHR signal_info;
+
+    anvil_assert(m_create_info_ptr->get_semaphore_type() == Anvil::SemaphoreType::TIMELINE_KHR);
+
+    signal_info.pNext     = nullptr;
+    signal_info.semaphore = m_semaphore;
+    signal_info.sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR;
+    signal_info.value     = in_value;
+
+    lock();
+    {
+        result = m_device_ptr->get_extension_khr_timeline_semaphore_entrypoints().vkSignalSemaphoreKHR(m_device_ptr->get_device_vk(),
+                                                                                                        &signal_info);
+    }
+    unlock();
+
+    anvil_assert_vk_call_succeeded(result);
+    return is_vk_call_successful(result);
+}
+
+/* Please see header for specification */
+bool Anvil::Semaphore::wait(uint64_t in_value,
+                            uint64_t in_timeout) const
+{
+    VkResult               result;
+    VkSemaphoreWaitInfoKHR wait_info;
+
+    anvil_assert(m_create_info_ptr->get_semaphore_type() == Anvil::SemaphoreType::TIMELINE_KHR);
+
+    wait_info.flags          = 0;
+    wait_info.pNext          = nullptr;
+    wait_info.pSemaphores    = &m_semaphore;
+    wait_info.pValues        = &in_value;
+    wait_info.semaphoreCount = 1;
+    wait_info.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+
+    result = m_device_ptr->get_extension_khr_timeline_semaphore_entrypoints().vkWaitSemaphoresKHR(m_device_ptr->get_device_vk(),
+                                                                                                   &wait_info,
+                                                                                                   in_timeout);
+
+    anvil_assert(result == VK_SUCCESS  ||
+                 result == VK_TIMEOUT);
+
+    return (result == VK_SUCCESS);
+}
@@ -235,11 +235,11 @@ Anvil::SwapchainOperationErrorCode Anvil::Swapchain::acquire_image(Anvil::Semaph
 
             if (fence_handle != VK_NULL_HANDLE)
             {
-                result_status = static_cast<Anvil::SwapchainOperationErrorCode>(Anvil::Vulkan::vkWaitForFences(m_device_ptr->get_device_vk(),
-                                                                                1, /* fenceCount */
-                                                                               &fence_handle,
-                                                                                VK_TRUE, /* waitAll */
-                                                                                UINT64_MAX) );
+                result_status = static_cast<Anvil::SwapchainOperationErrorCode>(m_device_ptr->get_dispatch_table().vkWaitForFences(m_device_ptr->get_device_vk(),
+                                                                                                    1, /* fenceCount */
+                                                                                                   &fence_handle,
+                                                                                                    VK_TRUE, /* waitAll */
+                                                                                                    UINT64_MAX) );
             }
         }
         unlock();